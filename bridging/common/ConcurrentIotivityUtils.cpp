@@ -31,6 +31,71 @@ using namespace OC::Bridging;
 
 // Static member initializations.
 std::unique_ptr<WorkQueue<std::unique_ptr<IotivityWorkItem>>> ConcurrentIotivityUtils::m_queue;
+std::unique_ptr<WorkQueue<std::unique_ptr<IotivityWorkItem>>> ConcurrentIotivityUtils::m_pluginQueue;
+
+void ConcurrentIotivityUtils::processWorkQueue()
+{
+    while (true)
+    {
+        std::unique_ptr<IotivityWorkItem> workItem;
+        bool fetchedWorkItem = m_queue->get(&workItem);
+
+        if (fetchedWorkItem)
+        {
+            std::lock_guard<std::mutex> lock(m_iotivityApiCallMutex);
+            workItem->process();
+        }
+        else
+        {
+            break;
+        }
+
+        // The work item may have changed when the stack needs OCProcessEvent next,
+        // e.g. by holding back a notification.
+        if (m_processEvent)
+        {
+            oc_event_signal(m_processEvent);
+        }
+    }
+}
+
+void ConcurrentIotivityUtils::processPluginWorkQueue()
+{
+    while (true)
+    {
+        std::unique_ptr<IotivityWorkItem> workItem;
+
+        if (!m_pluginQueue->get(&workItem))
+        {
+            break;
+        }
+        workItem->process();
+    }
+}
+
+void ConcurrentIotivityUtils::callOCProcess()
+{
+    while (!m_shutDownOCProcessThread)
+    {
+        OCStackResult result;
+        uint32_t nextEventTime = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_iotivityApiCallMutex);
+            result = m_processEvent ? OCProcessEvent(&nextEventTime) : OCProcess();
+        }
+
+        if (m_processEvent && OC_STACK_OK == result)
+        {
+            // Sleep until a message is queued, a work item was processed or the next
+            // stack timer is due.
+            oc_event_wait_for(m_processEvent, nextEventTime);
+        }
+        else
+        {
+            usleep(OCPROCESS_SLEEP_MICROSECONDS);
+        }
+    }
+}
 
 void ConcurrentIotivityUtils::startWorkerThreads()
 {
@@ -38,8 +103,24 @@ void ConcurrentIotivityUtils::startWorkerThreads()
     {
         throw "Work Queue Processor already started";
     }
+
+    m_processEvent = oc_event_new();
+    if (!m_processEvent)
+    {
+        OIC_LOG(ERROR, TAG, "Failed to create process event, falling back to polling");
+    }
+    else
+    {
+        OCRegisterProcessEvent(m_processEvent);
+    }
+
     m_processWorkQueueThread = std::thread(&ConcurrentIotivityUtils::processWorkQueue, this);
     m_ocProcessThread = std::thread(&ConcurrentIotivityUtils::callOCProcess, this);
+    for (size_t i = 0; i < m_numPluginWorkerThreads; i++)
+    {
+        m_pluginWorkerThreads.push_back(
+            std::thread(&ConcurrentIotivityUtils::processPluginWorkQueue, this));
+    }
     m_threadStarted = true;
 }
 
@@ -47,8 +128,25 @@ void ConcurrentIotivityUtils::stopWorkerThreads()
 {
     m_shutDownOCProcessThread = true;
     m_queue->shutdown();
+    m_pluginQueue->shutdown();
+    if (m_processEvent)
+    {
+        oc_event_signal(m_processEvent);
+    }
     m_processWorkQueueThread.join();
     m_ocProcessThread.join();
+    for (auto &thread : m_pluginWorkerThreads)
+    {
+        thread.join();
+    }
+    m_pluginWorkerThreads.clear();
+
+    if (m_processEvent)
+    {
+        OCRegisterProcessEvent(NULL);
+        oc_event_free(m_processEvent);
+        m_processEvent = NULL;
+    }
     m_threadStarted = false;
 }
 
@@ -116,6 +214,18 @@ OCStackResult ConcurrentIotivityUtils::respondToRequestWithError(OCEntityHandler
     return res;
 }
 
+OCStackResult ConcurrentIotivityUtils::queuePluginWork(std::function<void()> work)
+{
+    if (!work)
+    {
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    std::unique_ptr<IotivityWorkItem> item = make_unique<PluginWorkItem>(std::move(work));
+    m_pluginQueue->put(std::move(item));
+    return OC_STACK_OK;
+}
+
 OCStackResult ConcurrentIotivityUtils::queueNotifyObservers(const std::string &resourceUri)
 {
     std::unique_ptr<IotivityWorkItem> item = make_unique<NotifyObserversItem>(resourceUri);
@@ -26,17 +26,21 @@
 #include <queue>
 #include <mutex>
 #include <memory>
+#include <atomic>
 #include <condition_variable>
+#include <functional>
 #include <thread>
 #include <unistd.h>
 #include <iostream>
 #include <string>
 #include <memory>
 #include <map>
+#include <vector>
 #include "IotivityWorkItem.h"
 #include "WorkQueue.h"
 #include "ocstack.h"
 #include "octypes.h"
+#include "ocevent.h"
 
 namespace OC
 {
@@ -52,76 +56,77 @@ namespace OC
          * Provides a synchronized C++ wrapper over the Iotivity CSDK.
          * Accepts workItems from the plugins for common operations.
          * A consumer thread processes these worker items and makes calls into Iotivity.
-         * Another thread calls OCProcess() to check for network requests.
+         * Another thread calls OCProcessEvent() when a network request arrives or a stack
+         * timer is due. A pool of threads processes plugin work that does not call into
+         * Iotivity.
          */
         class ConcurrentIotivityUtils
         {
             private:
 
                 static std::unique_ptr<WorkQueue<std::unique_ptr<IotivityWorkItem>>> m_queue;
+                static std::unique_ptr<WorkQueue<std::unique_ptr<IotivityWorkItem>>> m_pluginQueue;
                 std::mutex m_iotivityApiCallMutex;
 
                 std::thread m_processWorkQueueThread, m_ocProcessThread;
+                std::vector<std::thread> m_pluginWorkerThreads;
+                size_t m_numPluginWorkerThreads;
                 bool m_threadStarted;
-                bool m_shutDownOCProcessThread;
+                std::atomic<bool> m_shutDownOCProcessThread;
+
+                // Wakes up the OCProcess thread, NULL if it polls.
+                oc_event m_processEvent;
+
+                // Polling interval if the process event cannot be created.
                 static const int OCPROCESS_SLEEP_MICROSECONDS = 200000;
 
                 // Fetches work item from queue and processes it.
-                void processWorkQueue()
-                {
-                    while (true)
-                    {
-                        std::unique_ptr<IotivityWorkItem> workItem;
-                        bool fetchedWorkItem = m_queue->get(&workItem);
-
-                        if (fetchedWorkItem)
-                        {
-                            std::lock_guard<std::mutex> lock(m_iotivityApiCallMutex);
-                            workItem->process();
-                        }
-                        else
-                        {
-                            break;
-                        }
-                    }
-                }
+                void processWorkQueue();
 
-                void callOCProcess()
-                {
-                    while (!m_shutDownOCProcessThread)
-                    {
-                        {
-                            std::lock_guard<std::mutex> lock(m_iotivityApiCallMutex);
-                            OCProcess();
-                        }
-                        // Hopefully it's enough for other threads to be scheduled
-                        // instead of the spin here. OCProcess is very lightweight though.
-                        usleep(OCPROCESS_SLEEP_MICROSECONDS);
-                    }
-                }
+                // Fetches plugin work item from queue and processes it, without the mutex.
+                void processPluginWorkQueue();
+
+                void callOCProcess();
 
             public:
 
+                static const size_t DEFAULT_PLUGIN_WORKER_THREADS = 4;
 
                 ConcurrentIotivityUtils(std::unique_ptr<WorkQueue<std::unique_ptr<IotivityWorkItem>>>
-                                        queueToMonitor)
+                                        queueToMonitor,
+                                        size_t numPluginWorkerThreads = DEFAULT_PLUGIN_WORKER_THREADS)
                 {
                     m_queue = std::move(queueToMonitor);
+                    m_pluginQueue = make_unique<WorkQueue<std::unique_ptr<IotivityWorkItem>>>();
+                    m_numPluginWorkerThreads = numPluginWorkerThreads ? numPluginWorkerThreads : 1;
                     m_threadStarted = false;
                     m_shutDownOCProcessThread = false;
+                    m_processEvent = NULL;
                 }
 
                 /**
-                 * Starts 2 worker threads. One to service the concurrent work queue to call
-                 * into Iotivity. One to process network requests by calling OCProcess()
+                 * Starts the worker threads. One to service the concurrent work queue to call
+                 * into Iotivity. One to process network requests by calling OCProcessEvent().
+                 * numPluginWorkerThreads to service the plugin work queue.
                  */
                 void startWorkerThreads();
 
                 /**
-                 * Stops the 2 worker threads started by startWorkerThreads. @see startWorkerThreads
+                 * Stops the worker threads started by startWorkerThreads. @see startWorkerThreads
                  */
                 void stopWorkerThreads();
 
+                /**
+                 * Queues plugin work that does not call into Iotivity. The work runs on one of
+                 * the plugin worker threads, in parallel with other plugin work, and may use
+                 * the queue* and respondToRequest functions to get back to Iotivity.
+                 *
+                 * @param[in] work      work to run
+                 *
+                 * @return OCStackResult OC_STACK_OK on success, some other value upon failure.
+                 */
+                OCStackResult static queuePluginWork(std::function<void()> work);
+
                 /**
                  * Gets the string URI associated with an Iotivity handle.
                  * @warning This function is not thread safe and should only be called from entityHandler
@@ -26,6 +26,8 @@
 #include "octypes.h"
 #include "ocpayload.h"
 #include "experimental/logger.h"
+#include <chrono>
+#include <functional>
 #include <string>
 
 #define LOG "IOTIVITY_WORK_ITEM"
@@ -107,16 +109,44 @@ namespace OC
             public:
                 SendResponseItem(std::unique_ptr<OCEntityHandlerResponse> response)
                 : m_response(std::move(response))
+                , m_queuedTime(std::chrono::steady_clock::now())
                 {}
 
                 virtual void process()
                 {
                     OCDoResponse((m_response).get());
                     OCPayloadDestroy(m_response->payload);
+
+                    // Time the response waited for the Iotivity access mutex.
+                    OIC_LOG_V(DEBUG, LOG, "Response sent %lld us after it was queued",
+                              (long long) std::chrono::duration_cast<std::chrono::microseconds>(
+                                  std::chrono::steady_clock::now() - m_queuedTime).count());
                 }
 
             private:
                 std::unique_ptr<OCEntityHandlerResponse> m_response;
+                std::chrono::steady_clock::time_point m_queuedTime;
+        };
+
+        /**
+         * Runs plugin work that does not call into Iotivity, e.g. requests to a cloud
+         * service or a device hub. It is processed without the Iotivity access mutex, in
+         * parallel with other plugin work.
+         */
+        class PluginWorkItem : public IotivityWorkItem
+        {
+            public:
+                PluginWorkItem(std::function<void()> work)
+                : m_work(std::move(work))
+                {}
+
+                virtual void process()
+                {
+                    m_work();
+                }
+
+            private:
+                std::function<void()> m_work;
         };
 
         /**
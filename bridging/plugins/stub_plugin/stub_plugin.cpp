@@ -26,16 +26,26 @@
 #include <iostream>
 #include <set>
 #include <assert.h>
+#include <chrono>
 #include <pluginServer.h>
+#include "ConcurrentIotivityUtils.h"
+#include "ocpayload.h"
 #include "experimental/logger.h"
 
 #define TAG "STUB_PLUGIN"
 
+using namespace OC::Bridging;
+
 MPMPluginCtx *g_plugin_ctx = NULL;
 
-FILE *sec_file(const char *, const char *mode)
+// Answers GET requests from a plugin worker thread, to measure the request latency
+// through the bridge. See the debug logs of this plugin and CONCURRENT_IOTIVITY_UTILS.
+static const std::string ECHO_URI = "/stub/echo";
+static const std::string ECHO_RT = "oic.r.stub.echo";
+
+FILE *sec_file(const char *path, const char *mode)
 {
-    std::string filename = "sample_" + path;
+    std::string filename = std::string("sample_") + path;
     return fopen(filename.c_str(), mode);
 }
 
@@ -55,9 +65,51 @@ MPMResult pluginCreate(MPMPluginCtx **pluginSpecificCtx)
     return MPM_RESULT_OK;
 }
 
+OCEntityHandlerResult echoEntityHandler(OCEntityHandlerFlag, OCEntityHandlerRequest *request,
+                                        void *)
+{
+    if (request->method != OC_REST_GET)
+    {
+        ConcurrentIotivityUtils::respondToRequestWithError(request, "Unsupported method received",
+                OC_EH_METHOD_NOT_ALLOWED);
+        return OC_EH_OK;
+    }
+
+    // The request is only valid in the entity handler, the response needs its handle only.
+    OCRequestHandle requestHandle = request->requestHandle;
+    auto received = std::chrono::steady_clock::now();
+
+    ConcurrentIotivityUtils::queuePluginWork([requestHandle, received]()
+    {
+        OCEntityHandlerRequest echoRequest;
+        memset(&echoRequest, 0, sizeof(echoRequest));
+        echoRequest.requestHandle = requestHandle;
+
+        OCRepPayload *payload = OCRepPayloadCreate();
+        if (!payload)
+        {
+            ConcurrentIotivityUtils::respondToRequestWithError(&echoRequest, "", OC_EH_ERROR);
+            return;
+        }
+        OCRepPayloadSetUri(payload, ECHO_URI.c_str());
+        OCRepPayloadSetPropString(payload, "value", "GET response echo");
+
+        OIC_LOG_V(DEBUG, TAG, "Echo response queued %lld us after the request was received",
+                  (long long) std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::steady_clock::now() - received).count());
+
+        ConcurrentIotivityUtils::respondToRequest(&echoRequest, payload, OC_EH_OK);
+        OCRepPayloadDestroy(payload);
+    });
+
+    return OC_EH_OK;
+}
+
 MPMResult pluginStart(MPMPluginCtx *ctx)
 {
     ctx->stay_in_process_loop = true;
+    ConcurrentIotivityUtils::queueCreateResource(ECHO_URI, ECHO_RT, OC_RSRVD_INTERFACE_DEFAULT,
+            echoEntityHandler, NULL, OC_DISCOVERABLE);
     OIC_LOG(INFO, TAG, "Plugin start called!");
     return MPM_RESULT_OK;
 }
@@ -101,6 +153,7 @@ MPMResult pluginReconnect(MPMPluginCtx *, MPMPipeMessage *message)
 MPMResult pluginStop(MPMPluginCtx *)
 {
     OIC_LOG(INFO, TAG, "Stop called !");
+    ConcurrentIotivityUtils::queueDeleteResource(ECHO_URI);
     return MPM_RESULT_OK;
 }
 
@@ -108,7 +161,7 @@ MPMResult pluginStop(MPMPluginCtx *)
 MPMResult pluginDestroy(MPMPluginCtx *pluginSpecificCtx)
 {
     OIC_LOG(INFO, TAG, "Destroy called");
-    if (!pluginSpecificCtx)
+    if (pluginSpecificCtx)
     {
         assert(g_plugin_ctx);
 
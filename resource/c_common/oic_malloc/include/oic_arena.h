@@ -0,0 +1,179 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#ifndef OIC_ARENA_H_
+#define OIC_ARENA_H_
+
+// An arena hands out memory for objects that share a lifetime, e.g. everything
+// allocated while a request is processed. Allocations are never freed one by one,
+// all of them are released at once with the arena. The memory comes from a buffer
+// given by the caller, which can live on the stack, and from blocks allocated with
+// OICMalloc when the buffer is used up.
+//
+// Note that these functions are intended to be used ONLY within the TB
+// stack and NOT by the application code.
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+//-----------------------------------------------------------------------------
+// Defines
+//-----------------------------------------------------------------------------
+
+/** Default size of the blocks an arena allocates when its buffer is used up. */
+#ifndef OIC_ARENA_BLOCK_SIZE
+#define OIC_ARENA_BLOCK_SIZE 1024
+#endif
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+
+/** Block allocated by an arena, defined in oic_arena.c. */
+struct OICArenaBlock;
+
+typedef struct
+{
+    /** Blocks allocated by the arena. */
+    struct OICArenaBlock *blocks;
+
+    /** Next free byte of the current buffer or block. */
+    uint8_t *next;
+
+    /** End of the current buffer or block. */
+    uint8_t *end;
+
+    /** Size of the blocks allocated when the current one is used up. */
+    size_t blockSize;
+
+    /** Number of allocations served by the arena. */
+    size_t allocations;
+
+    /** Number of blocks allocated with OICMalloc. */
+    size_t blockCount;
+} OICArena_t;
+
+//-----------------------------------------------------------------------------
+// Function prototypes
+//-----------------------------------------------------------------------------
+
+/**
+ * Initializes an arena over a buffer of the caller.
+ *
+ * @param arena - Arena to initialize.
+ * @param buffer - Memory to allocate from first, or NULL. It must outlive the arena.
+ * @param bufferSize - Size of buffer in bytes.
+ * @param blockSize - Size of the blocks allocated when buffer is used up,
+ *                    0 for OIC_ARENA_BLOCK_SIZE.
+ */
+void OICArenaInit(OICArena_t *arena, void *buffer, size_t bufferSize, size_t blockSize);
+
+/**
+ * Creates an arena whose first size bytes are allocated together with it.
+ *
+ * @param size - Number of bytes available before another block is allocated.
+ *
+ * @return
+ *     on success, the arena, to be released with OICArenaDestroy
+ *     on failure, a null pointer is returned
+ */
+OICArena_t *OICArenaCreate(size_t size);
+
+/**
+ * Releases the blocks of an arena initialized with OICArenaInit. The buffer of the
+ * arena is not used again, later allocations come from new blocks.
+ *
+ * @param arena - Arena to release. If arena is a null pointer, the function does nothing.
+ */
+void OICArenaRelease(OICArena_t *arena);
+
+/**
+ * Releases an arena created by OICArenaCreate and all of its allocations.
+ *
+ * @param arena - Arena to destroy. If arena is a null pointer, the function does nothing.
+ */
+void OICArenaDestroy(OICArena_t *arena);
+
+/**
+ * Allocates size bytes from an arena, aligned for any type.
+ *
+ * @param arena - Arena to allocate from.
+ * @param size - Size of the memory block in bytes, where size > 0
+ *
+ * @return
+ *     on success, a pointer to the allocated memory block, valid until the arena
+ *     is released
+ *     on failure, a null pointer is returned
+ */
+void *OICArenaAlloc(OICArena_t *arena, size_t size);
+
+/**
+ * Allocates an array of num elements of size bytes from an arena and initializes
+ * all its bits to zero.
+ *
+ * @param arena - Arena to allocate from.
+ * @param num - The number of elements
+ * @param size - Size of the element type in bytes, where size > 0
+ *
+ * @return
+ *     on success, a pointer to the allocated memory block
+ *     on failure, a null pointer is returned
+ */
+void *OICArenaCalloc(OICArena_t *arena, size_t num, size_t size);
+
+/**
+ * Copies size bytes into memory allocated from an arena.
+ *
+ * @param arena - Arena to allocate from.
+ * @param source - Bytes to copy.
+ * @param size - Number of bytes to copy, where size > 0
+ *
+ * @return
+ *     on success, a pointer to the copy
+ *     on failure, a null pointer is returned
+ */
+void *OICArenaMemdup(OICArena_t *arena, const void *source, size_t size);
+
+/**
+ * Copies size bytes of a string into memory allocated from an arena and terminates
+ * the copy with a null character.
+ *
+ * @param arena - Arena to allocate from.
+ * @param str - String to copy.
+ * @param size - Number of characters to copy.
+ *
+ * @return
+ *     on success, a pointer to the copy
+ *     on failure, a null pointer is returned
+ */
+char *OICArenaStrndup(OICArena_t *arena, const char *str, size_t size);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+#endif /* OIC_ARENA_H_ */
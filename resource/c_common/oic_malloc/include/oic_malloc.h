@@ -35,6 +35,8 @@
 // Includes
 //-----------------------------------------------------------------------------
 #include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -48,6 +50,16 @@ extern "C"
 // Typedefs
 //-----------------------------------------------------------------------------
 
+/**
+ * Number of calls that reached the system allocator since the process started.
+ * The counts wrap around, compare the difference of two snapshots only.
+ */
+typedef struct
+{
+    uint32_t allocations;   /**< successful OICMalloc, OICCalloc and OICRealloc calls */
+    uint32_t frees;         /**< OICFree calls with a non-null pointer */
+} OICAllocationCounters_t;
+
 //-----------------------------------------------------------------------------
 // Function prototypes
 //-----------------------------------------------------------------------------
@@ -134,6 +146,16 @@ void OICFree(void *ptr);
  */
 void OICClearMemory(void *buf, size_t n);
 
+/**
+ * Reads the allocation counters, e.g. to measure the allocations done by an
+ * operation. The counters are only kept in builds with ENABLE_MALLOC_COUNTERS or
+ * ENABLE_MALLOC_DEBUG defined.
+ *
+ * @param counters - Filled with the current counts, zero when they are not kept.
+ * @return true if the counters are kept.
+ */
+bool OICGetAllocationCounters(OICAllocationCounters_t *counters);
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
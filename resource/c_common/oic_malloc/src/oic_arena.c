@@ -0,0 +1,228 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <string.h>
+#include "oic_arena.h"
+#include "oic_malloc.h"
+
+//-----------------------------------------------------------------------------
+// Typedefs
+//-----------------------------------------------------------------------------
+struct OICArenaBlock
+{
+    struct OICArenaBlock *next;
+};
+
+typedef union
+{
+    long long l;
+    double d;
+    void *p;
+} OICArenaMaxAlign_t;
+
+//-----------------------------------------------------------------------------
+// Macros
+//-----------------------------------------------------------------------------
+#define OIC_ARENA_ALIGNMENT (sizeof(OICArenaMaxAlign_t))
+
+#define OIC_ARENA_ALIGN(size) \
+    (((size) + OIC_ARENA_ALIGNMENT - 1) & ~(OIC_ARENA_ALIGNMENT - 1))
+
+#define OIC_ARENA_BLOCK_HEADER_SIZE OIC_ARENA_ALIGN(sizeof(struct OICArenaBlock))
+
+//-----------------------------------------------------------------------------
+// Private internal functions
+//-----------------------------------------------------------------------------
+static uint8_t *OICArenaAlignPointer(uint8_t *ptr)
+{
+    return (uint8_t *)OIC_ARENA_ALIGN((uintptr_t)ptr);
+}
+
+/**
+ * Allocates a block of at least size bytes. An allocation that does not fit in a
+ * default sized block gets a block of its own, and the current block stays in use.
+ */
+static void *OICArenaAllocBlock(OICArena_t *arena, size_t size)
+{
+    size_t dataSize = (size > arena->blockSize) ? size : arena->blockSize;
+    if (dataSize > SIZE_MAX - OIC_ARENA_BLOCK_HEADER_SIZE)
+    {
+        return NULL;
+    }
+
+    struct OICArenaBlock *block =
+        (struct OICArenaBlock *)OICMalloc(OIC_ARENA_BLOCK_HEADER_SIZE + dataSize);
+    if (!block)
+    {
+        return NULL;
+    }
+    block->next = arena->blocks;
+    arena->blocks = block;
+    arena->blockCount++;
+
+    uint8_t *data = (uint8_t *)block + OIC_ARENA_BLOCK_HEADER_SIZE;
+    if (size <= arena->blockSize)
+    {
+        arena->next = data + size;
+        arena->end = data + dataSize;
+    }
+    return data;
+}
+
+//-----------------------------------------------------------------------------
+// Public APIs
+//-----------------------------------------------------------------------------
+void OICArenaInit(OICArena_t *arena, void *buffer, size_t bufferSize, size_t blockSize)
+{
+    if (!arena)
+    {
+        return;
+    }
+
+    memset(arena, 0, sizeof(OICArena_t));
+    arena->blockSize = blockSize ? blockSize : OIC_ARENA_BLOCK_SIZE;
+    if (buffer)
+    {
+        arena->next = (uint8_t *)buffer;
+        arena->end = (uint8_t *)buffer + bufferSize;
+    }
+}
+
+OICArena_t *OICArenaCreate(size_t size)
+{
+    const size_t headerSize = OIC_ARENA_ALIGN(sizeof(OICArena_t));
+    if (size > SIZE_MAX - headerSize)
+    {
+        return NULL;
+    }
+
+    OICArena_t *arena = (OICArena_t *)OICMalloc(headerSize + size);
+    if (!arena)
+    {
+        return NULL;
+    }
+    OICArenaInit(arena, (uint8_t *)arena + headerSize, size, 0);
+    return arena;
+}
+
+void OICArenaRelease(OICArena_t *arena)
+{
+    if (!arena)
+    {
+        return;
+    }
+
+    while (arena->blocks)
+    {
+        struct OICArenaBlock *block = arena->blocks;
+        arena->blocks = block->next;
+        OICFree(block);
+    }
+    arena->next = NULL;
+    arena->end = NULL;
+    arena->allocations = 0;
+    arena->blockCount = 0;
+}
+
+void OICArenaDestroy(OICArena_t *arena)
+{
+    if (!arena)
+    {
+        return;
+    }
+
+    OICArenaRelease(arena);
+    OICFree(arena);
+}
+
+void *OICArenaAlloc(OICArena_t *arena, size_t size)
+{
+    if (!arena || 0 == size)
+    {
+        return NULL;
+    }
+
+    void *ptr = NULL;
+    uint8_t *start = arena->next ? OICArenaAlignPointer(arena->next) : NULL;
+    if (start && start <= arena->end && size <= (size_t)(arena->end - start))
+    {
+        arena->next = start + size;
+        ptr = start;
+    }
+    else
+    {
+        ptr = OICArenaAllocBlock(arena, size);
+    }
+
+    if (ptr)
+    {
+        arena->allocations++;
+    }
+    return ptr;
+}
+
+void *OICArenaCalloc(OICArena_t *arena, size_t num, size_t size)
+{
+    if (0 == num || 0 == size || num > SIZE_MAX / size)
+    {
+        return NULL;
+    }
+
+    void *ptr = OICArenaAlloc(arena, num * size);
+    if (ptr)
+    {
+        memset(ptr, 0, num * size);
+    }
+    return ptr;
+}
+
+void *OICArenaMemdup(OICArena_t *arena, const void *source, size_t size)
+{
+    if (!source)
+    {
+        return NULL;
+    }
+
+    void *ptr = OICArenaAlloc(arena, size);
+    if (ptr)
+    {
+        memcpy(ptr, source, size);
+    }
+    return ptr;
+}
+
+char *OICArenaStrndup(OICArena_t *arena, const char *str, size_t size)
+{
+    if (!str || size == SIZE_MAX)
+    {
+        return NULL;
+    }
+
+    char *ptr = (char *)OICArenaAlloc(arena, size + 1);
+    if (ptr)
+    {
+        memcpy(ptr, str, size);
+        ptr[size] = '\0';
+    }
+    return ptr;
+}
@@ -36,6 +36,12 @@
 #define TAG "OIC_MALLOC"
 #endif
 
+// Count allocations and frees for OICGetAllocationCounters()
+#if defined(ENABLE_MALLOC_DEBUG) || defined(ENABLE_MALLOC_COUNTERS)
+#include "ocatomic.h"
+#define OIC_MALLOC_COUNTERS
+#endif
+
 //-----------------------------------------------------------------------------
 // Typedefs
 //-----------------------------------------------------------------------------
@@ -43,10 +49,19 @@
 //-----------------------------------------------------------------------------
 // Private variables
 //-----------------------------------------------------------------------------
+#ifdef OIC_MALLOC_COUNTERS
+static volatile int32_t g_allocationCount = 0;
+static volatile int32_t g_freeCount = 0;
+#endif
 
 //-----------------------------------------------------------------------------
 // Macros
 //-----------------------------------------------------------------------------
+#ifdef OIC_MALLOC_COUNTERS
+#define OIC_MALLOC_COUNT(COUNTER) oc_atomic_increment(&(COUNTER))
+#else
+#define OIC_MALLOC_COUNT(COUNTER)
+#endif
 
 //-----------------------------------------------------------------------------
 // Internal API function
@@ -70,17 +85,18 @@ void *OICMalloc(size_t size)
         return NULL;
     }
 
-#ifdef ENABLE_MALLOC_DEBUG
     void *ptr = malloc(size);
     if (ptr)
     {
+        OIC_MALLOC_COUNT(g_allocationCount);
+#ifdef ENABLE_MALLOC_DEBUG
         count++;
+#endif
     }
+#ifdef ENABLE_MALLOC_DEBUG
     OIC_LOG_V(INFO, TAG, "malloc: ptr=%p, size=%u, count=%u", ptr, size, count);
-    return ptr;
-#else
-    return malloc(size);
 #endif
+    return ptr;
 }
 
 void *OICCalloc(size_t num, size_t size)
@@ -90,17 +106,18 @@ void *OICCalloc(size_t num, size_t size)
         return NULL;
     }
 
-#ifdef ENABLE_MALLOC_DEBUG
     void *ptr = calloc(num, size);
     if (ptr)
     {
+        OIC_MALLOC_COUNT(g_allocationCount);
+#ifdef ENABLE_MALLOC_DEBUG
         count++;
+#endif
     }
+#ifdef ENABLE_MALLOC_DEBUG
     OIC_LOG_V(INFO, TAG, "calloc: ptr=%p, num=%u, size=%u, count=%u", ptr, num, size, count);
-    return ptr;
-#else
-    return calloc(num, size);
 #endif
+    return ptr;
 }
 
 void *OICRealloc(void* ptr, size_t size)
@@ -114,16 +131,17 @@ void *OICRealloc(void* ptr, size_t size)
     }
 
     // Otherwise leave the behavior up to realloc() itself:
-
-#ifdef ENABLE_MALLOC_DEBUG
     void* newptr = realloc(ptr, size);
+    if (newptr)
+    {
+        OIC_MALLOC_COUNT(g_allocationCount);
+    }
+#ifdef ENABLE_MALLOC_DEBUG
     OIC_LOG_V(INFO, TAG, "realloc: ptr=%p, newptr=%p, size=%u", ptr, newptr, size);
+#endif
     // Very important to return the correct pointer here, as it only *somtimes*
     // differs and thus can be hard to notice/test:
     return newptr;
-#else
-    return realloc(ptr, size);
-#endif
 }
 
 void OICFreeAndSetToNull(void **ptr)
@@ -137,6 +155,11 @@ void OICFreeAndSetToNull(void **ptr)
 
 void OICFree(void *ptr)
 {
+    if (ptr)
+    {
+        OIC_MALLOC_COUNT(g_freeCount);
+    }
+
 #ifdef ENABLE_MALLOC_DEBUG
     // Since OICMalloc() did not increment count if it returned NULL,
     // guard the decrement:
@@ -165,3 +188,20 @@ void OICClearMemory(void *buf, size_t n)
 #endif
     }
 }
+
+bool OICGetAllocationCounters(OICAllocationCounters_t *counters)
+{
+    if (!counters)
+    {
+        return false;
+    }
+#ifdef OIC_MALLOC_COUNTERS
+    counters->allocations = (uint32_t)g_allocationCount;
+    counters->frees = (uint32_t)g_freeCount;
+    return true;
+#else
+    counters->allocations = 0;
+    counters->frees = 0;
+    return false;
+#endif
+}
@@ -0,0 +1,148 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include "iotivity_config.h"
+
+extern "C" {
+    #include "oic_arena.h"
+    #include "oic_malloc.h"
+}
+
+#include <gtest/gtest.h>
+#include <iostream>
+#include <stdint.h>
+#include <string.h>
+
+TEST(OICArena, AllocatesFromBufferFirst)
+{
+    uint8_t buffer[256];
+    OICArena_t arena;
+    OICArenaInit(&arena, buffer, sizeof(buffer), 0);
+
+    OICAllocationCounters_t before;
+    bool counted = OICGetAllocationCounters(&before);
+    for (int i = 0; i < 8; i++)
+    {
+        uint8_t *ptr = (uint8_t *)OICArenaAlloc(&arena, 10);
+        ASSERT_TRUE(NULL != ptr);
+        EXPECT_TRUE(ptr >= buffer && ptr + 10 <= buffer + sizeof(buffer));
+        EXPECT_EQ(0u, (uintptr_t)ptr % sizeof(void *));
+    }
+    OICAllocationCounters_t after;
+    OICGetAllocationCounters(&after);
+
+    if (counted)
+    {
+        EXPECT_EQ(before.allocations, after.allocations);
+    }
+    EXPECT_EQ(8u, arena.allocations);
+    EXPECT_EQ(0u, arena.blockCount);
+    OICArenaRelease(&arena);
+}
+
+TEST(OICArena, SpillsToBlocks)
+{
+    uint8_t buffer[32];
+    OICArena_t arena;
+    OICArenaInit(&arena, buffer, sizeof(buffer), 128);
+
+    void *ptrs[20];
+    for (int i = 0; i < 20; i++)
+    {
+        ptrs[i] = OICArenaAlloc(&arena, 24);
+        ASSERT_TRUE(NULL != ptrs[i]);
+        memset(ptrs[i], i, 24);
+    }
+    for (int i = 0; i < 20; i++)
+    {
+        EXPECT_EQ(i, ((uint8_t *)ptrs[i])[23]);
+    }
+    EXPECT_LT(0u, arena.blockCount);
+    EXPECT_GT(20u, arena.blockCount);
+    OICArenaRelease(&arena);
+    EXPECT_EQ(0u, arena.blockCount);
+}
+
+TEST(OICArena, LargeAllocationKeepsCurrentBlock)
+{
+    OICArena_t *arena = OICArenaCreate(64);
+    ASSERT_TRUE(NULL != arena);
+
+    uint8_t *first = (uint8_t *)OICArenaAlloc(arena, 8);
+    ASSERT_TRUE(NULL != first);
+    uint8_t *large = (uint8_t *)OICArenaAlloc(arena, 4 * OIC_ARENA_BLOCK_SIZE);
+    ASSERT_TRUE(NULL != large);
+    memset(large, 0x55, 4 * OIC_ARENA_BLOCK_SIZE);
+    EXPECT_EQ(1u, arena->blockCount);
+
+    // The rest of the first buffer is still used.
+    uint8_t *second = (uint8_t *)OICArenaAlloc(arena, 8);
+    EXPECT_TRUE(second > first && second < first + 64);
+    EXPECT_EQ(1u, arena->blockCount);
+    OICArenaDestroy(arena);
+}
+
+TEST(OICArena, CallocMemdupStrndup)
+{
+    OICArena_t *arena = OICArenaCreate(16);
+    ASSERT_TRUE(NULL != arena);
+
+    uint8_t *zeroed = (uint8_t *)OICArenaCalloc(arena, 100, 3);
+    ASSERT_TRUE(NULL != zeroed);
+    for (int i = 0; i < 300; i++)
+    {
+        EXPECT_EQ(0, zeroed[i]);
+    }
+
+    const uint8_t bytes[] = { 1, 2, 3, 4, 5 };
+    uint8_t *copy = (uint8_t *)OICArenaMemdup(arena, bytes, sizeof(bytes));
+    ASSERT_TRUE(NULL != copy);
+    EXPECT_EQ(0, memcmp(bytes, copy, sizeof(bytes)));
+
+    char *str = OICArenaStrndup(arena, "/a/light?if=oic.if.baseline", 8);
+    EXPECT_STREQ("/a/light", str);
+
+    EXPECT_TRUE(NULL == OICArenaAlloc(arena, 0));
+    EXPECT_TRUE(NULL == OICArenaCalloc(arena, SIZE_MAX / 2, 4));
+    EXPECT_TRUE(NULL == OICArenaAlloc(NULL, 8));
+    OICArenaDestroy(arena);
+}
+
+TEST(OICAllocationCounters, CountAllocationsAndFrees)
+{
+    OICAllocationCounters_t before;
+    if (!OICGetAllocationCounters(&before))
+    {
+        std::cout << "allocation counters are not built in" << std::endl;
+        return;
+    }
+
+    void *ptr = OICMalloc(8);
+    ptr = OICRealloc(ptr, 4096);
+    void *zeroed = OICCalloc(2, 8);
+    OICFree(ptr);
+    OICFree(zeroed);
+    OICFree(NULL);
+
+    OICAllocationCounters_t after;
+    OICGetAllocationCounters(&after);
+    EXPECT_EQ(3u, after.allocations - before.allocations);
+    EXPECT_EQ(2u, after.frees - before.frees);
+}
@@ -531,6 +531,9 @@ typedef struct
     CAURI_t resourceUri;        /**< Resource URI information **/
     CARemoteId_t identity;      /**< endpoint identity */
     CADataType_t dataType;      /**< data type */
+    struct oc_refcounter_t *payloadRef; /**< reference counted buffer of a received payload,
+                                             shared by the clones of the info instead of
+                                             being copied. NULL when the info owns payload */
 } CAInfo_t;
 
 /**
@@ -590,23 +593,6 @@ typedef struct
     uint16_t port;      /**< socket port */
 } CASocket_t;
 
-#define HISTORYSIZE (4)
-
-typedef struct
-{
-    CATransportFlags_t flags;        /**< Transport flags */
-    uint16_t messageId;              /**< Message Id */
-    char token[CA_MAX_TOKEN_LEN];    /**< Token */
-    uint8_t tokenLength;             /**< Token length */
-    uint32_t ifindex;                /**< Index of interface */
-} CAHistoryItem_t;
-
-typedef struct
-{
-    int nextIndex;                       /**< Next item index */
-    CAHistoryItem_t items[HISTORYSIZE];  /**< History items */
-} CAHistory_t;
-
 /**
  * Hold interface index for keeping track of comings and goings.
  */
@@ -685,11 +671,6 @@ typedef struct
         } nm;
     } ip;
 
-    struct calayer
-    {
-        CAHistory_t requestHistory;  /**< filter IP family in requests */
-    } ca;
-
 #ifdef TCP_ADAPTER
     /**
      * Hold global variables for TCP Adapter.
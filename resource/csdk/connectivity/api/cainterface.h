@@ -32,6 +32,7 @@
  */
 #include "cacommon.h"
 #include "casecurityinterface.h"
+#include "ocevent.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -231,6 +232,13 @@ CATransportAdapter_t CAGetSelectedNetwork(void);
  */
 CAResult_t CAHandleRequestResponse(void);
 
+/**
+ * Register the event to be signaled when a request, response or error is ready
+ * to be handled by ::CAHandleRequestResponse.
+ * @param[in]   event      event to signal, or NULL to unregister.
+ */
+void CARegisterProcessEvent(oc_event event);
+
 #ifdef RA_ADAPTER
 /**
  * Set Remote Access information for XMPP Client.
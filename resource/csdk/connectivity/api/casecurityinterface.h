@@ -357,6 +357,16 @@ CAResult_t CAcloseSslConnection(const CAEndpoint_t *endpoint);
  */
 void CAcloseSslConnectionAll(CATransportAdapter_t transportType);
 
+/**
+ * Drop the TLS/DTLS sessions kept for resumption. To be called when the credentials,
+ * the CRL or the provisioning state change, since resumed sessions are not verified
+ * again.
+ *
+ * @retval  ::CA_STATUS_OK    Successful.
+ * @retval  ::CA_STATUS_FAILED Operation failed.
+ */
+CAResult_t CAflushSslSessions(void);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
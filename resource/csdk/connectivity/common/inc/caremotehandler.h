@@ -65,6 +65,18 @@ void CAFreeEndpoint(CAEndpoint_t *rep);
  */
 CAResult_t CACloneInfo(const CAInfo_t *info, CAInfo_t *clone);
 
+/**
+ * Hands a received payload over to the given info. The payload buffer is reference
+ * counted, the clones of the info share it instead of copying it.
+ * @param[in,out]   info        info object to set the payload of.
+ *                              Its previous payload is released.
+ * @param[in]       payload     payload buffer allocated by OICMalloc, owned by info
+ *                              afterwards. It is released when the function fails.
+ * @param[in]       payloadSize size of the payload.
+ * @return      ::CA_STATUS_OK or Appropriate error code if fail to set the payload.
+ */
+CAResult_t CASetSharedPayload(CAInfo_t *info, CAPayload_t payload, size_t payloadSize);
+
 /**
  * Creates a new request information.
  * @param[in]   request           request information that needs to be duplicated.
@@ -0,0 +1,109 @@
+/* ****************************************************************
+ *
+ * Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file
+ *
+ * This file contains the APIs of a bounded lock-free queue with many producers
+ * and a single consumer.
+ */
+
+#ifndef U_MPSC_QUEUE_H_
+#define U_MPSC_QUEUE_H_
+
+#include "uqueue.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/**
+ * Cell of the ring buffer.
+ */
+typedef struct u_mpsc_queue_cell_t
+{
+    /** Position the cell can next be pushed (sequence) or popped (sequence - 1) at. */
+    volatile int32_t sequence;
+    /** message in the cell. */
+    u_queue_message_t message;
+} u_mpsc_queue_cell_t;
+
+/**
+ * Queue structure. Producers claim positions with a compare and swap on the tail,
+ * the consumer owns the head.
+ */
+typedef struct u_mpsc_queue_t
+{
+    /** Ring buffer. */
+    u_mpsc_queue_cell_t *cells;
+    /** Number of cells, a power of two. */
+    uint32_t capacity;
+    /** Next position claimed by a producer. */
+    volatile int32_t tail;
+    /** Next position popped by the consumer. */
+    int32_t head;
+} u_mpsc_queue_t;
+
+/**
+ * Creates a queue.
+ * @param capacity Number of messages the queue holds, rounded up to a power of two.
+ * @return  u_mpsc_queue_t pointer if Success, NULL otherwise.
+ */
+u_mpsc_queue_t *u_mpsc_queue_create(uint32_t capacity);
+
+/**
+ * Deletes the queue. Messages still queued are not freed.
+ * @param queue pointer to queue.
+ */
+void u_mpsc_queue_delete(u_mpsc_queue_t *queue);
+
+/**
+ * Adds message at the end of the queue. May be called from any thread.
+ * @param queue pointer to queue.
+ * @param msg Pointer to message.
+ * @param size message size.
+ * @return true if Success, false if the queue is full.
+ */
+bool u_mpsc_queue_push(u_mpsc_queue_t *queue, void *msg, uint32_t size);
+
+/**
+ * Removes up to count messages from the head of the queue. Only to be called by
+ * the consumer. A message being pushed ends the batch, even when messages pushed
+ * after it are complete.
+ * @param queue pointer to queue.
+ * @param messages Array receiving the messages.
+ * @param count number of elements of messages.
+ * @return number of messages removed.
+ */
+uint32_t u_mpsc_queue_pop(u_mpsc_queue_t *queue, u_queue_message_t *messages, uint32_t count);
+
+/**
+ * Only to be called by the consumer.
+ * @param queue pointer to queue.
+ * @return true if no message is queued nor being pushed.
+ */
+bool u_mpsc_queue_is_empty(u_mpsc_queue_t *queue);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif /* __cplusplus */
+
+#endif /* U_MPSC_QUEUE_H_ */
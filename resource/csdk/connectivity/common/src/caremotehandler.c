@@ -22,6 +22,7 @@
 
 #include "oic_malloc.h"
 #include "oic_string.h"
+#include "oc_refcounter.h"
 #include "caremotehandler.h"
 #include "experimental/logger.h"
 
@@ -235,8 +236,16 @@ static void CADestroyInfoInternal(CAInfo_t *info)
     info->options = NULL;
     info->numOptions = 0;
 
-    // free payload field
-    OICFree((char *) info->payload);
+    // free payload field, a shared payload is released by its last owner
+    if (info->payloadRef)
+    {
+        oc_refcounter_dec(info->payloadRef);
+        info->payloadRef = NULL;
+    }
+    else
+    {
+        OICFree((char *) info->payload);
+    }
     info->payload = NULL;
     info->payloadSize = 0;
 
@@ -339,7 +348,14 @@ CAResult_t CACloneInfo(const CAInfo_t *info, CAInfo_t *clone)
 
     memcpy(&(clone->identity), &(info->identity), sizeof(info->identity));
 
-    if ((info->payload) && (0 < info->payloadSize))
+    if (info->payloadRef)
+    {
+        // share the received payload
+        clone->payloadRef = oc_refcounter_inc(info->payloadRef);
+        clone->payload = info->payload;
+        clone->payloadSize = info->payloadSize;
+    }
+    else if ((info->payload) && (0 < info->payloadSize))
     {
         // allocate payload field
         uint8_t *temp = OICMalloc(info->payloadSize);
@@ -386,3 +402,35 @@ exit:
     CADestroyInfoInternal(clone);
     return CA_MEMORY_ALLOC_FAILED;
 }
+
+CAResult_t CASetSharedPayload(CAInfo_t *info, CAPayload_t payload, size_t payloadSize)
+{
+    if (!info || !payload)
+    {
+        OIC_LOG(ERROR, TAG, "input parameter invalid");
+        OICFree(payload);
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    oc_refcounter ref = oc_refcounter_create(payload, OICFree);
+    if (!ref)
+    {
+        OIC_LOG(ERROR, TAG, "CASetSharedPayload Out of memory");
+        OICFree(payload);
+        return CA_MEMORY_ALLOC_FAILED;
+    }
+
+    if (info->payloadRef)
+    {
+        oc_refcounter_dec(info->payloadRef);
+    }
+    else
+    {
+        OICFree(info->payload);
+    }
+    info->payloadRef = ref;
+    info->payload = payload;
+    info->payloadSize = payloadSize;
+
+    return CA_STATUS_OK;
+}
@@ -0,0 +1,139 @@
+/* ****************************************************************
+ *
+ * Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+#include "umpscqueue.h"
+
+#include "experimental/logger.h"
+#include "ocatomic.h"
+#include "oic_malloc.h"
+
+#define TAG "OIC_UMPSCQUEUE"
+
+/*
+ * Positions wrap around, compare them by their signed distance.
+ */
+#define POSITION_DIFF(a, b) ((int32_t)((uint32_t)(a) - (uint32_t)(b)))
+#define POSITION_ADD(a, n) ((int32_t)((uint32_t)(a) + (uint32_t)(n)))
+
+/*
+ * The oc_atomic functions are full barriers. Reading a sequence this way orders
+ * it before the access to the message it guards.
+ */
+#define LOAD_SEQUENCE(cell) oc_atomic_add(&(cell)->sequence, 0)
+
+u_mpsc_queue_t *u_mpsc_queue_create(uint32_t capacity)
+{
+    uint32_t size = 2;
+    while (size < capacity && size < (UINT32_C(1) << 30))
+    {
+        size <<= 1;
+    }
+
+    u_mpsc_queue_t *queue = (u_mpsc_queue_t *) OICMalloc(sizeof(u_mpsc_queue_t));
+    if (NULL == queue)
+    {
+        OIC_LOG(DEBUG, TAG, "QueueCreate FAIL");
+        return NULL;
+    }
+
+    queue->cells = (u_mpsc_queue_cell_t *) OICCalloc(size, sizeof(u_mpsc_queue_cell_t));
+    if (NULL == queue->cells)
+    {
+        OIC_LOG(DEBUG, TAG, "QueueCreate FAIL");
+        OICFree(queue);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+        queue->cells[i].sequence = (int32_t)i;
+    }
+    queue->capacity = size;
+    queue->tail = 0;
+    queue->head = 0;
+
+    return queue;
+}
+
+void u_mpsc_queue_delete(u_mpsc_queue_t *queue)
+{
+    if (NULL != queue)
+    {
+        OICFree(queue->cells);
+        OICFree(queue);
+    }
+}
+
+bool u_mpsc_queue_push(u_mpsc_queue_t *queue, void *msg, uint32_t size)
+{
+    u_mpsc_queue_cell_t *cell = NULL;
+    int32_t pos = queue->tail;
+
+    for (;;)
+    {
+        cell = &queue->cells[(uint32_t)pos & (queue->capacity - 1)];
+        int32_t diff = POSITION_DIFF(LOAD_SEQUENCE(cell), pos);
+        if (0 == diff)
+        {
+            // The cell is free at this position, claim it.
+            if (oc_atomic_cmpxchg(&queue->tail, pos, POSITION_ADD(pos, 1)))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // The consumer has not popped the message of the previous round.
+            return false;
+        }
+        pos = queue->tail;
+    }
+
+    cell->message.msg = msg;
+    cell->message.size = size;
+
+    // Publish the message to the consumer.
+    oc_atomic_increment(&cell->sequence);
+    return true;
+}
+
+uint32_t u_mpsc_queue_pop(u_mpsc_queue_t *queue, u_queue_message_t *messages, uint32_t count)
+{
+    uint32_t popped = 0;
+    while (popped < count)
+    {
+        u_mpsc_queue_cell_t *cell = &queue->cells[(uint32_t)queue->head & (queue->capacity - 1)];
+        if (0 != POSITION_DIFF(LOAD_SEQUENCE(cell), POSITION_ADD(queue->head, 1)))
+        {
+            break;
+        }
+
+        messages[popped++] = cell->message;
+
+        // Free the cell for the position one round ahead.
+        oc_atomic_add(&cell->sequence, (int32_t)(queue->capacity - 1));
+        queue->head = POSITION_ADD(queue->head, 1);
+    }
+    return popped;
+}
+
+bool u_mpsc_queue_is_empty(u_mpsc_queue_t *queue)
+{
+    return queue->head == oc_atomic_add(&queue->tail, 0);
+}
@@ -237,6 +237,39 @@ bool SetCASecureEndpointAttribute(const CAEndpoint_t* peer, uint32_t newAttribut
  */
 bool GetCASecureEndpointAttributes(const CAEndpoint_t* peer, uint32_t* allAttributes);
 
+/**
+ * Serializes the sessions kept for resumption as client, so that they can be restored
+ * by CAsslLoadClientSessions, e.g. after a restart.
+ *
+ * @note The data holds the secrets of the sessions and must be stored securely. It can
+ *       only be loaded by the same build.
+ *
+ * @param[out] data     serialized sessions, to be freed with OICFree
+ * @param[out] dataLen  byte length of data
+ *
+ * @return  CA_STATUS_OK on success; other error code on failure
+ */
+CAResult_t CAsslSaveClientSessions(uint8_t **data, size_t *dataLen);
+
+/**
+ * Restores the sessions serialized by CAsslSaveClientSessions, except the expired ones.
+ *
+ * @param[in]  data     serialized sessions
+ * @param[in]  dataLen  byte length of data
+ *
+ * @return  CA_STATUS_OK on success; other error code on failure
+ */
+CAResult_t CAsslLoadClientSessions(const uint8_t *data, size_t dataLen);
+
+/**
+ * Drops the sessions kept for resumption, as client and as server, and renews the keys
+ * of the session tickets. Resumed handshakes skip the verification of the peer, so the
+ * sessions must not outlive a change of the credentials or of the CRL.
+ *
+ * @return  CA_STATUS_OK on success; other error code on failure
+ */
+CAResult_t CAsslFlushSessions(void);
+
 #ifdef __cplusplus
 }
 #endif //__cplusplus
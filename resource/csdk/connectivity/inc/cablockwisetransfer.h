@@ -561,6 +561,16 @@ coap_block_t *CAGetBlockOption(const CABlockDataID_t *blockID,
 CAPayload_t CAGetPayloadFromBlockDataList(const CABlockDataID_t *blockID,
                                           size_t *fullPayloadLen);
 
+/**
+ * Take the full payload out of block-wise list. The block data does not keep it,
+ * later blocks are stored into a new buffer.
+ * @param[in]   blockID     ID set of CABlockData.
+ * @param[out]  fullPayloadLen  received full payload length.
+ * @return payload, to be released by the caller with OICFree().
+ */
+CAPayload_t CATakePayloadFromBlockDataList(const CABlockDataID_t *blockID,
+                                           size_t *fullPayloadLen);
+
 /**
  * Create the block data from given data and add the data in block-wise transfer list.
  * @param[in]   sendData    data to be added to a list.
@@ -0,0 +1,156 @@
+/* *****************************************************************
+ *
+ * Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file
+ * This file contains the duplicate detection of received requests.
+ *
+ * A request is recorded by message id, token and interface index. A second request
+ * with the same key from the same sender within the lifetime of the record is a
+ * duplicate, e.g. a retransmitted request. The same multicast request received over
+ * IPv4 and IPv6 comes from two sender addresses; it is only a duplicate within a short
+ * window after the first one. The piggybacked response to a confirmable request is kept with its record,
+ * so that it can be sent again instead of handing the duplicate to the stack.
+ */
+
+#ifndef CA_DUPLICATE_CACHE_H_
+#define CA_DUPLICATE_CACHE_H_
+
+#include <stdint.h>
+
+#include "octhread.h"
+#include "cacommon.h"
+
+/** default maximum number of recorded requests. **/
+#ifndef CA_DUPLICATE_CACHE_SIZE
+#define CA_DUPLICATE_CACHE_SIZE         256
+#endif
+
+/** default lifetime of a record in milliseconds, EXCHANGE_LIFETIME of RFC 7252. **/
+#ifndef CA_DUPLICATE_CACHE_LIFETIME_MS
+#define CA_DUPLICATE_CACHE_LIFETIME_MS  247000
+#endif
+
+/**
+ * default time in milliseconds in which a multicast request received from another
+ * sender, i.e. over the other address family, is a duplicate.
+ **/
+#ifndef CA_DUPLICATE_CACHE_MULTICAST_WINDOW_MS
+#define CA_DUPLICATE_CACHE_MULTICAST_WINDOW_MS  2000
+#endif
+
+/** recorded request, defined in caduplicatecache.c. **/
+struct CADuplicateEntry;
+
+typedef struct
+{
+    /** mutex for synchronization of the receiving and the sending threads. **/
+    oc_mutex mutex;
+
+    /** hash table of the records, indexed by message id, token and interface. **/
+    struct CADuplicateEntry **table;
+
+    /** number of buckets in table, a power of 2. **/
+    size_t tableSize;
+
+    /** oldest record, records expire in the order they were added. **/
+    struct CADuplicateEntry *oldest;
+
+    /** newest record. **/
+    struct CADuplicateEntry *newest;
+
+    /** number of records. **/
+    size_t count;
+
+    /** maximum number of records, the oldest one is replaced when reached. **/
+    size_t maxCount;
+
+    /** lifetime of a record. milliseconds. **/
+    uint64_t lifetime;
+
+    /** time in which a record matches multicast requests of other senders. milliseconds. **/
+    uint64_t multicastWindow;
+
+} CADuplicateCache_t;
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * Initializes the duplicate cache.
+ * @param[in]   cache           cache to initialize.
+ * @param[in]   maxCount        maximum number of recorded requests,
+ *                              0 for ::CA_DUPLICATE_CACHE_SIZE.
+ * @param[in]   lifetimeMs      lifetime of a record in milliseconds,
+ *                              0 for ::CA_DUPLICATE_CACHE_LIFETIME_MS.
+ * @return  ::CA_STATUS_OK or ERROR CODES (::CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CADuplicateCacheInitialize(CADuplicateCache_t *cache, size_t maxCount,
+                                      uint32_t lifetimeMs);
+
+/**
+ * Releases the records and the resources of the duplicate cache.
+ * @param[in]   cache           cache to terminate.
+ */
+void CADuplicateCacheTerminate(CADuplicateCache_t *cache);
+
+/**
+ * Records a received request, or reports it as a duplicate of a recorded one.
+ * A request only matches records of the same sender address and port, except that a
+ * non-confirmable multicast request matches a multicast record of any sender within
+ * ::CA_DUPLICATE_CACHE_MULTICAST_WINDOW_MS.
+ * @param[in]   cache           duplicate cache.
+ * @param[in]   endpoint        endpoint the request was received from.
+ * @param[in]   type            message type of the request.
+ * @param[in]   messageId       message id of the request.
+ * @param[in]   token           token of the request.
+ * @param[in]   tokenLength     length of the token.
+ * @param[out]  response        copy of the response sent to the recorded request, or NULL.
+ *                              Release with OICFree(). Optional.
+ * @param[out]  responseSize    size of the response.
+ * @return  true if the request is a duplicate.
+ */
+bool CADuplicateCacheCheck(CADuplicateCache_t *cache, const CAEndpoint_t *endpoint,
+                           CAMessageType_t type, uint16_t messageId,
+                           const CAToken_t token, uint8_t tokenLength,
+                           void **response, uint32_t *responseSize);
+
+/**
+ * Keeps the response sent to a recorded confirmable request. Nothing is kept when
+ * the request is not recorded.
+ * @param[in]   cache           duplicate cache.
+ * @param[in]   endpoint        endpoint the response was sent to.
+ * @param[in]   messageId       message id of the response.
+ * @param[in]   token           token of the response.
+ * @param[in]   tokenLength     length of the token.
+ * @param[in]   pdu             response pdu.
+ * @param[in]   size            size of the response pdu.
+ */
+void CADuplicateCacheSetResponse(CADuplicateCache_t *cache, const CAEndpoint_t *endpoint,
+                                 uint16_t messageId, const CAToken_t token,
+                                 uint8_t tokenLength, const void *pdu, uint32_t size);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  /* CA_DUPLICATE_CACHE_H_ */
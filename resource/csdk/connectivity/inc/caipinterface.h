@@ -136,6 +136,40 @@ void CAIPSendData(CAEndpoint_t *endpoint,
                   size_t dataLength,
                   bool isMulticast);
 
+/**
+ * Send data like ::CAIPSendData, but hold the datagrams of the plain sockets until
+ * ::CAIPFlushSendData so that each socket sends them with a single system call.
+ * Multicast datagrams are held once per interface. Without sendmmsg() this is the
+ * same as ::CAIPSendData.
+ *
+ * Only to be called from the send queue thread.
+ *
+ * @param[in]  endpoint          complete network address to send to.
+ * @param[in]  data              Data to be sent, copied before returning.
+ * @param[in]  dataLength        Length of data in bytes.
+ * @param[in]  isMulticast       Whether data needs to be sent to multicast ip.
+ */
+void CAIPSendDataBatched(CAEndpoint_t *endpoint,
+                         const void *data,
+                         size_t dataLength,
+                         bool isMulticast);
+
+/**
+ * Send the datagrams held by ::CAIPSendDataBatched.
+ *
+ * Only to be called from the send queue thread.
+ */
+void CAIPFlushSendData(void);
+
+/**
+ * Get the number of datagrams sent by ::CAIPFlushSendData and the number of
+ * sendmmsg() calls used for them.
+ *
+ * @param[out] datagrams         Number of datagrams sent.
+ * @param[out] calls             Number of system calls.
+ */
+void CAIPGetSendBatchStatistics(size_t *datagrams, size_t *calls);
+
 /**
  * Get IP adapter connection state.
  *
@@ -27,6 +27,7 @@
 #define CA_MESSAGE_HANDLER_H_
 
 #include "cacommon.h"
+#include "ocevent.h"
 #include <coap/coap.h>
 
 #define CA_MEMORY_ALLOC_CHECK(arg) { if (NULL == arg) {OIC_LOG(ERROR, TAG, "Out of memory"); \
@@ -92,6 +93,16 @@ void CATerminateMessageHandler(void);
  */
 void CAHandleRequestResponseCallbacks(void);
 
+/**
+ * Register the event to be signaled whenever data is added to the receive queue.
+ * The event stays signaled as long as the queue is not empty, so that a caller
+ * handling one message per ::CAHandleRequestResponseCallbacks call drains it.
+ * The event is only signaled under the lock taken here, so it can be freed once
+ * this function returned after unregistering it.
+ * @param[in] event    event to signal, or NULL to stop signaling.
+ */
+void CARegisterMessageHandlerEvent(oc_event event);
+
 /**
  * Setting the Callback funtion for network state change callback.
  * @param[in] nwMonitorHandler    callback for network state change.
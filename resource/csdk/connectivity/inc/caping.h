@@ -109,6 +109,13 @@ CAResult_t CASendPongMessage(const CAEndpoint_t *endpoint, bool withCustody,
  */
 void CAProcessPing();
 
+/**
+ * Gets the time left until the oldest outstanding ping message times out.
+ * @return  time in milliseconds, 0 if a timeout is already due, or UINT32_MAX
+ *          if no ping message is outstanding.
+ */
+uint32_t CAGetNextPingTimeout(void);
+
 /**
  * Sets the timeout for a ping message
  * @param[in] timeout   the timeout for the ping message (in ms). If this
@@ -31,7 +31,7 @@
 
 #include "cathreadpool.h"
 #include "octhread.h"
-#include "uqueue.h"
+#include "umpscqueue.h"
 #include "cacommon.h"
 #ifdef __cplusplus
 extern "C"
@@ -44,6 +44,15 @@ typedef void (*CAThreadTask)(void *threadData);
 /** Data destroy function. **/
 typedef void (*CADataDestroyFunction)(void *data, uint32_t size);
 
+/** Function to be invoked when the queue has been drained. **/
+typedef void (*CAThreadFlush)(void);
+
+/** Function deciding whether queued data is destroyed, see CAQueueingThreadClearContextData. **/
+typedef bool (*CAContextDataDestroy)(void *data, uint32_t size, void *ctx);
+
+/** Data kept outside of the lock-free queue. **/
+typedef struct CAQueueingItem CAQueueingItem_t;
+
 typedef struct
 {
     /** Thread pool of the thread started. **/
@@ -56,10 +65,23 @@ typedef struct
     CAThreadTask threadTask;
     /** Data destroy function. **/
     CADataDestroyFunction destroy;
+    /** Function to be invoked before waiting on an empty queue. **/
+    CAThreadFlush flush;
     /** Variable to inform the thread to stop. **/
     bool isStop;
-    /** Que on which the thread is operating. **/
-    u_queue_t *dataQueue;
+    /** Que on which the thread is operating, added to without locking. **/
+    u_mpsc_queue_t *dataQueue;
+    /** Data added while dataQueue was full, guarded by threadMutex. **/
+    CAQueueingItem_t *overflowHead;
+    CAQueueingItem_t *overflowTail;
+    /** Non-zero while data is added to the overflow list rather than to dataQueue. **/
+    volatile int32_t overflow;
+    /** Data taken from dataQueue or the overflow list, but not yet processed.
+        Guarded by threadMutex. **/
+    CAQueueingItem_t *pendingHead;
+    CAQueueingItem_t *pendingTail;
+    /** Non-zero while the thread waits for data, only then is threadCond signaled. **/
+    volatile int32_t idle;
 } CAQueueingThread_t;
 
 /**
@@ -73,6 +95,16 @@ typedef struct
 CAResult_t CAQueueingThreadInitialize(CAQueueingThread_t *thread, ca_thread_pool_t handle,
                                       CAThreadTask task, CADataDestroyFunction destroy);
 
+/**
+ * Set the function to be invoked each time the queue has been drained, before the
+ * thread waits for more data. A task may use it to complete work held back while
+ * more data was queued.
+ * @param[in]   thread       thread data for each thread.
+ * @param[in]   flush        function to be called when the queue is empty.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingThreadSetFlush(CAQueueingThread_t *thread, CAThreadFlush flush);
+
 /**
  * Start the queuing thread.
  * @param[in]   thread        thread data that needs to be started.
@@ -89,6 +121,32 @@ CAResult_t CAQueueingThreadStart(CAQueueingThread_t *thread);
  */
 CAResult_t CAQueueingThreadAddData(CAQueueingThread_t *thread, void *data, uint32_t size);
 
+/**
+ * Take the oldest data from the queue of a thread which is not started, for a caller
+ * processing the data itself.
+ * @param[in]   thread       thread data for each thread.
+ * @param[out]  size         length of the data.
+ * @return  the data, which the caller destroys, or NULL if the queue is empty.
+ */
+void *CAQueueingThreadTakeData(CAQueueingThread_t *thread, uint32_t *size);
+
+/**
+ * Check whether data is queued.
+ * @param[in]   thread       thread data for each thread.
+ * @return  true if data is queued.
+ */
+bool CAQueueingThreadHasData(CAQueueingThread_t *thread);
+
+/**
+ * Destroy the queued data for which the callback returns true.
+ * @param[in]   thread       thread data for each thread.
+ * @param[in]   callback     called for each queued data.
+ * @param[in]   ctx          passed to the callback.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingThreadClearContextData(CAQueueingThread_t *thread,
+                                            CAContextDataDestroy callback, void *ctx);
+
 /**
  * Stop the queuing thread.
  * @param[in]   thread       thread data that needs to be started.
@@ -30,7 +30,6 @@
 
 #include "cathreadpool.h"
 #include "octhread.h"
-#include "uarraylist.h"
 #include "cacommon.h"
 
 /** IP, EDR, LE. **/
@@ -44,9 +43,6 @@
 /** default max retransmission trying count is 4(CoAP). **/
 #define DEFAULT_RETRANSMISSION_COUNT      4
 
-/** check period is 1 sec. **/
-#define RETRANSMISSION_CHECK_PERIOD_SEC     1
-
 /** retransmission data send method type. **/
 typedef CAResult_t (*CADataSendMethod_t)(const CAEndpoint_t *endpoint,
                                          const void *pdu,
@@ -68,6 +64,9 @@ typedef struct
 
 } CARetransmissionConfig_t;
 
+/** retransmission data, defined in caretransmission.c. **/
+struct CARetransmissionData;
+
 typedef struct
 {
     /** Thread pool of the thread started. **/
@@ -91,8 +90,20 @@ typedef struct
     /** Variable to inform the thread to stop. **/
     bool isStop;
 
-    /** array list on which the thread is operating. **/
-    u_arraylist_t *dataList;
+    /** retransmission data as a binary min-heap ordered by next retransmission time. **/
+    struct CARetransmissionData **dataHeap;
+
+    /** number of retransmission data in dataHeap. **/
+    size_t dataCount;
+
+    /** allocated length of dataHeap. **/
+    size_t dataCapacity;
+
+    /** hash table of the retransmission data, indexed by message id. **/
+    struct CARetransmissionData **dataTable;
+
+    /** number of buckets in dataTable, a power of 2. **/
+    size_t tableSize;
 
 } CARetransmission_t;
 
@@ -28,6 +28,7 @@
 #include "cacommon.h"
 #include "caadapterinterface.h"
 #include "cathreadpool.h"
+#include "octhread.h"
 #include "cainterface.h"
 #include <coap/pdu.h>
 
@@ -83,6 +84,14 @@ typedef struct CATCPSessionInfo_t
     CATCPConnectionState_t state;       /**< current tcp session state */
     CACSMExchangeState_t CSMState;      /**< Capability and Setting Message shared status */
     bool isClient;                      /**< Host Mode of Operation. */
+    oc_mutex sendMutex;                 /**< serializes writes to fd and the send buffer */
+    unsigned char *sendBuffer;          /**< data waiting for the socket to become writable */
+    size_t sendCapacity;                /**< allocated size of sendBuffer */
+    size_t sendOffset;                  /**< first byte of sendBuffer not sent yet */
+    size_t sendLen;                     /**< end of the data in sendBuffer */
+    size_t listIndex;                   /**< index in the session list */
+    struct CATCPSessionInfo_t *addrNext;/**< next session in the same address bucket */
+    struct CATCPSessionInfo_t *fdNext;  /**< next session in the same socket bucket */
 } CATCPSessionInfo_t;
 
 /**
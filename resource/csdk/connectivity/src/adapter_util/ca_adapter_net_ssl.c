@@ -53,6 +53,8 @@
 #include "mbedtls/oid.h"
 #include "mbedtls/x509.h"
 #include "mbedtls/error.h"
+#include "mbedtls/ssl_cache.h"
+#include "mbedtls/ssl_ticket.h"
 #ifdef __WITH_DTLS__
 #include "mbedtls/timing.h"
 #include "mbedtls/ssl_cookie.h"
@@ -115,6 +117,21 @@
  */
 
 #define TLS_MSG_BUF_LEN (16384)
+/**
+ * @def SSL_PEER_TABLE_INITIAL_SIZE
+ * @brief Initial number of buckets of the peer table, must be a power of 2
+ */
+#define SSL_PEER_TABLE_INITIAL_SIZE (16)
+/**
+ * @def SSL_SESSION_CACHE_SIZE
+ * @brief Max number of sessions kept for resumption, as client and as server
+ */
+#define SSL_SESSION_CACHE_SIZE (16)
+/**
+ * @def SSL_SESSION_LIFETIME
+ * @brief Time during which a session can be resumed, in seconds
+ */
+#define SSL_SESSION_LIFETIME (3600)
 /**
  * @def PSK_LENGTH
  * @brief PSK keys max length
@@ -368,6 +385,9 @@ typedef struct SslContext
 {
     u_arraylist_t *peerList;         /**< peer list which holds the mapping between
                                               peer id, it's n/w address and mbedTLS context. */
+    struct SslEndPoint **peerTable;  /**< peers of peerList hashed by adapter, address
+                                              and port. */
+    size_t peerTableSize;            /**< number of buckets of peerTable, 0 or a power of 2. */
     mbedtls_entropy_context entropy;
     mbedtls_ctr_drbg_context rnd;
     mbedtls_x509_crt ca;
@@ -379,6 +399,10 @@ typedef struct SslContext
     mbedtls_ssl_config clientDtlsConf;
     mbedtls_ssl_config serverDtlsConf;
 
+    mbedtls_ssl_cache_context sessionCache;  /**< sessions resumable by ID, as server */
+    mbedtls_ssl_ticket_context ticketCtx;    /**< keys of the session tickets, as server */
+    u_arraylist_t *clientSessions;           /**< sessions resumable as client, oldest first */
+
     SslCipher_t cipher;
     SslCallbacks_t adapterCallbacks[MAX_SUPPORTED_ADAPTERS];
     mbedtls_x509_crl crl;
@@ -430,9 +454,27 @@ static CAcloseSslConnectionCallback g_closeSslConnectionCallback = NULL;
 /**
  * @var g_dtlsContextMutex
  * @brief Mutex to synchronize access to g_caSslContext and g_sslCallback.
+ *
+ * Lock order: g_sslContextMutex, then the mutex of a peer. A thread holding only the
+ * mutex of a peer must neither take g_sslContextMutex nor call into an adapter, which may
+ * close the connection; the records it writes are queued on the peer and sent by
+ * FlushSslRecords once the mutex is released.
  */
 static oc_mutex g_sslContextMutex = NULL;
 
+/**
+ * @var g_sslPeersInUse
+ * @brief The number of references held on peers by threads encrypting or decrypting
+ *        without g_sslContextMutex, guarded by g_sslContextMutex.
+ */
+static size_t g_sslPeersInUse = 0;
+
+/**
+ * @var g_sslPeersReleasedCond
+ * @brief Signaled when g_sslPeersInUse drops to 0.
+ */
+static oc_cond g_sslPeersReleasedCond = NULL;
+
 /**
  * @var g_sslInterestedThreadsCount
  * @brief The number of threads that use this module
@@ -461,6 +503,15 @@ typedef struct SslRecBuf
     size_t len;
     size_t loaded;
 } SslRecBuf_t;
+/**
+ * Record written on an established session, waiting to be sent.
+ */
+typedef struct SslPendingRecord
+{
+    struct SslPendingRecord *next;
+    size_t len;                     /**< length of the record following this header */
+} SslPendingRecord_t;
+
 /**
  * Data structure for holding the data related to endpoint
  * and TLS session.
@@ -476,8 +527,29 @@ typedef struct SslEndPoint
 #ifdef __WITH_DTLS__
     mbedtls_timing_delay_context timer;
 #endif // __WITH_DTLS__
+    oc_mutex mutex;                 /**< serializes the use of ssl once the handshake is over */
+    size_t refCount;                /**< references held by peerList and by the threads using
+                                         the peer, guarded by g_sslContextMutex */
+    bool removed;                   /**< set when the peer leaves peerList, guarded by mutex */
+    bool established;               /**< set once the handshake is over, written with both
+                                         g_sslContextMutex and mutex held */
+    bool deferSend;                 /**< queue written records, guarded by mutex */
+    bool flushing;                  /**< a thread sends pendingRecords, guarded by mutex */
+    SslPendingRecord_t *pendingRecords; /**< records to send in order, guarded by mutex */
+    SslPendingRecord_t *lastPendingRecord;
+    size_t listIndex;               /**< index in peerList */
+    struct SslEndPoint *next;       /**< next peer in the same bucket of peerTable */
 } SslEndPoint_t;
 
+/**
+ * Data structure for holding a session that can be resumed as client.
+ */
+typedef struct SslClientSession
+{
+    CAEndpoint_t endpoint;          /**< server the session was established with */
+    mbedtls_ssl_session session;    /**< session, with its ticket if the server issued one */
+} SslClientSession_t;
+
 void CAsetPskCredentialsCallback(CAgetPskCredentialsHandler credCallback)
 {
     // TODO Does this method needs protection of tlsContextMutex?
@@ -598,6 +670,85 @@ static int GetAdapterIndex(CATransportAdapter_t adapter)
 
 static void SendCacheMessages(SslEndPoint_t * tep, CAResult_t errorCode);
 
+/**
+ * Queues a record on its peer. Must be called with the mutex of the peer held.
+ *
+ * @param[in]  tep    TLS endpoint
+ * @param[in]  data    record
+ * @param[in]  dataLen    record length
+ *
+ * @return  record length or -1 on error.
+ */
+static int QueueSslRecord(SslEndPoint_t *tep, const unsigned char *data, size_t dataLen)
+{
+    if (dataLen > INT_MAX)
+    {
+        dataLen = INT_MAX;
+    }
+
+    SslPendingRecord_t *record =
+        (SslPendingRecord_t *) OICMalloc(sizeof(SslPendingRecord_t) + dataLen);
+    if (NULL == record)
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "Malloc failed!");
+        return -1;
+    }
+    record->next = NULL;
+    record->len = dataLen;
+    memcpy(record + 1, data, dataLen);
+
+    if (NULL == tep->lastPendingRecord)
+    {
+        tep->pendingRecords = record;
+    }
+    else
+    {
+        tep->lastPendingRecord->next = record;
+    }
+    tep->lastPendingRecord = record;
+    return (int)dataLen;
+}
+
+/**
+ * Sends the records queued on a peer, in order. Must be called without the mutex of the
+ * peer held, and with a reference on the peer. When another thread is sending the
+ * records of the peer already, it sends the records queued by this one too.
+ *
+ * @param[in]  tep    TLS endpoint
+ * @param[in]  sendCallback    send callback of the adapter of the peer
+ */
+static void FlushSslRecords(SslEndPoint_t *tep, CAPacketSendCallback sendCallback)
+{
+    oc_mutex_lock(tep->mutex);
+    if (tep->flushing)
+    {
+        oc_mutex_unlock(tep->mutex);
+        return;
+    }
+
+    tep->flushing = true;
+    while (NULL != tep->pendingRecords)
+    {
+        SslPendingRecord_t *record = tep->pendingRecords;
+        tep->pendingRecords = record->next;
+        if (NULL == tep->pendingRecords)
+        {
+            tep->lastPendingRecord = NULL;
+        }
+        oc_mutex_unlock(tep->mutex);
+
+        if (0 > sendCallback(&tep->sep.endpoint, (const void *)(record + 1), record->len))
+        {
+            OIC_LOG(ERROR, NET_SSL_TAG, "Error sending packet. The error will be reported in the adapter.");
+        }
+        OICFree(record);
+
+        oc_mutex_lock(tep->mutex);
+    }
+    tep->flushing = false;
+    oc_mutex_unlock(tep->mutex);
+}
+
 /**
  * Write callback.
  *
@@ -614,6 +765,15 @@ static int SendCallBack(void * tep, const unsigned char * data, size_t dataLen)
     VERIFY_NON_NULL_RET(data, NET_SSL_TAG, "data is NULL", -1);
     VERIFY_NON_NULL_RET(g_caSslContext, NET_SSL_TAG, "SSL Context is NULL", -1);
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Data len: %" PRIuPTR, dataLen);
+
+    // Both flags are only set on established sessions, which are written with the mutex
+    // of the peer held. Records written while another thread flushes are queued behind
+    // the ones it sends, so that they stay in order.
+    SslEndPoint_t *peer = (SslEndPoint_t *) tep;
+    if (peer->deferSend || peer->flushing)
+    {
+        return QueueSslRecord(peer, data, dataLen);
+    }
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Adapter: %u", ((SslEndPoint_t * )tep)->sep.endpoint.adapter);
     ssize_t sentLen = 0;
     int adapterIndex = GetAdapterIndex(((SslEndPoint_t * )tep)->sep.endpoint.adapter);
@@ -886,6 +1046,181 @@ static int GetPskCredentialsCallback(void * notUsed, mbedtls_ssl_context * ssl,
     OIC_LOG_V(WARNING, NET_SSL_TAG, "Out %s", __func__);
     return -1;
 }
+static void DeleteSslEndPoint(SslEndPoint_t * tep);
+
+static size_t GetSslPeerBucket(const CAEndpoint_t *endpoint)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    hash = (hash ^ (uint32_t)endpoint->adapter) * 16777619u;
+    for (size_t i = 0; i < MAX_ADDR_STR_SIZE_CA && endpoint->addr[i]; i++)
+    {
+        hash = (hash ^ (uint8_t)endpoint->addr[i]) * 16777619u;
+    }
+    // Sessions over BLE are matched regardless of the port.
+    if (CA_ADAPTER_GATT_BTLE != endpoint->adapter)
+    {
+        hash = (hash ^ endpoint->port) * 16777619u;
+    }
+    return hash & (g_caSslContext->peerTableSize - 1);
+}
+
+static bool IsSameSslEndpoint(const CAEndpoint_t *endpoint, const CAEndpoint_t *peer)
+{
+    return (peer->adapter == endpoint->adapter)
+            && (0 == strncmp(peer->addr, endpoint->addr, MAX_ADDR_STR_SIZE_CA))
+            && (peer->port == endpoint->port || CA_ADAPTER_GATT_BTLE == peer->adapter);
+}
+
+/*
+ * The peer list functions below must be called with g_sslContextMutex held.
+ */
+
+static bool ResizeSslPeerTable(size_t size)
+{
+    SslEndPoint_t **table = (SslEndPoint_t **) OICCalloc(size, sizeof(*table));
+    if (NULL == table)
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "Malloc failed!");
+        return false;
+    }
+
+    SslEndPoint_t **oldTable = g_caSslContext->peerTable;
+    size_t oldSize = g_caSslContext->peerTableSize;
+    g_caSslContext->peerTable = table;
+    g_caSslContext->peerTableSize = size;
+
+    for (size_t i = 0; i < oldSize; i++)
+    {
+        SslEndPoint_t *tep = oldTable[i];
+        while (tep)
+        {
+            SslEndPoint_t *next = tep->next;
+            size_t bucket = GetSslPeerBucket(&tep->sep.endpoint);
+            tep->next = table[bucket];
+            table[bucket] = tep;
+            tep = next;
+        }
+    }
+
+    OICFree(oldTable);
+    return true;
+}
+
+/**
+ * Adds a peer to the peer list, which holds a reference on it.
+ *
+ * @param[in]  tep    new endpoint with session info
+ *
+ * @return  true on success, false if out of memory
+ */
+static bool AddSslPeer(SslEndPoint_t *tep)
+{
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+
+    size_t count = u_arraylist_length(g_caSslContext->peerList);
+    if (count >= g_caSslContext->peerTableSize &&
+        !ResizeSslPeerTable(g_caSslContext->peerTableSize ?
+                            2 * g_caSslContext->peerTableSize : SSL_PEER_TABLE_INITIAL_SIZE))
+    {
+        return false;
+    }
+    if (!u_arraylist_add(g_caSslContext->peerList, (void *) tep))
+    {
+        return false;
+    }
+    tep->listIndex = count;
+    tep->refCount = 1;
+
+    size_t bucket = GetSslPeerBucket(&tep->sep.endpoint);
+    tep->next = g_caSslContext->peerTable[bucket];
+    g_caSslContext->peerTable[bucket] = tep;
+    return true;
+}
+
+/**
+ * Removes a peer from the peer list. The peer is deleted once the threads using it
+ * release it.
+ *
+ * @param[in]  tep    endpoint with session info
+ */
+static void RemoveSslPeer(SslEndPoint_t *tep)
+{
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+
+    if (tep->listIndex >= u_arraylist_length(g_caSslContext->peerList)
+        || tep != u_arraylist_get(g_caSslContext->peerList, tep->listIndex))
+    {
+        // Already removed.
+        return;
+    }
+
+    // Waits for the thread using the session, if any.
+    oc_mutex_lock(tep->mutex);
+    tep->removed = true;
+    oc_mutex_unlock(tep->mutex);
+
+    SslEndPoint_t **link = &g_caSslContext->peerTable[GetSslPeerBucket(&tep->sep.endpoint)];
+    while (*link && *link != tep)
+    {
+        link = &(*link)->next;
+    }
+    if (*link)
+    {
+        *link = tep->next;
+    }
+
+    //swap last element with current position and remove last element
+    size_t last = u_arraylist_length(g_caSslContext->peerList) - 1;
+    u_arraylist_swap(g_caSslContext->peerList, tep->listIndex, last);
+    u_arraylist_remove(g_caSslContext->peerList, last);
+    if (tep->listIndex != last)
+    {
+        SslEndPoint_t *moved = (SslEndPoint_t *) u_arraylist_get(g_caSslContext->peerList,
+                                                                 tep->listIndex);
+        moved->listIndex = tep->listIndex;
+    }
+
+    if (0 == --tep->refCount)
+    {
+        DeleteSslEndPoint(tep);
+    }
+}
+
+/**
+ * Takes a reference on a peer, which keeps it allocated after g_sslContextMutex is
+ * released. The reference is dropped by ReleaseSslPeer.
+ *
+ * @param[in]  tep    endpoint with session info
+ */
+static void AcquireSslPeer(SslEndPoint_t *tep)
+{
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+
+    tep->refCount++;
+    g_sslPeersInUse++;
+}
+
+/**
+ * Drops a reference taken by AcquireSslPeer. Must be called without g_sslContextMutex
+ * or the mutex of the peer held.
+ *
+ * @param[in]  tep    endpoint with session info
+ */
+static void ReleaseSslPeer(SslEndPoint_t *tep)
+{
+    oc_mutex_lock(g_sslContextMutex);
+    if (0 == --tep->refCount)
+    {
+        DeleteSslEndPoint(tep);
+    }
+    if (0 == --g_sslPeersInUse)
+    {
+        oc_cond_broadcast(g_sslPeersReleasedCond);
+    }
+    oc_mutex_unlock(g_sslContextMutex);
+}
+
 /**
  * Gets session corresponding for endpoint.
  *
@@ -895,8 +1230,6 @@ static int GetPskCredentialsCallback(void * notUsed, mbedtls_ssl_context * ssl,
  */
 static SslEndPoint_t *GetSslPeer(const CAEndpoint_t *peer)
 {
-    size_t listIndex = 0;
-    size_t listLength = 0;
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
 
     oc_mutex_assert_owner(g_sslContextMutex, true);
@@ -904,31 +1237,233 @@ static SslEndPoint_t *GetSslPeer(const CAEndpoint_t *peer)
     VERIFY_NON_NULL_RET(peer, NET_SSL_TAG, "TLS peer is NULL", NULL);
     VERIFY_NON_NULL_RET(g_caSslContext, NET_SSL_TAG, "SSL Context is NULL", NULL);
 
-    SslEndPoint_t *tep = NULL;
-    listLength = u_arraylist_length(g_caSslContext->peerList);
-    for (listIndex = 0; listIndex < listLength; listIndex++)
+    if (0 == g_caSslContext->peerTableSize)
     {
-        tep = (SslEndPoint_t *) u_arraylist_get(g_caSslContext->peerList, listIndex);
-        if (NULL == tep)
+        OIC_LOG(DEBUG, NET_SSL_TAG, "Return NULL");
+        return NULL;
+    }
+
+    SslEndPoint_t *tep = g_caSslContext->peerTable[GetSslPeerBucket(peer)];
+    while (tep && !IsSameSslEndpoint(&tep->sep.endpoint, peer))
+    {
+        tep = tep->next;
+    }
+    if (NULL == tep)
+    {
+        OIC_LOG(DEBUG, NET_SSL_TAG, "Return NULL");
+    }
+    OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+    return tep;
+}
+
+/**
+ * Checks whether a session may be resumed. Only the sessions authenticated with
+ * certificates are: the identity of the peer of a PSK session is set by the credentials
+ * callback, which is not called on resumption, and anonymous sessions are only used for
+ * ownership transfer.
+ *
+ * @param[in]  session    session to check
+ *
+ * @return  true if the session may be resumed
+ */
+static bool IsResumableSession(const mbedtls_ssl_session *session)
+{
+    return (MBEDTLS_TLS_ECDHE_PSK_WITH_AES_128_CBC_SHA256 != session->ciphersuite) &&
+           (MBEDTLS_TLS_ECDH_ANON_WITH_AES_128_CBC_SHA256 != session->ciphersuite);
+}
+
+/**
+ * Session cache callback of the server configurations, which keeps the resumable
+ * sessions only.
+ */
+static int SetServerSession(void *cache, const mbedtls_ssl_session *session)
+{
+    if (!IsResumableSession(session))
+    {
+        return -1;
+    }
+    return mbedtls_ssl_cache_set(cache, session);
+}
+
+/**
+ * Session ticket callback of the server configurations, which issues tickets for the
+ * resumable sessions only.
+ */
+static int WriteSessionTicket(void *ticketCtx, const mbedtls_ssl_session *session,
+                              unsigned char *start, const unsigned char *end,
+                              size_t *tlen, uint32_t *lifetime)
+{
+    if (!IsResumableSession(session))
+    {
+        return MBEDTLS_ERR_SSL_FEATURE_UNAVAILABLE;
+    }
+    return mbedtls_ssl_ticket_write(ticketCtx, session, start, end, tlen, lifetime);
+}
+
+/**
+ * Sets up the session cache and the session ticket keys of the server configurations.
+ * Must be called with g_sslContextMutex held.
+ *
+ * @return  0 on success, or an mbedTLS error code
+ */
+static int SetupServerSessions(void)
+{
+    mbedtls_ssl_cache_set_max_entries(&g_caSslContext->sessionCache, SSL_SESSION_CACHE_SIZE);
+    mbedtls_ssl_cache_set_timeout(&g_caSslContext->sessionCache, SSL_SESSION_LIFETIME);
+    return mbedtls_ssl_ticket_setup(&g_caSslContext->ticketCtx, mbedtls_ctr_drbg_random,
+                                    &g_caSslContext->rnd, MBEDTLS_CIPHER_AES_256_GCM,
+                                    SSL_SESSION_LIFETIME);
+}
+
+/*
+ * The client session functions below must be called with g_sslContextMutex held.
+ */
+
+static void DeleteClientSession(SslClientSession_t *entry)
+{
+    mbedtls_ssl_session_free(&entry->session);
+    OICFree(entry);
+}
+
+static void DeleteClientSessions(void)
+{
+    if (NULL == g_caSslContext->clientSessions)
+    {
+        return;
+    }
+    size_t listLength = u_arraylist_length(g_caSslContext->clientSessions);
+    for (size_t listIndex = 0; listIndex < listLength; listIndex++)
+    {
+        DeleteClientSession((SslClientSession_t *) u_arraylist_get(g_caSslContext->clientSessions,
+                                                                   listIndex));
+    }
+    u_arraylist_free(&g_caSslContext->clientSessions);
+}
+
+static bool IsExpiredClientSession(const SslClientSession_t *entry)
+{
+    mbedtls_time_t now = mbedtls_time(NULL);
+    return (entry->session.start > now) || (now - entry->session.start >= SSL_SESSION_LIFETIME);
+}
+
+/**
+ * Adds a session to the client sessions, replacing the session of the same server and
+ * the oldest session if the cache is full.
+ *
+ * @param[in]  entry    session to add, owned by the cache on success
+ *
+ * @return  true on success
+ */
+static bool AddClientSession(SslClientSession_t *entry)
+{
+    if (NULL == g_caSslContext->clientSessions)
+    {
+        g_caSslContext->clientSessions = u_arraylist_create();
+        if (NULL == g_caSslContext->clientSessions)
+        {
+            OIC_LOG(ERROR, NET_SSL_TAG, "clientSessions initialization failed!");
+            return false;
+        }
+    }
+
+    size_t listLength = u_arraylist_length(g_caSslContext->clientSessions);
+    for (size_t listIndex = 0; listIndex < listLength; listIndex++)
+    {
+        SslClientSession_t *old =
+            (SslClientSession_t *) u_arraylist_get(g_caSslContext->clientSessions, listIndex);
+        if (IsSameSslEndpoint(&old->endpoint, &entry->endpoint))
+        {
+            u_arraylist_remove(g_caSslContext->clientSessions, listIndex);
+            DeleteClientSession(old);
+            listLength--;
+            break;
+        }
+    }
+    if (SSL_SESSION_CACHE_SIZE <= listLength)
+    {
+        DeleteClientSession((SslClientSession_t *)
+                            u_arraylist_remove(g_caSslContext->clientSessions, 0));
+    }
+
+    return u_arraylist_add(g_caSslContext->clientSessions, (void *) entry);
+}
+
+/**
+ * Keeps the session established as client, so that the next handshake with the server
+ * resumes it.
+ *
+ * @param[in]  tep    endpoint with an established session
+ */
+static void SaveClientSession(const SslEndPoint_t *tep)
+{
+    if (!IsResumableSession(tep->ssl.session))
+    {
+        return;
+    }
+
+    SslClientSession_t *entry = (SslClientSession_t *) OICCalloc(1, sizeof(SslClientSession_t));
+    if (NULL == entry)
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "Malloc failed!");
+        return;
+    }
+    entry->endpoint = tep->sep.endpoint;
+    mbedtls_ssl_session_init(&entry->session);
+    if (0 != mbedtls_ssl_get_session(&tep->ssl, &entry->session) || !AddClientSession(entry))
+    {
+        OIC_LOG(WARNING, NET_SSL_TAG, "Failed to keep session for resumption");
+        DeleteClientSession(entry);
+    }
+}
+
+/**
+ * Offers the kept session of the server, if any, in the handshake of a client endpoint.
+ *
+ * @param[in]  tep    endpoint before its handshake
+ */
+static void LoadClientSession(SslEndPoint_t *tep)
+{
+    if (NULL == g_caSslContext->clientSessions)
+    {
+        return;
+    }
+
+    size_t listLength = u_arraylist_length(g_caSslContext->clientSessions);
+    for (size_t listIndex = 0; listIndex < listLength; listIndex++)
+    {
+        SslClientSession_t *entry =
+            (SslClientSession_t *) u_arraylist_get(g_caSslContext->clientSessions, listIndex);
+        if (!IsSameSslEndpoint(&entry->endpoint, &tep->sep.endpoint))
         {
             continue;
         }
 
-        OIC_LOG_V(DEBUG, NET_SSL_TAG, "Compare [%s:%d] and [%s:%d] for %d adapter",
-                  peer->addr, peer->port, tep->sep.endpoint.addr, tep->sep.endpoint.port,
-                  peer->adapter);
+        if (IsExpiredClientSession(entry))
+        {
+            u_arraylist_remove(g_caSslContext->clientSessions, listIndex);
+            DeleteClientSession(entry);
+            return;
+        }
 
-        if((peer->adapter == tep->sep.endpoint.adapter)
-                && (0 == strncmp(peer->addr, tep->sep.endpoint.addr, MAX_ADDR_STR_SIZE_CA))
-                && (peer->port == tep->sep.endpoint.port || CA_ADAPTER_GATT_BTLE == peer->adapter))
+        // Do not resume a session of another ciphersuite than the one selected.
+        if (SSL_CIPHER_MAX != g_caSslContext->cipher &&
+            tlsCipher[g_caSslContext->cipher][0] != entry->session.ciphersuite)
         {
-            OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
-            return tep;
+            return;
         }
+        for (size_t i = 0; i < SSL_CIPHER_MAX && 0 != g_cipherSuitesList[i]; i++)
+        {
+            if (g_cipherSuitesList[i] == entry->session.ciphersuite)
+            {
+                if (0 != mbedtls_ssl_set_session(&tep->ssl, &entry->session))
+                {
+                    OIC_LOG(WARNING, NET_SSL_TAG, "Failed to set session for resumption");
+                }
+                return;
+            }
+        }
+        return;
     }
-    OIC_LOG(DEBUG, NET_SSL_TAG, "Return NULL");
-    OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
-    return NULL;
 }
 
 /**
@@ -1120,6 +1655,16 @@ static void DeleteSslEndPoint(SslEndPoint_t * tep)
 
     mbedtls_ssl_free(&tep->ssl);
     DeleteCacheList(tep->cacheList);
+    while (NULL != tep->pendingRecords)
+    {
+        SslPendingRecord_t *record = tep->pendingRecords;
+        tep->pendingRecords = record->next;
+        OICFree(record);
+    }
+    if (NULL != tep->mutex)
+    {
+        oc_mutex_free(tep->mutex);
+    }
     OICFree(tep);
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
 }
@@ -1135,21 +1680,10 @@ static void RemovePeerFromList(CAEndpoint_t * endpoint)
     VERIFY_NON_NULL_VOID(g_caSslContext, NET_SSL_TAG, "SSL Context is NULL");
     VERIFY_NON_NULL_VOID(endpoint, NET_SSL_TAG, "endpoint");
 
-    size_t listLength = u_arraylist_length(g_caSslContext->peerList);
-    for (size_t listIndex = 0; listIndex < listLength; listIndex++)
+    SslEndPoint_t * tep = GetSslPeer(endpoint);
+    if (NULL != tep)
     {
-        SslEndPoint_t * tep = (SslEndPoint_t *)u_arraylist_get(g_caSslContext->peerList, listIndex);
-        if (NULL == tep)
-        {
-            continue;
-        }
-        if(0 == strncmp(endpoint->addr, tep->sep.endpoint.addr, MAX_ADDR_STR_SIZE_CA)
-                && (endpoint->port == tep->sep.endpoint.port))
-        {
-            u_arraylist_remove(g_caSslContext->peerList, listIndex);
-            DeleteSslEndPoint(tep);
-            return;
-        }
+        RemoveSslPeer(tep);
     }
 }
 
@@ -1258,15 +1792,11 @@ static void DeletePeerList(void)
 
     VERIFY_NON_NULL_VOID(g_caSslContext, NET_SSL_TAG, "SSL Context is NULL");
 
-    size_t listLength = u_arraylist_length(g_caSslContext->peerList);
-    for (size_t listIndex = 0; listIndex < listLength; listIndex++)
+    for (size_t listLength = u_arraylist_length(g_caSslContext->peerList); listLength > 0; listLength--)
     {
-        SslEndPoint_t * tep = (SslEndPoint_t *)u_arraylist_get(g_caSslContext->peerList, listIndex);
-        if (NULL == tep)
-        {
-            continue;
-        }
-        if (MBEDTLS_SSL_HANDSHAKE_OVER == tep->ssl.state)
+        SslEndPoint_t * tep = (SslEndPoint_t *)u_arraylist_get(g_caSslContext->peerList, listLength - 1);
+        oc_mutex_lock(tep->mutex);
+        if (tep->established)
         {
             int ret = 0;
             do
@@ -1275,9 +1805,19 @@ static void DeletePeerList(void)
             }
             while (MBEDTLS_ERR_SSL_WANT_WRITE == ret);
         }
-        DeleteSslEndPoint(tep);
+        oc_mutex_unlock(tep->mutex);
+        RemoveSslPeer(tep);
+    }
+
+    // The peers still used by other threads are deleted once released.
+    while (0 < g_sslPeersInUse)
+    {
+        oc_cond_wait(g_sslPeersReleasedCond, g_sslContextMutex);
     }
     u_arraylist_free(&g_caSslContext->peerList);
+    OICFree(g_caSslContext->peerTable);
+    g_caSslContext->peerTable = NULL;
+    g_caSslContext->peerTableSize = 0;
 }
 
 CAResult_t CAcloseSslConnection(const CAEndpoint_t *endpoint)
@@ -1301,18 +1841,20 @@ CAResult_t CAcloseSslConnection(const CAEndpoint_t *endpoint)
     }
     /* No error checking, the connection might be closed already */
     int ret = 0;
+    oc_mutex_lock(tep->mutex);
     do
     {
         ret = mbedtls_ssl_close_notify(&tep->ssl);
     }
     while (MBEDTLS_ERR_SSL_WANT_WRITE == ret);
+    oc_mutex_unlock(tep->mutex);
 
     if (NULL != g_closeSslConnectionCallback)
     {
         g_closeSslConnectionCallback(tep->sep.identity.id, tep->sep.identity.id_length);
     }
 
-    RemovePeerFromList(&tep->sep.endpoint);
+    RemoveSslPeer(tep);
     oc_mutex_unlock(g_sslContextMutex);
 
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
@@ -1359,8 +1901,7 @@ void CAcloseSslConnectionAll(CATransportAdapter_t transportType)
         while (MBEDTLS_ERR_SSL_WANT_WRITE == ret);*/
 
         // delete from list
-        u_arraylist_remove(g_caSslContext->peerList, i - 1);
-        DeleteSslEndPoint(tep);
+        RemoveSslPeer(tep);
     }
     oc_mutex_unlock(g_sslContextMutex);
 
@@ -1501,6 +2042,14 @@ static SslEndPoint_t * NewSslEndPoint(const CAEndpoint_t * endpoint, mbedtls_ssl
         OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
         return NULL;
     }
+    tep->mutex = oc_mutex_new_recursive();
+    if (NULL == tep->mutex)
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "mutex initialization failed!");
+        DeleteSslEndPoint(tep);
+        OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+        return NULL;
+    }
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "New [%s role] endpoint added [%s:%d]",
             (MBEDTLS_SSL_IS_SERVER==config->endpoint ? "server" : "client"),
             endpoint->addr, endpoint->port);
@@ -1666,14 +2215,14 @@ static SslEndPoint_t * InitiateTlsHandshake(const CAEndpoint_t *endpoint)
     }
 
     oc_mutex_lock(g_sslContextMutex);
-    ret = u_arraylist_add(g_caSslContext->peerList, (void *) tep);
-    if (!ret)
+    if (!AddSslPeer(tep))
     {
         oc_mutex_unlock(g_sslContextMutex);
-        OIC_LOG(ERROR, NET_SSL_TAG, "u_arraylist_add failed!");
+        OIC_LOG(ERROR, NET_SSL_TAG, "AddSslPeer failed!");
         DeleteSslEndPoint(tep);
         return NULL;
     }
+    LoadClientSession(tep);
 
     while (MBEDTLS_SSL_HANDSHAKE_OVER > tep->ssl.state)
     {
@@ -1694,9 +2243,9 @@ static SslEndPoint_t * InitiateTlsHandshake(const CAEndpoint_t *endpoint)
                                "Handshake error",
                                MBEDTLS_SSL_ALERT_MSG_HANDSHAKE_FAILURE))
         {
+            // checkSslOperation() removed and deleted the peer.
             oc_mutex_unlock(g_sslContextMutex);
             OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
-            DeleteSslEndPoint(tep);
             return NULL;
         }
     }
@@ -1730,6 +2279,9 @@ void CAdeinitSslAdapter(bool cleanup)
 
     // Clear all lists
     DeletePeerList();
+    DeleteClientSessions();
+    mbedtls_ssl_cache_free(&g_caSslContext->sessionCache);
+    mbedtls_ssl_ticket_free(&g_caSslContext->ticketCtx);
 
     // De-initialize mbedTLS
     mbedtls_x509_crt_free(&g_caSslContext->crt);
@@ -1781,6 +2333,8 @@ void CAcleanupSslAdapter(void)
     {
         oc_mutex_free(g_sslContextMutex);
         g_sslContextMutex = NULL;
+        oc_cond_free(g_sslPeersReleasedCond);
+        g_sslPeersReleasedCond = NULL;
     }
 
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s ", __func__);
@@ -1807,6 +2361,14 @@ static int InitConfig(mbedtls_ssl_config * conf, int transport, int mode)
     mbedtls_ssl_conf_curves(conf, curve[ADAPTER_CURVE_SECP256R1]);
     mbedtls_ssl_conf_authmode(conf, MBEDTLS_SSL_VERIFY_REQUIRED);
 
+    if (MBEDTLS_SSL_IS_SERVER == mode)
+    {
+        mbedtls_ssl_conf_session_cache(conf, &g_caSslContext->sessionCache,
+                                       mbedtls_ssl_cache_get, SetServerSession);
+        mbedtls_ssl_conf_session_tickets_cb(conf, WriteSessionTicket, mbedtls_ssl_ticket_parse,
+                                            &g_caSslContext->ticketCtx);
+    }
+
 #ifdef __WITH_DTLS__
     if (MBEDTLS_SSL_TRANSPORT_DATAGRAM == transport &&
             MBEDTLS_SSL_IS_SERVER == mode)
@@ -1858,7 +2420,7 @@ static void StartRetransmit(void *ctx)
             tep = (SslEndPoint_t *) u_arraylist_get(g_caSslContext->peerList, listIndex);
             if (NULL == tep
                 || (tep->ssl.conf && MBEDTLS_SSL_TRANSPORT_STREAM == tep->ssl.conf->transport)
-                || MBEDTLS_SSL_HANDSHAKE_OVER == tep->ssl.state)
+                || tep->established)
             {
                 continue;
             }
@@ -1895,6 +2457,14 @@ CAResult_t CAinitSslAdapter(void)
         g_sslContextMutex = oc_mutex_new_recursive();
         VERIFY_NON_NULL_RET(g_sslContextMutex, NET_SSL_TAG, "oc_mutex_new_recursive failed",
             CA_MEMORY_ALLOC_FAILED);
+        g_sslPeersReleasedCond = oc_cond_new();
+        if (NULL == g_sslPeersReleasedCond)
+        {
+            OIC_LOG(ERROR, NET_SSL_TAG, "oc_cond_new failed");
+            oc_mutex_free(g_sslContextMutex);
+            g_sslContextMutex = NULL;
+            return CA_MEMORY_ALLOC_FAILED;
+        }
 
         oc_mutex_lock(g_sslContextMutex);
         g_sslInterestedThreadsCount = 0;
@@ -1922,6 +2492,8 @@ CAResult_t CAinitSslAdapter(void)
         oc_mutex_unlock(g_sslContextMutex);
         oc_mutex_free(g_sslContextMutex);
         g_sslContextMutex = NULL;
+        oc_cond_free(g_sslPeersReleasedCond);
+        g_sslPeersReleasedCond = NULL;
         return CA_MEMORY_ALLOC_FAILED;
     }
 
@@ -1936,6 +2508,8 @@ CAResult_t CAinitSslAdapter(void)
         oc_mutex_unlock(g_sslContextMutex);
         oc_mutex_free(g_sslContextMutex);
         g_sslContextMutex = NULL;
+        oc_cond_free(g_sslPeersReleasedCond);
+        g_sslPeersReleasedCond = NULL;
         return CA_STATUS_FAILED;
     }
 
@@ -1955,6 +2529,8 @@ CAResult_t CAinitSslAdapter(void)
      */
     mbedtls_entropy_init(&g_caSslContext->entropy);
     mbedtls_ctr_drbg_init(&g_caSslContext->rnd);
+    mbedtls_ssl_cache_init(&g_caSslContext->sessionCache);
+    mbedtls_ssl_ticket_init(&g_caSslContext->ticketCtx);
 
     if(0 != mbedtls_ctr_drbg_seed(&g_caSslContext->rnd, mbedtls_entropy_func,
                                   &g_caSslContext->entropy,
@@ -1967,6 +2543,16 @@ CAResult_t CAinitSslAdapter(void)
     }
     mbedtls_ctr_drbg_set_prediction_resistance(&g_caSslContext->rnd, MBEDTLS_CTR_DRBG_PR_ON);
 
+    /* Session resumption settings
+     */
+    if (0 != SetupServerSessions())
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "Session ticket setup failed!");
+        oc_mutex_unlock(g_sslContextMutex);
+        CAdeinitSslAdapter(true);
+        return CA_STATUS_FAILED;
+    }
+
 #ifdef __WITH_TLS__
     if (0 != InitConfig(&g_caSslContext->clientTlsConf,
                         MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_IS_CLIENT))
@@ -2116,31 +2702,68 @@ CAResult_t CAencryptSsl(const CAEndpoint_t *endpoint,
         return CA_STATUS_FAILED;
     }
 
-    if (MBEDTLS_SSL_HANDSHAKE_OVER == tep->ssl.state)
+    if (tep->established)
     {
+        int adapterIndex = GetAdapterIndex(tep->sep.endpoint.adapter);
+        if (0 > adapterIndex)
+        {
+            OIC_LOG(ERROR, NET_SSL_TAG, "Unsupported adapter");
+            oc_mutex_unlock(g_sslContextMutex);
+            return CA_STATUS_FAILED;
+        }
+        CAPacketSendCallback sendCallback =
+            g_caSslContext->adapterCallbacks[adapterIndex].sendCallback;
+
+        // Encrypt without g_sslContextMutex, so that different peers are served in parallel.
+        AcquireSslPeer(tep);
+        oc_mutex_unlock(g_sslContextMutex);
+
+        CAResult_t res = CA_STATUS_OK;
         unsigned char *dataBuf = (unsigned char *)data;
         size_t written = 0;
 
-        do
+        oc_mutex_lock(tep->mutex);
+        if (tep->removed)
         {
-            ret = mbedtls_ssl_write(&tep->ssl, dataBuf, dataLen - written);
-            if (ret < 0)
+            OIC_LOG(ERROR, NET_SSL_TAG, "Session was closed");
+            res = CA_STATUS_FAILED;
+        }
+        else
+        {
+            tep->deferSend = true;
+            do
             {
-                if (MBEDTLS_ERR_SSL_WANT_WRITE != ret)
+                ret = mbedtls_ssl_write(&tep->ssl, dataBuf, dataLen - written);
+                if (ret < 0)
                 {
-                    OIC_LOG_V(ERROR, NET_SSL_TAG, "mbedTLS write failed! returned 0x%x", -ret);
-                    RemovePeerFromList(&tep->sep.endpoint);
-                    oc_mutex_unlock(g_sslContextMutex);
-                    return CA_STATUS_FAILED;
+                    if (MBEDTLS_ERR_SSL_WANT_WRITE != ret)
+                    {
+                        OIC_LOG_V(ERROR, NET_SSL_TAG, "mbedTLS write failed! returned 0x%x", -ret);
+                        res = CA_STATUS_FAILED;
+                        break;
+                    }
+                    continue;
                 }
-                continue;
-            }
-            OIC_LOG_V(DEBUG, NET_SSL_TAG, "mbedTLS write returned with sent bytes[%d]", ret);
+                OIC_LOG_V(DEBUG, NET_SSL_TAG, "mbedTLS write returned with sent bytes[%d]", ret);
+
+                dataBuf += ret;
+                written += ret;
+            } while (dataLen > written);
+            tep->deferSend = false;
+        }
+        oc_mutex_unlock(tep->mutex);
+        FlushSslRecords(tep, sendCallback);
 
-            dataBuf += ret;
-            written += ret;
-        } while (dataLen > written);
+        if (CA_STATUS_OK != res)
+        {
+            oc_mutex_lock(g_sslContextMutex);
+            RemoveSslPeer(tep);
+            oc_mutex_unlock(g_sslContextMutex);
+        }
+        ReleaseSslPeer(tep);
 
+        OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+        return res;
     }
     else
     {
@@ -2252,6 +2875,104 @@ void CAsetSslHandshakeCallback(CAHandshakeErrorCallback tlsHandshakeCallback)
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s(%p)", __func__, tlsHandshakeCallback);
 }
 
+/**
+ * Decrypts a record received on an established session and passes the data to the
+ * upper layer. Must be called with g_sslContextMutex held, which is released while the
+ * record is decrypted so that the records of different peers are decrypted in parallel.
+ *
+ * @param[in]  peer    remote address with session info
+ * @param[in]  data    received record
+ * @param[in]  dataLen    record length
+ *
+ * @return  CA_STATUS_OK on success; other error code on failure
+ */
+static CAResult_t DecryptSslRecord(SslEndPoint_t * peer, uint8_t *data, size_t dataLen)
+{
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+
+    int adapterIndex = GetAdapterIndex(peer->sep.endpoint.adapter);
+    if (0 > adapterIndex)
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "Unsuported adapter");
+        RemoveSslPeer(peer);
+        oc_mutex_unlock(g_sslContextMutex);
+        return CA_STATUS_FAILED;
+    }
+    SslCallbacks_t callbacks = g_caSslContext->adapterCallbacks[adapterIndex];
+    CASecureEndpoint_t sep = peer->sep;
+    AcquireSslPeer(peer);
+    oc_mutex_unlock(g_sslContextMutex);
+
+    uint8_t decryptBuffer[TLS_MSG_BUF_LEN] = {0};
+    int ret = 0;
+    bool closed = false;
+
+    oc_mutex_lock(peer->mutex);
+    if (peer->removed)
+    {
+        oc_mutex_unlock(peer->mutex);
+        OIC_LOG(ERROR, NET_SSL_TAG, "Session was closed");
+        ReleaseSslPeer(peer);
+        return CA_STATUS_FAILED;
+    }
+
+    peer->recBuf.buff = data;
+    peer->recBuf.len = dataLen;
+    peer->recBuf.loaded = 0;
+    peer->deferSend = true;
+    do
+    {
+        ret = mbedtls_ssl_read(&peer->ssl, decryptBuffer, TLS_MSG_BUF_LEN);
+    } while (MBEDTLS_ERR_SSL_WANT_READ == ret);
+
+    if (MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY == ret ||
+        // TinyDTLS sends fatal close_notify alert
+        (MBEDTLS_ERR_SSL_FATAL_ALERT_MESSAGE == ret &&
+         MBEDTLS_SSL_ALERT_LEVEL_FATAL == peer->ssl.in_msg[0] &&
+         MBEDTLS_SSL_ALERT_MSG_CLOSE_NOTIFY == peer->ssl.in_msg[1]))
+    {
+        OIC_LOG(INFO, NET_SSL_TAG, "Connection was closed gracefully");
+        closed = true;
+        do
+        {
+            ret = mbedtls_ssl_close_notify(&peer->ssl);
+        }
+        while (MBEDTLS_ERR_SSL_WANT_WRITE == ret);
+    }
+    peer->deferSend = false;
+    oc_mutex_unlock(peer->mutex);
+    FlushSslRecords(peer, callbacks.sendCallback);
+
+    CAResult_t res = CA_STATUS_OK;
+    if (closed)
+    {
+        oc_mutex_lock(g_sslContextMutex);
+        if (NULL != g_closeSslConnectionCallback)
+        {
+            g_closeSslConnectionCallback(sep.identity.id, sep.identity.id_length);
+        }
+        RemoveSslPeer(peer);
+        oc_mutex_unlock(g_sslContextMutex);
+    }
+    else if (0 > ret)
+    {
+        OIC_LOG_V(ERROR, NET_SSL_TAG, "mbedtls_ssl_read returned -0x%x", -ret);
+        callbacks.errorCallback(&sep.endpoint, data, dataLen, CA_STATUS_FAILED);
+        oc_mutex_lock(g_sslContextMutex);
+        RemoveSslPeer(peer);
+        oc_mutex_unlock(g_sslContextMutex);
+        res = CA_STATUS_FAILED;
+    }
+    else if (0 < ret)
+    {
+        callbacks.recvCallback(&sep, decryptBuffer, ret);
+    }
+
+    ReleaseSslPeer(peer);
+    OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+    return res;
+}
+
 /* Read data from TLS connection
  */
 CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dataLen)
@@ -2291,16 +3012,20 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
             return CA_STATUS_FAILED;
         }
 
-        ret = u_arraylist_add(g_caSslContext->peerList, (void *) peer);
-        if (!ret)
+        if (!AddSslPeer(peer))
         {
-            OIC_LOG(ERROR, NET_SSL_TAG, "u_arraylist_add failed!");
+            OIC_LOG(ERROR, NET_SSL_TAG, "AddSslPeer failed!");
             DeleteSslEndPoint(peer);
             oc_mutex_unlock(g_sslContextMutex);
             return CA_STATUS_FAILED;
         }
     }
 
+    if (peer->established)
+    {
+        return DecryptSslRecord(peer, data, dataLen);
+    }
+
     peer->recBuf.buff = data;
     peer->recBuf.len = dataLen;
     peer->recBuf.loaded = 0;
@@ -2405,6 +3130,14 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
         {
             memcpy(peer->random, peer->ssl.handshake->randbytes, sizeof(peer->random));
         }
+        else if (MBEDTLS_SSL_SERVER_CHANGE_CIPHER_SPEC == peer->ssl.state &&
+                 peer->ssl.handshake->resume)
+        {
+            /* A resumed handshake skips the key exchange, and its keys are already derived,
+             * which swapped the client and server randoms. */
+            memcpy(peer->random, peer->ssl.handshake->randbytes + RANDOM_LEN, RANDOM_LEN);
+            memcpy(peer->random + RANDOM_LEN, peer->ssl.handshake->randbytes, RANDOM_LEN);
+        }
 
         if (MBEDTLS_SSL_HANDSHAKE_OVER == peer->ssl.state)
         {
@@ -2550,67 +3283,20 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
                 peer->sep.publicKeyLength = 0;
             }
 
-            oc_mutex_unlock(g_sslContextMutex);
-            OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
-            return CA_STATUS_OK;
-        }
-    }
-
-    if (MBEDTLS_SSL_HANDSHAKE_OVER == peer->ssl.state)
-    {
-        uint8_t decryptBuffer[TLS_MSG_BUF_LEN] = {0};
-        do
-        {
-            ret = mbedtls_ssl_read(&peer->ssl, decryptBuffer, TLS_MSG_BUF_LEN);
-        } while (MBEDTLS_ERR_SSL_WANT_READ == ret);
-
-        if (MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY == ret ||
-            // TinyDTLS sends fatal close_notify alert
-            (MBEDTLS_ERR_SSL_FATAL_ALERT_MESSAGE == ret &&
-             MBEDTLS_SSL_ALERT_LEVEL_FATAL == peer->ssl.in_msg[0] &&
-             MBEDTLS_SSL_ALERT_MSG_CLOSE_NOTIFY == peer->ssl.in_msg[1]))
-        {
-            OIC_LOG(INFO, NET_SSL_TAG, "Connection was closed gracefully");
-
-            if (NULL != g_closeSslConnectionCallback)
+            if (MBEDTLS_SSL_IS_CLIENT == peer->ssl.conf->endpoint)
             {
-                g_closeSslConnectionCallback(peer->sep.identity.id, peer->sep.identity.id_length);
+                SaveClientSession(peer);
             }
 
-            do
-            {
-                ret = mbedtls_ssl_close_notify(&peer->ssl);
-            }
-            while (MBEDTLS_ERR_SSL_WANT_WRITE == ret);
+            // From now on the session is used under the mutex of the peer only.
+            oc_mutex_lock(peer->mutex);
+            peer->established = true;
+            oc_mutex_unlock(peer->mutex);
 
-            RemovePeerFromList(&peer->sep.endpoint);
             oc_mutex_unlock(g_sslContextMutex);
+            OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
             return CA_STATUS_OK;
         }
-
-        int adapterIndex = GetAdapterIndex(peer->sep.endpoint.adapter);
-        if (adapterIndex >= 0)
-        {
-            if (0 > ret)
-            {
-                OIC_LOG_V(ERROR, NET_SSL_TAG, "mbedtls_ssl_read returned -0x%x", -ret);
-                g_caSslContext->adapterCallbacks[adapterIndex].errorCallback(&peer->sep.endpoint, peer->recBuf.buff, peer->recBuf.len, CA_STATUS_FAILED);
-                RemovePeerFromList(&peer->sep.endpoint);
-                oc_mutex_unlock(g_sslContextMutex);
-                return CA_STATUS_FAILED;
-            }
-            else if (0 < ret)
-            {
-                g_caSslContext->adapterCallbacks[adapterIndex].recvCallback(&peer->sep, decryptBuffer, ret);
-            }
-        }
-        else
-        {
-            OIC_LOG(ERROR, NET_SSL_TAG, "Unsuported adapter");
-            RemovePeerFromList(&peer->sep.endpoint);
-            oc_mutex_unlock(g_sslContextMutex);
-            return CA_STATUS_FAILED;
-        }
     }
 
     oc_mutex_unlock(g_sslContextMutex);
@@ -3033,3 +3719,229 @@ CAResult_t CAsslGenerateOwnerPsk(const CAEndpoint_t *endpoint,
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
     return CA_STATUS_OK;
 }
+
+/*
+ * Client sessions are serialized as the layout (the size of SslClientSession_t) and the
+ * count of the sessions, followed by each session: its SslClientSession_t, then the
+ * length and bytes of its peer certificate and of its ticket.
+ */
+
+static uint8_t *WriteSslBytes(uint8_t *p, const void *bytes, size_t len)
+{
+    memcpy(p, bytes, len);
+    return p + len;
+}
+
+static uint8_t *WriteSslBlob(uint8_t *p, const void *bytes, size_t len)
+{
+    uint32_t blobLen = (uint32_t)len;
+    p = WriteSslBytes(p, &blobLen, sizeof(blobLen));
+    return WriteSslBytes(p, bytes, len);
+}
+
+static bool ReadSslBytes(const uint8_t **p, const uint8_t *end, void *bytes, size_t len)
+{
+    if ((size_t)(end - *p) < len)
+    {
+        return false;
+    }
+    memcpy(bytes, *p, len);
+    *p += len;
+    return true;
+}
+
+static bool ReadSslBlob(const uint8_t **p, const uint8_t *end,
+                        const uint8_t **bytes, uint32_t *len)
+{
+    if (!ReadSslBytes(p, end, len, sizeof(*len)) || (size_t)(end - *p) < *len)
+    {
+        return false;
+    }
+    *bytes = *p;
+    *p += *len;
+    return true;
+}
+
+CAResult_t CAsslSaveClientSessions(uint8_t **data, size_t *dataLen)
+{
+    OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
+    VERIFY_NON_NULL_RET(data, NET_SSL_TAG, "data is NULL", CA_STATUS_INVALID_PARAM);
+    VERIFY_NON_NULL_RET(dataLen, NET_SSL_TAG, "dataLen is NULL", CA_STATUS_INVALID_PARAM);
+
+    oc_mutex_lock(g_sslContextMutex);
+    if (NULL == g_caSslContext)
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "SSL Context is NULL");
+        oc_mutex_unlock(g_sslContextMutex);
+        return CA_STATUS_NOT_INITIALIZED;
+    }
+
+    size_t listLength = u_arraylist_length(g_caSslContext->clientSessions);
+    size_t size = 2 * sizeof(uint32_t);
+    for (size_t listIndex = 0; listIndex < listLength; listIndex++)
+    {
+        const SslClientSession_t *entry =
+            (const SslClientSession_t *) u_arraylist_get(g_caSslContext->clientSessions, listIndex);
+        size += sizeof(SslClientSession_t) + 2 * sizeof(uint32_t) + entry->session.ticket_len;
+        if (NULL != entry->session.peer_cert)
+        {
+            size += entry->session.peer_cert->raw.len;
+        }
+    }
+
+    uint8_t *buf = (uint8_t *) OICMalloc(size);
+    if (NULL == buf)
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "Malloc failed!");
+        oc_mutex_unlock(g_sslContextMutex);
+        return CA_MEMORY_ALLOC_FAILED;
+    }
+
+    uint32_t value = sizeof(SslClientSession_t);
+    uint8_t *p = WriteSslBytes(buf, &value, sizeof(value));
+    value = (uint32_t)listLength;
+    p = WriteSslBytes(p, &value, sizeof(value));
+    for (size_t listIndex = 0; listIndex < listLength; listIndex++)
+    {
+        const SslClientSession_t *entry =
+            (const SslClientSession_t *) u_arraylist_get(g_caSslContext->clientSessions, listIndex);
+        const mbedtls_x509_crt *peerCert = entry->session.peer_cert;
+        p = WriteSslBytes(p, entry, sizeof(*entry));
+        p = WriteSslBlob(p, peerCert ? peerCert->raw.p : NULL, peerCert ? peerCert->raw.len : 0);
+        p = WriteSslBlob(p, entry->session.ticket, entry->session.ticket_len);
+    }
+    oc_mutex_unlock(g_sslContextMutex);
+
+    *data = buf;
+    *dataLen = size;
+    OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+    return CA_STATUS_OK;
+}
+
+CAResult_t CAsslLoadClientSessions(const uint8_t *data, size_t dataLen)
+{
+    OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
+    VERIFY_NON_NULL_RET(data, NET_SSL_TAG, "data is NULL", CA_STATUS_INVALID_PARAM);
+
+    const uint8_t *p = data;
+    const uint8_t *end = data + dataLen;
+    uint32_t layout = 0;
+    uint32_t count = 0;
+    if (!ReadSslBytes(&p, end, &layout, sizeof(layout)) ||
+        (sizeof(SslClientSession_t) != layout) ||
+        !ReadSslBytes(&p, end, &count, sizeof(count)))
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "Invalid client sessions");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    oc_mutex_lock(g_sslContextMutex);
+    if (NULL == g_caSslContext)
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "SSL Context is NULL");
+        oc_mutex_unlock(g_sslContextMutex);
+        return CA_STATUS_NOT_INITIALIZED;
+    }
+
+    CAResult_t res = CA_STATUS_OK;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        SslClientSession_t *entry = (SslClientSession_t *) OICCalloc(1, sizeof(SslClientSession_t));
+        if (NULL == entry)
+        {
+            OIC_LOG(ERROR, NET_SSL_TAG, "Malloc failed!");
+            res = CA_MEMORY_ALLOC_FAILED;
+            break;
+        }
+
+        const uint8_t *cert = NULL;
+        const uint8_t *ticket = NULL;
+        uint32_t certLen = 0;
+        uint32_t ticketLen = 0;
+        bool valid = ReadSslBytes(&p, end, entry, sizeof(*entry));
+        // The pointers of the serialized session are meaningless.
+        entry->session.peer_cert = NULL;
+        entry->session.ticket = NULL;
+        entry->session.ticket_len = 0;
+        valid = valid && ReadSslBlob(&p, end, &cert, &certLen) &&
+                ReadSslBlob(&p, end, &ticket, &ticketLen);
+
+        if (valid && 0 < certLen)
+        {
+            entry->session.peer_cert = (mbedtls_x509_crt *) mbedtls_calloc(1, sizeof(mbedtls_x509_crt));
+            if (NULL == entry->session.peer_cert)
+            {
+                OIC_LOG(ERROR, NET_SSL_TAG, "Malloc failed!");
+                DeleteClientSession(entry);
+                res = CA_MEMORY_ALLOC_FAILED;
+                break;
+            }
+            mbedtls_x509_crt_init(entry->session.peer_cert);
+            valid = (0 == mbedtls_x509_crt_parse_der(entry->session.peer_cert, cert, certLen));
+        }
+        if (valid && 0 < ticketLen)
+        {
+            entry->session.ticket = (unsigned char *) mbedtls_calloc(1, ticketLen);
+            if (NULL == entry->session.ticket)
+            {
+                OIC_LOG(ERROR, NET_SSL_TAG, "Malloc failed!");
+                DeleteClientSession(entry);
+                res = CA_MEMORY_ALLOC_FAILED;
+                break;
+            }
+            memcpy(entry->session.ticket, ticket, ticketLen);
+            entry->session.ticket_len = ticketLen;
+        }
+        if (!valid)
+        {
+            OIC_LOG(ERROR, NET_SSL_TAG, "Invalid client session");
+            DeleteClientSession(entry);
+            res = CA_STATUS_INVALID_PARAM;
+            break;
+        }
+
+        if (IsExpiredClientSession(entry) || !AddClientSession(entry))
+        {
+            DeleteClientSession(entry);
+        }
+    }
+    oc_mutex_unlock(g_sslContextMutex);
+
+    OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+    return res;
+}
+
+CAResult_t CAsslFlushSessions(void)
+{
+    OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
+    VERIFY_NON_NULL_RET(g_sslContextMutex, NET_SSL_TAG, "context mutex is NULL",
+                        CA_STATUS_NOT_INITIALIZED);
+
+    oc_mutex_lock(g_sslContextMutex);
+    if (NULL == g_caSslContext)
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "SSL Context is NULL");
+        oc_mutex_unlock(g_sslContextMutex);
+        return CA_STATUS_NOT_INITIALIZED;
+    }
+
+    DeleteClientSessions();
+
+    // mbedTLS cannot empty the session cache or renew the ticket keys in place. The
+    // tickets issued before are rejected once the keys are replaced.
+    mbedtls_ssl_cache_free(&g_caSslContext->sessionCache);
+    mbedtls_ssl_cache_init(&g_caSslContext->sessionCache);
+    mbedtls_ssl_ticket_free(&g_caSslContext->ticketCtx);
+    mbedtls_ssl_ticket_init(&g_caSslContext->ticketCtx);
+    CAResult_t res = CA_STATUS_OK;
+    if (0 != SetupServerSessions())
+    {
+        // Without keys, no ticket is issued or accepted.
+        OIC_LOG(ERROR, NET_SSL_TAG, "Session ticket setup failed!");
+        res = CA_STATUS_FAILED;
+    }
+    oc_mutex_unlock(g_sslContextMutex);
+
+    OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+    return res;
+}
@@ -499,6 +499,17 @@ static void CALERemoveSendQueueData(CAQueueingThread_t *queueHandle,
                                     oc_mutex mutex,
                                     const char* address);
 
+/**
+ * Check whether queued data is sent to an address.
+ *
+ * @param[in] data           queued ::CALEData_t.
+ * @param[in] size           size of the data.
+ * @param[in] ctx            address of the disconnected device.
+ *
+ * @return true if the data is sent to the address.
+ */
+static bool CALEIsDataOfAddress(void *data, uint32_t size, void *ctx);
+
 /**
  * remove all received data of data list from receive queue.
  *
@@ -3450,33 +3461,21 @@ static void CALERemoveSendQueueData(CAQueueingThread_t *queueHandle, oc_mutex mu
     VERIFY_NON_NULL_VOID(address, CALEADAPTER_TAG, "address");
 
     oc_mutex_lock(mutex);
-    while (u_queue_get_size(queueHandle->dataQueue) > 0)
+    CAQueueingThreadClearContextData(queueHandle, CALEIsDataOfAddress, (void *)address);
+    oc_mutex_unlock(mutex);
+}
+
+static bool CALEIsDataOfAddress(void *data, uint32_t size, void *ctx)
+{
+    (void)size;
+    CALEData_t *bleData = (CALEData_t *) data;
+    if (bleData && bleData->remoteEndpoint &&
+        !strcasecmp(bleData->remoteEndpoint->addr, (const char *) ctx))
     {
-        OIC_LOG(DEBUG, CALEADAPTER_TAG, "get data from queue");
-        u_queue_message_t *message = u_queue_get_element(queueHandle->dataQueue);
-        if (NULL != message)
-        {
-            CALEData_t *bleData = (CALEData_t *) message->msg;
-            if (bleData && bleData->remoteEndpoint)
-            {
-                if (!strcasecmp(bleData->remoteEndpoint->addr, address))
-                {
-                    OIC_LOG(DEBUG, CALEADAPTER_TAG, "found the message of disconnected device");
-                    if (NULL != queueHandle->destroy)
-                    {
-                        queueHandle->destroy(message->msg, message->size);
-                    }
-                    else
-                    {
-                        OICFree(message->msg);
-                    }
-
-                    OICFree(message);
-                }
-            }
-        }
+        OIC_LOG(DEBUG, CALEADAPTER_TAG, "found the message of disconnected device");
+        return true;
     }
-    oc_mutex_unlock(mutex);
+    return false;
 }
 
 static void CALERemoveReceiveQueueData(u_arraylist_t *dataInfoList, const char* address)
@@ -43,6 +43,7 @@
 #include "oic_malloc.h"
 #include "oic_string.h"
 #include "octhread.h"
+#include "oc_refcounter.h"
 #include "experimental/logger.h"
 
 #define TAG "OIC_CA_BWT"
@@ -843,12 +844,31 @@ CAResult_t CAReceiveLastBlock(const CABlockDataID_t *blockID, const CAData_t *re
         return CA_MEMORY_ALLOC_FAILED;
     }
 
-    // update payload
+    // update payload, the reassembled payload is handed over instead of copied
     size_t fullPayloadLen = 0;
-    CAPayload_t fullPayload = CAGetPayloadFromBlockDataList(blockID, &fullPayloadLen);
+    CAPayload_t fullPayload = CATakePayloadFromBlockDataList(blockID, &fullPayloadLen);
     if (fullPayload)
     {
-        CAResult_t res = CAUpdatePayloadToCAData(cloneData, fullPayload, fullPayloadLen);
+        CAInfo_t *info = NULL;
+        if (CA_REQUEST_DATA == cloneData->dataType && cloneData->requestInfo)
+        {
+            info = &cloneData->requestInfo->info;
+        }
+        else if (CA_RESPONSE_DATA == cloneData->dataType && cloneData->responseInfo)
+        {
+            info = &cloneData->responseInfo->info;
+        }
+
+        CAResult_t res = CA_NOT_SUPPORTED;
+        if (info)
+        {
+            res = CASetSharedPayload(info, fullPayload, fullPayloadLen);
+        }
+        else
+        {
+            OICFree(fullPayload);
+        }
+
         if (CA_STATUS_OK != res)
         {
             OIC_LOG(ERROR, TAG, "update has failed");
@@ -2238,6 +2258,18 @@ CAData_t *CACloneCAData(const CAData_t *data)
     return clone;
 }
 
+static void CAUnshareInfoPayload(CAInfo_t *info)
+{
+    // a shared payload is not resized in place, the info gets a buffer of its own
+    if (info->payloadRef)
+    {
+        oc_refcounter_dec(info->payloadRef);
+        info->payloadRef = NULL;
+        info->payload = NULL;
+        info->payloadSize = 0;
+    }
+}
+
 CAResult_t CAUpdatePayloadToCAData(CAData_t *data, const CAPayload_t payload,
                                    size_t payloadLen)
 {
@@ -2256,6 +2288,7 @@ CAResult_t CAUpdatePayloadToCAData(CAData_t *data, const CAPayload_t payload,
                 return CA_STATUS_FAILED;
             }
             // allocate payload field
+            CAUnshareInfoPayload(&data->requestInfo->info);
             newPayload = OICRealloc(data->requestInfo->info.payload, payloadLen);
             if (!newPayload)
             {
@@ -2274,6 +2307,7 @@ CAResult_t CAUpdatePayloadToCAData(CAData_t *data, const CAPayload_t payload,
                 return CA_STATUS_FAILED;
             }
             // allocate payload field
+            CAUnshareInfoPayload(&data->responseInfo->info);
             newPayload = OICRealloc(data->responseInfo->info.payload, payloadLen);
             if (!newPayload)
             {
@@ -2607,6 +2641,39 @@ CAPayload_t CAGetPayloadFromBlockDataList(const CABlockDataID_t *blockID,
     return NULL;
 }
 
+CAPayload_t CATakePayloadFromBlockDataList(const CABlockDataID_t *blockID,
+                                           size_t *fullPayloadLen)
+{
+    OIC_LOG(DEBUG, TAG, "IN-TakeFullPayload");
+    VERIFY_NON_NULL_RET(blockID, TAG, "blockID", NULL);
+    VERIFY_NON_NULL_RET(fullPayloadLen, TAG, "fullPayloadLen", NULL);
+
+    CAPayload_t payload = NULL;
+    *fullPayloadLen = 0;
+
+    oc_mutex_lock(g_context.blockDataListMutex);
+
+    size_t len = u_arraylist_length(g_context.dataList);
+    for (size_t i = 0; i < len; i++)
+    {
+        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
+        if (CABlockidMatches(currData, blockID))
+        {
+            payload = currData->payload;
+            *fullPayloadLen = currData->receivedPayloadLen;
+
+            currData->payload = NULL;
+            currData->payloadLength = 0;
+            currData->receivedPayloadLen = 0;
+            break;
+        }
+    }
+    oc_mutex_unlock(g_context.blockDataListMutex);
+
+    OIC_LOG(DEBUG, TAG, "OUT-TakeFullPayload");
+    return payload;
+}
+
 CABlockData_t *CACreateNewBlockData(const CAData_t *sendData)
 {
     OIC_LOG(DEBUG, TAG, "IN-CACreateNewBlockData");
@@ -529,6 +529,11 @@ CAResult_t CAHandleRequestResponse(void)
     return CA_STATUS_OK;
 }
 
+void CARegisterProcessEvent(oc_event event)
+{
+    CARegisterMessageHandlerEvent(event);
+}
+
 CAResult_t CASelectCipherSuite(const uint16_t cipher, CATransportAdapter_t adapter)
 {
     (void)(adapter); // prevent unused-parameter warning when building release variant
@@ -669,6 +674,23 @@ CAResult_t CAcloseSslSession(const CAEndpoint_t *endpoint)
     return res;
 }
 
+CAResult_t CAflushSslSessions(void)
+{
+    OIC_LOG(DEBUG, TAG, "IN : CAflushSslSessions");
+    CAResult_t res = CA_STATUS_FAILED;
+#if defined (__WITH_DTLS__) || defined(__WITH_TLS__)
+    res = CAsslFlushSessions();
+    if (CA_STATUS_OK != res)
+    {
+        OIC_LOG_V(ERROR, TAG, "Failed to CAsslFlushSessions : %d", res);
+    }
+#else
+    OIC_LOG(ERROR, TAG, "Method not supported");
+#endif
+    OIC_LOG(DEBUG, TAG, "OUT : CAflushSslSessions");
+    return res;
+}
+
 #ifdef TCP_ADAPTER
 void CARegisterKeepAliveHandler(CAKeepAliveConnectionCallback ConnHandler)
 {
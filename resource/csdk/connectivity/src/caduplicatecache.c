@@ -0,0 +1,324 @@
+/* *****************************************************************
+ *
+ * Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <string.h>
+
+#include "caduplicatecache.h"
+#include "oic_malloc.h"
+#include "oic_time.h"
+#include "experimental/logger.h"
+
+#define TAG "OIC_CA_DUPLICATE"
+
+typedef struct CADuplicateEntry
+{
+    uint64_t timeStamp;                 /**< received time. milliseconds */
+    struct CADuplicateEntry *next;      /**< next record in the same hash bucket */
+    struct CADuplicateEntry *newer;     /**< next record added */
+    uint16_t messageId;                 /**< coap PDU message id */
+    uint8_t tokenLength;                /**< token length */
+    char token[CA_MAX_TOKEN_LEN];       /**< token */
+    bool confirmable;                   /**< the request is confirmable */
+    CAEndpoint_t endpoint;              /**< endpoint the request was received from */
+    void *response;                     /**< response pdu sent to a confirmable request */
+    uint32_t responseSize;              /**< response pdu size */
+} CADuplicateEntry_t;
+
+static size_t CAGetBucket(const CADuplicateCache_t *cache, uint16_t messageId,
+                          const char *token, uint8_t tokenLength, uint32_t ifindex)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    hash = (hash ^ (messageId & 0xFF)) * 16777619u;
+    hash = (hash ^ (messageId >> 8)) * 16777619u;
+    for (uint8_t i = 0; i < tokenLength; i++)
+    {
+        hash = (hash ^ (uint8_t)token[i]) * 16777619u;
+    }
+    hash = (hash ^ ifindex) * 16777619u;
+    return hash & (cache->tableSize - 1);
+}
+
+static bool CAIsSameSender(const CAEndpoint_t *ep1, const CAEndpoint_t *ep2)
+{
+    return ep1->adapter == ep2->adapter && ep1->port == ep2->port
+           && 0 == strncmp(ep1->addr, ep2->addr, MAX_ADDR_STR_SIZE_CA);
+}
+
+static bool CAIsMulticast(const CAEndpoint_t *endpoint)
+{
+    return 0 != (endpoint->flags & CA_MULTICAST);
+}
+
+static CADuplicateEntry_t *CAFindEntry(const CADuplicateCache_t *cache, size_t bucket,
+                                       const CAEndpoint_t *endpoint, bool confirmable,
+                                       uint16_t messageId, const char *token,
+                                       uint8_t tokenLength, uint64_t currentTime)
+{
+    for (CADuplicateEntry_t *entry = cache->table[bucket]; NULL != entry; entry = entry->next)
+    {
+        if (entry->messageId != messageId || entry->tokenLength != tokenLength
+            || entry->endpoint.ifindex != endpoint->ifindex
+            || 0 != memcmp(entry->token, token, tokenLength))
+        {
+            continue;
+        }
+        if (CAIsSameSender(&entry->endpoint, endpoint))
+        {
+            return entry;
+        }
+        // the same multicast request received over the other address family.
+        if (!confirmable && !entry->confirmable
+            && CAIsMulticast(endpoint) && CAIsMulticast(&entry->endpoint)
+            && currentTime - entry->timeStamp < cache->multicastWindow)
+        {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief   unlink the oldest record. caller must hold the mutex.
+ * @return  the record, to be reused or released by the caller.
+ */
+static CADuplicateEntry_t *CARemoveOldestEntry(CADuplicateCache_t *cache)
+{
+    CADuplicateEntry_t *entry = cache->oldest;
+
+    CADuplicateEntry_t **link = &cache->table[CAGetBucket(cache, entry->messageId,
+                                                          entry->token, entry->tokenLength,
+                                                          entry->endpoint.ifindex)];
+    while (*link != entry)
+    {
+        link = &(*link)->next;
+    }
+    *link = entry->next;
+
+    cache->oldest = entry->newer;
+    if (NULL == cache->oldest)
+    {
+        cache->newest = NULL;
+    }
+    cache->count--;
+
+    OICFree(entry->response);
+    entry->response = NULL;
+    entry->responseSize = 0;
+    return entry;
+}
+
+CAResult_t CADuplicateCacheInitialize(CADuplicateCache_t *cache, size_t maxCount,
+                                      uint32_t lifetimeMs)
+{
+    if (NULL == cache)
+    {
+        OIC_LOG(ERROR, TAG, "cache is NULL");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    memset(cache, 0, sizeof(CADuplicateCache_t));
+    cache->maxCount = maxCount ? maxCount : CA_DUPLICATE_CACHE_SIZE;
+    cache->lifetime = lifetimeMs ? lifetimeMs : CA_DUPLICATE_CACHE_LIFETIME_MS;
+    cache->multicastWindow = CA_DUPLICATE_CACHE_MULTICAST_WINDOW_MS;
+
+    // one bucket per record at most, the table is never resized.
+    cache->tableSize = 1;
+    while (cache->tableSize < cache->maxCount)
+    {
+        cache->tableSize <<= 1;
+    }
+
+    cache->table = (CADuplicateEntry_t **) OICCalloc(cache->tableSize,
+                                                     sizeof(CADuplicateEntry_t *));
+    if (NULL == cache->table)
+    {
+        OIC_LOG(ERROR, TAG, "memory error");
+        return CA_MEMORY_ALLOC_FAILED;
+    }
+
+    cache->mutex = oc_mutex_new();
+    if (NULL == cache->mutex)
+    {
+        OIC_LOG(ERROR, TAG, "oc_mutex_new failed");
+        OICFree(cache->table);
+        cache->table = NULL;
+        return CA_STATUS_FAILED;
+    }
+
+    return CA_STATUS_OK;
+}
+
+void CADuplicateCacheTerminate(CADuplicateCache_t *cache)
+{
+    if (NULL == cache || NULL == cache->table)
+    {
+        return;
+    }
+
+    while (NULL != cache->oldest)
+    {
+        OICFree(CARemoveOldestEntry(cache));
+    }
+    OICFree(cache->table);
+    cache->table = NULL;
+
+    oc_mutex_free(cache->mutex);
+    cache->mutex = NULL;
+}
+
+bool CADuplicateCacheCheck(CADuplicateCache_t *cache, const CAEndpoint_t *endpoint,
+                           CAMessageType_t type, uint16_t messageId,
+                           const CAToken_t token, uint8_t tokenLength,
+                           void **response, uint32_t *responseSize)
+{
+    if (response)
+    {
+        *response = NULL;
+    }
+    if (responseSize)
+    {
+        *responseSize = 0;
+    }
+    if (NULL == cache || NULL == cache->table || NULL == endpoint)
+    {
+        return false;
+    }
+
+    if (NULL == token || tokenLength > CA_MAX_TOKEN_LEN)
+    {
+        /*
+         * If token length is more than CA_MAX_TOKEN_LEN,
+         * we compare the first CA_MAX_TOKEN_LEN bytes only.
+         */
+        tokenLength = token ? CA_MAX_TOKEN_LEN : 0;
+    }
+
+    bool confirmable = (CA_MSG_CONFIRM == type);
+    uint64_t currentTime = OICGetCurrentTime(TIME_IN_MS);
+    size_t bucket = CAGetBucket(cache, messageId, token, tokenLength, endpoint->ifindex);
+
+    oc_mutex_lock(cache->mutex);
+
+    // records are added in time order, the expired ones are the oldest.
+    while (NULL != cache->oldest && currentTime - cache->oldest->timeStamp >= cache->lifetime)
+    {
+        OICFree(CARemoveOldestEntry(cache));
+    }
+
+    CADuplicateEntry_t *entry = CAFindEntry(cache, bucket, endpoint, confirmable,
+                                            messageId, token, tokenLength, currentTime);
+    if (NULL != entry)
+    {
+        if (response && entry->response)
+        {
+            *response = OICMalloc(entry->responseSize);
+            if (*response)
+            {
+                memcpy(*response, entry->response, entry->responseSize);
+                if (responseSize)
+                {
+                    *responseSize = entry->responseSize;
+                }
+            }
+        }
+        oc_mutex_unlock(cache->mutex);
+        return true;
+    }
+
+    if (cache->count >= cache->maxCount)
+    {
+        entry = CARemoveOldestEntry(cache);
+    }
+    else
+    {
+        entry = (CADuplicateEntry_t *) OICCalloc(1, sizeof(CADuplicateEntry_t));
+        if (NULL == entry)
+        {
+            OIC_LOG(ERROR, TAG, "memory error");
+            oc_mutex_unlock(cache->mutex);
+            return false;
+        }
+    }
+
+    entry->timeStamp = currentTime;
+    entry->messageId = messageId;
+    entry->tokenLength = tokenLength;
+    if (tokenLength)
+    {
+        memcpy(entry->token, token, tokenLength);
+    }
+    entry->confirmable = confirmable;
+    entry->endpoint = *endpoint;
+
+    entry->next = cache->table[bucket];
+    cache->table[bucket] = entry;
+
+    entry->newer = NULL;
+    if (NULL != cache->newest)
+    {
+        cache->newest->newer = entry;
+    }
+    else
+    {
+        cache->oldest = entry;
+    }
+    cache->newest = entry;
+    cache->count++;
+
+    oc_mutex_unlock(cache->mutex);
+    return false;
+}
+
+void CADuplicateCacheSetResponse(CADuplicateCache_t *cache, const CAEndpoint_t *endpoint,
+                                 uint16_t messageId, const CAToken_t token,
+                                 uint8_t tokenLength, const void *pdu, uint32_t size)
+{
+    if (NULL == cache || NULL == cache->table || NULL == endpoint || NULL == pdu || 0 == size)
+    {
+        return;
+    }
+
+    if (NULL == token || tokenLength > CA_MAX_TOKEN_LEN)
+    {
+        tokenLength = token ? CA_MAX_TOKEN_LEN : 0;
+    }
+
+    size_t bucket = CAGetBucket(cache, messageId, token, tokenLength, endpoint->ifindex);
+
+    oc_mutex_lock(cache->mutex);
+
+    CADuplicateEntry_t *entry = CAFindEntry(cache, bucket, endpoint, true,
+                                            messageId, token, tokenLength,
+                                            OICGetCurrentTime(TIME_IN_MS));
+    if (NULL != entry && entry->confirmable)
+    {
+        void *response = OICMalloc(size);
+        if (response)
+        {
+            memcpy(response, pdu, size);
+            OICFree(entry->response);
+            entry->response = response;
+            entry->responseSize = size;
+        }
+    }
+
+    oc_mutex_unlock(cache->mutex);
+}
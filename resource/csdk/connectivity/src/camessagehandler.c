@@ -38,6 +38,7 @@
 #include "caadapterutils.h"
 #include "cainterfacecontroller.h"
 #include "caretransmission.h"
+#include "caduplicatecache.h"
 #include "oic_string.h"
 #include "caping.h"
 
@@ -66,11 +67,19 @@ static ca_thread_pool_t g_threadPoolHandle = NULL;
 static CAQueueingThread_t g_sendThread;
 static CAQueueingThread_t g_receiveThread;
 
+// event signaled when data is queued for the receive handler
+static oc_event g_processEvent = NULL;
+
+// guards g_processEvent, so that an unregistered event is no longer signaled
+static oc_mutex g_processEventMutex = NULL;
 
 #define TAG "OIC_CA_MSG_HANDLE"
 
 static CARetransmission_t g_retransmissionContext;
 
+// recently received requests
+static CADuplicateCache_t g_duplicateCache;
+
 // handler field
 static CARequestCallback g_requestHandler = NULL;
 static CAResponseCallback g_responseHandler = NULL;
@@ -90,8 +99,7 @@ static void CASendErrorInfo(const CAEndpoint_t *endpoint, const CAInfo_t *info,
 
 static void CADestroyData(void *data, uint32_t size);
 static void CALogPayloadInfo(CAInfo_t *info);
-static bool CADropSecondMessage(CAHistory_t *history, const CAEndpoint_t *endpoint, uint16_t id,
-                                CAToken_t token, uint8_t tokenLength);
+static bool CADropSecondMessage(const CAEndpoint_t *endpoint, const CAInfo_t *info);
 
 /**
  * print send / receive message of CoAP.
@@ -100,6 +108,29 @@ static bool CADropSecondMessage(CAHistory_t *history, const CAEndpoint_t *endpoi
  */
 static void CALogPDUInfo(const CAData_t *data, const coap_pdu_t *pdu);
 
+/**
+ * Signal the registered process event, if any.
+ */
+static void CASignalProcessEvent(void)
+{
+    oc_mutex_lock(g_processEventMutex);
+    if (g_processEvent)
+    {
+        oc_event_signal(g_processEvent);
+    }
+    oc_mutex_unlock(g_processEventMutex);
+}
+
+/**
+ * Add data to the receive queue and wake up the thread processing it.
+ * @param[in] data      data to be handed over to the request/response handlers.
+ */
+static void CAQueueReceiveData(CAData_t *data)
+{
+    CAQueueingThreadAddData(&g_receiveThread, data, sizeof(CAData_t));
+    CASignalProcessEvent();
+}
+
 #if defined(WITH_BWT) || defined(TCP_ADAPTER)
 void CAAddDataToSendThread(CAData_t *data)
 {
@@ -114,7 +145,7 @@ void CAAddDataToReceiveThread(CAData_t *data)
     VERIFY_NON_NULL_VOID(data, TAG, "data");
 
     // add thread
-    CAQueueingThreadAddData(&g_receiveThread, data, sizeof(CAData_t));
+    CAQueueReceiveData(data);
 }
 #endif
 
@@ -197,9 +228,7 @@ static CAData_t* CAGenerateHandlerData(const CAEndpoint_t *endpoint,
             goto exit;
         }
 
-        if ((reqInfo->info.type != CA_MSG_CONFIRM) &&
-            CADropSecondMessage(&caglobals.ca.requestHistory, endpoint, reqInfo->info.messageId,
-                                reqInfo->info.token, reqInfo->info.tokenLength))
+        if (CADropSecondMessage(endpoint, &reqInfo->info))
         {
             OIC_LOG(INFO, TAG, "Second Request with same Token, Drop it");
             CADestroyRequestInfoInternal(reqInfo);
@@ -358,7 +387,7 @@ static void CATimeoutCallback(const CAEndpoint_t *endpoint, const void *pdu, uin
     }
 #endif // WITH_BWT
 
-    CAQueueingThreadAddData(&g_receiveThread, cadata, sizeof(CAData_t));
+    CAQueueReceiveData(cadata);
 }
 
 static void CADestroyData(void *data, uint32_t size)
@@ -593,6 +622,14 @@ static CAResult_t CAProcessSendData(const CAData_t *data)
                 return res;
             }
 
+            if (NULL != data->responseInfo && CA_MSG_ACKNOWLEDGE == info->type)
+            {
+                // piggybacked response, sent again if the request is retransmitted.
+                CADuplicateCacheSetResponse(&g_duplicateCache, data->remoteEndpoint,
+                                            info->messageId, info->token, info->tokenLength,
+                                            pdu->transport_hdr, pdu->length);
+            }
+
 #ifdef WITH_TCP
             if (CAIsSupportedCoAPOverTCP(data->remoteEndpoint->adapter))
             {
@@ -676,61 +713,54 @@ static void CASendThreadProcess(void *threadData)
 }
 
 /*
- * If a second message arrives with the same message ID, token and the other address
- * family, drop it.  Typically, IPv6 beats IPv4, so the IPv4 message is dropped.
+ * If a second request arrives from the same sender with the same message ID, token and
+ * interface, drop it. A multicast request is also dropped when it arrives shortly after
+ * over the other address family; typically, IPv6 beats IPv4, so the IPv4 request is dropped.  A retransmitted
+ * confirmable request is answered with the response sent to the first one, if any.
  */
-static bool CADropSecondMessage(CAHistory_t *history, const CAEndpoint_t *ep, uint16_t id,
-                                CAToken_t token, uint8_t tokenLength)
+static bool CADropSecondMessage(const CAEndpoint_t *ep, const CAInfo_t *info)
 {
     if (!ep)
     {
         return true;
     }
-    if (ep->adapter != CA_ADAPTER_IP)
+    if (CA_MSG_CONFIRM == info->type)
+    {
+        // only confirmable messages sent over these adapters are retransmitted.
+        if (!(ep->adapter & DEFAULT_RETRANSMISSION_TYPE))
+        {
+            return false;
+        }
+    }
+    else if (ep->adapter != CA_ADAPTER_IP)
     {
         return false;
     }
 
-    if (tokenLength > CA_MAX_TOKEN_LEN)
+    void *response = NULL;
+    uint32_t responseSize = 0;
+    if (!CADuplicateCacheCheck(&g_duplicateCache, ep, info->type, info->messageId,
+                               info->token, info->tokenLength, &response, &responseSize))
     {
-        /*
-         * If token length is more than CA_MAX_TOKEN_LEN,
-         * we compare the first CA_MAX_TOKEN_LEN bytes only.
-         */
-        tokenLength = CA_MAX_TOKEN_LEN;
+        return false;
     }
 
-    bool ret = false;
-    CATransportFlags_t familyFlags = ep->flags & CA_IPFAMILY_MASK;
-
-    for (size_t i = 0; i < sizeof(history->items) / sizeof(history->items[0]); i++)
+    if (CA_MSG_CONFIRM == info->type)
     {
-        CAHistoryItem_t *item = &(history->items[i]);
-        if (id == item->messageId && tokenLength == item->tokenLength
-            && ep->ifindex == item->ifindex && memcmp(item->token, token, tokenLength) == 0)
+        OIC_LOG_V(INFO, TAG, "duplicate confirmable message %u ignored", info->messageId);
+        if (response)
         {
-            OIC_LOG_V(INFO, TAG, "IPv%c duplicate message ignored",
-                      familyFlags & CA_IPV6 ? '6' : '4');
-            ret = true;
-            break;
+            OIC_LOG(DEBUG, TAG, "resend response of the first message");
+            CASendUnicastData(ep, response, responseSize, CA_RESPONSE_DATA);
+            OICFree(response);
         }
     }
-
-    history->items[history->nextIndex].flags = familyFlags;
-    history->items[history->nextIndex].messageId = id;
-    history->items[history->nextIndex].ifindex = ep->ifindex;
-    if (token && tokenLength)
-    {
-        memcpy(history->items[history->nextIndex].token, token, tokenLength);
-        history->items[history->nextIndex].tokenLength = tokenLength;
-    }
-
-    if (++history->nextIndex >= HISTORYSIZE)
+    else
     {
-        history->nextIndex = 0;
+        OIC_LOG_V(INFO, TAG, "IPv%c duplicate message ignored",
+                  ep->flags & CA_IPV6 ? '6' : '4');
     }
-
-    return ret;
+    return true;
 }
 
 static void CAReceivedPacketCallback(const CASecureEndpoint_t *sep,
@@ -881,7 +911,7 @@ static void CAReceivedPacketCallback(const CASecureEndpoint_t *sep,
         if (CA_NOT_SUPPORTED == res || CA_REQUEST_TIMEOUT == res)
         {
             OIC_LOG(DEBUG, TAG, "this message does not have block option");
-            CAQueueingThreadAddData(&g_receiveThread, cadata, sizeof(CAData_t));
+            CAQueueReceiveData(cadata);
         }
         else
         {
@@ -891,7 +921,7 @@ static void CAReceivedPacketCallback(const CASecureEndpoint_t *sep,
     else
 #endif
     {
-        CAQueueingThreadAddData(&g_receiveThread, cadata, sizeof(CAData_t));
+        CAQueueReceiveData(cadata);
     }
 
     coap_delete_pdu(pdu);
@@ -910,20 +940,21 @@ void CAHandleRequestResponseCallbacks(void)
     // #1 parse the data
     // #2 get endpoint
 
-    oc_mutex_lock(g_receiveThread.threadMutex);
+    uint32_t size = 0;
+    CAData_t *td = (CAData_t *) CAQueueingThreadTakeData(&g_receiveThread, &size);
+    bool hasPendingData = CAQueueingThreadHasData(&g_receiveThread);
 
-    u_queue_message_t *item = u_queue_get_element(g_receiveThread.dataQueue);
-
-    oc_mutex_unlock(g_receiveThread.threadMutex);
+    // only one message is handled per call, keep the event signaled until the queue is drained.
+    if (hasPendingData)
+    {
+        CASignalProcessEvent();
+    }
 
-    if (NULL == item || NULL == item->msg)
+    if (NULL == td)
     {
         return;
     }
 
-    // get endpoint
-    CAData_t *td = (CAData_t *) item->msg;
-
     if (td->requestInfo && g_requestHandler)
     {
         OIC_LOG_V(DEBUG, TAG, "request callback : %d", td->requestInfo->info.numOptions);
@@ -940,8 +971,7 @@ void CAHandleRequestResponseCallbacks(void)
         g_errorHandler(td->remoteEndpoint, td->errorInfo);
     }
 
-    CADestroyData(item->msg, sizeof(CAData_t));
-    OICFree(item);
+    CADestroyData(td, size);
 
 #endif // SINGLE_HANDLE
 }
@@ -1086,7 +1116,7 @@ CAResult_t CADetachSendMessage(const CAEndpoint_t *endpoint, const void *sendMsg
     {
         OIC_LOG(DEBUG, TAG,
                 "This is a loopback message. Transfer it to the receive queue directly");
-        CAQueueingThreadAddData(&g_receiveThread, data, sizeof(CAData_t));
+        CAQueueReceiveData(data);
         return CA_STATUS_OK;
     }
 #ifdef WITH_BWT
@@ -1130,11 +1160,30 @@ void CASetNetworkMonitorCallback(CANetworkMonitorCallback nwMonitorHandler)
 
 CAResult_t CAInitializeMessageHandler(CATransportAdapter_t transportType)
 {
+    if (!g_processEventMutex)
+    {
+        g_processEventMutex = oc_mutex_new();
+        if (!g_processEventMutex)
+        {
+            OIC_LOG(ERROR, TAG, "Failed to create process event mutex.");
+            return CA_MEMORY_ALLOC_FAILED;
+        }
+    }
+
     CASetPacketReceivedCallback(CAReceivedPacketCallback);
     CASetErrorHandleCallback(CAErrorHandler);
 
+    // duplicate detection of received requests
+    CAResult_t res = CADuplicateCacheInitialize(&g_duplicateCache, CA_DUPLICATE_CACHE_SIZE,
+                                                CA_DUPLICATE_CACHE_LIFETIME_MS);
+    if (CA_STATUS_OK != res)
+    {
+        OIC_LOG(ERROR, TAG, "Failed to Initialize duplicate cache.");
+        return res;
+    }
+
     // create thread pool
-    CAResult_t res = ca_thread_pool_init(MAX_THREAD_POOL_SIZE, &g_threadPoolHandle);
+    res = ca_thread_pool_init(MAX_THREAD_POOL_SIZE, &g_threadPoolHandle);
     if (CA_STATUS_OK != res)
     {
         OIC_LOG(ERROR, TAG, "thread pool initialize error.");
@@ -1215,6 +1264,20 @@ CAResult_t CAInitializeMessageHandler(CATransportAdapter_t transportType)
     return CA_STATUS_OK;
 }
 
+void CARegisterMessageHandlerEvent(oc_event event)
+{
+    // Without the mutex the message handler is not running, and nothing signals the event.
+    if (!g_processEventMutex)
+    {
+        g_processEvent = event;
+        return;
+    }
+
+    oc_mutex_lock(g_processEventMutex);
+    g_processEvent = event;
+    oc_mutex_unlock(g_processEventMutex);
+}
+
 void CATerminateMessageHandler(void)
 {
     // stop adapters
@@ -1258,6 +1321,12 @@ void CATerminateMessageHandler(void)
 
     // terminate interface adapters by controller
     CATerminateAdapters();
+
+    CADuplicateCacheTerminate(&g_duplicateCache);
+
+    // the adapter and queueing threads are stopped, none of them signals the event anymore
+    oc_mutex_free(g_processEventMutex);
+    g_processEventMutex = NULL;
 }
 
 static void CALogPayloadInfo(CAInfo_t *info)
@@ -1362,7 +1431,7 @@ void CAErrorHandler(const CAEndpoint_t *endpoint,
 
     cadata->errorInfo->result = result;
 
-    CAQueueingThreadAddData(&g_receiveThread, cadata, sizeof(CAData_t));
+    CAQueueReceiveData(cadata);
     coap_delete_pdu(pdu);
 
     OIC_LOG(DEBUG, TAG, "CAErrorHandler OUT");
@@ -1411,7 +1480,7 @@ static void CASendErrorInfo(const CAEndpoint_t *endpoint, const CAInfo_t *info,
     cadata->errorInfo = errorInfo;
     cadata->dataType = CA_ERROR_DATA;
 
-    CAQueueingThreadAddData(&g_receiveThread, cadata, sizeof(CAData_t));
+    CAQueueReceiveData(cadata);
     OIC_LOG(DEBUG, TAG, "CASendErrorInfo OUT");
 }
 
@@ -229,6 +229,35 @@ void CAProcessPing()
     oc_mutex_unlock(g_pingInfoListMutex);
 }
 
+uint32_t CAGetNextPingTimeout(void)
+{
+    uint32_t nextTimeout = UINT32_MAX;
+
+    oc_mutex_lock(g_pingInfoListMutex);
+    // The list is reverse sorted, so the last entry is the first one to expire.
+    PingInfo *oldest = g_pingInfoList;
+    while (oldest && oldest->next)
+    {
+        oldest = oldest->next;
+    }
+    if (oldest)
+    {
+        uint64_t curTime = OICGetCurrentTime(TIME_IN_MS);
+        uint64_t expiry = oldest->timeStamp + g_timeout;
+        if (expiry <= curTime)
+        {
+            nextTimeout = 0;
+        }
+        else if (expiry - curTime < UINT32_MAX)
+        {
+            nextTimeout = (uint32_t)(expiry - curTime);
+        }
+    }
+    oc_mutex_unlock(g_pingInfoListMutex);
+
+    return nextTimeout;
+}
+
 void CAPongReceivedCallback(const CAEndpoint_t *endpoint, const CAToken_t token, uint8_t tokenLength)
 {
     OIC_LOG(DEBUG, TAG, "CAPongReceivedCallback IN");
@@ -42,6 +42,7 @@
 #include "oic_malloc.h"
 #include "oic_string.h"
 #include "experimental/ocrandom.h"
+#include "caremotehandler.h"
 #include "cacommonutil.h"
 #include "cablockwisetransfer.h"
 
@@ -1106,8 +1107,20 @@ CAResult_t CAGetInfoFromPDU(const coap_pdu_t *pdu, const CAEndpoint_t *endpoint,
     if (coap_get_data(pdu, &dataSize, &data))
     {
         OIC_LOG(DEBUG, TAG, "inside pdu->data");
-        outInfo->payload = (uint8_t *) OICMalloc(dataSize);
-        if (NULL == outInfo->payload)
+        uint8_t *payload = (uint8_t *) OICMalloc(dataSize);
+        if (NULL == payload)
+        {
+            OIC_LOG(ERROR, TAG, "Out of memory");
+            OICFree(outInfo->options);
+            OICFree(outInfo->token);
+            OICFree(optionResult);
+            return CA_MEMORY_ALLOC_FAILED;
+        }
+        memcpy(payload, pdu->data, dataSize);
+
+        // this is the only copy of the received payload, the clones of the info and
+        // the stack share it by reference.
+        if (CA_STATUS_OK != CASetSharedPayload(outInfo, payload, dataSize))
         {
             OIC_LOG(ERROR, TAG, "Out of memory");
             OICFree(outInfo->options);
@@ -1115,8 +1128,6 @@ CAResult_t CAGetInfoFromPDU(const coap_pdu_t *pdu, const CAEndpoint_t *endpoint,
             OICFree(optionResult);
             return CA_MEMORY_ALLOC_FAILED;
         }
-        memcpy(outInfo->payload, pdu->data, dataSize);
-        outInfo->payloadSize = dataSize;
     }
 
     if (optionResult[0] != '\0')
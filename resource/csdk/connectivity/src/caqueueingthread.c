@@ -30,11 +30,110 @@
 #endif
 
 #include "caqueueingthread.h"
+#include "ocatomic.h"
 #include "oic_malloc.h"
 #include "experimental/logger.h"
 
 #define TAG PCF("OIC_CA_QING")
 
+/**
+ * Number of data the lock-free queue holds. Data added while it is full goes
+ * to the overflow list.
+ */
+#define CA_QUEUE_CAPACITY 256
+
+/**
+ * Number of data taken from the queue at once.
+ */
+#define CA_QUEUE_BATCH 16
+
+struct CAQueueingItem
+{
+    u_queue_message_t message;
+    CAQueueingItem_t *next;
+};
+
+static void CAQueueingThreadDestroyData(CAQueueingThread_t *thread, void *data, uint32_t size)
+{
+    if (NULL != thread->destroy)
+    {
+        thread->destroy(data, size);
+    }
+    else
+    {
+        OICFree(data);
+    }
+}
+
+static bool CAAppendItem(CAQueueingItem_t **head, CAQueueingItem_t **tail,
+                         void *data, uint32_t size)
+{
+    CAQueueingItem_t *item = (CAQueueingItem_t *) OICMalloc(sizeof(CAQueueingItem_t));
+    if (NULL == item)
+    {
+        return false;
+    }
+    item->message.msg = data;
+    item->message.size = size;
+    item->next = NULL;
+
+    if (*tail)
+    {
+        (*tail)->next = item;
+    }
+    else
+    {
+        *head = item;
+    }
+    *tail = item;
+    return true;
+}
+
+static uint32_t CATakePendingData(CAQueueingThread_t *thread, u_queue_message_t *messages,
+                                  uint32_t count)
+{
+    uint32_t taken = 0;
+    while (taken < count && thread->pendingHead)
+    {
+        CAQueueingItem_t *item = thread->pendingHead;
+        thread->pendingHead = item->next;
+        messages[taken++] = item->message;
+        OICFree(item);
+    }
+    if (!thread->pendingHead)
+    {
+        thread->pendingTail = NULL;
+    }
+    return taken;
+}
+
+/**
+ * Take up to count data in the order it was added. Called with threadMutex held.
+ */
+static uint32_t CAQueueingThreadTake(CAQueueingThread_t *thread, u_queue_message_t *messages,
+                                     uint32_t count)
+{
+    // Pending data was added before anything still in the lock-free queue.
+    uint32_t taken = CATakePendingData(thread, messages, count);
+    if (taken < count)
+    {
+        taken += u_mpsc_queue_pop(thread->dataQueue, messages + taken, count - taken);
+    }
+
+    // The overflow list follows once all data added to the lock-free queue before it
+    // has been taken. Producers use the lock-free queue again from then on.
+    if (0 == taken && thread->overflowHead && u_mpsc_queue_is_empty(thread->dataQueue))
+    {
+        thread->pendingHead = thread->overflowHead;
+        thread->pendingTail = thread->overflowTail;
+        thread->overflowHead = NULL;
+        thread->overflowTail = NULL;
+        oc_atomic_cmpxchg(&thread->overflow, 1, 0);
+        taken = CATakePendingData(thread, messages, count);
+    }
+    return taken;
+}
+
 static void CAQueueingThreadBaseRoutine(void *threadValue)
 {
     OIC_LOG(DEBUG, TAG, "message handler main thread start..");
@@ -47,53 +146,60 @@ static void CAQueueingThreadBaseRoutine(void *threadValue)
         return;
     }
 
+    u_queue_message_t messages[CA_QUEUE_BATCH];
     while (!thread->isStop)
     {
         // mutex lock
         oc_mutex_lock(thread->threadMutex);
 
-        // if queue is empty, thread will wait
-        if (!thread->isStop && u_queue_get_size(thread->dataQueue) <= 0)
+        uint32_t count = 0;
+        if (!thread->isStop)
         {
-            OIC_LOG(DEBUG, TAG, "wait..");
-
-            // wait
-            oc_cond_wait(thread->threadCond, thread->threadMutex);
-
-            OIC_LOG(DEBUG, TAG, "wake up..");
+            count = CAQueueingThreadTake(thread, messages, CA_QUEUE_BATCH);
         }
 
-        // check stop flag
-        if (thread->isStop)
+        // complete the work of the tasks before waiting on an empty queue
+        if (0 == count && NULL != thread->flush && !thread->isStop)
         {
-            // mutex unlock
             oc_mutex_unlock(thread->threadMutex);
-            continue;
+            thread->flush();
+            oc_mutex_lock(thread->threadMutex);
+            count = CAQueueingThreadTake(thread, messages, CA_QUEUE_BATCH);
         }
 
-        // get data
-        u_queue_message_t *message = u_queue_get_element(thread->dataQueue);
-        // mutex unlock
-        oc_mutex_unlock(thread->threadMutex);
-        if (NULL == message)
+        // if queue is empty, thread will wait
+        if (0 == count && !thread->isStop)
         {
-            continue;
-        }
+            // Producers check idle after adding data, so either the data is taken
+            // here or the producer signals once the wait has started.
+            oc_atomic_increment(&thread->idle);
+            count = CAQueueingThreadTake(thread, messages, CA_QUEUE_BATCH);
+            if (0 == count && !thread->isStop)
+            {
+                OIC_LOG(DEBUG, TAG, "wait..");
 
-        // process data
-        thread->threadTask(message->msg);
+                // wait
+                oc_cond_wait(thread->threadCond, thread->threadMutex);
 
-        // free
-        if (NULL != thread->destroy)
-        {
-            thread->destroy(message->msg, message->size);
+                OIC_LOG(DEBUG, TAG, "wake up..");
+            }
+            oc_atomic_decrement(&thread->idle);
         }
-        else
+
+        // mutex unlock
+        oc_mutex_unlock(thread->threadMutex);
+
+        // process data
+        for (uint32_t i = 0; i < count; i++)
         {
-            OICFree(message->msg);
+            thread->threadTask(messages[i].msg);
+            CAQueueingThreadDestroyData(thread, messages[i].msg, messages[i].size);
         }
+    }
 
-        OICFree(message);
+    if (NULL != thread->flush)
+    {
+        thread->flush();
     }
 
     oc_mutex_lock(thread->threadMutex);
@@ -122,12 +228,19 @@ CAResult_t CAQueueingThreadInitialize(CAQueueingThread_t *thread, ca_thread_pool
 
     // set send thread data
     thread->threadPool = handle;
-    thread->dataQueue = u_queue_create();
+    thread->dataQueue = u_mpsc_queue_create(CA_QUEUE_CAPACITY);
     thread->threadMutex = oc_mutex_new();
     thread->threadCond = oc_cond_new();
     thread->isStop = true;
     thread->threadTask = task;
     thread->destroy = destroy;
+    thread->flush = NULL;
+    thread->overflowHead = NULL;
+    thread->overflowTail = NULL;
+    thread->overflow = 0;
+    thread->pendingHead = NULL;
+    thread->pendingTail = NULL;
+    thread->idle = 0;
     if (NULL == thread->dataQueue || NULL == thread->threadMutex || NULL == thread->threadCond)
     {
         goto ERROR_MEM_FAILURE;
@@ -138,7 +251,7 @@ CAResult_t CAQueueingThreadInitialize(CAQueueingThread_t *thread, ca_thread_pool
 ERROR_MEM_FAILURE:
     if (thread->dataQueue)
     {
-        u_queue_delete(thread->dataQueue);
+        u_mpsc_queue_delete(thread->dataQueue);
         thread->dataQueue = NULL;
     }
     if (thread->threadMutex)
@@ -154,6 +267,24 @@ ERROR_MEM_FAILURE:
     return CA_MEMORY_ALLOC_FAILED;
 }
 
+CAResult_t CAQueueingThreadSetFlush(CAQueueingThread_t *thread, CAThreadFlush flush)
+{
+    if (NULL == thread)
+    {
+        OIC_LOG(ERROR, TAG, "thread instance is empty..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    if (false == thread->isStop)
+    {
+        OIC_LOG(ERROR, TAG, "queueing thread already running..");
+        return CA_STATUS_FAILED;
+    }
+
+    thread->flush = flush;
+    return CA_STATUS_OK;
+}
+
 CAResult_t CAQueueingThreadStart(CAQueueingThread_t *thread)
 {
     if (NULL == thread)
@@ -209,69 +340,153 @@ CAResult_t CAQueueingThreadAddData(CAQueueingThread_t *thread, void *data, uint3
         return CA_STATUS_INVALID_PARAM;
     }
 
-    // create thread data
-    u_queue_message_t *message = (u_queue_message_t *) OICMalloc(sizeof(u_queue_message_t));
+    if (0 == thread->overflow && u_mpsc_queue_push(thread->dataQueue, data, size))
+    {
+        // notify the thread only if it waits for data
+        if (0 != oc_atomic_add(&thread->idle, 0))
+        {
+            oc_mutex_lock(thread->threadMutex);
+            oc_cond_signal(thread->threadCond);
+            oc_mutex_unlock(thread->threadMutex);
+        }
+        return CA_STATUS_OK;
+    }
 
-    if (NULL == message)
+    // The lock-free queue is full. Keep adding to the overflow list until the thread
+    // has taken it, so that data from one producer stays in order.
+    oc_mutex_lock(thread->threadMutex);
+    if (!CAAppendItem(&thread->overflowHead, &thread->overflowTail, data, size))
     {
+        oc_mutex_unlock(thread->threadMutex);
         OIC_LOG(ERROR, TAG, "memory error!!");
         return CA_MEMORY_ALLOC_FAILED;
     }
+    oc_atomic_or(&thread->overflow, 1);
+    oc_cond_signal(thread->threadCond);
+    oc_mutex_unlock(thread->threadMutex);
 
-    message->msg = data;
-    message->size = size;
+    return CA_STATUS_OK;
+}
 
-    // mutex lock
+void *CAQueueingThreadTakeData(CAQueueingThread_t *thread, uint32_t *size)
+{
+    if (NULL == thread || NULL == size)
+    {
+        OIC_LOG(ERROR, TAG, "thread instance is empty..");
+        return NULL;
+    }
+
+    u_queue_message_t message = { .msg = NULL, .size = 0 };
     oc_mutex_lock(thread->threadMutex);
+    (void)CAQueueingThreadTake(thread, &message, 1);
+    oc_mutex_unlock(thread->threadMutex);
 
-    // add thread data into list
-    u_queue_add_element(thread->dataQueue, message);
+    *size = message.size;
+    return message.msg;
+}
 
-    // notity the thread
-    oc_cond_signal(thread->threadCond);
+bool CAQueueingThreadHasData(CAQueueingThread_t *thread)
+{
+    if (NULL == thread)
+    {
+        OIC_LOG(ERROR, TAG, "thread instance is empty..");
+        return false;
+    }
 
-    // mutex unlock
+    oc_mutex_lock(thread->threadMutex);
+    bool hasData = thread->pendingHead || thread->overflowHead ||
+                   !u_mpsc_queue_is_empty(thread->dataQueue);
     oc_mutex_unlock(thread->threadMutex);
 
-    return CA_STATUS_OK;
+    return hasData;
 }
 
-CAResult_t CAQueueingThreadDestroy(CAQueueingThread_t *thread)
+CAResult_t CAQueueingThreadClearContextData(CAQueueingThread_t *thread,
+                                            CAContextDataDestroy callback, void *ctx)
 {
-    if (NULL == thread)
+    if (NULL == thread || NULL == callback)
     {
         OIC_LOG(ERROR, TAG, "thread instance is empty..");
         return CA_STATUS_INVALID_PARAM;
     }
 
-    OIC_LOG(DEBUG, TAG, "thread destroy..");
+    CAResult_t res = CA_STATUS_OK;
+    CAQueueingItem_t *keptHead = NULL;
+    CAQueueingItem_t *keptTail = NULL;
+    u_queue_message_t messages[CA_QUEUE_BATCH];
 
-    // mutex lock
     oc_mutex_lock(thread->threadMutex);
 
-    // remove all remained list data.
-    while (u_queue_get_size(thread->dataQueue) > 0)
+    // Move everything but the overflow list to a new pending list, in order.
+    uint32_t count = 0;
+    while (0 < (count = CATakePendingData(thread, messages, CA_QUEUE_BATCH)) ||
+           0 < (count = u_mpsc_queue_pop(thread->dataQueue, messages, CA_QUEUE_BATCH)))
     {
-        // get data
-        u_queue_message_t *message = u_queue_get_element(thread->dataQueue);
-
-        // free
-        if (NULL != message)
+        for (uint32_t i = 0; i < count; i++)
         {
-            if (NULL != thread->destroy)
+            if (callback(messages[i].msg, messages[i].size, ctx))
             {
-                thread->destroy(message->msg, message->size);
+                CAQueueingThreadDestroyData(thread, messages[i].msg, messages[i].size);
             }
-            else
+            else if (!CAAppendItem(&keptHead, &keptTail, messages[i].msg, messages[i].size))
             {
-                OICFree(message->msg);
+                OIC_LOG(ERROR, TAG, "memory error!!");
+                CAQueueingThreadDestroyData(thread, messages[i].msg, messages[i].size);
+                res = CA_MEMORY_ALLOC_FAILED;
             }
+        }
+    }
+    thread->pendingHead = keptHead;
+    thread->pendingTail = keptTail;
+
+    CAQueueingItem_t **link = &thread->overflowHead;
+    thread->overflowTail = NULL;
+    while (*link)
+    {
+        CAQueueingItem_t *item = *link;
+        if (callback(item->message.msg, item->message.size, ctx))
+        {
+            *link = item->next;
+            CAQueueingThreadDestroyData(thread, item->message.msg, item->message.size);
+            OICFree(item);
+        }
+        else
+        {
+            thread->overflowTail = item;
+            link = &item->next;
+        }
+    }
+
+    oc_mutex_unlock(thread->threadMutex);
+
+    return res;
+}
 
-            OICFree(message);
+CAResult_t CAQueueingThreadDestroy(CAQueueingThread_t *thread)
+{
+    if (NULL == thread)
+    {
+        OIC_LOG(ERROR, TAG, "thread instance is empty..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    OIC_LOG(DEBUG, TAG, "thread destroy..");
+
+    // mutex lock
+    oc_mutex_lock(thread->threadMutex);
+
+    // remove all remained list data.
+    u_queue_message_t messages[CA_QUEUE_BATCH];
+    uint32_t count = 0;
+    while (0 < (count = CAQueueingThreadTake(thread, messages, CA_QUEUE_BATCH)))
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            CAQueueingThreadDestroyData(thread, messages[i].msg, messages[i].size);
         }
     }
 
-    u_queue_delete(thread->dataQueue);
+    u_mpsc_queue_delete(thread->dataQueue);
     thread->dataQueue = NULL;
 
     // mutex unlock
@@ -73,10 +73,13 @@
 
 #define TAG "OIC_CA_RETRANS"
 
-typedef struct
+typedef struct CARetransmissionData
 {
     uint64_t timeStamp;                 /**< last sent time. microseconds */
     uint64_t timeout;                   /**< timeout value. microseconds */
+    uint64_t deadline;                  /**< next retransmission time. microseconds */
+    size_t heapIndex;                   /**< position in the retransmission heap */
+    struct CARetransmissionData *next;  /**< next data in the same hash bucket */
     uint8_t triedCount;                 /**< retransmission count */
     uint16_t messageId;                 /**< coap PDU message id */
     CADataType_t dataType;              /**< data Type (Request/Response) */
@@ -85,10 +88,15 @@ typedef struct
     uint32_t size;                      /**< coap PDU size */
 } CARetransmissionData_t;
 
-static const uint64_t USECS_PER_SEC = 1000000;
 static const uint64_t USECS_PER_MSEC = 1000;
 static const uint64_t MSECS_PER_SEC = 1000;
 
+/** initial number of hash buckets and heap slots. **/
+#define RETRANSMISSION_INITIAL_SIZE     16
+
+/** message ids are 16 bit, more buckets than this would stay empty. **/
+#define RETRANSMISSION_MAX_TABLE_SIZE   (UINT16_MAX + 1)
+
 /**
  * @brief   timeout value is
  *          between DEFAULT_ACK_TIMEOUT_SEC and
@@ -135,24 +143,200 @@ CAResult_t CARetransmissionStart(CARetransmission_t *context)
 }
 
 /**
- * @brief   check timeout routine
- * @param[in] currentTime  microseconds
+ * @brief   calculate the next retransmission time, doubling the timeout for each try.
  * @param[in] retData      retransmission data
- * @return  true if the timeout period has elapsed, false otherwise
+ * @return  microseconds
  */
-static bool CACheckTimeout(uint64_t currentTime, CARetransmissionData_t *retData)
+static uint64_t CAGetDeadline(const CARetransmissionData_t *retData)
 {
-    // #1. calculate timeout
     uint64_t milliTimeoutValue = retData->timeout / USECS_PER_MSEC;
     uint64_t timeout = (milliTimeoutValue << retData->triedCount) * USECS_PER_MSEC;
 
-    if (currentTime >= retData->timeStamp + timeout)
+    return retData->timeStamp + timeout;
+}
+
+static void CAHeapSet(CARetransmission_t *context, size_t index, CARetransmissionData_t *retData)
+{
+    context->dataHeap[index] = retData;
+    retData->heapIndex = index;
+}
+
+static void CAHeapSiftUp(CARetransmission_t *context, size_t index)
+{
+    CARetransmissionData_t *retData = context->dataHeap[index];
+    while (index > 0)
     {
-        OIC_LOG_V(DEBUG, TAG, "%" PRIu64 " microseconds time out!!, tried count(%d)",
-                  timeout, retData->triedCount);
-        return true;
+        size_t parent = (index - 1) / 2;
+        if (context->dataHeap[parent]->deadline <= retData->deadline)
+        {
+            break;
+        }
+        CAHeapSet(context, index, context->dataHeap[parent]);
+        index = parent;
+    }
+    CAHeapSet(context, index, retData);
+}
+
+static void CAHeapSiftDown(CARetransmission_t *context, size_t index)
+{
+    CARetransmissionData_t *retData = context->dataHeap[index];
+    while (true)
+    {
+        size_t child = 2 * index + 1;
+        if (child >= context->dataCount)
+        {
+            break;
+        }
+        if (child + 1 < context->dataCount
+            && context->dataHeap[child + 1]->deadline < context->dataHeap[child]->deadline)
+        {
+            child++;
+        }
+        if (retData->deadline <= context->dataHeap[child]->deadline)
+        {
+            break;
+        }
+        CAHeapSet(context, index, context->dataHeap[child]);
+        index = child;
+    }
+    CAHeapSet(context, index, retData);
+}
+
+static size_t CAGetBucket(const CARetransmission_t *context, uint16_t messageId)
+{
+    return messageId & (context->tableSize - 1);
+}
+
+/**
+ * @brief   double the number of hash buckets once they hold one data each on average.
+ * @param[in] context      context for retransmission.
+ */
+static void CAGrowTable(CARetransmission_t *context)
+{
+    if (context->dataCount < context->tableSize
+        || context->tableSize >= RETRANSMISSION_MAX_TABLE_SIZE)
+    {
+        return;
+    }
+
+    size_t oldSize = context->tableSize;
+    CARetransmissionData_t **oldTable = context->dataTable;
+    CARetransmissionData_t **newTable = (CARetransmissionData_t **) OICCalloc(
+                                            oldSize * 2, sizeof(CARetransmissionData_t *));
+    if (NULL == newTable)
+    {
+        // keep using the smaller table, lookups are only slower.
+        OIC_LOG(ERROR, TAG, "memory error");
+        return;
+    }
+
+    context->dataTable = newTable;
+    context->tableSize = oldSize * 2;
+
+    for (size_t i = 0; i < oldSize; i++)
+    {
+        CARetransmissionData_t *retData = oldTable[i];
+        while (NULL != retData)
+        {
+            CARetransmissionData_t *next = retData->next;
+            size_t bucket = CAGetBucket(context, retData->messageId);
+            retData->next = newTable[bucket];
+            newTable[bucket] = retData;
+            retData = next;
+        }
+    }
+    OICFree(oldTable);
+}
+
+static CARetransmissionData_t *CAFindRetransmissionData(const CARetransmission_t *context,
+                                                        uint16_t messageId,
+                                                        CATransportAdapter_t adapter)
+{
+    CARetransmissionData_t *retData = context->dataTable[CAGetBucket(context, messageId)];
+    while (NULL != retData)
+    {
+        if (retData->messageId == messageId && NULL != retData->endpoint
+            && retData->endpoint->adapter == adapter)
+        {
+            return retData;
+        }
+        retData = retData->next;
+    }
+    return NULL;
+}
+
+/**
+ * @brief   add data to the heap and the hash table. caller must hold threadMutex.
+ * @return  ::CA_STATUS_OK or ::CA_MEMORY_ALLOC_FAILED.
+ */
+static CAResult_t CAAddRetransmissionData(CARetransmission_t *context,
+                                          CARetransmissionData_t *retData)
+{
+    if (context->dataCount == context->dataCapacity)
+    {
+        size_t capacity = context->dataCapacity * 2;
+        CARetransmissionData_t **heap = (CARetransmissionData_t **) OICRealloc(
+                                            context->dataHeap,
+                                            capacity * sizeof(CARetransmissionData_t *));
+        if (NULL == heap)
+        {
+            OIC_LOG(ERROR, TAG, "memory error");
+            return CA_MEMORY_ALLOC_FAILED;
+        }
+        context->dataHeap = heap;
+        context->dataCapacity = capacity;
+    }
+
+    context->dataHeap[context->dataCount] = retData;
+    retData->heapIndex = context->dataCount;
+    context->dataCount++;
+    CAHeapSiftUp(context, retData->heapIndex);
+
+    size_t bucket = CAGetBucket(context, retData->messageId);
+    retData->next = context->dataTable[bucket];
+    context->dataTable[bucket] = retData;
+    CAGrowTable(context);
+
+    return CA_STATUS_OK;
+}
+
+/**
+ * @brief   remove data from the heap and the hash table. caller must hold threadMutex.
+ */
+static void CARemoveRetransmissionData(CARetransmission_t *context,
+                                       CARetransmissionData_t *retData)
+{
+    CARetransmissionData_t **link = &context->dataTable[CAGetBucket(context, retData->messageId)];
+    while (*link != retData)
+    {
+        link = &(*link)->next;
+    }
+    *link = retData->next;
+
+    size_t index = retData->heapIndex;
+    context->dataCount--;
+    if (index < context->dataCount)
+    {
+        // move the last data into the hole and restore the heap order from there.
+        CARetransmissionData_t *last = context->dataHeap[context->dataCount];
+        CAHeapSet(context, index, last);
+        if (index > 0 && context->dataHeap[(index - 1) / 2]->deadline > last->deadline)
+        {
+            CAHeapSiftUp(context, index);
+        }
+        else
+        {
+            CAHeapSiftDown(context, index);
+        }
     }
-    return false;
+    context->dataHeap[context->dataCount] = NULL;
+}
+
+static void CAFreeRetransmissionData(CARetransmissionData_t *retData)
+{
+    CAFreeEndpoint(retData->endpoint);
+    OICFree(retData->pdu);
+    OICFree(retData);
 }
 
 static void CACheckRetransmissionList(CARetransmission_t *context)
@@ -166,64 +350,49 @@ static void CACheckRetransmissionList(CARetransmission_t *context)
     // mutex lock
     oc_mutex_lock(context->threadMutex);
 
-    size_t len = u_arraylist_length(context->dataList);
+    uint64_t currentTime = OICGetCurrentTime(TIME_IN_US);
 
-    for (size_t i = 0; i < len; i++)
+    // #1. only the data at the top of the heap can be due.
+    while (context->dataCount > 0 && context->dataHeap[0]->deadline <= currentTime)
     {
-        CARetransmissionData_t *retData = u_arraylist_get(context->dataList, i);
+        CARetransmissionData_t *retData = context->dataHeap[0];
 
-        if (NULL == retData)
-        {
-            continue;
-        }
-
-        uint64_t currentTime = OICGetCurrentTime(TIME_IN_US);
+        OIC_LOG_V(DEBUG, TAG, "%" PRIu64 " microseconds time out!!, tried count(%d)",
+                  retData->deadline - retData->timeStamp, retData->triedCount);
 
-        if (CACheckTimeout(currentTime, retData))
+        // #2. if time's up, send the data.
+        if (NULL != context->dataSendMethod)
         {
-            // #2. if time's up, send the data.
-            if (NULL != context->dataSendMethod)
-            {
-                OIC_LOG_V(DEBUG, TAG, "retransmission CON data!!, msgid=%d",
-                          retData->messageId);
-                context->dataSendMethod(retData->endpoint, retData->pdu,
-                                        retData->size, retData->dataType);
-            }
-
-            // #3. increase the retransmission count and update timestamp.
-            retData->timeStamp = currentTime;
-            retData->triedCount++;
+            OIC_LOG_V(DEBUG, TAG, "retransmission CON data!!, msgid=%d",
+                      retData->messageId);
+            context->dataSendMethod(retData->endpoint, retData->pdu,
+                                    retData->size, retData->dataType);
         }
 
-        // #4. if tried count is max, remove the retransmission data from list.
+        // #3. increase the retransmission count and update timestamp.
+        retData->timeStamp = currentTime;
+        retData->triedCount++;
+
+        // #4. if tried count is max, remove the retransmission data.
         if (retData->triedCount >= context->config.tryingCount)
         {
-            CARetransmissionData_t *removedData = u_arraylist_remove(context->dataList, i);
-            if (NULL == removedData)
-            {
-                OIC_LOG(ERROR, TAG, "Removed data is NULL");
-                // mutex unlock
-                oc_mutex_unlock(context->threadMutex);
-                return;
-            }
+            CARemoveRetransmissionData(context, retData);
             OIC_LOG_V(DEBUG, TAG, "max trying count, remove RTCON data,"
-                      "msgid=%d", removedData->messageId);
+                      "msgid=%d", retData->messageId);
 
             // callback for retransmit timeout
             if (NULL != context->timeoutCallback)
             {
-                context->timeoutCallback(removedData->endpoint, removedData->pdu,
-                                         removedData->size);
+                context->timeoutCallback(retData->endpoint, retData->pdu,
+                                         retData->size);
             }
 
-            CAFreeEndpoint(removedData->endpoint);
-            OICFree(removedData->pdu);
-
-            OICFree(removedData);
-
-            // modify loop value.
-            len = u_arraylist_length(context->dataList);
-            --i;
+            CAFreeRetransmissionData(retData);
+        }
+        else
+        {
+            retData->deadline = CAGetDeadline(retData);
+            CAHeapSiftDown(context, 0);
         }
     }
 
@@ -250,7 +419,7 @@ void CARetransmissionBaseRoutine(void *threadValue)
         // mutex lock
         oc_mutex_lock(context->threadMutex);
 
-        if (!context->isStop && u_arraylist_length(context->dataList) <= 0)
+        if (!context->isStop && 0 == context->dataCount)
         {
             // if list is empty, thread will wait
             OIC_LOG(DEBUG, TAG, "wait..there is no retransmission data.");
@@ -262,13 +431,19 @@ void CARetransmissionBaseRoutine(void *threadValue)
         }
         else if (!context->isStop)
         {
-            // check each RETRANSMISSION_CHECK_PERIOD_SEC time.
-            OIC_LOG_V(DEBUG, TAG, "wait..(%" PRIu64 ")microseconds",
-                      RETRANSMISSION_CHECK_PERIOD_SEC * (uint64_t) USECS_PER_SEC);
+            // sleep until the earliest retransmission is due.
+            uint64_t currentTime = OICGetCurrentTime(TIME_IN_US);
+            uint64_t deadline = context->dataHeap[0]->deadline;
 
-            // wait
-            uint64_t absTime = RETRANSMISSION_CHECK_PERIOD_SEC * (uint64_t) USECS_PER_SEC;
-            oc_cond_wait_for(context->threadCond, context->threadMutex, absTime );
+            if (deadline > currentTime)
+            {
+                OIC_LOG_V(DEBUG, TAG, "wait..(%" PRIu64 ")microseconds",
+                          deadline - currentTime);
+
+                // wait
+                oc_cond_wait_for(context->threadCond, context->threadMutex,
+                                 deadline - currentTime);
+            }
         }
         else
         {
@@ -323,6 +498,20 @@ CAResult_t CARetransmissionInitialize(CARetransmission_t *context,
         cfg = *config;
     }
 
+    context->dataHeap = (CARetransmissionData_t **) OICCalloc(
+                            RETRANSMISSION_INITIAL_SIZE, sizeof(CARetransmissionData_t *));
+    context->dataTable = (CARetransmissionData_t **) OICCalloc(
+                             RETRANSMISSION_INITIAL_SIZE, sizeof(CARetransmissionData_t *));
+    if (NULL == context->dataHeap || NULL == context->dataTable)
+    {
+        OIC_LOG(ERROR, TAG, "memory error");
+        OICFree(context->dataHeap);
+        OICFree(context->dataTable);
+        context->dataHeap = NULL;
+        context->dataTable = NULL;
+        return CA_MEMORY_ALLOC_FAILED;
+    }
+
     // set send thread data
     context->threadPool = handle;
     context->threadMutex = oc_mutex_new();
@@ -331,7 +520,9 @@ CAResult_t CARetransmissionInitialize(CARetransmission_t *context,
     context->timeoutCallback = timeoutCallback;
     context->config = cfg;
     context->isStop = false;
-    context->dataList = u_arraylist_create();
+    context->dataCount = 0;
+    context->dataCapacity = RETRANSMISSION_INITIAL_SIZE;
+    context->tableSize = RETRANSMISSION_INITIAL_SIZE;
 
     return CA_STATUS_OK;
 }
@@ -400,6 +591,7 @@ CAResult_t CARetransmissionSentData(CARetransmission_t *context,
     retData->timeStamp = OICGetCurrentTime(TIME_IN_US);
     retData->timeout = CAGetTimeoutValue();
     retData->triedCount = 0;
+    retData->deadline = CAGetDeadline(retData);
     retData->messageId = messageId;
     retData->endpoint = remoteEndpoint;
     retData->pdu = pduData;
@@ -408,38 +600,33 @@ CAResult_t CARetransmissionSentData(CARetransmission_t *context,
     // mutex lock
     oc_mutex_lock(context->threadMutex);
 
-    size_t len = u_arraylist_length(context->dataList);
-
     // #3. add data into list
-    for (size_t i = 0; i < len; i++)
+    if (NULL != CAFindRetransmissionData(context, messageId, endpoint->adapter))
     {
-        CARetransmissionData_t *currData = u_arraylist_get(context->dataList, i);
+        OIC_LOG(ERROR, TAG, "Duplicate message ID");
 
-        if (NULL == currData)
-        {
-            continue;
-        }
+        // mutex unlock
+        oc_mutex_unlock(context->threadMutex);
 
-        // found index
-        if (NULL != currData->endpoint && currData->messageId == messageId
-            && (currData->endpoint->adapter == endpoint->adapter))
-        {
-            OIC_LOG(ERROR, TAG, "Duplicate message ID");
+        CAFreeRetransmissionData(retData);
+        return CA_STATUS_FAILED;
+    }
 
-            // mutex unlock
-            oc_mutex_unlock(context->threadMutex);
+    CAResult_t res = CAAddRetransmissionData(context, retData);
+    if (CA_STATUS_OK != res)
+    {
+        // mutex unlock
+        oc_mutex_unlock(context->threadMutex);
 
-            OICFree(retData);
-            OICFree(pduData);
-            OICFree(remoteEndpoint);
-            return CA_STATUS_FAILED;
-        }
+        CAFreeRetransmissionData(retData);
+        return res;
     }
 
-    u_arraylist_add(context->dataList, (void *) retData);
-
-    // notify the thread
-    oc_cond_signal(context->threadCond);
+    // notify the thread if it has to wake up earlier than planned.
+    if (0 == retData->heapIndex)
+    {
+        oc_cond_signal(context->threadCond);
+    }
 
     // mutex unlock
     oc_mutex_unlock(context->threadMutex);
@@ -482,73 +669,46 @@ CAResult_t CARetransmissionReceivedData(CARetransmission_t *context,
 
     // mutex lock
     oc_mutex_lock(context->threadMutex);
-    size_t len = u_arraylist_length(context->dataList);
 
-    for (size_t i = 0; i < len; i++)
+    CARetransmissionData_t *retData = CAFindRetransmissionData(context, messageId,
+                                                               endpoint->adapter);
+    if (NULL != retData)
     {
-        CARetransmissionData_t *retData = (CARetransmissionData_t *) u_arraylist_get(
-                context->dataList, i);
-
-        if (NULL == retData)
+        // get pdu data for getting token when CA_EMPTY(RST/ACK) is received from remote device
+        // if retransmission was finish..token will be unavailable.
+        if (CA_EMPTY == code)
         {
-            continue;
-        }
+            OIC_LOG(DEBUG, TAG, "code is CA_EMPTY");
 
-        // found index
-        if (NULL != retData->endpoint && retData->messageId == messageId
-            && (retData->endpoint->adapter == endpoint->adapter))
-        {
-            // get pdu data for getting token when CA_EMPTY(RST/ACK) is received from remote device
-            // if retransmission was finish..token will be unavailable.
-            if (CA_EMPTY == CAGetCodeFromPduBinaryData(pdu, size))
+            if (NULL == retData->pdu)
             {
-                OIC_LOG(DEBUG, TAG, "code is CA_EMPTY");
-
-                if (NULL == retData->pdu)
-                {
-                    OIC_LOG(ERROR, TAG, "retData->pdu is null");
-                    OICFree(retData);
-                    // mutex unlock
-                    oc_mutex_unlock(context->threadMutex);
-
-                    return CA_STATUS_FAILED;
-                }
-
-                // copy PDU data
-                (*retransmissionPdu) = (void *) OICCalloc(1, retData->size);
-                if ((*retransmissionPdu) == NULL)
-                {
-                    OICFree(retData);
-                    OIC_LOG(ERROR, TAG, "memory error");
-
-                    // mutex unlock
-                    oc_mutex_unlock(context->threadMutex);
-
-                    return CA_MEMORY_ALLOC_FAILED;
-                }
-                memcpy((*retransmissionPdu), retData->pdu, retData->size);
+                OIC_LOG(ERROR, TAG, "retData->pdu is null");
+                // mutex unlock
+                oc_mutex_unlock(context->threadMutex);
+
+                return CA_STATUS_FAILED;
             }
 
-            // #2. remove data from list
-            CARetransmissionData_t *removedData = u_arraylist_remove(context->dataList, i);
-            if (NULL == removedData)
+            // copy PDU data
+            (*retransmissionPdu) = (void *) OICCalloc(1, retData->size);
+            if ((*retransmissionPdu) == NULL)
             {
-                OIC_LOG(ERROR, TAG, "Removed data is NULL");
+                OIC_LOG(ERROR, TAG, "memory error");
 
                 // mutex unlock
                 oc_mutex_unlock(context->threadMutex);
 
-                return CA_STATUS_FAILED;
+                return CA_MEMORY_ALLOC_FAILED;
             }
+            memcpy((*retransmissionPdu), retData->pdu, retData->size);
+        }
 
-            OIC_LOG_V(DEBUG, TAG, "remove RTCON data!!, msgid=%d", messageId);
+        // #2. remove data from list
+        CARemoveRetransmissionData(context, retData);
 
-            CAFreeEndpoint(removedData->endpoint);
-            OICFree(removedData->pdu);
-            OICFree(removedData);
+        OIC_LOG_V(DEBUG, TAG, "remove RTCON data!!, msgid=%d", messageId);
 
-            break;
-        }
+        CAFreeRetransmissionData(retData);
     }
 
     // mutex unlock
@@ -596,24 +756,22 @@ CAResult_t CARetransmissionDestroy(CARetransmission_t *context)
     OIC_LOG(DEBUG, TAG, "retransmission context destroy..");
 
     oc_mutex_lock(context->threadMutex);
-    size_t len = u_arraylist_length(context->dataList);
-    for (size_t i = 0; i < len; i++)
+    for (size_t i = 0; i < context->dataCount; i++)
     {
-        CARetransmissionData_t *data = u_arraylist_get(context->dataList, i);
-        if (NULL == data)
-        {
-            continue;
-        }
-        CAFreeEndpoint(data->endpoint);
-        OICFree(data->pdu);
-        OICFree(data);
+        CAFreeRetransmissionData(context->dataHeap[i]);
     }
+    context->dataCount = 0;
     oc_mutex_unlock(context->threadMutex);
 
     oc_mutex_free(context->threadMutex);
     context->threadMutex = NULL;
     oc_cond_free(context->threadCond);
-    u_arraylist_free(&context->dataList);
+    OICFree(context->dataHeap);
+    context->dataHeap = NULL;
+    context->dataCapacity = 0;
+    OICFree(context->dataTable);
+    context->dataTable = NULL;
+    context->tableSize = 0;
 
     return CA_STATUS_OK;
 }
@@ -171,6 +171,9 @@ CAResult_t CAIPInitializeQueueHandles(void)
         return CA_STATUS_FAILED;
     }
 
+    // Datagrams are held while more data is queued and sent together once drained.
+    CAQueueingThreadSetFlush(g_sendQueueHandle, CAIPFlushSendData);
+
     return CA_STATUS_OK;
 }
 
@@ -598,7 +601,7 @@ void CAIPSendDataThread(void *threadData)
     {
         //Processing for sending multicast
         OIC_LOG(DEBUG, TAG, "Send Multicast Data is called");
-        CAIPSendData(ipData->remoteEndpoint, ipData->data, ipData->dataLen, true);
+        CAIPSendDataBatched(ipData->remoteEndpoint, ipData->data, ipData->dataLen, true);
     }
     else
     {
@@ -617,10 +620,10 @@ void CAIPSendDataThread(void *threadData)
         else
         {
             OIC_LOG(DEBUG, TAG, "Send Unicast Data is called");
-            CAIPSendData(ipData->remoteEndpoint, ipData->data, ipData->dataLen, false);
+            CAIPSendDataBatched(ipData->remoteEndpoint, ipData->data, ipData->dataLen, false);
         }
 #else
-        CAIPSendData(ipData->remoteEndpoint, ipData->data, ipData->dataLen, false);
+        CAIPSendDataBatched(ipData->remoteEndpoint, ipData->data, ipData->dataLen, false);
 #endif
     }
 }
@@ -60,6 +60,10 @@
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
 #endif
+#ifdef WITH_EPOLL
+#include <sys/epoll.h>
+#include <poll.h>
+#endif
 
 #include <coap/pdu.h>
 #include <inttypes.h>
@@ -114,6 +118,67 @@ static struct in6_addr IPv6MulticastAddressGlb;
  */
 #define RECV_MSG_BUF_LEN 16384
 
+#ifdef WITH_EPOLL
+/*
+ * Number of datagrams received by a single recvmmsg() call
+ */
+#define RECV_MMSG_COUNT 8
+
+/*
+ * Number of events returned by a single epoll_wait() call
+ */
+#define EPOLL_EVENT_COUNT 16
+
+/*
+ * Longest wait of the receive thread after repeated epoll_wait() failures
+ */
+#define EPOLL_ERROR_MAX_BACKOFF_MS 1000
+#endif
+
+#ifdef HAVE_SENDMMSG
+/*
+ * Number of datagrams sent by a single sendmmsg() call
+ */
+#define SEND_MMSG_COUNT 32
+
+/*
+ * Number of sockets with datagrams held for sendmmsg(), the IPv4 and IPv6 unicast socket
+ */
+#define SEND_BATCH_SOCKETS 2
+
+/*
+ * Control buffer of a batched datagram, large enough for either pktinfo
+ */
+#define SEND_CONTROL_LEN CMSG_SPACE(sizeof (struct in6_pktinfo))
+
+/*
+ * A datagram held for sendmmsg(). Its data is kept in the buffer of the batch.
+ */
+typedef struct
+{
+    CAEndpoint_t endpoint;
+    struct sockaddr_storage addr;
+    socklen_t addrlen;
+    int ifindex;                    // outgoing interface of a multicast datagram, 0 if none
+    size_t offset;
+    size_t len;
+    const char *cast;
+    const char *fam;
+} CASendEntry_t;
+
+typedef struct
+{
+    CASocketFd_t fd;
+    size_t count;
+    CASendEntry_t entries[SEND_MMSG_COUNT];
+    unsigned char *buffer;
+    size_t used;
+    size_t capacity;
+    uint32_t lastCall;              // CAIPSendDataBatched() call which copied lastOffset
+    size_t lastOffset;
+} CASendBatch_t;
+#endif
+
 static char *ipv6mcnames[IPv6_DOMAINS] = {
     NULL,
     IPv6_MULTICAST_INT,
@@ -156,6 +221,41 @@ static CAIPPacketReceivedCallback g_packetReceivedCallback = NULL;
 static oc_mutex g_mutex = NULL;
 static oc_cond g_condVar = NULL;
 
+#ifdef WITH_EPOLL
+/*
+ * Wait set of the receive thread, -1 when select() is used instead.
+ */
+static int g_epollFd = -1;
+
+/*
+ * RECV_MMSG_COUNT receive buffers, only used by the receive thread.
+ */
+static char *g_recvBuffers = NULL;
+
+/*
+ * Consecutive epoll_wait() failures, only used by the receive thread.
+ */
+static unsigned int g_epollErrors = 0;
+#endif
+
+#ifdef HAVE_SENDMMSG
+/*
+ * Datagrams held for sendmmsg(), only used by the send queue thread.
+ */
+static CASendBatch_t *g_sendBatches = NULL;
+
+/*
+ * Number of the current CAIPSendDataBatched() call. A multicast datagram sent on several
+ * interfaces is copied to a batch once per call.
+ */
+static uint32_t g_sendCall = 0;
+
+static size_t g_batchedDatagrams = 0;
+static size_t g_batchedCalls = 0;
+
+static void CAIPFreeSendBatches(void);
+#endif
+
 static CAResult_t CAIPCreateMutex(void);
 static void CAIPDestroyMutex(void);
 static CAResult_t CAIPCreateCond(void);
@@ -168,6 +268,16 @@ static void CAEventReturned(CASocketFd_t socket);
 #endif
 
 static CAResult_t CAReceiveMessage(CASocketFd_t fd, CATransportFlags_t flags);
+static CAResult_t CAProcessReceivedData(CATransportFlags_t flags,
+                                        const struct sockaddr_storage *srcAddr, int namelen,
+                                        unsigned char *pktinfo,
+                                        char *recvBuffer, size_t recvLen);
+static void CAProcessInterfaceChange(void);
+#ifdef WITH_EPOLL
+static void CAIPCreateEpoll(void);
+static void CAIPCloseEpoll(void);
+static void CAWaitForEpollEvents(void);
+#endif
 
 static CAResult_t CAIPCreateMutex(void)
 {
@@ -218,6 +328,9 @@ static void CACloseFDs(void)
         close(caglobals.ip.shutdownFds[0]);
         caglobals.ip.shutdownFds[0] = -1;
     }
+#endif
+#ifdef WITH_EPOLL
+    CAIPCloseEpoll();
 #endif
     CADeInitializeIPGlobals();
 }
@@ -228,6 +341,13 @@ static void CAReceiveHandler(void *data)
 
     while (!caglobals.ip.terminate)
     {
+#ifdef WITH_EPOLL
+        if (-1 != g_epollFd)
+        {
+            CAWaitForEpollEvents();
+            continue;
+        }
+#endif
         CAFindReadyMessage();
     }
     CACloseFDs();
@@ -329,23 +449,7 @@ static void CASelectReturned(fd_set *readFds, int ret)
         else ISSET(m4s, readFds, CA_MULTICAST | CA_IPV4 | CA_SECURE)
         else if ((caglobals.ip.netlinkFd != OC_INVALID_SOCKET) && FD_ISSET(caglobals.ip.netlinkFd, readFds))
         {
-#if NETWORK_INTERFACE_CHANGED_LOGGING
-            OIC_LOG_V(DEBUG, TAG, "Netlink event detected");
-#endif
-            u_arraylist_t *iflist = CAFindInterfaceChange();
-            if (iflist)
-            {
-                size_t listLength = u_arraylist_length(iflist);
-                for (size_t i = 0; i < listLength; i++)
-                {
-                    CAInterface_t *ifitem = (CAInterface_t *)u_arraylist_get(iflist, i);
-                    if (ifitem)
-                    {
-                        CAProcessNewInterface(ifitem);
-                    }
-                }
-                u_arraylist_destroy(iflist);
-            }
+            CAProcessInterfaceChange();
             break;
         }
         else if (FD_ISSET(caglobals.ip.shutdownFds[0], readFds))
@@ -499,20 +603,7 @@ static void CAFindReadyMessage(void)
                     if ((caglobals.ip.addressChangeEvent != WSA_INVALID_EVENT) &&
                         (caglobals.ip.addressChangeEvent == eventArray[eventIndex]))
                     {
-                        u_arraylist_t *iflist = CAFindInterfaceChange();
-                        if (iflist)
-                        {
-                            size_t listLength = u_arraylist_length(iflist);
-                            for (size_t i = 0; i < listLength; i++)
-                            {
-                                CAInterface_t *ifitem = (CAInterface_t *)u_arraylist_get(iflist, i);
-                                if (ifitem)
-                                {
-                                    CAProcessNewInterface(ifitem);
-                                }
-                            }
-                            u_arraylist_destroy(iflist);
-                        }
+                        CAProcessInterfaceChange();
                         break;
                     }
 
@@ -580,6 +671,270 @@ static void CAEventReturned(CASocketFd_t socket)
 
 #endif
 
+static void CAProcessInterfaceChange(void)
+{
+#if NETWORK_INTERFACE_CHANGED_LOGGING
+    OIC_LOG_V(DEBUG, TAG, "Netlink event detected");
+#endif
+    u_arraylist_t *iflist = CAFindInterfaceChange();
+    if (iflist)
+    {
+        size_t listLength = u_arraylist_length(iflist);
+        for (size_t i = 0; i < listLength; i++)
+        {
+            CAInterface_t *ifitem = (CAInterface_t *)u_arraylist_get(iflist, i);
+            if (ifitem)
+            {
+                CAProcessNewInterface(ifitem);
+            }
+        }
+        u_arraylist_destroy(iflist);
+    }
+}
+
+#ifdef WITH_EPOLL
+
+#define EPOLL_ADD_IP_SOCKET(TYPE) \
+    if (caglobals.ip.TYPE.fd != OC_INVALID_SOCKET && \
+        !CAEpollAdd(caglobals.ip.TYPE.fd, EPOLLIN | EPOLLET)) \
+    { \
+        added = false; \
+    }
+
+#define IS_IP_SOCKET(TYPE, FLAGS) \
+    if (caglobals.ip.TYPE.fd != OC_INVALID_SOCKET && caglobals.ip.TYPE.fd == fd) \
+    { \
+        *flags = FLAGS; \
+        return true; \
+    }
+
+static bool CAEpollAdd(int fd, uint32_t events)
+{
+    struct epoll_event event = { .events = events, .data.fd = fd };
+    if (-1 == epoll_ctl(g_epollFd, EPOLL_CTL_ADD, fd, &event))
+    {
+        OIC_LOG_V(ERROR, TAG, "epoll_ctl(%d) failed: %s", fd, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+static void CAIPCreateEpoll(void)
+{
+    g_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (-1 == g_epollFd)
+    {
+        OIC_LOG_V(ERROR, TAG, "epoll_create1 failed: %s, using select", strerror(errno));
+        return;
+    }
+
+    g_recvBuffers = (char *)OICMalloc(RECV_MMSG_COUNT * RECV_MSG_BUF_LEN);
+    bool added = (NULL != g_recvBuffers);
+
+    // The IP sockets are edge triggered, CAReceiveMessages() drains them.
+    EPOLL_ADD_IP_SOCKET(u6)
+    EPOLL_ADD_IP_SOCKET(u6s)
+    EPOLL_ADD_IP_SOCKET(u4)
+    EPOLL_ADD_IP_SOCKET(u4s)
+    EPOLL_ADD_IP_SOCKET(m6)
+    EPOLL_ADD_IP_SOCKET(m6s)
+    EPOLL_ADD_IP_SOCKET(m4)
+    EPOLL_ADD_IP_SOCKET(m4s)
+
+    // A wakeup reads a single netlink or shutdown message, so these are level triggered.
+    if (caglobals.ip.netlinkFd != OC_INVALID_SOCKET &&
+        !CAEpollAdd(caglobals.ip.netlinkFd, EPOLLIN))
+    {
+        added = false;
+    }
+    if (caglobals.ip.shutdownFds[0] != -1 &&
+        !CAEpollAdd(caglobals.ip.shutdownFds[0], EPOLLIN))
+    {
+        added = false;
+    }
+
+    if (!added)
+    {
+        OIC_LOG(ERROR, TAG, "epoll setup failed, using select");
+        CAIPCloseEpoll();
+    }
+}
+
+static void CAIPCloseEpoll(void)
+{
+    if (-1 != g_epollFd)
+    {
+        close(g_epollFd);
+        g_epollFd = -1;
+    }
+    OICFree(g_recvBuffers);
+    g_recvBuffers = NULL;
+}
+
+static bool CAGetSocketFlags(int fd, CATransportFlags_t *flags)
+{
+    IS_IP_SOCKET(u6,  CA_IPV6)
+    IS_IP_SOCKET(u6s, CA_IPV6 | CA_SECURE)
+    IS_IP_SOCKET(u4,  CA_IPV4)
+    IS_IP_SOCKET(u4s, CA_IPV4 | CA_SECURE)
+    IS_IP_SOCKET(m6,  CA_MULTICAST | CA_IPV6)
+    IS_IP_SOCKET(m6s, CA_MULTICAST | CA_IPV6 | CA_SECURE)
+    IS_IP_SOCKET(m4,  CA_MULTICAST | CA_IPV4)
+    IS_IP_SOCKET(m4s, CA_MULTICAST | CA_IPV4 | CA_SECURE)
+    return false;
+}
+
+/*
+ * Receive every datagram queued on an edge triggered socket, up to RECV_MMSG_COUNT
+ * per system call.
+ */
+static void CAReceiveMessages(CASocketFd_t fd, CATransportFlags_t flags)
+{
+    struct mmsghdr msgs[RECV_MMSG_COUNT];
+    struct iovec iovs[RECV_MMSG_COUNT];
+    struct sockaddr_storage srcAddrs[RECV_MMSG_COUNT];
+    union control
+    {
+        struct cmsghdr cmsg;
+        unsigned char data[CMSG_SPACE(sizeof (struct in6_pktinfo))];
+    } cmsgs[RECV_MMSG_COUNT];
+
+    int namelen = sizeof (struct sockaddr_in);
+    int level = IPPROTO_IP;
+    int type = IP_PKTINFO;
+    if (flags & CA_IPV6)
+    {
+        namelen = sizeof (struct sockaddr_in6);
+        level = IPPROTO_IPV6;
+        type = IPV6_PKTINFO;
+    }
+
+    while (!caglobals.ip.terminate)
+    {
+        memset(msgs, 0, sizeof (msgs));
+        for (int i = 0; i < RECV_MMSG_COUNT; i++)
+        {
+            iovs[i].iov_base = g_recvBuffers + (i * RECV_MSG_BUF_LEN);
+            iovs[i].iov_len = RECV_MSG_BUF_LEN;
+            msgs[i].msg_hdr.msg_name = &srcAddrs[i];
+            msgs[i].msg_hdr.msg_namelen = namelen;
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_control = &cmsgs[i];
+            msgs[i].msg_hdr.msg_controllen = sizeof (cmsgs[i]);
+        }
+
+        int count = recvmmsg(fd, msgs, RECV_MMSG_COUNT, MSG_DONTWAIT, NULL);
+        if (-1 == count)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            if (EAGAIN != errno && EWOULDBLOCK != errno)
+            {
+                OIC_LOG_V(ERROR, TAG, "recvmmsg failed %s", strerror(errno));
+            }
+            return;
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            unsigned char *pktinfo = NULL;
+            for (struct cmsghdr *cmp = CMSG_FIRSTHDR(&msgs[i].msg_hdr); cmp != NULL;
+                 cmp = CMSG_NXTHDR(&msgs[i].msg_hdr, cmp))
+            {
+                if (cmp->cmsg_level == level && cmp->cmsg_type == type)
+                {
+                    pktinfo = CMSG_DATA(cmp);
+                }
+            }
+            (void)CAProcessReceivedData(flags, &srcAddrs[i], namelen, pktinfo,
+                                        (char *)iovs[i].iov_base, msgs[i].msg_len);
+        }
+
+        if (RECV_MMSG_COUNT > count)
+        {
+            // Drained, the next datagram triggers a new event.
+            return;
+        }
+    }
+}
+
+/**
+ * Wait before epoll_wait() is called again after it failed, doubling the wait with each
+ * failure in a row up to EPOLL_ERROR_MAX_BACKOFF_MS, so that a persistent error does not
+ * spin the receive thread. The wait ends early when the adapter is stopped.
+ */
+static void CABackOffEpollError(int error)
+{
+    OC_UNUSED(error); // only used for logging
+
+    if (0 == g_epollErrors)
+    {
+        OIC_LOG_V(FATAL, TAG, "epoll_wait error %s", strerror(error));
+    }
+
+    int backoff = 1 << g_epollErrors;
+    if (backoff < EPOLL_ERROR_MAX_BACKOFF_MS)
+    {
+        g_epollErrors++;
+    }
+    else
+    {
+        backoff = EPOLL_ERROR_MAX_BACKOFF_MS;
+    }
+
+    struct pollfd shutdownFd = { .fd = caglobals.ip.shutdownFds[0], .events = POLLIN };
+    (void)poll(&shutdownFd, 1, backoff);
+}
+
+static void CAWaitForEpollEvents(void)
+{
+    struct epoll_event events[EPOLL_EVENT_COUNT];
+    int timeout = (-1 == caglobals.ip.selectTimeout) ? -1 : caglobals.ip.selectTimeout * 1000;
+
+    int ret = epoll_wait(g_epollFd, events, EPOLL_EVENT_COUNT, timeout);
+
+    if (caglobals.ip.terminate)
+    {
+        OIC_LOG_V(DEBUG, TAG, "Packet receiver Stop request received.");
+        return;
+    }
+
+    if (-1 == ret)
+    {
+        if (EINTR != errno)
+        {
+            CABackOffEpollError(errno);
+        }
+        return;
+    }
+    g_epollErrors = 0;
+
+    for (int i = 0; i < ret && !caglobals.ip.terminate; i++)
+    {
+        int fd = events[i].data.fd;
+        CATransportFlags_t flags = CA_DEFAULT_FLAGS;
+
+        if (fd == caglobals.ip.netlinkFd)
+        {
+            CAProcessInterfaceChange();
+        }
+        else if (fd == caglobals.ip.shutdownFds[0])
+        {
+            char buf[10] = {0};
+            (void)read(caglobals.ip.shutdownFds[0], buf, sizeof (buf));
+        }
+        else if (CAGetSocketFlags(fd, &flags))
+        {
+            CAReceiveMessages(fd, flags);
+        }
+    }
+}
+
+#endif // WITH_EPOLL
+
 void CAUnregisterForAddressChanges(void)
 {
 #ifdef _WIN32
@@ -713,6 +1068,15 @@ static CAResult_t CAReceiveMessage(CASocketFd_t fd, CATransportFlags_t flags)
         }
     }
 #endif // !defined(WSA_CMSG_DATA)
+
+    return CAProcessReceivedData(flags, &srcAddr, namelen, pktinfo, recvBuffer, (size_t)recvLen);
+}
+
+static CAResult_t CAProcessReceivedData(CATransportFlags_t flags,
+                                        const struct sockaddr_storage *srcAddr, int namelen,
+                                        unsigned char *pktinfo,
+                                        char *recvBuffer, size_t recvLen)
+{
     if (!pktinfo)
     {
         OIC_LOG(ERROR, TAG, "pktinfo is null");
@@ -751,7 +1115,7 @@ static CAResult_t CAReceiveMessage(CASocketFd_t fd, CATransportFlags_t flags)
         }
     }
 
-    CAConvertAddrToName(&srcAddr, namelen, sep.endpoint.addr, &sep.endpoint.port);
+    CAConvertAddrToName(srcAddr, namelen, sep.endpoint.addr, &sep.endpoint.port);
 
     if (flags & CA_SECURE)
     {
@@ -1071,6 +1435,10 @@ CAResult_t CAIPStartServer(const ca_thread_pool_t threadPool)
     // create source of network address change notifications
     CARegisterForAddressChanges();
 
+#ifdef WITH_EPOLL
+    CAIPCreateEpoll();
+#endif
+
     caglobals.ip.selectTimeout = CAGetPollingInterval(caglobals.ip.selectTimeout);
 
     res = CAIPStartListenServer();
@@ -1132,6 +1500,10 @@ void CAIPStopServer(void)
 
     CAIPDestroyMutex();
     CAIPDestroyCond();
+
+#ifdef HAVE_SENDMMSG
+    CAIPFreeSendBatches();
+#endif
 }
 
 void CAWakeUpForChange(void)
@@ -1381,6 +1753,17 @@ void CAIPSetPacketReceiveCallback(CAIPPacketReceivedCallback callback)
     g_packetReceivedCallback = callback;
 }
 
+static socklen_t CAGetSendAddress(const CAEndpoint_t *endpoint, struct sockaddr_storage *sock)
+{
+    CAConvertNameToAddr(endpoint->addr, endpoint->port, sock);
+
+    if (sock->ss_family == AF_INET6)
+    {
+        return sizeof(struct sockaddr_in6);
+    }
+    return sizeof(struct sockaddr_in);
+}
+
 static void sendData(CASocketFd_t fd, const CAEndpoint_t *endpoint,
                      const void *data, size_t dlen,
                      const char *cast, const char *fam)
@@ -1401,17 +1784,7 @@ static void sendData(CASocketFd_t fd, const CAEndpoint_t *endpoint,
     (void)fam;
 
     struct sockaddr_storage sock = { .ss_family = 0 };
-    CAConvertNameToAddr(endpoint->addr, endpoint->port, &sock);
-
-    socklen_t socklen = 0;
-    if (sock.ss_family == AF_INET6)
-    {
-        socklen = sizeof(struct sockaddr_in6);
-    }
-    else
-    {
-        socklen = sizeof(struct sockaddr_in);
-    }
+    socklen_t socklen = CAGetSendAddress(endpoint, &sock);
 
 #ifdef TB_LOG
     const char *secure = (endpoint->flags & CA_SECURE) ? "secure " : "";
@@ -1482,9 +1855,218 @@ static void sendData(CASocketFd_t fd, const CAEndpoint_t *endpoint,
 #endif
 }
 
+#ifdef HAVE_SENDMMSG
+static void CASetSendPktinfo(struct msghdr *hdr, unsigned char *control, const CASendEntry_t *entry)
+{
+    memset(control, 0, SEND_CONTROL_LEN);
+    hdr->msg_control = control;
+
+    struct cmsghdr *cmsg = NULL;
+    if (AF_INET6 == entry->addr.ss_family)
+    {
+        hdr->msg_controllen = CMSG_SPACE(sizeof (struct in6_pktinfo));
+        cmsg = CMSG_FIRSTHDR(hdr);
+        cmsg->cmsg_level = IPPROTO_IPV6;
+        cmsg->cmsg_type = IPV6_PKTINFO;
+        cmsg->cmsg_len = CMSG_LEN(sizeof (struct in6_pktinfo));
+        struct in6_pktinfo *info = (struct in6_pktinfo *) CMSG_DATA(cmsg);
+        info->ipi6_ifindex = entry->ifindex;
+    }
+    else
+    {
+        hdr->msg_controllen = CMSG_SPACE(sizeof (struct in_pktinfo));
+        cmsg = CMSG_FIRSTHDR(hdr);
+        cmsg->cmsg_level = IPPROTO_IP;
+        cmsg->cmsg_type = IP_PKTINFO;
+        cmsg->cmsg_len = CMSG_LEN(sizeof (struct in_pktinfo));
+        struct in_pktinfo *info = (struct in_pktinfo *) CMSG_DATA(cmsg);
+        info->ipi_ifindex = entry->ifindex;
+    }
+}
+
+static void CAFlushSendBatch(CASendBatch_t *batch)
+{
+    struct mmsghdr msgs[SEND_MMSG_COUNT];
+    struct iovec iovs[SEND_MMSG_COUNT];
+    union
+    {
+        struct cmsghdr align;
+        unsigned char buf[SEND_CONTROL_LEN];
+    } controls[SEND_MMSG_COUNT];
+
+    memset(msgs, 0, sizeof (msgs[0]) * batch->count);
+    for (size_t i = 0; i < batch->count; i++)
+    {
+        CASendEntry_t *entry = &batch->entries[i];
+        iovs[i].iov_base = batch->buffer + entry->offset;
+        iovs[i].iov_len = entry->len;
+
+        struct msghdr *hdr = &msgs[i].msg_hdr;
+        hdr->msg_name = &entry->addr;
+        hdr->msg_namelen = entry->addrlen;
+        hdr->msg_iov = &iovs[i];
+        hdr->msg_iovlen = 1;
+        if (entry->ifindex)
+        {
+            // Select the interface of a multicast datagram per message instead of
+            // changing the multicast interface of the socket.
+            CASetSendPktinfo(hdr, controls[i].buf, entry);
+        }
+    }
+
+    size_t sent = 0;
+    while (sent < batch->count)
+    {
+        int ret = sendmmsg(batch->fd, msgs + sent, batch->count - sent, 0);
+        g_batchedCalls++;
+        if (-1 == ret)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+
+            // sendmmsg() fails when the first datagram fails, report it and go on.
+            CASendEntry_t *entry = &batch->entries[sent];
+            OIC_LOG_V(ERROR, TAG, "%s %s sendmmsg failed: %s", entry->cast, entry->fam,
+                      strerror(errno));
+            CALogSendStateInfo(entry->endpoint.adapter, entry->endpoint.addr,
+                               entry->endpoint.port, -1, false, strerror(errno));
+            if (g_ipErrorHandler)
+            {
+                g_ipErrorHandler(&entry->endpoint, iovs[sent].iov_base, entry->len,
+                                 CA_SEND_FAILED);
+            }
+            sent++;
+            continue;
+        }
+
+        for (int i = 0; i < ret; i++, sent++)
+        {
+            CASendEntry_t *entry = &batch->entries[sent];
+            OIC_LOG_V(INFO, TAG, "%s %s sendTo is successful: %u bytes", entry->cast, entry->fam,
+                      msgs[sent].msg_len);
+            CALogSendStateInfo(entry->endpoint.adapter, entry->endpoint.addr,
+                               entry->endpoint.port, msgs[sent].msg_len, true, NULL);
+        }
+    }
+
+    g_batchedDatagrams += batch->count;
+    batch->count = 0;
+    batch->used = 0;
+    batch->lastCall = 0;
+}
+
+static CASendBatch_t *CAGetSendBatch(CASocketFd_t fd)
+{
+    if (!g_sendBatches)
+    {
+        g_sendBatches = (CASendBatch_t *) OICCalloc(SEND_BATCH_SOCKETS, sizeof (*g_sendBatches));
+        if (!g_sendBatches)
+        {
+            OIC_LOG(ERROR, TAG, "OICCalloc - out of memory");
+            return NULL;
+        }
+        for (size_t i = 0; i < SEND_BATCH_SOCKETS; i++)
+        {
+            g_sendBatches[i].fd = OC_INVALID_SOCKET;
+        }
+    }
+
+    CASendBatch_t *empty = NULL;
+    for (size_t i = 0; i < SEND_BATCH_SOCKETS; i++)
+    {
+        if (g_sendBatches[i].fd == fd)
+        {
+            return &g_sendBatches[i];
+        }
+        if (!empty && !g_sendBatches[i].count)
+        {
+            empty = &g_sendBatches[i];
+        }
+    }
+
+    if (!empty)
+    {
+        empty = &g_sendBatches[0];
+        CAFlushSendBatch(empty);
+    }
+    empty->fd = fd;
+    return empty;
+}
+
+/**
+ * Hold a datagram until ::CAIPFlushSendData, or until the batch of its socket is full.
+ *
+ * @return false if the datagram could not be held and has to be sent right away.
+ */
+static bool queueData(CASocketFd_t fd, const CAEndpoint_t *endpoint, int ifindex,
+                      const void *data, size_t dlen, const char *cast, const char *fam)
+{
+    CASendBatch_t *batch = CAGetSendBatch(fd);
+    if (!batch)
+    {
+        return false;
+    }
+
+    if (SEND_MMSG_COUNT == batch->count ||
+        (batch->count && batch->used + dlen > RECV_MSG_BUF_LEN))
+    {
+        CAFlushSendBatch(batch);
+    }
+
+    size_t offset = batch->lastOffset;
+    if (batch->lastCall != g_sendCall)
+    {
+        if (batch->used + dlen > batch->capacity)
+        {
+            size_t capacity = (dlen > RECV_MSG_BUF_LEN) ? dlen : RECV_MSG_BUF_LEN;
+            unsigned char *buffer = (unsigned char *) OICRealloc(batch->buffer, capacity);
+            if (!buffer)
+            {
+                OIC_LOG(ERROR, TAG, "OICRealloc - out of memory");
+                return false;
+            }
+            batch->buffer = buffer;
+            batch->capacity = capacity;
+        }
+        offset = batch->used;
+        memcpy(batch->buffer + offset, data, dlen);
+        batch->used += dlen;
+        batch->lastCall = g_sendCall;
+        batch->lastOffset = offset;
+    }
+
+    CASendEntry_t *entry = &batch->entries[batch->count++];
+    entry->endpoint = *endpoint;
+    entry->addr.ss_family = 0;
+    entry->addrlen = CAGetSendAddress(endpoint, &entry->addr);
+    entry->ifindex = ifindex;
+    entry->offset = offset;
+    entry->len = dlen;
+    entry->cast = cast;
+    entry->fam = fam;
+    return true;
+}
+
+static void CAIPFreeSendBatches(void)
+{
+    if (g_sendBatches)
+    {
+        for (size_t i = 0; i < SEND_BATCH_SOCKETS; i++)
+        {
+            OICFree(g_sendBatches[i].buffer);
+        }
+        OICFree(g_sendBatches);
+        g_sendBatches = NULL;
+    }
+}
+#endif // HAVE_SENDMMSG
+
 static void sendMulticastData6(const u_arraylist_t *iflist,
                                CAEndpoint_t *endpoint,
-                               const void *data, size_t datalen)
+                               const void *data, size_t datalen,
+                               bool batched)
 {
     if (!endpoint)
     {
@@ -1492,6 +2074,10 @@ static void sendMulticastData6(const u_arraylist_t *iflist,
         return;
     }
 
+#ifndef HAVE_SENDMMSG
+    (void)batched;
+#endif
+
     int scope = endpoint->flags & CA_SCOPE_MASK;
     char *ipv6mcname = ipv6mcnames[scope];
     if (!ipv6mcname)
@@ -1520,6 +2106,12 @@ static void sendMulticastData6(const u_arraylist_t *iflist,
         }
 
         int index = ifitem->index;
+#ifdef HAVE_SENDMMSG
+        if (batched && queueData(fd, endpoint, index, data, datalen, "multicast", "ipv6"))
+        {
+            continue;
+        }
+#endif
         if (setsockopt(fd, IPPROTO_IPV6, IPV6_MULTICAST_IF, OPTVAL_T(&index), sizeof (index)))
         {
             OIC_LOG_V(ERROR, TAG, "setsockopt6 failed: %s", CAIPS_GET_ERROR);
@@ -1531,9 +2123,13 @@ static void sendMulticastData6(const u_arraylist_t *iflist,
 
 static void sendMulticastData4(const u_arraylist_t *iflist,
                                CAEndpoint_t *endpoint,
-                               const void *data, size_t datalen)
+                               const void *data, size_t datalen,
+                               bool batched)
 {
     VERIFY_NON_NULL_VOID(endpoint, TAG, "endpoint is NULL");
+#ifndef HAVE_SENDMMSG
+    (void)batched;
+#endif
 
 #if defined(USE_IP_MREQN)
     struct ip_mreqn mreq = { .imr_multiaddr = IPv4MulticastAddress,
@@ -1563,6 +2159,12 @@ static void sendMulticastData4(const u_arraylist_t *iflist,
         {
             continue;
         }
+#ifdef HAVE_SENDMMSG
+        if (batched && queueData(fd, endpoint, ifitem->index, data, datalen, "multicast", "ipv4"))
+        {
+            continue;
+        }
+#endif
 #if defined(USE_IP_MREQN)
         mreq.imr_ifindex = ifitem->index;
 #else
@@ -1577,9 +2179,13 @@ static void sendMulticastData4(const u_arraylist_t *iflist,
     }
 }
 
-void CAIPSendData(CAEndpoint_t *endpoint, const void *data, size_t datalen,
-                  bool isMulticast)
+static void CAIPSendDataInternal(CAEndpoint_t *endpoint, const void *data, size_t datalen,
+                                 bool isMulticast, bool batched)
 {
+#ifndef HAVE_SENDMMSG
+    (void)batched;
+#endif
+
     VERIFY_NON_NULL_VOID(endpoint, TAG, "endpoint is NULL");
     VERIFY_NON_NULL_VOID(data, TAG, "data is NULL");
 
@@ -1598,11 +2204,11 @@ void CAIPSendData(CAEndpoint_t *endpoint, const void *data, size_t datalen,
 
         if ((endpoint->flags & CA_IPV6) && caglobals.ip.ipv6enabled)
         {
-            sendMulticastData6(iflist, endpoint, data, datalen);
+            sendMulticastData6(iflist, endpoint, data, datalen, batched);
         }
         if ((endpoint->flags & CA_IPV4) && caglobals.ip.ipv4enabled)
         {
-            sendMulticastData4(iflist, endpoint, data, datalen);
+            sendMulticastData4(iflist, endpoint, data, datalen, batched);
         }
 
         u_arraylist_destroy(iflist);
@@ -1621,7 +2227,12 @@ void CAIPSendData(CAEndpoint_t *endpoint, const void *data, size_t datalen,
 #ifndef __WITH_DTLS__
             fd = caglobals.ip.u6.fd;
 #endif
-            sendData(fd, endpoint, data, datalen, "unicast", "ipv6");
+#ifdef HAVE_SENDMMSG
+            if (!batched || !queueData(fd, endpoint, 0, data, datalen, "unicast", "ipv6"))
+#endif
+            {
+                sendData(fd, endpoint, data, datalen, "unicast", "ipv6");
+            }
         }
         if (caglobals.ip.ipv4enabled && (endpoint->flags & CA_IPV4))
         {
@@ -1629,9 +2240,61 @@ void CAIPSendData(CAEndpoint_t *endpoint, const void *data, size_t datalen,
 #ifndef __WITH_DTLS__
             fd = caglobals.ip.u4.fd;
 #endif
-            sendData(fd, endpoint, data, datalen, "unicast", "ipv4");
+#ifdef HAVE_SENDMMSG
+            if (!batched || !queueData(fd, endpoint, 0, data, datalen, "unicast", "ipv4"))
+#endif
+            {
+                sendData(fd, endpoint, data, datalen, "unicast", "ipv4");
+            }
+        }
+    }
+}
+
+void CAIPSendData(CAEndpoint_t *endpoint, const void *data, size_t datalen,
+                  bool isMulticast)
+{
+    CAIPSendDataInternal(endpoint, data, datalen, isMulticast, false);
+}
+
+void CAIPSendDataBatched(CAEndpoint_t *endpoint, const void *data, size_t datalen,
+                         bool isMulticast)
+{
+#ifdef HAVE_SENDMMSG
+    if (0 == ++g_sendCall)
+    {
+        g_sendCall = 1;
+    }
+    CAIPSendDataInternal(endpoint, data, datalen, isMulticast, true);
+#else
+    CAIPSendData(endpoint, data, datalen, isMulticast);
+#endif
+}
+
+void CAIPFlushSendData(void)
+{
+#ifdef HAVE_SENDMMSG
+    if (g_sendBatches)
+    {
+        for (size_t i = 0; i < SEND_BATCH_SOCKETS; i++)
+        {
+            if (g_sendBatches[i].count)
+            {
+                CAFlushSendBatch(&g_sendBatches[i]);
+            }
         }
     }
+#endif
+}
+
+void CAIPGetSendBatchStatistics(size_t *datagrams, size_t *calls)
+{
+#ifdef HAVE_SENDMMSG
+    *datagrams = g_batchedDatagrams;
+    *calls = g_batchedCalls;
+#else
+    *datagrams = 0;
+    *calls = 0;
+#endif
 }
 
 CAResult_t CAGetIPInterfaceInformation(CAEndpoint_t **info, size_t *size)
@@ -56,6 +56,9 @@
 #ifdef HAVE_NETDB_H
 #include <netdb.h>
 #endif
+#ifdef WITH_EPOLL
+#include <sys/epoll.h>
+#endif
 
 #include "catcpinterface.h"
 #include "caipnwmonitor.h"
@@ -90,6 +93,23 @@
  */
 #define TLS_HEADER_SIZE 5
 
+/**
+ * Initial number of buckets of the session tables, must be a power of 2.
+ */
+#define SESSION_TABLE_INITIAL_SIZE 16
+
+/**
+ * Maximum length of the data queued for a session whose socket is not writable.
+ */
+#define SESSION_SEND_BUFFER_MAX (1024 * 1024)
+
+#ifdef WITH_EPOLL
+/**
+ * Number of events returned by a single epoll_wait() call.
+ */
+#define EPOLL_EVENT_COUNT 64
+#endif
+
 /**
  * Mutex to synchronize device object list.
  */
@@ -120,6 +140,21 @@ static CATCPConnectionHandleCallback g_connectionCallback = NULL;
  */
 static u_arraylist_t *s_sessionList = NULL;
 
+/**
+ * Sessions of s_sessionList hashed by remote address and port, and by socket.
+ * Each table has s_tableSize buckets, which is 0 or a power of 2.
+ */
+static CATCPSessionInfo_t **s_addrTable = NULL;
+static CATCPSessionInfo_t **s_fdTable = NULL;
+static size_t s_tableSize = 0;
+
+#ifdef WITH_EPOLL
+/**
+ * Wait set of the receive thread, -1 when select() is used instead.
+ */
+static int g_epollFd = -1;
+#endif
+
 static CAResult_t CATCPCreateMutex(void);
 static void CATCPDestroyMutex(void);
 static CAResult_t CATCPCreateCond(void);
@@ -134,7 +169,15 @@ static void CASocketEventReturned(u_arraylist_t* sessionList, CASocketFd_t socke
 #endif
 static CAResult_t CAReceiveMessage(CATCPSessionInfo_t *svritem);
 static void CAReceiveHandler(void *data);
+#ifdef WITH_EPOLL
+static void CAWaitForEpollEvents(void);
+#endif
 static CAResult_t CATCPCreateSocket(int family, CATCPSessionInfo_t *svritem);
+#ifdef WITH_EPOLL
+static void CAWatchSession(CATCPSessionInfo_t *session);
+static void CAUnwatchSession(CATCPSessionInfo_t *session);
+static void CAUpdateSessionEvents(CATCPSessionInfo_t *session, uint32_t events);
+#endif
 
 #if defined(WSA_WAIT_EVENT_0)
 #define CHECKFD(FD)
@@ -221,21 +264,221 @@ static CATCPSessionInfo_t* session_list_get(u_arraylist_t* sessionList, size_t i
     return (CATCPSessionInfo_t*) oc_refcounter_get_data(ref);
 }
 
-static void CARemoveSession(CATCPSessionInfo_t *session)
+static size_t CAGetAddrBucket(const char *addr, uint16_t port)
 {
-    oc_refcounter ref = NULL;
-    oc_mutex_lock(g_mutexObjectList);
-    size_t length = u_arraylist_length(s_sessionList);
-    for (size_t i = 0; i < length; ++i)
-    {
-        oc_refcounter tmp = (oc_refcounter) u_arraylist_get(s_sessionList, i);
-        if (oc_refcounter_get_data(tmp) == session) {
-            //swap last element with current position and remove last element
-            u_arraylist_swap(s_sessionList, i, length-1);
-            ref = (oc_refcounter) u_arraylist_remove(s_sessionList, length-1);
-            break;
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < MAX_ADDR_STR_SIZE_CA && addr[i]; i++)
+    {
+        hash = (hash ^ (uint8_t)addr[i]) * 16777619u;
+    }
+    hash = (hash ^ port) * 16777619u;
+    return hash & (s_tableSize - 1);
+}
+
+static size_t CAGetFdBucket(CASocketFd_t fd)
+{
+    return (size_t)fd & (s_tableSize - 1);
+}
+
+static bool CAIsSessionOfEndpoint(const CATCPSessionInfo_t *session,
+                                  const CAEndpoint_t *endpoint)
+{
+    return !strncmp(session->sep.endpoint.addr, endpoint->addr,
+                    sizeof(session->sep.endpoint.addr))
+           && (session->sep.endpoint.port == endpoint->port)
+           && (session->sep.endpoint.flags & endpoint->flags);
+}
+
+/*
+ * The session index functions below must be called with g_mutexObjectList held.
+ */
+
+static bool CAResizeSessionTables(size_t size)
+{
+    CATCPSessionInfo_t **addrTable =
+        (CATCPSessionInfo_t **) OICCalloc(size, sizeof (*addrTable));
+    CATCPSessionInfo_t **fdTable =
+        (CATCPSessionInfo_t **) OICCalloc(size, sizeof (*fdTable));
+    if (!addrTable || !fdTable)
+    {
+        OIC_LOG(ERROR, TAG, "Out of memory");
+        OICFree(addrTable);
+        OICFree(fdTable);
+        return false;
+    }
+
+    CATCPSessionInfo_t **oldAddrTable = s_addrTable;
+    CATCPSessionInfo_t **oldFdTable = s_fdTable;
+    size_t oldSize = s_tableSize;
+    s_addrTable = addrTable;
+    s_fdTable = fdTable;
+    s_tableSize = size;
+
+    for (size_t i = 0; i < oldSize; i++)
+    {
+        CATCPSessionInfo_t *session = oldAddrTable[i];
+        while (session)
+        {
+            CATCPSessionInfo_t *next = session->addrNext;
+            size_t bucket = CAGetAddrBucket(session->sep.endpoint.addr,
+                                            session->sep.endpoint.port);
+            session->addrNext = s_addrTable[bucket];
+            s_addrTable[bucket] = session;
+            session = next;
+        }
+
+        session = oldFdTable[i];
+        while (session)
+        {
+            CATCPSessionInfo_t *next = session->fdNext;
+            size_t bucket = CAGetFdBucket(session->fd);
+            session->fdNext = s_fdTable[bucket];
+            s_fdTable[bucket] = session;
+            session = next;
+        }
+    }
+
+    OICFree(oldAddrTable);
+    OICFree(oldFdTable);
+    return true;
+}
+
+static void CAIndexSessionFd(CATCPSessionInfo_t *session)
+{
+    size_t bucket = CAGetFdBucket(session->fd);
+    session->fdNext = s_fdTable[bucket];
+    s_fdTable[bucket] = session;
+#ifdef WITH_EPOLL
+    CAWatchSession(session);
+#endif
+}
+
+/**
+ * Add a session to the list and to the indexes. Its socket is indexed as well when it
+ * is already connected.
+ *
+ * @param[in] ref    refcounter of the session, owned by the list on success.
+ * @return true on success, false if out of memory or the server is stopped.
+ */
+static bool CAAddSession(oc_refcounter ref)
+{
+    CATCPSessionInfo_t *session = (CATCPSessionInfo_t *) oc_refcounter_get_data(ref);
+    size_t count = u_arraylist_length(s_sessionList);
+    if (count >= s_tableSize &&
+        !CAResizeSessionTables(s_tableSize ? 2 * s_tableSize : SESSION_TABLE_INITIAL_SIZE))
+    {
+        return false;
+    }
+    if (!u_arraylist_add(s_sessionList, ref))
+    {
+        return false;
+    }
+    session->listIndex = count;
+
+    size_t bucket = CAGetAddrBucket(session->sep.endpoint.addr, session->sep.endpoint.port);
+    session->addrNext = s_addrTable[bucket];
+    s_addrTable[bucket] = session;
+
+    if (OC_INVALID_SOCKET != session->fd)
+    {
+        CAIndexSessionFd(session);
+    }
+    return true;
+}
+
+static bool CAIsSessionListed(const CATCPSessionInfo_t *session)
+{
+    return session->listIndex < u_arraylist_length(s_sessionList)
+           && session == session_list_get(s_sessionList, session->listIndex);
+}
+
+/**
+ * Remove a session from the list and from the indexes.
+ *
+ * @return refcounter of the session, NULL if it was not listed.
+ */
+static oc_refcounter CAUnlinkSession(CATCPSessionInfo_t *session)
+{
+    if (!CAIsSessionListed(session))
+    {
+        return NULL;
+    }
+
+    CATCPSessionInfo_t **link = &s_addrTable[CAGetAddrBucket(session->sep.endpoint.addr,
+                                                             session->sep.endpoint.port)];
+    while (*link && *link != session)
+    {
+        link = &(*link)->addrNext;
+    }
+    if (*link)
+    {
+        *link = session->addrNext;
+    }
+
+    if (OC_INVALID_SOCKET != session->fd)
+    {
+        link = &s_fdTable[CAGetFdBucket(session->fd)];
+        while (*link && *link != session)
+        {
+            link = &(*link)->fdNext;
         }
+        if (*link)
+        {
+            *link = session->fdNext;
+#ifdef WITH_EPOLL
+            CAUnwatchSession(session);
+#endif
+        }
+    }
+
+    //swap last element with current position and remove last element
+    size_t last = u_arraylist_length(s_sessionList) - 1;
+    u_arraylist_swap(s_sessionList, session->listIndex, last);
+    oc_refcounter ref = (oc_refcounter) u_arraylist_remove(s_sessionList, last);
+    if (session->listIndex != last)
+    {
+        session_list_get(s_sessionList, session->listIndex)->listIndex = session->listIndex;
     }
+    return ref;
+}
+
+static CATCPSessionInfo_t *CAFindSessionByEndpoint(const CAEndpoint_t *endpoint)
+{
+    if (!s_tableSize)
+    {
+        return NULL;
+    }
+
+    CATCPSessionInfo_t *session = s_addrTable[CAGetAddrBucket(endpoint->addr, endpoint->port)];
+    while (session && !CAIsSessionOfEndpoint(session, endpoint))
+    {
+        session = session->addrNext;
+    }
+    return session;
+}
+
+#ifdef WITH_EPOLL
+static CATCPSessionInfo_t *CAFindSessionByFd(CASocketFd_t fd)
+{
+    if (!s_tableSize)
+    {
+        return NULL;
+    }
+
+    CATCPSessionInfo_t *session = s_fdTable[CAGetFdBucket(fd)];
+    while (session && session->fd != fd)
+    {
+        session = session->fdNext;
+    }
+    return session;
+}
+#endif
+
+static void CARemoveSession(CATCPSessionInfo_t *session)
+{
+    oc_mutex_lock(g_mutexObjectList);
+    oc_refcounter ref = CAUnlinkSession(session);
     oc_mutex_unlock(g_mutexObjectList);
     if (ref)
     {
@@ -248,6 +491,13 @@ static void CAReceiveHandler(void *data)
     (void)data;
     OIC_LOG(DEBUG, TAG, "IN - CAReceiveHandler");
 
+#ifdef WITH_EPOLL
+    while (-1 != g_epollFd && !caglobals.tcp.terminate)
+    {
+        CAWaitForEpollEvents();
+    }
+#endif
+
     u_arraylist_t* sessionList = u_arraylist_create();
     while (sessionList && !caglobals.tcp.terminate)
     {
@@ -607,6 +857,328 @@ static void CASocketEventReturned(u_arraylist_t* sessionList, CASocketFd_t s, lo
 
 #endif // WSA_WAIT_EVENT_0
 
+#ifdef WITH_EPOLL
+
+static bool CAEpollAdd(int fd)
+{
+    struct epoll_event event = { .events = EPOLLIN, .data.fd = fd };
+    if (-1 == epoll_ctl(g_epollFd, EPOLL_CTL_ADD, fd, &event))
+    {
+        OIC_LOG_V(ERROR, TAG, "epoll_ctl(%d) failed: %s", fd, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+static void CATCPCreateEpoll(void)
+{
+    g_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (-1 == g_epollFd)
+    {
+        OIC_LOG_V(ERROR, TAG, "epoll_create1 failed: %s, using select", strerror(errno));
+        return;
+    }
+
+    int fds[] = { caglobals.tcp.ipv4.fd, caglobals.tcp.ipv4s.fd,
+                  caglobals.tcp.ipv6.fd, caglobals.tcp.ipv6s.fd,
+                  caglobals.tcp.shutdownFds[0], caglobals.tcp.connectionFds[0] };
+    for (size_t i = 0; i < sizeof (fds) / sizeof (fds[0]); i++)
+    {
+        if (OC_INVALID_SOCKET != fds[i] && !CAEpollAdd(fds[i]))
+        {
+            OIC_LOG(ERROR, TAG, "epoll setup failed, using select");
+            close(g_epollFd);
+            g_epollFd = -1;
+            return;
+        }
+    }
+}
+
+/**
+ * Make the socket of a connected session non-blocking and add it to the wait set.
+ * Called with g_mutexObjectList held.
+ */
+static void CAWatchSession(CATCPSessionInfo_t *session)
+{
+    if (-1 == g_epollFd)
+    {
+        return;
+    }
+
+    int flags = fcntl(session->fd, F_GETFL);
+    if (-1 == flags || -1 == fcntl(session->fd, F_SETFL, flags | O_NONBLOCK))
+    {
+        OIC_LOG_V(ERROR, TAG, "set O_NONBLOCK failed: %s", strerror(errno));
+    }
+    (void)CAEpollAdd(session->fd);
+}
+
+static void CAUnwatchSession(CATCPSessionInfo_t *session)
+{
+    if (-1 != g_epollFd)
+    {
+        (void)epoll_ctl(g_epollFd, EPOLL_CTL_DEL, session->fd, NULL);
+    }
+}
+
+static void CAUpdateSessionEvents(CATCPSessionInfo_t *session, uint32_t events)
+{
+    struct epoll_event event = { .events = events, .data.fd = session->fd };
+    // ENOENT: the session was removed from the wait set while it was being written.
+    if (-1 == epoll_ctl(g_epollFd, EPOLL_CTL_MOD, session->fd, &event) && ENOENT != errno)
+    {
+        OIC_LOG_V(ERROR, TAG, "epoll_ctl(%d) failed: %s", session->fd, strerror(errno));
+    }
+}
+
+/**
+ * Queue data which the session socket could not take. The receive thread sends it
+ * when the socket becomes writable. Called with the sendMutex of the session held.
+ */
+static bool CAAppendSendBuffer(CATCPSessionInfo_t *session, const char *data, size_t dlen)
+{
+    size_t pending = session->sendLen - session->sendOffset;
+    if (pending + dlen > SESSION_SEND_BUFFER_MAX)
+    {
+        OIC_LOG_V(ERROR, TAG, "send buffer of [%s:%u] is full",
+                  session->sep.endpoint.addr, session->sep.endpoint.port);
+        return false;
+    }
+
+    if (session->sendOffset)
+    {
+        memmove(session->sendBuffer, session->sendBuffer + session->sendOffset, pending);
+        session->sendOffset = 0;
+        session->sendLen = pending;
+    }
+
+    if (pending + dlen > session->sendCapacity)
+    {
+        size_t capacity = session->sendCapacity ? 2 * session->sendCapacity : dlen;
+        if (capacity < pending + dlen)
+        {
+            capacity = pending + dlen;
+        }
+        unsigned char *buffer = (unsigned char *) OICRealloc(session->sendBuffer, capacity);
+        if (!buffer)
+        {
+            OIC_LOG(ERROR, TAG, "OICRealloc - out of memory");
+            return false;
+        }
+        session->sendBuffer = buffer;
+        session->sendCapacity = capacity;
+    }
+
+    memcpy(session->sendBuffer + session->sendLen, data, dlen);
+    session->sendLen += dlen;
+
+    if (!pending)
+    {
+        CAUpdateSessionEvents(session, EPOLLIN | EPOLLOUT);
+    }
+    return true;
+}
+
+/**
+ * Write as much of the data as the non-blocking socket takes.
+ *
+ * @param[in,out] data    data to send, advanced past the bytes sent.
+ * @param[in,out] dlen    length of the data, reduced by the bytes sent.
+ * @return ::CA_STATUS_OK if the data was sent or the socket would block,
+ *         ::CA_SEND_FAILED upon failure.
+ */
+static CAResult_t CASendNonBlocking(CASocketFd_t fd, const char **data, size_t *dlen)
+{
+    while (*dlen > 0)
+    {
+        ssize_t len = send(fd, *data, *dlen, 0);
+        if (-1 == len)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            if (EAGAIN != errno && EWOULDBLOCK != errno)
+            {
+                OIC_LOG_V(ERROR, TAG, "send failed: %s", strerror(errno));
+                return CA_SEND_FAILED;
+            }
+            break;
+        }
+        *data += len;
+        *dlen -= len;
+    }
+    return CA_STATUS_OK;
+}
+
+/**
+ * Send on a non-blocking session socket, queueing what the socket does not take.
+ * g_mutexObjectList is only held to look the session up, the socket is written under
+ * the sendMutex of the session so that sends on different sessions run in parallel.
+ *
+ * @return ::CA_STATUS_OK if the data was sent or queued, some other value upon failure.
+ */
+static CAResult_t CAQueueSendData(const CAEndpoint_t *endpoint, const void *data, size_t dlen)
+{
+    oc_refcounter ref = NULL;
+    oc_mutex_lock(g_mutexObjectList);
+    CATCPSessionInfo_t *session = CAFindSessionByEndpoint(endpoint);
+    if (session && OC_INVALID_SOCKET != session->fd)
+    {
+        ref = oc_refcounter_inc((oc_refcounter) u_arraylist_get(s_sessionList,
+                                                                session->listIndex));
+    }
+    oc_mutex_unlock(g_mutexObjectList);
+
+    if (!ref)
+    {
+        OIC_LOG(ERROR, TAG, "Session not found");
+        return CA_SEND_FAILED;
+    }
+
+    const char *remaining = (const char *) data;
+    size_t remainLen = dlen;
+    CAResult_t res = CA_STATUS_OK;
+
+    oc_mutex_lock(session->sendMutex);
+    // Keep the order of the data, only write directly when nothing is queued.
+    if (session->sendOffset == session->sendLen)
+    {
+        res = CASendNonBlocking(session->fd, &remaining, &remainLen);
+    }
+    if (CA_STATUS_OK == res && remainLen > 0 &&
+        !CAAppendSendBuffer(session, remaining, remainLen))
+    {
+        res = CA_SEND_FAILED;
+    }
+    oc_mutex_unlock(session->sendMutex);
+
+    // The reference keeps the socket open while it is written.
+    oc_refcounter_dec(ref);
+    return res;
+}
+
+/**
+ * Send the queued data of a session. The caller holds a reference to the session.
+ */
+static CAResult_t CAFlushSendBuffer(CATCPSessionInfo_t *session)
+{
+    oc_mutex_lock(session->sendMutex);
+    const char *remaining = (const char *) session->sendBuffer + session->sendOffset;
+    size_t remainLen = session->sendLen - session->sendOffset;
+    CAResult_t res = CASendNonBlocking(session->fd, &remaining, &remainLen);
+    session->sendOffset = session->sendLen - remainLen;
+
+    if (CA_STATUS_OK == res && !remainLen)
+    {
+        session->sendOffset = 0;
+        session->sendLen = 0;
+        CAUpdateSessionEvents(session, EPOLLIN);
+    }
+    oc_mutex_unlock(session->sendMutex);
+
+    return res;
+}
+
+static void CAHandleSessionEvent(CASocketFd_t fd, uint32_t events)
+{
+    oc_refcounter ref = NULL;
+    oc_mutex_lock(g_mutexObjectList);
+    CATCPSessionInfo_t *session = CAFindSessionByFd(fd);
+    if (session)
+    {
+        ref = oc_refcounter_inc((oc_refcounter) u_arraylist_get(s_sessionList,
+                                                                session->listIndex));
+    }
+    oc_mutex_unlock(g_mutexObjectList);
+
+    if (!ref)
+    {
+        return;
+    }
+
+    CAResult_t res = CA_STATUS_OK;
+    if (events & EPOLLOUT)
+    {
+        res = CAFlushSendBuffer(session);
+    }
+    if (CA_STATUS_OK == res && (events & (EPOLLIN | EPOLLHUP | EPOLLERR)))
+    {
+        res = CAReceiveMessage(session);
+    }
+
+    //disconnect session and clean-up data if any error occurs
+    if (CA_STATUS_OK != res)
+    {
+#ifdef __WITH_TLS__
+        if (CA_STATUS_OK != CAcloseSslConnection(&session->sep.endpoint))
+        {
+            OIC_LOG(ERROR, TAG, "Failed to close TLS session");
+        }
+#endif
+        CARemoveSession(session);
+    }
+    oc_refcounter_dec(ref);
+}
+
+static void CAWaitForEpollEvents(void)
+{
+    struct epoll_event events[EPOLL_EVENT_COUNT];
+    int timeout = (0 > caglobals.tcp.selectTimeout) ? -1 : caglobals.tcp.selectTimeout * 1000;
+
+    int ret = epoll_wait(g_epollFd, events, EPOLL_EVENT_COUNT, timeout);
+
+    if (caglobals.tcp.terminate)
+    {
+        OIC_LOG_V(DEBUG, TAG, "Packet receiver Stop request received.");
+        return;
+    }
+
+    if (-1 == ret)
+    {
+        if (EINTR != errno)
+        {
+            OIC_LOG_V(FATAL, TAG, "epoll_wait error %s", strerror(errno));
+        }
+        return;
+    }
+
+    for (int i = 0; i < ret && !caglobals.tcp.terminate; i++)
+    {
+        CASocketFd_t fd = events[i].data.fd;
+
+        if (fd == caglobals.tcp.ipv4.fd)
+        {
+            CAAcceptConnection(CA_IPV4, &caglobals.tcp.ipv4);
+        }
+        else if (fd == caglobals.tcp.ipv4s.fd)
+        {
+            CAAcceptConnection(CA_IPV4 | CA_SECURE, &caglobals.tcp.ipv4s);
+        }
+        else if (fd == caglobals.tcp.ipv6.fd)
+        {
+            CAAcceptConnection(CA_IPV6, &caglobals.tcp.ipv6);
+        }
+        else if (fd == caglobals.tcp.ipv6s.fd)
+        {
+            CAAcceptConnection(CA_IPV6 | CA_SECURE, &caglobals.tcp.ipv6s);
+        }
+        else if (fd == caglobals.tcp.shutdownFds[0] || fd == caglobals.tcp.connectionFds[0])
+        {
+            // Connected sessions are added to the wait set directly, so the
+            // connection event is only drained.
+            char buf[MAX_ADDR_STR_SIZE_CA] = {0};
+            (void)read(fd, buf, sizeof (buf));
+        }
+        else
+        {
+            CAHandleSessionEvent(fd, events[i].events);
+        }
+    }
+}
+
+#endif // WITH_EPOLL
+
 static void CADtorTCPSession(CATCPSessionInfo_t *removedData)
 {
     OIC_LOG_V(DEBUG, TAG, "%s", __func__);
@@ -632,6 +1204,8 @@ static void CADtorTCPSession(CATCPSessionInfo_t *removedData)
         }
     }
     OICFree(removedData->data);
+    OICFree(removedData->sendBuffer);
+    oc_mutex_free(removedData->sendMutex);
     OICFree(removedData);
 
     OIC_LOG(DEBUG, TAG, "data is removed");
@@ -661,6 +1235,14 @@ static void CAAcceptConnection(CATransportFlags_t flag, CASocket_t *sock)
         }
 
         OICClearMemory(svritem, 0);
+        svritem->sendMutex = oc_mutex_new();
+        if (!svritem->sendMutex)
+        {
+            OICFree(svritem);
+            OIC_LOG(ERROR, TAG, "Failed to create mutex");
+            OC_CLOSE_SOCKET(sockfd);
+            return;
+        }
         svritem->fd = sockfd;
         svritem->sep.endpoint.flags = flag;
         svritem->sep.endpoint.adapter = CA_ADAPTER_TCP;
@@ -672,6 +1254,7 @@ static void CAAcceptConnection(CATransportFlags_t flag, CASocket_t *sock)
         oc_refcounter ref = oc_refcounter_create(svritem, (oc_refcounter_dtor_data_func) CADtorTCPSession);
         if (!ref)
         {
+            oc_mutex_free(svritem->sendMutex);
             OICFree(svritem);
             OIC_LOG(ERROR, TAG, "Out of memory");
             OC_CLOSE_SOCKET(sockfd);
@@ -679,8 +1262,16 @@ static void CAAcceptConnection(CATransportFlags_t flag, CASocket_t *sock)
         }
 
         oc_mutex_lock(g_mutexObjectList);
-        u_arraylist_add(s_sessionList, ref);
+        bool added = CAAddSession(ref);
         oc_mutex_unlock(g_mutexObjectList);
+        if (!added)
+        {
+            OIC_LOG(ERROR, TAG, "Failed to add session");
+            OC_CLOSE_SOCKET(sockfd);
+            svritem->fd = OC_INVALID_SOCKET;
+            oc_refcounter_dec(ref);
+            return;
+        }
 
         CHECKFD(sockfd);
 
@@ -866,7 +1457,11 @@ static CAResult_t CAReceiveMessage(CATCPSessionInfo_t *svritem)
         }
 
         len = recv(svritem->fd, (char*)svritem->tlsdata + svritem->tlsLen, (int)nbRead, 0);
-        if (len < 0)
+        if (len < 0 && (EAGAIN == errno || EWOULDBLOCK == errno))
+        {
+            // Non-blocking session socket, nothing to read yet.
+        }
+        else if (len < 0)
         {
             OIC_LOG_V(ERROR, TAG, "recv failed %s", strerror(errno));
             res = CA_RECEIVE_FAILED;
@@ -898,7 +1493,11 @@ static CAResult_t CAReceiveMessage(CATCPSessionInfo_t *svritem)
 
         // svritem->tlsdata can also be used as receiving buffer in case of raw tcp
         len = recv(svritem->fd, (char*)svritem->tlsdata, sizeof(svritem->tlsdata), 0);
-        if (len < 0)
+        if (len < 0 && (EAGAIN == errno || EWOULDBLOCK == errno))
+        {
+            // Non-blocking session socket, nothing to read yet.
+        }
+        else if (len < 0)
         {
             OIC_LOG_V(ERROR, TAG, "recv failed %s", strerror(errno));
             res = CA_RECEIVE_FAILED;
@@ -1001,7 +1600,13 @@ static CAResult_t CATCPCreateSocket(int family, CATCPSessionInfo_t *svritem)
     }
 
     OIC_LOG(DEBUG, TAG, "connect socket success");
+    oc_mutex_lock(g_mutexObjectList);
     svritem->state = CONNECTED;
+    if (CAIsSessionListed(svritem))
+    {
+        CAIndexSessionFd(svritem);
+    }
+    oc_mutex_unlock(g_mutexObjectList);
     CHECKFD(svritem->fd);
 #if !defined(WSA_WAIT_EVENT_0)
     ssize_t len = CAWakeUpForReadFdsUpdate(svritem->sep.endpoint.addr);
@@ -1214,6 +1819,10 @@ CAResult_t CATCPStartServer(const ca_thread_pool_t threadPool)
     CHECKFD(caglobals.tcp.connectionFds[1]);
 #endif
 
+#ifdef WITH_EPOLL
+    CATCPCreateEpoll();
+#endif
+
     caglobals.tcp.terminate = false;
     res = ca_thread_pool_add_task(threadPool, CAReceiveHandler, NULL);
     if (CA_STATUS_OK != res)
@@ -1282,6 +1891,14 @@ void CATCPStopServer(void)
     caglobals.tcp.shutdownFds[0] = OC_INVALID_SOCKET;
 #endif
 
+#ifdef WITH_EPOLL
+    if (-1 != g_epollFd)
+    {
+        close(g_epollFd);
+        g_epollFd = -1;
+    }
+#endif
+
     // mutex unlock
     oc_mutex_unlock(g_mutexObjectList);
 
@@ -1362,25 +1979,40 @@ static ssize_t sendData(const CAEndpoint_t *endpoint, const void *data,
     }
 
     // #2. send data to remote device.
-    ssize_t remainLen = dlen;
-    do
+#ifdef WITH_EPOLL
+    if (-1 != g_epollFd)
     {
-        int dataToSend = (remainLen > INT_MAX) ? INT_MAX : (int)remainLen;
-        ssize_t len = send(sockFd, data, dataToSend, 0);
-        if (-1 == len)
+        if (CA_STATUS_OK != CAQueueSendData(endpoint, data, dlen))
         {
-            if (EWOULDBLOCK != errno)
+            OIC_LOG_V(ERROR, TAG, "unicast %stcp sendTo failed", fam);
+            CALogSendStateInfo(endpoint->adapter, endpoint->addr, endpoint->port,
+                               -1, false, "send failed");
+            return -1;
+        }
+    }
+    else
+#endif
+    {
+        ssize_t remainLen = dlen;
+        do
+        {
+            int dataToSend = (remainLen > INT_MAX) ? INT_MAX : (int)remainLen;
+            ssize_t len = send(sockFd, data, dataToSend, 0);
+            if (-1 == len)
             {
-                OIC_LOG_V(ERROR, TAG, "unicast ipv4tcp sendTo failed: %s", strerror(errno));
-                CALogSendStateInfo(endpoint->adapter, endpoint->addr, endpoint->port,
-                                   len, false, strerror(errno));
-                return len;
+                if (EWOULDBLOCK != errno)
+                {
+                    OIC_LOG_V(ERROR, TAG, "unicast ipv4tcp sendTo failed: %s", strerror(errno));
+                    CALogSendStateInfo(endpoint->adapter, endpoint->addr, endpoint->port,
+                                       len, false, strerror(errno));
+                    return len;
+                }
+                continue;
             }
-            continue;
-        }
-        data = ((char*)data) + len;
-        remainLen -= len;
-    } while (remainLen > 0);
+            data = ((char*)data) + len;
+            remainLen -= len;
+        } while (remainLen > 0);
+    }
 
 #ifndef TB_LOG
     (void)fam;
@@ -1533,13 +2165,22 @@ CASocketFd_t CAConnectTCPSession(const CAEndpoint_t *endpoint)
         OIC_LOG(ERROR, TAG, "Out of memory");
         return OC_INVALID_SOCKET;
     }
+    svritem->sendMutex = oc_mutex_new();
+    if (!svritem->sendMutex)
+    {
+        OICFree(svritem);
+        OIC_LOG(ERROR, TAG, "Failed to create mutex");
+        return OC_INVALID_SOCKET;
+    }
     svritem->sep.endpoint = *endpoint;
+    svritem->fd = OC_INVALID_SOCKET;    // indexed once connected
     svritem->state = CONNECTING;
     svritem->isClient = true;
 
     oc_refcounter ref = oc_refcounter_create(svritem, (oc_refcounter_dtor_data_func) CADtorTCPSession);
     if (!ref)
     {
+        oc_mutex_free(svritem->sendMutex);
         OICFree(svritem);
         OIC_LOG(ERROR, TAG, "Out of memory");
         return OC_INVALID_SOCKET;
@@ -1547,8 +2188,14 @@ CASocketFd_t CAConnectTCPSession(const CAEndpoint_t *endpoint)
 
     // #2. add TCP connection info to list
     oc_mutex_lock(g_mutexObjectList);
-    u_arraylist_add(s_sessionList, ref);
+    bool added = CAAddSession(ref);
     oc_mutex_unlock(g_mutexObjectList);
+    if (!added)
+    {
+        OIC_LOG(ERROR, TAG, "Failed to add session");
+        oc_refcounter_dec(ref);
+        return OC_INVALID_SOCKET;
+    }
 
     // #3. create the socket and connect to TCP server
     int family = (svritem->sep.endpoint.flags & CA_IPV6) ? AF_INET6 : AF_INET;
@@ -1577,6 +2224,20 @@ void CATCPDisconnectAll(void)
     oc_mutex_lock(g_mutexObjectList);
     u_arraylist_t* sessionList = s_sessionList;
     s_sessionList = NULL;
+#ifdef WITH_EPOLL
+    for (size_t i = 0; i < s_tableSize; ++i)
+    {
+        for (CATCPSessionInfo_t *session = s_fdTable[i]; session; session = session->fdNext)
+        {
+            CAUnwatchSession(session);
+        }
+    }
+#endif
+    OICFree(s_addrTable);
+    OICFree(s_fdTable);
+    s_addrTable = NULL;
+    s_fdTable = NULL;
+    s_tableSize = 0;
     oc_mutex_unlock(g_mutexObjectList);
     for (size_t i = 0; i < u_arraylist_length(sessionList); ++i)
     {
@@ -1598,20 +2259,14 @@ oc_refcounter CAGetTCPSessionInfoRefCountedFromEndpoint(const CAEndpoint_t *endp
     oc_mutex_lock(g_mutexObjectList);
 
     // get connection info from list
-    for (size_t i = 0; i < u_arraylist_length(s_sessionList); ++i)
+    CATCPSessionInfo_t *session = CAFindSessionByEndpoint(endpoint);
+    if (session)
     {
-        oc_refcounter ref = (oc_refcounter) u_arraylist_get(s_sessionList, i);
-        CATCPSessionInfo_t *session = (CATCPSessionInfo_t *) oc_refcounter_get_data(ref);
-        if (!strncmp(session->sep.endpoint.addr, endpoint->addr,
-                     sizeof(session->sep.endpoint.addr))
-                && (session->sep.endpoint.port == endpoint->port)
-                && (session->sep.endpoint.flags & endpoint->flags))
-        {
-            OIC_LOG(DEBUG, TAG, "Found in session list");
-            oc_refcounter_inc(ref);
-            oc_mutex_unlock(g_mutexObjectList);
-            return ref;
-        }
+        OIC_LOG(DEBUG, TAG, "Found in session list");
+        oc_refcounter ref = oc_refcounter_inc(
+            (oc_refcounter) u_arraylist_get(s_sessionList, session->listIndex));
+        oc_mutex_unlock(g_mutexObjectList);
+        return ref;
     }
     oc_mutex_unlock(g_mutexObjectList);
 
@@ -1627,18 +2282,13 @@ CASocketFd_t CAGetSocketFDFromEndpoint(const CAEndpoint_t *endpoint)
 
     // get connection info from list.
     oc_mutex_lock(g_mutexObjectList);
-    for (size_t i = 0; i < u_arraylist_length(s_sessionList); ++i)
+    CATCPSessionInfo_t *session = CAFindSessionByEndpoint(endpoint);
+    if (session)
     {
-        CATCPSessionInfo_t *session = session_list_get(s_sessionList, i);
-        if (!strncmp(session->sep.endpoint.addr, endpoint->addr,
-                     sizeof(session->sep.endpoint.addr))
-                && (session->sep.endpoint.port == endpoint->port)
-                && (session->sep.endpoint.flags & endpoint->flags))
-        {
-            oc_mutex_unlock(g_mutexObjectList);
-            OIC_LOG(DEBUG, TAG, "Found in session list");
-            return session->fd;
-        }
+        CASocketFd_t fd = session->fd;
+        oc_mutex_unlock(g_mutexObjectList);
+        OIC_LOG(DEBUG, TAG, "Found in session list");
+        return fd;
     }
 
     oc_mutex_unlock(g_mutexObjectList);
@@ -1656,19 +2306,10 @@ CAResult_t CASearchAndDeleteTCPSession(const CAEndpoint_t *endpoint)
     oc_refcounter ref = NULL;
 
     oc_mutex_lock(g_mutexObjectList);
-    size_t length = u_arraylist_length(s_sessionList);
-    for (size_t i = 0; i < length; ++i)
+    CATCPSessionInfo_t *session = CAFindSessionByEndpoint(endpoint);
+    if (session)
     {
-        CATCPSessionInfo_t *s = session_list_get(s_sessionList, i);
-        if (!strncmp(s->sep.endpoint.addr, endpoint->addr,
-                     sizeof(s->sep.endpoint.addr))
-                && (s->sep.endpoint.port == endpoint->port)
-                && (s->sep.endpoint.flags & endpoint->flags))
-        {
-            u_arraylist_swap(s_sessionList, i, length-1);
-            ref = (oc_refcounter)u_arraylist_remove(s_sessionList, length-1);
-            break;
-        }
+        ref = CAUnlinkSession(session);
     }
     oc_mutex_unlock(g_mutexObjectList);
 
@@ -19,6 +19,9 @@
  * *****************************************************************/
 #include <stdio.h>
 #include <stdlib.h>
+#include <string>
+#include <thread>
+#include <vector>
 #include <gtest/gtest.h>
 
 #ifdef __cplusplus
@@ -28,6 +31,8 @@ extern "C" {
 #include "srmutility.h"
 #include "../src/adapter_util/ca_adapter_net_ssl.c"
 #include "mbedtls/pem.h"
+#include "mbedtls/ecp.h"
+#include "mbedtls/x509_crt.h"
 #include "mbedtls_messages.h"
 
 #undef TAG
@@ -228,7 +233,7 @@ TEST_F(OCAA, CAcloseSslConnectionAll)
     if (sep)
     {
         oc_mutex_lock(g_sslContextMutex);
-        u_arraylist_add(g_caSslContext->peerList, (void *) sep);
+        AddSslPeer(sep);
         oc_mutex_unlock(g_sslContextMutex);
     }
 
@@ -445,7 +450,7 @@ TEST_F(OCAA, CAsslGenerateOwnerPsk)
     if (sep)
     {
         oc_mutex_lock(g_sslContextMutex);
-        u_arraylist_add(g_caSslContext->peerList, (void *) sep);
+        AddSslPeer(sep);
         oc_mutex_unlock(g_sslContextMutex);
     }
 
@@ -493,7 +498,7 @@ TEST_F(OCAA, CAinitiateSslHandshake)
     if (sep)
     {
         oc_mutex_lock(g_sslContextMutex);
-        u_arraylist_add(g_caSslContext->peerList, (void *) sep);
+        AddSslPeer(sep);
         oc_mutex_unlock(g_sslContextMutex);
     }
 
@@ -526,3 +531,705 @@ TEST_F(OCAA, StartRetransmit)
 }
 
 
+
+typedef struct
+{
+    unsigned char buf[4 * TLS_MSG_BUF_LEN];
+    size_t len;
+} MemoryPipe;
+
+typedef struct
+{
+    MemoryPipe *out;
+    MemoryPipe *in;
+} MemoryLink;
+
+static int MemorySend(void *ctx, const unsigned char *buf, size_t len)
+{
+    MemoryPipe *pipe = ((MemoryLink *)ctx)->out;
+    if (len > sizeof(pipe->buf) - pipe->len)
+    {
+        return MBEDTLS_ERR_SSL_WANT_WRITE;
+    }
+    memcpy(pipe->buf + pipe->len, buf, len);
+    pipe->len += len;
+    return (int)len;
+}
+
+static int MemoryRecv(void *ctx, unsigned char *buf, size_t len)
+{
+    MemoryPipe *pipe = ((MemoryLink *)ctx)->in;
+    if (0 == pipe->len)
+    {
+        return MBEDTLS_ERR_SSL_WANT_READ;
+    }
+    size_t n = (len < pipe->len) ? len : pipe->len;
+    memcpy(buf, pipe->buf, n);
+    memmove(pipe->buf, pipe->buf + n, pipe->len - n);
+    pipe->len -= n;
+    return (int)n;
+}
+
+/*
+ * Steps the handshake of a client and a server connected over memory until both are
+ * done, and sets resumed if the client resumed a session.
+ */
+static bool RunHandshake(mbedtls_ssl_context *client, mbedtls_ssl_context *server, bool *resumed)
+{
+    *resumed = false;
+    for (int i = 0; i < 100; i++)
+    {
+        int clientRet = 0;
+        int serverRet = 0;
+        if (MBEDTLS_SSL_HANDSHAKE_OVER != client->state)
+        {
+            clientRet = mbedtls_ssl_handshake_step(client);
+            if (NULL != client->handshake && client->handshake->resume)
+            {
+                *resumed = true;
+            }
+        }
+        if (MBEDTLS_SSL_HANDSHAKE_OVER != server->state)
+        {
+            serverRet = mbedtls_ssl_handshake_step(server);
+        }
+        if ((0 != clientRet && MBEDTLS_ERR_SSL_WANT_READ != clientRet) ||
+            (0 != serverRet && MBEDTLS_ERR_SSL_WANT_READ != serverRet))
+        {
+            OIC_LOG_V(ERROR, TAG, "handshake failed: -0x%x -0x%x", -clientRet, -serverRet);
+            return false;
+        }
+        if (MBEDTLS_SSL_HANDSHAKE_OVER == client->state &&
+            MBEDTLS_SSL_HANDSHAKE_OVER == server->state)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Certificate and configurations for the handshakes over memory: a self-signed P-256
+ * certificate of the server, because the test certificates are expired and use P-521,
+ * and the configurations of the adapter without peer authentication.
+ */
+class MemoryTls
+{
+    public:
+        MemoryTls()
+        {
+            mbedtls_pk_init(&pkey);
+            mbedtls_x509_crt_init(&crt);
+            mbedtls_ssl_config_init(&clientConf);
+            mbedtls_ssl_config_init(&serverConf);
+        }
+
+        ~MemoryTls()
+        {
+            mbedtls_ssl_config_free(&clientConf);
+            mbedtls_ssl_config_free(&serverConf);
+            mbedtls_x509_crt_free(&crt);
+            mbedtls_pk_free(&pkey);
+        }
+
+        bool Init(int transport)
+        {
+            static const int cipherSuites[] = { MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_CCM, 0 };
+            if (!GenerateCertificate() ||
+                0 != InitConfig(&clientConf, transport, MBEDTLS_SSL_IS_CLIENT) ||
+                0 != InitConfig(&serverConf, transport, MBEDTLS_SSL_IS_SERVER))
+            {
+                return false;
+            }
+            mbedtls_ssl_conf_authmode(&clientConf, MBEDTLS_SSL_VERIFY_NONE);
+            mbedtls_ssl_conf_authmode(&serverConf, MBEDTLS_SSL_VERIFY_NONE);
+            mbedtls_ssl_conf_ciphersuites(&clientConf, cipherSuites);
+            mbedtls_ssl_conf_ciphersuites(&serverConf, cipherSuites);
+            return 0 == mbedtls_ssl_conf_own_cert(&serverConf, &crt, &pkey);
+        }
+
+        mbedtls_pk_context pkey;
+        mbedtls_x509_crt crt;
+        mbedtls_ssl_config clientConf;
+        mbedtls_ssl_config serverConf;
+
+    private:
+        bool GenerateCertificate()
+        {
+            if (0 != mbedtls_pk_setup(&pkey, mbedtls_pk_info_from_type(MBEDTLS_PK_ECKEY)) ||
+                0 != mbedtls_ecp_gen_key(MBEDTLS_ECP_DP_SECP256R1, mbedtls_pk_ec(pkey),
+                                         mbedtls_ctr_drbg_random, &g_caSslContext->rnd))
+            {
+                return false;
+            }
+            mbedtls_x509write_cert writer;
+            mbedtls_x509write_crt_init(&writer);
+            mbedtls_mpi serial;
+            mbedtls_mpi_init(&serial);
+            mbedtls_mpi_lset(&serial, 1);
+            mbedtls_x509write_crt_set_version(&writer, MBEDTLS_X509_CRT_VERSION_3);
+            mbedtls_x509write_crt_set_md_alg(&writer, MBEDTLS_MD_SHA256);
+            mbedtls_x509write_crt_set_subject_key(&writer, &pkey);
+            mbedtls_x509write_crt_set_issuer_key(&writer, &pkey);
+            mbedtls_x509write_crt_set_serial(&writer, &serial);
+            unsigned char der[1024];
+            int derLen = -1;
+            if (0 == mbedtls_x509write_crt_set_subject_name(&writer,
+                         "CN=uuid:32323232-3232-3232-3232-323232323232") &&
+                0 == mbedtls_x509write_crt_set_issuer_name(&writer,
+                         "CN=uuid:32323232-3232-3232-3232-323232323232") &&
+                0 == mbedtls_x509write_crt_set_validity(&writer, "20200101000000", "20991231235959"))
+            {
+                derLen = mbedtls_x509write_crt_der(&writer, der, sizeof(der),
+                                                   mbedtls_ctr_drbg_random, &g_caSslContext->rnd);
+            }
+            mbedtls_x509write_crt_free(&writer);
+            mbedtls_mpi_free(&serial);
+            return 0 < derLen &&
+                   0 == mbedtls_x509_crt_parse_der(&crt, der + sizeof(der) - derLen, derLen);
+        }
+};
+
+static CAEndpoint_t PeerEndpoint(CATransportAdapter_t adapter, int host, uint16_t port)
+{
+    CAEndpoint_t endpoint = {};
+    endpoint.adapter = adapter;
+    endpoint.port = port;
+    snprintf(endpoint.addr, sizeof(endpoint.addr), "10.0.%d.%d", host / 256, host % 256);
+    return endpoint;
+}
+
+static SslEndPoint_t *AddPeer(const CAEndpoint_t &endpoint)
+{
+    SslEndPoint_t *tep = NewSslEndPoint(&endpoint, &g_caSslContext->clientTlsConf);
+    if (NULL != tep && !AddSslPeer(tep))
+    {
+        DeleteSslEndPoint(tep);
+        tep = NULL;
+    }
+    return tep;
+}
+
+static bool IsListedPeer(SslEndPoint_t *tep)
+{
+    return tep == u_arraylist_get(g_caSslContext->peerList, tep->listIndex);
+}
+
+// More peers than the initial size of the table: every peer is found by its endpoint
+// after the table grew, and removing peers leaves the others and the list consistent.
+TEST_F(OCAA, SslPeerTable)
+{
+    const int peers = 3 * SSL_PEER_TABLE_INITIAL_SIZE;
+    size_t listed = u_arraylist_length(g_caSslContext->peerList);
+
+    std::vector<SslEndPoint_t *> teps;
+    for (int host = 0; host < peers; host++)
+    {
+        teps.push_back(AddPeer(PeerEndpoint(CA_ADAPTER_TCP, host, 5684)));
+        ASSERT_TRUE(NULL != teps.back());
+    }
+    EXPECT_EQ(listed + peers, u_arraylist_length(g_caSslContext->peerList));
+    EXPECT_LE((size_t)peers, g_caSslContext->peerTableSize);
+
+    for (int host = 0; host < peers; host++)
+    {
+        CAEndpoint_t endpoint = PeerEndpoint(CA_ADAPTER_TCP, host, 5684);
+        EXPECT_EQ(teps[host], GetSslPeer(&endpoint));
+        EXPECT_TRUE(IsListedPeer(teps[host]));
+        endpoint.port++;
+        EXPECT_TRUE(NULL == GetSslPeer(&endpoint));
+        endpoint = PeerEndpoint(CA_ADAPTER_IP, host, 5684);
+        EXPECT_TRUE(NULL == GetSslPeer(&endpoint));
+    }
+    CAEndpoint_t other = PeerEndpoint(CA_ADAPTER_TCP, peers, 5684);
+    EXPECT_TRUE(NULL == GetSslPeer(&other));
+
+    for (int host = 0; host < peers; host += 2)
+    {
+        RemoveSslPeer(teps[host]);
+    }
+    EXPECT_EQ(listed + peers / 2, u_arraylist_length(g_caSslContext->peerList));
+    for (int host = 0; host < peers; host++)
+    {
+        CAEndpoint_t endpoint = PeerEndpoint(CA_ADAPTER_TCP, host, 5684);
+        if (host % 2)
+        {
+            EXPECT_EQ(teps[host], GetSslPeer(&endpoint));
+            EXPECT_TRUE(IsListedPeer(teps[host]));
+        }
+        else
+        {
+            EXPECT_TRUE(NULL == GetSslPeer(&endpoint));
+        }
+    }
+
+    for (int host = 1; host < peers; host += 2)
+    {
+        RemoveSslPeer(teps[host]);
+    }
+    EXPECT_EQ(listed, u_arraylist_length(g_caSslContext->peerList));
+}
+
+// Peers in the same bucket are told apart, and removing one of them leaves the others.
+TEST_F(OCAA, SslPeerTableCollisions)
+{
+    CAEndpoint_t endpoints[3] = { PeerEndpoint(CA_ADAPTER_TCP, 1, 5684) };
+    SslEndPoint_t *teps[3] = { AddPeer(endpoints[0]) };
+    ASSERT_TRUE(NULL != teps[0]);
+    size_t tableSize = g_caSslContext->peerTableSize;
+    size_t bucket = GetSslPeerBucket(&endpoints[0]);
+
+    // Other ports of the same address that fall in the same bucket.
+    uint16_t port = endpoints[0].port;
+    for (int i = 1; i < 3; i++)
+    {
+        do
+        {
+            endpoints[i] = PeerEndpoint(CA_ADAPTER_TCP, 1, ++port);
+        } while (bucket != GetSslPeerBucket(&endpoints[i]));
+        teps[i] = AddPeer(endpoints[i]);
+        ASSERT_TRUE(NULL != teps[i]);
+    }
+    ASSERT_EQ(tableSize, g_caSslContext->peerTableSize);
+
+    for (int i = 0; i < 3; i++)
+    {
+        EXPECT_EQ(teps[i], GetSslPeer(&endpoints[i]));
+    }
+
+    RemoveSslPeer(teps[1]);
+    EXPECT_TRUE(NULL == GetSslPeer(&endpoints[1]));
+    EXPECT_EQ(teps[0], GetSslPeer(&endpoints[0]));
+    EXPECT_EQ(teps[2], GetSslPeer(&endpoints[2]));
+    EXPECT_TRUE(IsListedPeer(teps[0]));
+    EXPECT_TRUE(IsListedPeer(teps[2]));
+
+    RemoveSslPeer(teps[2]);
+    EXPECT_TRUE(NULL == GetSslPeer(&endpoints[2]));
+    EXPECT_EQ(teps[0], GetSslPeer(&endpoints[0]));
+    RemoveSslPeer(teps[0]);
+    EXPECT_TRUE(NULL == GetSslPeer(&endpoints[0]));
+}
+
+// Sessions over BLE are found regardless of the port.
+TEST_F(OCAA, SslPeerTableIgnoresBlePort)
+{
+    CAEndpoint_t endpoint = PeerEndpoint(CA_ADAPTER_GATT_BTLE, 1, 1);
+    SslEndPoint_t *tep = AddPeer(endpoint);
+    ASSERT_TRUE(NULL != tep);
+    endpoint.port = 2;
+    EXPECT_EQ(tep, GetSslPeer(&endpoint));
+    RemoveSslPeer(tep);
+    EXPECT_TRUE(NULL == GetSslPeer(&endpoint));
+}
+
+/*
+ * A peer of the adapter with an established session, and the client of the session.
+ * The adapter sends the records of the peer to the client over memory.
+ */
+typedef struct
+{
+    CAEndpoint_t endpoint;
+    SslEndPoint_t *tep;
+    mbedtls_ssl_context client;
+    MemoryPipe toClient;
+    MemoryPipe toServer;
+    MemoryLink clientLink;
+    MemoryLink serverLink;
+    std::vector<std::string> received;
+    int errors;
+} MemoryPeer;
+
+static const uint16_t MEMORY_PEER_PORT = 6000;
+static std::vector<MemoryPeer *> g_memoryPeers;
+
+static MemoryPeer *FindMemoryPeer(const CAEndpoint_t *endpoint)
+{
+    size_t index = endpoint->port - MEMORY_PEER_PORT;
+    return (index < g_memoryPeers.size()) ? g_memoryPeers[index] : NULL;
+}
+
+static ssize_t MemoryPeerSend(CAEndpoint_t *endpoint, const void *data, size_t dataLength)
+{
+    MemoryPeer *peer = FindMemoryPeer(endpoint);
+    return peer ? MemorySend(&peer->serverLink, (const unsigned char *)data, dataLength) : -1;
+}
+
+static void MemoryPeerReceived(const CASecureEndpoint_t *sep, const void *data, size_t dataLength)
+{
+    MemoryPeer *peer = FindMemoryPeer(&sep->endpoint);
+    if (peer)
+    {
+        peer->received.push_back(std::string((const char *)data, dataLength));
+    }
+}
+
+static void MemoryPeerError(const CAEndpoint_t *endpoint, const void *data, size_t dataLength,
+                            CAResult_t result)
+{
+    OC_UNUSED(data);
+    OC_UNUSED(dataLength);
+    OC_UNUSED(result);
+    MemoryPeer *peer = FindMemoryPeer(endpoint);
+    if (peer)
+    {
+        peer->errors++;
+    }
+}
+
+/*
+ * Establishes the session of a peer over memory and adds the peer to the adapter, which
+ * serves the session from then on.
+ */
+static bool ConnectMemoryPeer(MemoryPeer *peer, MemoryTls *tls)
+{
+    peer->clientLink.out = &peer->toServer;
+    peer->clientLink.in = &peer->toClient;
+    peer->serverLink.out = &peer->toClient;
+    peer->serverLink.in = &peer->toServer;
+    mbedtls_ssl_init(&peer->client);
+    if (0 != mbedtls_ssl_setup(&peer->client, &tls->clientConf))
+    {
+        return false;
+    }
+    mbedtls_ssl_set_bio(&peer->client, &peer->clientLink, MemorySend, MemoryRecv, NULL);
+
+    peer->tep = NewSslEndPoint(&peer->endpoint, &tls->serverConf);
+    if (NULL == peer->tep)
+    {
+        return false;
+    }
+    mbedtls_ssl_set_bio(&peer->tep->ssl, &peer->serverLink, MemorySend, MemoryRecv, NULL);
+    bool resumed = false;
+    bool connected = RunHandshake(&peer->client, &peer->tep->ssl, &resumed);
+    mbedtls_ssl_set_bio(&peer->tep->ssl, peer->tep, SendCallBack, RecvCallBack, NULL);
+    if (!connected || !AddSslPeer(peer->tep))
+    {
+        DeleteSslEndPoint(peer->tep);
+        peer->tep = NULL;
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Sends messages both ways on a peer: the adapter encrypts messages for the client, and
+ * decrypts the replies of the client. Returns the number of messages that did not
+ * arrive intact.
+ */
+static int ExchangeMessages(MemoryPeer *peer, int messages)
+{
+    int failures = 0;
+    CASecureEndpoint_t sep = {};
+    sep.endpoint = peer->endpoint;
+    for (int m = 0; m < messages; m++)
+    {
+        std::string message = "message " + std::to_string(m) + " to port " +
+                              std::to_string(peer->endpoint.port);
+        unsigned char buf[256];
+        if (CA_STATUS_OK != CAencryptSsl(&peer->endpoint, message.data(), message.size()) ||
+            (int)message.size() != mbedtls_ssl_read(&peer->client, buf, sizeof(buf)) ||
+            0 != memcmp(buf, message.data(), message.size()))
+        {
+            failures++;
+        }
+
+        std::string reply = "reply " + std::to_string(m) + " from port " +
+                            std::to_string(peer->endpoint.port);
+        if ((int)reply.size() != mbedtls_ssl_write(&peer->client,
+                                                   (const unsigned char *)reply.data(),
+                                                   reply.size()))
+        {
+            failures++;
+            continue;
+        }
+        std::vector<uint8_t> record(peer->toServer.buf, peer->toServer.buf + peer->toServer.len);
+        peer->toServer.len = 0;
+        if (CA_STATUS_OK != CAdecryptSsl(&sep, record.data(), record.size()) ||
+            peer->received.empty() || reply != peer->received.back())
+        {
+            failures++;
+        }
+    }
+    return failures;
+}
+
+// Established sessions of different peers are encrypted and decrypted from several
+// threads at once. Each peer keeps its own records in order.
+TEST_F(OCAA, ParallelEncryptDecryptPerPeer)
+{
+    const int peers = 4;
+    const int messages = 200;
+
+    MemoryTls tls;
+    ASSERT_TRUE(tls.Init(MBEDTLS_SSL_TRANSPORT_STREAM));
+
+    int adapterIndex = GetAdapterIndex(CA_ADAPTER_TCP);
+    ASSERT_LE(0, adapterIndex);
+    SslCallbacks_t savedCallbacks = g_caSslContext->adapterCallbacks[adapterIndex];
+    g_caSslContext->adapterCallbacks[adapterIndex].sendCallback = MemoryPeerSend;
+    g_caSslContext->adapterCallbacks[adapterIndex].recvCallback = MemoryPeerReceived;
+    g_caSslContext->adapterCallbacks[adapterIndex].errorCallback = MemoryPeerError;
+
+    for (int i = 0; i < peers; i++)
+    {
+        MemoryPeer *peer = new MemoryPeer();
+        peer->endpoint = PeerEndpoint(CA_ADAPTER_TCP, i + 1, MEMORY_PEER_PORT + i);
+        g_memoryPeers.push_back(peer);
+        EXPECT_TRUE(ConnectMemoryPeer(peer, &tls));
+    }
+
+    std::vector<int> failures(peers, 0);
+    if (!HasFailure())
+    {
+        // The fixture holds g_sslContextMutex.
+        oc_mutex_unlock(g_sslContextMutex);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < peers; i++)
+        {
+            threads.emplace_back([&, i] {
+                failures[i] = ExchangeMessages(g_memoryPeers[i], messages);
+            });
+        }
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+        oc_mutex_lock(g_sslContextMutex);
+    }
+
+    for (int i = 0; i < peers; i++)
+    {
+        MemoryPeer *peer = g_memoryPeers[i];
+        EXPECT_EQ(0, failures[i]) << "peer " << i;
+        EXPECT_EQ(0, peer->errors) << "peer " << i;
+        EXPECT_EQ((size_t)messages, peer->received.size()) << "peer " << i;
+        if (peer->tep)
+        {
+            EXPECT_EQ(peer->tep, GetSslPeer(&peer->endpoint));
+            RemoveSslPeer(peer->tep);
+        }
+        mbedtls_ssl_free(&peer->client);
+        delete peer;
+    }
+    g_memoryPeers.clear();
+    g_caSslContext->adapterCallbacks[adapterIndex] = savedCallbacks;
+}
+
+static SslClientSession_t *NewClientSession(const char *addr, mbedtls_time_t start)
+{
+    SslClientSession_t *entry = (SslClientSession_t *)OICCalloc(1, sizeof(SslClientSession_t));
+    snprintf(entry->endpoint.addr, sizeof(entry->endpoint.addr), "%s", addr);
+    entry->endpoint.port = 5684;
+    entry->endpoint.adapter = CA_ADAPTER_IP;
+    mbedtls_ssl_session_init(&entry->session);
+    entry->session.start = start;
+    entry->session.ciphersuite = MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_CCM;
+    entry->session.id_len = 32;
+    entry->session.ticket = (unsigned char *)mbedtls_calloc(1, 16);
+    entry->session.ticket_len = 16;
+    return entry;
+}
+
+TEST_F(OCAA, CAsslSaveLoadClientSessions)
+{
+    mbedtls_time_t now = mbedtls_time(NULL);
+    ASSERT_TRUE(AddClientSession(NewClientSession("127.0.0.11", now)));
+    ASSERT_TRUE(AddClientSession(NewClientSession("127.0.0.12", now - SSL_SESSION_LIFETIME)));
+
+    uint8_t *data = NULL;
+    size_t dataLen = 0;
+    ASSERT_EQ(CA_STATUS_OK, CAsslSaveClientSessions(&data, &dataLen));
+    DeleteClientSessions();
+
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CAsslLoadClientSessions(data, dataLen - 1));
+    DeleteClientSessions();
+    EXPECT_EQ(CA_STATUS_OK, CAsslLoadClientSessions(data, dataLen));
+    OICFree(data);
+
+    // The expired session is not restored.
+    ASSERT_EQ(1u, u_arraylist_length(g_caSslContext->clientSessions));
+    SslClientSession_t *entry =
+        (SslClientSession_t *)u_arraylist_get(g_caSslContext->clientSessions, 0);
+    EXPECT_STREQ("127.0.0.11", entry->endpoint.addr);
+    EXPECT_EQ(MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_CCM, entry->session.ciphersuite);
+    EXPECT_EQ(16u, entry->session.ticket_len);
+    EXPECT_TRUE(NULL == entry->session.peer_cert);
+    DeleteClientSessions();
+
+    mbedtls_ssl_session psk;
+    mbedtls_ssl_session_init(&psk);
+    psk.ciphersuite = MBEDTLS_TLS_ECDHE_PSK_WITH_AES_128_CBC_SHA256;
+    EXPECT_NE(0, SetServerSession(&g_caSslContext->sessionCache, &psk));
+}
+
+/*
+ * Client session settings of the adapter for the tests of session resumption: the
+ * ciphersuite of the memory handshakes is enabled and no ciphersuite is selected.
+ */
+class ClientSessionSettings
+{
+    public:
+        ClientSessionSettings()
+        {
+            memcpy(m_savedCipherSuites, g_cipherSuitesList, sizeof(g_cipherSuitesList));
+            m_savedCipher = g_caSslContext->cipher;
+            memset(g_cipherSuitesList, 0, sizeof(g_cipherSuitesList));
+            g_cipherSuitesList[0] = MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_CCM;
+            g_caSslContext->cipher = SSL_CIPHER_MAX;
+            DeleteClientSessions();
+        }
+
+        ~ClientSessionSettings()
+        {
+            DeleteClientSessions();
+            memcpy(g_cipherSuitesList, m_savedCipherSuites, sizeof(g_cipherSuitesList));
+            g_caSslContext->cipher = m_savedCipher;
+        }
+
+    private:
+        int m_savedCipherSuites[SSL_CIPHER_MAX];
+        SslCipher_t m_savedCipher;
+};
+
+/*
+ * Runs a handshake over memory between a client endpoint of the adapter and a server.
+ * The client offers its kept session of the endpoint, if any, and keeps the established
+ * session. Sets resumed if the session was resumed.
+ */
+static bool ClientHandshake(const CAEndpoint_t &endpoint, MemoryTls *tls, bool *resumed)
+{
+    SslEndPoint_t *tep = NewSslEndPoint(&endpoint, &tls->clientConf);
+    if (NULL == tep)
+    {
+        return false;
+    }
+    LoadClientSession(tep);
+
+    MemoryPipe *toServer = (MemoryPipe *)OICCalloc(1, sizeof(MemoryPipe));
+    MemoryPipe *toClient = (MemoryPipe *)OICCalloc(1, sizeof(MemoryPipe));
+    MemoryLink clientLink = { toServer, toClient };
+    MemoryLink serverLink = { toClient, toServer };
+    mbedtls_ssl_context server;
+    mbedtls_ssl_init(&server);
+    bool connected = false;
+    if (NULL != toServer && NULL != toClient &&
+        0 == mbedtls_ssl_setup(&server, &tls->serverConf))
+    {
+        mbedtls_ssl_set_bio(&tep->ssl, &clientLink, MemorySend, MemoryRecv, NULL);
+        mbedtls_ssl_set_bio(&server, &serverLink, MemorySend, MemoryRecv, NULL);
+        connected = RunHandshake(&tep->ssl, &server, resumed);
+    }
+    if (connected)
+    {
+        SaveClientSession(tep);
+    }
+
+    mbedtls_ssl_free(&server);
+    DeleteSslEndPoint(tep);
+    OICFree(toServer);
+    OICFree(toClient);
+    return connected;
+}
+
+static SslClientSession_t *GetClientSession(size_t index)
+{
+    return (SslClientSession_t *)u_arraylist_get(g_caSslContext->clientSessions, index);
+}
+
+static const int g_ticketModes[] = { MBEDTLS_SSL_SESSION_TICKETS_DISABLED,
+                                     MBEDTLS_SSL_SESSION_TICKETS_ENABLED };
+
+// The session kept by SaveClientSession is offered by LoadClientSession to the same
+// server only, by session ID or with the session ticket.
+TEST_F(OCAA, ClientSessionResumption)
+{
+    MemoryTls tls;
+    ASSERT_TRUE(tls.Init(MBEDTLS_SSL_TRANSPORT_STREAM));
+    ClientSessionSettings settings;
+
+    for (int ticketMode : g_ticketModes)
+    {
+        mbedtls_ssl_conf_session_tickets(&tls.clientConf, ticketMode);
+        DeleteClientSessions();
+        CAEndpoint_t endpoint = PeerEndpoint(CA_ADAPTER_TCP, 1, 5684);
+        bool resumed = true;
+
+        ASSERT_TRUE(ClientHandshake(endpoint, &tls, &resumed));
+        EXPECT_FALSE(resumed);
+        ASSERT_EQ(1u, u_arraylist_length(g_caSslContext->clientSessions));
+        SslClientSession_t *entry = GetClientSession(0);
+        EXPECT_STREQ(endpoint.addr, entry->endpoint.addr);
+        EXPECT_EQ(endpoint.port, entry->endpoint.port);
+        EXPECT_EQ(MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_CCM, entry->session.ciphersuite);
+        EXPECT_EQ(MBEDTLS_SSL_SESSION_TICKETS_ENABLED == ticketMode,
+                  0 < entry->session.ticket_len);
+
+        ASSERT_TRUE(ClientHandshake(endpoint, &tls, &resumed));
+        EXPECT_TRUE(resumed);
+        // The resumed session replaced the kept one.
+        EXPECT_EQ(1u, u_arraylist_length(g_caSslContext->clientSessions));
+
+        CAEndpoint_t other = endpoint;
+        other.port++;
+        ASSERT_TRUE(ClientHandshake(other, &tls, &resumed));
+        EXPECT_FALSE(resumed);
+        EXPECT_EQ(2u, u_arraylist_length(g_caSslContext->clientSessions));
+    }
+}
+
+// An expired session is dropped instead of being offered.
+TEST_F(OCAA, ExpiredClientSessionIsNotResumed)
+{
+    MemoryTls tls;
+    ASSERT_TRUE(tls.Init(MBEDTLS_SSL_TRANSPORT_STREAM));
+    ClientSessionSettings settings;
+    CAEndpoint_t endpoint = PeerEndpoint(CA_ADAPTER_TCP, 1, 5684);
+    bool resumed = true;
+
+    ASSERT_TRUE(ClientHandshake(endpoint, &tls, &resumed));
+    ASSERT_EQ(1u, u_arraylist_length(g_caSslContext->clientSessions));
+    GetClientSession(0)->session.start -= SSL_SESSION_LIFETIME;
+
+    ASSERT_TRUE(ClientHandshake(endpoint, &tls, &resumed));
+    EXPECT_FALSE(resumed);
+    ASSERT_EQ(1u, u_arraylist_length(g_caSslContext->clientSessions));
+    EXPECT_FALSE(IsExpiredClientSession(GetClientSession(0)));
+}
+
+// Sessions restored by CAsslLoadClientSessions are resumed, and CAsslFlushSessions drops
+// the sessions of both sides: a restored session is no longer accepted by the server.
+TEST_F(OCAA, CAsslFlushSessions)
+{
+    MemoryTls tls;
+    ASSERT_TRUE(tls.Init(MBEDTLS_SSL_TRANSPORT_STREAM));
+    ClientSessionSettings settings;
+
+    for (int ticketMode : g_ticketModes)
+    {
+        mbedtls_ssl_conf_session_tickets(&tls.clientConf, ticketMode);
+        DeleteClientSessions();
+        CAEndpoint_t endpoint = PeerEndpoint(CA_ADAPTER_TCP, 1, 5684);
+        bool resumed = true;
+        ASSERT_TRUE(ClientHandshake(endpoint, &tls, &resumed));
+
+        uint8_t *data = NULL;
+        size_t dataLen = 0;
+        ASSERT_EQ(CA_STATUS_OK, CAsslSaveClientSessions(&data, &dataLen));
+        DeleteClientSessions();
+        EXPECT_EQ(CA_STATUS_OK, CAsslLoadClientSessions(data, dataLen));
+        ASSERT_EQ(1u, u_arraylist_length(g_caSslContext->clientSessions));
+        EXPECT_TRUE(NULL != GetClientSession(0)->session.peer_cert);
+        ASSERT_TRUE(ClientHandshake(endpoint, &tls, &resumed));
+        EXPECT_TRUE(resumed);
+
+        EXPECT_EQ(CA_STATUS_OK, CAsslFlushSessions());
+        EXPECT_EQ(0u, u_arraylist_length(g_caSslContext->clientSessions));
+
+        EXPECT_EQ(CA_STATUS_OK, CAsslLoadClientSessions(data, dataLen));
+        OICFree(data);
+        ASSERT_EQ(1u, u_arraylist_length(g_caSslContext->clientSessions));
+        ASSERT_TRUE(ClientHandshake(endpoint, &tls, &resumed));
+        EXPECT_FALSE(resumed);
+    }
+}
@@ -0,0 +1,207 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "caduplicatecache.h"
+#include "oic_malloc.h"
+
+class CADuplicateCacheF : public testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        // a multicast request, received over both address families
+        memset(&m_ipv6, 0, sizeof(m_ipv6));
+        m_ipv6.adapter = CA_ADAPTER_IP;
+        m_ipv6.flags = (CATransportFlags_t)(CA_IPV6 | CA_MULTICAST);
+        m_ipv6.port = 5683;
+        m_ipv6.ifindex = 2;
+        strcpy(m_ipv6.addr, "fe80::1");
+
+        m_ipv4 = m_ipv6;
+        m_ipv4.flags = (CATransportFlags_t)(CA_IPV4 | CA_MULTICAST);
+        strcpy(m_ipv4.addr, "192.168.0.1");
+    }
+
+    virtual void TearDown()
+    {
+        CADuplicateCacheTerminate(&m_cache);
+    }
+
+    bool Check(const CAEndpoint_t *endpoint, CAMessageType_t type, uint16_t messageId,
+               void **response = NULL, uint32_t *responseSize = NULL)
+    {
+        char token[] = "token";
+        return CADuplicateCacheCheck(&m_cache, endpoint, type, messageId,
+                                     token, sizeof(token) - 1, response, responseSize);
+    }
+
+    CADuplicateCache_t m_cache;
+    CAEndpoint_t m_ipv6;
+    CAEndpoint_t m_ipv4;
+};
+
+TEST_F(CADuplicateCacheF, SecondAddressFamilyIsDuplicate)
+{
+    ASSERT_EQ(CA_STATUS_OK, CADuplicateCacheInitialize(&m_cache, 0, 0));
+
+    EXPECT_FALSE(Check(&m_ipv6, CA_MSG_NONCONFIRM, 1));
+    EXPECT_TRUE(Check(&m_ipv4, CA_MSG_NONCONFIRM, 1));
+
+    // other message id, token or interface
+    EXPECT_FALSE(Check(&m_ipv4, CA_MSG_NONCONFIRM, 2));
+    char token[] = "other";
+    EXPECT_FALSE(CADuplicateCacheCheck(&m_cache, &m_ipv4, CA_MSG_NONCONFIRM, 1,
+                                       token, sizeof(token) - 1, NULL, NULL));
+    m_ipv4.ifindex = 3;
+    EXPECT_FALSE(Check(&m_ipv4, CA_MSG_NONCONFIRM, 1));
+}
+
+TEST_F(CADuplicateCacheF, ConfirmableResendsResponse)
+{
+    ASSERT_EQ(CA_STATUS_OK, CADuplicateCacheInitialize(&m_cache, 0, 0));
+    m_ipv4.flags = CA_IPV4;
+
+    EXPECT_FALSE(Check(&m_ipv4, CA_MSG_CONFIRM, 7));
+
+    // retransmitted before the response was sent
+    void *response = NULL;
+    uint32_t responseSize = 0;
+    EXPECT_TRUE(Check(&m_ipv4, CA_MSG_CONFIRM, 7, &response, &responseSize));
+    EXPECT_TRUE(NULL == response);
+
+    char token[] = "token";
+    uint8_t pdu[] = { 0x65, 0x45, 0x00, 0x07 };
+    CADuplicateCacheSetResponse(&m_cache, &m_ipv4, 7, token, sizeof(token) - 1,
+                                pdu, sizeof(pdu));
+
+    EXPECT_TRUE(Check(&m_ipv4, CA_MSG_CONFIRM, 7, &response, &responseSize));
+    ASSERT_TRUE(NULL != response);
+    ASSERT_EQ(sizeof(pdu), responseSize);
+    EXPECT_EQ(0, memcmp(pdu, response, sizeof(pdu)));
+    OICFree(response);
+
+    // same message id and token from another sender
+    m_ipv4.port = 5684;
+    EXPECT_FALSE(Check(&m_ipv4, CA_MSG_CONFIRM, 7));
+}
+
+// Unicast requests of different senders are distinct even with the same key.
+TEST_F(CADuplicateCacheF, UnicastComparesSender)
+{
+    ASSERT_EQ(CA_STATUS_OK, CADuplicateCacheInitialize(&m_cache, 0, 0));
+    m_ipv4.flags = CA_IPV4;
+    m_ipv6.flags = CA_IPV6;
+
+    EXPECT_FALSE(Check(&m_ipv6, CA_MSG_NONCONFIRM, 1));
+    EXPECT_FALSE(Check(&m_ipv4, CA_MSG_NONCONFIRM, 1));
+
+    CAEndpoint_t other = m_ipv4;
+    other.port = 5684;
+    EXPECT_FALSE(Check(&other, CA_MSG_NONCONFIRM, 1));
+    strcpy(other.addr, "192.168.0.2");
+    other.port = m_ipv4.port;
+    EXPECT_FALSE(Check(&other, CA_MSG_NONCONFIRM, 1));
+
+    // repeated by the same sender
+    EXPECT_TRUE(Check(&m_ipv4, CA_MSG_NONCONFIRM, 1));
+    EXPECT_TRUE(Check(&m_ipv6, CA_MSG_NONCONFIRM, 1));
+
+    // a unicast request does not match a multicast record of another sender
+    m_ipv6.flags = (CATransportFlags_t)(CA_IPV6 | CA_MULTICAST);
+    EXPECT_FALSE(Check(&m_ipv6, CA_MSG_NONCONFIRM, 2));
+    EXPECT_FALSE(Check(&m_ipv4, CA_MSG_NONCONFIRM, 2));
+}
+
+// A multicast request of another sender is only a duplicate within the window, a
+// repetition by the same sender for the lifetime of the record.
+TEST_F(CADuplicateCacheF, MulticastWindow)
+{
+    ASSERT_EQ(CA_STATUS_OK, CADuplicateCacheInitialize(&m_cache, 0, 0));
+    m_cache.multicastWindow = 50;
+
+    EXPECT_FALSE(Check(&m_ipv6, CA_MSG_NONCONFIRM, 1));
+    EXPECT_TRUE(Check(&m_ipv4, CA_MSG_NONCONFIRM, 1));
+
+    EXPECT_FALSE(Check(&m_ipv6, CA_MSG_NONCONFIRM, 2));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_FALSE(Check(&m_ipv4, CA_MSG_NONCONFIRM, 2));
+    EXPECT_TRUE(Check(&m_ipv6, CA_MSG_NONCONFIRM, 2));
+    EXPECT_TRUE(Check(&m_ipv4, CA_MSG_NONCONFIRM, 2));
+}
+
+TEST_F(CADuplicateCacheF, RecordsExpire)
+{
+    ASSERT_EQ(CA_STATUS_OK, CADuplicateCacheInitialize(&m_cache, 0, 50));
+
+    EXPECT_FALSE(Check(&m_ipv6, CA_MSG_NONCONFIRM, 1));
+    EXPECT_TRUE(Check(&m_ipv4, CA_MSG_NONCONFIRM, 1));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_FALSE(Check(&m_ipv4, CA_MSG_NONCONFIRM, 1));
+    EXPECT_EQ(1u, m_cache.count);
+}
+
+TEST_F(CADuplicateCacheF, OldestRecordIsReplaced)
+{
+    ASSERT_EQ(CA_STATUS_OK, CADuplicateCacheInitialize(&m_cache, 4, 0));
+
+    for (uint16_t id = 0; id < 5; id++)
+    {
+        EXPECT_FALSE(Check(&m_ipv6, CA_MSG_NONCONFIRM, id));
+    }
+    EXPECT_EQ(4u, m_cache.count);
+
+    EXPECT_TRUE(Check(&m_ipv4, CA_MSG_NONCONFIRM, 4));
+    EXPECT_TRUE(Check(&m_ipv4, CA_MSG_NONCONFIRM, 1));
+    EXPECT_FALSE(Check(&m_ipv4, CA_MSG_NONCONFIRM, 0));
+}
+
+// Receives every request over IPv6 and IPv4 with 4k records kept, and reports the
+// average cost of one check.
+TEST_F(CADuplicateCacheF, CheckRate)
+{
+    using namespace std::chrono;
+    const uint16_t records = 4096;
+    const uint32_t requests = 100000;
+
+    ASSERT_EQ(CA_STATUS_OK, CADuplicateCacheInitialize(&m_cache, records, 0));
+
+    uint32_t duplicates = 0;
+    auto start = steady_clock::now();
+    for (uint32_t i = 0; i < requests; i++)
+    {
+        uint16_t id = (uint16_t)i;
+        duplicates += Check(&m_ipv6, CA_MSG_NONCONFIRM, id) ? 1 : 0;
+        duplicates += Check(&m_ipv4, CA_MSG_NONCONFIRM, id) ? 1 : 0;
+    }
+    double elapsedNs = duration<double, std::nano>(steady_clock::now() - start).count();
+
+    EXPECT_EQ(requests, duplicates);
+    EXPECT_EQ(records, m_cache.count);
+    std::cout << "records: " << records
+              << ", check (ns/packet): " << elapsedNs / (2 * requests) << std::endl;
+}
@@ -0,0 +1,342 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "cacommon.h"
+#include "caipinterface.h"
+#include "caipnwmonitor.h"
+#include "cathreadpool.h"
+
+// Sends datagrams from the IPv4 unicast socket of the IP adapter to a local socket.
+class CAIPSendF : public testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        m_savedFd = caglobals.ip.u4.fd;
+        m_savedIpv4 = caglobals.ip.ipv4enabled;
+        m_savedIpv6 = caglobals.ip.ipv6enabled;
+
+        struct sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        m_receiver = socket(AF_INET, SOCK_DGRAM, 0);
+        ASSERT_NE(-1, m_receiver);
+        ASSERT_EQ(0, bind(m_receiver, (struct sockaddr *)&addr, sizeof(addr)));
+        int size = 8 * 1024 * 1024;
+        setsockopt(m_receiver, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+        struct timeval timeout = { 0, 200000 };
+        setsockopt(m_receiver, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        socklen_t len = sizeof(addr);
+        ASSERT_EQ(0, getsockname(m_receiver, (struct sockaddr *)&addr, &len));
+
+        m_sender = socket(AF_INET, SOCK_DGRAM, 0);
+        ASSERT_NE(-1, m_sender);
+        caglobals.ip.u4.fd = m_sender;
+        caglobals.ip.ipv4enabled = true;
+        caglobals.ip.ipv6enabled = false;
+
+        memset(&m_endpoint, 0, sizeof(m_endpoint));
+        m_endpoint.adapter = CA_ADAPTER_IP;
+        m_endpoint.flags = CA_IPV4;
+        m_endpoint.port = ntohs(addr.sin_port);
+        strcpy(m_endpoint.addr, "127.0.0.1");
+    }
+
+    virtual void TearDown()
+    {
+        CAIPFlushSendData();
+        caglobals.ip.u4.fd = m_savedFd;
+        caglobals.ip.ipv4enabled = m_savedIpv4;
+        caglobals.ip.ipv6enabled = m_savedIpv6;
+        close(m_sender);
+        close(m_receiver);
+    }
+
+    // Receive until count datagrams arrived or the socket timed out.
+    size_t Receive(size_t count, uint32_t *sequence = NULL)
+    {
+        size_t received = 0;
+        uint32_t value = 0;
+        while (received < count &&
+               (ssize_t)sizeof(value) == recv(m_receiver, &value, sizeof(value), 0))
+        {
+            if (sequence)
+            {
+                sequence[received] = value;
+            }
+            received++;
+        }
+        return received;
+    }
+
+    int m_receiver = -1;
+    int m_sender = -1;
+    CASocketFd_t m_savedFd = OC_INVALID_SOCKET;
+    bool m_savedIpv4 = false;
+    bool m_savedIpv6 = false;
+    CAEndpoint_t m_endpoint;
+};
+
+TEST_F(CAIPSendF, BatchedDatagramsKeepOrder)
+{
+    const uint32_t messages = 100;
+    uint32_t sequence[messages] = {};
+
+    for (uint32_t i = 0; i < messages; i++)
+    {
+        CAIPSendDataBatched(&m_endpoint, &i, sizeof(i), false);
+    }
+    CAIPFlushSendData();
+
+    ASSERT_EQ(messages, Receive(messages, sequence));
+    for (uint32_t i = 0; i < messages; i++)
+    {
+        EXPECT_EQ(i, sequence[i]);
+    }
+}
+
+// Sends 20k datagrams with a sendto() per datagram and in batches the size of a
+// drained send queue, and reports system calls per datagram and throughput.
+TEST_F(CAIPSendF, SendBatchThroughput)
+{
+    using namespace std::chrono;
+    const uint32_t messages = 20000;
+    const uint32_t queueDepth = 64;
+
+    for (int batched = 0; batched < 2; batched++)
+    {
+        std::atomic<size_t> received(0);
+        std::thread receiver([this, &received, messages] { received = Receive(messages); });
+
+        size_t datagramsBefore = 0;
+        size_t callsBefore = 0;
+        CAIPGetSendBatchStatistics(&datagramsBefore, &callsBefore);
+
+        auto start = steady_clock::now();
+        for (uint32_t i = 0; i < messages; i++)
+        {
+            if (batched)
+            {
+                CAIPSendDataBatched(&m_endpoint, &i, sizeof(i), false);
+                if (0 == (i + 1) % queueDepth)
+                {
+                    CAIPFlushSendData();
+                }
+            }
+            else
+            {
+                CAIPSendData(&m_endpoint, &i, sizeof(i), false);
+            }
+        }
+        CAIPFlushSendData();
+        double elapsedSec = duration<double>(steady_clock::now() - start).count();
+        receiver.join();
+
+        size_t datagrams = 0;
+        size_t calls = 0;
+        CAIPGetSendBatchStatistics(&datagrams, &calls);
+        datagrams -= datagramsBefore;
+        calls -= callsBefore;
+
+        // Without sendmmsg() the batched path falls back to one sendto() per datagram.
+        double callsPerDatagram = (batched && datagrams) ? (double)calls / datagrams : 1.0;
+        EXPECT_GE(1.0, callsPerDatagram);
+
+        std::cout << (batched ? "sendmmsg" : "sendto") << ": "
+                  << "syscalls/datagram: " << callsPerDatagram
+                  << ", datagrams/sec: " << messages / elapsedSec
+                  << ", received: " << received << "/" << messages << std::endl;
+    }
+}
+
+// Receives datagrams sent from a local socket through the receive thread of the IP
+// adapter, which drains each socket with recvmmsg() when built with epoll.
+class CAIPReceiveF : public testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        m_savedIpv4 = caglobals.ip.ipv4enabled;
+        m_savedIpv6 = caglobals.ip.ipv6enabled;
+        caglobals.ip.ipv4enabled = true;
+        caglobals.ip.ipv6enabled = false;
+
+        // As initialized by the IP adapter, ephemeral unicast ports.
+        CASocket_t *sockets[] = { &caglobals.ip.u6, &caglobals.ip.u6s, &caglobals.ip.u4,
+                                  &caglobals.ip.u4s, &caglobals.ip.m6, &caglobals.ip.m6s,
+                                  &caglobals.ip.m4, &caglobals.ip.m4s };
+        for (CASocket_t *socket : sockets)
+        {
+            socket->fd = OC_INVALID_SOCKET;
+        }
+        caglobals.ip.u4.port = 0;
+        caglobals.ip.u4s.port = 0;
+
+        s_received.clear();
+        CAIPSetPacketReceiveCallback(PacketReceived);
+        ASSERT_EQ(CA_STATUS_OK, CAIPStartNetworkMonitor(AdapterStateChanged, CA_ADAPTER_IP));
+        ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(1, &m_threadPool));
+        ASSERT_EQ(CA_STATUS_OK, CAIPStartServer(m_threadPool));
+
+        struct sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        m_sender = socket(AF_INET, SOCK_DGRAM, 0);
+        ASSERT_NE(-1, m_sender);
+        ASSERT_EQ(0, bind(m_sender, (struct sockaddr *)&addr, sizeof(addr)));
+        socklen_t len = sizeof(addr);
+        ASSERT_EQ(0, getsockname(m_sender, (struct sockaddr *)&addr, &len));
+        m_senderPort = ntohs(addr.sin_port);
+    }
+
+    virtual void TearDown()
+    {
+        CAIPStopServer();
+        ca_thread_pool_free(m_threadPool);
+        CAIPStopNetworkMonitor(CA_ADAPTER_IP);
+        CAIPSetPacketReceiveCallback(NULL);
+        caglobals.ip.ipv4enabled = m_savedIpv4;
+        caglobals.ip.ipv6enabled = m_savedIpv6;
+        close(m_sender);
+    }
+
+    static void AdapterStateChanged(CATransportAdapter_t, CANetworkStatus_t)
+    {
+    }
+
+    static void PacketReceived(const CASecureEndpoint_t *sep, const void *data,
+                               size_t dataLength)
+    {
+        Datagram datagram;
+        datagram.endpoint = sep->endpoint;
+        datagram.value = 0;
+        if (sizeof(datagram.value) == dataLength)
+        {
+            memcpy(&datagram.value, data, dataLength);
+        }
+
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_received.push_back(datagram);
+        s_cond.notify_all();
+    }
+
+    void Send(uint32_t value)
+    {
+        struct sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(caglobals.ip.u4.port);
+        ASSERT_EQ((ssize_t)sizeof(value),
+                  sendto(m_sender, &value, sizeof(value), 0,
+                         (struct sockaddr *)&addr, sizeof(addr)));
+    }
+
+    // Wait until count datagrams arrived or two seconds passed.
+    size_t WaitForDatagrams(size_t count)
+    {
+        std::unique_lock<std::mutex> lock(s_mutex);
+        s_cond.wait_for(lock, std::chrono::seconds(2),
+                        [count] { return s_received.size() >= count; });
+        return s_received.size();
+    }
+
+    struct Datagram
+    {
+        CAEndpoint_t endpoint;
+        uint32_t value;
+    };
+
+    static std::mutex s_mutex;
+    static std::condition_variable s_cond;
+    static std::vector<Datagram> s_received;
+
+    ca_thread_pool_t m_threadPool = NULL;
+    int m_sender = -1;
+    uint16_t m_senderPort = 0;
+    bool m_savedIpv4 = false;
+    bool m_savedIpv6 = false;
+};
+
+std::mutex CAIPReceiveF::s_mutex;
+std::condition_variable CAIPReceiveF::s_cond;
+std::vector<CAIPReceiveF::Datagram> CAIPReceiveF::s_received;
+
+TEST_F(CAIPReceiveF, ReceivesDatagramWithSourceEndpoint)
+{
+    Send(42);
+
+    ASSERT_EQ(1u, WaitForDatagrams(1));
+    std::lock_guard<std::mutex> lock(s_mutex);
+    EXPECT_EQ(42u, s_received[0].value);
+    EXPECT_EQ(CA_ADAPTER_IP, s_received[0].endpoint.adapter);
+    EXPECT_TRUE(s_received[0].endpoint.flags & CA_IPV4);
+    EXPECT_FALSE(s_received[0].endpoint.flags & CA_MULTICAST);
+    EXPECT_STREQ("127.0.0.1", s_received[0].endpoint.addr);
+    EXPECT_EQ(m_senderPort, s_received[0].endpoint.port);
+}
+
+// More datagrams than one recvmmsg() call returns arrive before the receive thread
+// wakes up; all of them are delivered, in order, without a further event.
+TEST_F(CAIPReceiveF, ReceivesBurstInOrder)
+{
+    const uint32_t messages = 100;
+    for (uint32_t i = 0; i < messages; i++)
+    {
+        Send(i);
+    }
+
+    ASSERT_EQ(messages, WaitForDatagrams(messages));
+    std::lock_guard<std::mutex> lock(s_mutex);
+    for (uint32_t i = 0; i < messages; i++)
+    {
+        EXPECT_EQ(i, s_received[i].value);
+    }
+}
+
+// Datagrams arriving after the socket was drained raise a new event.
+TEST_F(CAIPReceiveF, ReceivesAfterDrain)
+{
+    for (uint32_t round = 0; round < 5; round++)
+    {
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            Send(round * 3 + i);
+        }
+        ASSERT_EQ((round + 1) * 3, WaitForDatagrams((round + 1) * 3));
+    }
+}
@@ -28,7 +28,9 @@
 #include <gtest/gtest.h>
 
 #include "oic_malloc.h"
+#include "oc_refcounter.h"
 #include "caprotocolmessage.h"
+#include "caremotehandler.h"
 
 namespace {
 
@@ -261,3 +263,56 @@ TEST(CAProtocolMessage, CAGetInfoFromPDU)
     coap_delete_list(options);
     coap_delete_pdu(pdu);
 }
+
+TEST(CAProtocolMessage, ReceivedPayloadIsSharedByClones)
+{
+    CAEndpoint_t tempRep;
+    memset(&tempRep, 0, sizeof(CAEndpoint_t));
+    tempRep.flags = CA_DEFAULT_FLAGS;
+    tempRep.adapter = CA_ADAPTER_IP;
+    tempRep.port = 5683;
+
+    coap_pdu_t *pdu = NULL;
+    coap_list_t *options = NULL;
+    coap_transport_t transport = COAP_UDP;
+
+    CAInfo_t inData;
+    memset(&inData, 0, sizeof(CAInfo_t));
+    inData.token = (CAToken_t)"token";
+    inData.tokenLength = (uint8_t)strlen(inData.token);
+    inData.type = CA_MSG_NONCONFIRM;
+    inData.payload = (CAPayload_t) "requestPayload";
+    inData.payloadSize = strlen((const char *) inData.payload);
+    inData.payloadFormat = CA_FORMAT_APPLICATION_CBOR;
+
+    pdu = CAGeneratePDU(CA_PUT, &inData, &tempRep, &options, &transport);
+    ASSERT_TRUE(NULL != pdu);
+
+    CARequestInfo_t *received = (CARequestInfo_t *) OICCalloc(1, sizeof(CARequestInfo_t));
+    ASSERT_TRUE(NULL != received);
+    EXPECT_EQ(CA_STATUS_OK, CAGetRequestInfoFromPDU(pdu, &tempRep, received));
+    coap_delete_list(options);
+    coap_delete_pdu(pdu);
+
+    // the received payload outlives the pdu it was copied from
+    ASSERT_TRUE(NULL != received->info.payloadRef);
+    ASSERT_EQ(inData.payloadSize, received->info.payloadSize);
+    EXPECT_EQ(0, memcmp(inData.payload, received->info.payload, inData.payloadSize));
+    EXPECT_EQ(1, oc_refcounter_get_count(received->info.payloadRef));
+
+    // clones share the buffer instead of copying it
+    CARequestInfo_t *clone = CACloneRequestInfo(received);
+    ASSERT_TRUE(NULL != clone);
+    EXPECT_EQ(received->info.payload, clone->info.payload);
+    EXPECT_EQ(received->info.payloadRef, clone->info.payloadRef);
+    EXPECT_EQ(2, oc_refcounter_get_count(received->info.payloadRef));
+
+    oc_refcounter ref = oc_refcounter_inc(received->info.payloadRef);
+    CADestroyRequestInfoInternal(received);
+    EXPECT_EQ(2, oc_refcounter_get_count(ref));
+    EXPECT_EQ(0, memcmp(inData.payload, clone->info.payload, inData.payloadSize));
+
+    CADestroyRequestInfoInternal(clone);
+    EXPECT_EQ(1, oc_refcounter_get_count(ref));
+    EXPECT_TRUE(NULL == oc_refcounter_dec(ref));
+}
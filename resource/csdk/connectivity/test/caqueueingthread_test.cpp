@@ -0,0 +1,229 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "caqueueingthread.h"
+#include "oic_malloc.h"
+
+struct QueueTestData
+{
+    uint32_t producer;
+    uint32_t sequence;
+};
+
+static const uint32_t MAX_PRODUCERS = 8;
+static uint32_t g_next[MAX_PRODUCERS];
+static std::atomic<uint32_t> g_processed(0);
+static std::atomic<bool> g_ordered(true);
+
+static void OrderCheckingTask(void *threadData)
+{
+    QueueTestData *data = (QueueTestData *) threadData;
+    if (g_next[data->producer]++ != data->sequence)
+    {
+        g_ordered = false;
+    }
+    g_processed++;
+}
+
+static void SlowTask(void *threadData)
+{
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+    OrderCheckingTask(threadData);
+}
+
+static void DestroyTestData(void *data, uint32_t /*size*/)
+{
+    OICFree(data);
+}
+
+class CAQueueingThreadF : public testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        memset(g_next, 0, sizeof(g_next));
+        g_processed = 0;
+        g_ordered = true;
+        ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(1, &m_threadPool));
+    }
+
+    virtual void TearDown()
+    {
+        if (m_initialized)
+        {
+            EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadStop(&m_thread));
+            EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadDestroy(&m_thread));
+        }
+        ca_thread_pool_free(m_threadPool);
+    }
+
+    void Initialize(CAThreadTask task)
+    {
+        ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadInitialize(&m_thread, m_threadPool, task,
+                                                           DestroyTestData));
+        m_initialized = true;
+    }
+
+    static CAResult_t Add(CAQueueingThread_t *thread, uint32_t producer, uint32_t sequence)
+    {
+        QueueTestData *data = (QueueTestData *) OICMalloc(sizeof(QueueTestData));
+        data->producer = producer;
+        data->sequence = sequence;
+        return CAQueueingThreadAddData(thread, data, sizeof(QueueTestData));
+    }
+
+    void WaitForProcessed(uint32_t count)
+    {
+        auto limit = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+        while (g_processed < count && std::chrono::steady_clock::now() < limit)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    ca_thread_pool_t m_threadPool = NULL;
+    CAQueueingThread_t m_thread;
+    bool m_initialized = false;
+};
+
+TEST_F(CAQueueingThreadF, TakeDataWithoutThread)
+{
+    Initialize(OrderCheckingTask);
+
+    EXPECT_FALSE(CAQueueingThreadHasData(&m_thread));
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        ASSERT_EQ(CA_STATUS_OK, Add(&m_thread, 0, i));
+    }
+
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        EXPECT_TRUE(CAQueueingThreadHasData(&m_thread));
+        uint32_t size = 0;
+        QueueTestData *data = (QueueTestData *) CAQueueingThreadTakeData(&m_thread, &size);
+        ASSERT_TRUE(NULL != data);
+        EXPECT_EQ(sizeof(QueueTestData), size);
+        EXPECT_EQ(i, data->sequence);
+        OICFree(data);
+    }
+    EXPECT_FALSE(CAQueueingThreadHasData(&m_thread));
+}
+
+static bool IsOddSequence(void *data, uint32_t /*size*/, void * /*ctx*/)
+{
+    return 0 != (((QueueTestData *) data)->sequence % 2);
+}
+
+TEST_F(CAQueueingThreadF, ClearContextData)
+{
+    Initialize(OrderCheckingTask);
+
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        ASSERT_EQ(CA_STATUS_OK, Add(&m_thread, 0, i));
+    }
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadClearContextData(&m_thread, IsOddSequence, NULL));
+
+    for (uint32_t i = 0; i < 1000; i += 2)
+    {
+        uint32_t size = 0;
+        QueueTestData *data = (QueueTestData *) CAQueueingThreadTakeData(&m_thread, &size);
+        ASSERT_TRUE(NULL != data);
+        EXPECT_EQ(i, data->sequence);
+        OICFree(data);
+    }
+    EXPECT_FALSE(CAQueueingThreadHasData(&m_thread));
+}
+
+// A slow consumer lets the queue overflow. Data of each producer is still
+// processed in the order it was added.
+TEST_F(CAQueueingThreadF, OverflowKeepsOrder)
+{
+    const uint32_t producers = 4;
+    const uint32_t perProducer = 2000;
+
+    Initialize(SlowTask);
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadStart(&m_thread));
+
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < producers; p++)
+    {
+        threads.push_back(std::thread([this, p, perProducer] {
+            for (uint32_t i = 0; i < perProducer; i++)
+            {
+                EXPECT_EQ(CA_STATUS_OK, Add(&m_thread, p, i));
+            }
+        }));
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    WaitForProcessed(producers * perProducer);
+    EXPECT_EQ(producers * perProducer, g_processed);
+    EXPECT_TRUE(g_ordered);
+}
+
+// Reports the cost of adding data from several producers and of handing it
+// to the queueing thread.
+TEST_F(CAQueueingThreadF, Throughput)
+{
+    using namespace std::chrono;
+    const uint32_t producers = 4;
+    const uint32_t perProducer = 100000;
+
+    Initialize(OrderCheckingTask);
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadStart(&m_thread));
+
+    auto start = steady_clock::now();
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < producers; p++)
+    {
+        threads.push_back(std::thread([this, p, perProducer] {
+            for (uint32_t i = 0; i < perProducer; i++)
+            {
+                Add(&m_thread, p, i);
+            }
+        }));
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    double addSec = duration<double>(steady_clock::now() - start).count();
+
+    WaitForProcessed(producers * perProducer);
+    double totalSec = duration<double>(steady_clock::now() - start).count();
+
+    EXPECT_EQ(producers * perProducer, g_processed);
+    EXPECT_TRUE(g_ordered);
+    std::cout << "producers: " << producers
+              << ", add (ns/item): " << addSec * 1e9 / (producers * perProducer)
+              << ", items/sec: " << (producers * perProducer) / totalSec << std::endl;
+}
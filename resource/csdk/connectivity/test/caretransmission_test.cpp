@@ -0,0 +1,239 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "caretransmission.h"
+#include "cathreadpool.h"
+#include "oic_malloc.h"
+
+static std::atomic<int> g_sentCount(0);
+static std::atomic<int> g_timeoutCount(0);
+
+static CAResult_t CountingSendMethod(const CAEndpoint_t *, const void *, uint32_t, CADataType_t)
+{
+    g_sentCount++;
+    return CA_STATUS_OK;
+}
+
+static void CountingTimeoutCallback(const CAEndpoint_t *, const void *, uint32_t)
+{
+    g_timeoutCount++;
+}
+
+// CoAP header without token, options or payload.
+static void MakeHeader(uint8_t *pdu, CAMessageType_t type, uint8_t code, uint16_t messageId)
+{
+    pdu[0] = (uint8_t)(0x40 | (type << 4));
+    pdu[1] = code;
+    pdu[2] = (uint8_t)(messageId >> 8);
+    pdu[3] = (uint8_t)(messageId & 0xFF);
+}
+
+class CARetransmissionF : public testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        g_sentCount = 0;
+        g_timeoutCount = 0;
+
+        memset(&m_endpoint, 0, sizeof(m_endpoint));
+        m_endpoint.adapter = CA_ADAPTER_IP;
+        m_endpoint.port = 5683;
+        strcpy(m_endpoint.addr, "192.168.0.1");
+
+        ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(1, &m_threadPool));
+    }
+
+    virtual void TearDown()
+    {
+        if (m_started)
+        {
+            EXPECT_EQ(CA_STATUS_OK, CARetransmissionStop(&m_context));
+            EXPECT_EQ(CA_STATUS_OK, CARetransmissionDestroy(&m_context));
+        }
+        ca_thread_pool_free(m_threadPool);
+    }
+
+    void Start(uint8_t tryingCount)
+    {
+        CARetransmissionConfig_t config = { CA_ADAPTER_IP, tryingCount };
+        ASSERT_EQ(CA_STATUS_OK, CARetransmissionInitialize(&m_context, m_threadPool,
+                                                           CountingSendMethod,
+                                                           CountingTimeoutCallback,
+                                                           &config));
+        ASSERT_EQ(CA_STATUS_OK, CARetransmissionStart(&m_context));
+        m_started = true;
+    }
+
+    CAResult_t SendCon(uint16_t messageId)
+    {
+        uint8_t pdu[4];
+        MakeHeader(pdu, CA_MSG_CONFIRM, 0x01, messageId);
+        return CARetransmissionSentData(&m_context, &m_endpoint, CA_REQUEST_DATA,
+                                        pdu, sizeof(pdu));
+    }
+
+    CAResult_t ReceiveAck(uint16_t messageId, uint8_t code, void **retransmissionPdu)
+    {
+        uint8_t pdu[4];
+        MakeHeader(pdu, CA_MSG_ACKNOWLEDGE, code, messageId);
+        return CARetransmissionReceivedData(&m_context, &m_endpoint, pdu, sizeof(pdu),
+                                            retransmissionPdu);
+    }
+
+    ca_thread_pool_t m_threadPool = NULL;
+    CARetransmission_t m_context;
+    CAEndpoint_t m_endpoint;
+    bool m_started = false;
+};
+
+TEST_F(CARetransmissionF, AckRemovesData)
+{
+    Start(DEFAULT_RETRANSMISSION_COUNT);
+
+    EXPECT_EQ(CA_STATUS_OK, SendCon(1));
+    EXPECT_EQ(CA_STATUS_OK, SendCon(2));
+    EXPECT_EQ(2u, m_context.dataCount);
+
+    void *retransmissionPdu = NULL;
+    EXPECT_EQ(CA_STATUS_OK, ReceiveAck(1, 0x45, &retransmissionPdu));
+    EXPECT_TRUE(NULL == retransmissionPdu);
+    EXPECT_EQ(1u, m_context.dataCount);
+
+    // Unknown message id is ignored.
+    EXPECT_EQ(CA_STATUS_OK, ReceiveAck(3, 0x45, &retransmissionPdu));
+    EXPECT_EQ(1u, m_context.dataCount);
+}
+
+TEST_F(CARetransmissionF, EmptyAckReturnsSentPdu)
+{
+    Start(DEFAULT_RETRANSMISSION_COUNT);
+
+    EXPECT_EQ(CA_STATUS_OK, SendCon(0x1234));
+
+    void *retransmissionPdu = NULL;
+    EXPECT_EQ(CA_STATUS_OK, ReceiveAck(0x1234, 0x00, &retransmissionPdu));
+    ASSERT_TRUE(NULL != retransmissionPdu);
+
+    uint8_t expected[4];
+    MakeHeader(expected, CA_MSG_CONFIRM, 0x01, 0x1234);
+    EXPECT_EQ(0, memcmp(expected, retransmissionPdu, sizeof(expected)));
+    EXPECT_EQ(0u, m_context.dataCount);
+    OICFree(retransmissionPdu);
+}
+
+TEST_F(CARetransmissionF, DuplicateMessageIdFails)
+{
+    Start(DEFAULT_RETRANSMISSION_COUNT);
+
+    EXPECT_EQ(CA_STATUS_OK, SendCon(7));
+    EXPECT_EQ(CA_STATUS_FAILED, SendCon(7));
+    EXPECT_EQ(1u, m_context.dataCount);
+}
+
+TEST_F(CARetransmissionF, NonConfirmableIsNotStored)
+{
+    Start(DEFAULT_RETRANSMISSION_COUNT);
+
+    uint8_t pdu[4];
+    MakeHeader(pdu, CA_MSG_NONCONFIRM, 0x01, 9);
+    EXPECT_EQ(CA_NOT_SUPPORTED, CARetransmissionSentData(&m_context, &m_endpoint,
+                                                         CA_REQUEST_DATA, pdu, sizeof(pdu)));
+    EXPECT_EQ(0u, m_context.dataCount);
+}
+
+TEST_F(CARetransmissionF, TimeoutAfterTryingCount)
+{
+    const int messages = 100;
+    Start(1);
+
+    for (int id = 0; id < messages; id++)
+    {
+        EXPECT_EQ(CA_STATUS_OK, SendCon(id));
+    }
+
+    // Acknowledged messages are neither retransmitted nor timed out.
+    for (int id = 0; id < messages; id += 2)
+    {
+        void *retransmissionPdu = NULL;
+        EXPECT_EQ(CA_STATUS_OK, ReceiveAck(id, 0x45, &retransmissionPdu));
+    }
+
+    // The first timeout is between DEFAULT_ACK_TIMEOUT_SEC and 1.5 times that.
+    auto limit = std::chrono::steady_clock::now() +
+                 std::chrono::seconds(2 * DEFAULT_ACK_TIMEOUT_SEC);
+    while (messages / 2 > g_timeoutCount && std::chrono::steady_clock::now() < limit)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    EXPECT_EQ(messages / 2, g_sentCount);
+    EXPECT_EQ(messages / 2, g_timeoutCount);
+    EXPECT_EQ(0u, m_context.dataCount);
+}
+
+// Keeps 10k CON messages outstanding, then acknowledges them in random order, and
+// reports the average cost of storing and of acknowledging one message.
+TEST_F(CARetransmissionF, OutstandingConMessages)
+{
+    using namespace std::chrono;
+    const uint16_t messages = 10000;
+
+    Start(DEFAULT_RETRANSMISSION_COUNT);
+
+    auto start = steady_clock::now();
+    for (uint16_t id = 0; id < messages; id++)
+    {
+        ASSERT_EQ(CA_STATUS_OK, SendCon(id));
+    }
+    double sentUs = duration<double, std::micro>(steady_clock::now() - start).count();
+    EXPECT_EQ(messages, m_context.dataCount);
+
+    std::vector<uint16_t> ids(messages);
+    for (uint16_t id = 0; id < messages; id++)
+    {
+        ids[id] = id;
+    }
+    std::shuffle(ids.begin(), ids.end(), std::mt19937(messages));
+
+    start = steady_clock::now();
+    for (uint16_t id : ids)
+    {
+        void *retransmissionPdu = NULL;
+        ASSERT_EQ(CA_STATUS_OK, ReceiveAck(id, 0x45, &retransmissionPdu));
+    }
+    double ackUs = duration<double, std::micro>(steady_clock::now() - start).count();
+    EXPECT_EQ(0u, m_context.dataCount);
+    EXPECT_EQ(0, g_sentCount);
+
+    std::cout << "outstanding CON messages: " << messages
+              << ", sent (us/msg): " << sentUs / messages
+              << ", ACK (us/msg): " << ackUs / messages << std::endl;
+}
@@ -0,0 +1,293 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "cacommon.h"
+#include "catcpinterface.h"
+#include "cathreadpool.h"
+
+// Connects sessions of the TCP adapter to a local listening socket. The listening
+// socket is bound to the wildcard address, so every 127.0.0.x address reaches it and
+// each address gives a distinct remote endpoint.
+class CATCPSessionF : public testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        m_savedTimeout = caglobals.tcp.selectTimeout;
+        caglobals.tcp.selectTimeout = 1;
+
+        // As initialized by the TCP adapter, ephemeral accept ports.
+        CASocket_t *sockets[] = { &caglobals.tcp.ipv4, &caglobals.tcp.ipv4s,
+                                  &caglobals.tcp.ipv6, &caglobals.tcp.ipv6s };
+        for (CASocket_t *socket : sockets)
+        {
+            socket->fd = OC_INVALID_SOCKET;
+            socket->port = 0;
+        }
+
+        ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(1, &m_threadPool));
+        ASSERT_EQ(CA_STATUS_OK, CATCPStartServer(m_threadPool));
+
+        struct sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        m_listener = socket(AF_INET, SOCK_STREAM, 0);
+        ASSERT_NE(-1, m_listener);
+        // Inherited by accepted sockets, so that the peers take little data.
+        int size = 4096;
+        setsockopt(m_listener, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+        ASSERT_EQ(0, bind(m_listener, (struct sockaddr *)&addr, sizeof(addr)));
+        ASSERT_EQ(0, listen(m_listener, 128));
+        socklen_t len = sizeof(addr);
+        ASSERT_EQ(0, getsockname(m_listener, (struct sockaddr *)&addr, &len));
+        m_port = ntohs(addr.sin_port);
+    }
+
+    virtual void TearDown()
+    {
+        CATCPStopServer();
+        ca_thread_pool_free(m_threadPool);
+        caglobals.tcp.selectTimeout = m_savedTimeout;
+        for (int peer : m_peers)
+        {
+            close(peer);
+        }
+        close(m_listener);
+    }
+
+    CAEndpoint_t Endpoint(int host)
+    {
+        CAEndpoint_t endpoint = {};
+        endpoint.adapter = CA_ADAPTER_TCP;
+        endpoint.flags = CA_IPV4;
+        endpoint.port = m_port;
+        snprintf(endpoint.addr, sizeof(endpoint.addr), "127.0.0.%d", host);
+        return endpoint;
+    }
+
+    // Connect a session to the endpoint and accept the connection.
+    int Connect(const CAEndpoint_t &endpoint)
+    {
+        if (OC_INVALID_SOCKET == CAConnectTCPSession(&endpoint))
+        {
+            return -1;
+        }
+        int peer = accept(m_listener, NULL, NULL);
+        if (-1 != peer)
+        {
+            struct timeval timeout = { 2, 0 };
+            setsockopt(peer, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            m_peers.push_back(peer);
+        }
+        return peer;
+    }
+
+    // Read a stream of counters written by Send() and check that it continues from next.
+    static bool Receive(int peer, uint32_t &next, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            uint32_t value = 0;
+            if ((ssize_t)sizeof(value) != recv(peer, &value, sizeof(value), MSG_WAITALL)
+                || value != next)
+            {
+                return false;
+            }
+            next++;
+        }
+        return true;
+    }
+
+    // Send count counters starting from next as a single message.
+    static ssize_t Send(CAEndpoint_t &endpoint, uint32_t &next, size_t count)
+    {
+        std::vector<uint32_t> data(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            data[i] = next++;
+        }
+        return CATCPSendData(&endpoint, data.data(), count * sizeof(uint32_t));
+    }
+
+    ca_thread_pool_t m_threadPool = NULL;
+    int m_listener = -1;
+    uint16_t m_port = 0;
+    std::vector<int> m_peers;
+    int m_savedTimeout = 0;
+};
+
+// More sessions than the initial size of the session tables: every session is found
+// by its endpoint after the tables grew, and removing sessions leaves the others.
+TEST_F(CATCPSessionF, SessionTableFindsAndRemovesSessions)
+{
+    const int sessions = 40;
+    for (int host = 1; host <= sessions; host++)
+    {
+        ASSERT_NE(-1, Connect(Endpoint(host)));
+    }
+
+    std::set<CASocketFd_t> fds;
+    for (int host = 1; host <= sessions; host++)
+    {
+        CAEndpoint_t endpoint = Endpoint(host);
+        CASocketFd_t fd = CAGetSocketFDFromEndpoint(&endpoint);
+        EXPECT_NE(OC_INVALID_SOCKET, fd);
+        fds.insert(fd);
+    }
+    EXPECT_EQ((size_t)sessions, fds.size());
+
+    CAEndpoint_t other = Endpoint(sessions + 1);
+    EXPECT_EQ(OC_INVALID_SOCKET, CAGetSocketFDFromEndpoint(&other));
+    other = Endpoint(1);
+    other.port++;
+    EXPECT_EQ(OC_INVALID_SOCKET, CAGetSocketFDFromEndpoint(&other));
+
+    for (int host = 2; host <= sessions; host += 2)
+    {
+        CAEndpoint_t endpoint = Endpoint(host);
+        EXPECT_EQ(CA_STATUS_OK, CASearchAndDeleteTCPSession(&endpoint));
+    }
+    for (int host = 1; host <= sessions; host++)
+    {
+        CAEndpoint_t endpoint = Endpoint(host);
+        CASocketFd_t fd = CAGetSocketFDFromEndpoint(&endpoint);
+        if (host % 2)
+        {
+            EXPECT_NE(OC_INVALID_SOCKET, fd);
+            oc_refcounter ref = CAGetTCPSessionInfoRefCountedFromEndpoint(&endpoint);
+            ASSERT_TRUE(NULL != ref);
+            CATCPSessionInfo_t *session = (CATCPSessionInfo_t *) oc_refcounter_get_data(ref);
+            EXPECT_EQ(fd, session->fd);
+            EXPECT_STREQ(endpoint.addr, session->sep.endpoint.addr);
+            oc_refcounter_dec(ref);
+        }
+        else
+        {
+            EXPECT_EQ(OC_INVALID_SOCKET, fd);
+            EXPECT_TRUE(NULL == CAGetTCPSessionInfoRefCountedFromEndpoint(&endpoint));
+        }
+    }
+}
+
+// The peer does not read while more data is sent than the sockets take. The rest is
+// buffered by the adapter and sent in order once the peer reads.
+TEST_F(CATCPSessionF, SendBufferKeepsOrder)
+{
+    CAEndpoint_t endpoint = Endpoint(1);
+    int peer = Connect(endpoint);
+    ASSERT_NE(-1, peer);
+    int size = 4096;
+    setsockopt(CAGetSocketFDFromEndpoint(&endpoint), SOL_SOCKET, SO_SNDBUF,
+               &size, sizeof(size));
+
+    const size_t messages = 64;
+    const size_t counters = 1024;
+    uint32_t sent = 0;
+    for (size_t i = 0; i < messages; i++)
+    {
+        ASSERT_EQ((ssize_t)(counters * sizeof(uint32_t)), Send(endpoint, sent, counters));
+    }
+
+    uint32_t received = 0;
+    EXPECT_TRUE(Receive(peer, received, messages * counters));
+    EXPECT_EQ(sent, received);
+
+    // Sent directly again once the buffer drained.
+    ASSERT_EQ((ssize_t)(counters * sizeof(uint32_t)), Send(endpoint, sent, counters));
+    EXPECT_TRUE(Receive(peer, received, counters));
+}
+
+// Sending fails once the data the peer does not read exceeds the send buffer limit.
+TEST_F(CATCPSessionF, SendBufferIsBounded)
+{
+    CAEndpoint_t endpoint = Endpoint(1);
+    ASSERT_NE(-1, Connect(endpoint));
+
+    const size_t counters = 16 * 1024;
+    uint32_t sent = 0;
+    bool failed = false;
+    // 64 MiB, well above the limit and the socket buffers.
+    for (size_t i = 0; i < 1024 && !failed; i++)
+    {
+        failed = (-1 == Send(endpoint, sent, counters));
+    }
+    EXPECT_TRUE(failed);
+}
+
+// Sessions are written from several threads at once while their peers read. Each
+// peer receives the stream of its session complete and in order.
+TEST_F(CATCPSessionF, ParallelSendsToSessions)
+{
+    const int sessions = 4;
+    const size_t messages = 256;
+    const size_t counters = 256;
+
+    std::vector<CAEndpoint_t> endpoints;
+    std::vector<int> peers;
+    for (int host = 1; host <= sessions; host++)
+    {
+        endpoints.push_back(Endpoint(host));
+        peers.push_back(Connect(endpoints.back()));
+        ASSERT_NE(-1, peers.back());
+    }
+
+    std::vector<std::thread> threads;
+    std::vector<int> sendFailures(sessions, 0);
+    std::vector<int> receiveFailures(sessions, 0);
+    for (int i = 0; i < sessions; i++)
+    {
+        threads.emplace_back([&, i] {
+            uint32_t sent = 0;
+            for (size_t m = 0; m < messages; m++)
+            {
+                if ((ssize_t)(counters * sizeof(uint32_t)) != Send(endpoints[i], sent, counters))
+                {
+                    sendFailures[i]++;
+                }
+            }
+        });
+        threads.emplace_back([&, i] {
+            uint32_t received = 0;
+            receiveFailures[i] = !Receive(peers[i], received, messages * counters);
+        });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (int i = 0; i < sessions; i++)
+    {
+        EXPECT_EQ(0, sendFailures[i]) << "session " << i;
+        EXPECT_EQ(0, receiveFailures[i]) << "session " << i;
+    }
+}
@@ -0,0 +1,135 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "umpscqueue.h"
+
+TEST(UMpscQueue, CapacityIsPowerOfTwo)
+{
+    u_mpsc_queue_t *queue = u_mpsc_queue_create(100);
+    ASSERT_TRUE(queue != NULL);
+    EXPECT_EQ(128u, queue->capacity);
+    u_mpsc_queue_delete(queue);
+}
+
+TEST(UMpscQueue, PopInOrder)
+{
+    u_mpsc_queue_t *queue = u_mpsc_queue_create(8);
+    ASSERT_TRUE(queue != NULL);
+
+    int values[5] = { 0, 1, 2, 3, 4 };
+    EXPECT_TRUE(u_mpsc_queue_is_empty(queue));
+    for (int i = 0; i < 5; i++)
+    {
+        EXPECT_TRUE(u_mpsc_queue_push(queue, &values[i], i));
+    }
+    EXPECT_FALSE(u_mpsc_queue_is_empty(queue));
+
+    u_queue_message_t messages[3];
+    ASSERT_EQ(3u, u_mpsc_queue_pop(queue, messages, 3));
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        EXPECT_EQ(&values[i], messages[i].msg);
+        EXPECT_EQ(i, messages[i].size);
+    }
+    ASSERT_EQ(2u, u_mpsc_queue_pop(queue, messages, 3));
+    EXPECT_EQ(&values[3], messages[0].msg);
+    EXPECT_EQ(&values[4], messages[1].msg);
+
+    EXPECT_EQ(0u, u_mpsc_queue_pop(queue, messages, 3));
+    EXPECT_TRUE(u_mpsc_queue_is_empty(queue));
+
+    u_mpsc_queue_delete(queue);
+}
+
+TEST(UMpscQueue, FullQueueRejectsPush)
+{
+    u_mpsc_queue_t *queue = u_mpsc_queue_create(4);
+    ASSERT_TRUE(queue != NULL);
+
+    int value = 0;
+    for (int round = 0; round < 3; round++)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            EXPECT_TRUE(u_mpsc_queue_push(queue, &value, 0));
+        }
+        EXPECT_FALSE(u_mpsc_queue_push(queue, &value, 0));
+
+        u_queue_message_t messages[4];
+        EXPECT_EQ(4u, u_mpsc_queue_pop(queue, messages, 4));
+    }
+
+    u_mpsc_queue_delete(queue);
+}
+
+TEST(UMpscQueue, ProducersKeepOrder)
+{
+    const uint32_t producers = 4;
+    const uint32_t perProducer = 20000;
+
+    u_mpsc_queue_t *queue = u_mpsc_queue_create(64);
+    ASSERT_TRUE(queue != NULL);
+
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < producers; p++)
+    {
+        threads.push_back(std::thread([queue, p, perProducer] {
+            for (uint32_t i = 0; i < perProducer; i++)
+            {
+                while (!u_mpsc_queue_push(queue, (void *)(uintptr_t)(i + 1), p))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+
+    std::vector<uintptr_t> next(producers, 1);
+    uint32_t received = 0;
+    bool ordered = true;
+    u_queue_message_t messages[16];
+    while (received < producers * perProducer)
+    {
+        uint32_t count = u_mpsc_queue_pop(queue, messages, 16);
+        if (0 == count)
+        {
+            std::this_thread::yield();
+        }
+        for (uint32_t i = 0; i < count; i++)
+        {
+            ordered = ordered && (next[messages[i].size]++ == (uintptr_t)messages[i].msg);
+        }
+        received += count;
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(u_mpsc_queue_is_empty(queue));
+
+    u_mpsc_queue_delete(queue);
+}
@@ -1176,6 +1176,34 @@ typedef void * OCRequestHandle;
  */
 typedef uint8_t OCObservationId;
 
+/**
+ * Callback to iterate over the observation IDs to notify with ::OCNotifyObservers.
+ *
+ * @param context         Context passed to ::OCNotifyObservers.
+ * @param observationId   Set to the next observation ID.
+ *
+ * @return true if observationId was set, false if there are no more IDs.
+ */
+typedef bool (*OCObservationIdIterator)(void *context, OCObservationId *observationId);
+
+/**
+ * Policy for notifying the observers of a resource, set with ::OCSetResourceNotificationPolicy.
+ * Notifications held back by the policy are sent from ::OCProcess.
+ */
+typedef struct
+{
+    /** Minimum time in milliseconds between two notifications, 0 for no limit. */
+    uint32_t minInterval;
+
+    /** Time in milliseconds a notification is held back to batch it with later changes,
+     *  0 to send it as soon as minInterval allows. */
+    uint32_t maxDelay;
+
+    /** Merge the notifications held back into one. The observers get the latest
+     *  representation only, instead of one notification per change. */
+    bool latestOnly;
+} OCNotificationPolicy;
+
 /**
  * Sequence number is a 24 bit field,
  * per https://tools.ietf.org/html/rfc7641.
@@ -1910,6 +1938,27 @@ typedef OCEntityHandlerResult (*OCEntityHandler)
 typedef OCEntityHandlerResult (*OCDeviceEntityHandler)
 (OCEntityHandlerFlag flag, OCEntityHandlerRequest * entityHandlerRequest, char* uri, void* callbackParam);
 
+/**
+ * Statistics of the cache of the responses to discovery (/oic/res) requests.
+ * The hits, misses and invalidations counters start at 0 when the stack is
+ * initialized, and wrap around after UINT32_MAX.
+ */
+typedef struct
+{
+    /** Number of discovery requests answered from the cache. */
+    uint32_t hits;
+
+    /** Number of discovery responses built because they were not cached. */
+    uint32_t misses;
+
+    /** Number of times the cache was invalidated by a change of the resources,
+     *  the device or the network interfaces. */
+    uint32_t invalidations;
+
+    /** Number of responses in the cache. */
+    size_t entries;
+} OCDiscoveryCacheStats;
+
 #if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
 /**
  * Callback function definition for Change in TrustCertChain
@@ -0,0 +1,82 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+/**
+ * @file
+ *
+ * This file contains the index of the ACEs of the ACL used by the Policy Engine.
+ * The ACEs are found by subject (UUID, role or conntype) and resource href in a hash
+ * table, the ACEs with a wildcard resource being kept under their subject alone.
+ * The index is rebuilt from the ACL on the first lookup after InvalidateACLIndex,
+ * which is also called when /cred or /pstat change so that the Policy Engine can
+ * drop the access decisions it cached.
+ */
+
+#ifndef IOTVT_SRM_ACL_INDEX_H
+#define IOTVT_SRM_ACL_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "experimental/securevirtualresourcetypes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Invalidates the index and the access decisions which depend on the ACL, /cred or
+ * /pstat. It may be called from any thread, the index is rebuilt by the next lookup.
+ */
+void InvalidateACLIndex(void);
+
+/**
+ * Gets the number of times InvalidateACLIndex was called, which identifies the state
+ * of the ACL, /cred and /pstat the access decisions were made in.
+ *
+ * @return the generation of the index.
+ */
+uint32_t GetACLIndexGeneration(void);
+
+/**
+ * Gets the ACEs of an ACL which have a subject and include a resource href.
+ *
+ * @param aces List of ACEs of the ACL.
+ * @param subject ACE whose subjectType and subject are looked up.
+ * @param href href of the resource, or NULL for the ACEs which include a wildcard
+ *             resource.
+ * @param result Set to the ACEs, in the order of the ACL. The array is valid until the
+ *               index is invalidated.
+ *
+ * @return the number of ACEs.
+ */
+size_t GetACLIndexAces(const OicSecAce_t *aces, const OicSecAce_t *subject, const char *href,
+                       const OicSecAce_t * const **result);
+
+/**
+ * Releases the index.
+ */
+void DeInitACLIndex(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //IOTVT_SRM_ACL_INDEX_H
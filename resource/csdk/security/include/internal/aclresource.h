@@ -84,6 +84,21 @@ const OicSecAce_t* GetACLResourceDataByRoles(const OicSecRole_t *roles, size_t r
  */
 const OicSecAce_t* GetACLResourceDataByConntype(const OicSecConntype_t conntype, OicSecAce_t **savePtr);
 
+/**
+ * This method is used by PolicyEngine to retrieve the ACEs of a subject which include
+ * a resource, without walking the ACL.
+ *
+ * @param[in] subject ACE whose subjectType and subject (UUID, role or conntype) to match.
+ * @param[in] href href of the resource to match, or NULL to retrieve the ACEs which
+ *                 include a wildcard resource.
+ * @param[out] aces set to the matching ACEs, in the order of the ACL. The array is valid
+ *                  until the ACL changes.
+ *
+ * @return the number of matching ACEs.
+ */
+size_t GetACLResourceDataByHref(const OicSecAce_t *subject, const char *href,
+                                const OicSecAce_t * const **aces);
+
 /**
  * This function converts ACL data into CBOR format.
  *
@@ -29,6 +29,14 @@
 #include <stdlib.h>
 #include <stdint.h>
 
+/**
+ * Number of access decisions cached by the Policy Engine, the least recently used is
+ * dropped first.
+ */
+#ifndef ACL_DECISION_CACHE_SIZE
+#define ACL_DECISION_CACHE_SIZE (16)
+#endif
+
 /**
  * Check whether a request should be allowed.
  *
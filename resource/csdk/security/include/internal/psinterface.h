@@ -49,6 +49,21 @@ OCStackResult ReadDatabaseFromPS(const char *databaseName, const char *resourceN
  */
 OCStackResult UpdateResourceInPS(const char *databaseName, const char *resourceName, const uint8_t *payload, size_t size);
 
+/**
+ * This method starts a transaction, in which the updates of the databases are kept in
+ * memory and read back by ReadDatabaseFromPS. Each database updated in the transaction
+ * is written once by the matching EndPSTransaction. Transactions may be nested.
+ */
+void BeginPSTransaction(void);
+
+/**
+ * This method ends a transaction started by BeginPSTransaction. Ending the outermost
+ * transaction writes the updated databases to PS.
+ *
+ * @return ::OC_STACK_OK for Success, otherwise some error value
+ */
+OCStackResult EndPSTransaction(void);
+
 /**
  * Reads the Secure Virtual Database from PS into dynamically allocated
  * memory buffer.
@@ -66,7 +66,7 @@ class SRP : public ::testing::Test
             ClientCB *tmp = NULL;
             LL_FOREACH_SAFE(g_cbList, out, tmp)
             {
-                LL_DELETE(g_cbList, out);
+                DeleteClientCB(out);
             }
 
             OicSecCred_t *cred = NULL;
@@ -0,0 +1,310 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <string.h>
+
+#include "utlist.h"
+#include "oic_malloc.h"
+#include "ocatomic.h"
+#include "experimental/logger.h"
+#include "aclindex.h"
+
+#define TAG "OIC_SRM_ACL_INDEX"
+
+/** Minimum number of buckets of the index, a power of 2. */
+#define ACL_INDEX_MIN_BUCKETS (16)
+
+#define FNV_OFFSET_BASIS (2166136261u)
+#define FNV_PRIME (16777619u)
+
+typedef struct AclIndexEntry
+{
+    /** Next entry of the bucket. */
+    struct AclIndexEntry *next;
+
+    uint32_t hash;
+
+    /** First ACE of the entry, holding its subject. */
+    const OicSecAce_t *subject;
+
+    /** href of the resource, or NULL for the ACEs with a wildcard resource. */
+    const char *href;
+
+    /** ACEs of the entry, in the order of the ACL. */
+    const OicSecAce_t **aces;
+    size_t count;
+    size_t capacity;
+} AclIndexEntry;
+
+static AclIndexEntry **g_buckets = NULL;
+static size_t g_bucketCount = 0;
+
+/** ACL and generation the index was built for. */
+static const OicSecAce_t *g_indexedAces = NULL;
+static uint32_t g_indexedGeneration = 0;
+static bool g_indexed = false;
+
+/** Incremented by InvalidateACLIndex, from any thread. */
+static volatile int32_t g_generation = 0;
+
+static uint32_t HashBytes(uint32_t hash, const void *data, size_t size)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+static uint32_t HashKey(const OicSecAce_t *subject, const char *href)
+{
+    uint8_t type = (uint8_t)subject->subjectType;
+    uint32_t hash = HashBytes(FNV_OFFSET_BASIS, &type, sizeof(type));
+
+    switch (subject->subjectType)
+    {
+        case OicSecAceUuidSubject:
+            hash = HashBytes(hash, subject->subjectuuid.id, sizeof(subject->subjectuuid.id));
+            break;
+        case OicSecAceRoleSubject:
+            // Include the terminators so that ("ab", "c") and ("a", "bc") differ.
+            hash = HashBytes(hash, subject->subjectRole.id,
+                             strnlen(subject->subjectRole.id, ROLEID_LENGTH - 1) + 1);
+            hash = HashBytes(hash, subject->subjectRole.authority,
+                             strnlen(subject->subjectRole.authority, ROLEAUTHORITY_LENGTH - 1) + 1);
+            break;
+        case OicSecAceConntypeSubject:
+        {
+            uint8_t conntype = (uint8_t)subject->subjectConn;
+            hash = HashBytes(hash, &conntype, sizeof(conntype));
+            break;
+        }
+        default:
+            break;
+    }
+
+    if (href)
+    {
+        hash = HashBytes(hash, href, strlen(href) + 1);
+    }
+    return hash;
+}
+
+static bool IsSameSubject(const OicSecAce_t *ace, const OicSecAce_t *subject)
+{
+    if (ace->subjectType != subject->subjectType)
+    {
+        return false;
+    }
+
+    switch (subject->subjectType)
+    {
+        case OicSecAceUuidSubject:
+            return (0 == memcmp(&ace->subjectuuid, &subject->subjectuuid, sizeof(OicUuid_t)));
+        case OicSecAceRoleSubject:
+            return (0 == strncmp(ace->subjectRole.id, subject->subjectRole.id, ROLEID_LENGTH)) &&
+                   (0 == strncmp(ace->subjectRole.authority, subject->subjectRole.authority,
+                                 ROLEAUTHORITY_LENGTH));
+        case OicSecAceConntypeSubject:
+            return (ace->subjectConn == subject->subjectConn);
+        default:
+            return false;
+    }
+}
+
+static AclIndexEntry *FindEntry(uint32_t hash, const OicSecAce_t *subject, const char *href)
+{
+    AclIndexEntry *entry = g_buckets[hash & (g_bucketCount - 1)];
+    for (; entry; entry = entry->next)
+    {
+        if ((entry->hash == hash) &&
+            IsSameSubject(entry->subject, subject) &&
+            ((!entry->href && !href) ||
+             (entry->href && href && (0 == strcmp(entry->href, href)))))
+        {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static void FreeIndex(void)
+{
+    for (size_t i = 0; i < g_bucketCount; i++)
+    {
+        AclIndexEntry *entry = g_buckets[i];
+        while (entry)
+        {
+            AclIndexEntry *next = entry->next;
+            OICFree((void *)entry->aces);
+            OICFree(entry);
+            entry = next;
+        }
+    }
+    OICFree(g_buckets);
+    g_buckets = NULL;
+    g_bucketCount = 0;
+    g_indexedAces = NULL;
+    g_indexed = false;
+}
+
+static bool AddAce(const OicSecAce_t *ace, const char *href)
+{
+    uint32_t hash = HashKey(ace, href);
+    AclIndexEntry *entry = FindEntry(hash, ace, href);
+    if (!entry)
+    {
+        entry = (AclIndexEntry *)OICCalloc(1, sizeof(AclIndexEntry));
+        if (!entry)
+        {
+            return false;
+        }
+        entry->hash = hash;
+        entry->subject = ace;
+        entry->href = href;
+        size_t bucket = hash & (g_bucketCount - 1);
+        entry->next = g_buckets[bucket];
+        g_buckets[bucket] = entry;
+    }
+    else if (entry->aces[entry->count - 1] == ace)
+    {
+        // The ACE lists the resource twice.
+        return true;
+    }
+
+    if (entry->count == entry->capacity)
+    {
+        size_t capacity = entry->capacity ? (2 * entry->capacity) : 1;
+        const OicSecAce_t **aces = (const OicSecAce_t **)OICRealloc((void *)entry->aces,
+                                                                    capacity * sizeof(*aces));
+        if (!aces)
+        {
+            return false;
+        }
+        entry->aces = aces;
+        entry->capacity = capacity;
+    }
+    entry->aces[entry->count++] = ace;
+    return true;
+}
+
+static bool BuildIndex(const OicSecAce_t *aces)
+{
+    // One bucket per resource of the ACL.
+    size_t resourceCount = 0;
+    const OicSecAce_t *ace = NULL;
+    const OicSecRsrc_t *rsrc = NULL;
+    LL_FOREACH(aces, ace)
+    {
+        LL_FOREACH(ace->resources, rsrc)
+        {
+            resourceCount++;
+        }
+    }
+
+    size_t bucketCount = ACL_INDEX_MIN_BUCKETS;
+    while (bucketCount < resourceCount)
+    {
+        bucketCount *= 2;
+    }
+    g_buckets = (AclIndexEntry **)OICCalloc(bucketCount, sizeof(AclIndexEntry *));
+    if (!g_buckets)
+    {
+        return false;
+    }
+    g_bucketCount = bucketCount;
+
+    LL_FOREACH(aces, ace)
+    {
+        bool wildcard = false;
+        LL_FOREACH(ace->resources, rsrc)
+        {
+            if (rsrc->href)
+            {
+                if (!AddAce(ace, rsrc->href))
+                {
+                    return false;
+                }
+            }
+            else if ((NO_WILDCARD != rsrc->wildcard) && !wildcard)
+            {
+                if (!AddAce(ace, NULL))
+                {
+                    return false;
+                }
+                wildcard = true;
+            }
+        }
+    }
+
+    OIC_LOG_V(DEBUG, TAG, "%s: indexed %zu resources in %zu buckets", __func__,
+              resourceCount, bucketCount);
+    return true;
+}
+
+void InvalidateACLIndex(void)
+{
+    oc_atomic_increment(&g_generation);
+}
+
+uint32_t GetACLIndexGeneration(void)
+{
+    return (uint32_t)g_generation;
+}
+
+size_t GetACLIndexAces(const OicSecAce_t *aces, const OicSecAce_t *subject, const char *href,
+                       const OicSecAce_t * const **result)
+{
+    if ((NULL == subject) || (NULL == result))
+    {
+        return 0;
+    }
+    *result = NULL;
+
+    uint32_t generation = GetACLIndexGeneration();
+    if (!g_indexed || (g_indexedGeneration != generation) || (g_indexedAces != aces))
+    {
+        FreeIndex();
+        if (!BuildIndex(aces))
+        {
+            OIC_LOG(ERROR, TAG, "Failed to build the ACL index");
+            FreeIndex();
+            return 0;
+        }
+        g_indexedAces = aces;
+        g_indexedGeneration = generation;
+        g_indexed = true;
+    }
+
+    AclIndexEntry *entry = FindEntry(HashKey(subject, href), subject, href);
+    if (!entry)
+    {
+        return 0;
+    }
+    *result = entry->aces;
+    return entry->count;
+}
+
+void DeInitACLIndex(void)
+{
+    FreeIndex();
+}
@@ -38,6 +38,7 @@
 #include "experimental/payload_logging.h"
 #include "srmresourcestrings.h"
 #include "aclresource.h"
+#include "aclindex.h"
 #include "experimental/doxmresource.h"
 #include "rolesresource.h"
 #include "resourcemanager.h"
@@ -2257,6 +2258,8 @@ OCStackResult RemoveACE(const OicUuid_t *subject, const char *resource)
 
     if (deleteFlag)
     {
+        InvalidateACLIndex();
+
         // In case of unit test do not update persistant storage.
         if (memcmp(subject->id, &WILDCARD_SUBJECT_B64_ID, sizeof(subject->id)) == 0)
         {
@@ -2319,6 +2322,8 @@ static OCStackResult RemoveAceByAceIds(AceIdList_t *aceIdList)
 
     if (deleteFlag)
     {
+        InvalidateACLIndex();
+
         uint8_t *payload = NULL;
         size_t size = 0;
         if (OC_STACK_OK == AclToCBORPayload(gAcl, OIC_SEC_ACL_V2, &payload, &size))
@@ -2750,6 +2755,7 @@ static OCStackResult RemoveAllAce(const char *resource)
                 FreeACE(aceItem);
             }
         }
+        InvalidateACLIndex();
 
         //Generate empty ACL payload
         ret = AclToCBORPayload(gAcl, OIC_SEC_ACL_V2, &payload, &size);
@@ -2776,6 +2782,7 @@ static OCStackResult RemoveAllAce(const char *resource)
                 {
                     DeleteACLList(gAcl);
                     gAcl = originAcl;
+                    InvalidateACLIndex();
                 }
                 else
                 {
@@ -2907,6 +2914,9 @@ static OCEntityHandlerResult HandleACLPostRequest(const OCEntityHandlerRequest *
     OIC_LOG(INFO, TAG, "HandleACLPostRequest processing the request");
     OCEntityHandlerResult ehRet = OC_EH_INTERNAL_SERVER_ERROR;
 
+    // Write the databases updated by the request once, before responding.
+    BeginPSTransaction();
+
     // Convert CBOR into ACL data and update to SVR buffers. This will also validate the ACL data received.
     uint8_t *payload = ((OCSecurityPayload *) ehRequest->payload)->securityData;
     size_t size = ((OCSecurityPayload *) ehRequest->payload)->payloadSize;
@@ -2973,6 +2983,7 @@ static OCEntityHandlerResult HandleACLPostRequest(const OCEntityHandlerRequest *
                         OIC_LOG(DEBUG, TAG, "Prepending new ACE:");
                         OIC_LOG_ACE(DEBUG, insertAce);
                         LL_PREPEND(gAcl->aces, insertAce);
+                        InvalidateACLIndex();
                     }
                     else
                     {
@@ -3004,6 +3015,10 @@ static OCEntityHandlerResult HandleACLPostRequest(const OCEntityHandlerRequest *
     }
 
 exit:
+    if ((OC_STACK_OK != EndPSTransaction()) && (OC_EH_OK == ehRet))
+    {
+        ehRet = OC_EH_ERROR;
+    }
 
     //Send response to request originator
     ehRet = ((SendSRMResponse(ehRequest, ehRet, NULL, 0)) == OC_STACK_OK) ?
@@ -3021,6 +3036,9 @@ static OCEntityHandlerResult HandleACL2PostRequest(const OCEntityHandlerRequest
     VERIFY_NOT_NULL_RETURN(TAG, ehRequest, ERROR, OC_EH_ERROR);
     VERIFY_NOT_NULL_RETURN(TAG, ehRequest->payload, ERROR, OC_EH_ERROR);
 
+    // Write the databases updated by the request once, before responding.
+    BeginPSTransaction();
+
     // Convert CBOR into ACL data and update to SVR buffers. This will also validate the ACL data received.
     uint8_t *payload = ((OCSecurityPayload *) ehRequest->payload)->securityData;
     size_t size = ((OCSecurityPayload *) ehRequest->payload)->payloadSize;
@@ -3083,6 +3101,7 @@ static OCEntityHandlerResult HandleACL2PostRequest(const OCEntityHandlerRequest
                             //remove old ace with the same aceid
                             LL_DELETE(gAcl->aces, existAce);
                             FreeACE(existAce);
+                            InvalidateACLIndex();
                             break;
                         }
                     }
@@ -3097,6 +3116,7 @@ static OCEntityHandlerResult HandleACL2PostRequest(const OCEntityHandlerRequest
                     OIC_LOG(DEBUG, TAG, "Prepending new ACE:");
                     OIC_LOG_ACE(DEBUG, insertAce);
                     LL_PREPEND(gAcl->aces, insertAce);
+                    InvalidateACLIndex();
                 }
                 else
                 {
@@ -3127,6 +3147,10 @@ static OCEntityHandlerResult HandleACL2PostRequest(const OCEntityHandlerRequest
     }
 
 exit:
+    if ((OC_STACK_OK != EndPSTransaction()) && (OC_EH_OK == ehRet))
+    {
+        ehRet = OC_EH_ERROR;
+    }
 
     //Send response to request originator
     ehRet = ((SendSRMResponse(ehRequest, ehRet, NULL, 0)) == OC_STACK_OK) ?
@@ -3301,6 +3325,7 @@ static OCStackResult CreateACLResource(void)
 OCStackResult SetDefaultACL(OicSecAcl_t *acl)
 {
     gAcl = acl;
+    InvalidateACLIndex();
     return OC_STACK_OK;
 }
 
@@ -3521,6 +3546,7 @@ OCStackResult InitACLResource(void)
         // TODO Needs to update persistent storage
     }
     VERIFY_NOT_NULL(TAG, gAcl, FATAL);
+    InvalidateACLIndex();
 
     // Instantiate 'oic.sec.acl'
     ret = CreateACLResource();
@@ -3545,6 +3571,8 @@ OCStackResult DeInitACLResource(void)
         DeleteACLList(gAcl);
         gAcl = NULL;
     }
+    InvalidateACLIndex();
+    DeInitACLIndex();
 
     oc_mutex_free(g_AceIdCounterMutex);
     g_AceIdCounterMutex = NULL;
@@ -3723,6 +3751,17 @@ const OicSecAce_t* GetACLResourceDataByConntype(const OicSecConntype_t conntype,
     return NULL;
 }
 
+size_t GetACLResourceDataByHref(const OicSecAce_t *subject, const char *href,
+                                const OicSecAce_t * const **aces)
+{
+    if ((NULL == subject) || (NULL == aces) || (NULL == gAcl))
+    {
+        return 0;
+    }
+
+    return GetACLIndexAces(gAcl->aces, subject, href, aces);
+}
+
 OCStackResult AppendACLObject(const OicSecAcl_t* acl)
 {
     OCStackResult ret = OC_STACK_ERROR;
@@ -3747,6 +3786,7 @@ OCStackResult AppendACLObject(const OicSecAcl_t* acl)
     {
         gAcl->aces = acl->aces;
     }
+    InvalidateACLIndex();
 
     OIC_LOG_ACL(INFO, gAcl);
 
@@ -3992,6 +4032,7 @@ OCStackResult UpdateDefaultSecProvACE(void)
                     LL_DELETE(gAcl->aces, ace);
                     FreeACE(ace);
                     isRemoved = true;
+                    InvalidateACLIndex();
                 }
             }
         }
@@ -4008,6 +4049,7 @@ OCStackResult UpdateDefaultSecProvACE(void)
             if (secDefaultAce)
             {
                 LL_APPEND(gAcl->aces, secDefaultAce);
+                InvalidateACLIndex();
 
                 size_t size = 0;
                 uint8_t *payload = NULL;
@@ -58,6 +58,7 @@
 #include "ocstackinternal.h"
 #include "deviceonboardingstate.h"
 #include "mbedtls_messages.h"
+#include "aclindex.h"
 
 #ifdef __unix__
 #include <sys/types.h>
@@ -1511,6 +1512,11 @@ static bool UpdatePersistentStorage(const OicSecCred_t *cred)
     bool ret = false;
     OIC_LOG(DEBUG, TAG, "IN Cred UpdatePersistentStorage");
 
+    // The access decisions cached by the Policy Engine depend on /cred.
+    InvalidateACLIndex();
+    // Resumed TLS sessions skip the verification against the credentials.
+    CAflushSslSessions();
+
     // Convert Cred data into JSON for update to persistent storage
     if (cred)
     {
@@ -2465,6 +2471,9 @@ static OCEntityHandlerResult HandlePostRequest(OCEntityHandlerRequest* ehRequest
     uint8_t *payload = (((OCSecurityPayload*)ehRequest->payload)->securityData);
     size_t size = (((OCSecurityPayload*)ehRequest->payload)->payloadSize);
 
+    // Write the databases updated by the request once, before responding.
+    BeginPSTransaction();
+
     OicSecDostype_t dos;
     VERIFY_SUCCESS(TAG, OC_STACK_OK == GetDos(&dos), ERROR);
     if ((DOS_RESET == dos.state) ||
@@ -2530,6 +2539,11 @@ exit:
         }
     }
 
+    if ((OC_STACK_OK != EndPSTransaction()) && (OC_EH_CHANGED == ret))
+    {
+        ret = OC_EH_ERROR;
+    }
+
     // Send response to request originator
     ret = ((SendSRMResponse(ehRequest, ret, NULL, 0)) == OC_STACK_OK) ?
                    OC_EH_OK : OC_EH_ERROR;
@@ -2753,6 +2767,7 @@ OCStackResult InitCredResource(void)
     {
         gCred = GetCredDefault();
     }
+    InvalidateACLIndex();
 
     if (gCred)
     {
@@ -2816,6 +2831,7 @@ OCStackResult DeInitCredResource(void)
         DeleteCredList(gCred);
         gCred = NULL;
     }
+    InvalidateACLIndex();
     return result;
 }
 
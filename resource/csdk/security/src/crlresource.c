@@ -21,6 +21,7 @@
 #include "utlist.h"
 #include "crl_logging.h"
 #include "experimental/payload_logging.h"
+#include "casecurityinterface.h"
 #include "psinterface.h"
 #include "resourcemanager.h"
 #include "srmresourcestrings.h"
@@ -447,6 +448,9 @@ OCStackResult UpdateCRLResource(OicSecCrl_t *crl)
         return OC_STACK_ERROR;
     }
 
+    // Resumed TLS sessions skip the revocation check of the peer certificate.
+    CAflushSslSessions();
+
     char currentTime[32] = {0};
     getCurrentUTCTime(currentTime, sizeof(currentTime));
 
@@ -1574,6 +1574,9 @@ static OCEntityHandlerResult HandleDoxmPostRequest(OCEntityHandlerRequest *ehReq
     uint8_t *payload = NULL;
     OCStackResult res = OC_STACK_OK;
 
+    // Write the databases updated by the request once, before responding.
+    BeginPSTransaction();
+
     VERIFY_NOT_NULL(TAG, ehRequest, ERROR);
     VERIFY_NOT_NULL(TAG, ehRequest->payload, ERROR);
     VERIFY_NOT_NULL(TAG, gDoxm, ERROR);
@@ -1642,6 +1645,10 @@ static OCEntityHandlerResult HandleDoxmPostRequest(OCEntityHandlerRequest *ehReq
     ehRet = HandleDoxmPostRequestUpdatePS(fACE);
 
 exit:
+    if ((OC_STACK_OK != EndPSTransaction()) && (OC_EH_OK == ehRet))
+    {
+        ehRet = OC_EH_ERROR;
+    }
 
     //Send payload to request originator
     ehRet = ((SendSRMResponse(ehRequest, ehRet, NULL, 0)) == OC_STACK_OK) ?
@@ -22,12 +22,14 @@
 
 #include "utlist.h"
 #include "oic_malloc.h"
+#include "oic_string.h"
 #include "experimental/ocrandom.h"
 #include "policyengine.h"
 #include "resourcemanager.h"
 #include "srmresourcestrings.h"
 #include "experimental/logger.h"
 #include "aclresource.h"
+#include "aclindex.h"
 #include "srmutility.h"
 #include "experimental/doxmresource.h"
 #include "iotvticalendar.h"
@@ -691,10 +693,133 @@ static void ProcessMatchingACE(SRMRequestContext_t *context, const OicSecAce_t *
     }
 }
 
+/**
+ * Access decision of ProcessAccessRequest, for the request properties it depends on.
+ */
+typedef struct AclDecision
+{
+    bool                    valid;
+    uint32_t                generation;                         // ACL index generation
+    uint64_t                lastUsed;
+    OicUuid_t               subjectUuid;
+    char                    resourceUri[MAX_URI_LENGTH + 1];
+    uint16_t                requestedPermission;
+    bool                    secureChannel;
+    OicSecDiscoverable_t    discoverable;
+    bool                    resourceIsOcSecure;
+    bool                    resourceIsOcNonsecure;
+    SRMAccessResponse_t     responseVal;
+} AclDecision_t;
+
+static AclDecision_t g_aclDecisions[ACL_DECISION_CACHE_SIZE];
+static uint64_t g_aclDecisionClock = 0;
+static uint64_t g_aclDecisionHits = 0;
+static uint64_t g_aclDecisionMisses = 0;
+
+static bool IsSameRequest(const AclDecision_t *decision, const SRMRequestContext_t *context)
+{
+    return (decision->requestedPermission == context->requestedPermission) &&
+           (decision->secureChannel == context->secureChannel) &&
+           (decision->discoverable == context->discoverable) &&
+           (decision->resourceIsOcSecure == context->resourceIsOcSecure) &&
+           (decision->resourceIsOcNonsecure == context->resourceIsOcNonsecure) &&
+           (0 == memcmp(&decision->subjectUuid, &context->subjectUuid, sizeof(OicUuid_t))) &&
+           (0 == strcmp(decision->resourceUri, context->resourceUri));
+}
+
+/**
+ * Look up the access decision made for an identical request since the ACL last changed.
+ *
+ * @return true if context->responseVal was set from the cache.
+ */
+static bool GetCachedAccessDecision(SRMRequestContext_t *context, uint32_t generation)
+{
+    for (size_t i = 0; i < ACL_DECISION_CACHE_SIZE; i++)
+    {
+        AclDecision_t *decision = &g_aclDecisions[i];
+        if (decision->valid && (decision->generation == generation) &&
+            IsSameRequest(decision, context))
+        {
+            decision->lastUsed = ++g_aclDecisionClock;
+            context->responseVal = decision->responseVal;
+            g_aclDecisionHits++;
+            return true;
+        }
+    }
+    g_aclDecisionMisses++;
+    return false;
+}
+
+/**
+ * Cache an access decision in place of a decision of a previous generation, or else of
+ * the least recently used decision.
+ */
+static void CacheAccessDecision(const SRMRequestContext_t *context, uint32_t generation)
+{
+    AclDecision_t *target = &g_aclDecisions[0];
+    for (size_t i = 0; i < ACL_DECISION_CACHE_SIZE; i++)
+    {
+        AclDecision_t *decision = &g_aclDecisions[i];
+        if (!decision->valid || (decision->generation != generation))
+        {
+            target = decision;
+            break;
+        }
+        if (decision->lastUsed < target->lastUsed)
+        {
+            target = decision;
+        }
+    }
+
+    target->valid = true;
+    target->generation = generation;
+    target->lastUsed = ++g_aclDecisionClock;
+    memcpy(&target->subjectUuid, &context->subjectUuid, sizeof(OicUuid_t));
+    OICStrcpy(target->resourceUri, sizeof(target->resourceUri), context->resourceUri);
+    target->requestedPermission = context->requestedPermission;
+    target->secureChannel = context->secureChannel;
+    target->discoverable = context->discoverable;
+    target->resourceIsOcSecure = context->resourceIsOcSecure;
+    target->resourceIsOcNonsecure = context->resourceIsOcNonsecure;
+    target->responseVal = context->responseVal;
+}
+
+/**
+ * Check the ACEs of a subject which include the requested resource, by href and then
+ * by wildcard, until one grants permission.
+ *
+ * @param[in,out] context Request context, whose responseVal is updated.
+ * @param[in] subject ACE holding the subject to match.
+ * @param[out] timeDependent set to true if an ACE with validity periods was checked.
+ */
+static void ProcessSubjectACEs(SRMRequestContext_t *context, const OicSecAce_t *subject,
+                               bool *timeDependent)
+{
+    const char *hrefs[] = { context->resourceUri, NULL };
+    for (size_t h = 0; (h < sizeof(hrefs) / sizeof(hrefs[0])) &&
+                       !IsAccessGranted(context->responseVal); h++)
+    {
+        const OicSecAce_t * const *aces = NULL;
+        size_t count = GetACLResourceDataByHref(subject, hrefs[h], &aces);
+        for (size_t i = 0; (i < count) && !IsAccessGranted(context->responseVal); i++)
+        {
+            if (NULL != aces[i]->validities)
+            {
+                *timeDependent = true;
+            }
+            ProcessMatchingACE(context, aces[i]);
+        }
+    }
+}
+
 /**
  * Search for an ACE that matches the Resource URI, by conntype, subjectuuid, or roles.
  * For each matching ACE, check whether it grants permission.
  * If any ACE grants permission, set responseVal to ACCESS_GRANTED.
+ *
+ * The ACEs are looked up in the ACL index. The decision is cached until the ACL, /cred
+ * or /pstat change, unless it depends on the time of the request or on the roles
+ * asserted by the endpoint.
  */
 static void ProcessAccessRequest(SRMRequestContext_t *context)
 {
@@ -706,95 +831,72 @@ static void ProcessAccessRequest(SRMRequestContext_t *context)
 
     OIC_LOG_V(DEBUG, TAG, "Entering %s(%s)", __func__, context->resourceUri);
 
-    const OicSecAce_t *currentAce = NULL;
-    OicSecAce_t *aceSavePtr = NULL;
+    uint32_t generation = GetACLIndexGeneration();
+    if (GetCachedAccessDecision(context, generation))
+    {
+        OIC_LOG_V(INFO, TAG, "%s: returning with cached responseVal = %s", __func__,
+            IsAccessGranted(context->responseVal) ? "ACCESS_GRANTED" : "ACCESS_DENIED");
+        return;
+    }
+
+    bool timeDependent = false;
+    bool dependsOnRoles = false;
+    OicSecAce_t subject;
+    memset(&subject, 0, sizeof(subject));
 
     // Start out assuming subject not found.
     context->responseVal = ACCESS_DENIED_SUBJECT_NOT_FOUND;
 
     // First, check for a conntype ACE that matches.
-    OicSecConntype_t conntype;
-    if (context->secureChannel)
-    {
-        conntype = AUTH_CRYPT;
-    }
-    else
-    {
-        conntype = ANON_CLEAR;
-    }
-    do
-    {
-        currentAce = GetACLResourceDataByConntype(conntype, &aceSavePtr);
-
-        if (NULL != currentAce)
-        {
-            OIC_LOG_V(DEBUG, TAG, "%s: found conntype %s match; processing for access.",
-                __func__, (AUTH_CRYPT == conntype?"auth-crypt":"anon-clear"));
-            ProcessMatchingACE(context, currentAce);
-        }
-        else
-        {
-            OIC_LOG_V(INFO, TAG, "%s:no ACL found matching conntype %s for resource %s",
-                __func__, (AUTH_CRYPT == conntype?"auth-crypt":"anon-clear"), context->resourceUri);
-        }
-    } while ((NULL != currentAce) && !IsAccessGranted(context->responseVal));
+    subject.subjectType = OicSecAceConntypeSubject;
+    subject.subjectConn = context->secureChannel ? AUTH_CRYPT : ANON_CLEAR;
+    ProcessSubjectACEs(context, &subject, &timeDependent);
 
     // If not granted via conntype, try Subject-based match.
     if (!IsAccessGranted(context->responseVal))
     {
-        currentAce = NULL;
-        aceSavePtr = NULL;
-        do
-        {
-            currentAce = GetACLResourceData(&context->subjectUuid, &aceSavePtr);
-
-            if (NULL != currentAce)
-            {
-                ProcessMatchingACE(context, currentAce);
-            }
-            else
-            {
-                OIC_LOG_V(INFO, TAG, "%s:no ACL found matching subject for resource %s",
-                    __func__, context->resourceUri);
-            }
-        } while ((NULL != currentAce) && !IsAccessGranted(context->responseVal));
+        memset(&subject, 0, sizeof(subject));
+        subject.subjectType = OicSecAceUuidSubject;
+        memcpy(&subject.subjectuuid, &context->subjectUuid, sizeof(OicUuid_t));
+        ProcessSubjectACEs(context, &subject, &timeDependent);
     }
 
 #if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
     // If no subject ACE granted access, try role ACEs.
     if (!IsAccessGranted(context->responseVal))
     {
-        currentAce = NULL;
-        aceSavePtr = NULL;
+        // Roles are asserted over secure channels, and are not part of the cached decision.
+        dependsOnRoles = context->secureChannel;
+
         OicSecRole_t *roles = NULL;
         size_t roleCount = 0;
         OCStackResult res = GetEndpointRoles(context->endPoint, &roles, &roleCount);
         if (OC_STACK_OK != res)
         {
             OIC_LOG_V(ERROR, TAG, "Error getting asserted roles for endpoint: %d", res);
+            dependsOnRoles = true;
         }
         else
         {
             OIC_LOG_V(DEBUG, TAG, "Found %u asserted roles for endpoint", (unsigned int) roleCount);
-            do
+            for (size_t i = 0; (i < roleCount) && !IsAccessGranted(context->responseVal); i++)
             {
-                currentAce = GetACLResourceDataByRoles(roles, roleCount, &aceSavePtr);
-                if (NULL != currentAce)
-                {
-                    ProcessMatchingACE(context, currentAce);
-                }
-                else
-                {
-                    OIC_LOG_V(INFO, TAG, "%s:no ACL found matching roles for resource %s",
-                        __func__, context->resourceUri);
-                }
-            } while ((NULL != currentAce) && !IsAccessGranted(context->responseVal));
+                memset(&subject, 0, sizeof(subject));
+                subject.subjectType = OicSecAceRoleSubject;
+                memcpy(&subject.subjectRole, &roles[i], sizeof(OicSecRole_t));
+                ProcessSubjectACEs(context, &subject, &timeDependent);
+            }
 
             OICFree(roles);
         }
     }
 #endif /* defined(__WITH_DTLS__) || defined(__WITH_TLS__) */
 
+    if (!timeDependent && !dependsOnRoles)
+    {
+        CacheAccessDecision(context, generation);
+    }
+
     OIC_LOG_V(INFO, TAG, "%s: returning with responseVal = %s", __func__,
         IsAccessGranted(context->responseVal) ? "ACCESS_GRANTED" : "ACCESS_DENIED");
     return;
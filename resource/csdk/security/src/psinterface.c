@@ -28,6 +28,7 @@
 #include "ocpayloadcbor.h"
 #include "ocstack.h"
 #include "oic_malloc.h"
+#include "oic_string.h"
 #include "experimental/payload_logging.h"
 #include "resourcemanager.h"
 #include "secureresourcemanager.h"
@@ -54,11 +55,38 @@
 const size_t DB_FILE_SIZE_BLOCK = 1023;
 #endif
 
-typedef enum _PSDatabase
+/**
+ * Maximum number of resources kept in a database.
+ */
+#define PS_MAX_RESOURCES 8
+
+/**
+ * Resource stored in a database.
+ */
+typedef struct PSRecord
 {
-    PS_DATABASE_SECURITY = 0,
-    PS_DATABASE_DEVICEPROPERTIES
-} PSDatabase;
+    char *name;
+    uint8_t *payload;
+    size_t size;
+    struct PSRecord *next;
+} PSRecord;
+
+/**
+ * Resources of a database, held in memory while a transaction is in progress.
+ */
+typedef struct PSImage
+{
+    char *databaseName;
+    PSRecord *records;
+    bool modified;
+    struct PSImage *next;
+} PSImage;
+
+/** Images of the databases accessed in the current transaction. */
+static PSImage *g_psImages = NULL;
+
+/** Number of nested transactions in progress. */
+static size_t g_psTransactionDepth = 0;
 
 /**
  * Writes CBOR payload to the specified database in persistent storage.
@@ -139,28 +167,215 @@ static size_t GetDatabaseSize(const OCPersistentStorage *ps, const char *databas
 }
 
 /**
- * Reads the database from PS
+ * Gets the names of the resources kept in a database. The other resources found in
+ * the database are dropped when it is updated.
+ *
+ * @param databaseName is the name of the database.
+ * @param names        is set to the names of the resources.
+ *
+ * @return the number of names.
+ */
+static size_t GetDatabaseResourceNames(const char *databaseName, const char *names[PS_MAX_RESOURCES])
+{
+    size_t count = 0;
+    if (0 == strcmp(OC_DEVICE_PROPS_FILE_NAME, databaseName))
+    {
+        names[count++] = OC_JSON_DEVICE_PROPS_NAME;
+    }
+    else
+    {
+        names[count++] = OIC_JSON_ACL_NAME;
+        names[count++] = OIC_JSON_PSTAT_NAME;
+        names[count++] = OIC_JSON_DOXM_NAME;
+        names[count++] = OIC_JSON_AMACL_NAME;
+        names[count++] = OIC_JSON_CRED_NAME;
+        names[count++] = OIC_JSON_RESET_PF_NAME;
+        names[count++] = OIC_JSON_CRL_NAME;
+        names[count++] = OIC_JSON_SP_NAME;
+    }
+    return count;
+}
+
+static void FreeRecords(PSRecord *records)
+{
+    while (records)
+    {
+        PSRecord *next = records->next;
+        OICFree(records->name);
+        OICFree(records->payload);
+        OICFree(records);
+        records = next;
+    }
+}
+
+static void FreeImage(PSImage *image)
+{
+    if (image)
+    {
+        FreeRecords(image->records);
+        OICFree(image->databaseName);
+        OICFree(image);
+    }
+}
+
+static PSRecord *FindRecord(const PSImage *image, const char *resourceName)
+{
+    for (PSRecord *record = image->records; record; record = record->next)
+    {
+        if (0 == strcmp(record->name, resourceName))
+        {
+            return record;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Sets the resources of an image from the CBOR map of a database.
+ *
+ * @param image is the image to set.
+ * @param data  is the content of the database, or NULL if the database is empty.
+ * @param size  is the size of data.
+ *
+ * @return ::OC_STACK_OK for Success, otherwise some error value
+ */
+static OCStackResult ParseImage(PSImage *image, const uint8_t *data, size_t size)
+{
+    OCStackResult ret = OC_STACK_ERROR;
+    PSRecord *records = NULL;
+    PSRecord **tail = &records;
+    const char *names[PS_MAX_RESOURCES];
+    size_t count = GetDatabaseResourceNames(image->databaseName, names);
+
+    if (data && size)
+    {
+        CborParser parser;  // will be initialized in |cbor_parser_init|
+        CborValue cbor;     // will be initialized in |cbor_parser_init|
+        cbor_parser_init(data, size, 0, &parser, &cbor);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            CborValue curVal = OC_DEFAULT_CBOR_VALUE;
+            CborError cborFindResult = cbor_value_map_find_value(&cbor, names[i], &curVal);
+            if ((CborNoError != cborFindResult) || !cbor_value_is_byte_string(&curVal))
+            {
+                continue;
+            }
+
+            PSRecord *record = (PSRecord *)OICCalloc(1, sizeof(PSRecord));
+            VERIFY_NOT_NULL(TAG, record, ERROR);
+            *tail = record;
+            tail = &record->next;
+            record->name = OICStrdup(names[i]);
+            VERIFY_NOT_NULL(TAG, record->name, ERROR);
+
+            cborFindResult = cbor_value_dup_byte_string(&curVal, &record->payload, &record->size, NULL);
+            if ((CborNoError != cborFindResult) && (0 == strcmp(OIC_JSON_CRL_NAME, names[i])))
+            {
+                // The CRL is optional.
+                OIC_LOG(ERROR, TAG, "Failed Finding optional CRL Name Value.");
+                record->payload = NULL;
+                record->size = 0;
+                continue;
+            }
+            VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborFindResult, "Failed Finding Resource Value.");
+            VERIFY_NOT_NULL(TAG, record->payload, ERROR);
+        }
+    }
+
+    // Drop the records left empty, such as a CRL which failed to parse.
+    for (PSRecord **link = &records; *link;)
+    {
+        if (!(*link)->size)
+        {
+            PSRecord *record = *link;
+            *link = record->next;
+            record->next = NULL;
+            FreeRecords(record);
+        }
+        else
+        {
+            link = &(*link)->next;
+        }
+    }
+
+    FreeRecords(image->records);
+    image->records = records;
+    records = NULL;
+    ret = OC_STACK_OK;
+
+exit:
+    FreeRecords(records);
+    return ret;
+}
+
+/**
+ * Encodes the resources of an image into the CBOR map of a database.
  *
  * @note Caller of this method MUST use OICFree() method to release memory
  *       referenced by the data argument.
  *
- * @param databaseName is the name of the database to access through persistent storage.
- * @param resourceName is the name of the field for which file content are read.
- *                     if the value is NULL it will send the content of the whole file.
- * @param data         is the pointer to the file contents read from the database.
- * @param size         is the size of the file contents read.
+ * @param image is the image to encode.
+ * @param data  is set to the content of the database.
+ * @param size  is set to the size of data.
  *
  * @return ::OC_STACK_OK for Success, otherwise some error value
  */
-OCStackResult ReadDatabaseFromPS(const char *databaseName, const char *resourceName, uint8_t **data, size_t *size)
+static OCStackResult EncodeImage(const PSImage *image, uint8_t **data, size_t *size)
 {
-    OIC_LOG(DEBUG, TAG, "ReadDatabaseFromPS IN");
+    OCStackResult ret = OC_STACK_ERROR;
+    int64_t cborEncoderResult = CborNoError;
+    uint8_t *outPayload = NULL;
 
-    if (!databaseName || !data || *data || !size)
+    size_t allocSize = CBOR_ENCODING_SIZE_ADDITION;
+    for (const PSRecord *record = image->records; record; record = record->next)
     {
-        return OC_STACK_INVALID_PARAM;
+        allocSize += strlen(record->name) + record->size + CBOR_ENCODING_SIZE_ADDITION;
     }
 
+    outPayload = (uint8_t *)OICCalloc(1, allocSize);
+    VERIFY_NOT_NULL(TAG, outPayload, ERROR);
+    CborEncoder encoder;  // will be initialized in |cbor_parser_init|
+    cbor_encoder_init(&encoder, outPayload, allocSize, 0);
+    CborEncoder resource;  // will be initialized in |cbor_encoder_create_map|
+    cborEncoderResult |= cbor_encoder_create_map(&encoder, &resource, CborIndefiniteLength);
+    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding PS Map.");
+
+    for (const PSRecord *record = image->records; record; record = record->next)
+    {
+        cborEncoderResult |= cbor_encode_text_string(&resource, record->name, strlen(record->name));
+        VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Value Tag");
+        cborEncoderResult |= cbor_encode_byte_string(&resource, record->payload, record->size);
+        VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Value.");
+    }
+
+    cborEncoderResult |= cbor_encoder_close_container(&encoder, &resource);
+    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Closing Array.");
+
+    *size = cbor_encoder_get_buffer_size(&encoder, outPayload);
+    *data = outPayload;
+    outPayload = NULL;
+    ret = OC_STACK_OK;
+
+exit:
+    OICFree(outPayload);
+    return ret;
+}
+
+/**
+ * Reads the whole content of a database from PS.
+ *
+ * @note Caller of this method MUST use OICFree() method to release memory
+ *       referenced by the data argument.
+ *
+ * @param databaseName is the name of the database to access through persistent storage.
+ * @param data         is set to the content of the database, or NULL if it is empty.
+ * @param size         is set to the size of data.
+ *
+ * @return ::OC_STACK_OK for Success, otherwise some error value
+ */
+static OCStackResult ReadFileFromPS(const char *databaseName, uint8_t **data, size_t *size)
+{
     FILE *fp = NULL;
     uint8_t *fsData = NULL;
     size_t fileSize = 0;
@@ -178,35 +393,13 @@ OCStackResult ReadDatabaseFromPS(const char *databaseName, const char *resourceN
 
         fp = ps->open(databaseName, "rb");
         VERIFY_NOT_NULL(TAG, fp, ERROR);
-        if (ps->read(fsData, 1, fileSize, fp) == fileSize)
-        {
-            if (resourceName)
-            {
-                CborParser parser;  // will be initialized in |cbor_parser_init|
-                CborValue cbor;     // will be initialized in |cbor_parser_init|
-                cbor_parser_init(fsData, fileSize, 0, &parser, &cbor);
-                CborValue cborValue = OC_DEFAULT_CBOR_VALUE;
-                CborError cborFindResult = cbor_value_map_find_value(&cbor, resourceName, &cborValue);
-                if (CborNoError == cborFindResult && cbor_value_is_byte_string(&cborValue))
-                {
-                    cborFindResult = cbor_value_dup_byte_string(&cborValue, data, size, NULL);
-                    VERIFY_SUCCESS(TAG, CborNoError == cborFindResult, ERROR);
-                    ret = OC_STACK_OK;
-                }
-                // in case of |else (...)|, svr_data not found
-            }
-            // return everything in case resourceName is NULL
-            else
-            {
-                *size = fileSize;
-                *data = (uint8_t *) OICCalloc(1, fileSize);
-                VERIFY_NOT_NULL(TAG, *data, ERROR);
-                memcpy(*data, fsData, fileSize);
-                ret = OC_STACK_OK;
-            }
-        }
+        VERIFY_SUCCESS(TAG, ps->read(fsData, 1, fileSize, fp) == fileSize, ERROR);
     }
-    OIC_LOG(DEBUG, TAG, "ReadDatabaseFromPS OUT");
+
+    *data = fsData;
+    *size = fileSize;
+    fsData = NULL;
+    ret = OC_STACK_OK;
 
 exit:
     if (fp)
@@ -218,295 +411,302 @@ exit:
 }
 
 /**
- * This method updates the database in PS
+ * Gets the image of a database accessed in the current transaction.
  *
- * @param databaseName  is the name of the database to access through persistent storage.
- * @param resourceName  is the name of the resource that will be updated.
- * @param payload       is the pointer to memory where the CBOR payload is located.
- * @param size          is the size of the CBOR payload.
+ * @param databaseName is the name of the database.
+ * @param load         is true to read the database into a new image if it was not
+ *                     accessed yet.
+ *
+ * @return the image, or NULL if no transaction is in progress, the database was not
+ *         accessed and load is false, or the database could not be read.
+ */
+static PSImage *GetTransactionImage(const char *databaseName, bool load)
+{
+    if (0 == g_psTransactionDepth)
+    {
+        return NULL;
+    }
+
+    for (PSImage *image = g_psImages; image; image = image->next)
+    {
+        if (0 == strcmp(image->databaseName, databaseName))
+        {
+            return image;
+        }
+    }
+    if (!load)
+    {
+        return NULL;
+    }
+
+    uint8_t *data = NULL;
+    size_t size = 0;
+    PSImage *image = (PSImage *)OICCalloc(1, sizeof(PSImage));
+    VERIFY_NOT_NULL(TAG, image, ERROR);
+    image->databaseName = OICStrdup(databaseName);
+    VERIFY_NOT_NULL(TAG, image->databaseName, ERROR);
+    VERIFY_SUCCESS(TAG, OC_STACK_OK == ReadFileFromPS(databaseName, &data, &size), ERROR);
+    VERIFY_SUCCESS(TAG, OC_STACK_OK == ParseImage(image, data, size), ERROR);
+    OICFree(data);
+
+    image->next = g_psImages;
+    g_psImages = image;
+    return image;
+
+exit:
+    OICFree(data);
+    FreeImage(image);
+    return NULL;
+}
+
+/**
+ * Writes the whole content of a database, to PS or to the image of the database when
+ * a transaction is in progress.
+ *
+ * @param databaseName is the name of the database to access through persistent storage.
+ * @param payload      is the CBOR map of the database.
+ * @param size         is the size of payload.
  *
  * @return ::OC_STACK_OK for Success, otherwise some error value
  */
-OCStackResult UpdateResourceInPS(const char *databaseName, const char *resourceName, const uint8_t *payload, size_t size)
+static OCStackResult WriteDatabaseToPS(const char *databaseName, uint8_t *payload, size_t size)
 {
-    OIC_LOG(DEBUG, TAG, "UpdateResourceInPS IN");
-    if (!databaseName || !resourceName)
+    PSImage *image = GetTransactionImage(databaseName, true);
+    if (!image)
     {
-        return OC_STACK_INVALID_PARAM;
+        return (0 == g_psTransactionDepth) ? WritePayloadToPS(databaseName, payload, size)
+                                           : OC_STACK_ERROR;
     }
 
-    size_t dbSize = 0;
-    size_t outSize = 0;
-    uint8_t *dbData = NULL;
-    uint8_t *outPayload = NULL;
+    OCStackResult ret = ParseImage(image, payload, size);
+    if (OC_STACK_OK == ret)
+    {
+        image->modified = true;
+    }
+    return ret;
+}
 
-    uint8_t *aclCbor = NULL;
-    uint8_t *pstatCbor = NULL;
-    uint8_t *doxmCbor = NULL;
-    uint8_t *amaclCbor = NULL;
-    uint8_t *credCbor = NULL;
-    uint8_t *resetPfCbor = NULL;
-    uint8_t *crlCbor = NULL;
-    uint8_t *dpCbor = NULL;
-    uint8_t *spCbor = NULL;
+/**
+ * Reads the database from PS
+ *
+ * @note Caller of this method MUST use OICFree() method to release memory
+ *       referenced by the data argument.
+ *
+ * @param databaseName is the name of the database to access through persistent storage.
+ * @param resourceName is the name of the field for which file content are read.
+ *                     if the value is NULL it will send the content of the whole file.
+ * @param data         is the pointer to the file contents read from the database.
+ * @param size         is the size of the file contents read.
+ *
+ * @return ::OC_STACK_OK for Success, otherwise some error value
+ */
+OCStackResult ReadDatabaseFromPS(const char *databaseName, const char *resourceName, uint8_t **data, size_t *size)
+{
+    OIC_LOG(DEBUG, TAG, "ReadDatabaseFromPS IN");
 
-    int64_t cborEncoderResult = CborNoError;
-    OCStackResult ret = ReadDatabaseFromPS(databaseName, NULL, &dbData, &dbSize);
-    if (dbData && dbSize)
+    if (!databaseName || !data || *data || !size)
     {
-        PSDatabase database = PS_DATABASE_SECURITY;
-        size_t allocSize = 0;
-        size_t aclCborLen = 0;
-        size_t pstatCborLen = 0;
-        size_t doxmCborLen = 0;
-        size_t amaclCborLen = 0;
-        size_t credCborLen = 0;
-        size_t resetPfCborLen = 0;
-        size_t crlCborLen = 0;
-        size_t dpCborLen = 0;
-        size_t spCborLen = 0;
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    uint8_t *fsData = NULL;
+    size_t fileSize = 0;
+    OCStackResult ret = OC_STACK_ERROR;
 
-        // Determine which database we are working with so we can scope our operations
-        if (0 == strcmp(OC_DEVICE_PROPS_FILE_NAME, databaseName))
+    // The updates of the current transaction are not written yet.
+    PSImage *image = GetTransactionImage(databaseName, false);
+    if (image)
+    {
+        if (resourceName)
         {
-            database = PS_DATABASE_DEVICEPROPERTIES;
+            PSRecord *record = FindRecord(image, resourceName);
+            if (record)
+            {
+                *data = (uint8_t *)OICMalloc(record->size);
+                VERIFY_NOT_NULL(TAG, *data, ERROR);
+                memcpy(*data, record->payload, record->size);
+                *size = record->size;
+                ret = OC_STACK_OK;
+            }
+        }
+        else if (image->records)
+        {
+            ret = EncodeImage(image, data, size);
         }
+        goto exit;
+    }
 
-        // Gets each secure virtual resource from persistent storage
-        // this local scoping intended, for destroying large cbor instances after use
+    VERIFY_SUCCESS(TAG, OC_STACK_OK == ReadFileFromPS(databaseName, &fsData, &fileSize), ERROR);
+    if (fileSize)
+    {
+        if (resourceName)
         {
             CborParser parser;  // will be initialized in |cbor_parser_init|
             CborValue cbor;     // will be initialized in |cbor_parser_init|
-            cbor_parser_init(dbData, dbSize, 0, &parser, &cbor);
-            CborValue curVal = OC_DEFAULT_CBOR_VALUE;
-            CborError cborFindResult = CborNoError;
-
-            // Only search for and copy resources owned by the target database
-            if (PS_DATABASE_SECURITY == database)
+            cbor_parser_init(fsData, fileSize, 0, &parser, &cbor);
+            CborValue cborValue = OC_DEFAULT_CBOR_VALUE;
+            CborError cborFindResult = cbor_value_map_find_value(&cbor, resourceName, &cborValue);
+            if (CborNoError == cborFindResult && cbor_value_is_byte_string(&cborValue))
             {
-                // Security database
-                cborFindResult = cbor_value_map_find_value(&cbor, OIC_JSON_ACL_NAME, &curVal);
-                if ((CborNoError == cborFindResult) && cbor_value_is_byte_string(&curVal))
-                {
-                    cborFindResult = cbor_value_dup_byte_string(&curVal, &aclCbor, &aclCborLen, NULL);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborFindResult, "Failed Finding ACL Name Value.");
-                }
-                cborFindResult = cbor_value_map_find_value(&cbor, OIC_JSON_PSTAT_NAME, &curVal);
-                if ((CborNoError == cborFindResult) && cbor_value_is_byte_string(&curVal))
-                {
-                    cborFindResult = cbor_value_dup_byte_string(&curVal, &pstatCbor, &pstatCborLen, NULL);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborFindResult, "Failed Finding PSTAT Name Value.");
-                }
-                cborFindResult = cbor_value_map_find_value(&cbor, OIC_JSON_DOXM_NAME, &curVal);
-                if ((CborNoError == cborFindResult) && cbor_value_is_byte_string(&curVal))
-                {
-                    cborFindResult = cbor_value_dup_byte_string(&curVal, &doxmCbor, &doxmCborLen, NULL);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborFindResult, "Failed Finding DOXM Name Value.");
-                }
-                cborFindResult = cbor_value_map_find_value(&cbor, OIC_JSON_AMACL_NAME, &curVal);
-                if ((CborNoError == cborFindResult) && cbor_value_is_byte_string(&curVal))
-                {
-                    cborFindResult = cbor_value_dup_byte_string(&curVal, &amaclCbor, &amaclCborLen, NULL);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborFindResult, "Failed Finding AMACL Name Value.");
-                }
-                cborFindResult = cbor_value_map_find_value(&cbor, OIC_JSON_CRED_NAME, &curVal);
-                if ((CborNoError == cborFindResult) && cbor_value_is_byte_string(&curVal))
-                {
-                    cborFindResult = cbor_value_dup_byte_string(&curVal, &credCbor, &credCborLen, NULL);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborFindResult, "Failed Finding CRED Name Value.");
-                }
-                cborFindResult = cbor_value_map_find_value(&cbor, OIC_JSON_RESET_PF_NAME, &curVal);
-                if ((CborNoError == cborFindResult) && cbor_value_is_byte_string(&curVal))
-                {
-                    cborFindResult = cbor_value_dup_byte_string(&curVal, &resetPfCbor, &resetPfCborLen, NULL);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborFindResult, "Failed Finding Reset Profile Name Value.");
-                }
-                int64_t cborFindCrlResult = cbor_value_map_find_value(&cbor, OIC_JSON_CRL_NAME, &curVal);
-                if ((CborNoError == cborFindCrlResult) && cbor_value_is_byte_string(&curVal))
-                {
-                    cborFindCrlResult = cbor_value_dup_byte_string(&curVal, &crlCbor, &crlCborLen, NULL);
-                    if ((CborNoError != cborFindCrlResult) && (CborErrorOutOfMemory != cborFindCrlResult))
-                    {
-                        OIC_LOG(ERROR, TAG, "Failed Finding optional CRL Name Value.");
-                    }
-                    else
-                    {
-                        OIC_LOG(INFO, TAG, "Successfully Finding optional CRL Name Value.");
-                    }
-                }
-                cborFindResult = cbor_value_map_find_value(&cbor, OIC_JSON_SP_NAME, &curVal);
-                if ((CborNoError == cborFindResult) && cbor_value_is_byte_string(&curVal))
-                {
-                    cborFindResult = cbor_value_dup_byte_string(&curVal, &spCbor, &spCborLen, NULL);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborFindResult, "Failed Finding SP Name Value.");
-                }
-            }
-            else
-            {
-                // Device Properties database
-                cborFindResult = cbor_value_map_find_value(&cbor, OC_JSON_DEVICE_PROPS_NAME, &curVal);
-                if ((CborNoError == cborFindResult) && cbor_value_is_byte_string(&curVal))
-                {
-                    cborFindResult = cbor_value_dup_byte_string(&curVal, &dpCbor, &dpCborLen, NULL);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborFindResult, "Failed Finding Device Properties Name Value.");
-                }
+                cborFindResult = cbor_value_dup_byte_string(&cborValue, data, size, NULL);
+                VERIFY_SUCCESS(TAG, CborNoError == cborFindResult, ERROR);
+                ret = OC_STACK_OK;
             }
+            // in case of |else (...)|, svr_data not found
         }
-
-        // Updates the added |payload| with the existing secure virtual resource(s)
-        // this local scoping intended, for destroying large cbor instances after use
+        // return everything in case resourceName is NULL
+        else
         {
-            if (PS_DATABASE_SECURITY == database)
-            {
-                allocSize = aclCborLen + pstatCborLen + doxmCborLen + amaclCborLen
-                          + credCborLen + /* pconfCborLen + */ resetPfCborLen + crlCborLen + spCborLen
-                          + size + CBOR_ENCODING_SIZE_ADDITION;
-            }
-            else
-            {
-                allocSize = dpCborLen + size + CBOR_ENCODING_SIZE_ADDITION;
-            }
-
-
-            outPayload = (uint8_t *)OICCalloc(1, allocSize);
-            VERIFY_NOT_NULL(TAG, outPayload, ERROR);
-            CborEncoder encoder;  // will be initialized in |cbor_parser_init|
-            cbor_encoder_init(&encoder, outPayload, allocSize, 0);
-            CborEncoder resource;  // will be initialized in |cbor_encoder_create_map|
-            cborEncoderResult |= cbor_encoder_create_map(&encoder, &resource, CborIndefiniteLength);
-            VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding PS Map.");
+            *size = fileSize;
+            *data = fsData;
+            fsData = NULL;
+            ret = OC_STACK_OK;
+        }
+    }
+    OIC_LOG(DEBUG, TAG, "ReadDatabaseFromPS OUT");
 
-            // Encode the updated payload and add it to our map so it will be stored in the database.
-            if (payload && size)
-            {
-                cborEncoderResult |= cbor_encode_text_string(&resource, resourceName, strlen(resourceName));
-                VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Value Tag");
-                cborEncoderResult |= cbor_encode_byte_string(&resource, payload, size);
-                VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Value.");
-            }
+exit:
+    OICFree(fsData);
+    return ret;
+}
 
-            // Check all of the resources from a particular database to see if we need to encode them. If the resource
-            // currently exists in the database and has not been updated then we need to encode it and add it to the
-            // map. If the resource has been updated then it was encoded and added to the map above so we skip it to
-            // avoid having duplicate entries for the resource in the database.
-            if (PS_DATABASE_SECURITY == database)
-            {
-                // Security database
-                if (strcmp(OIC_JSON_ACL_NAME, resourceName) && aclCborLen)
-                {
-                    cborEncoderResult |= cbor_encode_text_string(&resource, OIC_JSON_ACL_NAME, strlen(OIC_JSON_ACL_NAME));
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding ACL Name.");
-                    cborEncoderResult |= cbor_encode_byte_string(&resource, aclCbor, aclCborLen);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding ACL Value.");
-                }
-                if (strcmp(OIC_JSON_PSTAT_NAME, resourceName) && pstatCborLen)
-                {
-                    cborEncoderResult |= cbor_encode_text_string(&resource, OIC_JSON_PSTAT_NAME, strlen(OIC_JSON_PSTAT_NAME));
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding PSTAT Name.");
-                    cborEncoderResult |= cbor_encode_byte_string(&resource, pstatCbor, pstatCborLen);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding PSTAT Value.");
-                }
-                if (strcmp(OIC_JSON_DOXM_NAME, resourceName) && doxmCborLen)
-                {
-                    cborEncoderResult |= cbor_encode_text_string(&resource, OIC_JSON_DOXM_NAME, strlen(OIC_JSON_DOXM_NAME));
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Doxm Name.");
-                    cborEncoderResult |= cbor_encode_byte_string(&resource, doxmCbor, doxmCborLen);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Doxm Value.");
-                }
-                if (strcmp(OIC_JSON_AMACL_NAME, resourceName) && amaclCborLen)
-                {
-                    cborEncoderResult |= cbor_encode_text_string(&resource, OIC_JSON_AMACL_NAME, strlen(OIC_JSON_AMACL_NAME));
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Amacl Name.");
-                    cborEncoderResult |= cbor_encode_byte_string(&resource, amaclCbor, amaclCborLen);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Amacl Value.");
-                }
-                if (strcmp(OIC_JSON_CRED_NAME, resourceName) && credCborLen)
-                {
-                    cborEncoderResult |= cbor_encode_text_string(&resource, OIC_JSON_CRED_NAME, strlen(OIC_JSON_CRED_NAME));
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Cred Name.");
-                    cborEncoderResult |= cbor_encode_byte_string(&resource, credCbor, credCborLen);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Cred Value.");
-                }
-                if (strcmp(OIC_JSON_RESET_PF_NAME, resourceName) && resetPfCborLen)
-                {
-                    cborEncoderResult |= cbor_encode_text_string(&resource, OIC_JSON_RESET_PF_NAME, strlen(OIC_JSON_RESET_PF_NAME));
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Reset Profile Name.");
-                    cborEncoderResult |= cbor_encode_byte_string(&resource, resetPfCbor, resetPfCborLen);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Reset Profile Value.");
-                }
-                if (strcmp(OIC_JSON_CRL_NAME, resourceName) && crlCborLen)
-                {
-                    cborEncoderResult |= cbor_encode_text_string(&resource, OIC_JSON_CRL_NAME, strlen(OIC_JSON_CRL_NAME));
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Crl Name.");
-                    cborEncoderResult |= cbor_encode_byte_string(&resource, crlCbor, crlCborLen);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Crl Value.");
-                }
-                if (strcmp(OIC_JSON_SP_NAME, resourceName) && spCborLen)
-                {
-                    cborEncoderResult |= cbor_encode_text_string(&resource, OIC_JSON_SP_NAME, strlen(OIC_JSON_SP_NAME));
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding SP Name.");
-                    cborEncoderResult |= cbor_encode_byte_string(&resource, spCbor, spCborLen);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding SP Value.");
-                }
+/**
+ * This method updates the database in PS
+ *
+ * Only the resource is re-encoded: the other resources of the database are copied as
+ * they are stored. When a transaction is in progress, the update is applied to the
+ * image of the database and written by EndPSTransaction.
+ *
+ * @param databaseName  is the name of the database to access through persistent storage.
+ * @param resourceName  is the name of the resource that will be updated.
+ * @param payload       is the pointer to memory where the CBOR payload is located.
+ * @param size          is the size of the CBOR payload.
+ *
+ * @return ::OC_STACK_OK for Success, otherwise some error value
+ */
+OCStackResult UpdateResourceInPS(const char *databaseName, const char *resourceName, const uint8_t *payload, size_t size)
+{
+    OIC_LOG(DEBUG, TAG, "UpdateResourceInPS IN");
+    if (!databaseName || !resourceName)
+    {
+        return OC_STACK_INVALID_PARAM;
+    }
 
+    OCStackResult ret = OC_STACK_ERROR;
+    uint8_t *dbData = NULL;
+    size_t dbSize = 0;
+    uint8_t *outPayload = NULL;
+    size_t outSize = 0;
+    PSImage *tempImage = NULL;
+    PSRecord *newRecord = NULL;
 
-            }
-            else
-            {
-                // Device Properties database
-                if (strcmp(OC_JSON_DEVICE_PROPS_NAME, resourceName) && dpCborLen)
-                {
-                    cborEncoderResult |= cbor_encode_text_string(&resource, OC_JSON_DEVICE_PROPS_NAME, strlen(OC_JSON_DEVICE_PROPS_NAME));
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Device Properties Name.");
-                    cborEncoderResult |= cbor_encode_byte_string(&resource, dpCbor, dpCborLen);
-                    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Device Properties Value.");
-                }
-            }
+    PSImage *image = GetTransactionImage(databaseName, true);
+    if (!image)
+    {
+        VERIFY_SUCCESS(TAG, 0 == g_psTransactionDepth, ERROR);
+
+        tempImage = (PSImage *)OICCalloc(1, sizeof(PSImage));
+        VERIFY_NOT_NULL(TAG, tempImage, ERROR);
+        tempImage->databaseName = OICStrdup(databaseName);
+        VERIFY_NOT_NULL(TAG, tempImage->databaseName, ERROR);
+        VERIFY_SUCCESS(TAG, OC_STACK_OK == ReadFileFromPS(databaseName, &dbData, &dbSize), ERROR);
+        VERIFY_SUCCESS(TAG, OC_STACK_OK == ParseImage(tempImage, dbData, dbSize), ERROR);
+        image = tempImage;
+    }
 
-            cborEncoderResult |= cbor_encoder_close_container(&encoder, &resource);
-            VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Closing Array.");
-            outSize = cbor_encoder_get_buffer_size(&encoder, outPayload);
-        }
+    // Remove the stored resource, and add the updated one first.
+    PSRecord **link = &image->records;
+    while (*link && strcmp((*link)->name, resourceName))
+    {
+        link = &(*link)->next;
     }
-    else if (payload && size)
+    if (*link)
     {
-        size_t allocSize = size + CBOR_ENCODING_SIZE_ADDITION;
-
-        outPayload = (uint8_t *)OICCalloc(1, allocSize);
-        VERIFY_NOT_NULL(TAG, outPayload, ERROR);
-        CborEncoder encoder;  // will be initialized in |cbor_parser_init|
-        cbor_encoder_init(&encoder, outPayload, allocSize, 0);
-        CborEncoder resource;  // will be initialized in |cbor_encoder_create_map|
-        cborEncoderResult |= cbor_encoder_create_map(&encoder, &resource, CborIndefiniteLength);
-        VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding PS Map.");
+        PSRecord *oldRecord = *link;
+        *link = oldRecord->next;
+        oldRecord->next = NULL;
+        FreeRecords(oldRecord);
+    }
 
-        cborEncoderResult |= cbor_encode_text_string(&resource, resourceName, strlen(resourceName));
-        VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Value Tag");
-        cborEncoderResult |= cbor_encode_byte_string(&resource, payload, size);
-        VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Value.");
+    if (payload && size)
+    {
+        newRecord = (PSRecord *)OICCalloc(1, sizeof(PSRecord));
+        VERIFY_NOT_NULL(TAG, newRecord, ERROR);
+        newRecord->name = OICStrdup(resourceName);
+        newRecord->payload = (uint8_t *)OICMalloc(size);
+        VERIFY_NOT_NULL(TAG, newRecord->name, ERROR);
+        VERIFY_NOT_NULL(TAG, newRecord->payload, ERROR);
+        memcpy(newRecord->payload, payload, size);
+        newRecord->size = size;
+        newRecord->next = image->records;
+        image->records = newRecord;
+        newRecord = NULL;
+    }
 
-        cborEncoderResult |= cbor_encoder_close_container(&encoder, &resource);
-        VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Closing Array.");
-        outSize = cbor_encoder_get_buffer_size(&encoder, outPayload);
+    if (!tempImage)
+    {
+        image->modified = true;
+        ret = OC_STACK_OK;
+        OIC_LOG(DEBUG, TAG, "UpdateResourceInPS OUT (deferred to the end of the transaction)");
+        goto exit;
     }
 
+    ret = EncodeImage(image, &outPayload, &outSize);
+    VERIFY_SUCCESS(TAG, (OC_STACK_OK == ret), ERROR);
     ret = WritePayloadToPS(databaseName, outPayload, outSize);
     VERIFY_SUCCESS(TAG, (OC_STACK_OK == ret), ERROR);
 
     OIC_LOG(DEBUG, TAG, "UpdateResourceInPS OUT");
 
 exit:
+    FreeRecords(newRecord);
+    FreeImage(tempImage);
     OICFree(dbData);
     OICFree(outPayload);
-    OICFree(aclCbor);
-    OICFree(pstatCbor);
-    OICFree(doxmCbor);
-    OICFree(amaclCbor);
-    OICFree(credCbor);
-    OICFree(resetPfCbor);
-    OICFree(crlCbor);
-    OICFree(dpCbor);
-    OICFree(spCbor);
+    return ret;
+}
+
+void BeginPSTransaction(void)
+{
+    g_psTransactionDepth++;
+}
+
+OCStackResult EndPSTransaction(void)
+{
+    OCStackResult ret = OC_STACK_OK;
+
+    if (0 == g_psTransactionDepth)
+    {
+        return OC_STACK_ERROR;
+    }
+    if (0 != --g_psTransactionDepth)
+    {
+        return OC_STACK_OK;
+    }
+
+    while (g_psImages)
+    {
+        PSImage *image = g_psImages;
+        g_psImages = image->next;
+
+        if (image->modified)
+        {
+            uint8_t *outPayload = NULL;
+            size_t outSize = 0;
+            OCStackResult res = EncodeImage(image, &outPayload, &outSize);
+            if (OC_STACK_OK == res)
+            {
+                res = WritePayloadToPS(image->databaseName, outPayload, outSize);
+            }
+            if (OC_STACK_OK != res)
+            {
+                OIC_LOG_V(ERROR, TAG, "Failed writing %s: %d", image->databaseName, res);
+                ret = res;
+            }
+            OICFree(outPayload);
+        }
+        FreeImage(image);
+    }
     return ret;
 }
 
@@ -682,7 +882,7 @@ OCStackResult ResetSecureResourceInPS(void)
             outSize = cbor_encoder_get_buffer_size(&encoder, outPayload);
         }
 
-        ret = WritePayloadToPS(SVR_DB_DAT_FILE_NAME, outPayload, outSize);
+        ret = WriteDatabaseToPS(SVR_DB_DAT_FILE_NAME, outPayload, outSize);
         VERIFY_SUCCESS(TAG, (OC_STACK_OK == ret), ERROR);
     }
 
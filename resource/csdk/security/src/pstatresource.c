@@ -25,6 +25,7 @@
 #include <inttypes.h>
 
 #include "ocstack.h"
+#include "casecurityinterface.h"
 #include "oic_malloc.h"
 #include "ocpayload.h"
 #include "ocpayloadcbor.h"
@@ -36,6 +37,7 @@
 #include "srmresourcestrings.h"
 #include "srmutility.h"
 #include "deviceonboardingstate.h"
+#include "aclindex.h"
 
 #define TAG  "OIC_SRM_PSTAT"
 
@@ -154,6 +156,11 @@ static bool UpdatePersistentStorage(OicSecPstat_t *pstat)
 {
     bool bRet = false;
 
+    // The access decisions cached by the Policy Engine depend on /pstat.
+    InvalidateACLIndex();
+    // The sessions established in the previous state must not be resumed.
+    CAflushSslSessions();
+
     size_t size = 0;
     uint8_t *cborPayload = NULL;
     OCStackResult ret = PstatToCBORPayload(pstat, &cborPayload, &size);
@@ -817,6 +824,10 @@ static OCEntityHandlerResult HandlePstatPostRequest(OCEntityHandlerRequest *ehRe
     OIC_LOG_V(DEBUG, TAG, "IN %s", __func__);
     OicSecPstat_t *pstat = NULL;
 
+    // Write the databases updated by the request, including a change of dos, once
+    // before responding.
+    BeginPSTransaction();
+
     if (ehRequest->payload && NULL != gPstat)
     {
         uint8_t *payload = ((OCSecurityPayload *) ehRequest->payload)->securityData;
@@ -921,6 +932,10 @@ static OCEntityHandlerResult HandlePstatPostRequest(OCEntityHandlerRequest *ehRe
     }
 
 exit:
+    if ((OC_STACK_OK != EndPSTransaction()) && (OC_EH_OK == ehRet))
+    {
+        ehRet = OC_EH_ERROR;
+    }
 
     // Send response payload to request originator
     ehRet = ((SendSRMResponse(ehRequest, ehRet, NULL, 0)) == OC_STACK_OK) ?
@@ -1014,6 +1029,7 @@ OCStackResult InitPstatResource(void)
         gPstat = GetPstatDefault();
     }
     VERIFY_NOT_NULL(TAG, gPstat, FATAL);
+    InvalidateACLIndex();
 
     // TODO [IOT-2023]: after all SVRs are initialized, need to call SetDosState()
     // using the just-loaded pstat.dos.s
@@ -1046,6 +1062,7 @@ OCStackResult DeInitPstatResource(void)
         DeletePstatBinData(gPstat);
         gPstat = NULL;
     }
+    InvalidateACLIndex();
     return OCDeleteResource(gPstatHandle);
 }
 
@@ -1207,6 +1224,8 @@ OCStackResult SetPstatSelfOwnership(const OicUuid_t* newROwner)
         gPstat->isOp = true;
 
         memcpy(gPstat->rownerID.id, newROwner->id, sizeof(newROwner->id));
+        InvalidateACLIndex();
+        CAflushSslSessions();
 
         ret = PstatToCBORPayload(gPstat, &cborPayload, &size);
         VERIFY_SUCCESS(TAG, OC_STACK_OK == ret, ERROR);
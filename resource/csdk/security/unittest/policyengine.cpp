@@ -18,12 +18,15 @@
 *
 ******************************************************************/
 #include <gtest/gtest.h>
+#include <chrono>
+#include <string>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 #include "tools.h"
+#include "security_internals.h"
 #undef TAG
 #include "../src/policyengine.c"
 
@@ -86,3 +89,93 @@ TEST_F(PE, IsRequestFromCms)
     OICFree(context);
 }
 
+
+static OicSecAce_t *NewUuidAce(size_t subject, const char *href, uint16_t permission)
+{
+    OicSecAce_t *ace = (OicSecAce_t *)OICCalloc(1, sizeof(OicSecAce_t));
+    OicSecRsrc_t *rsrc = (OicSecRsrc_t *)OICCalloc(1, sizeof(OicSecRsrc_t));
+    if ((NULL == ace) || (NULL == rsrc))
+    {
+        OICFree(ace);
+        OICFree(rsrc);
+        return NULL;
+    }
+    ace->subjectType = OicSecAceUuidSubject;
+    memcpy(ace->subjectuuid.id, &subject, sizeof(subject));
+    ace->permission = permission;
+    rsrc->href = OICStrdup(href);
+    ace->resources = rsrc;
+    return ace;
+}
+
+static void SetRequest(SRMRequestContext_t *context, size_t subject, const char *uri,
+                       uint16_t permission)
+{
+    memset(context, 0, sizeof(*context));
+    context->subjectIdType = SUBJECT_ID_TYPE_UUID;
+    memcpy(context->subjectUuid.id, &subject, sizeof(subject));
+    OICStrcpy(context->resourceUri, sizeof(context->resourceUri), uri);
+    context->requestedPermission = permission;
+}
+
+TEST_F(PE, ProcessAccessRequestWith1kAces)
+{
+    const size_t aceCount = 1000;
+    OicSecAcl_t *acl = (OicSecAcl_t *)OICCalloc(1, sizeof(OicSecAcl_t));
+    ASSERT_TRUE(NULL != acl);
+    for (size_t i = 0; i < aceCount; i++)
+    {
+        std::string href = "/light/" + std::to_string(i);
+        OicSecAce_t *ace = NewUuidAce(i + 1, href.c_str(), PERMISSION_READ);
+        ASSERT_TRUE(NULL != ace);
+        LL_PREPEND(acl->aces, ace);
+    }
+    EXPECT_EQ(OC_STACK_OK, SetDefaultACL(acl));
+
+    SRMRequestContext_t context;
+    uint64_t hits = g_aclDecisionHits;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < aceCount; i++)
+    {
+        std::string href = "/light/" + std::to_string(i);
+        SetRequest(&context, i + 1, href.c_str(), PERMISSION_READ);
+        ProcessAccessRequest(&context);
+        EXPECT_TRUE(IsAccessGranted(context.responseVal));
+
+        SetRequest(&context, i + 1, href.c_str(), PERMISSION_WRITE);
+        ProcessAccessRequest(&context);
+        EXPECT_FALSE(IsAccessGranted(context.responseVal));
+
+        SetRequest(&context, i + 2, href.c_str(), PERMISSION_READ);
+        ProcessAccessRequest(&context);
+        EXPECT_FALSE(IsAccessGranted(context.responseVal));
+    }
+    long long elapsed = (long long)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    OIC_LOG_V(INFO, TAG, "%zu access requests against %zu ACEs in %lld us",
+              3 * aceCount, aceCount, elapsed);
+    EXPECT_EQ(hits, g_aclDecisionHits);
+
+    // The decision is cached until the ACL changes.
+    SetRequest(&context, 1, "/light/0", PERMISSION_READ);
+    ProcessAccessRequest(&context);
+    ProcessAccessRequest(&context);
+    EXPECT_TRUE(IsAccessGranted(context.responseVal));
+    EXPECT_EQ(hits + 1, g_aclDecisionHits);
+
+    OicSecAce_t *ace = NewUuidAce(1, "/light/0", PERMISSION_READ | PERMISSION_WRITE);
+    ASSERT_TRUE(NULL != ace);
+    LL_PREPEND(acl->aces, ace);
+    InvalidateACLIndex();
+
+    ProcessAccessRequest(&context);
+    EXPECT_TRUE(IsAccessGranted(context.responseVal));
+    EXPECT_EQ(hits + 1, g_aclDecisionHits);
+
+    SetRequest(&context, 1, "/light/0", PERMISSION_WRITE);
+    ProcessAccessRequest(&context);
+    EXPECT_TRUE(IsAccessGranted(context.responseVal));
+
+    EXPECT_EQ(OC_STACK_OK, SetDefaultACL(NULL));
+    DeleteACLList(acl);
+}
@@ -0,0 +1,239 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+#include "cbor.h"
+#include "ocstack.h"
+#include "oic_malloc.h"
+#include "psinterface.h"
+#include "srmresourcestrings.h"
+
+#define PS_TEST_DATABASE "oic_ps_transaction_test.dat"
+
+// Counts the writes of the database and fails them on request.
+static int g_psWrites = 0;
+static bool g_psFailWrites = false;
+
+static FILE *TestOpen(const char *path, const char *mode)
+{
+    if (0 == strcmp(path, PS_TEST_DATABASE) && 'w' == mode[0])
+    {
+        g_psWrites++;
+    }
+    return fopen(path, mode);
+}
+
+static size_t TestWrite(const void *ptr, size_t size, size_t count, FILE *stream)
+{
+    return g_psFailWrites ? 0 : fwrite(ptr, size, count, stream);
+}
+
+class PSTransaction : public testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        m_savedPs = OCGetPersistentStorageHandler();
+        m_ps.open = TestOpen;
+        m_ps.read = fread;
+        m_ps.write = TestWrite;
+        m_ps.close = fclose;
+        m_ps.unlink = remove;
+        ASSERT_EQ(OC_STACK_OK, OCRegisterPersistentStorageHandler(&m_ps));
+        remove(PS_TEST_DATABASE);
+        g_psWrites = 0;
+        g_psFailWrites = false;
+    }
+
+    virtual void TearDown()
+    {
+        remove(PS_TEST_DATABASE);
+        if (m_savedPs)
+        {
+            OCRegisterPersistentStorageHandler(m_savedPs);
+        }
+    }
+
+    static OCStackResult Update(const char *resourceName, const std::string &value)
+    {
+        return UpdateResourceInPS(PS_TEST_DATABASE, resourceName,
+                                  (const uint8_t *)value.data(), value.size());
+    }
+
+    // Whether the database holds an empty map.
+    static bool IsEmpty()
+    {
+        uint8_t *data = NULL;
+        size_t size = 0;
+        bool empty = false;
+        if (OC_STACK_OK == ReadDatabaseFromPS(PS_TEST_DATABASE, NULL, &data, &size))
+        {
+            CborParser parser;
+            CborValue cbor;
+            CborValue map;
+            empty = (CborNoError == cbor_parser_init(data, size, 0, &parser, &cbor))
+                    && cbor_value_is_map(&cbor)
+                    && (CborNoError == cbor_value_enter_container(&cbor, &map))
+                    && cbor_value_at_end(&map);
+        }
+        OICFree(data);
+        return empty;
+    }
+
+    // The value of the resource, or an empty string when it is not found.
+    static std::string Read(const char *resourceName)
+    {
+        uint8_t *data = NULL;
+        size_t size = 0;
+        std::string value;
+        if (OC_STACK_OK == ReadDatabaseFromPS(PS_TEST_DATABASE, resourceName, &data, &size))
+        {
+            value.assign((const char *)data, size);
+        }
+        OICFree(data);
+        return value;
+    }
+
+    OCPersistentStorage m_ps;
+    OCPersistentStorage *m_savedPs = NULL;
+};
+
+TEST_F(PSTransaction, UpdateWithoutTransactionWritesDatabase)
+{
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_ACL_NAME, "acl1"));
+    EXPECT_EQ(1, g_psWrites);
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_CRED_NAME, "cred1"));
+    EXPECT_EQ(2, g_psWrites);
+    EXPECT_EQ("acl1", Read(OIC_JSON_ACL_NAME));
+    EXPECT_EQ("cred1", Read(OIC_JSON_CRED_NAME));
+}
+
+TEST_F(PSTransaction, EndWithoutBeginFails)
+{
+    EXPECT_EQ(OC_STACK_ERROR, EndPSTransaction());
+}
+
+// Only the outermost end writes, and it writes the database once for all updates.
+TEST_F(PSTransaction, NestedTransactionsWriteOnceAtOutermostEnd)
+{
+    BeginPSTransaction();
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_ACL_NAME, "acl1"));
+    BeginPSTransaction();
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_CRED_NAME, "cred1"));
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_PSTAT_NAME, "pstat1"));
+    EXPECT_EQ(OC_STACK_OK, EndPSTransaction());
+    EXPECT_EQ(0, g_psWrites);
+
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_ACL_NAME, "acl2"));
+    EXPECT_EQ(OC_STACK_OK, EndPSTransaction());
+    EXPECT_EQ(1, g_psWrites);
+
+    EXPECT_EQ("acl2", Read(OIC_JSON_ACL_NAME));
+    EXPECT_EQ("cred1", Read(OIC_JSON_CRED_NAME));
+    EXPECT_EQ("pstat1", Read(OIC_JSON_PSTAT_NAME));
+    EXPECT_EQ(OC_STACK_ERROR, EndPSTransaction());
+}
+
+// A transaction without updates does not write.
+TEST_F(PSTransaction, ReadOnlyTransactionDoesNotWrite)
+{
+    ASSERT_EQ(OC_STACK_OK, Update(OIC_JSON_ACL_NAME, "acl1"));
+    g_psWrites = 0;
+
+    BeginPSTransaction();
+    EXPECT_EQ("acl1", Read(OIC_JSON_ACL_NAME));
+    EXPECT_EQ(OC_STACK_OK, EndPSTransaction());
+    EXPECT_EQ(0, g_psWrites);
+}
+
+// Reads in a transaction see its updates before they are written.
+TEST_F(PSTransaction, ReadsInTransactionSeeUpdates)
+{
+    ASSERT_EQ(OC_STACK_OK, Update(OIC_JSON_ACL_NAME, "acl1"));
+    ASSERT_EQ(OC_STACK_OK, Update(OIC_JSON_CRED_NAME, "cred1"));
+    g_psWrites = 0;
+
+    BeginPSTransaction();
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_ACL_NAME, "acl2"));
+    EXPECT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, OIC_JSON_CRED_NAME, NULL, 0));
+    EXPECT_EQ("acl2", Read(OIC_JSON_ACL_NAME));
+    EXPECT_EQ("", Read(OIC_JSON_CRED_NAME));
+
+    // The whole database, as it will be written.
+    uint8_t *data = NULL;
+    size_t size = 0;
+    EXPECT_EQ(OC_STACK_OK, ReadDatabaseFromPS(PS_TEST_DATABASE, NULL, &data, &size));
+    EXPECT_TRUE(NULL != data);
+    EXPECT_NE(0u, size);
+    OICFree(data);
+    EXPECT_EQ(0, g_psWrites);
+
+    EXPECT_EQ(OC_STACK_OK, EndPSTransaction());
+    EXPECT_EQ(1, g_psWrites);
+    EXPECT_EQ("acl2", Read(OIC_JSON_ACL_NAME));
+    EXPECT_EQ("", Read(OIC_JSON_CRED_NAME));
+}
+
+// Removing the last resource leaves an empty map in the database.
+TEST_F(PSTransaction, RemoveLastResource)
+{
+    ASSERT_EQ(OC_STACK_OK, Update(OIC_JSON_ACL_NAME, "acl1"));
+    EXPECT_FALSE(IsEmpty());
+    EXPECT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, OIC_JSON_ACL_NAME, NULL, 0));
+    EXPECT_EQ(2, g_psWrites);
+    EXPECT_EQ("", Read(OIC_JSON_ACL_NAME));
+    EXPECT_TRUE(IsEmpty());
+
+    // The same in a transaction.
+    ASSERT_EQ(OC_STACK_OK, Update(OIC_JSON_ACL_NAME, "acl1"));
+    BeginPSTransaction();
+    EXPECT_EQ(OC_STACK_OK, UpdateResourceInPS(PS_TEST_DATABASE, OIC_JSON_ACL_NAME, NULL, 0));
+    EXPECT_EQ(OC_STACK_OK, EndPSTransaction());
+    EXPECT_EQ(4, g_psWrites);
+    EXPECT_EQ("", Read(OIC_JSON_ACL_NAME));
+    EXPECT_TRUE(IsEmpty());
+}
+
+// A failed write is returned by the update outside a transaction, and by the
+// outermost end in a transaction. The failed transaction does not leak into the next.
+TEST_F(PSTransaction, WriteFailureIsReturned)
+{
+    ASSERT_EQ(OC_STACK_OK, Update(OIC_JSON_ACL_NAME, "acl1"));
+
+    g_psFailWrites = true;
+    EXPECT_NE(OC_STACK_OK, Update(OIC_JSON_ACL_NAME, "acl2"));
+
+    BeginPSTransaction();
+    BeginPSTransaction();
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_ACL_NAME, "acl3"));
+    EXPECT_EQ(OC_STACK_OK, EndPSTransaction());
+    EXPECT_NE(OC_STACK_OK, EndPSTransaction());
+    g_psFailWrites = false;
+
+    BeginPSTransaction();
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_CRED_NAME, "cred1"));
+    EXPECT_EQ(OC_STACK_OK, EndPSTransaction());
+    EXPECT_EQ("cred1", Read(OIC_JSON_CRED_NAME));
+}
@@ -128,6 +128,18 @@ typedef struct ClientCB {
      * can be explicitly cancelled.*/
     uint32_t TTL;
 
+    /** Position in the expiry heap, only used while TTL is not 0.*/
+    size_t ttlIndex;
+
+    /** next node in the same token hash bucket.*/
+    struct ClientCB    *tokenNext;
+
+    /** next node in the same handle hash bucket.*/
+    struct ClientCB    *handleNext;
+
+    /** previous node in this list.*/
+    struct ClientCB    *prev;
+
     /** next node in this list.*/
     struct ClientCB    *next;
 } ClientCB;
@@ -189,6 +201,14 @@ OCStackResult AddClientCB(ClientCB** clientCB,
  */
 void DeleteClientCB(ClientCB *cbNode);
 
+/**
+ * This method is used to change the time to live of a callback node.
+ *
+ * @param[in]  cbNode               Address to client callback node.
+ * @param[in]  ttl                  time to live in coap_ticks, 0 if the node never times out.
+ */
+void SetClientCBTTL(ClientCB *cbNode, uint32_t ttl);
+
 /**
  * This method is used to clear the cbList.
  */
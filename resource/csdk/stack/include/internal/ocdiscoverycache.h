@@ -0,0 +1,121 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+/**
+ * @file
+ *
+ * This file contains the cache of the encoded responses to discovery (/oic/res)
+ * requests. A response is cached for the query filters, the accept format and version
+ * and the transport of the request, which selects the endpoints of the response.
+ * The cache is invalidated when resources, their bindings or properties, the device
+ * or the network interfaces change, and its entries expire after
+ * OC_DISCOVERY_CACHE_LIFETIME_MS in case a change was not reported.
+ */
+
+#ifndef OC_DISCOVERY_CACHE_H
+#define OC_DISCOVERY_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ocstack.h"
+#include "ocresourcehandler.h"
+#include "ocserverrequest.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/** Maximum number of responses cached, the least recently used is dropped first. */
+#ifndef OC_DISCOVERY_CACHE_SIZE
+#define OC_DISCOVERY_CACHE_SIZE (8)
+#endif
+
+/** Lifetime of a cached response in milliseconds. */
+#ifndef OC_DISCOVERY_CACHE_LIFETIME_MS
+#define OC_DISCOVERY_CACHE_LIFETIME_MS (30 * 1000)
+#endif
+
+/**
+ * Checks that the response to a discovery request can be cached.
+ *
+ * @param request Discovery request.
+ *
+ * @return true if the response is encoded in a format the cache holds.
+ */
+bool OCDiscoveryCacheAccepts(const OCServerRequest *request);
+
+/**
+ * Gets a copy of the encoded response to a discovery request.
+ *
+ * @param virtualUri Virtual resource of the request.
+ * @param interfaceQuery Interface filter of the request, or NULL.
+ * @param resourceTypeQuery Resource type filter of the request, or NULL.
+ * @param request Discovery request.
+ * @param payloadSize Set to the size of the response.
+ * @param generation Set to the state of the cache, to be passed to OCDiscoveryCachePut
+ *                   when the response is not cached.
+ *
+ * @return the encoded response, to be released with OICFree, or NULL if it is not cached.
+ */
+uint8_t *OCDiscoveryCacheGet(OCVirtualResources virtualUri,
+                             const char *interfaceQuery,
+                             const char *resourceTypeQuery,
+                             const OCServerRequest *request,
+                             size_t *payloadSize,
+                             uint32_t *generation);
+
+/**
+ * Caches the encoded response to a discovery request. The response is not cached if
+ * the cache was invalidated since the generation was returned by OCDiscoveryCacheGet.
+ *
+ * @param virtualUri Virtual resource of the request.
+ * @param interfaceQuery Interface filter of the request, or NULL.
+ * @param resourceTypeQuery Resource type filter of the request, or NULL.
+ * @param request Discovery request.
+ * @param payload Encoded response, copied by the cache.
+ * @param payloadSize Size of the response.
+ * @param generation Generation returned by OCDiscoveryCacheGet.
+ */
+void OCDiscoveryCachePut(OCVirtualResources virtualUri,
+                         const char *interfaceQuery,
+                         const char *resourceTypeQuery,
+                         const OCServerRequest *request,
+                         const uint8_t *payload,
+                         size_t payloadSize,
+                         uint32_t generation);
+
+/**
+ * Invalidates the cached responses. It may be called from any thread, the responses
+ * are released by the next call from the stack.
+ */
+void OCDiscoveryCacheInvalidate(void);
+
+/**
+ * Releases the cached responses and resets the statistics.
+ */
+void OCDiscoveryCacheTerminate(void);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // OC_DISCOVERY_CACHE_H
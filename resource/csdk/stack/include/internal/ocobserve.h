@@ -30,6 +30,7 @@
 #define OC_OBSERVE_H
 
 #include "cacommon.h"
+#include "ocevent.h"
 
 /** Maximum number of observers to reach */
 
@@ -140,20 +141,100 @@ OCStackResult SendAllObserverNotification (OCMethod method, OCResource *resPtr,
 /**
  * Notify specific observers with updated value of representation.
  *
+ * The payload is encoded once for each accept format of the observers.
+ *
  * @param resource                  Observed resource.
- * @param obsIdList                 List of observation ids that need to be notified.
- * @param numberOfIds               Number of observation ids included in obsIdList.
- * @param payload                   JSON encoded payload to send in notification.
+ * @param nextId                    Iterator over the observation ids that need to be notified.
+ * @param context                   Context passed to nextId.
+ * @param payload                   Representation to send in notification.
  * @param maxAge                    Time To Live (in seconds) of observation.
  * @param qos                       Desired quality of service of the observation notifications.
  *
  * @return ::OC_STACK_OK on success, some other value upon failure.
  */
 OCStackResult SendListObserverNotification (OCResource * resource,
-        OCObservationId  *obsIdList, uint8_t numberOfIds,
+        OCObservationIdIterator nextId, void *context,
         const OCRepPayload *payload, uint32_t maxAge,
         OCQualityOfService qos);
 
+/**
+ * Initialize the list of notifications held back by notification policies.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+OCStackResult InitializePendingNotifications(void);
+
+/**
+ * Terminate the list of notifications held back, once the resources are deleted.
+ */
+void TerminatePendingNotifications(void);
+
+/**
+ * Register the event signaled when a notification is held back, so that a thread
+ * waiting for ::OCProcessEvent wakes up to send it when it is due.
+ *
+ * @param event           Event to signal, or NULL to unregister.
+ */
+void RegisterPendingNotificationEvent(oc_event event);
+
+/**
+ * Set the notification policy of a resource.
+ *
+ * @param resource        Observed resource.
+ * @param policy          Notification policy, which is copied.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+OCStackResult SetNotificationPolicy(OCResource *resource, const OCNotificationPolicy *policy);
+
+/**
+ * Delete the notification policy of a resource and drop the notifications it holds back.
+ *
+ * @param resource        Observed resource.
+ */
+void DeleteNotificationPolicy(OCResource *resource);
+
+/**
+ * Hold back a notification of all observers if the notification policy of the resource
+ * does not allow to send it now.
+ *
+ * @param resource        Observed resource.
+ * @param qos             Quality of service of the notification.
+ * @param now             Current time in milliseconds.
+ *
+ * @return true if the notification is held back, false if it is to be sent now.
+ */
+bool DeferObserverNotification(OCResource *resource, OCQualityOfService qos, uint64_t now);
+
+/**
+ * Take a notification held back which is due.
+ *
+ * @param now             Current time in milliseconds.
+ * @param qos             Set to the quality of service of the notification.
+ *
+ * @return resource whose observers are to be notified, NULL if no notification is due.
+ */
+OCResource *TakeDueNotification(uint64_t now, OCQualityOfService *qos);
+
+/**
+ * Take the notifications a resource holds back, whether they are due or not, merged into one.
+ *
+ * @param resource        Observed resource.
+ * @param qos             Set to the quality of service of the notification.
+ *
+ * @return true if the resource held back a notification.
+ */
+bool TakePendingNotification(OCResource *resource, OCQualityOfService *qos);
+
+/**
+ * Get the time left until a notification held back is due.
+ *
+ * @param now             Current time in milliseconds.
+ *
+ * @return time in milliseconds, or UINT32_MAX if no notification is held back.
+ */
+uint32_t GetNextNotificationTimeout(uint64_t now);
+
 /**
  * Delete all observers belonging to the resource.
  *
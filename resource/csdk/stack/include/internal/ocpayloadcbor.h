@@ -34,6 +34,17 @@ OCStackResult OCParsePayload(OCPayload** outPayload, OCPayloadFormat format, OCP
 OCStackResult OCConvertPayload(OCPayload* payload, OCPayloadFormat format,
         uint8_t** outPayload, size_t* size);
 
+/**
+ * Upper bound of the size of the CBOR encoding of a payload.  OCConvertPayload allocates
+ * a buffer of this size and encodes the payload into it once.
+ *
+ * @param payload   Payload to be encoded.
+ * @param format    Format the payload is encoded in.
+ *
+ * @return size in bytes, at least 1.
+ */
+size_t OCGetPayloadSizeBound(OCPayload* payload, OCPayloadFormat format);
+
 #ifdef __cplusplus
 }
 #endif
@@ -185,6 +185,30 @@ typedef struct OCChildResource {
     struct OCChildResource *next;
 } OCChildResource;
 
+/**
+ * Notification policy of a resource and the notifications it holds back.
+ */
+typedef struct OCNotificationState
+{
+    /** Policy set with OCSetResourceNotificationPolicy.*/
+    OCNotificationPolicy policy;
+
+    /** Number of notifications held back; at most 1 if the policy merges them.*/
+    uint32_t pending;
+
+    /** Highest quality of service requested for the notifications held back.*/
+    OCQualityOfService qos;
+
+    /** Time in milliseconds the first notification held back was requested.*/
+    uint64_t pendingTime;
+
+    /** Time in milliseconds the last notification was sent.*/
+    uint64_t sentTime;
+
+    /** Next resource with notifications held back.*/
+    struct OCResource *nextPending;
+} OCNotificationState;
+
 /**
  * Data structure for holding data type and definition for OIC resource.
  */
@@ -263,6 +287,18 @@ typedef struct OCResource {
 
     /** Resource endpoint type(s). */
     OCTpsSchemeFlags endpointType;
+
+    /** Next resource in the same bucket of the index by handle. */
+    struct OCResource *handleIndexNext;
+
+    /** Next resource in the same bucket of the index by URI. */
+    struct OCResource *uriIndexNext;
+
+    /** Creation order of the resource, orders the resource type and interface indexes. */
+    uint64_t indexOrder;
+
+    /** Notification policy, NULL to notify the observers on every change. */
+    OCNotificationState *notificationState;
 } OCResource;
 
 /**
@@ -0,0 +1,141 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+/**
+ * @file
+ *
+ * This file contains the indexes of the resources of the stack. The resources are
+ * found by handle and by URI in hash tables, and the resources of a resource type or
+ * of an interface are kept in inverted indexes, in the order the resources were
+ * created. The indexes are kept up to date by ocstack.c as resources are created,
+ * bound and deleted.
+ */
+
+#ifndef OC_RESOURCE_INDEX_H
+#define OC_RESOURCE_INDEX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "ocstack.h"
+#include "ocresource.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * Adds a resource to the index by handle, and to the index by URI when its URI is set.
+ *
+ * @param resource Resource added to the list of resources.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+OCStackResult OCResourceIndexAdd(OCResource *resource);
+
+/**
+ * Adds a resource to the index by URI once its URI is set.
+ *
+ * @param resource Resource added by OCResourceIndexAdd.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+OCStackResult OCResourceIndexAddUri(OCResource *resource);
+
+/**
+ * Records a resource type bound to a resource.
+ *
+ * @param resource Resource the type is bound to.
+ * @param resourceType Name of the resource type.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+OCStackResult OCResourceIndexAddType(OCResource *resource, const char *resourceType);
+
+/**
+ * Records an interface bound to a resource.
+ *
+ * @param resource Resource the interface is bound to.
+ * @param interfaceName Name of the interface.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+OCStackResult OCResourceIndexAddInterface(OCResource *resource, const char *interfaceName);
+
+/**
+ * Removes a resource, its resource types and its interfaces from the indexes.
+ * It is called before the resource is released.
+ *
+ * @param resource Resource removed from the list of resources.
+ */
+void OCResourceIndexRemove(OCResource *resource);
+
+/**
+ * Releases the indexes, after all the resources were removed.
+ */
+void OCResourceIndexTerminate(void);
+
+/**
+ * Checks that a handle is a resource of the stack. The handle is not dereferenced,
+ * it may point to a deleted resource.
+ *
+ * @param resource Handle to check.
+ *
+ * @return true if the resource is in the index.
+ */
+bool OCResourceIndexContains(const OCResource *resource);
+
+/**
+ * Finds a resource by URI.
+ *
+ * @param uri URI of the resource.
+ *
+ * @return the resource, or NULL if there is no resource with that URI.
+ */
+OCResource *OCResourceIndexFindUri(const char *uri);
+
+/**
+ * Gets the resources a resource type is bound to.
+ *
+ * @param resourceType Name of the resource type.
+ * @param resources Set to the resources in the order they were created. The array is
+ *                  valid until a resource is created, bound or deleted.
+ *
+ * @return the number of resources.
+ */
+size_t OCResourceIndexGetByType(const char *resourceType, OCResource * const **resources);
+
+/**
+ * Gets the resources an interface is bound to.
+ *
+ * @param interfaceName Name of the interface.
+ * @param resources Set to the resources in the order they were created. The array is
+ *                  valid until a resource is created, bound or deleted.
+ *
+ * @return the number of resources.
+ */
+size_t OCResourceIndexGetByInterface(const char *interfaceName,
+                                     OCResource * const **resources);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif // OC_RESOURCE_INDEX_H
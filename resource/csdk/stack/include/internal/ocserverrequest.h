@@ -31,6 +31,8 @@
 
 #include "cacommon.h"
 #include "cainterface.h"
+#include "oic_arena.h"
+#include "oc_refcounter.h"
 
 #include "tree.h"
 
@@ -46,6 +48,25 @@ extern "C"
  */
 typedef OCStackResult (* OCEHResponseHandler)(OCEntityHandlerResponse * ehResponse);
 
+/**
+ * Observer which gets a copy of a notification encoded for another observer of the
+ * same resource, query and accept format.
+ */
+typedef struct OCNotificationTarget
+{
+    /** Token of the observe request.*/
+    char token[CA_MAX_TOKEN_LEN];
+
+    /** Token length of the observe request.*/
+    uint8_t tokenLength;
+
+    /** qos of this notification.*/
+    OCQualityOfService qos;
+
+    /** Remote endpoint address.*/
+    OCDevAddr devAddr;
+} OCNotificationTarget;
+
 /**
  * following structure will be created in occoap and passed up the stack on the server side.
  */
@@ -118,6 +139,23 @@ typedef struct OCServerRequest
     /** Flag indicating notification.*/
     uint8_t notificationFlag;
 
+    /** Other observers to send the encoded notification to, owned by the request.*/
+    OCNotificationTarget *notificationTargets;
+
+    /** Number of notificationTargets.*/
+    size_t numNotificationTargets;
+
+    /** Response payload already encoded for acceptFormat, sent instead of encoding the
+     *  payload of the response. Owned by the request.*/
+    uint8_t *encodedPayload;
+
+    /** Size of encodedPayload.*/
+    size_t encodedPayloadSize;
+
+    /** Memory of the request and of the allocations that live as long as the request,
+     *  released in one piece by DeleteServerRequest.*/
+    OICArena_t *arena;
+
     /** Payload format retrieved from the received request PDU. */
     OCPayloadFormat payloadFormat;
 
@@ -125,11 +163,11 @@ typedef struct OCServerRequest
     size_t payloadSize;
 
     /** payload is retrieved from the payload of the received request PDU.*/
-    uint8_t payload[1];
-
-    // WARNING: Do NOT add attributes after payload as they get overwritten
-    // when payload content gets copied over!
+    uint8_t *payload;
 
+    /** Reference to the received buffer payload points into, NULL when payload is
+     *  a copy in the arena of the request.*/
+    oc_refcounter payloadRef;
 } OCServerRequest;
 
 /**
@@ -168,6 +206,9 @@ typedef struct OCServerResponse
  * @param[in]  query                                Request query.
  * @param[in]  rcvdVendorSpecificHeaderOptions      Received vendor specific header options.
  * @param[in]  payload                              Request JSON payload.
+ * @param[in]  payloadRef                           Reference to the buffer of payload, which
+ *                                                  the request shares instead of copying it.
+ *                                                  NULL to copy payload.
  * @param[in]  requestToken                         Request token.
  * @param[in]  tokenLength                          Request token length.
  * @param[in]  resourceUrl                          URL of resource.
@@ -192,6 +233,7 @@ OCStackResult AddServerRequest (OCServerRequest ** request,
                                 OCHeaderOption * rcvdVendorSpecificHeaderOptions,
                                 OCPayloadFormat payloadFormat,
                                 uint8_t * payload,
+                                oc_refcounter payloadRef,
                                 CAToken_t requestToken,
                                 uint8_t tokenLength,
                                 char * resourceUrl,
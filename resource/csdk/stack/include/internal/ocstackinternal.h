@@ -42,6 +42,7 @@
 
 #include "cacommon.h"
 #include "cainterface.h"
+#include "oc_refcounter.h"
 #include "experimental/securevirtualresourcetypes.h"
 
 #ifdef __cplusplus
@@ -98,6 +99,10 @@ typedef struct
     /** reqJSON is retrieved from the payload of the received request PDU.*/
     uint8_t *payload;
 
+    /** Reference to the received buffer payload points into, shared by the server
+     *  request instead of copying the payload. NULL if payload is not shared.*/
+    oc_refcounter payloadRef;
+
     /** qos is indicating if the request is CON or NON.*/
     OCQualityOfService qos;
 
@@ -178,6 +183,14 @@ OCStackResult OCStackFeedBack(CAToken_t token, uint8_t tokenLength, uint8_t stat
  */
 OCStackResult HandleStackRequests(OCServerProtocolRequest * protocolRequest);
 
+/**
+ * Handles a request received by the connectivity layer.
+ *
+ * @param endPoint      Endpoint the request was received from.
+ * @param requestInfo   Received request.
+ */
+void OCHandleRequests(const CAEndpoint_t* endPoint, const CARequestInfo_t* requestInfo);
+
 OCStackResult SendDirectStackResponse(const CAEndpoint_t* endPoint, const uint16_t coapID,
         const CAResponseResult_t responseResult, const CAMessageType_t type,
         const uint8_t numOptions, const CAHeaderOption_t *options,
@@ -71,6 +71,13 @@ OCStackResult TerminateKeepAlive(OCMode mode);
  */
 void ProcessKeepAlive(void);
 
+/**
+ * Gets the time left until ::ProcessKeepAlive has to send a ping message or
+ * terminate a connection.
+ * @return  time in milliseconds, or UINT32_MAX if there is no KeepAlive connection.
+ */
+uint32_t GetNextKeepAliveTimeout(void);
+
 /**
  * This API will be called from RI layer whenever there is a request for KeepAlive.
  * Virtual Resource.
@@ -36,6 +36,7 @@
 #include "octypes.h"
 
 #include "platform_features.h"
+#include "ocevent.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -144,6 +145,36 @@ OCStackResult OC_CALL OCStopMulticastServer(void);
  */
 OCStackResult OC_CALL OCProcess(void);
 
+/**
+ * Event driven alternative to calling ::OCProcess in a sleep loop.
+ *
+ * Performs the same processing as ::OCProcess and reports how long the caller may
+ * wait on the event registered with ::OCRegisterProcessEvent before the stack needs
+ * to run its timers again (presence, KeepAlive and ping timeouts, held back
+ * notifications). The event is signaled as soon as a request, response or error is
+ * queued by the connectivity layer, or a notification is held back by the notification
+ * policy of a resource, so the caller should call this function again when either happens.
+ *
+ * @param nextEventTime     Maximum time in milliseconds to wait for the process event.
+ *                          UINT32_MAX means there is no pending timer.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+OCStackResult OC_CALL OCProcessEvent(uint32_t *nextEventTime);
+
+/**
+ * Register the event that wakes up a thread calling ::OCProcessEvent.
+ *
+ * @note The event must be unregistered by passing NULL before it is freed. The stack
+ *       only signals the event while holding the lock this function takes, so it may be
+ *       freed as soon as the call unregistering it returns. Only one event can be
+ *       registered at a time; all callers of ::OCProcessEvent in a process share it.
+ *
+ * @param event             Event to be signaled when there is work for ::OCProcessEvent,
+ *                          or NULL to unregister it.
+ */
+void OC_CALL OCRegisterProcessEvent(oc_event event);
+
 /**
  * This function discovers or Perform requests on a specified resource
  * (specified by that Resource's respective URI).
@@ -643,11 +674,33 @@ OCEntityHandler OC_CALL OCGetResourceHandler(OCResourceHandle handle);
  */
 OCStackResult OC_CALL OCNotifyNewAMAvailable(const OCResourceHandle handle);
 
+/**
+ * This function sets the policy for notifying the observers of the resource specified by
+ * handle. It is typically set right after the resource is created. Once set,
+ * ::OCNotifyAllObservers holds back the notifications the policy does not allow yet, and
+ * ::OCProcess sends them when they are due.
+ *
+ * @param handle   Handle of resource.
+ * @param policy   Notification policy, which is copied. NULL sends any notification held back
+ *                 and notifies the observers on every change again.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+OCStackResult OC_CALL OCSetResourceNotificationPolicy(OCResourceHandle handle,
+                                                      const OCNotificationPolicy *policy);
+
 /**
  * This function notify all registered observers that the resource representation has
  * changed. If observation includes a query the client is notified only if the query is valid after
  * the resource representation has changed.
  *
+ * The entity handler is called once for all observers sharing the same query, accept
+ * format, transport adapter and security, with the address of one of them. Resources
+ * which build a representation for each observer use ::OCNotifyListOfObservers.
+ *
+ * If the resource has a notification policy, see ::OCSetResourceNotificationPolicy, the
+ * notification may be held back and sent later from ::OCProcess.
+ *
  * @param handle   Handle of resource.
  * @param qos      Desired quality of service for the observation notifications.
  *
@@ -673,10 +726,31 @@ OCStackResult OC_CALL OCNotifyAllObservers(OCResourceHandle handle, OCQualityOfS
  */
 OCStackResult OC_CALL OCNotifyListOfObservers (OCResourceHandle handle,
                                        OCObservationId  *obsIdList,
-                                       uint8_t          numberOfIds,
+                                       size_t           numberOfIds,
                                        const OCRepPayload *payload,
                                        OCQualityOfService qos);
 
+/**
+ * Notify specific observers with updated value of representation, without building
+ * a list of their observation IDs. The IDs are read from the iterator before any
+ * notification is sent, and the payload is encoded once for each accept format.
+ *
+ * @param handle                    Handle of resource.
+ * @param nextId                    Iterator over the observation IDs that need to be notified.
+ * @param context                   Context passed to nextId.
+ * @param payload                   Object representing the notification
+ * @param qos                       Desired quality of service of the observation notifications.
+ *
+ * @note: The memory for payload is managed by the entity invoking the API.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+OCStackResult OC_CALL OCNotifyObservers(OCResourceHandle handle,
+                                        OCObservationIdIterator nextId,
+                                        void *context,
+                                        const OCRepPayload *payload,
+                                        OCQualityOfService qos);
+
 /**
  * This function sends a response to a request.
  * The response can be a normal, slow, or block (i.e. a response that
@@ -960,6 +1034,16 @@ OCStackResult OC_CALL OCGetIpv6AddrScope(const char *addr, OCTransportFlags *sco
 OCStackResult OC_CALL OCGetRequestPayloadVersion(OCEntityHandlerRequest *ehRequest,
                                   OCPayloadFormat* pContentFormat, uint16_t* pAcceptVersion);
 
+/**
+ * Get the statistics of the cache of the responses to discovery (/oic/res) requests.
+ * The hit rate is hits / (hits + misses).
+ *
+ * @param[out] stats        statistics of the cache.
+ *
+ * @return ::OC_STACK_OK if successful, ::OC_STACK_INVALID_PARAM if stats is NULL.
+ */
+OCStackResult OC_CALL OCGetDiscoveryCacheStats(OCDiscoveryCacheStats *stats);
+
 #ifdef TCP_ADAPTER
 /**
  * Send a ping message to the remote TCP server
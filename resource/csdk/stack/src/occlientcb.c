@@ -43,9 +43,221 @@
 //      This should be static variable after we make a presence feature separately.
 struct ClientCB *g_cbList = NULL;
 
+/// Initial number of buckets of the token and handle indexes.
+#define CLIENTCB_INITIAL_TABLE_SIZE 16
+
+/// Number of nodes in g_cbList.
+static size_t g_cbCount = 0;
+
+/// Token index of g_cbList, chained through ClientCB::tokenNext.
+static ClientCB **g_tokenTable = NULL;
+
+/// Handle index of g_cbList, chained through ClientCB::handleNext.
+static ClientCB **g_handleTable = NULL;
+
+/// Number of buckets of both indexes, a power of 2.
+static size_t g_tableSize = 0;
+
+/// Nodes with a TTL, as a binary min-heap ordered by TTL.
+static ClientCB **g_ttlHeap = NULL;
+static size_t g_ttlCount = 0;
+static size_t g_ttlCapacity = 0;
+
 //-------------------------------------------------------------------------------------------------
 // Local functions
 //-------------------------------------------------------------------------------------------------
+static size_t GetTokenBucket(const CAToken_t token, uint8_t tokenLength)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (uint8_t i = 0; i < tokenLength; i++)
+    {
+        hash = (hash ^ (uint8_t)token[i]) * 16777619u;
+    }
+    return hash & (g_tableSize - 1);
+}
+
+static size_t GetHandleBucket(const OCDoHandle handle)
+{
+    uintptr_t value = (uintptr_t)handle;
+    return (size_t)((value >> 4) ^ (value >> 12)) & (g_tableSize - 1);
+}
+
+static void InsertIntoIndexes(ClientCB *cbNode)
+{
+    size_t bucket = GetTokenBucket(cbNode->token, cbNode->tokenLength);
+    cbNode->tokenNext = g_tokenTable[bucket];
+    g_tokenTable[bucket] = cbNode;
+
+    bucket = GetHandleBucket(cbNode->handle);
+    cbNode->handleNext = g_handleTable[bucket];
+    g_handleTable[bucket] = cbNode;
+}
+
+static void RemoveFromIndexes(ClientCB *cbNode)
+{
+    ClientCB **link = &g_tokenTable[GetTokenBucket(cbNode->token, cbNode->tokenLength)];
+    while (*link && *link != cbNode)
+    {
+        link = &(*link)->tokenNext;
+    }
+    if (*link)
+    {
+        *link = cbNode->tokenNext;
+    }
+
+    link = &g_handleTable[GetHandleBucket(cbNode->handle)];
+    while (*link && *link != cbNode)
+    {
+        link = &(*link)->handleNext;
+    }
+    if (*link)
+    {
+        *link = cbNode->handleNext;
+    }
+}
+
+/*
+ * Makes sure that the indexes and the expiry heap can take one more node. The
+ * indexes are doubled once they hold one node per bucket on average.
+ */
+static OCStackResult ReserveClientCB(void)
+{
+    if (!g_tokenTable)
+    {
+        g_tokenTable = (ClientCB **) OICCalloc(CLIENTCB_INITIAL_TABLE_SIZE, sizeof(ClientCB *));
+        g_handleTable = (ClientCB **) OICCalloc(CLIENTCB_INITIAL_TABLE_SIZE, sizeof(ClientCB *));
+        if (!g_tokenTable || !g_handleTable)
+        {
+            OICFree(g_tokenTable);
+            OICFree(g_handleTable);
+            g_tokenTable = NULL;
+            g_handleTable = NULL;
+            return OC_STACK_NO_MEMORY;
+        }
+        g_tableSize = CLIENTCB_INITIAL_TABLE_SIZE;
+    }
+
+    // Every node may have a TTL, so the heap never has to grow in SetClientCBTTL().
+    if (g_cbCount >= g_ttlCapacity)
+    {
+        size_t capacity = g_ttlCapacity ? g_ttlCapacity * 2 : CLIENTCB_INITIAL_TABLE_SIZE;
+        ClientCB **heap = (ClientCB **) OICRealloc(g_ttlHeap, capacity * sizeof(ClientCB *));
+        if (!heap)
+        {
+            return OC_STACK_NO_MEMORY;
+        }
+        g_ttlHeap = heap;
+        g_ttlCapacity = capacity;
+    }
+
+    if (g_cbCount >= g_tableSize)
+    {
+        ClientCB **tokenTable = (ClientCB **) OICCalloc(g_tableSize * 2, sizeof(ClientCB *));
+        ClientCB **handleTable = (ClientCB **) OICCalloc(g_tableSize * 2, sizeof(ClientCB *));
+        if (!tokenTable || !handleTable)
+        {
+            // Keep the smaller indexes, lookups are only slower.
+            OICFree(tokenTable);
+            OICFree(handleTable);
+            return OC_STACK_OK;
+        }
+
+        OICFree(g_tokenTable);
+        OICFree(g_handleTable);
+        g_tokenTable = tokenTable;
+        g_handleTable = handleTable;
+        g_tableSize *= 2;
+
+        ClientCB *out = NULL;
+        LL_FOREACH(g_cbList, out)
+        {
+            InsertIntoIndexes(out);
+        }
+    }
+
+    return OC_STACK_OK;
+}
+
+static void SetTTLHeapNode(size_t index, ClientCB *cbNode)
+{
+    g_ttlHeap[index] = cbNode;
+    cbNode->ttlIndex = index;
+}
+
+static void SiftUpTTLHeap(size_t index)
+{
+    ClientCB *cbNode = g_ttlHeap[index];
+    while (index > 0)
+    {
+        size_t parent = (index - 1) / 2;
+        if (g_ttlHeap[parent]->TTL <= cbNode->TTL)
+        {
+            break;
+        }
+        SetTTLHeapNode(index, g_ttlHeap[parent]);
+        index = parent;
+    }
+    SetTTLHeapNode(index, cbNode);
+}
+
+static void SiftDownTTLHeap(size_t index)
+{
+    ClientCB *cbNode = g_ttlHeap[index];
+    while (true)
+    {
+        size_t child = 2 * index + 1;
+        if (child >= g_ttlCount)
+        {
+            break;
+        }
+        if (child + 1 < g_ttlCount && g_ttlHeap[child + 1]->TTL < g_ttlHeap[child]->TTL)
+        {
+            child++;
+        }
+        if (cbNode->TTL <= g_ttlHeap[child]->TTL)
+        {
+            break;
+        }
+        SetTTLHeapNode(index, g_ttlHeap[child]);
+        index = child;
+    }
+    SetTTLHeapNode(index, cbNode);
+}
+
+static void InsertIntoTTLHeap(ClientCB *cbNode)
+{
+    assert(g_ttlCount < g_ttlCapacity);
+
+    SetTTLHeapNode(g_ttlCount, cbNode);
+    g_ttlCount++;
+    SiftUpTTLHeap(cbNode->ttlIndex);
+}
+
+static void RemoveFromTTLHeap(ClientCB *cbNode)
+{
+    size_t index = cbNode->ttlIndex;
+    if (index >= g_ttlCount || g_ttlHeap[index] != cbNode)
+    {
+        return;
+    }
+
+    g_ttlCount--;
+    if (index < g_ttlCount)
+    {
+        ClientCB *last = g_ttlHeap[g_ttlCount];
+        SetTTLHeapNode(index, last);
+        if (index > 0 && g_ttlHeap[(index - 1) / 2]->TTL > last->TTL)
+        {
+            SiftUpTTLHeap(index);
+        }
+        else
+        {
+            SiftDownTTLHeap(index);
+        }
+    }
+}
+
 static void DeleteClientCBInternal(ClientCB * cbNode)
 {
     assert(cbNode);
@@ -56,7 +268,13 @@ static void DeleteClientCBInternal(ClientCB * cbNode)
     OIC_TRACE_BUFFER("OIC_RI_CLIENTCB:DeleteClientCB:token:",
                      (const uint8_t *)cbNode->token, cbNode->tokenLength);
 
-    LL_DELETE(g_cbList, cbNode);
+    DL_DELETE(g_cbList, cbNode);
+    RemoveFromIndexes(cbNode);
+    if (cbNode->TTL != 0)
+    {
+        RemoveFromTTLHeap(cbNode);
+    }
+    g_cbCount--;
     CADestroyToken(cbNode->token);
     OICFree(cbNode->devAddr);
     OICFree(cbNode->handle);
@@ -106,27 +324,25 @@ static void DeleteClientCBInternal(ClientCB * cbNode)
 }
 
 /*
- * This function checks if the node is past its time to live and
- * deletes it if timed-out. Calling this function with a  presence or observe
- * callback with ttl set to 0 will not delete anything as presence nodes have
- * their own mechanisms for timeouts. A null argument will cause the function to
- * silently return.
+ * This function deletes the nodes which are past their time to live. Presence
+ * and observe callbacks with ttl set to 0 are never deleted here as presence
+ * nodes have their own mechanisms for timeouts and observes can be explicitly
+ * cancelled.
  */
-static void CheckAndDeleteTimedOutCB(ClientCB * cbNode)
+static void DeleteTimedOutCBs(void)
 {
-    assert(cbNode);
-
-    if (cbNode->TTL == 0)
+    if (!g_ttlCount)
     {
         return;
     }
+
     coap_tick_t now;
     coap_ticks(&now);
 
-    if (cbNode->TTL < now)
+    while (g_ttlCount && g_ttlHeap[0]->TTL < now)
     {
         OIC_LOG(INFO, TAG, "Deleting timed-out callback");
-        DeleteClientCBInternal(cbNode);
+        DeleteClientCBInternal(g_ttlHeap[0]);
     }
 }
 
@@ -178,6 +394,13 @@ OCStackResult AddClientCB(ClientCB** clientCB, OCCallbackData* cbData,
 
     ClientCB *cbNode = NULL;
 
+    if (OC_STACK_OK != ReserveClientCB())
+    {
+        OIC_LOG(ERROR, TAG, "Out of memory");
+        *clientCB = NULL;
+        goto exit;
+    }
+
 #ifdef WITH_PRESENCE
     if (method == OC_REST_PRESENCE)
     {   // Retrieve the presence callback structure for this specific requestUri.
@@ -272,7 +495,13 @@ OCStackResult AddClientCB(ClientCB** clientCB, OCCallbackData* cbData,
         cbNode->devAddr = devAddr;          // I own it now
         OIC_LOG_V(INFO, TAG, "Added Callback for uri : %s", requestUri);
         OIC_TRACE_MARK(%s:AddClientCB:uri:%s, TAG, requestUri);
-        LL_APPEND(g_cbList, cbNode);
+        DL_APPEND(g_cbList, cbNode);
+        g_cbCount++;
+        InsertIntoIndexes(cbNode);
+        if (cbNode->TTL != 0)
+        {
+            InsertIntoTTLHeap(cbNode);
+        }
         *clientCB = cbNode;
     }
 #ifdef WITH_PRESENCE
@@ -319,21 +548,36 @@ exit:
 
 void DeleteClientCB(ClientCB * cbNode)
 {
-    if (cbNode)
+    if (cbNode && g_handleTable)
     {
-        ClientCB* out = NULL;
-        ClientCB* tmp = NULL;
-        LL_FOREACH_SAFE(g_cbList, out, tmp)
+        ClientCB* out = g_handleTable[GetHandleBucket(cbNode->handle)];
+        while (out)
         {
             if (cbNode == out)
             {
                 DeleteClientCBInternal(out);
                 break;
             }
+            out = out->handleNext;
         }
     }
 }
 
+void SetClientCBTTL(ClientCB *cbNode, uint32_t ttl)
+{
+    assert(cbNode);
+
+    if (cbNode->TTL != 0)
+    {
+        RemoveFromTTLHeap(cbNode);
+    }
+    cbNode->TTL = ttl;
+    if (cbNode->TTL != 0)
+    {
+        InsertIntoTTLHeap(cbNode);
+    }
+}
+
 void DeleteClientCBList(void)
 {
     ClientCB* out = NULL;
@@ -343,6 +587,18 @@ void DeleteClientCBList(void)
         DeleteClientCBInternal(out);
     }
     g_cbList = NULL;
+    g_cbCount = 0;
+
+    OICFree(g_tokenTable);
+    OICFree(g_handleTable);
+    g_tokenTable = NULL;
+    g_handleTable = NULL;
+    g_tableSize = 0;
+
+    OICFree(g_ttlHeap);
+    g_ttlHeap = NULL;
+    g_ttlCount = 0;
+    g_ttlCapacity = 0;
 }
 
 ClientCB* GetClientCBUsingToken(const CAToken_t token,
@@ -357,18 +613,20 @@ ClientCB* GetClientCBUsingToken(const CAToken_t token,
     OIC_LOG (INFO, TAG, "Looking for token");
     OIC_LOG_BUFFER(INFO, TAG, (const uint8_t *)token, tokenLength);
 
-    ClientCB* out = NULL;
-    ClientCB* tmp = NULL;
-    LL_FOREACH_SAFE(g_cbList, out, tmp)
+    DeleteTimedOutCBs();
+
+    if (g_tokenTable)
     {
-        /* de-annotate below line if want to see all token in g_cbList */
-        //OIC_LOG_BUFFER(INFO, TAG, (const uint8_t *)out->token, tokenLength);
-        if (memcmp(out->token, token, tokenLength) == 0)
+        ClientCB* out = g_tokenTable[GetTokenBucket(token, tokenLength)];
+        while (out)
         {
-            OIC_LOG(INFO, TAG, "Found in callback list");
-            return out;
+            if (out->tokenLength == tokenLength && memcmp(out->token, token, tokenLength) == 0)
+            {
+                OIC_LOG(INFO, TAG, "Found in callback list");
+                return out;
+            }
+            out = out->tokenNext;
         }
-        CheckAndDeleteTimedOutCB(out);
     }
 
     OIC_LOG(INFO, TAG, "Callback Not found!");
@@ -385,16 +643,20 @@ ClientCB* GetClientCBUsingHandle(const OCDoHandle handle)
 
     OIC_LOG(INFO, TAG,  "Looking for handle");
 
-    ClientCB* out = NULL;
-    ClientCB* tmp = NULL;
-    LL_FOREACH_SAFE(g_cbList, out, tmp)
+    DeleteTimedOutCBs();
+
+    if (g_handleTable)
     {
-        if (out->handle == handle)
+        ClientCB* out = g_handleTable[GetHandleBucket(handle)];
+        while (out)
         {
-            OIC_LOG(INFO, TAG, "Found in callback list");
-            return out;
+            if (out->handle == handle)
+            {
+                OIC_LOG(INFO, TAG, "Found in callback list");
+                return out;
+            }
+            out = out->handleNext;
         }
-        CheckAndDeleteTimedOutCB(out);
     }
 
     OIC_LOG(INFO, TAG, "Callback Not found!");
@@ -412,9 +674,10 @@ ClientCB* GetClientCBUsingUri(const char *requestUri)
 
     OIC_LOG_V(INFO, TAG, "Looking for uri %s", requestUri);
 
+    DeleteTimedOutCBs();
+
     ClientCB* out = NULL;
-    ClientCB* tmp = NULL;
-    LL_FOREACH_SAFE(g_cbList, out, tmp)
+    LL_FOREACH(g_cbList, out)
     {
         /* de-annotate below line if want to see all URI in g_cbList */
         //OIC_LOG_V(INFO, TAG, "%s", out->requestUri);
@@ -423,7 +686,6 @@ ClientCB* GetClientCBUsingUri(const char *requestUri)
             OIC_LOG(INFO, TAG, "Found in callback list");
             return out;
         }
-        CheckAndDeleteTimedOutCB(out);
     }
 
     OIC_LOG(INFO, TAG, "Callback Not found!");
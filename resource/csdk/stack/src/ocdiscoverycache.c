@@ -0,0 +1,320 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <string.h>
+
+#include "ocdiscoverycache.h"
+#include "ocatomic.h"
+#include "oic_malloc.h"
+#include "oic_string.h"
+#include "oic_time.h"
+#include "experimental/logger.h"
+
+#define TAG "OIC_RI_DISCOVERYCACHE"
+
+/** Flags of the request address which select the endpoints of the response. */
+#define OC_DISCOVERY_CACHE_FLAGS (OC_FLAG_SECURE | OC_MASK_FAMS)
+
+typedef struct OCDiscoveryCacheEntry
+{
+    /** Next entry, less recently used. */
+    struct OCDiscoveryCacheEntry *next;
+
+    /** Generation of the cache the response was built in. */
+    uint32_t generation;
+
+    /** Time the response expires at, in milliseconds. */
+    uint64_t expiry;
+
+    /** Device ID the response was built with. */
+    char deviceId[UUID_STRING_SIZE];
+
+    OCVirtualResources virtualUri;
+    char *interfaceQuery;
+    char *resourceTypeQuery;
+    OCPayloadFormat acceptFormat;
+    uint16_t acceptVersion;
+    OCTransportAdapter adapter;
+    OCTransportFlags flags;
+
+    /** Encoded response. */
+    uint8_t *payload;
+    size_t payloadSize;
+} OCDiscoveryCacheEntry;
+
+/** Cached responses, most recently used first. */
+static OCDiscoveryCacheEntry *g_entries = NULL;
+
+/** Incremented by OCDiscoveryCacheInvalidate, from any thread. */
+static volatile int32_t g_generation = 0;
+
+/**
+ * Statistics, updated by the thread handling requests and read by
+ * OCGetDiscoveryCacheStats from any thread.
+ */
+static volatile int32_t g_entryCount = 0;
+static volatile int32_t g_hits = 0;
+static volatile int32_t g_misses = 0;
+
+static uint32_t ReadCounter(volatile int32_t *counter)
+{
+    return (uint32_t)oc_atomic_add(counter, 0);
+}
+
+static void ResetCounter(volatile int32_t *counter)
+{
+    int32_t value;
+    do
+    {
+        value = oc_atomic_add(counter, 0);
+    } while (!oc_atomic_cmpxchg(counter, value, 0));
+}
+
+static void FreeEntry(OCDiscoveryCacheEntry *entry)
+{
+    OICFree(entry->interfaceQuery);
+    OICFree(entry->resourceTypeQuery);
+    OICFree(entry->payload);
+    OICFree(entry);
+}
+
+static bool SameQuery(const char *cached, const char *query)
+{
+    return (!cached && !query) || (cached && query && 0 == strcmp(cached, query));
+}
+
+/**
+ * Releases the entries of previous generations, the expired entries and, if the device
+ * ID changed, all entries.
+ */
+static void RemoveStaleEntries(uint32_t generation, const char *deviceId)
+{
+    uint64_t now = OICGetCurrentTime(TIME_IN_MS);
+    OCDiscoveryCacheEntry **link = &g_entries;
+    while (*link)
+    {
+        OCDiscoveryCacheEntry *entry = *link;
+        if (entry->generation != generation || now >= entry->expiry
+            || 0 != strncmp(entry->deviceId, deviceId, sizeof(entry->deviceId)))
+        {
+            *link = entry->next;
+            oc_atomic_decrement(&g_entryCount);
+            FreeEntry(entry);
+        }
+        else
+        {
+            link = &entry->next;
+        }
+    }
+}
+
+static OCDiscoveryCacheEntry **FindEntry(OCVirtualResources virtualUri,
+                                         const char *interfaceQuery,
+                                         const char *resourceTypeQuery,
+                                         const OCServerRequest *request)
+{
+    OCTransportFlags flags = (OCTransportFlags)(request->devAddr.flags & OC_DISCOVERY_CACHE_FLAGS);
+    for (OCDiscoveryCacheEntry **link = &g_entries; *link; link = &(*link)->next)
+    {
+        OCDiscoveryCacheEntry *entry = *link;
+        if (entry->virtualUri == virtualUri
+            && entry->acceptFormat == request->acceptFormat
+            && entry->acceptVersion == request->acceptVersion
+            && entry->adapter == request->devAddr.adapter
+            && entry->flags == flags
+            && SameQuery(entry->interfaceQuery, interfaceQuery)
+            && SameQuery(entry->resourceTypeQuery, resourceTypeQuery))
+        {
+            return link;
+        }
+    }
+    return NULL;
+}
+
+static const char *GetDeviceId(void)
+{
+    const char *deviceId = OCGetServerInstanceIDString();
+    return deviceId ? deviceId : "";
+}
+
+bool OCDiscoveryCacheAccepts(const OCServerRequest *request)
+{
+#ifdef RD_SERVER
+    // The resources published to the resource directory are not tracked by the cache.
+    OC_UNUSED(request);
+    return false;
+#else
+    if (!request)
+    {
+        return false;
+    }
+    switch (request->acceptFormat)
+    {
+        case OC_FORMAT_UNDEFINED:
+        case OC_FORMAT_CBOR:
+        case OC_FORMAT_VND_OCF_CBOR:
+            return true;
+        default:
+            return false;
+    }
+#endif
+}
+
+uint8_t *OCDiscoveryCacheGet(OCVirtualResources virtualUri,
+                             const char *interfaceQuery,
+                             const char *resourceTypeQuery,
+                             const OCServerRequest *request,
+                             size_t *payloadSize,
+                             uint32_t *generation)
+{
+    if (!request || !payloadSize || !generation)
+    {
+        return NULL;
+    }
+
+    *payloadSize = 0;
+    *generation = (uint32_t)g_generation;
+    RemoveStaleEntries(*generation, GetDeviceId());
+
+    OCDiscoveryCacheEntry **link = FindEntry(virtualUri, interfaceQuery, resourceTypeQuery,
+                                             request);
+    if (!link)
+    {
+        oc_atomic_increment(&g_misses);
+        return NULL;
+    }
+
+    uint8_t *payload = (uint8_t *)OICMalloc((*link)->payloadSize);
+    if (!payload)
+    {
+        OIC_LOG(ERROR, TAG, "Failed to copy cached discovery response");
+        oc_atomic_increment(&g_misses);
+        return NULL;
+    }
+    memcpy(payload, (*link)->payload, (*link)->payloadSize);
+    *payloadSize = (*link)->payloadSize;
+
+    // Move the entry to the front.
+    OCDiscoveryCacheEntry *entry = *link;
+    *link = entry->next;
+    entry->next = g_entries;
+    g_entries = entry;
+
+    oc_atomic_increment(&g_hits);
+    OIC_LOG_V(DEBUG, TAG, "Cached discovery response of %zu bytes", *payloadSize);
+    return payload;
+}
+
+void OCDiscoveryCachePut(OCVirtualResources virtualUri,
+                         const char *interfaceQuery,
+                         const char *resourceTypeQuery,
+                         const OCServerRequest *request,
+                         const uint8_t *payload,
+                         size_t payloadSize,
+                         uint32_t generation)
+{
+    if (!request || !payload || !payloadSize || generation != (uint32_t)g_generation)
+    {
+        return;
+    }
+
+    const char *deviceId = GetDeviceId();
+    RemoveStaleEntries(generation, deviceId);
+    if (FindEntry(virtualUri, interfaceQuery, resourceTypeQuery, request))
+    {
+        return;
+    }
+
+    OCDiscoveryCacheEntry *entry =
+        (OCDiscoveryCacheEntry *)OICCalloc(1, sizeof(OCDiscoveryCacheEntry));
+    if (!entry)
+    {
+        return;
+    }
+    entry->payload = (uint8_t *)OICMalloc(payloadSize);
+    if ((interfaceQuery && !(entry->interfaceQuery = OICStrdup(interfaceQuery)))
+        || (resourceTypeQuery && !(entry->resourceTypeQuery = OICStrdup(resourceTypeQuery)))
+        || !entry->payload)
+    {
+        OIC_LOG(ERROR, TAG, "Failed to cache discovery response");
+        FreeEntry(entry);
+        return;
+    }
+    memcpy(entry->payload, payload, payloadSize);
+    entry->payloadSize = payloadSize;
+    entry->generation = generation;
+    entry->expiry = OICGetCurrentTime(TIME_IN_MS) + OC_DISCOVERY_CACHE_LIFETIME_MS;
+    OICStrcpy(entry->deviceId, sizeof(entry->deviceId), deviceId);
+    entry->virtualUri = virtualUri;
+    entry->acceptFormat = request->acceptFormat;
+    entry->acceptVersion = request->acceptVersion;
+    entry->adapter = request->devAddr.adapter;
+    entry->flags = (OCTransportFlags)(request->devAddr.flags & OC_DISCOVERY_CACHE_FLAGS);
+
+    // Drop the least recently used entry.
+    if (ReadCounter(&g_entryCount) >= OC_DISCOVERY_CACHE_SIZE)
+    {
+        OCDiscoveryCacheEntry **link = &g_entries;
+        while ((*link)->next)
+        {
+            link = &(*link)->next;
+        }
+        FreeEntry(*link);
+        *link = NULL;
+        oc_atomic_decrement(&g_entryCount);
+    }
+
+    entry->next = g_entries;
+    g_entries = entry;
+    oc_atomic_increment(&g_entryCount);
+}
+
+void OCDiscoveryCacheInvalidate(void)
+{
+    oc_atomic_increment(&g_generation);
+}
+
+void OCDiscoveryCacheTerminate(void)
+{
+    while (g_entries)
+    {
+        OCDiscoveryCacheEntry *entry = g_entries;
+        g_entries = entry->next;
+        FreeEntry(entry);
+    }
+    ResetCounter(&g_entryCount);
+    ResetCounter(&g_generation);
+    ResetCounter(&g_hits);
+    ResetCounter(&g_misses);
+}
+
+OCStackResult OC_CALL OCGetDiscoveryCacheStats(OCDiscoveryCacheStats *stats)
+{
+    if (!stats)
+    {
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    stats->hits = ReadCounter(&g_hits);
+    stats->misses = ReadCounter(&g_misses);
+    stats->invalidations = ReadCounter(&g_generation);
+    stats->entries = ReadCounter(&g_entryCount);
+    return OC_STACK_OK;
+}
@@ -18,6 +18,7 @@
 //
 //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
 
+#include <assert.h>
 #include <string.h>
 #include "ocstack.h"
 #include "ocstackconfig.h"
@@ -30,6 +31,7 @@
 #include "ocpayload.h"
 #include "ocserverrequest.h"
 #include "experimental/logger.h"
+#include "octhread.h"
 
 #include <coap/utlist.h>
 #include <coap/pdu.h>
@@ -112,7 +114,7 @@ static OCStackResult SendObserveNotification(ResourceObserver *observer,
 
     result = AddServerRequest(&request, 0, 0, 1, OC_REST_GET,
                               0, sequenceNum, qos,
-                              observer->query, NULL, OC_FORMAT_UNDEFINED, NULL,
+                              observer->query, NULL, OC_FORMAT_UNDEFINED, NULL, NULL,
                               observer->token, observer->tokenLength,
                               observer->resUri, 0, observer->acceptFormat,
                               observer->acceptVersion, &observer->devAddr);
@@ -137,6 +139,190 @@ static OCStackResult SendObserveNotification(ResourceObserver *observer,
     return result;
 }
 
+/**
+ * Observers of a resource which get the same notification.
+ */
+typedef struct
+{
+    /** Observer for which the entity handler is called.*/
+    ResourceObserver *observer;
+
+    /** Server request of the notification, listing the other observers as targets.*/
+    OCServerRequest *request;
+
+    /** Allocated length of the notification targets of the request.*/
+    size_t targetCapacity;
+} NotificationGroup;
+
+static bool IsSameString(const char *str1, const char *str2)
+{
+    return 0 == strcmp(str1 ? str1 : "", str2 ? str2 : "");
+}
+
+/**
+ * Check if two observers can share the encoding of a given representation.
+ */
+static bool IsSameEncoding(const ResourceObserver *observer1,
+                           const ResourceObserver *observer2)
+{
+    return observer1->acceptFormat == observer2->acceptFormat &&
+           observer1->acceptVersion == observer2->acceptVersion &&
+           IsSameString(observer1->resUri, observer2->resUri);
+}
+
+/**
+ * Check if two observers can share the representation and encoding of a notification.
+ * The entity handler only sees the devAddr of the first observer of a group, so observers
+ * on another transport adapter, or with another security, get their own entity handler
+ * call.
+ */
+static bool IsSameNotification(const ResourceObserver *observer1,
+                               const ResourceObserver *observer2)
+{
+    return IsSameEncoding(observer1, observer2) &&
+           IsSameString(observer1->query, observer2->query) &&
+           observer1->devAddr.adapter == observer2->devAddr.adapter &&
+           (observer1->devAddr.flags & OC_FLAG_SECURE) ==
+           (observer2->devAddr.flags & OC_FLAG_SECURE);
+}
+
+static OCStackResult AddNotificationTarget(NotificationGroup *group,
+                                           const ResourceObserver *observer,
+                                           OCQualityOfService qos)
+{
+    OCServerRequest *request = group->request;
+
+    if (observer->tokenLength > CA_MAX_TOKEN_LEN)
+    {
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    if (request->numNotificationTargets == group->targetCapacity)
+    {
+        size_t capacity = group->targetCapacity ? group->targetCapacity * 2 : 4;
+        OCNotificationTarget *targets = (OCNotificationTarget *) OICRealloc(
+                request->notificationTargets, capacity * sizeof(OCNotificationTarget));
+        if (!targets)
+        {
+            return OC_STACK_NO_MEMORY;
+        }
+        request->notificationTargets = targets;
+        group->targetCapacity = capacity;
+    }
+
+    OCNotificationTarget *target = &request->notificationTargets[request->numNotificationTargets];
+    memcpy(target->token, observer->token, observer->tokenLength);
+    target->tokenLength = observer->tokenLength;
+    target->qos = qos;
+    target->devAddr = observer->devAddr;
+    request->numNotificationTargets++;
+
+    return OC_STACK_OK;
+}
+
+/**
+ * Notify all observers of a resource. The entity handler is called, and its response
+ * encoded, once for each group of observers sharing the same query, accept format,
+ * transport adapter and security. Only the token, message type and id differ between
+ * the notifications of a group. Resources whose representation depends on the address
+ * of each observer notify them through SendListObserverNotification instead.
+ *
+ * @param method RESTful method.
+ * @param resPtr Observed resource.
+ * @param qos Quality of service of resource.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+static OCStackResult SendGroupedObserverNotification(OCMethod method, OCResource *resPtr,
+                                                     OCQualityOfService qos)
+{
+    OCStackResult result = OC_STACK_OK;
+    ResourceObserver *resourceObserver = NULL;
+    size_t numObservers = 0;
+    size_t numGroups = 0;
+
+    LL_FOREACH(resPtr->observersHead, resourceObserver)
+    {
+        numObservers++;
+    }
+
+    NotificationGroup *groups = (NotificationGroup *) OICCalloc(numObservers,
+                                                                sizeof(NotificationGroup));
+    if (!groups)
+    {
+        // Fall back to one entity handler call per observer.
+        LL_FOREACH(resPtr->observersHead, resourceObserver)
+        {
+            qos = DetermineObserverQoS(method, resourceObserver, qos);
+            if (OC_STACK_OK != SendObserveNotification(resourceObserver, resPtr->sequenceNum, qos))
+            {
+                result = OC_STACK_ERROR;
+            }
+        }
+        return result;
+    }
+
+    // Create the server requests before calling any entity handler, as they may respond
+    // synchronously.
+    LL_FOREACH(resPtr->observersHead, resourceObserver)
+    {
+        qos = DetermineObserverQoS(method, resourceObserver, qos);
+
+        NotificationGroup *group = NULL;
+        for (size_t i = 0; i < numGroups; i++)
+        {
+            if (IsSameNotification(groups[i].observer, resourceObserver))
+            {
+                group = &groups[i];
+                break;
+            }
+        }
+
+        if (!group || OC_STACK_OK != AddNotificationTarget(group, resourceObserver, qos))
+        {
+            group = &groups[numGroups];
+            if (OC_STACK_OK != AddServerRequest(&group->request, 0, 0, 1, OC_REST_GET,
+                        0, resPtr->sequenceNum, qos, resourceObserver->query,
+                        NULL, OC_FORMAT_UNDEFINED, NULL, NULL,
+                        resourceObserver->token, resourceObserver->tokenLength,
+                        resourceObserver->resUri, 0, resourceObserver->acceptFormat,
+                        resourceObserver->acceptVersion, &resourceObserver->devAddr))
+            {
+                result = OC_STACK_ERROR;
+                continue;
+            }
+            group->request->observeResult = OC_STACK_OK;
+            group->observer = resourceObserver;
+            numGroups++;
+        }
+
+        // Reset Observer TTL.
+        resourceObserver->TTL = GetTicks(MAX_OBSERVER_TTL_SECONDS * MILLISECONDS_PER_SECOND);
+    }
+
+    for (size_t i = 0; i < numGroups; i++)
+    {
+        OIC_LOG_V(INFO, TAG, "Notifying %" PRIuPTR " observers with one representation",
+                  groups[i].request->numNotificationTargets + 1);
+
+        ResourceHandling resHandling = OC_RESOURCE_VIRTUAL;
+        OCResource *resource = NULL;
+        OCStackResult groupResult = DetermineResourceHandling(groups[i].request, &resHandling,
+                                                              &resource);
+        if (OC_STACK_OK == groupResult)
+        {
+            groupResult = ProcessRequest(resHandling, resource, groups[i].request);
+        }
+        if (OC_STACK_OK != groupResult)
+        {
+            result = OC_STACK_ERROR;
+        }
+    }
+
+    OICFree(groups);
+    return result;
+}
+
 #ifdef WITH_PRESENCE
 OCStackResult SendAllObserverNotification (OCMethod method, OCResource *resPtr, uint32_t maxAge,
         OCPresenceTrigger trigger, OCResourceType *resourceType, OCQualityOfService qos)
@@ -156,6 +342,19 @@ OCStackResult SendAllObserverNotification (OCMethod method, OCResource *resPtr,
         return OC_STACK_NO_OBSERVERS;
     }
 
+#ifdef WITH_PRESENCE
+    if (method != OC_REST_PRESENCE)
+    {
+#endif
+        OCStackResult result = SendGroupedObserverNotification(method, resPtr, qos);
+        if (OC_STACK_OK != result)
+        {
+            OIC_LOG(ERROR, TAG, "Observer notification error");
+        }
+        return result;
+#ifdef WITH_PRESENCE
+    }
+
     OCStackResult result = OC_STACK_ERROR;
     ResourceObserver * resourceObserver = resPtr->observersHead;
     OCServerRequest * request = NULL;
@@ -164,53 +363,41 @@ OCStackResult SendAllObserverNotification (OCMethod method, OCResource *resPtr,
     // Find clients that are observing this resource
     while (resourceObserver)
     {
-#ifdef WITH_PRESENCE
-        if (method != OC_REST_PRESENCE)
-        {
-#endif
-            qos = DetermineObserverQoS(method, resourceObserver, qos);
-            result = SendObserveNotification(resourceObserver, resPtr->sequenceNum, qos);
-#ifdef WITH_PRESENCE
-        }
-        else
+        OCEntityHandlerResponse ehResponse = {0};
+
+        //This is effectively the implementation for the presence entity handler.
+        OIC_LOG(DEBUG, TAG, "This notification is for Presence");
+        result = AddServerRequest(&request, 0, 0, 1, OC_REST_GET,
+                0, resPtr->sequenceNum, qos, resourceObserver->query,
+                NULL, OC_FORMAT_UNDEFINED, NULL, NULL,
+                resourceObserver->token, resourceObserver->tokenLength,
+                resourceObserver->resUri, 0, resourceObserver->acceptFormat,
+                resourceObserver->acceptVersion, &resourceObserver->devAddr);
+
+        if (result == OC_STACK_OK)
         {
-            OCEntityHandlerResponse ehResponse = {0};
+            OCPresencePayload* presenceResBuf = OCPresencePayloadCreate(
+                    resPtr->sequenceNum, maxAge, trigger,
+                    resourceType ? resourceType->resourcetypename : NULL);
 
-            //This is effectively the implementation for the presence entity handler.
-            OIC_LOG(DEBUG, TAG, "This notification is for Presence");
-            result = AddServerRequest(&request, 0, 0, 1, OC_REST_GET,
-                    0, resPtr->sequenceNum, qos, resourceObserver->query,
-                    NULL, OC_FORMAT_UNDEFINED, NULL,
-                    resourceObserver->token, resourceObserver->tokenLength,
-                    resourceObserver->resUri, 0, resourceObserver->acceptFormat,
-                    resourceObserver->acceptVersion, &resourceObserver->devAddr);
+            if (!presenceResBuf)
+            {
+                return OC_STACK_NO_MEMORY;
+            }
 
             if (result == OC_STACK_OK)
             {
-                OCPresencePayload* presenceResBuf = OCPresencePayloadCreate(
-                        resPtr->sequenceNum, maxAge, trigger,
-                        resourceType ? resourceType->resourcetypename : NULL);
-
-                if (!presenceResBuf)
-                {
-                    return OC_STACK_NO_MEMORY;
-                }
-
-                if (result == OC_STACK_OK)
-                {
-                    ehResponse.ehResult = OC_EH_OK;
-                    ehResponse.payload = (OCPayload*)presenceResBuf;
-                    ehResponse.persistentBufferFlag = 0;
-                    ehResponse.requestHandle = (OCRequestHandle) request;
-                    OICStrcpy(ehResponse.resourceUri, sizeof(ehResponse.resourceUri),
-                            resourceObserver->resUri);
-                    result = OCDoResponse(&ehResponse);
-                }
-
-                OCPresencePayloadDestroy(presenceResBuf);
+                ehResponse.ehResult = OC_EH_OK;
+                ehResponse.payload = (OCPayload*)presenceResBuf;
+                ehResponse.persistentBufferFlag = 0;
+                ehResponse.requestHandle = (OCRequestHandle) request;
+                OICStrcpy(ehResponse.resourceUri, sizeof(ehResponse.resourceUri),
+                        resourceObserver->resUri);
+                result = OCDoResponse(&ehResponse);
             }
+
+            OCPresencePayloadDestroy(presenceResBuf);
         }
-#endif
 
         // Since we are in a loop, set an error flag to indicate at least one error occurred.
         if (result != OC_STACK_OK)
@@ -227,16 +414,17 @@ OCStackResult SendAllObserverNotification (OCMethod method, OCResource *resPtr,
         result = OC_STACK_ERROR;
     }
     return result;
+#endif // WITH_PRESENCE
 }
 
 OCStackResult SendListObserverNotification (OCResource * resource,
-        OCObservationId  *obsIdList, uint8_t numberOfIds,
+        OCObservationIdIterator nextId, void *context,
         const OCRepPayload *payload,
         uint32_t maxAge,
         OCQualityOfService qos)
 {
     (void)maxAge;
-    if (!resource || !obsIdList || !payload)
+    if (!resource || !nextId || !payload)
     {
         return OC_STACK_INVALID_PARAM;
     }
@@ -246,78 +434,111 @@ OCStackResult SendListObserverNotification (OCResource * resource,
         return OC_STACK_NO_OBSERVERS;
     }
 
-    uint8_t numIds = numberOfIds;
+    OIC_LOG(INFO, TAG, "Entering SendListObserverNotification");
+
+    // Observation IDs are 8 bits wide, so a bitmap holds the listed IDs and
+    // the observers are matched in one pass over the resource.
+    uint8_t listed[(UINT8_MAX + 1) / 8] = {0};
+    size_t numListed = 0;
+    OCObservationId obsId = 0;
+    while (nextId(context, &obsId))
+    {
+        uint8_t mask = (uint8_t)(1 << (obsId % 8));
+        if (!(listed[obsId / 8] & mask))
+        {
+            listed[obsId / 8] |= mask;
+            numListed++;
+        }
+    }
+    if (!numListed)
+    {
+        return OC_STACK_OK;
+    }
+
+    NotificationGroup *groups = (NotificationGroup *) OICCalloc(numListed,
+                                                                sizeof(NotificationGroup));
+    if (!groups)
+    {
+        return OC_STACK_NO_MEMORY;
+    }
+
     ResourceObserver *observer = NULL;
-    uint8_t numSentNotification = 0;
-    OCServerRequest * request = NULL;
-    OCStackResult result = OC_STACK_ERROR;
+    size_t numGroups = 0;
+    size_t numSentNotification = 0;
     bool observeErrorFlag = false;
 
-    OIC_LOG(INFO, TAG, "Entering SendListObserverNotification");
-    while(numIds)
+    // Create all server requests first, grouping the observers which share the encoding
+    // of the payload.
+    LL_FOREACH(resource->observersHead, observer)
     {
-        observer = GetObserverUsingId (resource, *obsIdList);
-        if (observer)
+        if (!(listed[observer->observeId / 8] & (1 << (observer->observeId % 8))))
         {
-            qos = DetermineObserverQoS(OC_REST_GET, observer, qos);
+            continue;
+        }
 
-            result = AddServerRequest(&request, 0, 0, 1, OC_REST_GET,
-                    0, resource->sequenceNum, qos, observer->query,
-                    NULL, OC_FORMAT_UNDEFINED, NULL, observer->token, observer->tokenLength,
-                    observer->resUri, 0, observer->acceptFormat,
-                    observer->acceptVersion, &observer->devAddr);
+        qos = DetermineObserverQoS(OC_REST_GET, observer, qos);
 
-            if (request)
+        NotificationGroup *group = NULL;
+        for (size_t i = 0; i < numGroups; i++)
+        {
+            if (IsSameEncoding(groups[i].observer, observer))
             {
-                request->observeResult = OC_STACK_OK;
-                if (result == OC_STACK_OK)
-                {
-                    OCEntityHandlerResponse ehResponse = {0};
-                    ehResponse.ehResult = OC_EH_OK;
-                    ehResponse.payload = (OCPayload*)OCRepPayloadCreate();
-                    if (!ehResponse.payload)
-                    {
-                        DeleteServerRequest(request);
-                        continue;
-                    }
-                    memcpy(ehResponse.payload, payload, sizeof(*payload));
-                    ehResponse.persistentBufferFlag = 0;
-                    ehResponse.requestHandle = (OCRequestHandle) request;
-                    result = OCDoResponse(&ehResponse);
-                    if (result == OC_STACK_OK)
-                    {
-                        OIC_LOG_V(INFO, TAG, "Observer id %d notified.", *obsIdList);
-
-                        // Increment only if OCDoResponse is successful
-                        numSentNotification++;
-
-                        OICFree(ehResponse.payload);
-                    }
-                    else
-                    {
-                        OIC_LOG_V(INFO, TAG, "Error notifying observer id %d.", *obsIdList);
-                    }
-                    // Reset Observer TTL.
-                    observer->TTL =
-                            GetTicks(MAX_OBSERVER_TTL_SECONDS * MILLISECONDS_PER_SECOND);
-                }
-                else
-                {
-                    DeleteServerRequest(request);
-                }
+                group = &groups[i];
+                break;
             }
-            // Since we are in a loop, set an error flag to indicate
-            // at least one error occurred.
-            if (result != OC_STACK_OK)
+        }
+
+        if (!group || OC_STACK_OK != AddNotificationTarget(group, observer, qos))
+        {
+            group = &groups[numGroups];
+            if (OC_STACK_OK != AddServerRequest(&group->request, 0, 0, 1, OC_REST_GET,
+                        0, resource->sequenceNum, qos, observer->query,
+                        NULL, OC_FORMAT_UNDEFINED, NULL, NULL,
+                        observer->token, observer->tokenLength,
+                        observer->resUri, 0, observer->acceptFormat,
+                        observer->acceptVersion, &observer->devAddr))
             {
+                OIC_LOG_V(INFO, TAG, "Error notifying observer id %d.", observer->observeId);
                 observeErrorFlag = true;
+                continue;
             }
+            group->request->observeResult = OC_STACK_OK;
+            group->observer = observer;
+            numGroups++;
         }
-        obsIdList++;
-        numIds--;
+
+        // Reset Observer TTL.
+        observer->TTL = GetTicks(MAX_OBSERVER_TTL_SECONDS * MILLISECONDS_PER_SECOND);
     }
 
-    if (numSentNotification == numberOfIds && !observeErrorFlag)
+    for (size_t i = 0; i < numGroups; i++)
+    {
+        // The request is deleted once the response is sent.
+        size_t numObservers = groups[i].request->numNotificationTargets + 1;
+        OIC_LOG_V(INFO, TAG, "Notifying %" PRIuPTR " observers with one encoding",
+                  numObservers);
+
+        OCRepPayload notification = *payload;
+        OCEntityHandlerResponse ehResponse = {0};
+        ehResponse.ehResult = OC_EH_OK;
+        ehResponse.payload = (OCPayload *) &notification;
+        ehResponse.persistentBufferFlag = 0;
+        ehResponse.requestHandle = (OCRequestHandle) groups[i].request;
+        if (OC_STACK_OK == OCDoResponse(&ehResponse))
+        {
+            numSentNotification += numObservers;
+        }
+        else
+        {
+            OIC_LOG_V(INFO, TAG, "Error notifying observer id %d.",
+                      groups[i].observer->observeId);
+            observeErrorFlag = true;
+        }
+    }
+
+    OICFree(groups);
+
+    if (numSentNotification == numListed && !observeErrorFlag)
     {
         return OC_STACK_OK;
     }
@@ -539,6 +760,248 @@ void DeleteObserverList(OCResource *resource)
     resource->observersHead = NULL;
 }
 
+/**
+ * Resources with notifications held back by their notification policy, linked through
+ * OCNotificationState::nextPending.
+ */
+static OCResource *g_pendingNotifications = NULL;
+
+/**
+ * Guards g_pendingNotifications and the notification states of the resources, which are
+ * held back by the application thread and sent by the thread calling OCProcess.
+ */
+static oc_mutex g_pendingNotificationsLock = NULL;
+
+/** Event signaled when a resource is linked into g_pendingNotifications. */
+static oc_event g_pendingNotificationEvent = NULL;
+
+static uint64_t GetNotificationDueTime(const OCNotificationState *state)
+{
+    uint64_t batched = state->pendingTime + state->policy.maxDelay;
+    uint64_t allowed = state->sentTime + state->policy.minInterval;
+    return (allowed > batched) ? allowed : batched;
+}
+
+static void UnlinkPendingNotification(OCResource *resource)
+{
+    OCResource **prev = &g_pendingNotifications;
+    while (*prev)
+    {
+        if (*prev == resource)
+        {
+            *prev = resource->notificationState->nextPending;
+            resource->notificationState->nextPending = NULL;
+            return;
+        }
+        prev = &(*prev)->notificationState->nextPending;
+    }
+}
+
+OCStackResult InitializePendingNotifications(void)
+{
+    assert(g_pendingNotificationsLock == NULL);
+
+    g_pendingNotificationsLock = oc_mutex_new();
+    if (g_pendingNotificationsLock == NULL)
+    {
+        return OC_STACK_ERROR;
+    }
+
+    g_pendingNotifications = NULL;
+    return OC_STACK_OK;
+}
+
+void TerminatePendingNotifications(void)
+{
+    assert(g_pendingNotifications == NULL);
+
+    if (g_pendingNotificationsLock != NULL)
+    {
+        oc_mutex_free(g_pendingNotificationsLock);
+        g_pendingNotificationsLock = NULL;
+    }
+}
+
+void RegisterPendingNotificationEvent(oc_event event)
+{
+    if (!g_pendingNotificationsLock)
+    {
+        g_pendingNotificationEvent = event;
+        return;
+    }
+
+    // DeferObserverNotification signals the event under this lock, so once it is
+    // unregistered here the caller may free it.
+    oc_mutex_lock(g_pendingNotificationsLock);
+    g_pendingNotificationEvent = event;
+    oc_mutex_unlock(g_pendingNotificationsLock);
+}
+
+OCStackResult SetNotificationPolicy(OCResource *resource, const OCNotificationPolicy *policy)
+{
+    if (!resource || !policy)
+    {
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    OCNotificationState *state = resource->notificationState;
+    if (!state)
+    {
+        state = (OCNotificationState *) OICCalloc(1, sizeof(OCNotificationState));
+        if (!state)
+        {
+            return OC_STACK_NO_MEMORY;
+        }
+        resource->notificationState = state;
+    }
+
+    oc_mutex_lock(g_pendingNotificationsLock);
+    state->policy = *policy;
+    if (state->policy.latestOnly && state->pending > 1)
+    {
+        state->pending = 1;
+    }
+    oc_mutex_unlock(g_pendingNotificationsLock);
+    return OC_STACK_OK;
+}
+
+void DeleteNotificationPolicy(OCResource *resource)
+{
+    if (!resource || !resource->notificationState)
+    {
+        return;
+    }
+
+    oc_mutex_lock(g_pendingNotificationsLock);
+    if (resource->notificationState->pending)
+    {
+        UnlinkPendingNotification(resource);
+    }
+    oc_mutex_unlock(g_pendingNotificationsLock);
+    OICFree(resource->notificationState);
+    resource->notificationState = NULL;
+}
+
+bool DeferObserverNotification(OCResource *resource, OCQualityOfService qos, uint64_t now)
+{
+    OCNotificationState *state = resource->notificationState;
+    if (!state)
+    {
+        return false;
+    }
+
+    oc_mutex_lock(g_pendingNotificationsLock);
+    if (0 == state->pending)
+    {
+        if (0 == state->policy.maxDelay && now >= state->sentTime + state->policy.minInterval)
+        {
+            state->sentTime = now;
+            oc_mutex_unlock(g_pendingNotificationsLock);
+            return false;
+        }
+
+        state->pendingTime = now;
+        state->qos = qos;
+        state->nextPending = g_pendingNotifications;
+        g_pendingNotifications = resource;
+
+        // The thread waiting for OCProcessEvent has to wake up for the new due time.
+        if (g_pendingNotificationEvent)
+        {
+            oc_event_signal(g_pendingNotificationEvent);
+        }
+    }
+    else if (OC_HIGH_QOS == qos)
+    {
+        state->qos = OC_HIGH_QOS;
+    }
+
+    if ((0 == state->pending || !state->policy.latestOnly) && state->pending < UINT32_MAX)
+    {
+        state->pending++;
+    }
+
+    OIC_LOG_V(DEBUG, TAG, "Notification of %s held back, %u pending",
+              resource->uri, state->pending);
+    oc_mutex_unlock(g_pendingNotificationsLock);
+    return true;
+}
+
+OCResource *TakeDueNotification(uint64_t now, OCQualityOfService *qos)
+{
+    oc_mutex_lock(g_pendingNotificationsLock);
+    for (OCResource *resource = g_pendingNotifications; resource;
+         resource = resource->notificationState->nextPending)
+    {
+        OCNotificationState *state = resource->notificationState;
+        if (GetNotificationDueTime(state) > now)
+        {
+            continue;
+        }
+
+        *qos = state->qos;
+        state->sentTime = now;
+        if (0 == --state->pending)
+        {
+            UnlinkPendingNotification(resource);
+        }
+        else
+        {
+            // The next one is held back again from now on.
+            state->pendingTime = now;
+        }
+        oc_mutex_unlock(g_pendingNotificationsLock);
+        return resource;
+    }
+
+    oc_mutex_unlock(g_pendingNotificationsLock);
+    return NULL;
+}
+
+bool TakePendingNotification(OCResource *resource, OCQualityOfService *qos)
+{
+    OCNotificationState *state = resource->notificationState;
+    if (!state)
+    {
+        return false;
+    }
+
+    oc_mutex_lock(g_pendingNotificationsLock);
+    bool pending = (0 != state->pending);
+    if (pending)
+    {
+        *qos = state->qos;
+        state->pending = 0;
+        UnlinkPendingNotification(resource);
+    }
+    oc_mutex_unlock(g_pendingNotificationsLock);
+    return pending;
+}
+
+uint32_t GetNextNotificationTimeout(uint64_t now)
+{
+    uint32_t nextTimeout = UINT32_MAX;
+
+    oc_mutex_lock(g_pendingNotificationsLock);
+    for (OCResource *resource = g_pendingNotifications; resource;
+         resource = resource->notificationState->nextPending)
+    {
+        uint64_t due = GetNotificationDueTime(resource->notificationState);
+        if (due <= now)
+        {
+            nextTimeout = 0;
+            break;
+        }
+        if (due - now < nextTimeout)
+        {
+            nextTimeout = (uint32_t) (due - now);
+        }
+    }
+    oc_mutex_unlock(g_pendingNotificationsLock);
+
+    return nextTimeout;
+}
+
 /*
  * CA layer expects observe registration/de-reg/notiifcations to be passed as a header
  * option, which breaks the protocol abstraction requirement between RI & CA, and
@@ -26,6 +26,7 @@
 #include "ocpayload.h"
 #include "occollection.h"
 #include "ocatomicmeasurement.h"
+#include "ocatomic.h"
 #include "octypes.h"
 #include <string.h>
 #include "oic_malloc.h"
@@ -41,7 +42,51 @@
 #define CSV_SEPARATOR ','
 #define MASK_SECURE_FAMS (OC_FLAG_SECURE | OC_MASK_FAMS)
 
+/** Number of values of a representation from which they are indexed by name.*/
+#ifndef OC_REP_PAYLOAD_INDEX_THRESHOLD
+#define OC_REP_PAYLOAD_INDEX_THRESHOLD 16
+#endif
+
+/** Number of buckets of the table of value indexes, a power of 2.*/
+#define OC_REP_PAYLOAD_INDEX_BUCKETS 64
+
+typedef struct
+{
+    uint32_t hash;
+    OCRepPayloadValue* value;
+} OCRepPayloadIndexSlot;
+
+/**
+ * Open addressing hash table of the values of a representation. Values are never
+ * removed from a representation, so the table only grows. The values list stays the
+ * storage and keeps the wire order, the index is rebuilt when the list was replaced
+ * or extended without going through this file. It is not updated when a value inside
+ * the list is unlinked, freed or renamed directly, and it is only released by
+ * OCRepPayloadDestroy.
+ */
+typedef struct OCRepPayloadValueIndex
+{
+    const OCRepPayload* payload;    /**< payload the index belongs to.*/
+    struct OCRepPayloadValueIndex* nextInBucket;
+    OCRepPayloadValue* head;        /**< payload->values the index was built for.*/
+    OCRepPayloadValue* tail;        /**< last value of the list.*/
+    size_t count;                   /**< number of indexed values.*/
+    size_t size;                    /**< number of slots, a power of 2.*/
+    OCRepPayloadIndexSlot* slots;
+} OCRepPayloadValueIndex;
+
+/**
+ * Value indexes keyed by the address of their payload. They are kept out of OCRepPayload
+ * so that its layout stays the same. Payloads are built and released on any thread, also
+ * before the stack is initialized, so the table is guarded by a spin lock rather than a
+ * mutex created by OCInit. Lookups skip the lock while no payload is indexed.
+ */
+static OCRepPayloadValueIndex* g_valueIndexes[OC_REP_PAYLOAD_INDEX_BUCKETS];
+static volatile int32_t g_valueIndexesLock = 0;
+static volatile int32_t g_valueIndexCount = 0;
+
 static void OCFreeRepPayloadValueContents(OCRepPayloadValue* val);
+static void OCRepPayloadFreeValueIndex(const OCRepPayload* payload);
 
 void OC_CALL OCPayloadDestroy(OCPayload* payload)
 {
@@ -89,6 +134,10 @@ OCRepPayload* OC_CALL OCRepPayloadCreate(void)
     payload->repType = PAYLOAD_REP_OBJECT_ARRAY;
     payload->base.type = PAYLOAD_TYPE_REPRESENTATION;
 
+    // Drop the index of a payload at this address which was freed without
+    // OCRepPayloadDestroy(), so that it is not taken for the index of this one.
+    OCRepPayloadFreeValueIndex(payload);
+
     return payload;
 }
 
@@ -108,6 +157,212 @@ void OC_CALL OCRepPayloadAppend(OCRepPayload* parent, OCRepPayload* child)
     child->next = NULL;
 }
 
+static uint32_t OCRepPayloadHashName(const char* name)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (; *name; name++)
+    {
+        hash = (hash ^ (uint8_t)*name) * 16777619u;
+    }
+    return hash;
+}
+
+static void OCRepPayloadLockValueIndexes(void)
+{
+    while (!oc_atomic_cmpxchg(&g_valueIndexesLock, 0, 1))
+    {
+    }
+}
+
+static void OCRepPayloadUnlockValueIndexes(void)
+{
+    oc_atomic_cmpxchg(&g_valueIndexesLock, 1, 0);
+}
+
+static OCRepPayloadValueIndex** OCRepPayloadIndexBucket(const OCRepPayload* payload)
+{
+    return &g_valueIndexes[((uintptr_t)payload / sizeof(void*))
+                           & (OC_REP_PAYLOAD_INDEX_BUCKETS - 1)];
+}
+
+/**
+ * Removes the index of a payload from the table and frees it.
+ */
+static void OCRepPayloadFreeValueIndex(const OCRepPayload* payload)
+{
+    if (0 == oc_atomic_add(&g_valueIndexCount, 0))
+    {
+        return;
+    }
+
+    OCRepPayloadValueIndex* index = NULL;
+    OCRepPayloadLockValueIndexes();
+    for (OCRepPayloadValueIndex** link = OCRepPayloadIndexBucket(payload); *link;
+         link = &(*link)->nextInBucket)
+    {
+        if ((*link)->payload == payload)
+        {
+            index = *link;
+            *link = index->nextInBucket;
+            oc_atomic_decrement(&g_valueIndexCount);
+            break;
+        }
+    }
+    OCRepPayloadUnlockValueIndexes();
+
+    if (index)
+    {
+        OICFree(index->slots);
+        OICFree(index);
+    }
+}
+
+/**
+ * @return the index of the payload, or NULL when there is none or it does not
+ *         describe payload->values anymore.
+ */
+static OCRepPayloadValueIndex* OCRepPayloadGetValueIndex(const OCRepPayload* payload)
+{
+    if (0 == oc_atomic_add(&g_valueIndexCount, 0))
+    {
+        return NULL;
+    }
+
+    OCRepPayloadValueIndex* index = NULL;
+    OCRepPayloadLockValueIndexes();
+    for (index = *OCRepPayloadIndexBucket(payload); index; index = index->nextInBucket)
+    {
+        if (index->payload == payload)
+        {
+            break;
+        }
+    }
+    OCRepPayloadUnlockValueIndexes();
+
+    if (index && index->head == payload->values && index->tail && !index->tail->next)
+    {
+        return index;
+    }
+    return NULL;
+}
+
+static OCRepPayloadIndexSlot* OCRepPayloadIndexLookup(const OCRepPayloadValueIndex* index,
+        const char* name, uint32_t hash)
+{
+    size_t mask = index->size - 1;
+    for (size_t i = hash & mask; ; i = (i + 1) & mask)
+    {
+        OCRepPayloadIndexSlot* slot = &index->slots[i];
+        if (!slot->value
+            || (slot->hash == hash && 0 == strcmp(slot->value->name, name)))
+        {
+            return slot;
+        }
+    }
+}
+
+/**
+ * Adds a value to the index, unless a value of the same name is indexed already.
+ * The table is kept at most half full.
+ */
+static bool OCRepPayloadIndexAdd(OCRepPayloadValueIndex* index, OCRepPayloadValue* value)
+{
+    if ((index->count + 1) * 2 > index->size)
+    {
+        size_t size = index->size * 2;
+        OCRepPayloadIndexSlot* slots =
+            (OCRepPayloadIndexSlot*)OICCalloc(size, sizeof(OCRepPayloadIndexSlot));
+        if (!slots)
+        {
+            return false;
+        }
+
+        OCRepPayloadIndexSlot* oldSlots = index->slots;
+        size_t oldSize = index->size;
+        index->slots = slots;
+        index->size = size;
+        for (size_t i = 0; i < oldSize; i++)
+        {
+            if (oldSlots[i].value)
+            {
+                *OCRepPayloadIndexLookup(index, oldSlots[i].value->name, oldSlots[i].hash) =
+                    oldSlots[i];
+            }
+        }
+        OICFree(oldSlots);
+    }
+
+    uint32_t hash = OCRepPayloadHashName(value->name);
+    OCRepPayloadIndexSlot* slot = OCRepPayloadIndexLookup(index, value->name, hash);
+    if (!slot->value)
+    {
+        slot->hash = hash;
+        slot->value = value;
+        index->count++;
+    }
+    return true;
+}
+
+/**
+ * Indexes the values of a payload once it has OC_REP_PAYLOAD_INDEX_THRESHOLD of them.
+ * @return the index, or NULL when the payload has fewer values or on memory error.
+ */
+static OCRepPayloadValueIndex* OCRepPayloadBuildValueIndex(OCRepPayload* payload)
+{
+    OCRepPayloadValueIndex* index = OCRepPayloadGetValueIndex(payload);
+    if (index)
+    {
+        return index;
+    }
+    OCRepPayloadFreeValueIndex(payload);
+
+    size_t count = 0;
+    for (OCRepPayloadValue* val = payload->values;
+         val && count < OC_REP_PAYLOAD_INDEX_THRESHOLD; val = val->next)
+    {
+        count++;
+    }
+    if (count < OC_REP_PAYLOAD_INDEX_THRESHOLD)
+    {
+        return NULL;
+    }
+
+    index = (OCRepPayloadValueIndex*)OICCalloc(1, sizeof(OCRepPayloadValueIndex));
+    if (!index)
+    {
+        return NULL;
+    }
+    index->size = OC_REP_PAYLOAD_INDEX_THRESHOLD * 2;
+    index->slots = (OCRepPayloadIndexSlot*)OICCalloc(index->size, sizeof(OCRepPayloadIndexSlot));
+    if (!index->slots)
+    {
+        OICFree(index);
+        return NULL;
+    }
+
+    for (OCRepPayloadValue* val = payload->values; val; val = val->next)
+    {
+        if (!OCRepPayloadIndexAdd(index, val))
+        {
+            OICFree(index->slots);
+            OICFree(index);
+            return NULL;
+        }
+        index->tail = val;
+    }
+    index->head = payload->values;
+    index->payload = payload;
+
+    OCRepPayloadValueIndex** bucket = OCRepPayloadIndexBucket(payload);
+    OCRepPayloadLockValueIndexes();
+    index->nextInBucket = *bucket;
+    *bucket = index;
+    oc_atomic_increment(&g_valueIndexCount);
+    OCRepPayloadUnlockValueIndexes();
+    return index;
+}
+
 static OCRepPayloadValue* OC_CALL OCRepPayloadFindValue(const OCRepPayload* payload, const char* name)
 {
     if (!payload || !name)
@@ -115,6 +370,13 @@ static OCRepPayloadValue* OC_CALL OCRepPayloadFindValue(const OCRepPayload* payl
         return NULL;
     }
 
+    // Lookups do not build the index, a const payload may be read by several threads.
+    OCRepPayloadValueIndex* index = OCRepPayloadGetValueIndex(payload);
+    if (index)
+    {
+        return OCRepPayloadIndexLookup(index, name, OCRepPayloadHashName(name))->value;
+    }
+
     OCRepPayloadValue* val = payload->values;
     while(val)
     {
@@ -353,6 +615,40 @@ static OCRepPayloadValue* OC_CALL OCRepPayloadFindAndSetValue(OCRepPayload* payl
         return NULL;
     }
 
+    OCRepPayloadValueIndex* index = OCRepPayloadGetValueIndex(payload);
+    if (index)
+    {
+        OCRepPayloadValue* found = OCRepPayloadIndexLookup(index, name,
+                                                          OCRepPayloadHashName(name))->value;
+        if (found)
+        {
+            OCFreeRepPayloadValueContents(found);
+            found->type = type;
+            return found;
+        }
+
+        OCRepPayloadValue* added = (OCRepPayloadValue*)OICCalloc(1, sizeof(OCRepPayloadValue));
+        if (!added)
+        {
+            return NULL;
+        }
+        added->name = OICStrdup(name);
+        if (!added->name)
+        {
+            OICFree(added);
+            return NULL;
+        }
+        added->type = type;
+
+        index->tail->next = added;
+        index->tail = added;
+        if (!OCRepPayloadIndexAdd(index, added))
+        {
+            OCRepPayloadFreeValueIndex(payload);
+        }
+        return added;
+    }
+
     OCRepPayloadValue* val = payload->values;
     if (val == NULL)
     {
@@ -395,6 +691,7 @@ static OCRepPayloadValue* OC_CALL OCRepPayloadFindAndSetValue(OCRepPayload* payl
                 return NULL;
             }
             val->next->type =type;
+            OCRepPayloadBuildValueIndex(payload);
             return val->next;
         }
 
@@ -1614,6 +1911,7 @@ OCRepPayload* OC_CALL OCRepPayloadClone (const OCRepPayload* payload)
     clone->types = CloneOCStringLL (payload->types);
     clone->interfaces = CloneOCStringLL (payload->interfaces);
     clone->values = OCRepPayloadValueClone (payload->values);
+    OCRepPayloadBuildValueIndex(clone);
 
     return clone;
 }
@@ -1642,6 +1940,7 @@ OCRepPayload* OC_CALL OCRepPayloadBatchClone(const OCRepPayload* repPayload)
     clone->repType = repPayload->repType;
     clone->interfaces  = CloneOCStringLL(repPayload->interfaces);
     clone->values = OCRepPayloadValueClone(repPayload->values);
+    OCRepPayloadBuildValueIndex(clone);
 
     OCRepPayloadSetPropObjectAsOwner(newPayload, OC_RSRVD_REPRESENTATION, clone);
 
@@ -1659,6 +1958,7 @@ void OC_CALL OCRepPayloadDestroy(OCRepPayload* payload)
     OCFreeOCStringLL(payload->types);
     OCFreeOCStringLL(payload->interfaces);
     OCFreeRepPayloadValue(payload->values);
+    OCRepPayloadFreeValueIndex(payload);
     OCRepPayloadDestroy(payload->next);
     OICFree(payload);
 }
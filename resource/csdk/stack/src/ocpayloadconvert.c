@@ -35,6 +35,12 @@
 // Arbitrarily chosen size that seems to contain the majority of packages
 #define INIT_SIZE (255)
 
+// Largest CBOR head, i.e. initial byte and 64 bit argument.
+#define CBOR_HEAD_MAX_SIZE (9)
+
+// Encoded size of a text string key given as a string literal.
+#define CBOR_KEY_SIZE(key) (CborHeadSize(sizeof(key) - 1) + sizeof(key) - 1)
+
 // Discovery Links Map Length.
 #define LINKS_MAP_LEN (4)
 
@@ -65,6 +71,8 @@ static int64_t AddTextStringToMap(CborEncoder *map, const char *key, size_t keyl
 static int64_t ConditionalAddTextStringToMap(CborEncoder *map, const char *key, size_t keylen,
         const char *value);
 
+static size_t CborHeadSize(uint64_t value);
+
 OCStackResult OCConvertPayload(OCPayload* payload, OCPayloadFormat format,
         uint8_t** outPayload, size_t* size)
 {
@@ -78,36 +86,26 @@ OCStackResult OCConvertPayload(OCPayload* payload, OCPayloadFormat format,
     OCStackResult ret = OC_STACK_INVALID_PARAM;
     int64_t err = CborErrorOutOfMemory;
     uint8_t *out = NULL;
-    size_t curSize = INIT_SIZE;
+    size_t bufSize = 0;
+    size_t curSize = 0;
 
     VERIFY_PARAM_NON_NULL(TAG, payload, "Input param, payload is NULL");
     VERIFY_PARAM_NON_NULL(TAG, outPayload, "OutPayload parameter is NULL");
     VERIFY_PARAM_NON_NULL(TAG, size, "size parameter is NULL");
 
     OIC_LOG_V(INFO, TAG, "Converting payload of type %d", payload->type);
-    if (PAYLOAD_TYPE_SECURITY == payload->type)
-    {
-        size_t securityPayloadSize = ((OCSecurityPayload *)payload)->payloadSize;
-        if (securityPayloadSize > 0)
-        {
-            curSize = securityPayloadSize;
-        }
-    }
-    if (PAYLOAD_TYPE_INTROSPECTION == payload->type)
-    {
-        size_t introspectionPayloadSize = ((OCIntrospectionPayload *)payload)->cborPayload.len;
-        if (introspectionPayloadSize > 0)
-        {
-            curSize = introspectionPayloadSize;
-        }
-    }
+
+    // Encode once into a buffer of the size bound.  Should the bound fall short, tinycbor
+    // reports the missing bytes and the payload is encoded again.
+    curSize = OCGetPayloadSizeBound(payload, format);
 
     ret = OC_STACK_NO_MEMORY;
 
     for (;;)
     {
-        out = (uint8_t *)OICCalloc(1, curSize);
+        out = (uint8_t *)OICMalloc(curSize);
         VERIFY_PARAM_NON_NULL(TAG, out, "Failed to allocate payload");
+        bufSize = curSize;
         err = OCConvertPayloadHelper(payload, format, out, &curSize);
 
         if ((CborErrorOutOfMemory & err) == 0)
@@ -115,17 +113,17 @@ OCStackResult OCConvertPayload(OCPayload* payload, OCPayloadFormat format,
             break;
         }
 
+        OIC_LOG_V(WARNING, TAG, "Size bound %zu of payload type %d too small, need %zu",
+                  bufSize, payload->type, curSize);
         OICFree(out);
     }
 
     if (err == CborNoError)
     {
-        if ((curSize < INIT_SIZE) &&
-            (PAYLOAD_TYPE_SECURITY != payload->type) &&
-            (PAYLOAD_TYPE_INTROSPECTION != payload->type))
+        if (curSize < bufSize)
         {
-            uint8_t *out2 = (uint8_t *)OICRealloc(out, curSize);
-            VERIFY_PARAM_NON_NULL(TAG, out2, "Failed to increase payload size");
+            uint8_t *out2 = (uint8_t *)OICRealloc(out, curSize ? curSize : 1);
+            VERIFY_PARAM_NON_NULL(TAG, out2, "Failed to decrease payload size");
             out = out2;
         }
 
@@ -968,7 +966,8 @@ static int64_t OCConvertRepPayload(OCRepPayload *payload, uint8_t *outPayload, s
         VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed adding rep root map");
     }
 
-    while (payload != NULL && (err == CborNoError))
+    // Keep going when out of memory, so that the missing size covers all objects.
+    while (payload != NULL)
     {
         CborEncoder rootMap;
         err |= cbor_encoder_create_map(((objectCount == 1 && !isColResource)? &encoder: &rootArray),
@@ -1076,3 +1075,343 @@ static int64_t ConditionalAddTextStringToMap(CborEncoder* map, const char* key,
 {
     return value ? AddTextStringToMap(map, key, keylen, value) : 0;
 }
+
+/*
+ * Size bounds.  The functions below mirror the converters above and add up the encoded
+ * size of every item, taking the largest encoding wherever it is not known without
+ * encoding, e.g. the array or map form of an object.
+ */
+
+static size_t CborHeadSize(uint64_t value)
+{
+    if (value < 24)
+    {
+        return 1;
+    }
+    if (value <= UINT8_MAX)
+    {
+        return 2;
+    }
+    if (value <= UINT16_MAX)
+    {
+        return 3;
+    }
+    if (value <= UINT32_MAX)
+    {
+        return 5;
+    }
+    return CBOR_HEAD_MAX_SIZE;
+}
+
+static size_t CborIntSize(int64_t value)
+{
+    return CborHeadSize((value < 0) ? (uint64_t)(-1 - value) : (uint64_t)value);
+}
+
+static size_t CborTextSize(const char *value)
+{
+    if (!value)
+    {
+        return 0;
+    }
+    size_t len = strlen(value);
+    return CborHeadSize(len) + len;
+}
+
+static size_t OCStringLLSizeBound(size_t keySize, const OCStringLL *val)
+{
+    if (!val)
+    {
+        return 0;
+    }
+
+    size_t count = 0;
+    size_t size = keySize;
+    for (; val; val = val->next)
+    {
+        size += CborTextSize(val->value);
+        ++count;
+    }
+    return size + CborHeadSize(count);
+}
+
+static size_t OCEndpointStringSizeBound(const OCEndpointPayload *endpoint)
+{
+    // "tps://[addr]:port"
+    size_t len = (endpoint->tps ? strlen(endpoint->tps) : 0) +
+                 (endpoint->addr ? strlen(endpoint->addr) : 0) + sizeof("://[]:65535") - 1;
+    return CborHeadSize(len) + len;
+}
+
+static size_t OCResourcePayloadSizeBound(const OCResourcePayload *resource,
+                                         const OCEndpointPayload *endpoint)
+{
+    size_t size = 1 + CBOR_KEY_SIZE(OC_RSRVD_HREF);
+    if (endpoint)
+    {
+        size_t len = OCEndpointStringSizeBound(endpoint) + CborTextSize(resource->uri);
+        size += CborHeadSize(len) + len;
+    }
+    else
+    {
+        size += CborTextSize(resource->uri);
+    }
+    if (resource->rel)
+    {
+        size += CBOR_KEY_SIZE(OC_RSRVD_REL) + CborTextSize(resource->rel);
+    }
+    size += OCStringLLSizeBound(CBOR_KEY_SIZE(OC_RSRVD_RESOURCE_TYPE), resource->types);
+    size += OCStringLLSizeBound(CBOR_KEY_SIZE(OC_RSRVD_INTERFACE), resource->interfaces);
+
+    // policy map with bitmap, secure, port and the transport ports.
+    size += CBOR_KEY_SIZE(OC_RSRVD_POLICY) + 2;
+    size += CBOR_KEY_SIZE(OC_RSRVD_BITMAP) + CborHeadSize(resource->bitmap);
+    size += CBOR_KEY_SIZE(OC_RSRVD_SECURE) + 1;
+    size += CBOR_KEY_SIZE(OC_RSRVD_HOSTING_PORT) + CborHeadSize(UINT16_MAX);
+#ifdef TCP_ADAPTER
+    size += CBOR_KEY_SIZE(OC_RSRVD_TCP_PORT) + CborHeadSize(UINT16_MAX);
+#endif
+    return size;
+}
+
+static size_t OCDiscoveryPayloadCborSizeBound(const OCDiscoveryPayload *payload)
+{
+    size_t arrayCount = 0;
+    for (const OCDiscoveryPayload *temp = payload; temp; temp = temp->next)
+    {
+        arrayCount++;
+    }
+
+    size_t size = CborHeadSize(arrayCount);
+    for (; payload && payload->resources; payload = payload->next)
+    {
+        size += 2;
+        if (payload->name)
+        {
+            size += CBOR_KEY_SIZE(OC_RSRVD_DEVICE_NAME) + CborTextSize(payload->name);
+        }
+        size += CBOR_KEY_SIZE(OC_RSRVD_DEVICE_ID) + CborTextSize(payload->sid);
+        size += OCStringLLSizeBound(CBOR_KEY_SIZE(OC_RSRVD_RESOURCE_TYPE), payload->type);
+        size += OCStringLLSizeBound(CBOR_KEY_SIZE(OC_RSRVD_INTERFACE), payload->iface);
+        size += CBOR_KEY_SIZE(OC_RSRVD_LINKS) + 2;
+
+        // Depending on whether the payload is of this device, a resource is encoded
+        // once without or once per endpoint.
+        for (const OCResourcePayload *resource = payload->resources; resource;
+             resource = resource->next)
+        {
+            size_t linkSize = OCResourcePayloadSizeBound(resource, NULL);
+            size_t epsSize = 0;
+            for (const OCEndpointPayload *ep = resource->eps; ep; ep = ep->next)
+            {
+                epsSize += OCResourcePayloadSizeBound(resource, ep);
+            }
+            size += (epsSize > linkSize) ? epsSize : linkSize;
+        }
+    }
+    return size;
+}
+
+static size_t OCDiscoveryPayloadVndOcfCborSizeBound(const OCDiscoveryPayload *payload)
+{
+    size_t size = 2;
+    if (payload->name || payload->type || payload->iface)
+    {
+        size += 1 + 2 + CBOR_KEY_SIZE(OC_RSRVD_LINKS);
+        if (payload->name)
+        {
+            size += CBOR_KEY_SIZE(OC_RSRVD_DEVICE_NAME) + CborTextSize(payload->name);
+        }
+        size += OCStringLLSizeBound(CBOR_KEY_SIZE(OC_RSRVD_RESOURCE_TYPE), payload->type);
+        size += OCStringLLSizeBound(CBOR_KEY_SIZE(OC_RSRVD_INTERFACE), payload->iface);
+    }
+
+    for (; payload && payload->resources; payload = payload->next)
+    {
+        // "ocf://sid"
+        size_t anchorLen = sizeof("ocf://") - 1 + (payload->sid ? strlen(payload->sid) : 0);
+        size_t anchorSize = CBOR_KEY_SIZE(OC_RSRVD_URI) + CborHeadSize(anchorLen) + anchorLen;
+
+        for (const OCResourcePayload *resource = payload->resources; resource;
+             resource = resource->next)
+        {
+            size += 2 + CBOR_KEY_SIZE(OC_RSRVD_HREF) + CborTextSize(resource->uri);
+            if (resource->rel)
+            {
+                size += CBOR_KEY_SIZE(OC_RSRVD_REL) + CborTextSize(resource->rel);
+            }
+            size += anchorSize;
+            size += OCStringLLSizeBound(CBOR_KEY_SIZE(OC_RSRVD_RESOURCE_TYPE), resource->types);
+            size += OCStringLLSizeBound(CBOR_KEY_SIZE(OC_RSRVD_INTERFACE), resource->interfaces);
+            size += CBOR_KEY_SIZE(OC_RSRVD_POLICY) + 2;
+            size += CBOR_KEY_SIZE(OC_RSRVD_BITMAP) + CborHeadSize(resource->bitmap);
+
+            size_t epsCount = 0;
+            for (const OCEndpointPayload *ep = resource->eps; ep; ep = ep->next)
+            {
+                size += 1 + CBOR_KEY_SIZE(OC_RSRVD_ENDPOINT) + OCEndpointStringSizeBound(ep);
+                size += CBOR_KEY_SIZE(OC_RSRVD_PRIORITY) + CborHeadSize(ep->pri);
+                epsCount++;
+            }
+            if (epsCount)
+            {
+                size += CBOR_KEY_SIZE(OC_RSRVD_ENDPOINTS) + CborHeadSize(epsCount);
+            }
+        }
+    }
+    return size;
+}
+
+static size_t OCRepMapSizeBound(const OCRepPayload *payload);
+
+static size_t OCRepArrayItemSizeBound(const OCRepPayloadValueArray *valArray, size_t index)
+{
+    switch (valArray->type)
+    {
+        case OCREP_PROP_INT:
+            return valArray->iArray ? CborIntSize(valArray->iArray[index]) : 0;
+        case OCREP_PROP_DOUBLE:
+            return CBOR_HEAD_MAX_SIZE;
+        case OCREP_PROP_BOOL:
+            return 1;
+        case OCREP_PROP_STRING:
+            return (valArray->strArray && valArray->strArray[index]) ?
+                   CborTextSize(valArray->strArray[index]) : 1;
+        case OCREP_PROP_BYTE_STRING:
+            return CborHeadSize(valArray->ocByteStrArray[index].len) +
+                   valArray->ocByteStrArray[index].len;
+        case OCREP_PROP_OBJECT:
+            return (valArray->objArray && valArray->objArray[index]) ?
+                   OCRepMapSizeBound(valArray->objArray[index]) : 1;
+        default:
+            return 0;
+    }
+}
+
+static size_t OCRepArraySizeBound(const OCRepPayloadValueArray *valArray)
+{
+    size_t dim0 = valArray->dimensions[0];
+    size_t dim1 = valArray->dimensions[1] ? valArray->dimensions[1] : 1;
+    size_t dim2 = valArray->dimensions[2] ? valArray->dimensions[2] : 1;
+
+    size_t size = CborHeadSize(dim0);
+    if (valArray->dimensions[1])
+    {
+        size += dim0 * CborHeadSize(valArray->dimensions[1]);
+    }
+    if (valArray->dimensions[1] && valArray->dimensions[2])
+    {
+        size += dim0 * dim1 * CborHeadSize(valArray->dimensions[2]);
+    }
+
+    size_t count = dim0 * dim1 * dim2;
+    if (OCREP_PROP_DOUBLE == valArray->type || OCREP_PROP_BOOL == valArray->type)
+    {
+        return size + count * OCRepArrayItemSizeBound(valArray, 0);
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        size += OCRepArrayItemSizeBound(valArray, i);
+    }
+    return size;
+}
+
+static size_t OCRepValueSizeBound(const OCRepPayloadValue *value)
+{
+    switch (value->type)
+    {
+        case OCREP_PROP_NULL:
+        case OCREP_PROP_BOOL:
+            return 1;
+        case OCREP_PROP_INT:
+            return CborIntSize(value->i);
+        case OCREP_PROP_DOUBLE:
+            return CBOR_HEAD_MAX_SIZE;
+        case OCREP_PROP_STRING:
+            return CborTextSize(value->str);
+        case OCREP_PROP_BYTE_STRING:
+            return CborHeadSize(value->ocByteStr.len) + value->ocByteStr.len;
+        case OCREP_PROP_OBJECT:
+            return value->obj ? OCRepMapSizeBound(value->obj) : 1;
+        case OCREP_PROP_ARRAY:
+            return OCRepArraySizeBound(&value->arr);
+        default:
+            return 0;
+    }
+}
+
+static size_t OCSingleRepPayloadSizeBound(const OCRepPayload *payload)
+{
+    size_t size = 0;
+    if (payload->uri && strlen(payload->uri) > 0)
+    {
+        size += CBOR_KEY_SIZE(OC_RSRVD_HREF) + CborTextSize(payload->uri);
+    }
+    size += OCStringLLSizeBound(CBOR_KEY_SIZE(OC_RSRVD_RESOURCE_TYPE), payload->types);
+    size += OCStringLLSizeBound(CBOR_KEY_SIZE(OC_RSRVD_INTERFACE), payload->interfaces);
+    for (const OCRepPayloadValue *value = payload->values; value; value = value->next)
+    {
+        size += CborTextSize(value->name) + OCRepValueSizeBound(value);
+    }
+    return size;
+}
+
+static size_t OCRepMapSizeBound(const OCRepPayload *payload)
+{
+    // The array form leaves out the names, the map form is the larger one.
+    return 2 + OCSingleRepPayloadSizeBound(payload);
+}
+
+static size_t OCRepPayloadSizeBound(const OCRepPayload *payload)
+{
+    size_t objectCount = 0;
+    size_t size = 0;
+    for (; payload; payload = payload->next)
+    {
+        size += 2 + OCSingleRepPayloadSizeBound(payload);
+        objectCount++;
+    }
+    return size + CborHeadSize(objectCount);
+}
+
+size_t OCGetPayloadSizeBound(OCPayload *payload, OCPayloadFormat format)
+{
+    size_t size = INIT_SIZE;
+    if (!payload)
+    {
+        return size;
+    }
+
+    switch (payload->type)
+    {
+        case PAYLOAD_TYPE_DISCOVERY:
+            size = (OC_FORMAT_VND_OCF_CBOR == format) ?
+                   OCDiscoveryPayloadVndOcfCborSizeBound((OCDiscoveryPayload *)payload) :
+                   OCDiscoveryPayloadCborSizeBound((OCDiscoveryPayload *)payload);
+            break;
+        case PAYLOAD_TYPE_REPRESENTATION:
+            size = OCRepPayloadSizeBound((OCRepPayload *)payload);
+            break;
+        case PAYLOAD_TYPE_PRESENCE:
+        {
+            OCPresencePayload *presence = (OCPresencePayload *)payload;
+            size = 2 + CBOR_KEY_SIZE(OC_RSRVD_NONCE) + CborHeadSize(presence->sequenceNumber) +
+                   CBOR_KEY_SIZE(OC_RSRVD_TTL) + CborHeadSize(presence->maxAge) +
+                   CBOR_KEY_SIZE(OC_RSRVD_TRIGGER) + 2 +
+                   CBOR_KEY_SIZE(OC_RSRVD_RESOURCE_TYPE) + CborTextSize(presence->resourceType);
+            break;
+        }
+        case PAYLOAD_TYPE_DIAGNOSTIC:
+            size = CborTextSize(((OCDiagnosticPayload *)payload)->message);
+            break;
+        case PAYLOAD_TYPE_SECURITY:
+            size = ((OCSecurityPayload *)payload)->payloadSize;
+            break;
+        case PAYLOAD_TYPE_INTROSPECTION:
+            size = ((OCIntrospectionPayload *)payload)->cborPayload.len;
+            break;
+        default:
+            break;
+    }
+    return size ? size : 1;
+}
@@ -41,6 +41,8 @@
 
 #include "ocresource.h"
 #include "ocresourcehandler.h"
+#include "ocresourceindex.h"
+#include "ocdiscoverycache.h"
 #include "ocobserve.h"
 #include "occollection.h"
 #include "ocatomicmeasurement.h"
@@ -1314,17 +1316,12 @@ OCResource *OC_CALL FindResourceByUri(const char* resourceUri)
         return NULL;
     }
 
-    OCResource * pointer = headResource;
-    while (pointer)
+    OCResource *pointer = OCResourceIndexFindUri(resourceUri);
+    if (!pointer)
     {
-        if (strcmp(resourceUri, pointer->uri) == 0)
-        {
-            return pointer;
-        }
-        pointer = pointer->next;
+        OIC_LOG_V(INFO, TAG, "Resource %s not found", resourceUri);
     }
-    OIC_LOG_V(INFO, TAG, "Resource %s not found", resourceUri);
-    return NULL;
+    return pointer;
 }
 
 OCStackResult CheckRequestsEndpoint(const OCDevAddr *reqDevAddr,
@@ -1973,6 +1970,8 @@ static OCStackResult HandleVirtualResource (OCServerRequest *request, OCResource
     OCPayload* payload = NULL;
     char *interfaceQuery = NULL;
     char *resourceTypeQuery = NULL;
+    bool cacheable = false;
+    uint32_t cacheGeneration = 0;
 
     OIC_LOG(INFO, TAG, "Entering HandleVirtualResource");
 
@@ -2028,16 +2027,6 @@ static OCStackResult HandleVirtualResource (OCServerRequest *request, OCResource
             goto exit;
         }
 
-        CAEndpoint_t *networkInfo = NULL;
-        size_t infoSize = 0;
-
-        CAResult_t caResult = CAGetNetworkInformation(&networkInfo, &infoSize);
-        if (CA_STATUS_FAILED == caResult)
-        {
-            OIC_LOG(ERROR, TAG, "CAGetNetworkInformation has error on parsing network infomation");
-            return OC_STACK_ERROR;
-        }
-
         discoveryResult = getQueryParamsForFiltering (virtualUriInRequest, request->query,
                 &interfaceQuery, &resourceTypeQuery);
         VERIFY_SUCCESS(discoveryResult);
@@ -2048,6 +2037,37 @@ static OCStackResult HandleVirtualResource (OCServerRequest *request, OCResource
             interfaceQuery = OICStrdup(OC_RSRVD_INTERFACE_LL);
         }
 
+        cacheable = OCDiscoveryCacheAccepts(request);
+        if (cacheable)
+        {
+            size_t encodedSize = 0;
+            uint8_t *encoded = OCDiscoveryCacheGet(virtualUriInRequest, interfaceQuery,
+                                                   resourceTypeQuery, request, &encodedSize,
+                                                   &cacheGeneration);
+            if (encoded)
+            {
+                request->encodedPayload = encoded;
+                request->encodedPayloadSize = encodedSize;
+
+                // Only the type of the payload is read when the response is encoded.
+                OCPayload encodedPayload = { PAYLOAD_TYPE_DISCOVERY };
+                SendNonPersistantDiscoveryResponse(request, &encodedPayload, OC_EH_OK);
+                discoveryResult = OC_STACK_OK;
+                goto exit;
+            }
+        }
+
+        CAEndpoint_t *networkInfo = NULL;
+        size_t infoSize = 0;
+
+        CAResult_t caResult = CAGetNetworkInformation(&networkInfo, &infoSize);
+        if (CA_STATUS_FAILED == caResult)
+        {
+            OIC_LOG(ERROR, TAG, "CAGetNetworkInformation has error on parsing network infomation");
+            discoveryResult = OC_STACK_ERROR;
+            goto exit;
+        }
+
         discoveryResult = discoveryPayloadCreateAndAddDeviceId(&payload);
         VERIFY_PARAM_NON_NULL(TAG, payload, "Failed creating Discovery Payload.");
         VERIFY_SUCCESS(discoveryResult);
@@ -2062,7 +2082,31 @@ static OCStackResult HandleVirtualResource (OCServerRequest *request, OCResource
 #ifdef MQ_BROKER
         prop = (OC_MQ_BROKER_URI == virtualUriInRequest) ? OC_MQ_BROKER : prop;
 #endif
-        for (; resource && discoveryResult == OC_STACK_OK; resource = resource->next)
+        // With a resource type or an interface filter, only the resources bound to it
+        // are visited, in the order they were created.
+        OCResource * const *candidates = NULL;
+        size_t candidateCount = 0;
+        size_t candidate = 0;
+        bool useIndex = false;
+        if (resourceTypeQuery)
+        {
+            candidateCount = OCResourceIndexGetByType(resourceTypeQuery, &candidates);
+            useIndex = true;
+        }
+        else if (interfaceQuery && 0 != strcmp(interfaceQuery, OC_RSRVD_INTERFACE_LL)
+                 && 0 != strcmp(interfaceQuery, OC_RSRVD_INTERFACE_DEFAULT))
+        {
+            candidateCount = OCResourceIndexGetByInterface(interfaceQuery, &candidates);
+            useIndex = true;
+        }
+        if (useIndex)
+        {
+            resource = candidateCount ? candidates[0] : NULL;
+        }
+
+        for (; resource && discoveryResult == OC_STACK_OK;
+             resource = useIndex ? ((++candidate < candidateCount) ? candidates[candidate] : NULL)
+                                 : resource->next)
         {
             // This case will handle when no resource type and it is oic.if.ll.
             // Do not assume check if the query is ll
@@ -2194,6 +2238,20 @@ static OCStackResult HandleVirtualResource (OCServerRequest *request, OCResource
         OIC_LOG_PAYLOAD(DEBUG, payload);
         if(discoveryResult == OC_STACK_OK)
         {
+            if (cacheable && payload)
+            {
+                // Encode the response once, for the request and for the cache.
+                uint8_t *encoded = NULL;
+                size_t encodedSize = 0;
+                if (OC_STACK_OK == OCConvertPayload(payload, request->acceptFormat,
+                                                    &encoded, &encodedSize))
+                {
+                    OCDiscoveryCachePut(virtualUriInRequest, interfaceQuery, resourceTypeQuery,
+                                        request, encoded, encodedSize, cacheGeneration);
+                    request->encodedPayload = encoded;
+                    request->encodedPayloadSize = encodedSize;
+                }
+            }
             SendNonPersistantDiscoveryResponse(request, payload, OC_EH_OK);
         }
         else // Error handling
@@ -2835,6 +2893,12 @@ static OCStackResult SetAttributeInternal(OCResource *resource,
         return OC_STACK_INVALID_PARAM;
     }
 
+    // Baseline discovery responses include the device name.
+    if (0 == strcmp(attribute, OC_RSRVD_DEVICE_NAME))
+    {
+        OCDiscoveryCacheInvalidate();
+    }
+
     // See if the attribute already exists in the list.
     for (resAttrib = resource->rsrcAttributes; resAttrib; resAttrib = resAttrib->next)
     {
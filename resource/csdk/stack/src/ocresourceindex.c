@@ -0,0 +1,523 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <string.h>
+
+#include "ocresourceindex.h"
+#include "oic_malloc.h"
+#include "oic_string.h"
+#include "experimental/logger.h"
+
+#define TAG "OIC_RI_RESOURCEINDEX"
+
+/** Number of buckets the tables start with, a power of 2. */
+#define OC_RESOURCE_INDEX_MIN_BUCKETS (16)
+
+/** Resources a resource type or an interface is bound to. */
+typedef struct OCResourceIndexList
+{
+    /** Next list in the same bucket. */
+    struct OCResourceIndexList *next;
+
+    /** Name of the resource type or of the interface. */
+    char *name;
+
+    /** Hash of name. */
+    uint32_t hash;
+
+    /** Resources, ordered by OCResource::indexOrder. */
+    OCResource **resources;
+
+    /** Number of resources. */
+    size_t count;
+
+    /** Number of resources the array has room for. */
+    size_t capacity;
+} OCResourceIndexList;
+
+/** Hash table of the lists of one kind of name. */
+typedef struct
+{
+    OCResourceIndexList **buckets;
+    size_t bucketCount;
+    size_t count;
+} OCResourceNameIndex;
+
+/** Hash table of the resources, chained by one of the index links of OCResource. */
+typedef struct
+{
+    OCResource **buckets;
+    size_t bucketCount;
+    size_t count;
+} OCResourceTable;
+
+static OCResourceTable g_handleIndex = { NULL, 0, 0 };
+static OCResourceTable g_uriIndex = { NULL, 0, 0 };
+static OCResourceNameIndex g_typeIndex = { NULL, 0, 0 };
+static OCResourceNameIndex g_interfaceIndex = { NULL, 0, 0 };
+
+/** Creation order of the next resource added. */
+static uint64_t g_nextIndexOrder = 0;
+
+static uint32_t HashString(const char *str)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (const unsigned char *p = (const unsigned char *)str; *p; p++)
+    {
+        hash = (hash ^ *p) * 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t HashPointer(const void *pointer)
+{
+    uintptr_t value = (uintptr_t)pointer;
+    // Resources are aligned, mix the high bits into the low ones.
+    value ^= value >> 16;
+    value *= 0x45d9f3bu;
+    value ^= value >> 16;
+    return (uint32_t)value;
+}
+
+static OCResource **NextLink(OCResource *resource, bool byUri)
+{
+    return byUri ? &resource->uriIndexNext : &resource->handleIndexNext;
+}
+
+static uint32_t ResourceHash(const OCResource *resource, bool byUri)
+{
+    return byUri ? HashString(resource->uri) : HashPointer(resource);
+}
+
+/**
+ * Doubles the buckets of a table when it holds more resources than buckets.
+ */
+static bool GrowTable(OCResourceTable *table, bool byUri)
+{
+    if (table->count < table->bucketCount)
+    {
+        return true;
+    }
+
+    size_t bucketCount = table->bucketCount ? table->bucketCount * 2
+                                            : OC_RESOURCE_INDEX_MIN_BUCKETS;
+    OCResource **buckets = (OCResource **)OICCalloc(bucketCount, sizeof(OCResource *));
+    if (!buckets)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < table->bucketCount; i++)
+    {
+        OCResource *resource = table->buckets[i];
+        while (resource)
+        {
+            OCResource *next = *NextLink(resource, byUri);
+            size_t bucket = ResourceHash(resource, byUri) & (bucketCount - 1);
+            *NextLink(resource, byUri) = buckets[bucket];
+            buckets[bucket] = resource;
+            resource = next;
+        }
+    }
+
+    OICFree(table->buckets);
+    table->buckets = buckets;
+    table->bucketCount = bucketCount;
+    return true;
+}
+
+static OCStackResult AddToTable(OCResourceTable *table, OCResource *resource, bool byUri)
+{
+    if (!GrowTable(table, byUri))
+    {
+        OIC_LOG(ERROR, TAG, "Failed to grow resource index");
+        return OC_STACK_NO_MEMORY;
+    }
+
+    size_t bucket = ResourceHash(resource, byUri) & (table->bucketCount - 1);
+    *NextLink(resource, byUri) = table->buckets[bucket];
+    table->buckets[bucket] = resource;
+    table->count++;
+    return OC_STACK_OK;
+}
+
+static void RemoveFromTable(OCResourceTable *table, OCResource *resource, bool byUri)
+{
+    if (!table->bucketCount)
+    {
+        return;
+    }
+
+    size_t bucket = ResourceHash(resource, byUri) & (table->bucketCount - 1);
+    for (OCResource **link = &table->buckets[bucket]; *link; link = NextLink(*link, byUri))
+    {
+        if (*link == resource)
+        {
+            *link = *NextLink(resource, byUri);
+            *NextLink(resource, byUri) = NULL;
+            table->count--;
+            return;
+        }
+    }
+}
+
+static OCResourceIndexList *FindList(const OCResourceNameIndex *index, const char *name,
+                                     uint32_t hash)
+{
+    if (!index->bucketCount)
+    {
+        return NULL;
+    }
+
+    for (OCResourceIndexList *list = index->buckets[hash & (index->bucketCount - 1)];
+         list; list = list->next)
+    {
+        if (list->hash == hash && 0 == strcmp(list->name, name))
+        {
+            return list;
+        }
+    }
+    return NULL;
+}
+
+static OCResourceIndexList *GetList(OCResourceNameIndex *index, const char *name)
+{
+    uint32_t hash = HashString(name);
+    OCResourceIndexList *list = FindList(index, name, hash);
+    if (list)
+    {
+        return list;
+    }
+
+    if (index->count >= index->bucketCount)
+    {
+        size_t bucketCount = index->bucketCount ? index->bucketCount * 2
+                                                : OC_RESOURCE_INDEX_MIN_BUCKETS;
+        OCResourceIndexList **buckets =
+            (OCResourceIndexList **)OICCalloc(bucketCount, sizeof(OCResourceIndexList *));
+        if (!buckets)
+        {
+            return NULL;
+        }
+        for (size_t i = 0; i < index->bucketCount; i++)
+        {
+            OCResourceIndexList *current = index->buckets[i];
+            while (current)
+            {
+                OCResourceIndexList *next = current->next;
+                size_t bucket = current->hash & (bucketCount - 1);
+                current->next = buckets[bucket];
+                buckets[bucket] = current;
+                current = next;
+            }
+        }
+        OICFree(index->buckets);
+        index->buckets = buckets;
+        index->bucketCount = bucketCount;
+    }
+
+    list = (OCResourceIndexList *)OICCalloc(1, sizeof(OCResourceIndexList));
+    if (!list)
+    {
+        return NULL;
+    }
+    list->name = OICStrdup(name);
+    if (!list->name)
+    {
+        OICFree(list);
+        return NULL;
+    }
+    list->hash = hash;
+
+    size_t bucket = hash & (index->bucketCount - 1);
+    list->next = index->buckets[bucket];
+    index->buckets[bucket] = list;
+    index->count++;
+    return list;
+}
+
+/**
+ * Finds the position of a resource in a list, or the position it is inserted at.
+ */
+static size_t FindPosition(const OCResourceIndexList *list, const OCResource *resource)
+{
+    // Resources are mostly bound in the order they are created, check the end first.
+    if (!list->count || list->resources[list->count - 1]->indexOrder < resource->indexOrder)
+    {
+        return list->count;
+    }
+
+    size_t low = 0;
+    size_t high = list->count;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (list->resources[middle]->indexOrder < resource->indexOrder)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+static OCStackResult AddToList(OCResourceNameIndex *index, const char *name,
+                               OCResource *resource)
+{
+    if (!resource || !name)
+    {
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    OCResourceIndexList *list = GetList(index, name);
+    if (!list)
+    {
+        OIC_LOG_V(ERROR, TAG, "Failed to index %s", name);
+        return OC_STACK_NO_MEMORY;
+    }
+
+    size_t position = FindPosition(list, resource);
+    if (position < list->count && list->resources[position] == resource)
+    {
+        return OC_STACK_OK;
+    }
+
+    if (list->count == list->capacity)
+    {
+        size_t capacity = list->capacity ? list->capacity * 2 : 4;
+        OCResource **resources =
+            (OCResource **)OICRealloc(list->resources, capacity * sizeof(OCResource *));
+        if (!resources)
+        {
+            OIC_LOG_V(ERROR, TAG, "Failed to index %s", name);
+            return OC_STACK_NO_MEMORY;
+        }
+        list->resources = resources;
+        list->capacity = capacity;
+    }
+
+    memmove(&list->resources[position + 1], &list->resources[position],
+            (list->count - position) * sizeof(OCResource *));
+    list->resources[position] = resource;
+    list->count++;
+    return OC_STACK_OK;
+}
+
+static void FreeList(OCResourceIndexList *list)
+{
+    OICFree(list->name);
+    OICFree(list->resources);
+    OICFree(list);
+}
+
+static void RemoveFromList(OCResourceNameIndex *index, const char *name,
+                           const OCResource *resource)
+{
+    uint32_t hash = HashString(name);
+    OCResourceIndexList *list = FindList(index, name, hash);
+    if (!list)
+    {
+        return;
+    }
+
+    size_t position = FindPosition(list, resource);
+    if (position < list->count && list->resources[position] == resource)
+    {
+        list->count--;
+        memmove(&list->resources[position], &list->resources[position + 1],
+                (list->count - position) * sizeof(OCResource *));
+    }
+
+    if (!list->count)
+    {
+        OCResourceIndexList **link = &index->buckets[hash & (index->bucketCount - 1)];
+        while (*link != list)
+        {
+            link = &(*link)->next;
+        }
+        *link = list->next;
+        index->count--;
+        FreeList(list);
+    }
+}
+
+static void FreeNameIndex(OCResourceNameIndex *index)
+{
+    for (size_t i = 0; i < index->bucketCount; i++)
+    {
+        OCResourceIndexList *list = index->buckets[i];
+        while (list)
+        {
+            OCResourceIndexList *next = list->next;
+            FreeList(list);
+            list = next;
+        }
+    }
+    OICFree(index->buckets);
+    memset(index, 0, sizeof(*index));
+}
+
+static size_t GetResources(const OCResourceNameIndex *index, const char *name,
+                           OCResource * const **resources)
+{
+    if (!resources)
+    {
+        return 0;
+    }
+    *resources = NULL;
+    if (!name)
+    {
+        return 0;
+    }
+
+    OCResourceIndexList *list = FindList(index, name, HashString(name));
+    if (!list)
+    {
+        return 0;
+    }
+    *resources = list->resources;
+    return list->count;
+}
+
+OCStackResult OCResourceIndexAdd(OCResource *resource)
+{
+    if (!resource)
+    {
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    resource->indexOrder = g_nextIndexOrder++;
+    OCStackResult result = AddToTable(&g_handleIndex, resource, false);
+    if (OC_STACK_OK == result && resource->uri)
+    {
+        result = OCResourceIndexAddUri(resource);
+    }
+    return result;
+}
+
+OCStackResult OCResourceIndexAddUri(OCResource *resource)
+{
+    if (!resource || !resource->uri)
+    {
+        return OC_STACK_INVALID_PARAM;
+    }
+    return AddToTable(&g_uriIndex, resource, true);
+}
+
+OCStackResult OCResourceIndexAddType(OCResource *resource, const char *resourceType)
+{
+    return AddToList(&g_typeIndex, resourceType, resource);
+}
+
+OCStackResult OCResourceIndexAddInterface(OCResource *resource, const char *interfaceName)
+{
+    return AddToList(&g_interfaceIndex, interfaceName, resource);
+}
+
+void OCResourceIndexRemove(OCResource *resource)
+{
+    if (!resource)
+    {
+        return;
+    }
+
+    for (OCResourceType *type = resource->rsrcType; type; type = type->next)
+    {
+        if (type->resourcetypename)
+        {
+            RemoveFromList(&g_typeIndex, type->resourcetypename, resource);
+        }
+    }
+    for (OCResourceInterface *itf = resource->rsrcInterface; itf; itf = itf->next)
+    {
+        if (itf->name)
+        {
+            RemoveFromList(&g_interfaceIndex, itf->name, resource);
+        }
+    }
+    if (resource->uri)
+    {
+        RemoveFromTable(&g_uriIndex, resource, true);
+    }
+    RemoveFromTable(&g_handleIndex, resource, false);
+}
+
+void OCResourceIndexTerminate(void)
+{
+    OICFree(g_handleIndex.buckets);
+    memset(&g_handleIndex, 0, sizeof(g_handleIndex));
+    OICFree(g_uriIndex.buckets);
+    memset(&g_uriIndex, 0, sizeof(g_uriIndex));
+    FreeNameIndex(&g_typeIndex);
+    FreeNameIndex(&g_interfaceIndex);
+}
+
+bool OCResourceIndexContains(const OCResource *resource)
+{
+    if (!resource || !g_handleIndex.bucketCount)
+    {
+        return false;
+    }
+
+    size_t bucket = HashPointer(resource) & (g_handleIndex.bucketCount - 1);
+    for (OCResource *current = g_handleIndex.buckets[bucket]; current;
+         current = current->handleIndexNext)
+    {
+        if (current == resource)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+OCResource *OCResourceIndexFindUri(const char *uri)
+{
+    if (!uri || !g_uriIndex.bucketCount)
+    {
+        return NULL;
+    }
+
+    size_t bucket = HashString(uri) & (g_uriIndex.bucketCount - 1);
+    for (OCResource *current = g_uriIndex.buckets[bucket]; current;
+         current = current->uriIndexNext)
+    {
+        if (0 == strcmp(current->uri, uri))
+        {
+            return current;
+        }
+    }
+    return NULL;
+}
+
+size_t OCResourceIndexGetByType(const char *resourceType, OCResource * const **resources)
+{
+    return GetResources(&g_typeIndex, resourceType, resources);
+}
+
+size_t OCResourceIndexGetByInterface(const char *interfaceName,
+                                     OCResource * const **resources)
+{
+    return GetResources(&g_interfaceIndex, interfaceName, resources);
+}
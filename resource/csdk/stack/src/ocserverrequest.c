@@ -188,6 +188,61 @@ static OCStackResult OCSendResponse (const CAEndpoint_t *object, CAResponseInfo_
     return OC_STACK_OK;
 }
 
+/**
+ * Release the header options of a response built by HandleSingleResponse. They are
+ * allocated in the arena of the request, except in routing builds where RMAddInfo
+ * reallocates them on the heap to add the route option.
+ *
+ * @param[in]  responseInfo     CA response info.
+ */
+static void FreeResponseOptions(CAResponseInfo_t *responseInfo)
+{
+#if defined (ROUTING_GATEWAY) || defined (ROUTING_EP)
+    OICFree(responseInfo->info.options);
+#endif
+    responseInfo->info.options = NULL;
+}
+
+/**
+ * Send a notification, which has been encoded for the observer of the server request,
+ * to the other observers listed in the server request.
+ *
+ * @param[in]  serverRequest    Server request of the notification.
+ * @param[in]  responseInfo     CA response info sent to the observer of the server request.
+ *                              Token, message type and id are overwritten.
+ *
+ * @return ::OC_STACK_OK if all notifications were sent, some other value upon failure.
+ */
+static OCStackResult SendNotificationCopies(const OCServerRequest *serverRequest,
+                                            CAResponseInfo_t *responseInfo)
+{
+    OCStackResult result = OC_STACK_OK;
+
+    for (size_t i = 0; i < serverRequest->numNotificationTargets; i++)
+    {
+        const OCNotificationTarget *target = &serverRequest->notificationTargets[i];
+        CAEndpoint_t endpoint = {.adapter = CA_DEFAULT_ADAPTER};
+        CopyDevAddrToEndpoint(&target->devAddr, &endpoint);
+
+        // To assign new messageId in CA.
+        responseInfo->info.messageId = 0;
+        responseInfo->info.type = (OC_HIGH_QOS == target->qos) ? CA_MSG_CONFIRM
+                                                               : CA_MSG_NONCONFIRM;
+        memcpy(responseInfo->info.token, target->token, target->tokenLength);
+        responseInfo->info.tokenLength = target->tokenLength;
+
+        OCStackResult sendResult = OCSendResponse(&endpoint, responseInfo);
+        if (OC_STACK_OK != sendResult)
+        {
+            OIC_LOG_V(ERROR, TAG, "Notification to [%s:%u] failed", endpoint.addr,
+                      endpoint.port);
+            result = sendResult;
+        }
+    }
+
+    return result;
+}
+
 static CAPayloadFormat_t OCToCAPayloadFormat (OCPayloadFormat ocFormat)
 {
     switch (ocFormat)
@@ -289,6 +344,7 @@ OCStackResult AddServerRequest (OCServerRequest ** request,
                                 OCHeaderOption * rcvdVendorSpecificHeaderOptions,
                                 OCPayloadFormat payloadFormat,
                                 uint8_t * payload,
+                                oc_refcounter payloadRef,
                                 CAToken_t requestToken,
                                 uint8_t tokenLength,
                                 char * resourceUrl,
@@ -304,10 +360,19 @@ OCStackResult AddServerRequest (OCServerRequest ** request,
 
     OIC_LOG_V(INFO, TAG, "AddServerRequest entry [%s:%u]", devAddr->addr, devAddr->port);
 
-    OCServerRequest * serverRequest = (OCServerRequest *) OICCalloc(1, sizeof(OCServerRequest) +
-                                                            (payloadSize ? payloadSize : 1) - 1);
+    // The request, its token and the allocations made while it is handled share one
+    // arena, allocated with the request. A payload received by reference is shared,
+    // any other payload is copied into the arena. The header options of the response
+    // are only known once it is sent; being larger than a block, they get a block of
+    // their own sized for them.
+    const bool sharePayload = payload && payloadSize && payloadRef;
+    const size_t copySize = (payload && !sharePayload) ? payloadSize : 0;
+    OICArena_t *arena = OICArenaCreate(sizeof(OCServerRequest) + copySize + tokenLength);
+    OCServerRequest * serverRequest = (OCServerRequest *) OICArenaCalloc(arena, 1,
+                                                                         sizeof(OCServerRequest));
     VERIFY_NON_NULL(serverRequest);
 
+    serverRequest->arena = arena;
     serverRequest->coapID = coapMessageID;
     serverRequest->delayedResNeeded = delayedResNeeded;
     serverRequest->notificationFlag = notificationFlag;
@@ -332,9 +397,16 @@ OCStackResult AddServerRequest (OCServerRequest ** request,
     }
     if (payload && payloadSize)
     {
-        // destination is at least 1 greater than the source, so a NULL always exists in the
-        // last character
-        memcpy(serverRequest->payload, payload, payloadSize);
+        if (sharePayload)
+        {
+            serverRequest->payload = payload;
+            serverRequest->payloadRef = oc_refcounter_inc(payloadRef);
+        }
+        else
+        {
+            serverRequest->payload = (uint8_t *) OICArenaMemdup(arena, payload, payloadSize);
+            VERIFY_NON_NULL(serverRequest->payload);
+        }
         serverRequest->payloadSize = payloadSize;
         serverRequest->payloadFormat = payloadFormat;
     }
@@ -347,9 +419,9 @@ OCStackResult AddServerRequest (OCServerRequest ** request,
         // particular library implementation (it may or may not be a null pointer).
         if (tokenLength)
         {
-            serverRequest->requestToken = (CAToken_t) OICMalloc(tokenLength);
+            serverRequest->requestToken = (CAToken_t) OICArenaMemdup(arena, requestToken,
+                                                                     tokenLength);
             VERIFY_NON_NULL(serverRequest->requestToken);
-            memcpy(serverRequest->requestToken, requestToken, tokenLength);
         }
     }
     serverRequest->tokenLength = tokenLength;
@@ -368,11 +440,11 @@ OCStackResult AddServerRequest (OCServerRequest ** request,
     return OC_STACK_OK;
 
 exit:
-    if (serverRequest)
+    if (serverRequest && serverRequest->payloadRef)
     {
-        OICFree(serverRequest);
-        serverRequest = NULL;
+        oc_refcounter_dec(serverRequest->payloadRef);
     }
+    OICArenaDestroy(arena);
     *request = NULL;
     return OC_STACK_NO_MEMORY;
 }
@@ -414,8 +486,14 @@ void DeleteServerRequest(OCServerRequest * serverRequest)
         }
 
         RBL_REMOVE(ServerRequestTree, &g_serverRequestTree, serverRequest);
-        OICFree(serverRequest->requestToken);
-        OICFree(serverRequest);
+        OICFree(serverRequest->notificationTargets);
+        OICFree(serverRequest->encodedPayload);
+        if (serverRequest->payloadRef)
+        {
+            oc_refcounter_dec(serverRequest->payloadRef);
+        }
+        // Releases the request and its token too.
+        OICArenaDestroy(serverRequest->arena);
         serverRequest = NULL;
         OIC_LOG(INFO, TAG, "Server Request Removed");
     }
@@ -605,9 +683,17 @@ OCStackResult HandleSingleResponse(OCEntityHandlerResponse * ehResponse)
 
     if (responseInfo.info.numOptions > 0)
     {
+#if defined (ROUTING_GATEWAY) || defined (ROUTING_EP)
         responseInfo.info.options = (CAHeaderOption_t *)
                                       OICCalloc(responseInfo.info.numOptions,
-                                              sizeof(CAHeaderOption_t));
+                                                sizeof(CAHeaderOption_t));
+#else
+        // Released with the request.
+        responseInfo.info.options = (CAHeaderOption_t *)
+                                      OICArenaCalloc(serverRequest->arena,
+                                                     responseInfo.info.numOptions,
+                                                     sizeof(CAHeaderOption_t));
+#endif
 
         if(!responseInfo.info.options)
         {
@@ -658,7 +744,7 @@ OCStackResult HandleSingleResponse(OCEntityHandlerResponse * ehResponse)
             {
                 OIC_LOG(ERROR, TAG,
                     "New resource path must be less than CA_MAX_HEADER_OPTION_DATA_LENGTH");
-                OICFree(responseInfo.info.options);
+                FreeResponseOptions(&responseInfo);
                 return OC_STACK_INVALID_URI;
             }
 
@@ -736,12 +822,20 @@ OCStackResult HandleSingleResponse(OCEntityHandlerResponse * ehResponse)
                 // No preference set by the client, so default to CBOR then
             case OC_FORMAT_CBOR:
             case OC_FORMAT_VND_OCF_CBOR:
-                if((result = OCConvertPayload(ehResponse->payload, serverRequest->acceptFormat,
-                                &responseInfo.info.payload, &responseInfo.info.payloadSize))
-                        != OC_STACK_OK)
+                if (serverRequest->encodedPayload)
+                {
+                    // Encoded by the handler of the request, e.g. a cached discovery response.
+                    responseInfo.info.payload = serverRequest->encodedPayload;
+                    responseInfo.info.payloadSize = serverRequest->encodedPayloadSize;
+                    serverRequest->encodedPayload = NULL;
+                    serverRequest->encodedPayloadSize = 0;
+                }
+                else if((result = OCConvertPayload(ehResponse->payload,
+                                serverRequest->acceptFormat, &responseInfo.info.payload,
+                                &responseInfo.info.payloadSize)) != OC_STACK_OK)
                 {
                     OIC_LOG(ERROR, TAG, "Error converting payload");
-                    OICFree(responseInfo.info.options);
+                    FreeResponseOptions(&responseInfo);
                     return result;
                 }
                 // Add CONTENT_FORMAT OPT if payload exist
@@ -830,8 +924,17 @@ OCStackResult HandleSingleResponse(OCEntityHandlerResponse * ehResponse)
     result = OCSendResponse(&responseEndpoint, &responseInfo);
 #endif
 
+    if (serverRequest->numNotificationTargets)
+    {
+        OCStackResult copiesResult = SendNotificationCopies(serverRequest, &responseInfo);
+        if (OC_STACK_OK == result)
+        {
+            result = copiesResult;
+        }
+    }
+
     OICFree(responseInfo.info.payload);
-    OICFree(responseInfo.info.options);
+    FreeResponseOptions(&responseInfo);
     //Delete the request
     DeleteServerRequest(serverRequest);
     return result;
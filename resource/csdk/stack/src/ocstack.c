@@ -52,10 +52,14 @@
 #include "ocobserve.h"
 #include "experimental/ocrandom.h"
 #include "oic_malloc.h"
+#include "oic_arena.h"
 #include "oic_string.h"
+#include "oic_time.h"
 #include "experimental/logger.h"
 #include "trace.h"
 #include "ocserverrequest.h"
+#include "ocresourceindex.h"
+#include "ocdiscoverycache.h"
 #include "secureresourcemanager.h"
 #include "srmutility.h"
 #include "psinterface.h"
@@ -152,6 +156,11 @@ static uint8_t PresenceTimeOutSize = 0;
 static uint32_t PresenceTimeOut[] = {50, 75, 85, 95, 100};
 #endif
 
+#ifdef ROUTING_GATEWAY
+/** Interval in milliseconds at which OCProcessEvent runs the routing manager timers. */
+static const uint32_t RoutingProcessInterval = 1000;
+#endif
+
 static OCMode myStackMode;
 #ifdef RA_ADAPTER
 //TODO: revisit this design
@@ -192,6 +201,12 @@ bool g_multicastServerStopped = false;
 //TODO: we should allow the server to define this
 #define MAX_OBSERVE_AGE (0x2FFFFUL)
 
+/** Stack memory for the allocations made while a received request is handed to the
+ *  server request layer, larger payloads spill to the heap.*/
+#ifndef OC_REQUEST_ARENA_SIZE
+#define OC_REQUEST_ARENA_SIZE (512)
+#endif
+
 #define MILLISECONDS_PER_SECOND   (1000)
 
 //-----------------------------------------------------------------------------
@@ -213,14 +228,16 @@ static OCDoHandle GenerateInvocationHandle(void);
 static OCStackResult initResources(void);
 
 /**
- * Add a resource to the end of the linked list of resources.
+ * Add a resource to the end of the linked list of resources and to the resource index.
  *
  * @param resource Resource to be added
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
  */
-static void insertResource(OCResource *resource);
+static OCStackResult insertResource(OCResource *resource);
 
 /**
- * Find a resource in the linked list of resources.
+ * Find a resource in the resource index.
  *
  * @param resource Resource to be found.
  * @return Pointer to resource that was found in the linked list or NULL if the resource was not
@@ -320,6 +337,21 @@ static void deleteAllResources(void);
  */
 static void incrementSequenceNumber(OCResource * resPtr);
 
+/**
+ * Notify all observers of a resource, without consulting its notification policy.
+ *
+ * @param resPtr Pointer to resource.
+ * @param qos    Quality of service of the notification.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+static OCStackResult NotifyAllObserversNow(OCResource *resPtr, OCQualityOfService qos);
+
+/**
+ * Send the notifications held back by notification policies which are due.
+ */
+static void ProcessDeferredNotifications(void);
+
 /*
  * Attempts to initialize every network interface that the CA Layer might have compiled in.
  *
@@ -1974,8 +2006,8 @@ void OC_CALL OCHandleResponse(const CAEndpoint_t* endPoint, const CAResponseInfo
                 else
                 {
                     // To keep discovery callbacks active.
-                    cbNode->TTL = GetTicks(MAX_CB_TIMEOUT_SECONDS *
-                                            MILLISECONDS_PER_SECOND);
+                    SetClientCBTTL(cbNode, GetTicks(MAX_CB_TIMEOUT_SECONDS *
+                                                    MILLISECONDS_PER_SECOND));
                 }
             }
 
@@ -2298,7 +2330,7 @@ OCStackResult HandleStackRequests(OCServerProtocolRequest * protocolRequest)
                 protocolRequest->observationOption, protocolRequest->qos,
                 protocolRequest->query, protocolRequest->rcvdVendorSpecificHeaderOptions,
                 protocolRequest->payloadFormat, protocolRequest->payload,
-                protocolRequest->requestToken, protocolRequest->tokenLength,
+                protocolRequest->payloadRef, protocolRequest->requestToken, protocolRequest->tokenLength,
                 protocolRequest->resourceUrl, protocolRequest->reqTotalSize,
                 protocolRequest->acceptFormat, protocolRequest->acceptVersion,
                 &protocolRequest->devAddr);
@@ -2361,61 +2393,68 @@ void OCHandleRequests(const CAEndpoint_t* endPoint, const CARequestInfo_t* reque
     directResponseType = (directResponseType == CA_MSG_CONFIRM)
             ? CA_MSG_ACKNOWLEDGE : CA_MSG_NONCONFIRM;
 
-    char * uriWithoutQuery = NULL;
-    char * query = NULL;
     OCStackResult requestResult = OC_STACK_ERROR;
+    OCServerProtocolRequest serverRequest = { 0 };
 
-    requestResult = getQueryFromUri(requestInfo->info.resourceUri, &query, &uriWithoutQuery);
-
-    if (requestResult != OC_STACK_OK || !uriWithoutQuery)
+    // Split the URI and the query straight into the request.
+    const char *resourceUri = requestInfo->info.resourceUri;
+    const char *delimiter = resourceUri ? strchr(resourceUri, '?') : NULL;
+    size_t uriLength = 0;
+    if (resourceUri)
     {
-        OIC_LOG_V(ERROR, TAG, "getQueryFromUri() failed with OC error code %d\n", requestResult);
-        return;
+        uriLength = delimiter ? (size_t)(delimiter - resourceUri) : strlen(resourceUri);
     }
-    OIC_LOG_V(INFO, TAG, "URI without query: %s", uriWithoutQuery);
-    OIC_LOG_V(INFO, TAG, "Query : %s", query);
-
-    OCServerProtocolRequest serverRequest = { 0 };
-    if (strlen(uriWithoutQuery) < MAX_URI_LENGTH)
+    if (!uriLength)
     {
-        OICStrcpy(serverRequest.resourceUrl, sizeof(serverRequest.resourceUrl), uriWithoutQuery);
-        OICFree(uriWithoutQuery);
+        OIC_LOG(ERROR, TAG, "Request without URI.");
+        return;
     }
-    else
+    if (uriLength >= MAX_URI_LENGTH)
     {
         OIC_LOG(ERROR, TAG, "URI length exceeds MAX_URI_LENGTH.");
-        OICFree(uriWithoutQuery);
-        OICFree(query);
         return;
     }
+    memcpy(serverRequest.resourceUrl, resourceUri, uriLength);
 
-    if (query)
+    if (delimiter)
     {
-        if (strlen(query) < MAX_QUERY_LENGTH)
-        {
-            OICStrcpy(serverRequest.query, sizeof(serverRequest.query), query);
-            OICFree(query);
-        }
-        else
+        size_t queryLength = strlen(delimiter + 1);
+        if (queryLength >= MAX_QUERY_LENGTH)
         {
             OIC_LOG(ERROR, TAG, "Query length exceeds MAX_QUERY_LENGTH.");
-            OICFree(query);
             return;
         }
+        memcpy(serverRequest.query, delimiter + 1, queryLength);
     }
+    OIC_LOG_V(INFO, TAG, "URI without query: %s", serverRequest.resourceUrl);
+    OIC_LOG_V(INFO, TAG, "Query : %s", serverRequest.query);
+
+    // The copies of the payload and the token live until the request was handled,
+    // they are taken from an arena on the stack.
+    uint8_t arenaBuffer[OC_REQUEST_ARENA_SIZE];
+    OICArena_t arena;
+    OICArenaInit(&arena, arenaBuffer, sizeof(arenaBuffer), 0);
 
     if ((requestInfo->info.payload) && (0 < requestInfo->info.payloadSize))
     {
         serverRequest.payloadFormat = CAToOCPayloadFormat(requestInfo->info.payloadFormat);
         serverRequest.reqTotalSize = requestInfo->info.payloadSize;
-        serverRequest.payload = (uint8_t *) OICMalloc(requestInfo->info.payloadSize);
+        if (requestInfo->info.payloadRef)
+        {
+            // The received payload is shared, the server request keeps a reference to it.
+            serverRequest.payload = requestInfo->info.payload;
+            serverRequest.payloadRef = requestInfo->info.payloadRef;
+        }
+        else
+        {
+            serverRequest.payload = (uint8_t *) OICArenaMemdup(&arena, requestInfo->info.payload,
+                                                               requestInfo->info.payloadSize);
+        }
         if (!serverRequest.payload)
         {
             OIC_LOG(ERROR, TAG, "Allocation for payload failed.");
             return;
         }
-        memcpy (serverRequest.payload, requestInfo->info.payload,
-                requestInfo->info.payloadSize);
     }
     else
     {
@@ -2443,7 +2482,7 @@ void OCHandleRequests(const CAEndpoint_t* endPoint, const CARequestInfo_t* reque
                                     requestInfo->info.options, requestInfo->info.token,
                                     requestInfo->info.tokenLength, requestInfo->info.resourceUri,
                                     CA_RESPONSE_DATA);
-            OICFree(serverRequest.payload);
+            OICArenaRelease(&arena);
             return;
     }
 
@@ -2454,7 +2493,8 @@ void OCHandleRequests(const CAEndpoint_t* endPoint, const CARequestInfo_t* reque
     if (serverRequest.tokenLength)
     {
         // Non empty token
-        serverRequest.requestToken = (CAToken_t)OICMalloc(requestInfo->info.tokenLength);
+        serverRequest.requestToken = (CAToken_t)OICArenaMemdup(&arena, requestInfo->info.token,
+                                                               requestInfo->info.tokenLength);
 
         if (!serverRequest.requestToken)
         {
@@ -2464,10 +2504,9 @@ void OCHandleRequests(const CAEndpoint_t* endPoint, const CARequestInfo_t* reque
                                     requestInfo->info.options, requestInfo->info.token,
                                     requestInfo->info.tokenLength, requestInfo->info.resourceUri,
                                     CA_RESPONSE_DATA);
-            OICFree(serverRequest.payload);
+            OICArenaRelease(&arena);
             return;
         }
-        memcpy(serverRequest.requestToken, requestInfo->info.token, requestInfo->info.tokenLength);
     }
 
     serverRequest.acceptFormat = CAToOCPayloadFormat(requestInfo->info.acceptFormat);
@@ -2510,8 +2549,7 @@ void OCHandleRequests(const CAEndpoint_t* endPoint, const CARequestInfo_t* reque
                                 requestInfo->info.options, requestInfo->info.token,
                                 requestInfo->info.tokenLength, requestInfo->info.resourceUri,
                                 CA_RESPONSE_DATA);
-        OICFree(serverRequest.payload);
-        OICFree(serverRequest.requestToken);
+        OICArenaRelease(&arena);
         return;
     }
     serverRequest.numRcvdVendorSpecificHeaderOptions = tempNum;
@@ -2552,8 +2590,7 @@ void OCHandleRequests(const CAEndpoint_t* endPoint, const CARequestInfo_t* reque
     }
     // requestToken is fed to HandleStackRequests, which then goes to AddServerRequest.
     // The token is copied in there, and is thus still owned by this function.
-    OICFree(serverRequest.payload);
-    OICFree(serverRequest.requestToken);
+    OICArenaRelease(&arena);
     OIC_LOG(INFO, TAG, "Exit OCHandleRequests");
 }
 
@@ -2762,6 +2799,9 @@ OCStackResult OCInitializeInternal(OCMode mode, OCTransportFlags serverFlags,
     result = InitializeScheduleResourceList();
     VERIFY_SUCCESS(result, OC_STACK_OK);
 
+    result = InitializePendingNotifications();
+    VERIFY_SUCCESS(result, OC_STACK_OK);
+
     result = CAResultToOCResult(CAInitialize((CATransportAdapter_t)transportType));
     VERIFY_SUCCESS(result, OC_STACK_OK);
 
@@ -2845,6 +2885,7 @@ exit:
         OIC_LOG(ERROR, TAG, "Stack initialization error");
         TerminateScheduleResourceList();
         deleteAllResources();
+        TerminatePendingNotifications();
         CATerminate();
         stackState = OC_STACK_UNINITIALIZED;
     }
@@ -2915,6 +2956,7 @@ OCStackResult OCDeInitializeInternal(void)
     TerminateScheduleResourceList();
     // Free memory dynamically allocated for resources
     deleteAllResources();
+    TerminatePendingNotifications();
     // Remove all the client callbacks
     DeleteClientCBList();
     // Terminate connectivity-abstraction layer.
@@ -4007,6 +4049,8 @@ OCStackResult OC_CALL OCProcess(void)
 #endif
     CAHandleRequestResponse();
 
+    ProcessDeferredNotifications();
+
 #ifdef ROUTING_GATEWAY
     RMProcess();
 #endif
@@ -4018,6 +4062,96 @@ OCStackResult OC_CALL OCProcess(void)
     return OC_STACK_OK;
 }
 
+#ifdef WITH_PRESENCE
+/**
+ * Get the time left until OCProcessPresence has to poll a presence server or
+ * report a presence timeout.
+ *
+ * @return time in milliseconds, or UINT32_MAX if no presence callback is pending.
+ */
+static uint32_t GetNextPresenceTimeout(void)
+{
+    uint32_t nextTimeout = UINT32_MAX;
+    uint32_t now = GetTicks(0);
+    ClientCB* cbNode = NULL;
+
+    LL_FOREACH(g_cbList, cbNode)
+    {
+        if (OC_REST_PRESENCE != cbNode->method || !cbNode->presence ||
+            cbNode->presence->TTLlevel > PresenceTimeOutSize)
+        {
+            continue;
+        }
+
+        if (cbNode->presence->TTLlevel == PresenceTimeOutSize)
+        {
+            // The presence timeout is reported on the next OCProcessPresence call.
+            return 0;
+        }
+
+        uint32_t deadline = cbNode->presence->timeOut[cbNode->presence->TTLlevel];
+        uint32_t remaining = (deadline > now) ?
+            (uint32_t)(((uint64_t)(deadline - now) * MILLISECONDS_PER_SECOND) /
+                       COAP_TICKS_PER_SECOND) : 0;
+        if (remaining < nextTimeout)
+        {
+            nextTimeout = remaining;
+        }
+    }
+
+    return nextTimeout;
+}
+#endif // WITH_PRESENCE
+
+OCStackResult OC_CALL OCProcessEvent(uint32_t *nextEventTime)
+{
+    OCStackResult result = OCProcess();
+    if (OC_STACK_OK != result)
+    {
+        return result;
+    }
+
+    if (nextEventTime)
+    {
+        uint32_t nextTimeout = GetNextNotificationTimeout(OICGetCurrentTime(TIME_IN_MS));
+#ifdef WITH_PRESENCE
+        uint32_t presenceTimeout = GetNextPresenceTimeout();
+        if (presenceTimeout < nextTimeout)
+        {
+            nextTimeout = presenceTimeout;
+        }
+#endif
+#ifdef TCP_ADAPTER
+        uint32_t keepAliveTimeout = GetNextKeepAliveTimeout();
+        if (keepAliveTimeout < nextTimeout)
+        {
+            nextTimeout = keepAliveTimeout;
+        }
+        uint32_t pingTimeout = CAGetNextPingTimeout();
+        if (pingTimeout < nextTimeout)
+        {
+            nextTimeout = pingTimeout;
+        }
+#endif
+#ifdef ROUTING_GATEWAY
+        // RMProcess does not expose its timers, keep polling it periodically.
+        if (RoutingProcessInterval < nextTimeout)
+        {
+            nextTimeout = RoutingProcessInterval;
+        }
+#endif
+        *nextEventTime = nextTimeout;
+    }
+
+    return OC_STACK_OK;
+}
+
+void OC_CALL OCRegisterProcessEvent(oc_event event)
+{
+    RegisterPendingNotificationEvent(event);
+    CARegisterProcessEvent(event);
+}
+
 #ifdef WITH_PRESENCE
 OCStackResult OC_CALL OCStartPresence(const uint32_t ttl)
 {
@@ -4218,21 +4352,11 @@ OCStackResult OC_CALL OCCreateResourceWithEp(OCResourceHandle *handle,
         return OC_STACK_INVALID_PARAM;
     }
 
-    // If the headResource is NULL, then no resources have been created...
-    pointer = headResource;
-    if (pointer)
+    // Repeated URLs are not allowed.  If a repeat is found, exit with an error
+    if (OCResourceIndexFindUri(uri))
     {
-        // At least one resources is in the resource list, so we need to search for
-        // repeated URLs, which are not allowed.  If a repeat is found, exit with an error
-        while (pointer)
-        {
-            if (strncmp(uri, pointer->uri, MAX_URI_LENGTH) == 0)
-            {
-                OIC_LOG_V(ERROR, TAG, "Resource %s already exists", uri);
-                return OC_STACK_INVALID_PARAM;
-            }
-            pointer = pointer->next;
-        }
+        OIC_LOG_V(ERROR, TAG, "Resource %s already exists", uri);
+        return OC_STACK_INVALID_PARAM;
     }
     // Create the pointer and insert it into the resource list
     pointer = (OCResource *) OICCalloc(1, sizeof(OCResource));
@@ -4243,7 +4367,11 @@ OCStackResult OC_CALL OCCreateResourceWithEp(OCResourceHandle *handle,
     }
     pointer->sequenceNum = OC_OFFSET_SEQUENCE_NUMBER;
 
-    insertResource(pointer);
+    result = insertResource(pointer);
+    if (result != OC_STACK_OK)
+    {
+        goto exit;
+    }
 
     // Set the uri
     pointer->uri = OICStrdup(uri);
@@ -4252,6 +4380,11 @@ OCStackResult OC_CALL OCCreateResourceWithEp(OCResourceHandle *handle,
         result = OC_STACK_NO_MEMORY;
         goto exit;
     }
+    result = OCResourceIndexAddUri(pointer);
+    if (result != OC_STACK_OK)
+    {
+        goto exit;
+    }
 
     // Set resource to secure if caller did not specify
     if ((resourceProperties & OC_MASK_RESOURCE_SECURE) == 0)
@@ -4318,6 +4451,7 @@ OCStackResult OC_CALL OCCreateResourceWithEp(OCResourceHandle *handle,
 
     *handle = pointer;
     result = OC_STACK_OK;
+    OCDiscoveryCacheInvalidate();
 
 #ifdef WITH_PRESENCE
     if (presenceResource.handle)
@@ -4646,8 +4780,22 @@ static OCStackResult BindResourceTypeToResource(OCResource* resource,
     pointer->resourcetypename = str;
     pointer->next = NULL;
 
+    // Discovery filters on the resource types, not on rts-m. The type is indexed before
+    // it is bound, so that a bound type is always indexed; indexing a type again succeeds.
+    if (!isRtsM)
+    {
+        result = OCResourceIndexAddType(resource, resourceTypeName);
+        if (OC_STACK_OK != result)
+        {
+            goto exit;
+        }
+    }
+
     insertResourceType(resource, pointer, isRtsM);
+    pointer = NULL;
+    str = NULL;
     result = OC_STACK_OK;
+    OCDiscoveryCacheInvalidate();
 
 exit:
     if (result != OC_STACK_OK)
@@ -4693,8 +4841,30 @@ OCStackResult BindResourceInterfaceToResource(OCResource* resource,
 
     // Bind the resourceinterface to the resource
     insertResourceInterface(resource, pointer);
+    pointer = NULL;
+    str = NULL;
+    OCDiscoveryCacheInvalidate();
 
-    result = OC_STACK_OK;
+    // insertResourceInterface drops the interface when it fails to bind the default
+    // interface first.
+    result = OC_STACK_NO_MEMORY;
+    for (OCResourceInterface **link = &resource->rsrcInterface; *link; link = &(*link)->next)
+    {
+        if (0 == strcmp((*link)->name, resourceInterfaceName))
+        {
+            result = OCResourceIndexAddInterface(resource, resourceInterfaceName);
+            if (OC_STACK_OK != result)
+            {
+                // Indexing an interface again succeeds, so this one was just bound.
+                // Unbind it, discovery filtered on it would not find the resource.
+                OCResourceInterface *unbound = *link;
+                *link = unbound->next;
+                unbound->next = NULL;
+                deleteResourceInterface(unbound);
+            }
+            break;
+        }
+    }
 
     exit:
     if (result != OC_STACK_OK)
@@ -4734,6 +4904,7 @@ OCStackResult BindTpsTypeToResource(OCResource* resource,
 
     OIC_LOG_V(INFO, TAG, "Binding %d TPS flags to %s", supportedTps, resource->uri);
     resource->endpointType = supportedTps;
+    OCDiscoveryCacheInvalidate();
     return result;
 }
 
@@ -4911,6 +5082,7 @@ OCStackResult OC_CALL OCSetResourceProperties(OCResourceHandle handle, uint8_t r
         return OC_STACK_NO_RESOURCE;
     }
     resource->resourceProperties = (OCResourceProperty) (resource->resourceProperties | resourceProperties);
+    OCDiscoveryCacheInvalidate();
     return OC_STACK_OK;
 }
 
@@ -4925,6 +5097,7 @@ OCStackResult OC_CALL OCClearResourceProperties(OCResourceHandle handle, uint8_t
         return OC_STACK_NO_RESOURCE;
     }
     resource->resourceProperties = (OCResourceProperty) (resource->resourceProperties & ~resourceProperties);
+    OCDiscoveryCacheInvalidate();
     return OC_STACK_OK;
 }
 
@@ -5148,12 +5321,62 @@ OCStackResult SendStopNotification(void)
 }
 
 #endif // WITH_PRESENCE
+
+OCStackResult NotifyAllObserversNow(OCResource *resPtr, OCQualityOfService qos)
+{
+    //only increment in the case of regular observing (not presence)
+    incrementSequenceNumber(resPtr);
+#ifdef WITH_PRESENCE
+    return SendAllObserverNotification (OC_REST_OBSERVE, resPtr, MAX_OBSERVE_AGE,
+            OC_PRESENCE_TRIGGER_DELETE, NULL, qos);
+#else
+    return SendAllObserverNotification (OC_REST_OBSERVE, resPtr, MAX_OBSERVE_AGE, qos);
+#endif
+}
+
+void ProcessDeferredNotifications(void)
+{
+    uint64_t now = OICGetCurrentTime(TIME_IN_MS);
+    OCQualityOfService qos = OC_NA_QOS;
+    OCResource *resPtr = NULL;
+
+    while (NULL != (resPtr = TakeDueNotification(now, &qos)))
+    {
+        if (OC_STACK_OK != NotifyAllObserversNow(resPtr, qos))
+        {
+            OIC_LOG_V(DEBUG, TAG, "No observers notified for %s", resPtr->uri);
+        }
+    }
+}
+
+OCStackResult OC_CALL OCSetResourceNotificationPolicy(OCResourceHandle handle,
+                                                      const OCNotificationPolicy *policy)
+{
+    OCResource *resPtr = findResource((OCResource *) handle);
+    if (NULL == resPtr)
+    {
+        OIC_LOG(ERROR, TAG, "Resource not found");
+        return OC_STACK_NO_RESOURCE;
+    }
+
+    if (policy)
+    {
+        return SetNotificationPolicy(resPtr, policy);
+    }
+
+    OCQualityOfService qos = OC_NA_QOS;
+    bool pending = TakePendingNotification(resPtr, &qos);
+    DeleteNotificationPolicy(resPtr);
+    if (pending)
+    {
+        NotifyAllObserversNow(resPtr, qos);
+    }
+    return OC_STACK_OK;
+}
+
 OCStackResult OC_CALL OCNotifyAllObservers(OCResourceHandle handle, OCQualityOfService qos)
 {
     OCResource *resPtr = NULL;
-    OCStackResult result = OC_STACK_ERROR;
-    OCMethod method = OC_REST_NOMETHOD;
-    uint32_t maxAge = 0;
 
     OIC_LOG(INFO, TAG, "Notifying all observers");
 #ifdef WITH_PRESENCE
@@ -5170,37 +5393,66 @@ OCStackResult OC_CALL OCNotifyAllObservers(OCResourceHandle handle, OCQualityOfS
     {
         return OC_STACK_NO_RESOURCE;
     }
-    else
+
+    // Nothing to hold back if nobody observes the resource.
+    if (resPtr->observersHead &&
+        DeferObserverNotification(resPtr, qos, OICGetCurrentTime(TIME_IN_MS)))
     {
-        //only increment in the case of regular observing (not presence)
-        incrementSequenceNumber(resPtr);
-        method = OC_REST_OBSERVE;
-        maxAge = MAX_OBSERVE_AGE;
-#ifdef WITH_PRESENCE
-        result = SendAllObserverNotification (method, resPtr, maxAge,
-                OC_PRESENCE_TRIGGER_DELETE, NULL, qos);
-#else
-        result = SendAllObserverNotification (method, resPtr, maxAge, qos);
-#endif
-        return result;
+        return OC_STACK_OK;
     }
+    return NotifyAllObserversNow(resPtr, qos);
+}
+
+/**
+ * Observation IDs of an array, for OCNotifyListOfObservers.
+ */
+typedef struct
+{
+    const OCObservationId *ids;
+    size_t count;
+} ObservationIdList;
+
+static bool NextListedObservationId(void *context, OCObservationId *observationId)
+{
+    ObservationIdList *list = (ObservationIdList *) context;
+    if (!list->count)
+    {
+        return false;
+    }
+    *observationId = *list->ids++;
+    list->count--;
+    return true;
 }
 
 OCStackResult
 OC_CALL OCNotifyListOfObservers (OCResourceHandle handle,
                                  OCObservationId  *obsIdList,
-                                 uint8_t          numberOfIds,
+                                 size_t           numberOfIds,
                                  const OCRepPayload       *payload,
                                  OCQualityOfService qos)
 {
     OIC_LOG(INFO, TAG, "Entering OCNotifyListOfObservers");
 
+    VERIFY_NON_NULL(obsIdList, ERROR, OC_STACK_ERROR);
+
+    ObservationIdList list = { obsIdList, numberOfIds };
+    return OCNotifyObservers(handle, NextListedObservationId, &list, payload, qos);
+}
+
+OCStackResult OC_CALL OCNotifyObservers(OCResourceHandle handle,
+                                        OCObservationIdIterator nextId,
+                                        void *context,
+                                        const OCRepPayload *payload,
+                                        OCQualityOfService qos)
+{
+    OIC_LOG(INFO, TAG, "Entering OCNotifyObservers");
+
     OCResource *resPtr = NULL;
     //TODO: we should allow the server to define this
     uint32_t maxAge = MAX_OBSERVE_AGE;
 
     VERIFY_NON_NULL(handle, ERROR, OC_STACK_ERROR);
-    VERIFY_NON_NULL(obsIdList, ERROR, OC_STACK_ERROR);
+    VERIFY_NON_NULL(nextId, ERROR, OC_STACK_ERROR);
     VERIFY_NON_NULL(payload, ERROR, OC_STACK_ERROR);
 
     resPtr = findResource ((OCResource *) handle);
@@ -5212,7 +5464,7 @@ OC_CALL OCNotifyListOfObservers (OCResourceHandle handle,
     {
         incrementSequenceNumber(resPtr);
     }
-    return (SendListObserverNotification(resPtr, obsIdList, numberOfIds,
+    return (SendListObserverNotification(resPtr, nextId, context,
             payload, maxAge, qos));
 }
 
@@ -5283,6 +5535,7 @@ OCStackResult OCChangeResourceProperty(OCResourceProperty * inputProperty,
     {
         *inputProperty = (OCResourceProperty) (*inputProperty | resourceProperties);
     }
+    OCDiscoveryCacheInvalidate();
     return OC_STACK_OK;
 }
 #endif
@@ -5433,7 +5686,7 @@ OCStackResult initResources(void)
     return result;
 }
 
-void insertResource(OCResource *resource)
+OCStackResult insertResource(OCResource *resource)
 {
     if (!headResource)
     {
@@ -5446,21 +5699,13 @@ void insertResource(OCResource *resource)
         tailResource = resource;
     }
     resource->next = NULL;
+
+    return OCResourceIndexAdd(resource);
 }
 
 OCResource *findResource(OCResource *resource)
 {
-    OCResource *pointer = headResource;
-
-    while (pointer)
-    {
-        if (pointer == resource)
-        {
-            return resource;
-        }
-        pointer = pointer->next;
-    }
-    return NULL;
+    return OCResourceIndexContains(resource) ? resource : NULL;
 }
 
 void deleteAllResources(void)
@@ -5496,6 +5741,9 @@ void deleteAllResources(void)
     deleteResource((OCResource *) presenceResource.handle);
     memset(&presenceResource, 0, sizeof(presenceResource));
 #endif // WITH_PRESENCE
+
+    OCResourceIndexTerminate();
+    OCDiscoveryCacheTerminate();
 }
 
 OCStackResult deleteResource(OCResource *resource)
@@ -5517,6 +5765,8 @@ OCStackResult deleteResource(OCResource *resource)
         {
             // Invalidate all Resource Properties.
             resource->resourceProperties = (OCResourceProperty) 0;
+            // The deletion is notified right away, drop what the policy holds back.
+            DeleteNotificationPolicy(resource);
 #ifdef WITH_PRESENCE
             if(resource != (OCResource *) presenceResource.handle)
             {
@@ -5553,9 +5803,11 @@ OCStackResult deleteResource(OCResource *resource)
                 prev->next = temp->next;
             }
 
+            OCResourceIndexRemove(temp);
             deleteResourceElements(temp);
             OICFree(temp);
             temp = NULL;
+            OCDiscoveryCacheInvalidate();
             return OC_STACK_OK;
         }
         else
@@ -5601,6 +5853,7 @@ void deleteResourceElements(OCResource *resource)
     }
 
     DeleteObserverList(resource);
+    DeleteNotificationPolicy(resource);
 }
 
 void deleteResourceType(OCResourceType *resourceType)
@@ -6227,18 +6480,12 @@ OCResourceHandle OC_CALL OCGetResourceHandleAtUri(const char *uri)
         return NULL;
     }
 
-    OCResource *pointer = headResource;
-
-    while (pointer)
+    OCResource *pointer = OCResourceIndexFindUri(uri);
+    if (pointer)
     {
-        if (strncmp(uri, pointer->uri, MAX_URI_LENGTH) == 0)
-        {
-            OIC_LOG_V(DEBUG, TAG, "Found Resource %s", uri);
-            return pointer;
-        }
-        pointer = pointer->next;
+        OIC_LOG_V(DEBUG, TAG, "Found Resource %s", uri);
     }
-    return NULL;
+    return pointer;
 }
 
 static OCStackResult SetHeaderOption(CAHeaderOption_t *caHdrOpt, size_t numOptions,
@@ -6353,6 +6600,9 @@ void OCDefaultAdapterStateChangedHandler(CATransportAdapter_t adapter, bool enab
 
     OC_UNUSED(adapter);
     OC_UNUSED(enabled);
+
+    // Discovery responses list the endpoints of the network interfaces.
+    OCDiscoveryCacheInvalidate();
 }
 
 void OCDefaultConnectionStateChangedHandler(const CAEndpoint_t *info, bool isConnected)
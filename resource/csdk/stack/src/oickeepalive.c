@@ -617,6 +617,51 @@ void ProcessKeepAlive()
     }
 }
 
+uint32_t GetNextKeepAliveTimeout(void)
+{
+    if (!g_isKeepAliveInitialized)
+    {
+        return UINT32_MAX;
+    }
+
+    uint64_t nextTimeout = UINT64_MAX;
+    uint64_t currentTime = OICGetCurrentTime(TIME_IN_US);
+    size_t len = u_arraylist_length(g_keepAliveConnectionTable);
+
+    for (size_t i = 0; i < len; i++)
+    {
+        KeepAliveEntry_t *entry = (KeepAliveEntry_t *)u_arraylist_get(g_keepAliveConnectionTable,
+                                                                      i);
+        if (NULL == entry)
+        {
+            continue;
+        }
+
+        // Same deadlines as the ones checked by ProcessKeepAlive.
+        uint64_t timeout = (uint64_t)entry->interval * KEEPALIVE_RESPONSE_TIMEOUT_SEC * USECS_PER_SEC;
+        if (OC_CLIENT == entry->mode && entry->sentPingMsg)
+        {
+            timeout = KEEPALIVE_RESPONSE_TIMEOUT_SEC * USECS_PER_SEC;
+        }
+
+        uint64_t elapsed = currentTime - entry->timeStamp;
+        uint64_t remaining = (elapsed < timeout) ? (timeout - elapsed) : 0;
+        if (remaining < nextTimeout)
+        {
+            nextTimeout = remaining;
+        }
+    }
+
+    if (UINT64_MAX == nextTimeout)
+    {
+        return UINT32_MAX;
+    }
+
+    // Round up so that the deadline has passed when the caller wakes up.
+    nextTimeout = (nextTimeout + US_PER_MS - 1) / US_PER_MS;
+    return (nextTimeout < UINT32_MAX) ? (uint32_t)nextTimeout : UINT32_MAX;
+}
+
 void IncreaseInterval(KeepAliveEntry_t *entry)
 {
     VERIFY_NON_NULL_NR(entry, FATAL);
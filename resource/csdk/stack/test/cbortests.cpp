@@ -27,6 +27,7 @@ extern "C"
     #include "ocpayloadcbor.h"
     #include "experimental/logger.h"
     #include "oic_malloc.h"
+    #include "oic_string.h"
 }
 
 #include <gtest/gtest.h>
@@ -45,7 +46,10 @@ extern "C"
 #include <stdio.h>
 #include <string.h>
 
+#include <chrono>
 #include <iostream>
+#include <string>
+#include <vector>
 #include <stdint.h>
 
 #include "gtest_helper.h"
@@ -432,3 +436,356 @@ TEST(CborEmptyArrayTest, EmptyArrayArraySetGetTest)
     OCRepPayloadDestroy(payload_in);
 }
 
+
+// Adds properties of every type, nested objects and arrays to a representation.
+static void AddRepProperties(OCRepPayload *payload, size_t groups)
+{
+    for (size_t i = 0; i < groups; ++i)
+    {
+        std::string prefix = "p" + std::to_string(i);
+        OCRepPayloadSetPropInt(payload, (prefix + "int").c_str(), (int64_t)i * 1000 - 500);
+        OCRepPayloadSetPropDouble(payload, (prefix + "double").c_str(), i * 0.5);
+        OCRepPayloadSetPropBool(payload, (prefix + "bool").c_str(), i % 2);
+        OCRepPayloadSetPropString(payload, (prefix + "string").c_str(), "a string value");
+        uint8_t bytes[] = { 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7, 0x8 };
+        OCByteString byteString = { bytes, sizeof(bytes) };
+        OCRepPayloadSetPropByteString(payload, (prefix + "bytes").c_str(), byteString);
+
+        OCRepPayload *obj = OCRepPayloadCreate();
+        OCRepPayloadSetPropString(obj, "member", "value");
+        OCRepPayloadSetPropInt(obj, "count", (int64_t)i);
+        OCRepPayloadSetPropObjectAsOwner(payload, (prefix + "obj").c_str(), obj);
+
+        int64_t ints[] = { 1, -24, 255, 65536, INT64_MIN, INT64_MAX };
+        size_t intDim[MAX_REP_ARRAY_DEPTH] = { 2, 3, 0 };
+        OCRepPayloadSetIntArray(payload, (prefix + "ints").c_str(), ints, intDim);
+        double doubles[] = { 0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8 };
+        size_t doubleDim[MAX_REP_ARRAY_DEPTH] = { 2, 2, 2 };
+        OCRepPayloadSetDoubleArray(payload, (prefix + "doubles").c_str(), doubles, doubleDim);
+        const char *strings[] = { "one", "two", "three" };
+        size_t stringDim[MAX_REP_ARRAY_DEPTH] = { 3, 0, 0 };
+        OCRepPayloadSetStringArray(payload, (prefix + "strings").c_str(), strings, stringDim);
+    }
+}
+
+static OCRepPayload *CreateRepPayload(size_t groups)
+{
+    OCRepPayload *payload = OCRepPayloadCreate();
+    OCRepPayloadSetUri(payload, "/a/light");
+    OCRepPayloadAddResourceType(payload, "core.light");
+    OCRepPayloadAddInterface(payload, "oic.if.baseline");
+    AddRepProperties(payload, groups);
+    return payload;
+}
+
+static OCRepPayload *CreateCollectionPayload(size_t children)
+{
+    OCRepPayload *payload = CreateRepPayload(0);
+    payload->repType = PAYLOAD_REP_ARRAY;
+    for (size_t i = 0; i < children; ++i)
+    {
+        OCRepPayload *child = CreateRepPayload(1);
+        OCRepPayloadSetUri(child, ("/a/light/" + std::to_string(i)).c_str());
+        OCRepPayloadAppend(payload, child);
+    }
+    return payload;
+}
+
+static OCDiscoveryPayload *CreateDiscoveryPayload(size_t resources)
+{
+    OCDiscoveryPayload *payload = OCDiscoveryPayloadCreate();
+    payload->sid = OICStrdup("88b7c7f0-4b51-4e0a-9faa-cfb439fd7f49");
+    payload->name = OICStrdup("device");
+    OCResourcePayloadAddStringLL(&payload->type, OC_RSRVD_RESOURCE_TYPE_RES);
+    OCResourcePayloadAddStringLL(&payload->iface, OC_RSRVD_INTERFACE_LL);
+    OCResourcePayloadAddStringLL(&payload->iface, OC_RSRVD_INTERFACE_DEFAULT);
+    for (size_t i = 0; i < resources; ++i)
+    {
+        OCResourcePayload *resource = (OCResourcePayload *)OICCalloc(1, sizeof(OCResourcePayload));
+        resource->uri = OICStrdup(("/a/light/" + std::to_string(i)).c_str());
+        OCResourcePayloadAddStringLL(&resource->types, "core.light");
+        OCResourcePayloadAddStringLL(&resource->interfaces, OC_RSRVD_INTERFACE_DEFAULT);
+        resource->bitmap = OC_DISCOVERABLE | OC_OBSERVABLE;
+        resource->secure = (0 == i % 2);
+        resource->port = 49152;
+
+        const char *addrs[] = { "fe80::1234:5678:9abc:def0%25eth0", "192.168.1.10" };
+        for (size_t j = 0; j < 2; ++j)
+        {
+            OCEndpointPayload *ep = (OCEndpointPayload *)OICCalloc(1, sizeof(OCEndpointPayload));
+            ep->tps = OICStrdup(resource->secure ? "coaps" : "coap");
+            ep->addr = OICStrdup(addrs[j]);
+            ep->family = (OCTransportFlags)((j ? OC_IP_USE_V4 : OC_IP_USE_V6) |
+                                            (resource->secure ? OC_FLAG_SECURE : 0));
+            ep->port = (uint16_t)(49152 + j);
+            ep->pri = 1;
+            OCResourcePayloadAddNewEndpoint(resource, ep);
+        }
+        OCDiscoveryPayloadAddNewResource(payload, resource);
+    }
+    return payload;
+}
+
+static void ExpectSizeBound(OCPayload *payload, OCPayloadFormat format)
+{
+    uint8_t *cbor = NULL;
+    size_t cborSize = 0;
+    ASSERT_EQ(OC_STACK_OK, OCConvertPayload(payload, format, &cbor, &cborSize));
+    size_t bound = OCGetPayloadSizeBound(payload, format);
+    EXPECT_LE(cborSize, bound);
+    // Only a few bytes per item are overestimated.
+    EXPECT_GE(cborSize * 2 + 16, bound);
+    OICFree(cbor);
+}
+
+TEST(CborSizeBoundTest, RepresentationPayload)
+{
+    for (size_t groups = 0; groups <= 64; groups = groups ? groups * 4 : 1)
+    {
+        OCRepPayload *payload = CreateRepPayload(groups);
+        ExpectSizeBound((OCPayload *)payload, OC_FORMAT_CBOR);
+        OCRepPayloadDestroy(payload);
+    }
+}
+
+TEST(CborSizeBoundTest, HeterogeneousArrayPayload)
+{
+    OCRepPayload *arr = OCRepPayloadCreate();
+    EXPECT_TRUE(OCRepPayloadSetPropString(arr, "0", "string"));
+    EXPECT_TRUE(OCRepPayloadSetPropDouble(arr, "1", 1.0));
+    OCRepPayload *payload = OCRepPayloadCreate();
+    EXPECT_TRUE(OCRepPayloadSetPropObjectAsOwner(payload, "property", arr));
+
+    ExpectSizeBound((OCPayload *)payload, OC_FORMAT_CBOR);
+    OCRepPayloadDestroy(payload);
+}
+
+TEST(CborSizeBoundTest, CollectionPayload)
+{
+    for (size_t children = 1; children <= 256; children *= 4)
+    {
+        OCRepPayload *payload = CreateCollectionPayload(children);
+        ExpectSizeBound((OCPayload *)payload, OC_FORMAT_CBOR);
+        OCRepPayloadDestroy(payload);
+    }
+}
+
+TEST(CborSizeBoundTest, DiscoveryPayload)
+{
+    for (size_t resources = 1; resources <= 256; resources *= 4)
+    {
+        OCDiscoveryPayload *payload = CreateDiscoveryPayload(resources);
+        ExpectSizeBound((OCPayload *)payload, OC_FORMAT_CBOR);
+        ExpectSizeBound((OCPayload *)payload, OC_FORMAT_VND_OCF_CBOR);
+        OCDiscoveryPayloadDestroy(payload);
+    }
+}
+
+// Converts discovery, representation and collection payloads from 100 B to 64 KB and
+// reports the cost of one conversion.
+TEST(CborSizeBoundTest, ConvertPayloadRate)
+{
+    using namespace std::chrono;
+    struct Sample
+    {
+        const char *name;
+        OCPayload *payload;
+        OCPayloadFormat format;
+    };
+    std::vector<Sample> samples;
+    for (size_t n = 1; n <= 256; n *= 4)
+    {
+        samples.push_back({ "discovery", (OCPayload *)CreateDiscoveryPayload(n),
+                            OC_FORMAT_VND_OCF_CBOR });
+        samples.push_back({ "representation", (OCPayload *)CreateRepPayload(n - 1),
+                            OC_FORMAT_CBOR });
+        samples.push_back({ "collection", (OCPayload *)CreateCollectionPayload(n),
+                            OC_FORMAT_CBOR });
+    }
+
+    for (const Sample &sample : samples)
+    {
+        uint8_t *cbor = NULL;
+        size_t cborSize = 0;
+        ASSERT_EQ(OC_STACK_OK, OCConvertPayload(sample.payload, sample.format, &cbor, &cborSize));
+        OICFree(cbor);
+
+        const size_t conversions = 2000000 / (cborSize + 1000) + 1;
+        auto start = steady_clock::now();
+        for (size_t i = 0; i < conversions; ++i)
+        {
+            OCConvertPayload(sample.payload, sample.format, &cbor, &cborSize);
+            OICFree(cbor);
+        }
+        double elapsedUs = duration<double, std::micro>(steady_clock::now() - start).count();
+
+        std::cout << sample.name << ": " << cborSize << " bytes"
+                  << ", convert (us): " << elapsedUs / conversions << std::endl;
+        OCPayloadDestroy(sample.payload);
+    }
+}
+
+static std::string PropertyName(size_t i)
+{
+    return "property" + std::to_string(i);
+}
+
+TEST(RepPayloadPropertyIndexTest, ManyPropertiesKeepOrder)
+{
+    const size_t properties = 100;
+    OCRepPayload *payload = OCRepPayloadCreate();
+    ASSERT_TRUE(NULL != payload);
+
+    for (size_t i = 0; i < properties; ++i)
+    {
+        EXPECT_TRUE(OCRepPayloadSetPropInt(payload, PropertyName(i).c_str(), i));
+    }
+    // Replacing a value keeps its position.
+    EXPECT_TRUE(OCRepPayloadSetPropString(payload, PropertyName(3).c_str(), "three"));
+    EXPECT_TRUE(OCRepPayloadSetNull(payload, PropertyName(properties - 1).c_str()));
+
+    size_t i = 0;
+    for (OCRepPayloadValue *value = payload->values; value; value = value->next, ++i)
+    {
+        EXPECT_STREQ(PropertyName(i).c_str(), value->name);
+    }
+    EXPECT_EQ(properties, i);
+
+    char *str = NULL;
+    EXPECT_TRUE(OCRepPayloadGetPropString(payload, PropertyName(3).c_str(), &str));
+    EXPECT_STREQ("three", str);
+    OICFree(str);
+    EXPECT_TRUE(OCRepPayloadIsNull(payload, PropertyName(properties - 1).c_str()));
+    int64_t intValue = 0;
+    EXPECT_FALSE(OCRepPayloadGetPropInt(payload, "missing", &intValue));
+
+    OCRepPayload *clone = OCRepPayloadClone(payload);
+    ASSERT_TRUE(NULL != clone);
+    for (size_t j = 4; j < properties - 1; ++j)
+    {
+        EXPECT_TRUE(OCRepPayloadGetPropInt(clone, PropertyName(j).c_str(), &intValue));
+        EXPECT_EQ((int64_t)j, intValue);
+    }
+
+    uint8_t *cborData = NULL;
+    size_t cborSize = 0;
+    OCPayload *parsed = NULL;
+    ASSERT_EQ(OC_STACK_OK, OCConvertPayload((OCPayload *)clone, OC_FORMAT_CBOR,
+                                            &cborData, &cborSize));
+    ASSERT_EQ(OC_STACK_OK, OCParsePayload(&parsed, OC_FORMAT_CBOR, PAYLOAD_TYPE_REPRESENTATION,
+                                          cborData, cborSize));
+    i = 0;
+    for (OCRepPayloadValue *value = ((OCRepPayload *)parsed)->values; value;
+         value = value->next, ++i)
+    {
+        EXPECT_STREQ(PropertyName(i).c_str(), value->name);
+    }
+    EXPECT_EQ(properties, i);
+
+    OICFree(cborData);
+    OCPayloadDestroy(parsed);
+    OCRepPayloadDestroy(clone);
+    OCRepPayloadDestroy(payload);
+}
+
+// The values list is public, lookups must follow a list replaced or extended by the
+// application.
+TEST(RepPayloadPropertyIndexTest, ValuesChangedOutsideTheApi)
+{
+    const size_t properties = 40;
+    OCRepPayload *payload = OCRepPayloadCreate();
+    OCRepPayload *other = OCRepPayloadCreate();
+    ASSERT_TRUE(NULL != payload);
+    ASSERT_TRUE(NULL != other);
+    for (size_t i = 0; i < properties; ++i)
+    {
+        EXPECT_TRUE(OCRepPayloadSetPropInt(payload, PropertyName(i).c_str(), i));
+        EXPECT_TRUE(OCRepPayloadSetPropInt(other, PropertyName(i).c_str(), i + 1000));
+    }
+
+    // Move the values of other to payload.
+    OCRepPayloadValue *values = payload->values;
+    payload->values = other->values;
+    other->values = NULL;
+
+    int64_t intValue = 0;
+    EXPECT_TRUE(OCRepPayloadGetPropInt(payload, PropertyName(7).c_str(), &intValue));
+    EXPECT_EQ(1007, intValue);
+    EXPECT_TRUE(OCRepPayloadSetPropInt(payload, PropertyName(8).c_str(), 8));
+    EXPECT_TRUE(OCRepPayloadGetPropInt(payload, PropertyName(8).c_str(), &intValue));
+    EXPECT_EQ(8, intValue);
+
+    // Append a value to the end of the list.
+    OCRepPayloadValue *last = payload->values;
+    while (last->next)
+    {
+        last = last->next;
+    }
+    last->next = values;
+    while (values->next)
+    {
+        values = values->next;
+    }
+    values->next = (OCRepPayloadValue *)OICCalloc(1, sizeof(OCRepPayloadValue));
+    ASSERT_TRUE(NULL != values->next);
+    values->next->name = OICStrdup("appended");
+    values->next->type = OCREP_PROP_INT;
+    values->next->i = 42;
+
+    EXPECT_TRUE(OCRepPayloadGetPropInt(payload, "appended", &intValue));
+    EXPECT_EQ(42, intValue);
+    EXPECT_TRUE(OCRepPayloadSetPropInt(payload, "added", 43));
+    EXPECT_TRUE(OCRepPayloadGetPropInt(payload, "added", &intValue));
+    EXPECT_EQ(43, intValue);
+    EXPECT_TRUE(OCRepPayloadGetPropInt(payload, "appended", &intValue));
+    EXPECT_EQ(42, intValue);
+
+    OCRepPayloadDestroy(other);
+    OCRepPayloadDestroy(payload);
+}
+
+// Sets and gets every property of representations of 8 to 512 properties, and reports
+// the cost of one Set and one Get.
+TEST(RepPayloadPropertyIndexTest, SetGetRate)
+{
+    using namespace std::chrono;
+    for (size_t properties = 8; properties <= 512; properties *= 4)
+    {
+        std::vector<std::string> names;
+        for (size_t i = 0; i < properties; ++i)
+        {
+            names.push_back(PropertyName(i));
+        }
+
+        const size_t rounds = 200000 / (properties * properties / 16 + properties) + 1;
+        double setUs = 0;
+        double getUs = 0;
+        for (size_t round = 0; round < rounds; ++round)
+        {
+            OCRepPayload *payload = OCRepPayloadCreate();
+            ASSERT_TRUE(NULL != payload);
+
+            auto start = steady_clock::now();
+            for (size_t i = 0; i < properties; ++i)
+            {
+                OCRepPayloadSetPropInt(payload, names[i].c_str(), i);
+            }
+            auto set = steady_clock::now();
+            int64_t intValue = 0;
+            for (size_t i = 0; i < properties; ++i)
+            {
+                OCRepPayloadGetPropInt(payload, names[i].c_str(), &intValue);
+            }
+            auto get = steady_clock::now();
+            EXPECT_EQ((int64_t)properties - 1, intValue);
+
+            setUs += duration<double, std::micro>(set - start).count();
+            getUs += duration<double, std::micro>(get - set).count();
+            OCRepPayloadDestroy(payload);
+        }
+
+        std::cout << properties << " properties"
+                  << ", set (ns): " << setUs * 1000 / (rounds * properties)
+                  << ", get (ns): " << getUs * 1000 / (rounds * properties) << std::endl;
+    }
+}
@@ -22,6 +22,7 @@
 extern "C"
 {
     #include "ocpayload.h"
+    #include "ocpayloadcbor.h"
     #include "ocstack.h"
     #include "ocstackinternal.h"
     #include "experimental/logger.h"
@@ -29,6 +30,7 @@ extern "C"
     #include "oic_string.h"
     #include "oic_time.h"
     #include "ocresourcehandler.h"
+    #include "ocresourceindex.h"
     #include "occollection.h"
     #include "mbedtls/ssl_ciphersuites.h"
     #include "octypes.h"
@@ -46,6 +48,13 @@ extern "C"
 #include <unistd.h>
 #endif
 #include <stdlib.h>
+#ifdef WITH_POSIX
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#endif
 
 //-----------------------------------------------------------------------------
 // Includes
@@ -53,7 +62,12 @@ extern "C"
 #include <stdio.h>
 #include <string.h>
 
+#include <atomic>
+#include <future>
 #include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
 #include <stdint.h>
 
 #include "gtest_helper.h"
@@ -2326,6 +2340,68 @@ TEST(StackResourceAccess, DeleteMiddleResource)
     EXPECT_EQ(OC_STACK_OK, OCStop());
 }
 
+TEST(StackResourceAccess, IndexedResources)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    OIC_LOG(INFO, TAG, "Starting IndexedResources test");
+    InitStack(OC_SERVER);
+
+    const int numResources = 300;
+    std::vector<OCResourceHandle> handles(numResources);
+    for (int i = 0; i < numResources; i++)
+    {
+        std::string uri = "/a/indexed" + std::to_string(i);
+        EXPECT_EQ(OC_STACK_OK, OCCreateResource(&handles[i],
+                                                (i % 2) ? "core.odd" : "core.even",
+                                                "core.rw",
+                                                uri.c_str(),
+                                                0,
+                                                NULL,
+                                                OC_DISCOVERABLE|OC_OBSERVABLE));
+    }
+    EXPECT_EQ(OC_STACK_OK, OCBindResourceTypeToResource(handles[0], "core.odd"));
+    EXPECT_EQ(OC_STACK_OK, OCBindResourceInterfaceToResource(handles[3], "core.r"));
+    EXPECT_EQ(OC_STACK_OK, OCBindResourceInterfaceToResource(handles[1], "core.r"));
+
+    for (int i = 0; i < numResources; i++)
+    {
+        std::string uri = "/a/indexed" + std::to_string(i);
+        EXPECT_EQ(handles[i], (OCResourceHandle)FindResourceByUri(uri.c_str()));
+        EXPECT_EQ(handles[i], OCGetResourceHandleAtUri(uri.c_str()));
+    }
+    EXPECT_EQ(NULL, FindResourceByUri("/a/indexed"));
+
+    // Resources are listed in the order they were created, whatever the binding order.
+    OCResource * const *resources = NULL;
+    ASSERT_EQ((size_t)numResources / 2 + 1, OCResourceIndexGetByType("core.odd", &resources));
+    EXPECT_EQ(handles[0], (OCResourceHandle)resources[0]);
+    EXPECT_EQ(handles[1], (OCResourceHandle)resources[1]);
+    EXPECT_EQ(handles[numResources - 1], (OCResourceHandle)resources[numResources / 2]);
+    ASSERT_EQ(2u, OCResourceIndexGetByInterface("core.r", &resources));
+    EXPECT_EQ(handles[1], (OCResourceHandle)resources[0]);
+    EXPECT_EQ(handles[3], (OCResourceHandle)resources[1]);
+
+    EXPECT_EQ(OC_STACK_OK, OCDeleteResource(handles[1]));
+    EXPECT_EQ(NULL, FindResourceByUri("/a/indexed1"));
+    EXPECT_EQ((size_t)numResources / 2, OCResourceIndexGetByType("core.odd", &resources));
+    ASSERT_EQ(1u, OCResourceIndexGetByInterface("core.r", &resources));
+    EXPECT_EQ(handles[3], (OCResourceHandle)resources[0]);
+    EXPECT_EQ(OC_STACK_ERROR, OCDeleteResource(handles[1]));
+
+    // The URI of a deleted resource can be used again.
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&handles[1],
+                                            "core.odd",
+                                            "core.rw",
+                                            "/a/indexed1",
+                                            0,
+                                            NULL,
+                                            OC_DISCOVERABLE|OC_OBSERVABLE));
+    EXPECT_EQ(handles[1], (OCResourceHandle)FindResourceByUri("/a/indexed1"));
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+    EXPECT_EQ(0u, OCResourceIndexGetByType("core.odd", &resources));
+}
+
 // Visual Studio versions earlier than 2015 have bugs in is_pod and report the wrong answer.
 #if !defined(_MSC_VER) || (_MSC_VER >= 1900)
 TEST(PODTests, OCHeaderOption)
@@ -3444,3 +3520,804 @@ TEST(SelectCipherSuite,SelectPositiveAdapter)
 
 }
 #endif
+
+static int g_deletedClientCBs = 0;
+
+extern "C" void clientCBDeleter(void* /*ctx*/)
+{
+    g_deletedClientCBs++;
+}
+
+static ClientCB* addTestClientCB(uint32_t id, uint32_t ttl)
+{
+    OCCallbackData cbData;
+    cbData.cb = asyncDoResourcesCallback;
+    cbData.context = (void*)DEFAULT_CONTEXT_VALUE;
+    cbData.cd = clientCBDeleter;
+
+    CAToken_t token = (CAToken_t)OICCalloc(1, CA_MAX_TOKEN_LEN);
+    memcpy(token, &id, sizeof(id));
+    OCDoHandle handle = (OCDoHandle)OICMalloc(1);
+    char *uri = OICStrdup("/a/light");
+
+    ClientCB *cbNode = NULL;
+    EXPECT_EQ(OC_STACK_OK, AddClientCB(&cbNode, &cbData, CA_MSG_CONFIRM,
+                                       token, CA_MAX_TOKEN_LEN, NULL, 0, NULL, 0,
+                                       CA_FORMAT_UNDEFINED, &handle, OC_REST_GET,
+                                       NULL, uri, NULL, ttl));
+    return cbNode;
+}
+
+TEST(ClientCB, LookupByTokenAndHandle)
+{
+    g_deletedClientCBs = 0;
+    std::vector<ClientCB*> nodes;
+    for (uint32_t id = 0; id < 100; id++)
+    {
+        nodes.push_back(addTestClientCB(id, UINT32_MAX));
+        ASSERT_TRUE(NULL != nodes.back());
+    }
+
+    for (ClientCB *node : nodes)
+    {
+        EXPECT_EQ(node, GetClientCBUsingToken(node->token, node->tokenLength));
+        EXPECT_EQ(node, GetClientCBUsingHandle(node->handle));
+    }
+
+    char unknown[CA_MAX_TOKEN_LEN] = { 0x7f };
+    EXPECT_TRUE(NULL == GetClientCBUsingToken(unknown, CA_MAX_TOKEN_LEN));
+
+    DeleteClientCB(nodes[50]);
+    EXPECT_EQ(1, g_deletedClientCBs);
+    EXPECT_EQ(nodes[51], GetClientCBUsingHandle(nodes[51]->handle));
+
+    DeleteClientCBList();
+    EXPECT_EQ(100, g_deletedClientCBs);
+}
+
+TEST(ClientCB, TimedOutCallbacksAreDeleted)
+{
+    g_deletedClientCBs = 0;
+    ClientCB *expired = addTestClientCB(1, 1);
+    ClientCB *active = addTestClientCB(2, UINT32_MAX);
+    ClientCB *observe = addTestClientCB(3, 0);
+    ASSERT_TRUE(NULL != expired && NULL != active && NULL != observe);
+
+    // Any lookup removes the expired callbacks.
+    EXPECT_EQ(active, GetClientCBUsingHandle(active->handle));
+    EXPECT_EQ(1, g_deletedClientCBs);
+
+    SetClientCBTTL(active, 1);
+    SetClientCBTTL(observe, UINT32_MAX);
+    EXPECT_EQ(observe, GetClientCBUsingHandle(observe->handle));
+    EXPECT_EQ(2, g_deletedClientCBs);
+
+    DeleteClientCBList();
+    EXPECT_EQ(3, g_deletedClientCBs);
+}
+
+// Looks up and deletes callbacks while the indexes grow from 10 to 100k callbacks.
+TEST(ClientCB, LookupWhileIndexesGrow)
+{
+    for (uint32_t count : { 10u, 1000u, 100000u })
+    {
+        g_deletedClientCBs = 0;
+        std::vector<ClientCB*> nodes;
+        nodes.reserve(count);
+        for (uint32_t id = 0; id < count; id++)
+        {
+            nodes.push_back(addTestClientCB(id, UINT32_MAX));
+            ASSERT_TRUE(NULL != nodes.back());
+        }
+
+        for (ClientCB *node : nodes)
+        {
+            ASSERT_EQ(node, GetClientCBUsingToken(node->token, node->tokenLength));
+            ASSERT_EQ(node, GetClientCBUsingHandle(node->handle));
+        }
+
+        // A token prefix of a callback token is another token.
+        EXPECT_TRUE(NULL == GetClientCBUsingToken(nodes[0]->token, sizeof(uint32_t)));
+
+        std::vector<CAToken_t> deletedTokens;
+        for (uint32_t id = 0; id < count; id += 2)
+        {
+            CAToken_t token = (CAToken_t)OICMalloc(CA_MAX_TOKEN_LEN);
+            memcpy(token, nodes[id]->token, CA_MAX_TOKEN_LEN);
+            deletedTokens.push_back(token);
+            DeleteClientCB(nodes[id]);
+        }
+        EXPECT_EQ((int)((count + 1) / 2), g_deletedClientCBs);
+
+        for (CAToken_t token : deletedTokens)
+        {
+            EXPECT_TRUE(NULL == GetClientCBUsingToken(token, CA_MAX_TOKEN_LEN));
+            OICFree(token);
+        }
+        for (uint32_t id = 1; id < count; id += 2)
+        {
+            ASSERT_EQ(nodes[id], GetClientCBUsingToken(nodes[id]->token,
+                                                       nodes[id]->tokenLength));
+            ASSERT_EQ(nodes[id], GetClientCBUsingHandle(nodes[id]->handle));
+        }
+
+        DeleteClientCBList();
+        EXPECT_EQ((int)count, g_deletedClientCBs);
+    }
+}
+
+static int g_notifyEntityHandlerCalls = 0;
+static std::vector<OCDevAddr> g_notifyEntityHandlerAddrs;
+
+static OCEntityHandlerResult notifyEntityHandler(OCEntityHandlerFlag /*flag*/,
+                                                 OCEntityHandlerRequest *entityHandlerRequest,
+                                                 void* /*callbackParam*/)
+{
+    g_notifyEntityHandlerCalls++;
+    g_notifyEntityHandlerAddrs.push_back(entityHandlerRequest->devAddr);
+
+    OCRepPayload *payload = OCRepPayloadCreate();
+    OCRepPayloadSetUri(payload, "/a/notify");
+    OCRepPayloadSetPropInt(payload, "power", g_notifyEntityHandlerCalls);
+    OCRepPayloadSetPropString(payload, "name", "notify");
+
+    OCEntityHandlerResponse response;
+    memset(&response, 0, sizeof(response));
+    response.requestHandle = entityHandlerRequest->requestHandle;
+    response.ehResult = OC_EH_OK;
+    response.payload = (OCPayload*)payload;
+    EXPECT_EQ(OC_STACK_OK, OCDoResponse(&response));
+
+    OCRepPayloadDestroy(payload);
+    return OC_EH_OK;
+}
+
+static void addTestObserver(OCResourceHandle handle, OCObservationId id, uint16_t port,
+                            OCTransportFlags flags)
+{
+    OCDevAddr devAddr;
+    memset(&devAddr, 0, sizeof(devAddr));
+    devAddr.adapter = OC_ADAPTER_IP;
+    devAddr.flags = flags;
+    devAddr.port = port;
+    OICStrcpy(devAddr.addr, sizeof(devAddr.addr), "127.0.0.1");
+
+    char token[CA_MAX_TOKEN_LEN] = { 0 };
+    memcpy(token, &id, sizeof(id));
+
+    ASSERT_EQ(OC_STACK_OK, AddObserver("/a/notify", NULL, id, token,
+                                       CA_MAX_TOKEN_LEN, (OCResource*)handle,
+                                       OC_LOW_QOS, OC_FORMAT_CBOR, 0, &devAddr));
+}
+
+static void addTestObservers(OCResourceHandle handle, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        addTestObserver(handle, (OCObservationId)i, (uint16_t)(50000 + i), OC_IP_USE_V4);
+    }
+}
+
+// Observers sharing the same query and accept format are served by a single entity
+// handler call, from 1 to 500 observers.
+TEST(StackNotification, NotifyGroupCallsEntityHandlerOnce)
+{
+    itst::DeadmanTimer killSwitch(LONG_TEST_TIMEOUT);
+    InitStack(OC_SERVER);
+
+    for (size_t count : { 1u, 10u, 100u, 500u })
+    {
+        OCResourceHandle handle = NULL;
+        ASSERT_EQ(OC_STACK_OK, OCCreateResource(&handle, "core.notify", "oic.if.baseline",
+                                                "/a/notify", notifyEntityHandler, NULL,
+                                                OC_DISCOVERABLE | OC_OBSERVABLE));
+        addTestObservers(handle, count);
+
+        g_notifyEntityHandlerCalls = 0;
+        EXPECT_EQ(OC_STACK_OK, OCNotifyAllObservers(handle, OC_LOW_QOS));
+        EXPECT_EQ(OC_STACK_OK, OCNotifyAllObservers(handle, OC_LOW_QOS));
+        EXPECT_EQ(2, g_notifyEntityHandlerCalls);
+
+        EXPECT_EQ(OC_STACK_OK, OCDeleteResource(handle));
+    }
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+#ifdef WITH_POSIX
+// Opens a UDP socket on the loopback interface to receive notifications.
+static int openObserverSocket(uint16_t *port)
+{
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    if (0 != bind(fd, (struct sockaddr *)&addr, sizeof(addr)) ||
+        0 != getsockname(fd, (struct sockaddr *)&addr, &len))
+    {
+        close(fd);
+        return -1;
+    }
+    *port = ntohs(addr.sin_port);
+    return fd;
+}
+
+// Receives the CoAP messages arriving on fd within timeoutMs and returns their tokens.
+static std::vector<std::string> receiveTokens(int fd, int timeoutMs)
+{
+    std::vector<std::string> tokens;
+    struct pollfd pfd = { fd, POLLIN, 0 };
+    while (0 < poll(&pfd, 1, timeoutMs))
+    {
+        uint8_t buf[1500];
+        ssize_t len = recv(fd, buf, sizeof(buf), 0);
+        if (len < 4)
+        {
+            continue;
+        }
+        size_t tokenLength = buf[0] & 0x0F;
+        if ((size_t)len >= 4 + tokenLength)
+        {
+            tokens.push_back(std::string((char *)buf + 4, tokenLength));
+        }
+        // Only wait for the notifications already on their way.
+        timeoutMs = 200;
+    }
+    return tokens;
+}
+
+// Every observer of a group receives one copy of the notification, with its own token.
+TEST(StackNotification, NotifyGroupSendsTokenOfEachObserver)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    InitStack(OC_SERVER);
+
+    OCResourceHandle handle = NULL;
+    ASSERT_EQ(OC_STACK_OK, OCCreateResource(&handle, "core.notify", "oic.if.baseline",
+                                            "/a/notify", notifyEntityHandler, NULL,
+                                            OC_DISCOVERABLE | OC_OBSERVABLE));
+
+    const size_t count = 8;
+    int fds[count];
+    for (size_t i = 0; i < count; i++)
+    {
+        uint16_t port = 0;
+        fds[i] = openObserverSocket(&port);
+        ASSERT_LE(0, fds[i]);
+        addTestObserver(handle, (OCObservationId)i, port, OC_IP_USE_V4);
+    }
+
+    g_notifyEntityHandlerCalls = 0;
+    EXPECT_EQ(OC_STACK_OK, OCNotifyAllObservers(handle, OC_LOW_QOS));
+    EXPECT_EQ(1, g_notifyEntityHandlerCalls);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        char token[CA_MAX_TOKEN_LEN] = { 0 };
+        OCObservationId id = (OCObservationId)i;
+        memcpy(token, &id, sizeof(id));
+
+        std::vector<std::string> tokens = receiveTokens(fds[i], 2000);
+        ASSERT_EQ(1u, tokens.size()) << "observer " << i;
+        EXPECT_EQ(std::string(token, CA_MAX_TOKEN_LEN), tokens[0]) << "observer " << i;
+        close(fds[i]);
+    }
+
+    EXPECT_EQ(OC_STACK_OK, OCDeleteResource(handle));
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+#endif
+
+// The entity handler is called once for the plain and once for the secure observers, with
+// the address of an observer of that security.
+TEST(StackNotification, NotifyGroupsBySecurity)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    InitStack(OC_SERVER);
+
+    OCResourceHandle handle = NULL;
+    ASSERT_EQ(OC_STACK_OK, OCCreateResource(&handle, "core.notify", "oic.if.baseline",
+                                            "/a/notify", notifyEntityHandler, NULL,
+                                            OC_DISCOVERABLE | OC_OBSERVABLE));
+    addTestObserver(handle, 0, 50000, OC_IP_USE_V4);
+    addTestObserver(handle, 1, 50001, (OCTransportFlags)(OC_IP_USE_V4 | OC_FLAG_SECURE));
+    addTestObserver(handle, 2, 50002, OC_IP_USE_V4);
+    addTestObserver(handle, 3, 50003, (OCTransportFlags)(OC_IP_USE_V4 | OC_FLAG_SECURE));
+
+    g_notifyEntityHandlerCalls = 0;
+    g_notifyEntityHandlerAddrs.clear();
+    // Sending to the secure observers may fail without a session, the grouping is tested.
+    OCNotifyAllObservers(handle, OC_LOW_QOS);
+
+    ASSERT_EQ(2, g_notifyEntityHandlerCalls);
+    EXPECT_EQ(0, g_notifyEntityHandlerAddrs[0].flags & OC_FLAG_SECURE);
+    EXPECT_EQ(50000, g_notifyEntityHandlerAddrs[0].port);
+    EXPECT_EQ(OC_FLAG_SECURE, g_notifyEntityHandlerAddrs[1].flags & OC_FLAG_SECURE);
+    EXPECT_EQ(50001, g_notifyEntityHandlerAddrs[1].port);
+
+    EXPECT_EQ(OC_STACK_OK, OCDeleteResource(handle));
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+static bool nextEvenObservationId(void *context, OCObservationId *observationId)
+{
+    size_t *next = (size_t *)context;
+    if (*next > UINT8_MAX)
+    {
+        return false;
+    }
+    *observationId = (OCObservationId)*next;
+    *next += 2;
+    return true;
+}
+
+// The observers to notify may be given as a list of more than 255 IDs, or by an
+// iterator, and are matched in one pass over the observers of the resource.
+TEST(StackNotification, NotifyListOfObservers)
+{
+    itst::DeadmanTimer killSwitch(LONG_TEST_TIMEOUT);
+    InitStack(OC_SERVER);
+
+    OCResourceHandle handle = NULL;
+    ASSERT_EQ(OC_STACK_OK, OCCreateResource(&handle, "core.notify", "oic.if.baseline",
+                                            "/a/notify", notifyEntityHandler, NULL,
+                                            OC_DISCOVERABLE | OC_OBSERVABLE));
+    addTestObservers(handle, UINT8_MAX + 1);
+
+    OCRepPayload *payload = OCRepPayloadCreate();
+    OCRepPayloadSetUri(payload, "/a/notify");
+    OCRepPayloadSetPropInt(payload, "power", 1);
+
+    std::vector<OCObservationId> ids;
+    for (size_t i = 0; i < 2 * (UINT8_MAX + 1); i++)
+    {
+        ids.push_back((OCObservationId)i);
+    }
+
+    g_notifyEntityHandlerCalls = 0;
+    EXPECT_EQ(OC_STACK_OK, OCNotifyListOfObservers(handle, ids.data(), ids.size(), payload,
+                                                   OC_LOW_QOS));
+
+    size_t next = 0;
+    EXPECT_EQ(OC_STACK_OK, OCNotifyObservers(handle, nextEvenObservationId, &next, payload,
+                                             OC_LOW_QOS));
+    EXPECT_EQ(0, g_notifyEntityHandlerCalls);
+
+    EXPECT_EQ(OC_STACK_OK, OCNotifyListOfObservers(handle, ids.data(), 0, payload,
+                                                   OC_LOW_QOS));
+    EXPECT_EQ(OC_STACK_ERROR, OCNotifyObservers(handle, NULL, NULL, payload, OC_LOW_QOS));
+
+    OCRepPayloadDestroy(payload);
+    EXPECT_EQ(OC_STACK_OK, OCDeleteResource(handle));
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+#ifdef WITH_POSIX
+// Each listed observer receives the notification once, however many times its ID is
+// listed. The other observers receive nothing, and IDs without observer are skipped.
+TEST(StackNotification, NotifyListOfObserversSendsOncePerListedObserver)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    InitStack(OC_SERVER);
+
+    OCResourceHandle handle = NULL;
+    ASSERT_EQ(OC_STACK_OK, OCCreateResource(&handle, "core.notify", "oic.if.baseline",
+                                            "/a/notify", notifyEntityHandler, NULL,
+                                            OC_DISCOVERABLE | OC_OBSERVABLE));
+
+    const size_t count = 8;
+    int fds[count];
+    for (size_t i = 0; i < count; i++)
+    {
+        uint16_t port = 0;
+        fds[i] = openObserverSocket(&port);
+        ASSERT_LE(0, fds[i]);
+        addTestObserver(handle, (OCObservationId)i, port, OC_IP_USE_V4);
+    }
+
+    OCRepPayload *payload = OCRepPayloadCreate();
+    OCRepPayloadSetUri(payload, "/a/notify");
+    OCRepPayloadSetPropInt(payload, "power", 1);
+
+    // Observers 1, 3 and 5, each listed many times, and IDs without observer.
+    std::vector<OCObservationId> ids;
+    for (size_t i = 0; i < 2 * (UINT8_MAX + 1); i++)
+    {
+        ids.push_back((OCObservationId)((i % 2) ? 1 + 2 * ((i / 2) % 3) : count + (i / 2) % 200));
+    }
+    const bool listed[count] = { false, true, false, true, false, true, false, false };
+
+    g_notifyEntityHandlerCalls = 0;
+    EXPECT_EQ(OC_STACK_OK, OCNotifyListOfObservers(handle, ids.data(), ids.size(), payload,
+                                                   OC_LOW_QOS));
+    EXPECT_EQ(0, g_notifyEntityHandlerCalls);
+
+    // The iterator lists the even IDs up to 255.
+    size_t next = 0;
+    EXPECT_EQ(OC_STACK_OK, OCNotifyObservers(handle, nextEvenObservationId, &next, payload,
+                                             OC_LOW_QOS));
+    EXPECT_EQ(0, g_notifyEntityHandlerCalls);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        char token[CA_MAX_TOKEN_LEN] = { 0 };
+        OCObservationId id = (OCObservationId)i;
+        memcpy(token, &id, sizeof(id));
+
+        size_t expected = (listed[i] ? 1 : 0) + ((0 == i % 2) ? 1 : 0);
+        std::vector<std::string> tokens = receiveTokens(fds[i], expected ? 2000 : 200);
+        EXPECT_EQ(expected, tokens.size()) << "observer " << i;
+        for (const std::string &received : tokens)
+        {
+            EXPECT_EQ(std::string(token, CA_MAX_TOKEN_LEN), received) << "observer " << i;
+        }
+        close(fds[i]);
+    }
+
+    OCRepPayloadDestroy(payload);
+    EXPECT_EQ(OC_STACK_OK, OCDeleteResource(handle));
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+#endif
+
+// A notification policy merges the notifications of a resource changing faster than its
+// minimum interval, and OCProcess sends the merged notification once it is due.
+TEST(StackNotification, NotificationPolicyMergesNotifications)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    InitStack(OC_SERVER);
+
+    OCResourceHandle handle = NULL;
+    ASSERT_EQ(OC_STACK_OK, OCCreateResource(&handle, "core.notify", "oic.if.baseline",
+                                            "/a/notify", notifyEntityHandler, NULL,
+                                            OC_DISCOVERABLE | OC_OBSERVABLE));
+    OCNotificationPolicy policy = { 50, 0, true };
+    EXPECT_EQ(OC_STACK_NO_RESOURCE, OCSetResourceNotificationPolicy(NULL, &policy));
+    EXPECT_EQ(OC_STACK_OK, OCSetResourceNotificationPolicy(handle, &policy));
+    addTestObservers(handle, 1);
+    oc_event processEvent = oc_event_new();
+    ASSERT_TRUE(NULL != processEvent);
+    OCRegisterProcessEvent(processEvent);
+
+    g_notifyEntityHandlerCalls = 0;
+    for (int i = 0; i < 100; i++)
+    {
+        EXPECT_EQ(OC_STACK_OK, OCNotifyAllObservers(handle, OC_LOW_QOS));
+    }
+    EXPECT_EQ(1, g_notifyEntityHandlerCalls);
+
+    uint32_t nextEventTime = UINT32_MAX;
+    EXPECT_EQ(OC_STACK_OK, OCProcessEvent(&nextEventTime));
+    EXPECT_GE(50u, nextEventTime);
+
+    while (1 == g_notifyEntityHandlerCalls)
+    {
+        oc_event_wait_for(processEvent, nextEventTime);
+        EXPECT_EQ(OC_STACK_OK, OCProcessEvent(&nextEventTime));
+    }
+    EXPECT_EQ(2, g_notifyEntityHandlerCalls);
+
+    EXPECT_EQ(OC_STACK_OK, OCProcess());
+    EXPECT_EQ(2, g_notifyEntityHandlerCalls);
+
+    EXPECT_EQ(OC_STACK_OK, OCSetResourceNotificationPolicy(handle, NULL));
+    EXPECT_EQ(OC_STACK_OK, OCNotifyAllObservers(handle, OC_LOW_QOS));
+    EXPECT_EQ(3, g_notifyEntityHandlerCalls);
+
+    OCRegisterProcessEvent(NULL);
+    oc_event_free(processEvent);
+    EXPECT_EQ(OC_STACK_OK, OCDeleteResource(handle));
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+// The application thread holds back a notification while the process thread waits for
+// the process event with the timeout it got before. Holding it back wakes the process
+// thread, which sends the notification once it is due.
+TEST(StackNotification, NotificationPolicyWakesProcessThread)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    InitStack(OC_SERVER);
+
+    OCResourceHandle handle = NULL;
+    ASSERT_EQ(OC_STACK_OK, OCCreateResource(&handle, "core.notify", "oic.if.baseline",
+                                            "/a/notify", notifyEntityHandler, NULL,
+                                            OC_DISCOVERABLE | OC_OBSERVABLE));
+    OCNotificationPolicy policy = { 50, 0, true };
+    EXPECT_EQ(OC_STACK_OK, OCSetResourceNotificationPolicy(handle, &policy));
+    addTestObservers(handle, 1);
+    oc_event processEvent = oc_event_new();
+    ASSERT_TRUE(NULL != processEvent);
+    OCRegisterProcessEvent(processEvent);
+
+    // Sent at once, the next one is held back.
+    g_notifyEntityHandlerCalls = 0;
+    EXPECT_EQ(OC_STACK_OK, OCNotifyAllObservers(handle, OC_LOW_QOS));
+    EXPECT_EQ(1, g_notifyEntityHandlerCalls);
+
+    std::atomic<bool> stop(false);
+    std::promise<void> waiting;
+    std::promise<void> sent;
+    std::thread processThread([&] {
+        uint32_t nextEventTime = UINT32_MAX;
+        EXPECT_EQ(OC_STACK_OK, OCProcessEvent(&nextEventTime));
+        waiting.set_value();
+        bool notified = false;
+        while (!stop)
+        {
+            oc_event_wait_for(processEvent, nextEventTime);
+            EXPECT_EQ(OC_STACK_OK, OCProcessEvent(&nextEventTime));
+            if (!notified && 2 == g_notifyEntityHandlerCalls)
+            {
+                notified = true;
+                sent.set_value();
+            }
+        }
+    });
+
+    waiting.get_future().wait();
+    EXPECT_EQ(OC_STACK_OK, OCNotifyAllObservers(handle, OC_LOW_QOS));
+    EXPECT_EQ(std::future_status::ready,
+              sent.get_future().wait_for(std::chrono::milliseconds(1000)));
+
+    stop = true;
+    oc_event_signal(processEvent);
+    processThread.join();
+    EXPECT_EQ(2, g_notifyEntityHandlerCalls);
+
+    OCRegisterProcessEvent(NULL);
+    oc_event_free(processEvent);
+    EXPECT_EQ(OC_STACK_OK, OCDeleteResource(handle));
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+static OCEntityHandlerResult requestEntityHandler(OCEntityHandlerFlag /*flag*/,
+                                                  OCEntityHandlerRequest *entityHandlerRequest,
+                                                  void* /*callbackParam*/)
+{
+    OCRepPayload *payload = OCRepPayloadCreate();
+    OCRepPayloadSetUri(payload, "/a/request");
+    OCRepPayloadSetPropInt(payload, "power", 10);
+
+    OCEntityHandlerResponse response;
+    memset(&response, 0, sizeof(response));
+    response.requestHandle = entityHandlerRequest->requestHandle;
+    response.ehResult = OC_EH_OK;
+    response.payload = (OCPayload*)payload;
+    EXPECT_EQ(OC_STACK_OK, OCDoResponse(&response));
+
+    OCRepPayloadDestroy(payload);
+    return OC_EH_OK;
+}
+
+// Hands GET and PUT requests to the stack as the connectivity layer does, and reports
+// the allocations made for one request and the request rate.
+TEST(StackRequest, AllocationsPerRequest)
+{
+    itst::DeadmanTimer killSwitch(LONG_TEST_TIMEOUT);
+    InitStack(OC_SERVER);
+
+    OCResourceHandle handle = NULL;
+    ASSERT_EQ(OC_STACK_OK, OCCreateResource(&handle, "core.request", "oic.if.baseline",
+                                            "/a/request", requestEntityHandler, NULL,
+                                            OC_DISCOVERABLE));
+
+    CAEndpoint_t endpoint;
+    memset(&endpoint, 0, sizeof(endpoint));
+    endpoint.adapter = CA_ADAPTER_IP;
+    endpoint.flags = CA_IPV4;
+    endpoint.port = 50000;
+    OICStrcpy(endpoint.addr, sizeof(endpoint.addr), "127.0.0.1");
+
+    OCRepPayload *repPayload = OCRepPayloadCreate();
+    ASSERT_TRUE(NULL != repPayload);
+    OCRepPayloadSetPropInt(repPayload, "power", 20);
+    OCRepPayloadSetPropString(repPayload, "name", std::string(80, 'n').c_str());
+    uint8_t *putPayload = NULL;
+    size_t putPayloadSize = 0;
+    ASSERT_EQ(OC_STACK_OK, OCConvertPayload((OCPayload*)repPayload, OC_FORMAT_CBOR,
+                                            &putPayload, &putPayloadSize));
+    OCRepPayloadDestroy(repPayload);
+    char uri[] = "/a/request?if=oic.if.baseline";
+
+    const uint32_t requests = 2000;
+    for (CAMethod_t method : { CA_GET, CA_PUT })
+    {
+        OICAllocationCounters_t before;
+        bool counted = OICGetAllocationCounters(&before);
+        auto start = std::chrono::steady_clock::now();
+
+        for (uint32_t i = 0; i < requests; i++)
+        {
+            char token[CA_MAX_TOKEN_LEN] = { 0 };
+            memcpy(token, &i, sizeof(i));
+
+            CARequestInfo_t requestInfo;
+            memset(&requestInfo, 0, sizeof(requestInfo));
+            requestInfo.method = method;
+            requestInfo.info.type = CA_MSG_NONCONFIRM;
+            requestInfo.info.messageId = (uint16_t)i;
+            requestInfo.info.token = token;
+            requestInfo.info.tokenLength = CA_MAX_TOKEN_LEN;
+            requestInfo.info.resourceUri = uri;
+            requestInfo.info.dataType = CA_REQUEST_DATA;
+            if (CA_PUT == method)
+            {
+                requestInfo.info.payload = putPayload;
+                requestInfo.info.payloadSize = putPayloadSize;
+                requestInfo.info.payloadFormat = CA_FORMAT_APPLICATION_CBOR;
+            }
+            OCHandleRequests(&endpoint, &requestInfo);
+        }
+
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        OICAllocationCounters_t after;
+        OICGetAllocationCounters(&after);
+
+        std::cout << (CA_GET == method ? "GET" : "PUT") << ": ";
+        if (counted)
+        {
+            std::cout << "allocations/request: "
+                      << (double)(after.allocations - before.allocations) / requests
+                      << ", frees/request: " << (double)(after.frees - before.frees) / requests
+                      << ", ";
+        }
+        std::cout << "requests/sec: "
+                  << requests / std::chrono::duration<double>(elapsed).count() << std::endl;
+    }
+
+    OICFree(putPayload);
+    EXPECT_EQ(OC_STACK_OK, OCDeleteResource(handle));
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+static oc_refcounter g_sharedPayloadRef = NULL;
+static int32_t g_sharedPayloadCount = 0;
+static int64_t g_sharedPayloadPower = 0;
+
+static OCEntityHandlerResult sharedPayloadEntityHandler(OCEntityHandlerFlag /*flag*/,
+                                                        OCEntityHandlerRequest *entityHandlerRequest,
+                                                        void* /*callbackParam*/)
+{
+    g_sharedPayloadCount = oc_refcounter_get_count(g_sharedPayloadRef);
+    OCRepPayloadGetPropInt((OCRepPayload*)entityHandlerRequest->payload, "power",
+                           &g_sharedPayloadPower);
+    return requestEntityHandler(OC_REQUEST_FLAG, entityHandlerRequest, NULL);
+}
+
+// The server request keeps a reference to a payload received by the connectivity layer
+// instead of copying it.
+TEST(StackRequest, ReceivedPayloadIsShared)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    InitStack(OC_SERVER);
+
+    OCResourceHandle handle = NULL;
+    ASSERT_EQ(OC_STACK_OK, OCCreateResource(&handle, "core.request", "oic.if.baseline",
+                                            "/a/request", sharedPayloadEntityHandler, NULL,
+                                            OC_DISCOVERABLE));
+
+    CAEndpoint_t endpoint;
+    memset(&endpoint, 0, sizeof(endpoint));
+    endpoint.adapter = CA_ADAPTER_IP;
+    endpoint.flags = CA_IPV4;
+    endpoint.port = 50000;
+    OICStrcpy(endpoint.addr, sizeof(endpoint.addr), "127.0.0.1");
+
+    OCRepPayload *repPayload = OCRepPayloadCreate();
+    ASSERT_TRUE(NULL != repPayload);
+    OCRepPayloadSetPropInt(repPayload, "power", 20);
+    uint8_t *putPayload = NULL;
+    size_t putPayloadSize = 0;
+    ASSERT_EQ(OC_STACK_OK, OCConvertPayload((OCPayload*)repPayload, OC_FORMAT_CBOR,
+                                            &putPayload, &putPayloadSize));
+    OCRepPayloadDestroy(repPayload);
+    g_sharedPayloadRef = oc_refcounter_create(putPayload, OICFree);
+    ASSERT_TRUE(NULL != g_sharedPayloadRef);
+
+    char uri[] = "/a/request?if=oic.if.baseline";
+    char token[CA_MAX_TOKEN_LEN] = { 1 };
+    CARequestInfo_t requestInfo;
+    memset(&requestInfo, 0, sizeof(requestInfo));
+    requestInfo.method = CA_PUT;
+    requestInfo.info.type = CA_MSG_NONCONFIRM;
+    requestInfo.info.token = token;
+    requestInfo.info.tokenLength = CA_MAX_TOKEN_LEN;
+    requestInfo.info.resourceUri = uri;
+    requestInfo.info.dataType = CA_REQUEST_DATA;
+    requestInfo.info.payload = putPayload;
+    requestInfo.info.payloadSize = putPayloadSize;
+    requestInfo.info.payloadFormat = CA_FORMAT_APPLICATION_CBOR;
+    requestInfo.info.payloadRef = g_sharedPayloadRef;
+    OCHandleRequests(&endpoint, &requestInfo);
+
+    // held by the request info and by the server request while it was handled
+    EXPECT_EQ(2, g_sharedPayloadCount);
+    EXPECT_EQ(20, g_sharedPayloadPower);
+    EXPECT_EQ(1, oc_refcounter_get_count(g_sharedPayloadRef));
+
+    EXPECT_TRUE(NULL == oc_refcounter_dec(g_sharedPayloadRef));
+    g_sharedPayloadRef = NULL;
+    EXPECT_EQ(OC_STACK_OK, OCDeleteResource(handle));
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+static void sendDiscoveryRequest(const char *query, char tokenValue)
+{
+    CAEndpoint_t endpoint;
+    memset(&endpoint, 0, sizeof(endpoint));
+    endpoint.adapter = CA_ADAPTER_IP;
+    endpoint.flags = CA_IPV4;
+    endpoint.port = 50000;
+    OICStrcpy(endpoint.addr, sizeof(endpoint.addr), "127.0.0.1");
+
+    char uri[MAX_URI_LENGTH];
+    OICStrcpy(uri, sizeof(uri), query);
+    char token[CA_MAX_TOKEN_LEN] = { tokenValue };
+    CARequestInfo_t requestInfo;
+    memset(&requestInfo, 0, sizeof(requestInfo));
+    requestInfo.method = CA_GET;
+    requestInfo.info.type = CA_MSG_NONCONFIRM;
+    requestInfo.info.token = token;
+    requestInfo.info.tokenLength = CA_MAX_TOKEN_LEN;
+    requestInfo.info.resourceUri = uri;
+    requestInfo.info.dataType = CA_REQUEST_DATA;
+    OCHandleRequests(&endpoint, &requestInfo);
+}
+
+// Discovery responses are encoded once and served from the cache until the resources
+// change.
+TEST(StackRequest, DiscoveryResponseIsCached)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    InitStack(OC_SERVER);
+
+    OCResourceHandle handle = NULL;
+    ASSERT_EQ(OC_STACK_OK, OCCreateResource(&handle, "core.cached", "oic.if.baseline",
+                                            "/a/cached", entityHandler, NULL,
+                                            OC_DISCOVERABLE));
+
+    OCDiscoveryCacheStats start;
+    ASSERT_EQ(OC_STACK_OK, OCGetDiscoveryCacheStats(&start));
+    EXPECT_EQ(OC_STACK_INVALID_PARAM, OCGetDiscoveryCacheStats(NULL));
+
+    sendDiscoveryRequest("/oic/res?rt=core.cached", 1);
+    OCDiscoveryCacheStats stats;
+    ASSERT_EQ(OC_STACK_OK, OCGetDiscoveryCacheStats(&stats));
+    EXPECT_EQ(start.hits, stats.hits);
+    EXPECT_EQ(start.misses + 1, stats.misses);
+    EXPECT_EQ(1u, stats.entries);
+
+    sendDiscoveryRequest("/oic/res?rt=core.cached", 2);
+    ASSERT_EQ(OC_STACK_OK, OCGetDiscoveryCacheStats(&stats));
+    EXPECT_EQ(start.hits + 1, stats.hits);
+    EXPECT_EQ(start.misses + 1, stats.misses);
+
+    // Another filter is another response.
+    sendDiscoveryRequest("/oic/res", 3);
+    ASSERT_EQ(OC_STACK_OK, OCGetDiscoveryCacheStats(&stats));
+    EXPECT_EQ(start.misses + 2, stats.misses);
+    EXPECT_EQ(2u, stats.entries);
+
+    // A binding changes the responses.
+    EXPECT_EQ(OC_STACK_OK, OCBindResourceInterfaceToResource(handle, "oic.if.r"));
+    ASSERT_EQ(OC_STACK_OK, OCGetDiscoveryCacheStats(&stats));
+    EXPECT_LT(start.invalidations, stats.invalidations);
+    sendDiscoveryRequest("/oic/res?rt=core.cached", 4);
+    ASSERT_EQ(OC_STACK_OK, OCGetDiscoveryCacheStats(&stats));
+    EXPECT_EQ(start.hits + 1, stats.hits);
+    EXPECT_EQ(start.misses + 3, stats.misses);
+    EXPECT_EQ(1u, stats.entries);
+
+    EXPECT_EQ(OC_STACK_OK, OCDeleteResource(handle));
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+
+    ASSERT_EQ(OC_STACK_OK, OCGetDiscoveryCacheStats(&stats));
+    EXPECT_EQ(0u, stats.entries);
+}
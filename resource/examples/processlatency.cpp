@@ -0,0 +1,244 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+///
+/// This sample measures the GET round trip latency between a client and a
+/// server hosted in the same process, either with the stack processing thread
+/// polling OCProcess() or waiting on the stack process event.
+///
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "OCPlatform.h"
+#include "OCApi.h"
+
+using namespace OC;
+using namespace std::chrono;
+
+static const char LATENCY_RESOURCE_URI[] = "/latency";
+static const char LATENCY_RESOURCE_TYPE[] = "core.latency";
+
+static void printUsage()
+{
+    std::cout << "    Usage processlatency <0|1> [requests]" << std::endl;
+    std::cout << "    ProcessMode : 0 - Polling, 1 - EventDriven (default)" << std::endl;
+    std::cout << "    requests    : number of GET requests to time (default 1000)" << std::endl;
+}
+
+class LatencyResource
+{
+public:
+    bool createResource()
+    {
+        std::string resourceURI = LATENCY_RESOURCE_URI;
+        EntityHandler eh(std::bind(&LatencyResource::entityHandler, this,
+                                   std::placeholders::_1));
+        OCStackResult result = OCPlatform::registerResource(m_resourceHandle,
+                                                            resourceURI,
+                                                            LATENCY_RESOURCE_TYPE,
+                                                            DEFAULT_INTERFACE,
+                                                            eh, OC_DISCOVERABLE);
+        return (OC_STACK_OK == result);
+    }
+
+private:
+    OCEntityHandlerResult entityHandler(std::shared_ptr<OCResourceRequest> request)
+    {
+        if (!request || request->getRequestType() != "GET")
+        {
+            return OC_EH_ERROR;
+        }
+
+        OCRepresentation rep;
+        rep.setUri(LATENCY_RESOURCE_URI);
+        rep.setValue("count", ++m_count);
+
+        auto pResponse = std::make_shared<OC::OCResourceResponse>();
+        pResponse->setRequestHandle(request->getRequestHandle());
+        pResponse->setResourceHandle(request->getResourceHandle());
+        pResponse->setResourceRepresentation(rep, "");
+        pResponse->setResponseResult(OC_EH_OK);
+
+        return (OC_STACK_OK == OCPlatform::sendResponse(pResponse)) ? OC_EH_OK : OC_EH_ERROR;
+    }
+
+    OCResourceHandle m_resourceHandle = nullptr;
+    int m_count = 0;
+};
+
+class LatencyClient
+{
+public:
+    bool discover()
+    {
+        std::ostringstream requestURI;
+        requestURI << OC_RSRVD_WELL_KNOWN_URI << "?rt=" << LATENCY_RESOURCE_TYPE;
+
+        FindCallback f(std::bind(&LatencyClient::foundResource, this, std::placeholders::_1));
+        if (OC_STACK_OK != OCPlatform::findResource("", requestURI.str(), CT_DEFAULT, f))
+        {
+            return false;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_cv.wait_for(lock, seconds(10), [this] { return nullptr != m_resource; });
+    }
+
+    bool measure(size_t requests, std::vector<double>& latenciesUs)
+    {
+        GetCallback cb(std::bind(&LatencyClient::onGet, this, std::placeholders::_1,
+                                 std::placeholders::_2, std::placeholders::_3));
+
+        for (size_t i = 0; i < requests; i++)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_responded = false;
+            auto start = steady_clock::now();
+            if (OC_STACK_OK != m_resource->get(QueryParamsMap(), cb))
+            {
+                return false;
+            }
+            if (!m_cv.wait_for(lock, seconds(10), [this] { return m_responded; }))
+            {
+                std::cout << "Timed out waiting for response " << i << std::endl;
+                return false;
+            }
+            auto elapsed = steady_clock::now() - start;
+            latenciesUs.push_back(duration<double, std::micro>(elapsed).count());
+        }
+        return true;
+    }
+
+private:
+    void foundResource(std::shared_ptr<OCResource> resource)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_resource && resource && resource->uri() == LATENCY_RESOURCE_URI)
+        {
+            m_resource = resource;
+            m_cv.notify_all();
+        }
+    }
+
+    void onGet(const HeaderOptions& /*headerOptions*/, const OCRepresentation& /*rep*/,
+               const int /*eCode*/)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_responded = true;
+        m_cv.notify_all();
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::shared_ptr<OCResource> m_resource;
+    bool m_responded = false;
+};
+
+static double percentile(const std::vector<double>& sorted, double p)
+{
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1));
+    return sorted[index];
+}
+
+int main(int argc, char* argv[])
+{
+    ProcessMode processMode = ProcessMode::EventDriven;
+    size_t requests = 1000;
+
+    try
+    {
+        if (argc >= 2)
+        {
+            processMode = (0 == std::stoi(argv[1])) ? ProcessMode::Polling
+                                                    : ProcessMode::EventDriven;
+        }
+        if (argc >= 3)
+        {
+            requests = std::stoul(argv[2]);
+        }
+    }
+    catch (std::exception&)
+    {
+        printUsage();
+        return -1;
+    }
+
+    if (argc < 2 || 0 == requests)
+    {
+        printUsage();
+    }
+
+    PlatformConfig cfg {
+        OC::ServiceType::InProc,
+        OC::ModeType::Both,
+        nullptr
+    };
+    cfg.processMode = processMode;
+
+    OCPlatform::Configure(cfg);
+
+    try
+    {
+        OC_VERIFY(OCPlatform::start() == OC_STACK_OK);
+
+        LatencyResource resource;
+        LatencyClient client;
+        std::vector<double> latenciesUs;
+
+        if (!resource.createResource() || !client.discover() ||
+            !client.measure(requests, latenciesUs) || latenciesUs.empty())
+        {
+            std::cout << "Latency measurement failed" << std::endl;
+            OC_VERIFY(OCPlatform::stop() == OC_STACK_OK);
+            return -1;
+        }
+
+        std::sort(latenciesUs.begin(), latenciesUs.end());
+        double total = 0;
+        for (double latency : latenciesUs)
+        {
+            total += latency;
+        }
+
+        std::cout << "Process mode : "
+                  << ((ProcessMode::Polling == processMode) ? "Polling" : "EventDriven")
+                  << std::endl;
+        std::cout << "Requests     : " << latenciesUs.size() << std::endl;
+        std::cout << "Mean (us)    : " << total / latenciesUs.size() << std::endl;
+        std::cout << "p50 (us)     : " << percentile(latenciesUs, 0.50) << std::endl;
+        std::cout << "p99 (us)     : " << percentile(latenciesUs, 0.99) << std::endl;
+        std::cout << "Max (us)     : " << latenciesUs.back() << std::endl;
+
+        OC_VERIFY(OCPlatform::stop() == OC_STACK_OK);
+    }
+    catch (OCException& e)
+    {
+        std::cout << "Exception in main: " << e.what() << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+/**
+ * @file
+ *
+ * This file contains the declaration of the fixed size thread pool used to run
+ * client callbacks of the in-process client wrapper.
+ */
+
+#ifndef OC_CALLBACK_EXECUTOR_H_
+#define OC_CALLBACK_EXECUTOR_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace OC
+{
+    /**
+     * Runs tasks on a fixed number of worker threads.
+     *
+     * Tasks are started in the order they were posted. When serial queues are enabled,
+     * tasks posted with the same non empty key run one at a time, e.g. the notifications
+     * of one observed resource; a key waiting for its running task does not hold back
+     * the tasks posted after it. The number of queued tasks is bounded.
+     */
+    class CallbackExecutor
+    {
+    public:
+        typedef std::function<void()> Task;
+
+        /** Default bound of the number of queued tasks. */
+        static const size_t DEFAULT_MAX_PENDING_TASKS = 4096;
+
+        /**
+         * @param threadCount       Number of worker threads, at least one is started.
+         * @param serialQueues      Run tasks sharing a key in posting order.
+         * @param maxPendingTasks   Number of tasks which may be queued and not yet started.
+         */
+        CallbackExecutor(unsigned int threadCount, bool serialQueues,
+                         size_t maxPendingTasks = DEFAULT_MAX_PENDING_TASKS);
+
+        /**
+         * Runs the tasks still queued and joins the worker threads.
+         */
+        ~CallbackExecutor();
+
+        CallbackExecutor(const CallbackExecutor&) = delete;
+        CallbackExecutor& operator=(const CallbackExecutor&) = delete;
+
+        /**
+         * Queue a task.
+         *
+         * @param key       Serial queue of the task, empty if it may run in any order.
+         * @param task      Task to run on a worker thread.
+         *
+         * @return false if maxPendingTasks tasks are queued already. The task is not
+         *         queued and left untouched, so that the caller can still run it.
+         */
+        bool post(const std::string& key, Task&& task);
+
+        /**
+         * @return Number of tasks queued and not yet started.
+         */
+        size_t pendingTasks() const;
+
+        /**
+         * Run a client callback on an executor, or on a new detached thread when there
+         * is none. When the queue of the executor is full, the callback runs on the
+         * calling thread instead of being dropped.
+         *
+         * @param executor  Executor of the client, may be expired.
+         * @param key       Serial queue of the task, empty if it may run in any order.
+         * @param task      Task to run.
+         */
+        static void dispatch(const std::weak_ptr<CallbackExecutor>& executor,
+                             const std::string& key, Task task);
+
+    private:
+        struct State;
+        static void workerFunc(std::shared_ptr<State> state);
+
+        // Shared with the workers, so that a worker releasing the last reference to
+        // the executor from within a callback can still finish safely.
+        std::shared_ptr<State> m_state;
+        std::vector<std::thread> m_workers;
+    };
+}
+
+#endif // OC_CALLBACK_EXECUTOR_H_
@@ -26,7 +26,9 @@
 #include <sstream>
 #include <iostream>
 
+#include <ocevent.h>
 #include <OCApi.h>
+#include <CallbackExecutor.h>
 #include <IClientWrapper.h>
 #include <InitializeException.h>
 #include <ResourceInitException.h>
@@ -38,12 +40,14 @@ namespace OC
         struct GetContext
         {
             GetCallback callback;
+            std::weak_ptr<CallbackExecutor> executor;
             GetContext(GetCallback cb) : callback(cb){}
         };
 
         struct SetContext
         {
             PutCallback callback;
+            std::weak_ptr<CallbackExecutor> executor;
             SetContext(PutCallback cb) : callback(cb){}
         };
 
@@ -51,6 +55,7 @@ namespace OC
         {
             FindCallback callback;
             std::weak_ptr<IClientWrapper> clientWrapper;
+            std::weak_ptr<CallbackExecutor> executor;
 
             ListenContext(FindCallback cb, std::weak_ptr<IClientWrapper> cw)
                 : callback(cb), clientWrapper(cw){}
@@ -61,6 +66,7 @@ namespace OC
             FindCallback callback;
             FindErrorCallback errorCallback;
             std::weak_ptr<IClientWrapper> clientWrapper;
+            std::weak_ptr<CallbackExecutor> executor;
 
             ListenErrorContext(FindCallback cb1, FindErrorCallback cb2,
                                std::weak_ptr<IClientWrapper> cw)
@@ -71,6 +77,7 @@ namespace OC
         {
             FindResListCallback callback;
             std::weak_ptr<IClientWrapper> clientWrapper;
+            std::weak_ptr<CallbackExecutor> executor;
 
             ListenResListContext(FindResListCallback cb, std::weak_ptr<IClientWrapper> cw)
                 : callback(cb), clientWrapper(cw){}
@@ -81,6 +88,7 @@ namespace OC
             FindResListCallback callback;
             FindErrorCallback errorCallback;
             std::weak_ptr<IClientWrapper> clientWrapper;
+            std::weak_ptr<CallbackExecutor> executor;
 
             ListenResListWithErrorContext(FindResListCallback cb1, FindErrorCallback cb2,
                                std::weak_ptr<IClientWrapper> cw)
@@ -91,6 +99,7 @@ namespace OC
         {
             FindDeviceCallback callback;
             IClientWrapper::Ptr clientWrapper;
+            std::weak_ptr<CallbackExecutor> executor;
             DeviceListenContext(FindDeviceCallback cb, IClientWrapper::Ptr cw)
                     : callback(cb), clientWrapper(cw){}
         };
@@ -98,18 +107,21 @@ namespace OC
         struct SubscribePresenceContext
         {
             SubscribeCallback callback;
+            std::weak_ptr<CallbackExecutor> executor;
             SubscribePresenceContext(SubscribeCallback cb) : callback(cb){}
         };
 
         struct DeleteContext
         {
             DeleteCallback callback;
+            std::weak_ptr<CallbackExecutor> executor;
             DeleteContext(DeleteCallback cb) : callback(cb){}
         };
 
         struct ObserveContext
         {
             ObserveCallback callback;
+            std::weak_ptr<CallbackExecutor> executor;
             ObserveContext(ObserveCallback cb) : callback(cb){}
         };
 
@@ -118,6 +130,7 @@ namespace OC
         {
             MQTopicCallback callback;
             std::weak_ptr<IClientWrapper> clientWrapper;
+            std::weak_ptr<CallbackExecutor> executor;
             MQTopicContext(MQTopicCallback cb, std::weak_ptr<IClientWrapper> cw)
                 : callback(cb), clientWrapper(cw){}
         };
@@ -240,10 +253,12 @@ namespace OC
            const HeaderOptions& headerOptions);
         std::thread m_listeningThread;
         bool m_threadRun;
+        oc_event m_processEvent;
         std::weak_ptr<std::recursive_mutex> m_csdkLock;
 
     private:
         PlatformConfig  m_cfg;
+        std::shared_ptr<CallbackExecutor> m_callbackExecutor;
     };
 }
 
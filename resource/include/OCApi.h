@@ -131,6 +131,18 @@ namespace OC
         NaQos       = OC_NA_QOS
     };
 
+    /**
+     * Selects how the stack processing thread of the in-process wrappers waits for work.
+     */
+    enum class ProcessMode
+    {
+        /** Call OCProcess() every 10 milliseconds. */
+        Polling,
+
+        /** Sleep until the stack signals queued messages or its next timer is due. */
+        EventDriven
+    };
+
     /**
      *  Data structure to provide the configuration.
      */
@@ -175,6 +187,22 @@ namespace OC
          */
         bool                       useLegacyCleanup;
 
+        /** indicate how the stack processing thread waits for work, EventDriven by default. */
+        ProcessMode                processMode;
+
+        /**
+         * number of threads the client callbacks run on. 0 (default) starts a new
+         * thread for every callback.
+         */
+        unsigned int               callbackThreadCount;
+
+        /**
+         * when callbackThreadCount is not 0, run the callbacks of one resource one at a
+         * time in the order the responses were received, e.g. to keep observe
+         * notifications in sequence.
+         */
+        bool                       serializeResourceCallbacks;
+
         public:
             PlatformConfig(const ServiceType serviceType_,
             const ModeType mode_,
@@ -188,7 +216,10 @@ namespace OC
                 port(0),
                 QoS(QualityOfService::NaQos),
                 ps(ps_),
-                useLegacyCleanup(false)
+                useLegacyCleanup(false),
+                processMode(ProcessMode::EventDriven),
+                callbackThreadCount(0),
+                serializeResourceCallbacks(false)
         {}
             /// @deprecated this constructor is deprecated (since 2014.10).
             OC_DEPRECATED_MSG(
@@ -204,7 +235,10 @@ namespace OC
                 port(0),
                 QoS(QualityOfService::NaQos),
                 ps(nullptr),
-                useLegacyCleanup(true)
+                useLegacyCleanup(true),
+                processMode(ProcessMode::EventDriven),
+                callbackThreadCount(0),
+                serializeResourceCallbacks(false)
         {}
             /// @deprecated this constructor is deprecated (since 2017.03).
             OC_DEPRECATED_MSG(
@@ -225,7 +259,10 @@ namespace OC
                 port(0),
                 QoS(QoS_),
                 ps(ps_),
-                useLegacyCleanup(true)
+                useLegacyCleanup(true),
+                processMode(ProcessMode::EventDriven),
+                callbackThreadCount(0),
+                serializeResourceCallbacks(false)
         {}
             /// @deprecated this constructor is deprecated (since 2017.03).
             OC_DEPRECATED_MSG(
@@ -246,7 +283,10 @@ namespace OC
                 port(port_),
                 QoS(QoS_),
                 ps(ps_),
-                useLegacyCleanup(true)
+                useLegacyCleanup(true),
+                processMode(ProcessMode::EventDriven),
+                callbackThreadCount(0),
+                serializeResourceCallbacks(false)
         {}
             /// @deprecated this constructor is deprecated (since 2017.03).
             OC_DEPRECATED_MSG(
@@ -267,7 +307,10 @@ namespace OC
                 ipAddress(ipAddress_),
                 port(port_),
                 QoS(QoS_),
-                ps(ps_)
+                ps(ps_),
+                processMode(ProcessMode::EventDriven),
+                callbackThreadCount(0),
+                serializeResourceCallbacks(false)
         {}
             PlatformConfig(const ServiceType serviceType_,
                            const ModeType mode_,
@@ -283,7 +326,10 @@ namespace OC
                 port(0),
                 QoS(QoS_),
                 ps(ps_),
-                useLegacyCleanup(false)
+                useLegacyCleanup(false),
+                processMode(ProcessMode::EventDriven),
+                callbackThreadCount(0),
+                serializeResourceCallbacks(false)
         {}
             /// @deprecated this constructor is deprecated (since 2017.03).
             OC_DEPRECATED_MSG(
@@ -305,7 +351,10 @@ namespace OC
                 port(0),
                 QoS(QoS_),
                 ps(ps_),
-                useLegacyCleanup(true)
+                useLegacyCleanup(true),
+                processMode(ProcessMode::EventDriven),
+                callbackThreadCount(0),
+                serializeResourceCallbacks(false)
         {}
 
     };
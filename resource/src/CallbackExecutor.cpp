@@ -0,0 +1,222 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include "CallbackExecutor.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <unordered_map>
+#include "experimental/logger.h"
+
+#define TAG "OIC_CALLBACK_EXECUTOR"
+
+namespace OC
+{
+    struct CallbackExecutor::State
+    {
+        State(bool serial, size_t maxPending)
+            : serialQueues(serial), maxPendingTasks(maxPending), stopping(false),
+              pendingTasks(0)
+        {}
+
+        // Entry of the ready queue: an unordered task, or the key of a serial queue.
+        struct Ready
+        {
+            std::string key;
+            Task task;
+        };
+
+        const bool serialQueues;
+        const size_t maxPendingTasks;
+        bool stopping;
+        size_t pendingTasks;
+        std::mutex mutex;
+        std::condition_variable cv;
+
+        // Tasks and serial queues in the order they became ready to run. A key is listed
+        // while its queue is not empty and none of its tasks is running.
+        std::deque<Ready> ready;
+        std::unordered_map<std::string, std::deque<Task>> serialTasks;
+    };
+
+    CallbackExecutor::CallbackExecutor(unsigned int threadCount, bool serialQueues,
+                                       size_t maxPendingTasks)
+        : m_state(std::make_shared<State>(serialQueues, maxPendingTasks))
+    {
+        if (0 == threadCount)
+        {
+            threadCount = 1;
+        }
+
+        m_workers.reserve(threadCount);
+        for (unsigned int i = 0; i < threadCount; i++)
+        {
+            m_workers.push_back(std::thread(&CallbackExecutor::workerFunc, m_state));
+        }
+    }
+
+    CallbackExecutor::~CallbackExecutor()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_state->mutex);
+            m_state->stopping = true;
+        }
+        m_state->cv.notify_all();
+
+        for (auto& worker : m_workers)
+        {
+            if (worker.get_id() == std::this_thread::get_id())
+            {
+                // The last reference was released by one of our own callbacks.
+                worker.detach();
+            }
+            else if (worker.joinable())
+            {
+                worker.join();
+            }
+        }
+    }
+
+    bool CallbackExecutor::post(const std::string& key, Task&& task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_state->mutex);
+            if (m_state->pendingTasks >= m_state->maxPendingTasks)
+            {
+                OIC_LOG_V(WARNING, TAG, "%zu callbacks queued, callback not queued",
+                          m_state->pendingTasks);
+                return false;
+            }
+
+            if (!m_state->serialQueues || key.empty())
+            {
+                m_state->ready.push_back(State::Ready{std::string(), std::move(task)});
+            }
+            else
+            {
+                auto it = m_state->serialTasks.find(key);
+                if (it == m_state->serialTasks.end())
+                {
+                    m_state->serialTasks[key].push_back(std::move(task));
+                    m_state->ready.push_back(State::Ready{key, Task()});
+                }
+                else
+                {
+                    // Either listed in ready already, or requeued when the running
+                    // task of this key completes.
+                    it->second.push_back(std::move(task));
+                }
+            }
+            m_state->pendingTasks++;
+        }
+        m_state->cv.notify_one();
+        return true;
+    }
+
+    size_t CallbackExecutor::pendingTasks() const
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        return m_state->pendingTasks;
+    }
+
+    void CallbackExecutor::dispatch(const std::weak_ptr<CallbackExecutor>& executor,
+                                    const std::string& key, Task task)
+    {
+        auto callbackExecutor = executor.lock();
+        if (callbackExecutor)
+        {
+            if (!callbackExecutor->post(key, std::move(task)))
+            {
+                // Slows down the stack thread until the workers catch up, instead of
+                // losing a response or notification.
+                OIC_LOG(WARNING, TAG, "Callback queue full, running callback inline");
+                try
+                {
+                    task();
+                }
+                catch (std::exception& e)
+                {
+                    OIC_LOG_V(ERROR, TAG, "Exception in client callback: %s", e.what());
+                }
+            }
+        }
+        else
+        {
+            std::thread exec(std::move(task));
+            exec.detach();
+        }
+    }
+
+    void CallbackExecutor::workerFunc(std::shared_ptr<State> state)
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        while (true)
+        {
+            state->cv.wait(lock, [&state] {
+                return state->stopping || !state->ready.empty();
+            });
+
+            if (state->ready.empty())
+            {
+                // Stopping and every queued task has been started.
+                break;
+            }
+
+            std::string key = std::move(state->ready.front().key);
+            Task task = std::move(state->ready.front().task);
+            state->ready.pop_front();
+            if (!key.empty())
+            {
+                auto& queue = state->serialTasks[key];
+                task = std::move(queue.front());
+                queue.pop_front();
+            }
+            state->pendingTasks--;
+
+            lock.unlock();
+            try
+            {
+                task();
+            }
+            catch (std::exception& e)
+            {
+                OIC_LOG_V(ERROR, TAG, "Exception in client callback: %s", e.what());
+            }
+            task = nullptr;
+            lock.lock();
+
+            if (!key.empty())
+            {
+                auto it = state->serialTasks.find(key);
+                if (it->second.empty())
+                {
+                    state->serialTasks.erase(it);
+                }
+                else
+                {
+                    state->ready.push_back(State::Ready{key, Task()});
+                    state->cv.notify_one();
+                }
+            }
+        }
+    }
+}
@@ -37,9 +37,15 @@ namespace OC
 {
     InProcClientWrapper::InProcClientWrapper(
         std::weak_ptr<std::recursive_mutex> csdkLock, PlatformConfig cfg)
-            : m_threadRun(false), m_csdkLock(csdkLock),
+            : m_threadRun(false), m_processEvent(nullptr), m_csdkLock(csdkLock),
               m_cfg { cfg }
     {
+        if (0 < m_cfg.callbackThreadCount)
+        {
+            m_callbackExecutor = std::make_shared<CallbackExecutor>(
+                m_cfg.callbackThreadCount, m_cfg.serializeResourceCallbacks);
+        }
+
         // if the config type is server, we ought to never get called.  If the config type
         // is both, we count on the server to run the thread and do the initialize
         start();
@@ -61,10 +67,26 @@ namespace OC
     {
         OIC_LOG(INFO, TAG, "start");
 
+        // In Both and Gateway mode the server wrapper runs the only OCProcess thread and
+        // owns the registered process event, which serves the client side as well.
         if (m_cfg.mode == ModeType::Client)
         {
             if (false == m_threadRun)
             {
+                if (ProcessMode::EventDriven == m_cfg.processMode)
+                {
+                    m_processEvent = oc_event_new();
+                    if (!m_processEvent)
+                    {
+                        OIC_LOG(ERROR, TAG,
+                                "Failed to create process event, falling back to polling");
+                    }
+                    else
+                    {
+                        OCRegisterProcessEvent(m_processEvent);
+                    }
+                }
+
                 m_threadRun = true;
                 m_listeningThread = std::thread(&InProcClientWrapper::listeningFunc, this);
             }
@@ -79,8 +101,19 @@ namespace OC
         if (m_threadRun && m_listeningThread.joinable())
         {
             m_threadRun = false;
+            if (m_processEvent)
+            {
+                oc_event_signal(m_processEvent);
+            }
             m_listeningThread.join();
         }
+
+        if (m_processEvent)
+        {
+            OCRegisterProcessEvent(nullptr);
+            oc_event_free(m_processEvent);
+            m_processEvent = nullptr;
+        }
         return OC_STACK_OK;
     }
 
@@ -89,11 +122,12 @@ namespace OC
         while(m_threadRun)
         {
             OCStackResult result;
+            uint32_t nextEventTime = 0;
             auto cLock = m_csdkLock.lock();
             if (cLock)
             {
                 std::lock_guard<std::recursive_mutex> lock(*cLock);
-                result = OCProcess();
+                result = m_processEvent ? OCProcessEvent(&nextEventTime) : OCProcess();
             }
             else
             {
@@ -105,11 +139,33 @@ namespace OC
                 // TODO: do something with result if failed?
             }
 
-            // To minimize CPU utilization we may wish to do this with sleep
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            if (m_processEvent && OC_STACK_OK == result)
+            {
+                // Sleep until a message is queued or the next stack timer is due.
+                oc_event_wait_for(m_processEvent, nextEventTime);
+            }
+            else
+            {
+                // To minimize CPU utilization we may wish to do this with sleep
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
         }
     }
 
+    /**
+     * Key of the callback executor serial queue for the resource a response comes from.
+     */
+    static std::string resourceKey(const OCClientResponse* clientResponse)
+    {
+        std::ostringstream key;
+        key << clientResponse->devAddr.addr << ':' << clientResponse->devAddr.port;
+        if (clientResponse->resourceUri)
+        {
+            key << clientResponse->resourceUri;
+        }
+        return key.str();
+    }
+
     OCRepresentation parseGetSetCallback(OCClientResponse* clientResponse)
     {
         if (clientResponse->payload == nullptr ||
@@ -215,8 +271,8 @@ namespace OC
 
             for(auto resource : container.Resources())
             {
-                std::thread exec(context->callback, resource);
-                exec.detach();
+                CallbackExecutor::dispatch(context->executor, std::string(),
+                                           std::bind(context->callback, resource));
             }
         }
         catch (std::exception &e)
@@ -267,16 +323,16 @@ namespace OC
             // loop to ensure valid construction of all resources
             for (auto resource : container.Resources())
             {
-                std::thread exec(context->callback, resource);
-                exec.detach();
+                CallbackExecutor::dispatch(context->executor, std::string(),
+                                           std::bind(context->callback, resource));
             }
             return OC_STACK_KEEP_TRANSACTION;
         }
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
         std::string resourceURI = clientResponse->resourceUri;
-        std::thread exec(context->errorCallback, resourceURI, result);
-        exec.detach();
+        CallbackExecutor::dispatch(context->executor, std::string(),
+                                   std::bind(context->errorCallback, resourceURI, result));
         return OC_STACK_KEEP_TRANSACTION;
     }
 
@@ -297,6 +353,7 @@ namespace OC
 
         ClientCallbackContext::ListenContext* context =
             new ClientCallbackContext::ListenContext(callback, shared_from_this());
+        context->executor = m_callbackExecutor;
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(context),
         cbdata.cb      = listenCallback;
@@ -343,6 +400,7 @@ namespace OC
         {
             return OC_STACK_ERROR;
         }
+        context->executor = m_callbackExecutor;
 
         OCCallbackData cbdata(
                 static_cast<void*>(context),
@@ -415,8 +473,8 @@ namespace OC
                     reinterpret_cast< OCDiscoveryPayload* >(clientResponse->payload));
 
             OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-            std::thread exec(context->callback, container.Resources());
-            exec.detach();
+            CallbackExecutor::dispatch(context->executor, std::string(),
+                                       std::bind(context->callback, container.Resources()));
         }
         catch (std::exception &e)
         {
@@ -444,6 +502,7 @@ namespace OC
 
         ClientCallbackContext::ListenResListContext* context =
             new ClientCallbackContext::ListenResListContext(callback, shared_from_this());
+        context->executor = m_callbackExecutor;
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(context),
         cbdata.cb      = listenResListCallback;
@@ -487,8 +546,8 @@ namespace OC
 
             //send the error callback
             std::string uri = clientResponse->resourceUri;
-            std::thread exec(context->errorCallback, uri, result);
-            exec.detach();
+            CallbackExecutor::dispatch(context->executor, std::string(),
+                                       std::bind(context->errorCallback, uri, result));
             return OC_STACK_KEEP_TRANSACTION;
         }
 
@@ -517,8 +576,8 @@ namespace OC
                     reinterpret_cast< OCDiscoveryPayload* >(clientResponse->payload));
 
             OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-            std::thread exec(context->callback, container.Resources());
-            exec.detach();
+            CallbackExecutor::dispatch(context->executor, std::string(),
+                                       std::bind(context->callback, container.Resources()));
         }
         catch (std::exception &e)
         {
@@ -552,6 +611,7 @@ namespace OC
         {
             return OC_STACK_ERROR;
         }
+        context->executor = m_callbackExecutor;
 
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(context),
@@ -596,9 +656,9 @@ namespace OC
                     << clientResponse->result
                     << std::flush;
 
-            std::thread exec(context->callback, clientResponse->result,
-                             resourceURI, nullptr);
-            exec.detach();
+            CallbackExecutor::dispatch(context->executor, std::string(),
+                                       std::bind(context->callback, clientResponse->result,
+                                                 resourceURI, nullptr));
 
             return OC_STACK_DELETE_TRANSACTION;
         }
@@ -619,9 +679,9 @@ namespace OC
             // loop to ensure valid construction of all resources
             for (auto resource : container.Resources())
             {
-                std::thread exec(context->callback, clientResponse->result,
-                                 resourceURI, resource);
-                exec.detach();
+                CallbackExecutor::dispatch(context->executor, std::string(),
+                                           std::bind(context->callback, clientResponse->result,
+                                                     resourceURI, resource));
             }
         }
         catch (std::exception &e)
@@ -649,6 +709,7 @@ namespace OC
 
         ClientCallbackContext::MQTopicContext* context =
             new ClientCallbackContext::MQTopicContext(callback, shared_from_this());
+        context->executor = m_callbackExecutor;
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(context),
         cbdata.cb      = listenMQCallback;
@@ -692,8 +753,8 @@ namespace OC
         {
             OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
             OCRepresentation rep = parseGetSetCallback(clientResponse);
-            std::thread exec(context->callback, rep);
-            exec.detach();
+            CallbackExecutor::dispatch(context->executor, std::string(),
+                                       std::bind(context->callback, rep));
         }
         catch(OC::OCException& e)
         {
@@ -721,6 +782,7 @@ namespace OC
 
         ClientCallbackContext::DeviceListenContext* context =
             new ClientCallbackContext::DeviceListenContext(callback, shared_from_this());
+        context->executor = m_callbackExecutor;
         OCCallbackData cbdata;
 
         cbdata.context = static_cast<void*>(context),
@@ -804,19 +866,15 @@ namespace OC
                                             createdUri);
                 for (auto resource : container.Resources())
                 {
-                    std::thread exec(context->callback, result,
-                                     createdUri,
-                                     resource);
-                    exec.detach();
+                    CallbackExecutor::dispatch(context->executor, std::string(),
+                        std::bind(context->callback, result, createdUri, resource));
                 }
             }
             else
             {
                 OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-                std::thread exec(context->callback, result,
-                                 createdUri,
-                                 nullptr);
-                exec.detach();
+                CallbackExecutor::dispatch(context->executor, std::string(),
+                    std::bind(context->callback, result, createdUri, nullptr));
             }
         }
         catch (std::exception &e)
@@ -841,6 +899,7 @@ namespace OC
         OCStackResult result;
         ClientCallbackContext::MQTopicContext* ctx =
                 new ClientCallbackContext::MQTopicContext(callback, shared_from_this());
+        ctx->executor = m_callbackExecutor;
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = createMQTopicCallback;
@@ -894,8 +953,8 @@ namespace OC
         }
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-        std::thread exec(context->callback, serverHeaderOptions, rep, result);
-        exec.detach();
+        CallbackExecutor::dispatch(context->executor, resourceKey(clientResponse),
+                                   std::bind(context->callback, serverHeaderOptions, rep, result));
         return OC_STACK_DELETE_TRANSACTION;
     }
 
@@ -914,6 +973,7 @@ namespace OC
         OCStackResult result;
         ClientCallbackContext::GetContext* ctx =
             new ClientCallbackContext::GetContext(callback);
+        ctx->executor = m_callbackExecutor;
 
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx);
@@ -970,8 +1030,8 @@ namespace OC
         }
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-        std::thread exec(context->callback, serverHeaderOptions, attrs, result);
-        exec.detach();
+        CallbackExecutor::dispatch(context->executor, resourceKey(clientResponse),
+            std::bind(context->callback, serverHeaderOptions, attrs, result));
         return OC_STACK_DELETE_TRANSACTION;
     }
 
@@ -1081,6 +1141,7 @@ namespace OC
 
         OCStackResult result;
         ClientCallbackContext::SetContext* ctx = new ClientCallbackContext::SetContext(callback);
+        ctx->executor = m_callbackExecutor;
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = setResourceCallback;
@@ -1128,6 +1189,7 @@ namespace OC
 
         OCStackResult result;
         ClientCallbackContext::SetContext* ctx = new ClientCallbackContext::SetContext(callback);
+        ctx->executor = m_callbackExecutor;
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = setResourceCallback;
@@ -1173,8 +1235,9 @@ namespace OC
         parseServerHeaderOptions(clientResponse, serverHeaderOptions);
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-        std::thread exec(context->callback, serverHeaderOptions, clientResponse->result);
-        exec.detach();
+        CallbackExecutor::dispatch(context->executor, resourceKey(clientResponse),
+                                   std::bind(context->callback, serverHeaderOptions,
+                                             clientResponse->result));
         return OC_STACK_DELETE_TRANSACTION;
     }
 
@@ -1194,6 +1257,7 @@ namespace OC
         OCStackResult result;
         ClientCallbackContext::DeleteContext* ctx =
             new ClientCallbackContext::DeleteContext(callback);
+        ctx->executor = m_callbackExecutor;
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = deleteResourceCallback;
@@ -1248,9 +1312,9 @@ namespace OC
         }
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-        std::thread exec(context->callback, serverHeaderOptions, attrs,
-                    result, sequenceNumber);
-        exec.detach();
+        CallbackExecutor::dispatch(context->executor, resourceKey(clientResponse),
+                                   std::bind(context->callback, serverHeaderOptions, attrs,
+                                             result, sequenceNumber));
         if (sequenceNumber == MAX_SEQUENCE_NUMBER + 1)
         {
             return OC_STACK_DELETE_TRANSACTION;
@@ -1274,6 +1338,7 @@ namespace OC
 
         ClientCallbackContext::ObserveContext* ctx =
             new ClientCallbackContext::ObserveContext(callback);
+        ctx->executor = m_callbackExecutor;
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = observeResourceCallback;
@@ -1366,10 +1431,9 @@ namespace OC
         std::string url = clientResponse->devAddr.addr;
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-        std::thread exec(context->callback, clientResponse->result,
-                    clientResponse->sequenceNumber, url);
-
-        exec.detach();
+        CallbackExecutor::dispatch(context->executor, resourceKey(clientResponse),
+                                   std::bind(context->callback, clientResponse->result,
+                                             clientResponse->sequenceNumber, url));
 
         return OC_STACK_KEEP_TRANSACTION;
     }
@@ -1385,6 +1449,7 @@ namespace OC
 
         ClientCallbackContext::SubscribePresenceContext* ctx =
             new ClientCallbackContext::SubscribePresenceContext(presenceHandler);
+        ctx->executor = m_callbackExecutor;
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = subscribePresenceCallback;
@@ -1446,6 +1511,7 @@ namespace OC
 
         ClientCallbackContext::ObserveContext* ctx =
             new ClientCallbackContext::ObserveContext(callback);
+        ctx->executor = m_callbackExecutor;
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = observeResourceCallback;
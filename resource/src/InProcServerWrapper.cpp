@@ -260,7 +260,7 @@ namespace OC
 {
     InProcServerWrapper::InProcServerWrapper(
         std::weak_ptr<std::recursive_mutex> csdkLock, PlatformConfig cfg)
-     : m_threadRun(false), m_csdkLock(csdkLock),
+     : m_threadRun(false), m_processEvent(nullptr), m_csdkLock(csdkLock),
        m_cfg { cfg }
     {
     }
@@ -271,6 +271,19 @@ namespace OC
 
         if (false == m_threadRun)
         {
+            if (ProcessMode::EventDriven == m_cfg.processMode)
+            {
+                m_processEvent = oc_event_new();
+                if (!m_processEvent)
+                {
+                    OIC_LOG(ERROR, TAG, "Failed to create process event, falling back to polling");
+                }
+                else
+                {
+                    OCRegisterProcessEvent(m_processEvent);
+                }
+            }
+
             m_threadRun = true;
             m_processThread = std::thread(&InProcServerWrapper::processFunc, this);
         }
@@ -284,9 +297,20 @@ namespace OC
         if(m_processThread.joinable())
         {
             m_threadRun = false;
+            if (m_processEvent)
+            {
+                oc_event_signal(m_processEvent);
+            }
             m_processThread.join();
         }
 
+        if (m_processEvent)
+        {
+            OCRegisterProcessEvent(nullptr);
+            oc_event_free(m_processEvent);
+            m_processEvent = nullptr;
+        }
+
         return OC_STACK_OK;
     }
 
@@ -296,10 +320,11 @@ namespace OC
         while(cLock && m_threadRun)
         {
             OCStackResult result;
+            uint32_t nextEventTime = 0;
 
             {
                 std::lock_guard<std::recursive_mutex> lock(*cLock);
-                result = OCProcess();
+                result = m_processEvent ? OCProcessEvent(&nextEventTime) : OCProcess();
             }
 
             if(OC_STACK_ERROR == result)
@@ -308,7 +333,15 @@ namespace OC
                 // ...the value of variable result is simply ignored for now.
             }
 
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            if (m_processEvent && OC_STACK_OK == result)
+            {
+                // Sleep until a message is queued or the next stack timer is due.
+                oc_event_wait_for(m_processEvent, nextEventTime);
+            }
+            else
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
         }
     }
 
@@ -295,7 +295,7 @@ namespace OC
                                        const std::shared_ptr<OCResourceResponse> pResponse,
                                        QualityOfService QoS)
     {
-        if(!pResponse || (observationIds.size() > UINT8_MAX))
+        if(!pResponse)
         {
          return result_guard(OC_STACK_ERROR);
         }
@@ -303,7 +303,7 @@ namespace OC
         OCRepPayload* pl = pResponse->getResourceRepresentation().getPayload();
         OCStackResult result =
                    OCNotifyListOfObservers(resourceHandle,
-                            &observationIds[0], (uint8_t)observationIds.size(),
+                            observationIds.data(), observationIds.size(),
                             pl,
                             static_cast<OCQualityOfService>(QoS));
         OCRepPayloadDestroy(pl);
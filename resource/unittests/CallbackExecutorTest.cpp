@@ -0,0 +1,320 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <gtest/gtest.h>
+#include <CallbackExecutor.h>
+
+namespace OC
+{
+    namespace test
+    {
+        namespace CallbackExecutorTests
+        {
+            using namespace OC;
+            using namespace std::chrono;
+
+            TEST(CallbackExecutorTest, RunsAllTasksBeforeDestruction)
+            {
+                std::atomic<int> count(0);
+                {
+                    CallbackExecutor executor(4, false);
+                    for (int i = 0; i < 1000; i++)
+                    {
+                        executor.post(std::string(), [&count] { count++; });
+                    }
+                }
+                EXPECT_EQ(1000, count);
+            }
+
+            TEST(CallbackExecutorTest, ZeroThreadsStillRunsTasks)
+            {
+                std::atomic<int> count(0);
+                {
+                    CallbackExecutor executor(0, true);
+                    executor.post("/a", [&count] { count++; });
+                    executor.post(std::string(), [&count] { count++; });
+                }
+                EXPECT_EQ(2, count);
+            }
+
+            TEST(CallbackExecutorTest, UsesBoundedNumberOfThreads)
+            {
+                std::mutex mutex;
+                std::set<std::thread::id> threads;
+                {
+                    CallbackExecutor executor(3, false);
+                    for (int i = 0; i < 500; i++)
+                    {
+                        executor.post(std::string(), [&mutex, &threads] {
+                            std::lock_guard<std::mutex> lock(mutex);
+                            threads.insert(std::this_thread::get_id());
+                        });
+                    }
+                }
+                EXPECT_GE(3u, threads.size());
+            }
+
+            TEST(CallbackExecutorTest, SerialQueuesKeepOrderPerKey)
+            {
+                const int keys = 8;
+                const int tasksPerKey = 500;
+                std::mutex mutex;
+                std::vector<std::vector<int>> seen(keys);
+                std::atomic<int> running[keys];
+                std::atomic<bool> overlapped(false);
+                for (int k = 0; k < keys; k++)
+                {
+                    running[k] = 0;
+                }
+
+                {
+                    CallbackExecutor executor(4, true);
+                    for (int i = 0; i < tasksPerKey; i++)
+                    {
+                        for (int k = 0; k < keys; k++)
+                        {
+                            executor.post("/resource/" + std::to_string(k),
+                                [&, k, i] {
+                                    if (1 != ++running[k])
+                                    {
+                                        overlapped = true;
+                                    }
+                                    {
+                                        std::lock_guard<std::mutex> lock(mutex);
+                                        seen[k].push_back(i);
+                                    }
+                                    running[k]--;
+                                });
+                        }
+                    }
+                }
+
+                EXPECT_FALSE(overlapped);
+                for (int k = 0; k < keys; k++)
+                {
+                    ASSERT_EQ(static_cast<size_t>(tasksPerKey), seen[k].size());
+                    EXPECT_TRUE(std::is_sorted(seen[k].begin(), seen[k].end()));
+                }
+            }
+
+            TEST(CallbackExecutorTest, ExceptionInTaskDoesNotStopWorker)
+            {
+                std::atomic<int> count(0);
+                {
+                    CallbackExecutor executor(1, false);
+                    executor.post(std::string(), [] { throw std::runtime_error("test"); });
+                    executor.post(std::string(), [&count] { count++; });
+                }
+                EXPECT_EQ(1, count);
+            }
+
+            // Blocks the workers of an executor until released.
+            class Gate
+            {
+            public:
+                Gate() : m_open(false) {}
+
+                void wait()
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_cv.wait(lock, [this] { return m_open; });
+                }
+
+                void open()
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        m_open = true;
+                    }
+                    m_cv.notify_all();
+                }
+
+            private:
+                std::mutex m_mutex;
+                std::condition_variable m_cv;
+                bool m_open;
+            };
+
+            TEST(CallbackExecutorTest, KeyedTasksDoNotStarveUnkeyedTasks)
+            {
+                Gate gate;
+                std::vector<std::string> order;
+                {
+                    CallbackExecutor executor(1, true);
+                    executor.post(std::string(), [&gate] { gate.wait(); });
+                    for (int i = 0; i < 50; i++)
+                    {
+                        std::string key = "/keyed/" + std::to_string(i);
+                        executor.post(key, [&order, key] { order.push_back(key); });
+                    }
+                    executor.post(std::string(), [&order] { order.push_back("unkeyed"); });
+                    for (int i = 50; i < 100; i++)
+                    {
+                        std::string key = "/keyed/" + std::to_string(i);
+                        executor.post(key, [&order, key] { order.push_back(key); });
+                    }
+                    gate.open();
+                }
+
+                ASSERT_EQ(101u, order.size());
+                EXPECT_EQ("unkeyed", order[50]);
+                EXPECT_EQ("/keyed/49", order[49]);
+                EXPECT_EQ("/keyed/50", order[51]);
+            }
+
+            TEST(CallbackExecutorTest, PostFailsWhenQueueIsFull)
+            {
+                Gate gate;
+                std::atomic<int> count(0);
+                {
+                    CallbackExecutor executor(1, true, 4);
+                    std::atomic<bool> started(false);
+                    executor.post(std::string(), [&gate, &started] {
+                        started = true;
+                        gate.wait();
+                    });
+                    while (!started)
+                    {
+                        std::this_thread::yield();
+                    }
+
+                    EXPECT_TRUE(executor.post("/a", [&count] { count++; }));
+                    EXPECT_TRUE(executor.post("/a", [&count] { count++; }));
+                    EXPECT_TRUE(executor.post("/b", [&count] { count++; }));
+                    EXPECT_TRUE(executor.post(std::string(), [&count] { count++; }));
+                    EXPECT_EQ(4u, executor.pendingTasks());
+                    EXPECT_FALSE(executor.post("/a", [&count] { count++; }));
+                    EXPECT_FALSE(executor.post(std::string(), [&count] { count++; }));
+                    gate.open();
+                }
+                EXPECT_EQ(4, count);
+            }
+
+            TEST(CallbackExecutorTest, DispatchRunsInlineWhenQueueIsFull)
+            {
+                Gate gate;
+                std::atomic<int> count(0);
+                std::atomic<int> inlineCount(0);
+                std::thread::id caller = std::this_thread::get_id();
+                {
+                    auto executor = std::make_shared<CallbackExecutor>(1, true, 4);
+                    std::weak_ptr<CallbackExecutor> weak = executor;
+                    std::atomic<bool> started(false);
+                    executor->post(std::string(), [&gate, &started] {
+                        started = true;
+                        gate.wait();
+                    });
+                    while (!started)
+                    {
+                        std::this_thread::yield();
+                    }
+
+                    for (int i = 0; i < 10; i++)
+                    {
+                        CallbackExecutor::dispatch(weak, "/a", [&count, &inlineCount, caller] {
+                            if (std::this_thread::get_id() == caller)
+                            {
+                                inlineCount++;
+                            }
+                            count++;
+                        });
+                    }
+                    EXPECT_EQ(4u, executor->pendingTasks());
+                    EXPECT_EQ(6, inlineCount);
+                    gate.open();
+                }
+                EXPECT_EQ(10, count);
+            }
+
+            TEST(CallbackExecutorTest, DifferentKeysRunConcurrently)
+            {
+                Gate gate;
+                std::atomic<int> running(0);
+                std::atomic<int> maxRunning(0);
+                std::atomic<int> done(0);
+                {
+                    CallbackExecutor executor(4, true);
+                    for (int k = 0; k < 4; k++)
+                    {
+                        executor.post("/resource/" + std::to_string(k), [&] {
+                            int now = ++running;
+                            int seen = maxRunning;
+                            while (now > seen && !maxRunning.compare_exchange_weak(seen, now))
+                            {
+                            }
+                            if (4 == now)
+                            {
+                                gate.open();
+                            }
+                            gate.wait();
+                            running--;
+                            done++;
+                        });
+                    }
+                }
+                EXPECT_EQ(4, done);
+                EXPECT_EQ(4, maxRunning);
+            }
+
+            TEST(CallbackExecutorTest, DispatchKeepsOrderOfResource)
+            {
+                std::vector<int> seen;
+                {
+                    auto executor = std::make_shared<CallbackExecutor>(4, true);
+                    std::weak_ptr<CallbackExecutor> weak = executor;
+                    for (int i = 0; i < 1000; i++)
+                    {
+                        CallbackExecutor::dispatch(weak, "10.0.0.1:5683/a/light",
+                                                   [&seen, i] { seen.push_back(i); });
+                    }
+                }
+
+                ASSERT_EQ(1000u, seen.size());
+                EXPECT_TRUE(std::is_sorted(seen.begin(), seen.end()));
+            }
+
+            TEST(CallbackExecutorTest, DispatchWithoutExecutorRunsOnNewThread)
+            {
+                std::weak_ptr<CallbackExecutor> expired;
+                std::mutex mutex;
+                std::condition_variable cv;
+                bool ran = false;
+                std::thread::id callbackThread;
+
+                CallbackExecutor::dispatch(expired, std::string(), [&] {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    callbackThread = std::this_thread::get_id();
+                    ran = true;
+                    cv.notify_one();
+                });
+
+                std::unique_lock<std::mutex> lock(mutex);
+                ASSERT_TRUE(cv.wait_for(lock, seconds(5), [&ran] { return ran; }));
+                EXPECT_NE(std::this_thread::get_id(), callbackThread);
+            }
+        }
+    }
+}
@@ -23,6 +23,7 @@
 #include <oic_malloc.h>
 #include <iotivity_debug.h>
 #include <gtest/gtest.h>
+#include <chrono>
 
 namespace OCPlatformTest
 {
@@ -242,6 +243,23 @@ namespace OCPlatformTest
         ASSERT_TRUE(OC_STACK_OK == framework.start());
     }
 
+    TEST(ConfigureTest, ConfigureBothStartStop)
+    {
+        // Client and server share the process thread and its event in Both mode, so
+        // restarting must neither leave a freed event registered nor block in stop.
+        for (int i = 0; i < 3; ++i)
+        {
+            std::chrono::steady_clock::time_point stopStart;
+            {
+                Framework framework(OC::ServiceType::InProc, OC::ModeType::Both, &gps);
+                ASSERT_TRUE(OC_STACK_OK == framework.start());
+                EXPECT_NO_THROW(OCPlatform::setDefaultDeviceEntityHandler(nullptr));
+                stopStart = std::chrono::steady_clock::now();
+            }
+            EXPECT_GT(std::chrono::seconds(1), std::chrono::steady_clock::now() - stopStart);
+        }
+    }
+
     //PersistentStorageTest
     TEST(ConfigureTest, ConfigureNULLPersistentStorage)
     {
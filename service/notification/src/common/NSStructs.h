@@ -56,15 +56,38 @@ typedef struct _NSCacheElement
 {
     NSCacheData * data;                 /**< cache data */
     struct _NSCacheElement * next;      /**< pointer to next element */
+    struct _NSCacheElement * prev;      /**< pointer to previous element, set by the cache */
 
 } NSCacheElement;
 
+/** ns cache index entry structure */
+typedef struct _NSCacheIndexEntry
+{
+    uint32_t hash;                      /**< hash of the key */
+    NSCacheElement * element;           /**< element with the key */
+    struct _NSCacheIndexEntry * next;   /**< pointer to next entry of the bucket */
+
+} NSCacheIndexEntry;
+
+/** ns cache index, the elements of a cache list hashed by one key */
+typedef struct
+{
+    NSCacheIndexEntry ** buckets;  /**< buckets, allocated on first use */
+    size_t size;                   /**< number of buckets, a power of 2 */
+    size_t count;                  /**< number of entries */
+
+} NSCacheIndex;
+
+/** number of keys by which the elements of a cache list are indexed */
+#define NS_CACHE_INDEX_KEYS 2
+
 /** ns cache list */
 typedef struct
 {
     NSCacheType cacheType;         /**< cache type */
     NSCacheElement * head;         /**< head node of list */
     NSCacheElement * tail;         /**< tail node of list */
+    NSCacheIndex index[NS_CACHE_INDEX_KEYS]; /**< elements by key, depending on cache type */
 
 } NSCacheList;
 
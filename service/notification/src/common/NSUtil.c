@@ -618,3 +618,190 @@ bool NSOCResultToSuccess(OCStackResult ret)
     }
 }
 
+
+uint32_t NSCacheHashString(const char * key)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (; *key; key++)
+    {
+        hash = (hash ^ (uint8_t) *key) * 16777619u;
+    }
+    return hash;
+}
+
+uint32_t NSCacheHashAddress(const char * addr, uint16_t port)
+{
+    uint32_t hash = NSCacheHashString(addr);
+    hash = (hash ^ (uint8_t) (port & 0xFF)) * 16777619u;
+    hash = (hash ^ (uint8_t) (port >> 8)) * 16777619u;
+    return hash;
+}
+
+static void NSCacheIndexResize(NSCacheIndex * index, size_t size)
+{
+    NSCacheIndexEntry ** buckets =
+            (NSCacheIndexEntry **) OICCalloc(size, sizeof(NSCacheIndexEntry *));
+    if (!buckets)
+    {
+        // Keep the current buckets; lookups get slower but stay correct.
+        return;
+    }
+
+    for (size_t i = 0; i < index->size; i++)
+    {
+        NSCacheIndexEntry * entry = index->buckets[i];
+        while (entry)
+        {
+            NSCacheIndexEntry * next = entry->next;
+            NSCacheIndexEntry ** bucket = &buckets[entry->hash & (size - 1)];
+            entry->next = *bucket;
+            *bucket = entry;
+            entry = next;
+        }
+    }
+
+    NSOICFree(index->buckets);
+    index->buckets = buckets;
+    index->size = size;
+}
+
+NSResult NSCacheIndexAdd(NSCacheIndex * index, uint32_t hash, NSCacheElement * element)
+{
+    NS_VERIFY_NOT_NULL(index, NS_ERROR);
+    NS_VERIFY_NOT_NULL(element, NS_ERROR);
+
+    if (index->count >= index->size)
+    {
+        NSCacheIndexResize(index, index->size ? index->size * 2 : 16);
+        NS_VERIFY_NOT_NULL(index->buckets, NS_ERROR);
+    }
+
+    NSCacheIndexEntry * entry = (NSCacheIndexEntry *) OICMalloc(sizeof(NSCacheIndexEntry));
+    NS_VERIFY_NOT_NULL(entry, NS_ERROR);
+
+    NSCacheIndexEntry ** bucket = &index->buckets[hash & (index->size - 1)];
+    entry->hash = hash;
+    entry->element = element;
+    entry->next = *bucket;
+    *bucket = entry;
+    index->count++;
+
+    return NS_OK;
+}
+
+void NSCacheIndexRemove(NSCacheIndex * index, uint32_t hash, const NSCacheElement * element)
+{
+    if (!index || !index->buckets)
+    {
+        return;
+    }
+
+    NSCacheIndexEntry ** prev = &index->buckets[hash & (index->size - 1)];
+    while (*prev)
+    {
+        NSCacheIndexEntry * entry = *prev;
+        if (entry->hash == hash && entry->element == element)
+        {
+            *prev = entry->next;
+            NSOICFree(entry);
+            index->count--;
+            return;
+        }
+        prev = &entry->next;
+    }
+}
+
+NSCacheIndexEntry * NSCacheIndexFind(const NSCacheIndex * index, uint32_t hash)
+{
+    if (!index || !index->buckets)
+    {
+        return NULL;
+    }
+
+    NSCacheIndexEntry * entry = index->buckets[hash & (index->size - 1)];
+    while (entry && entry->hash != hash)
+    {
+        entry = entry->next;
+    }
+    return entry;
+}
+
+NSCacheIndexEntry * NSCacheIndexFindNext(const NSCacheIndexEntry * entry)
+{
+    if (!entry)
+    {
+        return NULL;
+    }
+
+    uint32_t hash = entry->hash;
+    NSCacheIndexEntry * next = entry->next;
+    while (next && next->hash != hash)
+    {
+        next = next->next;
+    }
+    return next;
+}
+
+void NSCacheIndexDestroy(NSCacheIndex * index)
+{
+    if (!index)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < index->size; i++)
+    {
+        NSCacheIndexEntry * entry = index->buckets[i];
+        while (entry)
+        {
+            NSCacheIndexEntry * next = entry->next;
+            NSOICFree(entry);
+            entry = next;
+        }
+    }
+
+    NSOICFree(index->buckets);
+    index->size = 0;
+    index->count = 0;
+}
+
+void NSCacheListAppend(NSCacheList * list, NSCacheElement * element)
+{
+    element->next = NULL;
+    element->prev = list->tail;
+
+    if (list->tail)
+    {
+        list->tail->next = element;
+    }
+    else
+    {
+        list->head = element;
+    }
+    list->tail = element;
+}
+
+void NSCacheListUnlink(NSCacheList * list, NSCacheElement * element)
+{
+    if (element->prev)
+    {
+        element->prev->next = element->next;
+    }
+    else
+    {
+        list->head = element->next;
+    }
+
+    if (element->next)
+    {
+        element->next->prev = element->prev;
+    }
+    else
+    {
+        list->tail = element->prev;
+    }
+
+    element->next = NULL;
+    element->prev = NULL;
+}
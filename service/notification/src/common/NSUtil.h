@@ -220,4 +220,87 @@ OCDevAddr * NSChangeAddress(const char * address);
  */
 bool NSOCResultToSuccess(OCStackResult ret);
 
+/**
+ * Hash a key of cache data.
+ *
+ * @param key   Id, topic name or other string key
+ *
+ * @return hash of the key
+ */
+uint32_t NSCacheHashString(const char * key);
+
+/**
+ * Hash a device address.
+ *
+ * @param addr  address
+ * @param port  port
+ *
+ * @return hash of the address
+ */
+uint32_t NSCacheHashAddress(const char * addr, uint16_t port);
+
+/**
+ * Add an element to a cache index. An element may be added several times with
+ * different keys.
+ *
+ * @param index    cache index
+ * @param hash     hash of the key of the element
+ * @param element  cache element
+ *
+ * @return NS_OK if added, otherwise NS_ERROR
+ */
+NSResult NSCacheIndexAdd(NSCacheIndex * index, uint32_t hash, NSCacheElement * element);
+
+/**
+ * Remove an element from a cache index, once for the given key.
+ *
+ * @param index    cache index
+ * @param hash     hash of the key of the element
+ * @param element  cache element
+ */
+void NSCacheIndexRemove(NSCacheIndex * index, uint32_t hash, const NSCacheElement * element);
+
+/**
+ * Find the first entry of a cache index with the given hash. The caller compares
+ * the key of each entry, as different keys may have the same hash.
+ *
+ * @param index  cache index
+ * @param hash   hash of the key
+ *
+ * @return entry, or NULL if no entry has the hash
+ */
+NSCacheIndexEntry * NSCacheIndexFind(const NSCacheIndex * index, uint32_t hash);
+
+/**
+ * Find the next entry with the same hash.
+ *
+ * @param entry  entry returned by NSCacheIndexFind or NSCacheIndexFindNext
+ *
+ * @return entry, or NULL if no other entry has the hash
+ */
+NSCacheIndexEntry * NSCacheIndexFindNext(const NSCacheIndexEntry * entry);
+
+/**
+ * Free the entries of a cache index.
+ *
+ * @param index  cache index
+ */
+void NSCacheIndexDestroy(NSCacheIndex * index);
+
+/**
+ * Append an element to a cache list.
+ *
+ * @param list     cache list
+ * @param element  cache element
+ */
+void NSCacheListAppend(NSCacheList * list, NSCacheElement * element);
+
+/**
+ * Unlink an element from a cache list, without freeing it.
+ *
+ * @param list     cache list
+ * @param element  cache element of the list
+ */
+void NSCacheListUnlink(NSCacheList * list, NSCacheElement * element);
+
 #endif /* _NS_UTIL__H_ */
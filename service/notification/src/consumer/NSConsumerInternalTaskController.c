@@ -304,8 +304,8 @@ void NSConsumerHandleSubscribeSucceed(NSProvider_internal * provider)
     NSCacheElement * cacheElement = NSConsumerStorageRead(ProviderCache, provider->providerId);
     NS_VERIFY_NOT_NULL_V(cacheElement);
 
-    pthread_mutex_t * mutex = NSGetCacheMutex();
-    pthread_mutex_lock(mutex);
+    pthread_rwlock_t * lock = NSGetCacheLock();
+    pthread_rwlock_wrlock(lock);
 
     NS_VERIFY_NOT_NULL_V(cacheElement);
     NSProvider_internal * prov = (NSProvider_internal *)cacheElement->data;
@@ -316,7 +316,7 @@ void NSConsumerHandleSubscribeSucceed(NSProvider_internal * provider)
         infos = infos->next;
     }
 
-    pthread_mutex_unlock(mutex);
+    pthread_rwlock_unlock(lock);
 }
 
 void NSConsumerHandleRecvProviderChanged(NSMessage * msg)
@@ -330,14 +330,14 @@ void NSConsumerHandleRecvProviderChanged(NSMessage * msg)
     NSCacheElement * cacheElement = NSConsumerStorageRead(ProviderCache, msg->providerId);
     NS_VERIFY_NOT_NULL_V(cacheElement);
 
-    pthread_mutex_t * mutex = NSGetCacheMutex();
-    pthread_mutex_lock(mutex);
-    NS_VERIFY_NOT_NULL_WITH_POST_CLEANING_V(cacheElement, pthread_mutex_unlock(mutex));
+    pthread_rwlock_t * lock = NSGetCacheLock();
+    pthread_rwlock_wrlock(lock);
+    NS_VERIFY_NOT_NULL_WITH_POST_CLEANING_V(cacheElement, pthread_rwlock_unlock(lock));
     NSProvider_internal * provider = (NSProvider_internal *) cacheElement->data;
     if (provider->state == (NSProviderState) msg->messageId)
     {
         NS_LOG_V(DEBUG, "Already receive message(ALLOW/DENY) : %d", (int) msg->messageId);
-        pthread_mutex_unlock(mutex);
+        pthread_rwlock_unlock(lock);
         return;
     }
 
@@ -348,7 +348,7 @@ void NSConsumerHandleRecvProviderChanged(NSMessage * msg)
 
     NSProvider * prov = NSCopyProvider(provider);
 
-    pthread_mutex_unlock(mutex);
+    pthread_rwlock_unlock(lock);
     NSProviderChanged(prov, (NSProviderState) msg->messageId);
     NSRemoveProvider(prov);
 }
@@ -19,35 +19,104 @@
 //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
 
 #include "NSConsumerMemoryCache.h"
+#include "NSUtil.h"
 #include "oic_malloc.h"
 #include "oic_string.h"
 
-pthread_mutex_t * NSGetCacheMutex(void)
+/** index of provider data by provider Id */
+#define NS_CACHE_INDEX_PROVIDER_ID 0
+
+/** index of provider data by the address of each connection */
+#define NS_CACHE_INDEX_ADDRESS 1
+
+pthread_rwlock_t * NSGetCacheLock(void)
+{
+    static pthread_rwlock_t g_NSCacheLock = PTHREAD_RWLOCK_INITIALIZER;
+    return &g_NSCacheLock;
+}
+
+static void NSUnindexConnections(NSCacheList * list, NSCacheElement * element,
+        NSProviderConnectionInfo * connection, NSProviderConnectionInfo * end)
 {
-    static pthread_mutex_t * g_NSCacheMutex = NULL;
-    if (g_NSCacheMutex == NULL)
+    for (; connection != end; connection = connection->next)
     {
-        g_NSCacheMutex = (pthread_mutex_t *) OICMalloc(sizeof(pthread_mutex_t));
-        NS_VERIFY_NOT_NULL(g_NSCacheMutex, NULL);
+        NSCacheIndexRemove(&list->index[NS_CACHE_INDEX_ADDRESS],
+                NSCacheHashAddress(connection->addr->addr, connection->addr->port), element);
+    }
+}
 
-        pthread_mutex_init(g_NSCacheMutex, NULL);
+static NSResult NSIndexConnections(NSCacheList * list, NSCacheElement * element,
+        NSProviderConnectionInfo * connections)
+{
+    NSProviderConnectionInfo * connection = connections;
+    for (; connection; connection = connection->next)
+    {
+        if (NSCacheIndexAdd(&list->index[NS_CACHE_INDEX_ADDRESS],
+                NSCacheHashAddress(connection->addr->addr, connection->addr->port),
+                element) != NS_OK)
+        {
+            NSUnindexConnections(list, element, connections, connection);
+            return NS_ERROR;
+        }
     }
-    return g_NSCacheMutex;
+
+    return NS_OK;
 }
 
-NSCacheList * NSConsumerStorageCreate(void)
+static NSResult NSIndexProvider(NSCacheList * list, NSCacheElement * element)
 {
-    pthread_mutex_t * mutex = NSGetCacheMutex();
-    pthread_mutex_lock(mutex);
+    NSProvider_internal * prov = (NSProvider_internal *) element->data;
+
+    NSResult ret = NSCacheIndexAdd(&list->index[NS_CACHE_INDEX_PROVIDER_ID],
+            NSCacheHashString(prov->providerId), element);
+    NS_VERIFY_NOT_NULL(ret == NS_OK ? (void *) 1 : NULL, NS_ERROR);
+
+    ret = NSIndexConnections(list, element, prov->connection);
+    NS_VERIFY_NOT_NULL_WITH_POST_CLEANING(ret == NS_OK ? (void *) 1 : NULL, NS_ERROR,
+            NSCacheIndexRemove(&list->index[NS_CACHE_INDEX_PROVIDER_ID],
+                    NSCacheHashString(prov->providerId), element));
 
-    NSCacheList * newList = (NSCacheList *) OICMalloc(sizeof(NSCacheList));
-    NS_VERIFY_NOT_NULL_WITH_POST_CLEANING(newList, NULL, pthread_mutex_unlock(mutex));
+    return NS_OK;
+}
+
+static void NSUnindexProvider(NSCacheList * list, NSCacheElement * element)
+{
+    NSProvider_internal * prov = (NSProvider_internal *) element->data;
+
+    NSCacheIndexRemove(&list->index[NS_CACHE_INDEX_PROVIDER_ID],
+            NSCacheHashString(prov->providerId), element);
+    NSUnindexConnections(list, element, prov->connection, NULL);
+}
+
+/**
+ * Find an element of the list by the Id of its cache type. The caller holds the cache lock.
+ */
+static NSCacheElement * NSFindCacheElement(NSCacheList * list, const char * findId)
+{
+    NSCacheType type = list->cacheType;
+
+    NSCacheIndexEntry * entry = NSCacheIndexFind(&list->index[NS_CACHE_INDEX_PROVIDER_ID],
+            NSCacheHashString(findId));
+
+    for (; entry; entry = NSCacheIndexFindNext(entry))
+    {
+        if (NSConsumerCompareIdCacheData(type, entry->element->data, findId))
+        {
+            return entry->element;
+        }
+    }
+
+    return NULL;
+}
+
+NSCacheList * NSConsumerStorageCreate(void)
+{
+    NSCacheList * newList = (NSCacheList *) OICCalloc(1, sizeof(NSCacheList));
+    NS_VERIFY_NOT_NULL(newList, NULL);
 
     newList->head = NULL;
     newList->tail = NULL;
 
-    pthread_mutex_unlock(mutex);
-
     return newList;
 }
 
@@ -56,26 +125,17 @@ NSCacheElement * NSConsumerStorageRead(NSCacheList * list, const char * findId)
     NS_VERIFY_NOT_NULL(list, NULL);
     NS_VERIFY_NOT_NULL(findId, NULL);
 
-    pthread_mutex_t * mutex = NSGetCacheMutex();
-    pthread_mutex_lock(mutex);
-
-    NSCacheElement * iter = list->head;
-    NSCacheType type = list->cacheType;
+    pthread_rwlock_t * lock = NSGetCacheLock();
+    pthread_rwlock_rdlock(lock);
 
-    while (iter)
+    NSCacheElement * iter = NSFindCacheElement(list, findId);
+    if (!iter)
     {
-        if (NSConsumerCompareIdCacheData(type, iter->data, findId))
-        {
-            pthread_mutex_unlock(mutex);
-            return iter;
-        }
-
-        iter = iter->next;
+        NS_LOG (DEBUG, "No Cache Element");
     }
 
-    NS_LOG (DEBUG, "No Cache Element");
-    pthread_mutex_unlock(mutex);
-    return NULL;
+    pthread_rwlock_unlock(lock);
+    return iter;
 }
 
 NSCacheElement * NSGetProviderFromAddr(NSCacheList * list, const char * addr, uint16_t port)
@@ -85,15 +145,16 @@ NSCacheElement * NSGetProviderFromAddr(NSCacheList * list, const char * addr, ui
     NS_VERIFY_NOT_NULL(
             (list->cacheType != NS_CONSUMER_CACHE_PROVIDER) ? NULL : (void *) 1, NULL);
 
-    pthread_mutex_t * mutex = NSGetCacheMutex();
-    pthread_mutex_lock(mutex);
+    pthread_rwlock_t * lock = NSGetCacheLock();
+    pthread_rwlock_rdlock(lock);
 
-    NSCacheElement * iter = list->head;
+    NSCacheIndexEntry * entry = NSCacheIndexFind(&list->index[NS_CACHE_INDEX_ADDRESS],
+            NSCacheHashAddress(addr, port));
 
-    while (iter)
+    for (; entry; entry = NSCacheIndexFindNext(entry))
     {
         NSProviderConnectionInfo * connection =
-                ((NSProvider_internal *) iter->data)->connection;
+                ((NSProvider_internal *) entry->element->data)->connection;
         while (connection)
         {
             char * conAddr = connection->addr->addr;
@@ -101,17 +162,15 @@ NSCacheElement * NSGetProviderFromAddr(NSCacheList * list, const char * addr, ui
 
             if (!strcmp(conAddr, addr) && conPort == port)
             {
-                pthread_mutex_unlock(mutex);
-                return iter;
+                pthread_rwlock_unlock(lock);
+                return entry->element;
             }
             connection = connection->next;
         }
-
-        iter = iter->next;
     }
 
     NS_LOG (DEBUG, "No Cache Element");
-    pthread_mutex_unlock(mutex);
+    pthread_rwlock_unlock(lock);
     return NULL;
 }
 
@@ -140,61 +199,25 @@ NSResult NSConsumerStorageDelete(NSCacheList * list, const char * delId)
 
     NSCacheType type = list->cacheType;
 
-    pthread_mutex_t * mutex = NSGetCacheMutex();
-    pthread_mutex_lock(mutex);
+    pthread_rwlock_t * lock = NSGetCacheLock();
+    pthread_rwlock_wrlock(lock);
 
-    NSCacheElement * prev = list->head;
-    NSCacheElement * del = list->head;
-    NS_VERIFY_NOT_NULL_WITH_POST_CLEANING(del, NS_ERROR, pthread_mutex_unlock(mutex));
+    NS_VERIFY_NOT_NULL_WITH_POST_CLEANING(list->head, NS_ERROR, pthread_rwlock_unlock(lock));
 
-    if (NSConsumerCompareIdCacheData(type, del->data, delId))
+    NSCacheElement * del = NSFindCacheElement(list, delId);
+    if (del)
     {
-        if (del == list->head)
-        {
-            if (del == list->tail)
-            {
-                list->tail = del->next;
-            }
+        NSUnindexProvider(list, del);
+        NSCacheListUnlink(list, del);
 
-            list->head = del->next;
-
-            if (type == NS_CONSUMER_CACHE_PROVIDER)
-            {
-                NSRemoveProvider_internal((void *) del->data);
-            }
-            NSOICFree(del);
-            pthread_mutex_unlock(mutex);
-
-            return NS_OK;
-        }
-    }
-
-    del = del->next;
-    while (del)
-    {
-        if (NSConsumerCompareIdCacheData(type, del->data, delId))
+        if (type == NS_CONSUMER_CACHE_PROVIDER)
         {
-            if (del == list->tail)
-            {
-                list->tail = prev;
-            }
-
-            prev->next = del->next;
-
-            if (type == NS_CONSUMER_CACHE_PROVIDER)
-            {
-                NSRemoveProvider_internal((NSProvider_internal *) del->data);
-            }
-            NSOICFree(del);
-            pthread_mutex_unlock(mutex);
-
-            return NS_OK;
+            NSRemoveProvider_internal((NSProvider_internal *) del->data);
         }
-
-        prev = del;
-        del = del->next;
+        NSOICFree(del);
     }
-    pthread_mutex_unlock(mutex);
+
+    pthread_rwlock_unlock(lock);
     return NS_OK;
 }
 
@@ -203,13 +226,13 @@ NSResult NSConsumerCacheWriteProvider(NSCacheList * list, NSCacheElement * newOb
     NS_VERIFY_NOT_NULL(list, NS_ERROR);
     NS_VERIFY_NOT_NULL(newObj, NS_ERROR);
 
-    pthread_mutex_t * mutex = NSGetCacheMutex();
+    pthread_rwlock_t * lock = NSGetCacheLock();
 
     NSProvider_internal * newProvObj = (NSProvider_internal *) newObj->data;
 
-    NSCacheElement * it = NSConsumerStorageRead(list, newProvObj->providerId);
+    pthread_rwlock_wrlock(lock);
 
-    pthread_mutex_lock(mutex);
+    NSCacheElement * it = NSFindCacheElement(list, newProvObj->providerId);
 
     if (it)
     {
@@ -225,6 +248,13 @@ NSResult NSConsumerCacheWriteProvider(NSCacheList * list, NSCacheElement * newOb
                 lastConn = lastConn->next;
             }
             infos->next = NSCopyProviderConnections(newProvObj->connection);
+
+            if (infos->next && NSIndexConnections(list, it, infos->next) != NS_OK)
+            {
+                NS_LOG (ERROR, "Failed to index connections");
+                NSRemoveConnections(infos->next);
+                infos->next = NULL;
+            }
         }
 
         if (newProvObj->topicLL)
@@ -234,13 +264,13 @@ NSResult NSConsumerCacheWriteProvider(NSCacheList * list, NSCacheElement * newOb
             provObj->topicLL = NSCopyTopicLL(newProvObj->topicLL);
         }
 
-        pthread_mutex_unlock(mutex);
+        pthread_rwlock_unlock(lock);
 
         return NS_OK;
     }
 
     NSCacheElement * obj = (NSCacheElement *) OICMalloc(sizeof(NSCacheElement));
-    NS_VERIFY_NOT_NULL_WITH_POST_CLEANING(obj, NS_ERROR, pthread_mutex_unlock(mutex));
+    NS_VERIFY_NOT_NULL_WITH_POST_CLEANING(obj, NS_ERROR, pthread_rwlock_unlock(lock));
 
     NS_LOG_V(INFO_PRIVATE, "New Object address : %s:%d", newProvObj->connection->addr->addr, newProvObj->connection->addr->port);
     obj->data = (void *) NSCopyProvider_internal(newProvObj);
@@ -249,26 +279,24 @@ NSResult NSConsumerCacheWriteProvider(NSCacheList * list, NSCacheElement * newOb
     {
         NS_LOG (ERROR, "Failed to CopyProvider");
         NSOICFree(obj);
-        pthread_mutex_unlock(mutex);
+        pthread_rwlock_unlock(lock);
 
         return NS_ERROR;
     }
-    obj->next = NULL;
 
-    if (!list->head)
+    if (NSIndexProvider(list, obj) != NS_OK)
     {
-        list->head = obj;
-        list->tail = obj;
-
-        pthread_mutex_unlock(mutex);
+        NS_LOG (ERROR, "Failed to index provider");
+        NSRemoveProvider_internal((NSProvider_internal *) obj->data);
+        NSOICFree(obj);
+        pthread_rwlock_unlock(lock);
 
-        return NS_OK;
+        return NS_ERROR;
     }
 
-    (list->tail)->next = obj;
-    list->tail = obj;
+    NSCacheListAppend(list, obj);
 
-    pthread_mutex_unlock(mutex);
+    pthread_rwlock_unlock(lock);
 
     return NS_OK;
 }
@@ -277,22 +305,17 @@ NSCacheElement * NSPopProviderCacheList(NSCacheList * list)
 {
     NS_VERIFY_NOT_NULL(list, NULL);
 
-    pthread_mutex_t * mutex = NSGetCacheMutex();
-    pthread_mutex_lock(mutex);
+    pthread_rwlock_t * lock = NSGetCacheLock();
+    pthread_rwlock_wrlock(lock);
 
     NSCacheElement * head = list->head;
     if (head)
     {
-        if (list->tail == head)
-        {
-            list->tail = NULL;
-        }
-
-        list->head = head->next;
-        head->next = NULL;
+        NSUnindexProvider(list, head);
+        NSCacheListUnlink(list, head);
     }
 
-    pthread_mutex_unlock(mutex);
+    pthread_rwlock_unlock(lock);
     return head;
 }
 
@@ -301,8 +324,8 @@ NSResult NSConsumerStorageDestroy(NSCacheList * list)
 {
     NS_VERIFY_NOT_NULL(list, NS_ERROR);
 
-    pthread_mutex_t * mutex = NSGetCacheMutex();
-    pthread_mutex_lock(mutex);
+    pthread_rwlock_t * lock = NSGetCacheLock();
+    pthread_rwlock_wrlock(lock);
 
     NSCacheElement * iter = list->head;
     NSCacheElement * next = NULL;
@@ -321,10 +344,15 @@ NSResult NSConsumerStorageDestroy(NSCacheList * list)
             iter = next;
         }
 
+        for (size_t key = 0; key < NS_CACHE_INDEX_KEYS; key++)
+        {
+            NSCacheIndexDestroy(&list->index[key]);
+        }
+
         NSOICFree(list);
     }
 
-    pthread_mutex_unlock(mutex);
+    pthread_rwlock_unlock(lock);
 
     return NS_OK;
 }
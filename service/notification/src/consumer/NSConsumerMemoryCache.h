@@ -77,11 +77,11 @@ NSResult NSConsumerStorageDelete(NSCacheList * list, const char * delId);
 NSResult NSConsumerStorageDestroy(NSCacheList * list);
 
 /**
- * Get cache mutex.
+ * Get cache lock. Readers of the cache take it shared, writers exclusive.
  *
- * @return reference mutex, otherwise NULL.
+ * @return reference lock.
  */
-pthread_mutex_t * NSGetCacheMutex(void);
+pthread_rwlock_t * NSGetCacheLock(void);
 
 /**
  * Compare data with given Id
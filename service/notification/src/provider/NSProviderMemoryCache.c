@@ -19,6 +19,7 @@
 //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
 
 #include "NSProviderMemoryCache.h"
+#include <inttypes.h>
 #include <string.h>
 
 #define NS_PROVIDER_DELETE_REGISTERED_TOPIC_DATA(it, topicData, newObj) \
@@ -29,25 +30,158 @@
             NSOICFree(topicData->topicName); \
             NSOICFree(topicData); \
             NSOICFree(newObj); \
-            pthread_mutex_unlock(&NSCacheMutex); \
+            pthread_rwlock_unlock(&NSCacheLock); \
             return NS_FAIL; \
         } \
     }
 
+/** index of subscriber and consumer topic data by consumer Id */
+#define NS_CACHE_INDEX_CONSUMER_ID 0
+
+/** index of registered and consumer topic data by topic name */
+#define NS_CACHE_INDEX_TOPIC_NAME 1
+
+static const char * NSGetCacheKey(NSCacheType type, void * data, size_t key)
+{
+    if (type == NS_PROVIDER_CACHE_SUBSCRIBER || type == NS_PROVIDER_CACHE_SUBSCRIBER_OBSERVE_ID)
+    {
+        return (key == NS_CACHE_INDEX_CONSUMER_ID) ? ((NSCacheSubData *) data)->id : NULL;
+    }
+    else if (type == NS_PROVIDER_CACHE_REGISTER_TOPIC)
+    {
+        return (key == NS_CACHE_INDEX_TOPIC_NAME) ? ((NSCacheTopicData *) data)->topicName : NULL;
+    }
+    else if (type == NS_PROVIDER_CACHE_CONSUMER_TOPIC_NAME ||
+            type == NS_PROVIDER_CACHE_CONSUMER_TOPIC_CID)
+    {
+        NSCacheTopicSubData * topicData = (NSCacheTopicSubData *) data;
+        return (key == NS_CACHE_INDEX_CONSUMER_ID) ? topicData->id : topicData->topicName;
+    }
+
+    return NULL;
+}
+
+/**
+ * Get the index by which elements are read for the cache type, or NS_CACHE_INDEX_KEYS
+ * if they are read by observation Id, which is not indexed.
+ */
+static size_t NSGetReadIndex(NSCacheType type)
+{
+    switch (type)
+    {
+        case NS_PROVIDER_CACHE_SUBSCRIBER:
+        case NS_PROVIDER_CACHE_CONSUMER_TOPIC_CID:
+            return NS_CACHE_INDEX_CONSUMER_ID;
+        case NS_PROVIDER_CACHE_REGISTER_TOPIC:
+        case NS_PROVIDER_CACHE_CONSUMER_TOPIC_NAME:
+            return NS_CACHE_INDEX_TOPIC_NAME;
+        default:
+            return NS_CACHE_INDEX_KEYS;
+    }
+}
+
+static void NSUnindexCacheElement(NSCacheList * list, NSCacheElement * element, size_t keys)
+{
+    for (size_t key = 0; key < keys; key++)
+    {
+        const char * id = NSGetCacheKey(list->cacheType, element->data, key);
+        if (id)
+        {
+            NSCacheIndexRemove(&list->index[key], NSCacheHashString(id), element);
+        }
+    }
+}
+
+static NSResult NSIndexCacheElement(NSCacheList * list, NSCacheElement * element)
+{
+    for (size_t key = 0; key < NS_CACHE_INDEX_KEYS; key++)
+    {
+        const char * id = NSGetCacheKey(list->cacheType, element->data, key);
+        if (id && NSCacheIndexAdd(&list->index[key], NSCacheHashString(id), element) != NS_OK)
+        {
+            NSUnindexCacheElement(list, element, key);
+            return NS_ERROR;
+        }
+    }
+
+    return NS_OK;
+}
+
+/**
+ * Find an element of the list by the Id of its cache type. The caller holds NSCacheLock.
+ */
+static NSCacheElement * NSFindCacheElement(NSCacheList * list, const char * findId)
+{
+    NSCacheType type = list->cacheType;
+    size_t key = NSGetReadIndex(type);
+
+    if (key < NS_CACHE_INDEX_KEYS)
+    {
+        NSCacheIndexEntry * entry = NSCacheIndexFind(&list->index[key], NSCacheHashString(findId));
+        for (; entry; entry = NSCacheIndexFindNext(entry))
+        {
+            if (NSProviderCompareIdCacheData(type, entry->element->data, findId))
+            {
+                return entry->element;
+            }
+        }
+
+        return NULL;
+    }
+
+    for (NSCacheElement * iter = list->head; iter; iter = iter->next)
+    {
+        if (NSProviderCompareIdCacheData(type, iter->data, findId))
+        {
+            return iter;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Find the subscription of a consumer to a topic. The caller holds NSCacheLock.
+ */
+static NSCacheElement * NSFindConsumerTopic(NSCacheList * conTopicList, const char * cId,
+        const char * topicName)
+{
+    NSCacheIndexEntry * entry = NSCacheIndexFind(&conTopicList->index[NS_CACHE_INDEX_CONSUMER_ID],
+            NSCacheHashString(cId));
+
+    for (; entry; entry = NSCacheIndexFindNext(entry))
+    {
+        NSCacheTopicSubData * curr = (NSCacheTopicSubData *) entry->element->data;
+
+        if ((strncmp(curr->id, cId, NS_UUID_STRING_SIZE) == 0) &&
+                (strcmp(curr->topicName, topicName) == 0))
+        {
+            return entry->element;
+        }
+    }
+
+    return NULL;
+}
+
+static void NSRemoveCacheElement(NSCacheList * list, NSCacheElement * element)
+{
+    NSUnindexCacheElement(list, element, NS_CACHE_INDEX_KEYS);
+    NSCacheListUnlink(list, element);
+    NSProviderDeleteCacheData(list->cacheType, element->data);
+    NSOICFree(element);
+}
+
 NSCacheList * NSProviderStorageCreate(void)
 {
-    pthread_mutex_lock(&NSCacheMutex);
-    NSCacheList * newList = (NSCacheList *) OICMalloc(sizeof(NSCacheList));
+    NSCacheList * newList = (NSCacheList *) OICCalloc(1, sizeof(NSCacheList));
 
     if (!newList)
     {
-        pthread_mutex_unlock(&NSCacheMutex);
         return NULL;
     }
 
     newList->head = newList->tail = NULL;
 
-    pthread_mutex_unlock(&NSCacheMutex);
     NS_LOG(DEBUG, "NSCacheCreate");
 
     return newList;
@@ -55,51 +189,34 @@ NSCacheList * NSProviderStorageCreate(void)
 
 NSCacheElement * NSProviderStorageRead(NSCacheList * list, const char * findId)
 {
-    pthread_mutex_lock(&NSCacheMutex);
+    pthread_rwlock_rdlock(&NSCacheLock);
 
     NS_LOG(DEBUG, "NSCacheRead - IN");
 
-    NSCacheElement * iter = list->head;
-    NSCacheElement * next = NULL;
-    NSCacheType type = list->cacheType;
-
     NS_LOG_V(INFO_PRIVATE, "Find ID - %s", findId);
 
-    while (iter)
-    {
-        next = iter->next;
-
-        if (NSProviderCompareIdCacheData(type, iter->data, findId))
-        {
-            NS_LOG(DEBUG, "Found in Cache");
-            pthread_mutex_unlock(&NSCacheMutex);
-            return iter;
-        }
-
-        iter = next;
-    }
+    NSCacheElement * iter = NSFindCacheElement(list, findId);
 
-    NS_LOG(DEBUG, "Not found in Cache");
+    NS_LOG(DEBUG, iter ? "Found in Cache" : "Not found in Cache");
     NS_LOG(DEBUG, "NSCacheRead - OUT");
-    pthread_mutex_unlock(&NSCacheMutex);
+    pthread_rwlock_unlock(&NSCacheLock);
 
-    return NULL;
+    return iter;
 }
 
 NSResult NSCacheUpdateSubScriptionState(NSCacheList * list, char * id, bool state)
 {
-    pthread_mutex_lock(&NSCacheMutex);
-
     NS_LOG(DEBUG, "NSCacheUpdateSubScriptionState - IN");
 
     if (id == NULL)
     {
         NS_LOG(DEBUG, "id is NULL");
-        pthread_mutex_unlock(&NSCacheMutex);
         return NS_ERROR;
     }
 
-    NSCacheElement * it = NSProviderStorageRead(list, id);
+    pthread_rwlock_wrlock(&NSCacheLock);
+
+    NSCacheElement * it = NSFindCacheElement(list, id);
 
     if (it)
     {
@@ -118,7 +235,7 @@ NSResult NSCacheUpdateSubScriptionState(NSCacheList * list, char * id, bool stat
             itData->isWhite = state;
 
             NS_LOG(DEBUG, "Update Data - OUT");
-            pthread_mutex_unlock(&NSCacheMutex);
+            pthread_rwlock_unlock(&NSCacheLock);
             return NS_OK;
         }
     }
@@ -128,31 +245,30 @@ NSResult NSCacheUpdateSubScriptionState(NSCacheList * list, char * id, bool stat
     }
 
     NS_LOG(DEBUG, "NSCacheUpdateSubScriptionState - OUT");
-    pthread_mutex_unlock(&NSCacheMutex);
+    pthread_rwlock_unlock(&NSCacheLock);
     return NS_ERROR;
 }
 
 NSResult NSProviderStorageWrite(NSCacheList * list, NSCacheElement * newObj)
 {
-    pthread_mutex_lock(&NSCacheMutex);
-
-    NSCacheType type = list->cacheType;
-
     NS_LOG(DEBUG, "NSCacheWrite - IN");
 
     if (newObj == NULL)
     {
         NS_LOG(DEBUG, "newObj is NULL - IN");
-        pthread_mutex_unlock(&NSCacheMutex);
         return NS_ERROR;
     }
 
+    pthread_rwlock_wrlock(&NSCacheLock);
+
+    NSCacheType type = list->cacheType;
+
     if (type == NS_PROVIDER_CACHE_SUBSCRIBER)
     {
         NS_LOG(DEBUG, "Type is SUBSCRIBER");
 
         NSCacheSubData * subData = (NSCacheSubData *) newObj->data;
-        NSCacheElement * it = NSProviderStorageRead(list, subData->id);
+        NSCacheElement * it = NSFindCacheElement(list, subData->id);
 
         if (it)
         {
@@ -185,7 +301,7 @@ NSResult NSProviderStorageWrite(NSCacheList * list, NSCacheElement * newObj)
                 NS_LOG(DEBUG, "Update Data - OUT");
                 NSOICFree(subData);
                 NSOICFree(newObj);
-                pthread_mutex_unlock(&NSCacheMutex);
+                pthread_rwlock_unlock(&NSCacheLock);
                 return NS_OK;
             }
         }
@@ -196,40 +312,32 @@ NSResult NSProviderStorageWrite(NSCacheList * list, NSCacheElement * newObj)
         NS_LOG(DEBUG, "Type is REGITSTER TOPIC");
 
         NSCacheTopicData * topicData = (NSCacheTopicData *) newObj->data;
-        NSCacheElement * it = NSProviderStorageRead(list, topicData->topicName);
+        NSCacheElement * it = NSFindCacheElement(list, topicData->topicName);
 
         NS_PROVIDER_DELETE_REGISTERED_TOPIC_DATA(it, topicData, newObj);
     }
-    else if (type == NS_PROVIDER_CACHE_CONSUMER_TOPIC_NAME)
-    {
-        NS_LOG(DEBUG, "Type is REGITSTER TOPIC");
-
-        NSCacheTopicSubData * topicData = (NSCacheTopicSubData *) newObj->data;
-        NSCacheElement * it = NSProviderStorageRead(list, topicData->topicName);
-
-        NS_PROVIDER_DELETE_REGISTERED_TOPIC_DATA(it, topicData, newObj);
-    }
-    else if (type == NS_PROVIDER_CACHE_CONSUMER_TOPIC_CID)
+    else if (type == NS_PROVIDER_CACHE_CONSUMER_TOPIC_NAME ||
+            type == NS_PROVIDER_CACHE_CONSUMER_TOPIC_CID)
     {
-        NS_LOG(DEBUG, "Type is REGITSTER TOPIC");
+        NS_LOG(DEBUG, "Type is CONSUMER TOPIC");
 
         NSCacheTopicSubData * topicData = (NSCacheTopicSubData *) newObj->data;
-        NSCacheElement * it = NSProviderStorageRead(list, topicData->id);
+        NSCacheElement * it = NSFindConsumerTopic(list, topicData->id, topicData->topicName);
 
         NS_PROVIDER_DELETE_REGISTERED_TOPIC_DATA(it, topicData, newObj);
     }
 
-    if (list->head == NULL)
+    if (NSIndexCacheElement(list, newObj) != NS_OK)
     {
-        NS_LOG(DEBUG, "list->head is NULL, Insert First Data");
-        list->head = list->tail = newObj;
-        pthread_mutex_unlock(&NSCacheMutex);
-        return NS_OK;
+        NS_LOG(ERROR, "Failed to index cache data");
+        NSProviderDeleteCacheData(type, newObj->data);
+        NSOICFree(newObj);
+        pthread_rwlock_unlock(&NSCacheLock);
+        return NS_ERROR;
     }
 
-    list->tail = list->tail->next = newObj;
-    NS_LOG(DEBUG, "list->head is not NULL");
-    pthread_mutex_unlock(&NSCacheMutex);
+    NSCacheListAppend(list, newObj);
+    pthread_rwlock_unlock(&NSCacheLock);
     return NS_OK;
 }
 
@@ -247,6 +355,11 @@ NSResult NSProviderStorageDestroy(NSCacheList * list)
         iter = next;
     }
 
+    for (size_t key = 0; key < NS_CACHE_INDEX_KEYS; key++)
+    {
+        NSCacheIndexDestroy(&list->index[key]);
+    }
+
     NSOICFree(list);
     return NS_OK;
 }
@@ -388,72 +501,37 @@ NSResult NSProviderDeleteCacheData(NSCacheType type, void * data)
 
 NSResult NSProviderStorageDelete(NSCacheList * list, const char * delId)
 {
-    pthread_mutex_lock(&NSCacheMutex);
-    NSCacheElement * prev = list->head;
-    NSCacheElement * del = list->head;
+    pthread_rwlock_wrlock(&NSCacheLock);
 
-    NSCacheType type = list->cacheType;
-
-    if (!del)
+    if (!list->head)
     {
         NS_LOG(DEBUG, "list head is NULL");
-        pthread_mutex_unlock(&NSCacheMutex);
+        pthread_rwlock_unlock(&NSCacheLock);
         return NS_FAIL;
     }
 
-    if (NSProviderCompareIdCacheData(type, del->data, delId))
-    {
-        if (del == list->head) // first object
-        {
-            if (del == list->tail) // first object (one object)
-            {
-                list->tail = del->next;
-            }
-
-            list->head = del->next;
-            NSProviderDeleteCacheData(type, del->data);
-            NSOICFree(del);
-            pthread_mutex_unlock(&NSCacheMutex);
-            return NS_OK;
-        }
-    }
+    NSCacheElement * del = NSFindCacheElement(list, delId);
 
-    del = del->next;
-
-    while (del)
+    if (!del)
     {
-        if (NSProviderCompareIdCacheData(type, del->data, delId))
-        {
-            if (del == list->tail) // delete object same to last object
-            {
-                list->tail = prev;
-            }
-
-            prev->next = del->next;
-            NSProviderDeleteCacheData(type, del->data);
-            NSOICFree(del);
-            pthread_mutex_unlock(&NSCacheMutex);
-            return NS_OK;
-        }
-
-        prev = del;
-        del = del->next;
+        pthread_rwlock_unlock(&NSCacheLock);
+        return NS_FAIL;
     }
 
-    pthread_mutex_unlock(&NSCacheMutex);
-    return NS_FAIL;
+    NSRemoveCacheElement(list, del);
+    pthread_rwlock_unlock(&NSCacheLock);
+    return NS_OK;
 }
 
-NSTopicLL * NSProviderGetTopicsCacheData(NSCacheList * regTopicList)
+/**
+ * Copy the registered topics. The caller holds NSCacheLock.
+ */
+static NSTopicLL * NSGetTopicsCacheData(NSCacheList * regTopicList)
 {
-    NS_LOG(DEBUG, "NSProviderGetTopicsCache - IN");
-    pthread_mutex_lock(&NSCacheMutex);
-
     NSCacheElement * iter = regTopicList->head;
 
     if (!iter)
     {
-        pthread_mutex_unlock(&NSCacheMutex);
         return NULL;
     }
 
@@ -468,7 +546,6 @@ NSTopicLL * NSProviderGetTopicsCacheData(NSCacheList * regTopicList)
 
         if (!newTopic)
         {
-            pthread_mutex_unlock(&NSCacheMutex);
             return NULL;
         }
 
@@ -489,7 +566,17 @@ NSTopicLL * NSProviderGetTopicsCacheData(NSCacheList * regTopicList)
         iter = iter->next;
     }
 
-    pthread_mutex_unlock(&NSCacheMutex);
+    return topics;
+}
+
+NSTopicLL * NSProviderGetTopicsCacheData(NSCacheList * regTopicList)
+{
+    NS_LOG(DEBUG, "NSProviderGetTopicsCache - IN");
+    pthread_rwlock_rdlock(&NSCacheLock);
+
+    NSTopicLL * topics = NSGetTopicsCacheData(regTopicList);
+
+    pthread_rwlock_unlock(&NSCacheLock);
     NS_LOG(DEBUG, "NSProviderGetTopicsCache - OUT");
 
     return topics;
@@ -500,21 +587,21 @@ NSTopicLL * NSProviderGetConsumerTopicsCacheData(NSCacheList * regTopicList,
 {
     NS_LOG(DEBUG, "NSProviderGetConsumerTopicsCacheData - IN");
 
-    pthread_mutex_lock(&NSCacheMutex);
-    NSTopicLL * topics = NSProviderGetTopicsCacheData(regTopicList);
+    pthread_rwlock_rdlock(&NSCacheLock);
+    NSTopicLL * topics = NSGetTopicsCacheData(regTopicList);
 
     if (!topics)
     {
-        pthread_mutex_unlock(&NSCacheMutex);
+        pthread_rwlock_unlock(&NSCacheLock);
         return NULL;
     }
 
-    NSCacheElement * iter = conTopicList->head;
-    conTopicList->cacheType = NS_PROVIDER_CACHE_CONSUMER_TOPIC_CID;
+    NSCacheIndexEntry * entry = NSCacheIndexFind(&conTopicList->index[NS_CACHE_INDEX_CONSUMER_ID],
+            NSCacheHashString(consumerId));
 
-    while (iter)
+    for (; entry; entry = NSCacheIndexFindNext(entry))
     {
-        NSCacheTopicSubData * curr = (NSCacheTopicSubData *)iter->data;
+        NSCacheTopicSubData * curr = (NSCacheTopicSubData *) entry->element->data;
 
         if (curr && strcmp(curr->id, consumerId) == 0)
         {
@@ -533,121 +620,187 @@ NSTopicLL * NSProviderGetConsumerTopicsCacheData(NSCacheList * regTopicList,
                 topicIter = topicIter->next;
             }
         }
-
-        iter = iter->next;
     }
 
-    conTopicList->cacheType = NS_PROVIDER_CACHE_CONSUMER_TOPIC_NAME;
-    pthread_mutex_unlock(&NSCacheMutex);
+    pthread_rwlock_unlock(&NSCacheLock);
     NS_LOG(DEBUG, "NSProviderGetConsumerTopics - OUT");
 
     return topics;
 }
 
-bool NSProviderIsTopicSubScribed(NSCacheElement * conTopicList, char * cId, char * topicName)
+bool NSProviderIsTopicSubScribed(NSCacheList * conTopicList, const char * cId,
+        const char * topicName)
 {
-    pthread_mutex_lock(&NSCacheMutex);
-
     if (!conTopicList || !cId || !topicName)
     {
-        pthread_mutex_unlock(&NSCacheMutex);
         return false;
     }
 
-    NSCacheElement * iter = conTopicList;
+    pthread_rwlock_rdlock(&NSCacheLock);
+    bool subscribed = NSFindConsumerTopic(conTopicList, cId, topicName) != NULL;
+    pthread_rwlock_unlock(&NSCacheLock);
 
-    while (iter)
-    {
-        NSCacheTopicSubData * curr = (NSCacheTopicSubData *) iter->data;
+    return subscribed;
+}
 
-        if ( (strcmp(curr->id, cId) == 0) && (strcmp(curr->topicName, topicName) == 0) )
+static bool NSAddTopicSubscriber(NSTopicSubscribers * subscribers, const char * cId)
+{
+    size_t mask = subscribers->size - 1;
+    size_t index = NSCacheHashString(cId) & mask;
+
+    while (subscribers->ids[index][0] != '\0')
+    {
+        if (strcmp(subscribers->ids[index], cId) == 0)
         {
-            pthread_mutex_unlock(&NSCacheMutex);
-            return true;
+            return false;
         }
-
-        iter = iter->next;
+        index = (index + 1) & mask;
     }
 
-    pthread_mutex_unlock(&NSCacheMutex);
-    return false;
+    OICStrcpy(subscribers->ids[index], NS_UUID_STRING_SIZE, cId);
+    subscribers->count++;
+    return true;
 }
 
-NSResult NSProviderDeleteConsumerTopic(NSCacheList * conTopicList,
-        NSCacheTopicSubData * topicSubData)
+NSResult NSProviderGetTopicSubscribers(NSCacheList * conTopicList, const char * topicName,
+        NSTopicSubscribers * subscribers)
 {
-    pthread_mutex_lock(&NSCacheMutex);
+    if (!conTopicList || !topicName || !subscribers)
+    {
+        return NS_ERROR;
+    }
 
-    char * cId = topicSubData->id;
-    char * topicName = topicSubData->topicName;
+    pthread_rwlock_rdlock(&NSCacheLock);
 
-    if (!conTopicList || !cId || !topicName)
+    uint32_t hash = NSCacheHashString(topicName);
+    size_t count = 0;
+    NSCacheIndexEntry * entry = NULL;
+
+    for (entry = NSCacheIndexFind(&conTopicList->index[NS_CACHE_INDEX_TOPIC_NAME], hash);
+            entry; entry = NSCacheIndexFindNext(entry))
+    {
+        count++;
+    }
+
+    // Keep the table at most half full, so that probe sequences stay short.
+    size_t size = 4;
+    while (size < count * 2)
+    {
+        size *= 2;
+    }
+
+    subscribers->ids = OICCalloc(size, NS_UUID_STRING_SIZE);
+    if (!subscribers->ids)
     {
-        pthread_mutex_unlock(&NSCacheMutex);
+        pthread_rwlock_unlock(&NSCacheLock);
         return NS_ERROR;
     }
+    subscribers->size = size;
+    subscribers->count = 0;
 
-    NSCacheElement * prev = conTopicList->head;
-    NSCacheElement * del = conTopicList->head;
+    for (entry = NSCacheIndexFind(&conTopicList->index[NS_CACHE_INDEX_TOPIC_NAME], hash);
+            entry; entry = NSCacheIndexFindNext(entry))
+    {
+        NSCacheTopicSubData * curr = (NSCacheTopicSubData *) entry->element->data;
+        if (strcmp(curr->topicName, topicName) == 0 && curr->id[0] != '\0')
+        {
+            NSAddTopicSubscriber(subscribers, curr->id);
+        }
+    }
 
-    NSCacheType type = conTopicList->cacheType;
+    pthread_rwlock_unlock(&NSCacheLock);
+    NS_LOG_V(DEBUG, "topic %s has %" PRIuPTR " subscribers", topicName, subscribers->count);
+    return NS_OK;
+}
 
-    if (!del)
+bool NSProviderIsTopicSubscriber(const NSTopicSubscribers * subscribers, const char * cId)
+{
+    if (!subscribers || !subscribers->ids || !cId || cId[0] == '\0')
     {
-        NS_LOG(DEBUG, "list head is NULL");
-        pthread_mutex_unlock(&NSCacheMutex);
-        return NS_FAIL;
+        return false;
     }
 
-    NSCacheTopicSubData * curr = (NSCacheTopicSubData *) del->data;
-    NS_LOG_V(INFO_PRIVATE, "compareid = %s", cId);
-    NS_LOG_V(DEBUG, "comparetopicName = %s", topicName);
-    NS_LOG_V(INFO_PRIVATE, "curr->id = %s", curr->id);
-    NS_LOG_V(DEBUG, "curr->topicName = %s", curr->topicName);
+    size_t mask = subscribers->size - 1;
+    size_t index = NSCacheHashString(cId) & mask;
 
-    if ( (strncmp(curr->id, cId, NS_UUID_STRING_SIZE) == 0) &&
-            (strcmp(curr->topicName, topicName) == 0) )
+    while (subscribers->ids[index][0] != '\0')
     {
-        if (del == conTopicList->head) // first object
+        if (strcmp(subscribers->ids[index], cId) == 0)
         {
-            if (del == conTopicList->tail) // first object (one object)
-            {
-                conTopicList->tail = del->next;
-            }
-
-            conTopicList->head = del->next;
-            NSProviderDeleteCacheData(type, del->data);
-            NSOICFree(del);
-            pthread_mutex_unlock(&NSCacheMutex);
-            return NS_OK;
+            return true;
         }
+        index = (index + 1) & mask;
     }
 
-    curr = NULL;
-    del = del->next;
+    return false;
+}
 
-    while (del)
+void NSProviderFreeTopicSubscribers(NSTopicSubscribers * subscribers)
+{
+    if (subscribers)
     {
-        curr = (NSCacheTopicSubData *) del->data;
-        if ( (strncmp(curr->id, cId, NS_UUID_STRING_SIZE) == 0) &&
-                (strcmp(curr->topicName, topicName) == 0) )
+        NSOICFree(subscribers->ids);
+        subscribers->size = 0;
+        subscribers->count = 0;
+    }
+}
+
+bool NSProviderNextSubscriberObId(void * context, OCObservationId * id)
+{
+    NSSubscriberIterator * subIter = (NSSubscriberIterator *) context;
+
+    while (subIter->iter)
+    {
+        NSCacheSubData * subData = (NSCacheSubData *) subIter->iter->data;
+        subIter->iter = subIter->iter->next;
+
+        int obId = subIter->sync ? subData->syncObId : subData->messageObId;
+
+        if (!subData->isWhite || obId == 0)
         {
-            if (del == conTopicList->tail) // delete object same to last object
-            {
-                conTopicList->tail = prev;
-            }
+            continue;
+        }
 
-            prev->next = del->next;
-            NSProviderDeleteCacheData(type, del->data);
-            NSOICFree(del);
-            pthread_mutex_unlock(&NSCacheMutex);
-            return NS_OK;
+        if (subIter->topicSubscribers &&
+                !NSProviderIsTopicSubscriber(subIter->topicSubscribers, subData->id))
+        {
+            continue;
         }
 
-        prev = del;
-        del = del->next;
+        NS_LOG_V(DEBUG, "SubScription WhiteList[%" PRIuPTR "] = %d", subIter->count, obId);
+        *id = (OCObservationId) obId;
+        subIter->count++;
+        return true;
     }
 
-    pthread_mutex_unlock(&NSCacheMutex);
-    return NS_FAIL;
+    return false;
+}
+
+NSResult NSProviderDeleteConsumerTopic(NSCacheList * conTopicList,
+        NSCacheTopicSubData * topicSubData)
+{
+    char * cId = topicSubData->id;
+    char * topicName = topicSubData->topicName;
+
+    if (!conTopicList || !cId || !topicName)
+    {
+        return NS_ERROR;
+    }
+
+    pthread_rwlock_wrlock(&NSCacheLock);
+
+    NS_LOG_V(INFO_PRIVATE, "compareid = %s", cId);
+    NS_LOG_V(DEBUG, "comparetopicName = %s", topicName);
+
+    NSCacheElement * del = NSFindConsumerTopic(conTopicList, cId, topicName);
+
+    if (!del)
+    {
+        pthread_rwlock_unlock(&NSCacheLock);
+        return NS_FAIL;
+    }
+
+    NSRemoveCacheElement(conTopicList, del);
+    pthread_rwlock_unlock(&NSCacheLock);
+    return NS_OK;
 }
@@ -161,7 +161,66 @@ NSTopicLL * NSProviderGetConsumerTopicsCacheData(NSCacheList * regTopicList,
  *
  * @return True if topic subscribed, otherwise false.
  */
-bool NSProviderIsTopicSubScribed(NSCacheElement * conTopicList, char * cId, char * topicName);
+bool NSProviderIsTopicSubScribed(NSCacheList * conTopicList, const char * cId,
+        const char * topicName);
+
+/** consumers subscribed to a topic, hashed by consumer Id */
+typedef struct
+{
+    char (* ids)[NS_UUID_STRING_SIZE];  /**< open addressed table of consumer Ids */
+    size_t size;                        /**< table size, a power of 2 */
+    size_t count;                       /**< number of consumer Ids */
+
+} NSTopicSubscribers;
+
+/** iterator over the observation Ids of the allowed subscribers */
+typedef struct
+{
+    NSCacheElement * iter;                /**< next subscriber to check */
+    bool sync;                            /**< iterate sync instead of message observer Ids */
+    NSTopicSubscribers * topicSubscribers; /**< subscribers of the topic, or NULL for all */
+    size_t count;                         /**< number of Ids returned */
+
+} NSSubscriberIterator;
+
+/**
+ * Get the consumers subscribed to a topic, with one pass over the consumer topic list.
+ *
+ * @param conTopicList  Consumer topic list.
+ * @param topicName     topic name.
+ * @param subscribers   set to the consumers; free with NSProviderFreeTopicSubscribers.
+ *
+ * @return OK if subscribers is set, otherwise ERROR.
+ */
+NSResult NSProviderGetTopicSubscribers(NSCacheList * conTopicList, const char * topicName,
+        NSTopicSubscribers * subscribers);
+
+/**
+ * Checks whether a consumer is in the subscribers of a topic.
+ *
+ * @param subscribers   subscribers of the topic.
+ * @param cId           consumer Id.
+ *
+ * @return True if topic subscribed, otherwise false.
+ */
+bool NSProviderIsTopicSubscriber(const NSTopicSubscribers * subscribers, const char * cId);
+
+/**
+ * Free the subscribers of a topic.
+ *
+ * @param subscribers   subscribers of the topic.
+ */
+void NSProviderFreeTopicSubscribers(NSTopicSubscribers * subscribers);
+
+/**
+ * Iterate over the observation Ids of the allowed subscribers, for OCNotifyObservers.
+ *
+ * @param context  ::NSSubscriberIterator.
+ * @param id       set to the next observation Id.
+ *
+ * @return True if id is set, false if there are no more subscribers.
+ */
+bool NSProviderNextSubscriberObId(void * context, OCObservationId * id);
 
 /**
  * Delete consumer topic from consumer topic list.
@@ -174,7 +233,6 @@ bool NSProviderIsTopicSubScribed(NSCacheElement * conTopicList, char * cId, char
 NSResult NSProviderDeleteConsumerTopic(NSCacheList * conTopicList,
         NSCacheTopicSubData * topicSubData);
 
-pthread_mutex_t NSCacheMutex;
-pthread_mutexattr_t NSCacheMutexAttr;
+pthread_rwlock_t NSCacheLock;
 
 #endif /* _NS_PROVIDER_CACHEADAPTER__H_ */
@@ -114,8 +114,6 @@ NSResult NSSendNotification(NSMessage *msg)
     NS_LOG(DEBUG, "NSSendMessage - IN");
 
     OCResourceHandle rHandle = NULL;
-    OCObservationId obArray[255] = { 0, };
-    size_t obCount = 0;
 
     if (NSPutMessageResource(msg, &rHandle) != NS_OK)
     {
@@ -146,46 +144,29 @@ NSResult NSSendNotification(NSMessage *msg)
         return NS_ERROR;
     }
 
-    NSCacheElement * it = consumerSubList->head;
+    NSTopicSubscribers topicSubscribers = { NULL, 0, 0 };
+    NSSubscriberIterator subIter = { consumerSubList->head, false, NULL, 0 };
 
-    while (it)
+    if (msg->topic && (msg->topic)[0] != '\0')
     {
-        NSCacheSubData * subData = (NSCacheSubData *) it->data;
-        NS_LOG_V(INFO_PRIVATE, "message subData->id = %s", subData->id);
-        NS_LOG_V(DEBUG, "subData->messageId = %d", subData->messageObId);
-        NS_LOG_V(DEBUG, "subData->syncId = %d", subData->syncObId);
-        NS_LOG_V(DEBUG, "subData->isWhite = %d", subData->isWhite);
+        NS_LOG_V(DEBUG, "this is topic message: %s", msg->topic);
 
-        if (subData->isWhite)
+        if (NSProviderGetTopicSubscribers(consumerTopicList, msg->topic,
+                    &topicSubscribers) != NS_OK)
         {
-            if(subData->messageObId != 0)
-            {
-                if (msg->topic && (msg->topic)[0] != '\0')
-                {
-                    NS_LOG_V(DEBUG, "this is topic message: %s", msg->topic);
-
-                    if (NSProviderIsTopicSubScribed(consumerTopicList->head, subData->id, msg->topic))
-                    {
-                        obArray[obCount++] = subData->messageObId;
-                    }
-                }
-                else
-                {
-                    obArray[obCount++] = subData->messageObId;
-                }
-            }
+            NS_LOG(ERROR, "fail to get topic subscribers");
+            OCRepPayloadDestroy(payload);
+            msg->extraInfo = NULL;
+            return NS_ERROR;
         }
-        it = it->next;
+        subIter.topicSubscribers = &topicSubscribers;
     }
 
-    for (size_t i = 0; i < obCount; ++i)
-    {
-        NS_LOG(DEBUG, "-------------------------------------------------------message\n");
-        NS_LOG_V(DEBUG, "SubScription WhiteList[%" PRIuPTR "] = %d", i, obArray[i]);
-        NS_LOG(DEBUG, "-------------------------------------------------------message\n");
-    }
+    OCStackResult ocstackResult = OCNotifyObservers(rHandle, NSProviderNextSubscriberObId,
+            &subIter, payload, OC_LOW_QOS);
+    NSProviderFreeTopicSubscribers(&topicSubscribers);
 
-    if (!obCount)
+    if (!subIter.count)
     {
         NS_LOG(ERROR, "observer count is zero");
         OCRepPayloadDestroy(payload);
@@ -193,9 +174,6 @@ NSResult NSSendNotification(NSMessage *msg)
         return NS_ERROR;
     }
 
-    OCStackResult ocstackResult = OCNotifyListOfObservers(rHandle, obArray, obCount, payload,
-            OC_LOW_QOS);
-
     NS_LOG_V(DEBUG, "Message ocstackResult = %d", ocstackResult);
 
     if (ocstackResult != OC_STACK_OK)
@@ -217,9 +195,6 @@ NSResult NSSendSync(NSSyncInfo *sync)
 {
     NS_LOG(DEBUG, "NSSendSync - IN");
 
-    OCObservationId obArray[255] = { 0, };
-    size_t obCount = 0;
-
     OCResourceHandle rHandle = NULL;
     if (NSPutSyncResource(sync, &rHandle) != NS_OK)
     {
@@ -227,26 +202,6 @@ NSResult NSSendSync(NSSyncInfo *sync)
         return NS_ERROR;
     }
 
-    NSCacheElement * it = consumerSubList->head;
-
-    while (it)
-    {
-        NSCacheSubData * subData = (NSCacheSubData *) it->data;
-        NS_LOG_V(INFO_PRIVATE, "sync subData->id = %s", subData->id);
-        NS_LOG_V(DEBUG, "subData->messageId = %d", subData->messageObId);
-        NS_LOG_V(DEBUG, "subData->syncId = %d", subData->syncObId);
-        NS_LOG_V(DEBUG, "subData->isWhite = %d", subData->isWhite);
-
-        if (subData->isWhite)
-        {
-            if (subData->syncObId != 0)
-            {
-                obArray[obCount++] = subData->syncObId;
-            }
-        }
-        it = it->next;
-    }
-
     OCRepPayload* payload = NULL;
     if (NSSetSyncPayload(sync, &payload) != NS_OK)
     {
@@ -274,15 +229,9 @@ NSResult NSSendSync(NSSyncInfo *sync)
     }
 #endif
 
-    for (size_t i = 0; i < obCount; ++i)
-    {
-        NS_LOG(DEBUG, "-------------------------------------------------------message\n");
-        NS_LOG_V(DEBUG, "Sync WhiteList[%" PRIuPTR "] = %d", i, obArray[i]);
-        NS_LOG(DEBUG, "-------------------------------------------------------message\n");
-    }
-
-    OCStackResult ocstackResult = OCNotifyListOfObservers(rHandle, obArray,
-            obCount, payload, OC_LOW_QOS);
+    NSSubscriberIterator subIter = { consumerSubList->head, true, NULL, 0 };
+    OCStackResult ocstackResult = OCNotifyObservers(rHandle, NSProviderNextSubscriberObId,
+            &subIter, payload, OC_LOW_QOS);
 
     NS_LOG_V(DEBUG, "Sync ocstackResult = %d", ocstackResult);
     if (ocstackResult != OC_STACK_OK)
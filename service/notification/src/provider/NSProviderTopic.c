@@ -141,35 +141,18 @@ NSResult NSSendTopicUpdation(void)
     OCRepPayloadSetPropInt(payload, NS_ATTRIBUTE_MESSAGE_ID, NS_TOPIC);
     OCRepPayloadSetPropString(payload, NS_ATTRIBUTE_PROVIDER_ID, NSGetProviderInfo()->providerId);
 
-    OCObservationId obArray[255] =
-    { 0, };
-    size_t obCount = 0;
+    NSSubscriberIterator subIter = { consumerSubList->head, false, NULL, 0 };
+    OCStackResult ocstackResult = OCNotifyObservers(rHandle, NSProviderNextSubscriberObId,
+            &subIter, payload, OC_HIGH_QOS);
 
-    NSCacheElement * it = consumerSubList->head;
-
-    while (it)
-    {
-        NSCacheSubData * subData = (NSCacheSubData *) it->data;
-
-        if (subData->isWhite)
-        {
-            if (subData->messageObId != 0)
-            {
-                obArray[obCount++] = subData->messageObId;
-            }
-        }
-
-        it = it->next;
-    }
-
-    if (!obCount)
+    if (!subIter.count)
     {
         NS_LOG(ERROR, "observer count is zero");
         OCRepPayloadDestroy(payload);
         return NS_ERROR;
     }
 
-    if (OCNotifyListOfObservers(rHandle, obArray, obCount, payload, OC_HIGH_QOS) != OC_STACK_OK)
+    if (ocstackResult != OC_STACK_OK)
     {
         NS_LOG(ERROR, "fail to send topic updation");
         OCRepPayloadDestroy(payload);
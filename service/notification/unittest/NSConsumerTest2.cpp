@@ -24,10 +24,13 @@
 #include <condition_variable>
 #include <mutex>
 #include <chrono>
+#include <string>
+#include <vector>
 
 #include "OCPlatform.h"
 #include "octypes.h"
 #include "ocstack.h"
+#include "oic_malloc.h"
 #include "oic_string.h"
 #include "ocpayload.h"
 #include "cainterface.h"
@@ -643,3 +646,123 @@ TEST(NotificationConsumerTest, ExpectUnsubscribeWithPresenceStop)
 
     stackTearDown();
 }
+
+// Index of the provider cache by connection address, as in NSConsumerMemoryCache.c.
+#define NS_CACHE_INDEX_ADDRESS 1
+
+namespace
+{
+    std::string cacheProviderId(int i)
+    {
+        char id[NS_DEVICE_ID_LENGTH] = { 0, };
+        snprintf(id, sizeof(id), "%08d-0000-0000-0000-000000000000", i);
+        return id;
+    }
+
+    OCDevAddr cacheAddr(int host, uint16_t port)
+    {
+        OCDevAddr addr = {};
+        addr.adapter = OC_ADAPTER_IP;
+        addr.flags = OC_IP_USE_V4;
+        addr.port = port;
+        snprintf(addr.addr, sizeof(addr.addr), "10.0.0.%d", host);
+        return addr;
+    }
+
+    // Write a provider with a connection for each of the addresses to the cache.
+    NSResult writeCacheProvider(NSCacheList * list, const std::string & id,
+            std::vector<OCDevAddr> addrs)
+    {
+        NSProvider_internal * provider =
+                (NSProvider_internal *) OICCalloc(1, sizeof(NSProvider_internal));
+        EXPECT_NE((void *)NULL, provider);
+        OICStrcpy(provider->providerId, NS_DEVICE_ID_LENGTH, id.c_str());
+
+        NSProviderConnectionInfo ** last = &provider->connection;
+        for (OCDevAddr & addr : addrs)
+        {
+            *last = NSCreateProviderConnections(&addr);
+            last = &(*last)->next;
+        }
+
+        NSCacheElement element = { (NSCacheData *) provider, NULL, NULL };
+        NSResult result = NSConsumerCacheWriteProvider(list, &element);
+        NSRemoveProvider_internal(provider);
+        return result;
+    }
+
+    const char * cacheProviderIdFromAddr(NSCacheList * list, const OCDevAddr & addr)
+    {
+        NSCacheElement * element = NSGetProviderFromAddr(list, addr.addr, addr.port);
+        return element ? ((NSProvider_internal *) element->data)->providerId : NULL;
+    }
+}
+
+// Connections appended to a cached provider are indexed by their address, and are
+// unindexed with the provider.
+TEST(NotificationConsumerCacheTest, AppendedConnectionsAreIndexedByAddress)
+{
+    NSCacheList * list = NSConsumerStorageCreate();
+    ASSERT_NE((void *)NULL, list);
+    list->cacheType = NS_CONSUMER_CACHE_PROVIDER;
+
+    ASSERT_EQ(NS_OK, writeCacheProvider(list, cacheProviderId(1), { cacheAddr(1, 5683) }));
+    ASSERT_EQ(NS_OK, writeCacheProvider(list, cacheProviderId(2), { cacheAddr(2, 5683) }));
+    ASSERT_EQ(NS_OK, writeCacheProvider(list, cacheProviderId(1),
+            { cacheAddr(3, 5683), cacheAddr(1, 5684) }));
+
+    EXPECT_EQ(4u, list->index[NS_CACHE_INDEX_ADDRESS].count);
+    EXPECT_STREQ(cacheProviderId(1).c_str(), cacheProviderIdFromAddr(list, cacheAddr(1, 5683)));
+    EXPECT_STREQ(cacheProviderId(1).c_str(), cacheProviderIdFromAddr(list, cacheAddr(3, 5683)));
+    EXPECT_STREQ(cacheProviderId(1).c_str(), cacheProviderIdFromAddr(list, cacheAddr(1, 5684)));
+    EXPECT_STREQ(cacheProviderId(2).c_str(), cacheProviderIdFromAddr(list, cacheAddr(2, 5683)));
+    EXPECT_EQ((void *)NULL, cacheProviderIdFromAddr(list, cacheAddr(2, 5684)));
+
+    EXPECT_EQ(NS_OK, NSConsumerStorageDelete(list, cacheProviderId(1).c_str()));
+    EXPECT_EQ(1u, list->index[NS_CACHE_INDEX_ADDRESS].count);
+    EXPECT_EQ((void *)NULL, cacheProviderIdFromAddr(list, cacheAddr(1, 5683)));
+    EXPECT_EQ((void *)NULL, cacheProviderIdFromAddr(list, cacheAddr(3, 5683)));
+    EXPECT_EQ((void *)NULL, cacheProviderIdFromAddr(list, cacheAddr(1, 5684)));
+    EXPECT_EQ((void *)NULL, NSConsumerStorageRead(list, cacheProviderId(1).c_str()));
+    EXPECT_STREQ(cacheProviderId(2).c_str(), cacheProviderIdFromAddr(list, cacheAddr(2, 5683)));
+
+    NSConsumerStorageDestroy(list);
+}
+
+// Providers popped from the cache are no longer found by Id or by address.
+TEST(NotificationConsumerCacheTest, PopUnindexesProvider)
+{
+    const int count = 20;
+    NSCacheList * list = NSConsumerStorageCreate();
+    ASSERT_NE((void *)NULL, list);
+    list->cacheType = NS_CONSUMER_CACHE_PROVIDER;
+
+    for (int i = 0; i < count; i++)
+    {
+        ASSERT_EQ(NS_OK, writeCacheProvider(list, cacheProviderId(i),
+                { cacheAddr(i, 5683), cacheAddr(i, 5684) }));
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        NSCacheElement * element = NSPopProviderCacheList(list);
+        ASSERT_NE((void *)NULL, element);
+        NSProvider_internal * provider = (NSProvider_internal *) element->data;
+        EXPECT_STREQ(cacheProviderId(i).c_str(), provider->providerId);
+
+        EXPECT_EQ((void *)NULL, NSConsumerStorageRead(list, provider->providerId));
+        EXPECT_EQ((void *)NULL, cacheProviderIdFromAddr(list, cacheAddr(i, 5683)));
+        EXPECT_EQ((void *)NULL, cacheProviderIdFromAddr(list, cacheAddr(i, 5684)));
+        EXPECT_EQ((size_t) (count - i - 1) * 2, list->index[NS_CACHE_INDEX_ADDRESS].count);
+        if (i + 1 < count)
+        {
+            EXPECT_NE((void *)NULL, NSConsumerStorageRead(list, cacheProviderId(i + 1).c_str()));
+        }
+
+        NSRemoveProvider_internal(provider);
+        OICFree(element);
+    }
+    EXPECT_EQ((void *)NULL, NSPopProviderCacheList(list));
+
+    NSConsumerStorageDestroy(list);
+}
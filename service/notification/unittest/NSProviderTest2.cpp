@@ -23,6 +23,7 @@
 #include <condition_variable>
 #include <mutex>
 #include <chrono>
+#include <set>
 
 #include "OCPlatform.h"
 #include "ocpayload.h"
@@ -536,3 +537,182 @@ TEST(NotificationProviderTest, ExpectSuccessUnsub)
 
     NSStopProvider();
 }
+
+// Indexes of the provider caches, as in NSProviderMemoryCache.c.
+#define NS_CACHE_INDEX_CONSUMER_ID 0
+#define NS_CACHE_INDEX_TOPIC_NAME 1
+
+namespace
+{
+    NSCacheElement * createSubscriberElement(const std::string & id)
+    {
+        NSCacheSubData * subData = (NSCacheSubData *) OICCalloc(1, sizeof(NSCacheSubData));
+        OICStrcpy(subData->id, NS_UUID_STRING_SIZE, id.c_str());
+        NSCacheElement * element = (NSCacheElement *) OICCalloc(1, sizeof(NSCacheElement));
+        element->data = (NSCacheData *) subData;
+        return element;
+    }
+
+    NSCacheElement * createConsumerTopicElement(const std::string & id, const std::string & topic)
+    {
+        NSCacheTopicSubData * topicData =
+                (NSCacheTopicSubData *) OICCalloc(1, sizeof(NSCacheTopicSubData));
+        OICStrcpy(topicData->id, NS_UUID_STRING_SIZE, id.c_str());
+        topicData->topicName = OICStrdup(topic.c_str());
+        NSCacheElement * element = (NSCacheElement *) OICCalloc(1, sizeof(NSCacheElement));
+        element->data = (NSCacheData *) topicData;
+        return element;
+    }
+
+    size_t cacheListSize(NSCacheList * list)
+    {
+        size_t size = 0;
+        for (NSCacheElement * iter = list->head; iter; iter = iter->next)
+        {
+            size++;
+        }
+        return size;
+    }
+
+    std::string consumerId(int i)
+    {
+        char id[NS_UUID_STRING_SIZE] = { 0, };
+        snprintf(id, sizeof(id), "%08d-0000-0000-0000-000000000000", i);
+        return id;
+    }
+}
+
+// Entries of different elements with the same hash are all found, in a chain that
+// survives the index growing, and removing one leaves the others.
+TEST(NotificationProviderCacheTest, IndexFindsAllEntriesWithCollidingHash)
+{
+    const uint32_t hash = 0x1234;
+    const size_t count = 100;
+    NSCacheIndex index = { NULL, 0, 0 };
+    NSCacheElement elements[count];
+
+    for (size_t i = 0; i < count; i++)
+    {
+        // Every tenth element has the hash. The others have other hashes in the same
+        // bucket, which are skipped.
+        uint32_t elementHash = (i % 10) ? hash + (uint32_t) (i << 16) : hash;
+        ASSERT_EQ(NS_OK, NSCacheIndexAdd(&index, elementHash, &elements[i]));
+    }
+    EXPECT_EQ(count, index.count);
+
+    std::set<NSCacheElement *> found;
+    for (NSCacheIndexEntry * entry = NSCacheIndexFind(&index, hash); entry;
+            entry = NSCacheIndexFindNext(entry))
+    {
+        EXPECT_EQ(hash, entry->hash);
+        found.insert(entry->element);
+    }
+    EXPECT_EQ(count / 10, found.size());
+    for (size_t i = 0; i < count; i += 10)
+    {
+        EXPECT_EQ(1u, found.count(&elements[i])) << "element " << i;
+    }
+
+    NSCacheIndexRemove(&index, hash, &elements[50]);
+    found.clear();
+    for (NSCacheIndexEntry * entry = NSCacheIndexFind(&index, hash); entry;
+            entry = NSCacheIndexFindNext(entry))
+    {
+        found.insert(entry->element);
+    }
+    EXPECT_EQ(count / 10 - 1, found.size());
+    EXPECT_EQ(0u, found.count(&elements[50]));
+    EXPECT_EQ(count - 1, index.count);
+
+    EXPECT_EQ((void *) NULL, NSCacheIndexFind(&index, hash + 1));
+    NSCacheIndexDestroy(&index);
+}
+
+// Deleted subscribers are removed from the consumer Id index as well as the list.
+TEST(NotificationProviderCacheTest, DeleteUnindexesSubscriber)
+{
+    const int count = 40;
+    NSCacheList * list = NSProviderStorageCreate();
+    ASSERT_NE((void *) NULL, list);
+    list->cacheType = NS_PROVIDER_CACHE_SUBSCRIBER;
+
+    for (int i = 0; i < count; i++)
+    {
+        ASSERT_EQ(NS_OK, NSProviderStorageWrite(list, createSubscriberElement(consumerId(i))));
+    }
+    EXPECT_EQ((size_t) count, list->index[NS_CACHE_INDEX_CONSUMER_ID].count);
+
+    for (int i = 0; i < count; i += 2)
+    {
+        EXPECT_EQ(NS_OK, NSProviderStorageDelete(list, consumerId(i).c_str()));
+        EXPECT_EQ(NS_FAIL, NSProviderStorageDelete(list, consumerId(i).c_str()));
+    }
+    EXPECT_EQ((size_t) count / 2, list->index[NS_CACHE_INDEX_CONSUMER_ID].count);
+    EXPECT_EQ((size_t) count / 2, cacheListSize(list));
+
+    for (int i = 0; i < count; i++)
+    {
+        NSCacheElement * element = NSProviderStorageRead(list, consumerId(i).c_str());
+        if (i % 2)
+        {
+            ASSERT_NE((void *) NULL, element);
+            EXPECT_STREQ(consumerId(i).c_str(), ((NSCacheSubData *) element->data)->id);
+        }
+        else
+        {
+            EXPECT_EQ((void *) NULL, element);
+        }
+    }
+
+    // A subscriber written again after its deletion is indexed once.
+    ASSERT_EQ(NS_OK, NSProviderStorageWrite(list, createSubscriberElement(consumerId(0))));
+    EXPECT_NE((void *) NULL, NSProviderStorageRead(list, consumerId(0).c_str()));
+    EXPECT_EQ((size_t) count / 2 + 1, list->index[NS_CACHE_INDEX_CONSUMER_ID].count);
+
+    NSProviderStorageDestroy(list);
+}
+
+// A consumer subscribes to a topic once: the duplicate is the same consumer Id and
+// topic name, not either of them alone.
+TEST(NotificationProviderCacheTest, ConsumerTopicDuplicateIsConsumerAndTopic)
+{
+    NSCacheList * list = NSProviderStorageCreate();
+    ASSERT_NE((void *) NULL, list);
+    list->cacheType = NS_PROVIDER_CACHE_CONSUMER_TOPIC_NAME;
+
+    EXPECT_EQ(NS_OK, NSProviderStorageWrite(list,
+            createConsumerTopicElement(consumerId(1), "TOPIC1")));
+    EXPECT_EQ(NS_OK, NSProviderStorageWrite(list,
+            createConsumerTopicElement(consumerId(1), "TOPIC2")));
+    EXPECT_EQ(NS_OK, NSProviderStorageWrite(list,
+            createConsumerTopicElement(consumerId(2), "TOPIC1")));
+    EXPECT_EQ(NS_FAIL, NSProviderStorageWrite(list,
+            createConsumerTopicElement(consumerId(1), "TOPIC1")));
+    EXPECT_EQ(NS_FAIL, NSProviderStorageWrite(list,
+            createConsumerTopicElement(consumerId(2), "TOPIC1")));
+    EXPECT_EQ(3u, cacheListSize(list));
+
+    EXPECT_TRUE(NSProviderIsTopicSubScribed(list, consumerId(1).c_str(), "TOPIC2"));
+    EXPECT_FALSE(NSProviderIsTopicSubScribed(list, consumerId(2).c_str(), "TOPIC2"));
+
+    // Deleting by topic name removes the subscriptions of every consumer to the topic
+    // and unindexes them by both keys.
+    int deleted = 0;
+    while (NSProviderStorageDelete(list, "TOPIC1") != NS_FAIL)
+    {
+        deleted++;
+    }
+    EXPECT_EQ(2, deleted);
+    EXPECT_EQ(1u, cacheListSize(list));
+    EXPECT_EQ(1u, list->index[NS_CACHE_INDEX_CONSUMER_ID].count);
+    EXPECT_EQ(1u, list->index[NS_CACHE_INDEX_TOPIC_NAME].count);
+    EXPECT_FALSE(NSProviderIsTopicSubScribed(list, consumerId(1).c_str(), "TOPIC1"));
+    EXPECT_TRUE(NSProviderIsTopicSubScribed(list, consumerId(1).c_str(), "TOPIC2"));
+
+    // A deleted subscription may be written again.
+    EXPECT_EQ(NS_OK, NSProviderStorageWrite(list,
+            createConsumerTopicElement(consumerId(2), "TOPIC1")));
+    EXPECT_TRUE(NSProviderIsTopicSubScribed(list, consumerId(2).c_str(), "TOPIC1"));
+
+    NSProviderStorageDestroy(list);
+}
@@ -0,0 +1,216 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include "BundleExecutor.h"
+
+#include <algorithm>
+#include <exception>
+
+#include "InternalTypes.h"
+
+namespace OIC
+{
+    namespace Service
+    {
+        BundleExecutor::BundleExecutor(size_t numThreads, size_t maxQueueDepth)
+            : m_maxQueueDepth(maxQueueDepth), m_stopped(false), m_metrics()
+        {
+            numThreads = std::max<size_t>(numThreads, 1);
+            for (size_t i = 0; i < numThreads; i++)
+            {
+                m_threads.emplace_back(&BundleExecutor::run, this);
+            }
+        }
+
+        BundleExecutor::~BundleExecutor()
+        {
+            stop();
+        }
+
+        bool BundleExecutor::post(const std::string &key, Task task)
+        {
+            return enqueue(key, std::move(task), false);
+        }
+
+        bool BundleExecutor::postCoalesced(const std::string &key, Task task)
+        {
+            return enqueue(key, std::move(task), true);
+        }
+
+        bool BundleExecutor::enqueue(const std::string &key, Task &&task, bool coalesced)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (m_stopped)
+            {
+                return false;
+            }
+
+            KeyQueue &keyQueue = m_keyQueues[key];
+            if (coalesced && keyQueue.coalescedPending)
+            {
+                m_metrics.coalesced++;
+                return true;
+            }
+
+            if (m_metrics.queueDepth >= m_maxQueueDepth)
+            {
+                m_metrics.rejected++;
+                if (keyQueue.tasks.empty() && !keyQueue.running)
+                {
+                    m_keyQueues.erase(key);
+                }
+                OIC_LOG_V(ERROR, CONTAINER_TAG, "Executor full, task for (%s) dropped",
+                          key.c_str());
+                return false;
+            }
+
+            keyQueue.tasks.emplace_back(std::move(task), coalesced);
+            keyQueue.coalescedPending |= coalesced;
+            if (keyQueue.tasks.size() == 1 && !keyQueue.running)
+            {
+                m_readyKeys.push_back(key);
+                m_cond.notify_one();
+            }
+
+            m_metrics.queueDepth++;
+            m_metrics.maxQueueDepth = std::max(m_metrics.maxQueueDepth, m_metrics.queueDepth);
+            return true;
+        }
+
+        void BundleExecutor::stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_stopped)
+                {
+                    return;
+                }
+                m_stopped = true;
+            }
+            m_cond.notify_all();
+
+            for (auto &thread : m_threads)
+            {
+                if (!thread.joinable())
+                {
+                    continue;
+                }
+
+                if (thread.get_id() == std::this_thread::get_id())
+                {
+                    // stopped by one of its tasks, which returns to the loop and ends
+                    thread.detach();
+                }
+                else
+                {
+                    thread.join();
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_keyQueues.clear();
+            m_readyKeys.clear();
+            m_metrics.queueDepth = 0;
+        }
+
+        BundleExecutor::Metrics BundleExecutor::getMetrics() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_metrics;
+        }
+
+        void BundleExecutor::run()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            while (true)
+            {
+                m_cond.wait(lock, [this]()
+                {
+                    return m_stopped || !m_readyKeys.empty();
+                });
+
+                if (m_stopped)
+                {
+                    return;
+                }
+
+                std::string key = std::move(m_readyKeys.front());
+                m_readyKeys.pop_front();
+
+                KeyQueue &keyQueue = m_keyQueues[key];
+                Task task = std::move(keyQueue.tasks.front().first);
+                if (keyQueue.tasks.front().second)
+                {
+                    keyQueue.coalescedPending = false;
+                }
+                keyQueue.tasks.pop_front();
+                keyQueue.running = true;
+                m_metrics.queueDepth--;
+
+                lock.unlock();
+
+                auto start = std::chrono::steady_clock::now();
+                try
+                {
+                    task();
+                }
+                catch (const std::exception &e)
+                {
+                    OIC_LOG_V(ERROR, CONTAINER_TAG, "Task for (%s) failed: %s",
+                              key.c_str(), e.what());
+                }
+                catch (...)
+                {
+                    OIC_LOG_V(ERROR, CONTAINER_TAG, "Task for (%s) failed", key.c_str());
+                }
+                auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+                                   std::chrono::steady_clock::now() - start);
+
+                // release what the task holds before taking the lock again
+                task = nullptr;
+
+                lock.lock();
+
+                m_metrics.completed++;
+                m_metrics.totalLatency += latency;
+                m_metrics.maxLatency = std::max(m_metrics.maxLatency, latency);
+
+                if (m_stopped)
+                {
+                    return;
+                }
+
+                KeyQueue &doneQueue = m_keyQueues[key];
+                doneQueue.running = false;
+                if (doneQueue.tasks.empty())
+                {
+                    m_keyQueues.erase(key);
+                }
+                else
+                {
+                    m_readyKeys.push_back(key);
+                    m_cond.notify_one();
+                }
+            }
+        }
+    }
+}
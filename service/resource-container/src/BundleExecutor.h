@@ -0,0 +1,113 @@
+//******************************************************************
+//
+// Copyright 2017 Open Connectivity Foundation All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#ifndef BUNDLEEXECUTOR_H_
+#define BUNDLEEXECUTOR_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace OIC
+{
+    namespace Service
+    {
+        /**
+        * Runs the callbacks of bundle resources on a fixed set of threads.
+        *
+        * Tasks posted with the same key, the URI of a resource, run one at a time in the
+        * order they were posted; tasks of different keys run in parallel. The number of
+        * queued tasks is bounded, posting to a full executor fails.
+        */
+        class BundleExecutor
+        {
+            public:
+                typedef std::function<void()> Task;
+
+                struct Metrics
+                {
+                    size_t queueDepth;                      // tasks waiting to run
+                    size_t maxQueueDepth;                   // highest queueDepth seen
+                    uint64_t completed;                     // tasks run
+                    uint64_t rejected;                      // tasks not queued, executor full
+                    uint64_t coalesced;                     // tasks merged into a queued one
+                    std::chrono::microseconds totalLatency; // run time of all tasks
+                    std::chrono::microseconds maxLatency;   // longest run time of a task
+                };
+
+                BundleExecutor(size_t numThreads, size_t maxQueueDepth);
+                BundleExecutor(const BundleExecutor &) = delete;
+                BundleExecutor &operator=(const BundleExecutor &) = delete;
+                ~BundleExecutor();
+
+                /**
+                * Queue a task behind the other tasks of the key.
+                *
+                * @return false if the executor is full or stopped, the task is dropped then.
+                */
+                bool post(const std::string &key, Task task);
+
+                /**
+                * Queue a task unless a coalesced task of the key is still waiting to run,
+                * for tasks that only need to run once after the latest change, e.g.
+                * notifications of observers.
+                *
+                * @return false if the executor is full or stopped, the task is dropped then.
+                */
+                bool postCoalesced(const std::string &key, Task task);
+
+                /**
+                * Discard waiting tasks and join the threads, after the running tasks return.
+                */
+                void stop();
+
+                Metrics getMetrics() const;
+
+            private:
+                struct KeyQueue
+                {
+                    std::deque<std::pair<Task, bool>> tasks; // task, coalesced
+                    bool running = false;
+                    bool coalescedPending = false;
+                };
+
+                bool enqueue(const std::string &key, Task &&task, bool coalesced);
+                void run();
+
+                mutable std::mutex m_mutex;
+                std::condition_variable m_cond;
+                std::map<std::string, KeyQueue> m_keyQueues;
+                std::deque<std::string> m_readyKeys; // keys with tasks and none running
+                std::vector<std::thread> m_threads;
+                size_t m_maxQueueDepth;
+                bool m_stopped;
+                Metrics m_metrics;
+        };
+    }
+}
+
+#endif // BUNDLEEXECUTOR_H_
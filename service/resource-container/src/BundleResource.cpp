@@ -23,10 +23,10 @@
 #include <list>
 #include <string.h>
 #include <iostream>
-#include <boost/thread.hpp>
 #include "NotificationReceiver.h"
 
 #include "InternalTypes.h"
+#include "ResourceContainerImpl.h"
 
 namespace OIC
 {
@@ -94,7 +94,7 @@ namespace OIC
                     }
                 };
                 auto f = std::bind(notifyFunc, m_pNotiReceiver, m_uri);
-                boost::thread notifyThread(f);
+                ResourceContainerImpl::getImplInstance()->getExecutor().postCoalesced(m_uri, f);
             }
 
         }
@@ -119,7 +119,7 @@ namespace OIC
                     }
                 };
                 auto f = std::bind(notifyFunc, m_pNotiReceiver, m_uri);
-                boost::thread notifyThread(f);
+                ResourceContainerImpl::getImplInstance()->getExecutor().postCoalesced(m_uri, f);
             }
 
         }
@@ -29,6 +29,7 @@
 #include <thread>
 #include <mutex>
 #include <algorithm>
+#include <future>
 
 #include "BundleActivator.h"
 #include "SoftSensorResource.h"
@@ -42,6 +43,7 @@ namespace OIC
     namespace Service
     {
         ResourceContainerImpl::ResourceContainerImpl()
+            : m_executor(BUNDLE_EXECUTOR_THREADS, BUNDLE_EXECUTOR_MAX_QUEUE_DEPTH)
         {
             m_config = nullptr;
         }
@@ -151,6 +153,16 @@ namespace OIC
             {
                 delete m_config;
             }
+
+            BundleExecutor::Metrics metrics = m_executor.getMetrics();
+            OIC_LOG_V(INFO, CONTAINER_TAG,
+                      "Bundle tasks: %llu completed, %llu rejected, %llu coalesced, "
+                      "max queue depth %" PRIuPTR ", max latency %lld us",
+                      (unsigned long long) metrics.completed,
+                      (unsigned long long) metrics.rejected,
+                      (unsigned long long) metrics.coalesced, metrics.maxQueueDepth,
+                      (long long) metrics.maxLatency.count());
+            (void) metrics;
             activationLock.unlock();
         }
 
@@ -427,15 +439,20 @@ namespace OIC
             if (m_mapServers.find(strResourceUri) != m_mapServers.end()
                 && m_mapResources.find(strResourceUri) != m_mapResources.end())
             {
-                if (m_mapResources[strResourceUri])
+                BundleResource::Ptr resource = m_mapResources[strResourceUri];
+                if (resource)
                 {
-                    auto getFunction = [this, &attr, &strResourceUri, queryParams]()
+                    auto result = std::make_shared< std::promise< RCSResourceAttributes > >();
+                    std::future< RCSResourceAttributes > future = result->get_future();
+
+                    auto getFunction = [resource, queryParams, result]()
                     {
-                        attr = m_mapResources[strResourceUri]->handleGetAttributesRequest(queryParams);
+                        result->set_value(resource->handleGetAttributesRequest(queryParams));
                     };
-                    boost::thread getThread(getFunction);
-                    getThread.timed_join(boost::posix_time::seconds(BUNDLE_SET_GET_WAIT_SEC));
-
+                    if (m_executor.post(strResourceUri, getFunction))
+                    {
+                        waitForBundleResult(future, strResourceUri, &attr);
+                    }
                 }
             }
             OIC_LOG_V(INFO, CONTAINER_TAG, "Container get request for %s finished, %" PRIuPTR " attributes",strResourceUri.c_str(), attr.size());
@@ -447,7 +464,6 @@ namespace OIC
                 const RCSResourceAttributes &attributes)
         {
             RCSResourceAttributes attr;
-            std::list<std::string> lstAttributes;
             std::string strResourceUri = request.getResourceUri();
             const std::map< std::string, std::string > &queryParams  = request.getQueryParams();
 
@@ -456,11 +472,16 @@ namespace OIC
             if (m_mapServers.find(strResourceUri) != m_mapServers.end()
                 && m_mapResources.find(strResourceUri) != m_mapResources.end())
             {
-                if (m_mapResources[strResourceUri])
+                BundleResource::Ptr resource = m_mapResources[strResourceUri];
+                if (resource)
                 {
-                    auto setFunction = [this, &lstAttributes, &strResourceUri, &attributes, &attr, queryParams]()
+                    auto result = std::make_shared< std::promise< RCSResourceAttributes > >();
+                    std::future< RCSResourceAttributes > future = result->get_future();
+
+                    auto setFunction = [resource, attributes, queryParams, result]()
                     {
-                        lstAttributes = m_mapResources[strResourceUri]->getAttributeNames();
+                        RCSResourceAttributes attr;
+                        std::list< std::string > lstAttributes = resource->getAttributeNames();
 
                         for (RCSResourceAttributes::const_iterator itor = attributes.begin();
                              itor != attributes.end(); itor++)
@@ -473,10 +494,13 @@ namespace OIC
                         }
 
                         OIC_LOG_V(INFO, CONTAINER_TAG, "Calling handleSetAttributeRequest");
-                        m_mapResources[strResourceUri]->handleSetAttributesRequest(attr, queryParams);
+                        resource->handleSetAttributesRequest(attr, queryParams);
+                        result->set_value(std::move(attr));
                     };
-                    boost::thread setThread(setFunction);
-                    setThread.timed_join(boost::posix_time::seconds(BUNDLE_SET_GET_WAIT_SEC));
+                    if (m_executor.post(strResourceUri, setFunction))
+                    {
+                        waitForBundleResult(future, strResourceUri, &attr);
+                    }
                 }
             }
 
@@ -494,6 +518,38 @@ namespace OIC
             }
         }
 
+        BundleExecutor &ResourceContainerImpl::getExecutor()
+        {
+            return m_executor;
+        }
+
+        BundleExecutor::Metrics ResourceContainerImpl::getExecutorMetrics() const
+        {
+            return m_executor.getMetrics();
+        }
+
+        void ResourceContainerImpl::waitForBundleResult(std::future< RCSResourceAttributes > &future,
+                const std::string &strResourceUri, RCSResourceAttributes *attr)
+        {
+            if (future.wait_for(std::chrono::seconds(BUNDLE_SET_GET_WAIT_SEC))
+                != std::future_status::ready)
+            {
+                OIC_LOG_V(ERROR, CONTAINER_TAG, "Request for %s timed out",
+                          strResourceUri.c_str());
+                return;
+            }
+
+            try
+            {
+                *attr = future.get();
+            }
+            catch (const std::exception &e)
+            {
+                OIC_LOG_V(ERROR, CONTAINER_TAG, "Request for %s failed: %s",
+                          strResourceUri.c_str(), e.what());
+            }
+        }
+
         ResourceContainerImpl *ResourceContainerImpl::getImplInstance()
         {
             static ResourceContainerImpl m_instance;
@@ -30,19 +30,20 @@
 #include "RCSResourceObject.h"
 
 #include "DiscoverResourceUnit.h"
-
-#include <boost/thread.hpp>
-#include <boost/date_time.hpp>
+#include "BundleExecutor.h"
 
 #if(JAVA_SUPPORT)
 #include <jni.h>
 #endif
 
+#include <future>
 #include <map>
 
 #define BUNDLE_ACTIVATION_WAIT_SEC 10
 #define BUNDLE_SET_GET_WAIT_SEC 10
 #define BUNDLE_PATH_MAXLEN 300
+#define BUNDLE_EXECUTOR_THREADS 4
+#define BUNDLE_EXECUTOR_MAX_QUEUE_DEPTH 1024
 
 using namespace OIC::Service;
 
@@ -73,6 +74,10 @@ namespace OIC
 
                 void onNotificationReceived(const std::string &strResourceUri);
 
+                // runs the get, set and notification callbacks of bundle resources
+                BundleExecutor &getExecutor();
+                BundleExecutor::Metrics getExecutorMetrics() const;
+
                 static ResourceContainerImpl *getImplInstance();
                 static RCSResourceObject::Ptr buildResourceObject(const std::string &strUri,
                         const std::string &strResourceType, const std::string &strInterface);
@@ -112,6 +117,7 @@ namespace OIC
                 // used to synchronize the startup of the container with other operation
                 // such as individual bundle activation
                 std::recursive_mutex activationLock;
+                BundleExecutor m_executor;
 
                 ResourceContainerImpl();
                 virtual ~ResourceContainerImpl();
@@ -131,6 +137,9 @@ namespace OIC
                 void discoverInputResource(const std::string &outputResourceUri);
                 void undiscoverInputResource(const std::string &outputResourceUri);
                 void activateBundleThread(const std::string &bundleId);
+                void waitForBundleResult(std::future< RCSResourceAttributes > &future,
+                                         const std::string &strResourceUri,
+                                         RCSResourceAttributes *attr);
 
                 void activateBundle(shared_ptr<RCSBundleInfo> bundleInfo);
                 void deactivateBundle(shared_ptr<RCSBundleInfo> bundleInfo);
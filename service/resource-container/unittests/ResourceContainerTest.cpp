@@ -25,6 +25,7 @@
 #endif
 
 #include <algorithm>
+#include <future>
 
 #include <UnitTestHelper.h>
 
@@ -548,6 +549,58 @@ class ResourceContainerImplTest: public TestWithMock
 };
 
 
+/* Test for BundleExecutor */
+TEST(BundleExecutorTest, TasksOfSameResourceRunInPostedOrder)
+{
+    BundleExecutor executor(4, 1000);
+    std::mutex mutex;
+    std::vector< int > order;
+
+    for (int i = 0; i < 100; i++)
+    {
+        executor.post("/softsensor/1", [&mutex, &order, i]()
+        {
+            std::lock_guard< std::mutex > lock(mutex);
+            order.push_back(i);
+        });
+    }
+    while (executor.getMetrics().completed < 100)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::lock_guard< std::mutex > lock(mutex);
+    EXPECT_EQ(100u, order.size());
+    EXPECT_TRUE(std::is_sorted(order.begin(), order.end()));
+}
+
+TEST(BundleExecutorTest, TasksRejectedAndCoalescedWhenExecutorBusy)
+{
+    BundleExecutor executor(1, 2);
+    std::promise< void > started;
+    std::promise< void > release;
+    std::shared_future< void > released = release.get_future().share();
+
+    executor.post("/softsensor/1", [&started, released]()
+    {
+        started.set_value();
+        released.wait();
+    });
+    started.get_future().wait();
+
+    EXPECT_TRUE(executor.post("/softsensor/1", []() {}));
+    EXPECT_TRUE(executor.postCoalesced("/softsensor/2", []() {}));
+    EXPECT_TRUE(executor.postCoalesced("/softsensor/2", []() {}));
+    EXPECT_FALSE(executor.post("/softsensor/3", []() {}));
+
+    BundleExecutor::Metrics metrics = executor.getMetrics();
+    EXPECT_EQ(2u, metrics.queueDepth);
+    EXPECT_EQ(1u, metrics.rejected);
+    EXPECT_EQ(1u, metrics.coalesced);
+
+    release.set_value();
+}
+
 /* Test for Configuration */
 TEST(ConfigurationTest, ConfigFileLoadedWithValidPath)
 {